@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class AllocBenchmark {
+    // Small objects of different sizes; short-lived, so steady state mostly
+    // exercises the TLAB bump-pointer fast path (plus the GCs it triggers).
+    private static class Small {
+        int a;
+    }
+
+    private static class Medium {
+        long a;
+        long b;
+        long c;
+        long d;
+        Object e;
+        Object f;
+    }
+
+    public void timeAllocSmallObject(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new Small();
+        }
+        result = last;
+    }
+
+    public void timeAllocMediumObject(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new Medium();
+        }
+        result = last;
+    }
+
+    public void timeAllocSmallIntArray(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new int[8];
+        }
+        result = last;
+    }
+
+    public void timeAllocSmallObjectArray(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new Object[8];
+        }
+        result = last;
+    }
+
+    public Object result;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include "art_method-inl.h"
+#include "base/enums.h"
+#include "class_linker.h"
+#include "instrumentation.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "jni.h"
+#include "mirror/class-inl.h"
+#include "nativehelper/ScopedUtfChars.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+namespace {
+
+// JIT hooks for BenchmarkHarness, modeled on the run-test helpers in
+// test/common/runtime_state.cc: they let the harness measure steady-state
+// JIT code rather than the warmup ramp, and degrade to no-ops when the
+// runtime executes with the interpreter (-Xint, -Xusejit:false).
+
+jit::Jit* GetJitIfEnabled() {
+  Runtime* runtime = Runtime::Current();
+  bool can_jit =
+      runtime != nullptr
+      && runtime->GetJit() != nullptr
+      && runtime->GetInstrumentation()->GetCurrentInstrumentationLevel() !=
+            instrumentation::Instrumentation::InstrumentationLevel::kInstrumentWithInterpreter;
+  return can_jit ? runtime->GetJit() : nullptr;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_BenchmarkHarness_nativeHasJit(JNIEnv*, jclass) {
+  return GetJitIfEnabled() != nullptr;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_BenchmarkHarness_nativeEnsureJitCompiled(
+    JNIEnv* env, jclass, jclass cls, jstring method_name) {
+  jit::Jit* jit = GetJitIfEnabled();
+  if (jit == nullptr) {
+    return;
+  }
+  Thread* self = Thread::Current();
+  ArtMethod* method = nullptr;
+  {
+    ScopedObjectAccess soa(self);
+    ScopedUtfChars chars(env, method_name);
+    CHECK(chars.c_str() != nullptr);
+    ObjPtr<mirror::Class> klass = soa.Decode<mirror::Class>(cls);
+    method = klass->FindDeclaredVirtualMethodByName(chars.c_str(), kRuntimePointerSize);
+    if (method == nullptr) {
+      method = klass->FindDeclaredDirectMethodByName(chars.c_str(), kRuntimePointerSize);
+    }
+    CHECK(method != nullptr) << "Unable to find method called " << chars.c_str();
+
+    // Benchmark classes are instantiated before measurement, so the declaring
+    // class is initialized; make that state visible so the method does not
+    // keep the resolution stub as entrypoint.
+    if (!klass->IsVisiblyInitialized()) {
+      ScopedThreadSuspension sts(self, ThreadState::kNative);
+      Runtime::Current()->GetClassLinker()->MakeInitializedClassesVisiblyInitialized(
+          self, /*wait=*/ true);
+    }
+  }
+  jit::JitCodeCache* code_cache = jit->GetCodeCache();
+  // Update the code cache to make sure the JIT code does not get deleted.
+  // Note: this will apply to all JIT compilations.
+  code_cache->SetGarbageCollectCode(false);
+  do {
+    // Sleep to yield to the compiler thread.
+    usleep(1000);
+    ScopedObjectAccess soa(self);
+    jit->CompileMethod(method, self, CompilationKind::kOptimized, /*prejit=*/ false);
+  } while (!code_cache->ContainsPc(method->GetEntryPointFromQuickCompiledCode()));
+}
+
+}  // namespace
+
+}  // namespace art
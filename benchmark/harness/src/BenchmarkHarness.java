@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.FileOutputStream;
+import java.io.PrintStream;
+import java.lang.reflect.Method;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+
+/**
+ * Driver for the benchmarks in this directory.
+ *
+ * Each benchmark class exposes {@code timeXxx(int reps)} methods; the harness
+ * instantiates the class (the constructor warms every method up once),
+ * calibrates a repetition count per batch, optionally force-JIT-compiles the
+ * timed method, runs a number of measured batches and reports per-operation
+ * mean, standard deviation and a 95% confidence interval as JSON.
+ *
+ * JIT state is controlled by the launcher: run with default flags for JIT
+ * numbers (the harness force-compiles timed methods so the steady state is
+ * measured rather than the warmup ramp), or with -Xint / -Xusejit:false for
+ * interpreter numbers, in which case the force-compile hook is a no-op.
+ *
+ * Usage: dalvikvm ... BenchmarkHarness [--benchmarks=A,B] [--batches=N]
+ *            [--min-batch-ms=N] [--no-jit-compile] [--output=FILE]
+ */
+public class BenchmarkHarness {
+    // Benchmark classes run when no --benchmarks filter is given, in
+    // alphabetical order. New benchmarks should be added here.
+    private static final String[] DEFAULT_BENCHMARKS = {
+        "AllocBenchmark",
+        "ConstClassBenchmark",
+        "ConstStringBenchmark",
+        "JObjectBenchmark",
+        "JniPerfBenchmark",
+        "MonitorBenchmark",
+        "ReadBarrierBenchmark",
+        "ScopedPrimitiveArrayBenchmark",
+        "StringBuilderAppendBenchmark",
+        "StringIndexOfBenchmark",
+        "StringInternBenchmark",
+        "TypeCheckBenchmark",
+    };
+
+    // Two-sided Student t critical values at 95% confidence for small sample
+    // counts, indexed by degrees of freedom; falls back to the normal
+    // approximation for larger samples.
+    private static final double[] T_TABLE_95 = {
+        Double.NaN, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+        2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101,
+        2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048,
+        2.045, 2.042,
+    };
+
+    private int batches = 10;
+    private long minBatchMs = 50;
+    private boolean jitCompile = true;
+    private String outputFile = null;
+    private List<String> benchmarks = new ArrayList<>(Arrays.asList(DEFAULT_BENCHMARKS));
+    private boolean nativeLibraryLoaded = false;
+
+    private static class Result {
+        String className;
+        String methodName;
+        long repsPerBatch;
+        double[] nsPerOp;
+        double mean;
+        double stddev;
+        double ci95;
+    }
+
+    public static void main(String[] args) throws Exception {
+        BenchmarkHarness harness = new BenchmarkHarness();
+        harness.parseArgs(args);
+        harness.run();
+    }
+
+    private void parseArgs(String[] args) {
+        for (String arg : args) {
+            if (arg.startsWith("--benchmarks=")) {
+                benchmarks = new ArrayList<>(
+                        Arrays.asList(arg.substring("--benchmarks=".length()).split(",")));
+            } else if (arg.startsWith("--batches=")) {
+                batches = Integer.parseInt(arg.substring("--batches=".length()));
+            } else if (arg.startsWith("--min-batch-ms=")) {
+                minBatchMs = Long.parseLong(arg.substring("--min-batch-ms=".length()));
+            } else if (arg.equals("--no-jit-compile")) {
+                jitCompile = false;
+            } else if (arg.startsWith("--output=")) {
+                outputFile = arg.substring("--output=".length());
+            } else {
+                throw new IllegalArgumentException("Unknown option: " + arg);
+            }
+        }
+    }
+
+    private void run() throws Exception {
+        List<Result> results = new ArrayList<>();
+        for (String name : benchmarks) {
+            Class<?> cls = Class.forName(name);
+            // The constructors of the native benchmarks load libartbenchmark,
+            // which also provides the harness' JIT hooks.
+            Object instance = cls.getDeclaredConstructor().newInstance();
+            for (Method method : cls.getDeclaredMethods()) {
+                if (!method.getName().startsWith("time")
+                        || method.getParameterCount() != 1
+                        || method.getParameterTypes()[0] != int.class) {
+                    continue;
+                }
+                results.add(runBenchmark(cls, instance, method));
+            }
+        }
+        PrintStream out = (outputFile != null)
+                ? new PrintStream(new FileOutputStream(outputFile))
+                : System.out;
+        try {
+            emitJson(out, results);
+        } finally {
+            if (outputFile != null) {
+                out.close();
+            }
+        }
+    }
+
+    private Result runBenchmark(Class<?> cls, Object instance, Method method) throws Exception {
+        if (jitCompile) {
+            ensureJitCompiled(cls, method.getName());
+        }
+        // Calibrate the batch size so that timer granularity and batch
+        // scheduling noise stay small relative to the measurement.
+        long reps = 1;
+        while (timeBatch(instance, method, reps) < minBatchMs * 1_000_000L) {
+            reps *= 2;
+        }
+        Result result = new Result();
+        result.className = cls.getName();
+        result.methodName = method.getName();
+        result.repsPerBatch = reps;
+        result.nsPerOp = new double[batches];
+        for (int i = 0; i < batches; ++i) {
+            result.nsPerOp[i] = (double) timeBatch(instance, method, reps) / reps;
+        }
+        double sum = 0;
+        for (double sample : result.nsPerOp) {
+            sum += sample;
+        }
+        result.mean = sum / batches;
+        double variance = 0;
+        for (double sample : result.nsPerOp) {
+            variance += (sample - result.mean) * (sample - result.mean);
+        }
+        variance = (batches > 1) ? variance / (batches - 1) : 0;
+        result.stddev = Math.sqrt(variance);
+        int df = batches - 1;
+        double t = (df >= 1 && df < T_TABLE_95.length) ? T_TABLE_95[df] : 1.960;
+        result.ci95 = (df >= 1) ? t * result.stddev / Math.sqrt(batches) : 0;
+        System.err.println(result.className + "." + result.methodName + ": "
+                + String.format("%.2f ns/op (±%.2f)", result.mean, result.ci95));
+        return result;
+    }
+
+    private long timeBatch(Object instance, Method method, long reps) throws Exception {
+        int intReps = (int) Math.min(reps, Integer.MAX_VALUE);
+        long start = System.nanoTime();
+        method.invoke(instance, intReps);
+        return System.nanoTime() - start;
+    }
+
+    private void emitJson(PrintStream out, List<Result> results) {
+        out.println("{");
+        out.println("  \"jit_compiled\": " + (jitCompile && hasJitCompiler()) + ",");
+        out.println("  \"batches\": " + batches + ",");
+        out.println("  \"benchmarks\": [");
+        for (int i = 0; i < results.size(); ++i) {
+            Result r = results.get(i);
+            out.println("    {");
+            out.println("      \"class\": \"" + r.className + "\",");
+            out.println("      \"method\": \"" + r.methodName + "\",");
+            out.println("      \"reps_per_batch\": " + r.repsPerBatch + ",");
+            out.println("      \"mean_ns_per_op\": " + r.mean + ",");
+            out.println("      \"stddev_ns_per_op\": " + r.stddev + ",");
+            out.println("      \"ci95_ns_per_op\": " + r.ci95 + ",");
+            StringBuilder samples = new StringBuilder("      \"samples_ns_per_op\": [");
+            for (int j = 0; j < r.nsPerOp.length; ++j) {
+                if (j != 0) {
+                    samples.append(", ");
+                }
+                samples.append(r.nsPerOp[j]);
+            }
+            samples.append("]");
+            out.println(samples);
+            out.println(i + 1 < results.size() ? "    }," : "    }");
+        }
+        out.println("  ]");
+        out.println("}");
+    }
+
+    private void ensureJitCompiled(Class<?> cls, String methodName) {
+        if (loadNativeLibrary()) {
+            nativeEnsureJitCompiled(cls, methodName);
+        }
+    }
+
+    private boolean hasJitCompiler() {
+        return loadNativeLibrary() && nativeHasJit();
+    }
+
+    private boolean loadNativeLibrary() {
+        if (!nativeLibraryLoaded) {
+            try {
+                System.loadLibrary("artbenchmark");
+                nativeLibraryLoaded = true;
+            } catch (UnsatisfiedLinkError e) {
+                // Not fatal: run in whatever execution state the launcher set up.
+                return false;
+            }
+        }
+        return true;
+    }
+
+    private static native void nativeEnsureJitCompiled(Class<?> cls, String methodName);
+    private static native boolean nativeHasJit();
+}
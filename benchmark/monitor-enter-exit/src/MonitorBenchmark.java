@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class MonitorBenchmark {
+    public MonitorBenchmark() {
+        // Inflate the monitor of inflatedLock by making a thread wait on it,
+        // so that timeSynchronizedInflated measures the fat-lock path rather
+        // than thin-lock enter/exit.
+        synchronized (inflatedLock) {
+            Thread waiter = new Thread(() -> {
+                synchronized (inflatedLock) {
+                    inflatedLock.notifyAll();
+                }
+            });
+            waiter.start();
+            try {
+                inflatedLock.wait();
+                waiter.join();
+            } catch (InterruptedException e) {
+                throw new AssertionError(e);
+            }
+        }
+    }
+
+    public void timeSynchronizedThin(int count) {
+        Object lock = thinLock;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            synchronized (lock) {
+                ++sum;
+            }
+        }
+        result = sum;
+    }
+
+    public void timeSynchronizedInflated(int count) {
+        Object lock = inflatedLock;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            synchronized (lock) {
+                ++sum;
+            }
+        }
+        result = sum;
+    }
+
+    public void timeSynchronizedMethod(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += synchronizedIncrement();
+        }
+        result = sum;
+    }
+
+    private synchronized int synchronizedIncrement() {
+        return 1;
+    }
+
+    private final Object thinLock = new Object();
+    private final Object inflatedLock = new Object();
+    public int result;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class ReadBarrierBenchmark {
+    private static class Node {
+        Node next;
+        int value;
+    }
+
+    public ReadBarrierBenchmark() {
+        // A 1024-element cyclic list and a matching reference array. Chasing
+        // references through them makes every load a reference load, so on
+        // concurrent copying configurations each iteration goes through the
+        // read barrier; on other configurations this measures the plain load.
+        Node head = new Node();
+        Node node = head;
+        nodes = new Node[1024];
+        nodes[0] = head;
+        for (int i = 1; i < 1024; ++i) {
+            node.next = new Node();
+            node = node.next;
+            node.value = i;
+            nodes[i] = node;
+        }
+        node.next = head;
+        chainStart = head;
+    }
+
+    public void timeReferenceFieldChase(int count) {
+        Node node = chainStart;
+        for (int i = 0; i < count; ++i) {
+            node = node.next;
+        }
+        result = node.value;
+    }
+
+    public void timeReferenceArrayLoad(int count) {
+        Node[] arr = nodes;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += arr[i & 1023].value;
+        }
+        result = sum;
+    }
+
+    private final Node chainStart;
+    private final Node[] nodes;
+    public int result;
+}
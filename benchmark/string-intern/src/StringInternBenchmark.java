@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class StringInternBenchmark {
+    public StringInternBenchmark() {
+        // Pre-intern the strings used by timeInternHit, so that it measures
+        // intern table lookups rather than insertions.
+        hitStrings = new String[1024];
+        for (int i = 0; i < hitStrings.length; ++i) {
+            String s = "intern-hit-" + i;
+            s.intern();
+            // Build a distinct non-interned instance for the lookup.
+            hitStrings[i] = new String(s);
+        }
+    }
+
+    public void timeInternHit(int count) {
+        String[] strings = hitStrings;
+        String last = null;
+        for (int i = 0; i < count; ++i) {
+            last = strings[i & 1023].intern();
+        }
+        result = last;
+    }
+
+    public void timeInternMiss(int count) {
+        // Each iteration interns a string unlikely to be in the table yet,
+        // measuring the insertion path. The interned strings are strongly
+        // held by the table until the next GC of the intern table.
+        String last = null;
+        for (int i = 0; i < count; ++i) {
+            last = ("intern-miss-" + missCounter++).intern();
+        }
+        result = last;
+    }
+
+    private final String[] hitStrings;
+    private long missCounter = 0;
+    public String result;
+}
@@ -42,7 +42,8 @@ namespace art {
         lhs.min_methods_to_save_ == rhs.min_methods_to_save_ &&
         lhs.min_classes_to_save_ == rhs.min_classes_to_save_ &&
         lhs.min_notification_before_wake_ == rhs.min_notification_before_wake_ &&
-        lhs.max_notification_before_wake_ == rhs.max_notification_before_wake_;
+        lhs.max_notification_before_wake_ == rhs.max_notification_before_wake_ &&
+        lhs.hotness_sampling_interval_ms_ == rhs.hotness_sampling_interval_ms_;
   }
 
   bool UsuallyEquals(double expected, double actual) {
@@ -487,7 +488,9 @@ TEST_F(CmdlineParserTest, TestJitOptions) {
 * -Xps-*
 */
 TEST_F(CmdlineParserTest, ProfileSaverOptions) {
-  ProfileSaverOptions opt = ProfileSaverOptions(true, 1, 2, 3, 4, 5, 6, 7, 8, "abc", true);
+  ProfileSaverOptions opt = ProfileSaverOptions(
+      true, 1, 2, 3, 4, 5, 6, 7, 8, "abc", true, /*profile_aot_code=*/ false,
+      /*wait_for_jit_notifications_to_save=*/ true, /*hotness_sampling_interval_ms=*/ 9);
 
   EXPECT_SINGLE_PARSE_VALUE(opt,
                             "-Xjitsaveprofilinginfo "
@@ -499,6 +502,7 @@ TEST_F(CmdlineParserTest, ProfileSaverOptions) {
                             "-Xps-min-classes-to-save:6 "
                             "-Xps-min-notification-before-wake:7 "
                             "-Xps-max-notification-before-wake:8 "
+                            "-Xps-hotness-sampling-interval-ms:9 "
                             "-Xps-profile-path:abc "
                             "-Xps-profile-boot-class-path",
                             M::ProfileSaverOpts);
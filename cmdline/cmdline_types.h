@@ -500,6 +500,9 @@ struct XGcOption {
   bool verify_pre_sweeping_heap_ = kIsDebugBuild;
   bool generational_cc = kEnableGenerationalCCByDefault;
   bool verify_post_gc_heap_ = false;
+  // If set, the heap verification passes above only check a rotating slice of
+  // the heap per GC cycle, trading immediacy for always-on affordability.
+  bool incremental_verify_ = false;
   bool verify_pre_gc_rosalloc_ = kIsDebugBuild;
   bool verify_pre_sweeping_rosalloc_ = false;
   bool verify_post_gc_rosalloc_ = false;
@@ -545,6 +548,10 @@ struct CmdlineType<XGcOption> : CmdlineTypeParser<XGcOption> {
         xgc.verify_post_gc_heap_ = true;
       } else if (gc_option == "nopostverify") {
         xgc.verify_post_gc_heap_ = false;
+      } else if (gc_option == "incrementalverify") {
+        xgc.incremental_verify_ = true;
+      } else if (gc_option == "noincrementalverify") {
+        xgc.incremental_verify_ = false;
       } else if (gc_option == "preverify_rosalloc") {
         xgc.verify_pre_gc_rosalloc_ = true;
       } else if (gc_option == "nopreverify_rosalloc") {
@@ -807,6 +814,12 @@ struct CmdlineType<ProfileSaverOptions> : CmdlineTypeParser<ProfileSaverOptions>
              &ProfileSaverOptions::max_notification_before_wake_,
              type_parser.Parse(suffix));
     }
+    if (android::base::StartsWith(option, "hotness-sampling-interval-ms:")) {
+      CmdlineType<unsigned int> type_parser;
+      return ParseInto(existing,
+             &ProfileSaverOptions::hotness_sampling_interval_ms_,
+             type_parser.Parse(suffix));
+    }
     if (android::base::StartsWith(option, "profile-path:")) {
       existing.profile_path_ = suffix;
       return Result::SuccessNoValue();
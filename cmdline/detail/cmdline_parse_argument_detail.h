@@ -118,11 +118,30 @@ struct CmdlineParserArgumentInfo {
   // a guarantee that the argument is correct, it's more of a strong hint that the
   // user-provided input *probably* was trying to match this argument.
   size_t MaybeMatches(const TokenRange& token_list) const {
+    // Quick reject: the first token of every name must match the user token
+    // exactly or, with a wildcard, up to the wildcard. The prefixes are
+    // precomputed by CompleteArgument(), so definitions that cannot possibly
+    // match are rejected without going through the TokenRange machinery.
+    // This runs for every argument definition on every user token.
+    if (token_list.Size() == 0 || !MatchesAnyQuickPrefix(token_list[0])) {
+      return 0;
+    }
+
     auto best_match = FindClosestMatch(token_list);
 
     return best_match.second;
   }
 
+  // Does `token` start with the pre-wildcard prefix of the first token of any name?
+  bool MatchesAnyQuickPrefix(const std::string& token) const {
+    for (const std::string& prefix : quick_match_prefixes_) {
+      if (token.compare(0, prefix.size(), prefix) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   // Attempt to find the closest match (see MaybeMatches).
   //
   // Returns the token range that was the closest match and the # of tokens that
@@ -251,6 +270,16 @@ struct CmdlineParserArgumentInfo {
       }
     }
 
+    // Precompute the quick-match prefixes: the first token of each name up to
+    // (excluding) the first wildcard. TokenRange::MaybeMatches can only match
+    // at least one token when the user token starts with this prefix.
+    quick_match_prefixes_.clear();
+    for (auto&& tokenized_name : tokenized_names_) {
+      assert(tokenized_name.Size() >= 1);
+      const std::string& first_token = tokenized_name[0];
+      quick_match_prefixes_.push_back(first_token.substr(0, first_token.find('_')));
+    }
+
     if (token_count != 0) {
       assert(("Every argument descriptor string must have equal amount of tokens (spaces)" &&
           token_count == names_.size()));
@@ -314,6 +343,10 @@ struct CmdlineParserArgumentInfo {
   // contains the tokenized names, but with the _ character stripped
   std::vector<TokenRange> simple_names_;
 
+  // pre-wildcard prefix of the first token of each name, used to cheaply
+  // reject argument definitions that cannot match a user token
+  std::vector<std::string> quick_match_prefixes_;
+
   // For argument definitions created with '.AppendValues()'
   // Meaning that parsing should mutate the existing value in-place if possible.
   bool appending_values_ = false;
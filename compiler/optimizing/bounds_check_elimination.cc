@@ -1761,13 +1761,20 @@ class BCEVisitor : public HGraphVisitor {
         return true;
       }
       // Otherwise, allow dynamic bce if the index (which is necessarily an induction at
-      // this point) is the direct loop index (viz. a[i]), since then the runtime tests
-      // ensure upper bound cannot cause an infinite loop.
+      // this point) is the direct loop index (viz. a[i]) or offsets it by a non-negative
+      // constant (viz. a[i+1]), since then the runtime tests ensure upper bound cannot
+      // cause an infinite loop: in the non-deoptimizing path the upper bound plus the
+      // maximum offset is below the array length without wrap-around (wrap-around makes
+      // the unsigned range test deoptimize), keeping the loop bound below max int.
       HInstruction* control = loop->GetHeader()->GetLastInstruction();
       if (control->IsIf()) {
         HInstruction* if_expr = control->AsIf()->InputAt(0);
         if (if_expr->IsCondition()) {
           HCondition* condition = if_expr->AsCondition();
+          ValueBound value = ValueBound::AsValueBound(index);
+          if (value.GetInstruction() != nullptr && value.GetConstant() >= 0) {
+            index = value.GetInstruction();
+          }
           if (index == condition->InputAt(0) ||
               index == condition->InputAt(1)) {
             finite_loop_.insert(loop_id);
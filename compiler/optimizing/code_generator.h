@@ -458,6 +458,19 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
     return InstanceOfNeedsReadBarrier(instance_of) ? kWithReadBarrier : kWithoutReadBarrier;
   }
 
+  static bool FieldGetNeedsReadBarrier(HInstruction* field_get) {
+    DCHECK(field_get->IsInstanceFieldGet() ||
+           field_get->IsStaticFieldGet() ||
+           field_get->IsPredicatedInstanceFieldGet());
+    if (field_get->IsStaticFieldGet() && field_get->AsStaticFieldGet()->LoadsBootImageValue()) {
+      // The loaded reference is known to be in the boot image, which is part of the
+      // GC's immune spaces. Immune space objects are never moved, so it does not
+      // matter whether we read a from-space or to-space reference.
+      return false;
+    }
+    return kEmitCompilerReadBarrier;
+  }
+
   static bool IsTypeCheckSlowPathFatal(HCheckCast* check_cast) {
     switch (check_cast->GetTypeCheckKind()) {
       case TypeCheckKind::kExactCheck:
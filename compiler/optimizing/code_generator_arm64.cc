@@ -1971,7 +1971,8 @@ void LocationsBuilderARM64::HandleFieldGet(HInstruction* instruction,
   bool is_predicated = instruction->IsPredicatedInstanceFieldGet();
 
   bool object_field_get_with_read_barrier =
-      kEmitCompilerReadBarrier && (instruction->GetType() == DataType::Type::kReference);
+      (instruction->GetType() == DataType::Type::kReference) &&
+      CodeGenerator::FieldGetNeedsReadBarrier(instruction);
   LocationSummary* locations =
       new (GetGraph()->GetAllocator()) LocationSummary(instruction,
                                                        object_field_get_with_read_barrier
@@ -2026,9 +2027,10 @@ void InstructionCodeGeneratorARM64::HandleFieldGet(HInstruction* instruction,
   DataType::Type load_type = instruction->GetType();
   MemOperand field =
       HeapOperand(InputRegisterAt(instruction, receiver_input), field_info.GetFieldOffset());
+  const bool needs_read_barrier = (load_type == DataType::Type::kReference) &&
+                                  CodeGenerator::FieldGetNeedsReadBarrier(instruction);
 
-  if (kEmitCompilerReadBarrier && kUseBakerReadBarrier &&
-      load_type == DataType::Type::kReference) {
+  if (needs_read_barrier && kUseBakerReadBarrier) {
     // Object FieldGet with Baker's read barrier case.
     // /* HeapReference<Object> */ out = *(base + offset)
     Register base = RegisterFrom(base_loc, DataType::Type::kReference);
@@ -2062,10 +2064,16 @@ void InstructionCodeGeneratorARM64::HandleFieldGet(HInstruction* instruction,
       codegen_->MaybeRecordImplicitNullCheck(instruction);
     }
     if (load_type == DataType::Type::kReference) {
-      // If read barriers are enabled, emit read barriers other than
-      // Baker's using a slow path (and also unpoison the loaded
-      // reference, if heap poisoning is enabled).
-      codegen_->MaybeGenerateReadBarrierSlow(instruction, out, out, base_loc, offset);
+      if (needs_read_barrier) {
+        // If read barriers are enabled, emit read barriers other than
+        // Baker's using a slow path (and also unpoison the loaded
+        // reference, if heap poisoning is enabled).
+        codegen_->MaybeGenerateReadBarrierSlow(instruction, out, out, base_loc, offset);
+      } else {
+        // The read barrier was elided (see CodeGenerator::FieldGetNeedsReadBarrier())
+        // or read barriers are disabled; just unpoison the loaded reference.
+        GetAssembler()->MaybeUnpoisonHeapReference(WRegisterFrom(out));
+      }
     }
   }
 }
@@ -5866,7 +5866,8 @@ void LocationsBuilderARMVIXL::HandleFieldGet(HInstruction* instruction,
          instruction->IsPredicatedInstanceFieldGet());
 
   bool object_field_get_with_read_barrier =
-      kEmitCompilerReadBarrier && (field_info.GetFieldType() == DataType::Type::kReference);
+      (field_info.GetFieldType() == DataType::Type::kReference) &&
+      CodeGenerator::FieldGetNeedsReadBarrier(instruction);
   bool is_predicated = instruction->IsPredicatedInstanceFieldGet();
   LocationSummary* locations =
       new (GetGraph()->GetAllocator()) LocationSummary(instruction,
@@ -6037,7 +6038,8 @@ void InstructionCodeGeneratorARMVIXL::HandleFieldGet(HInstruction* instruction,
 
     case DataType::Type::kReference: {
       // /* HeapReference<Object> */ out = *(base + offset)
-      if (kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
+      const bool needs_read_barrier = CodeGenerator::FieldGetNeedsReadBarrier(instruction);
+      if (needs_read_barrier && kUseBakerReadBarrier) {
         Location maybe_temp = (locations->GetTempCount() != 0) ? locations->GetTemp(0) : Location();
         // Note that a potential implicit null check is handled in this
         // CodeGeneratorARMVIXL::GenerateFieldLoadWithBakerReadBarrier call.
@@ -6056,11 +6058,17 @@ void InstructionCodeGeneratorARMVIXL::HandleFieldGet(HInstruction* instruction,
         if (is_volatile) {
           codegen_->GenerateMemoryBarrier(MemBarrierKind::kLoadAny);
         }
-        // If read barriers are enabled, emit read barriers other than
-        // Baker's using a slow path (and also unpoison the loaded
-        // reference, if heap poisoning is enabled).
-        codegen_->MaybeGenerateReadBarrierSlow(
-            instruction, out, out, locations->InAt(receiver_input), offset);
+        if (needs_read_barrier) {
+          // If read barriers are enabled, emit read barriers other than
+          // Baker's using a slow path (and also unpoison the loaded
+          // reference, if heap poisoning is enabled).
+          codegen_->MaybeGenerateReadBarrierSlow(
+              instruction, out, out, locations->InAt(receiver_input), offset);
+        } else {
+          // The read barrier was elided (see CodeGenerator::FieldGetNeedsReadBarrier())
+          // or read barriers are disabled; just unpoison the loaded reference.
+          GetAssembler()->MaybeUnpoisonHeapReference(RegisterFrom(out));
+        }
       }
       break;
     }
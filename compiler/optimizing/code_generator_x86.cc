@@ -5649,7 +5649,8 @@ void LocationsBuilderX86::HandleFieldGet(HInstruction* instruction, const FieldI
          instruction->IsPredicatedInstanceFieldGet());
 
   bool object_field_get_with_read_barrier =
-      kEmitCompilerReadBarrier && (instruction->GetType() == DataType::Type::kReference);
+      (instruction->GetType() == DataType::Type::kReference) &&
+      CodeGenerator::FieldGetNeedsReadBarrier(instruction);
   bool is_predicated = instruction->IsPredicatedInstanceFieldGet();
   LocationSummary* locations =
       new (GetGraph()->GetAllocator()) LocationSummary(instruction,
@@ -5737,7 +5738,8 @@ void InstructionCodeGeneratorX86::HandleFieldGet(HInstruction* instruction,
 
     case DataType::Type::kReference: {
       // /* HeapReference<Object> */ out = *(base + offset)
-      if (kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
+      const bool needs_read_barrier = CodeGenerator::FieldGetNeedsReadBarrier(instruction);
+      if (needs_read_barrier && kUseBakerReadBarrier) {
         // Note that a potential implicit null check is handled in this
         // CodeGeneratorX86::GenerateFieldLoadWithBakerReadBarrier call.
         codegen_->GenerateFieldLoadWithBakerReadBarrier(
@@ -5751,10 +5753,16 @@ void InstructionCodeGeneratorX86::HandleFieldGet(HInstruction* instruction,
         if (is_volatile) {
           codegen_->GenerateMemoryBarrier(MemBarrierKind::kLoadAny);
         }
-        // If read barriers are enabled, emit read barriers other than
-        // Baker's using a slow path (and also unpoison the loaded
-        // reference, if heap poisoning is enabled).
-        codegen_->MaybeGenerateReadBarrierSlow(instruction, out, out, base_loc, offset);
+        if (needs_read_barrier) {
+          // If read barriers are enabled, emit read barriers other than
+          // Baker's using a slow path (and also unpoison the loaded
+          // reference, if heap poisoning is enabled).
+          codegen_->MaybeGenerateReadBarrierSlow(instruction, out, out, base_loc, offset);
+        } else {
+          // The read barrier was elided (see CodeGenerator::FieldGetNeedsReadBarrier())
+          // or read barriers are disabled; just unpoison the loaded reference.
+          __ MaybeUnpoisonHeapReference(out.AsRegister<Register>());
+        }
       }
       break;
     }
@@ -40,6 +40,10 @@ bool CodeSinking::Run() {
       SinkCodeToUncommonBranch(exit_predecessor);
     }
   }
+  // Allocations whose result is only consumed on one side of a branch can be
+  // moved - or duplicated - past the branch, so that paths which merge back
+  // without using the object no longer pay for it.
+  SinkAllocationsToConsumingBranches();
   return true;
 }
 
@@ -439,4 +443,300 @@ void CodeSinking::SinkCodeToUncommonBranch(HBasicBlock* end_block) {
   }
 }
 
+// Instructions whose cost we can remove from paths that do not consume their
+// result: they have no side effect other than materializing the object, and
+// HInstruction::Clone() supports them.
+static bool IsAllocationLike(HInstruction* instruction) {
+  return instruction->IsNewInstance() || instruction->IsNewArray() || instruction->IsLoadString();
+}
+
+// Returns whether `user` initializes the object created by `instruction`
+// rather than consuming it: a store into the freshly allocated object, or its
+// constructor fence. Such users must follow the allocation wherever it goes.
+static bool IsInitializingUse(HInstruction* instruction, HInstruction* user) {
+  if (instruction->IsNewInstance()) {
+    return (user->IsInstanceFieldSet() || user->IsConstructorFence()) &&
+        (user->InputAt(0) == instruction);
+  } else if (instruction->IsNewArray()) {
+    return (user->IsArraySet() || user->IsConstructorFence()) &&
+        (user->InputAt(0) == instruction);
+  }
+  return false;
+}
+
+// The block where `use` needs its input to be available, mirroring the phi
+// handling of FindIdealPosition.
+static HBasicBlock* GetUseBlock(const HUseListNode<HInstruction*>& use) {
+  HInstruction* user = use.GetUser();
+  HBasicBlock* block = user->GetBlock();
+  if (user->IsPhi()) {
+    block = user->AsPhi()->IsCatchPhi()
+        ? block->GetDominator()
+        : block->GetPredecessors()[use.GetIndex()];
+  }
+  return block;
+}
+
+// Find where to (re)materialize `instruction` in `target_block`: before its
+// earliest user there, or before the control flow instruction. Mirrors the
+// insertion position logic of FindIdealPosition.
+static HInstruction* FindInsertionPosition(HInstruction* instruction, HBasicBlock* target_block) {
+  HInstruction* insert_pos = nullptr;
+  for (const HUseListNode<HInstruction*>& use : instruction->GetUses()) {
+    if (use.GetUser()->GetBlock() == target_block &&
+        (insert_pos == nullptr || use.GetUser()->StrictlyDominates(insert_pos))) {
+      insert_pos = use.GetUser();
+    }
+  }
+  for (const HUseListNode<HEnvironment*>& use : instruction->GetEnvUses()) {
+    HInstruction* user = use.GetUser()->GetHolder();
+    if (user->GetBlock() == target_block &&
+        (insert_pos == nullptr || user->StrictlyDominates(insert_pos))) {
+      insert_pos = user;
+    }
+  }
+  if (insert_pos == nullptr) {
+    // No user in `target_block`, insert before the control flow instruction.
+    insert_pos = target_block->GetLastInstruction();
+    DCHECK(insert_pos->IsControlFlow());
+    // Avoid splitting HCondition from HIf to prevent unnecessary materialization.
+    if (insert_pos->IsIf()) {
+      HInstruction* if_input = insert_pos->AsIf()->InputAt(0);
+      if (if_input == insert_pos->GetPrevious()) {
+        insert_pos = if_input;
+      }
+    }
+  }
+  DCHECK(!insert_pos->IsPhi());
+  return insert_pos;
+}
+
+void CodeSinking::SinkAllocationsToConsumingBranches() {
+  // Collect the candidates first: sinking and duplicating rearranges the
+  // instruction lists we would otherwise be iterating over.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> candidates(allocator.Adapter(kArenaAllocMisc));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (IsAllocationLike(it.Current())) {
+        candidates.push_back(it.Current());
+      }
+    }
+  }
+  for (HInstruction* candidate : candidates) {
+    TrySinkAllocation(candidate);
+  }
+}
+
+void CodeSinking::TrySinkAllocation(HInstruction* allocation) {
+  HBasicBlock* block = allocation->GetBlock();
+
+  // Find where the object is consumed. Initializing stores and fences are not
+  // consumers: they follow the allocation wherever it goes.
+  CommonDominator finder(/* block= */ nullptr);
+  for (const HUseListNode<HInstruction*>& use : allocation->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (IsInitializingUse(allocation, user)) {
+      // Volatile stores cannot be moved, and a fence covering several
+      // allocations cannot follow just this one.
+      if ((user->IsInstanceFieldSet() && user->AsInstanceFieldSet()->IsVolatile()) ||
+          (user->IsConstructorFence() && user->InputCount() != 1u)) {
+        return;
+      }
+      continue;
+    }
+    finder.Update(GetUseBlock(use));
+  }
+  for (const HUseListNode<HEnvironment*>& use : allocation->GetEnvUses()) {
+    DCHECK(!use.GetUser()->GetHolder()->IsPhi());
+    finder.Update(use.GetUser()->GetHolder()->GetBlock());
+  }
+  HBasicBlock* target = finder.Get();
+  if (target == nullptr) {
+    // Only initialized, never consumed; leave it to dead code elimination.
+    return;
+  }
+  if (!block->Dominates(target)) {
+    // Can happen with the catch phi approximation of GetUseBlock.
+    return;
+  }
+
+  // Never sink into a loop the allocation is not already in: that would
+  // allocate once per iteration instead of once overall.
+  while (target != block && target->GetLoopInformation() != block->GetLoopInformation()) {
+    target = target->GetDominator();
+    DCHECK(target != nullptr);
+  }
+
+  // Be as conservative with try/catch regions as FindIdealPosition is.
+  if (target->GetTryCatchInformation() != nullptr) {
+    return;
+  }
+
+  // `duplicate` means the consuming uses have no common dominator below the
+  // allocation's own block: they are split across the arms of the branch
+  // ending it, and the allocation needs to be duplicated into each arm.
+  const bool duplicate = (target == block);
+  if (duplicate && (graph_->IsDebuggable() || !block->GetLastInstruction()->IsIf())) {
+    return;
+  }
+
+  // Classify the initializing users: those above the target position are
+  // companions that move (or get duplicated) with the allocation, those below
+  // it stay in place and keep their ordering with respect to the uses.
+  auto is_companion = [&](HInstruction* user) {
+    return IsInitializingUse(allocation, user) &&
+        user->GetBlock()->Dominates(target) &&
+        (duplicate || user->GetBlock() != target);
+  };
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> companions(allocator.Adapter(kArenaAllocMisc));
+  for (const HUseListNode<HInstruction*>& use : allocation->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (!IsInitializingUse(allocation, user)) {
+      continue;
+    }
+    if (is_companion(user)) {
+      // Constructor fences do not support cloning.
+      if (duplicate && !user->IsClonable()) {
+        return;
+      }
+      companions.push_back(user);
+    } else if (!target->Dominates(user->GetBlock())) {
+      // A store on a diverging path; bail.
+      return;
+    }
+  }
+  // Keep the original order when reinserting the companions.
+  std::sort(companions.begin(), companions.end(), [](HInstruction* a, HInstruction* b) {
+    return a->StrictlyDominates(b);
+  });
+
+  if (!duplicate) {
+    // All consuming uses are dominated by `target`: move the allocation there,
+    // provided this actually takes it past a branch.
+    bool crosses_branch = false;
+    for (HBasicBlock* current = target->GetDominator();
+         current != nullptr;
+         current = current->GetDominator()) {
+      if (current->GetSuccessors().size() > 1u) {
+        crosses_branch = true;
+        break;
+      }
+      if (current == block) {
+        break;
+      }
+    }
+    if (!crosses_branch) {
+      return;
+    }
+    HInstruction* insert_pos = FindInsertionPosition(allocation, target);
+    MaybeRecordStat(stats_, MethodCompilationStat::kInstructionSunk);
+    allocation->MoveBefore(insert_pos, /* do_checks= */ false);
+    for (HInstruction* companion : companions) {
+      companion->MoveBefore(insert_pos, /* do_checks= */ false);
+    }
+    return;
+  }
+
+  // Partition the consuming uses between the two arms of the branch. A use
+  // dominated by neither arm (in `block` itself, or past the merge point
+  // without going through a phi) makes the duplication impossible.
+  DCHECK_EQ(block->GetSuccessors().size(), 2u);
+  HBasicBlock* arms[2] = { block->GetSuccessors()[0], block->GetSuccessors()[1] };
+  CommonDominator arm_finder[2] = { CommonDominator(nullptr), CommonDominator(nullptr) };
+  ScopedArenaVector<std::pair<HInstruction*, size_t>> arm_uses[2] = {
+      ScopedArenaVector<std::pair<HInstruction*, size_t>>(allocator.Adapter(kArenaAllocMisc)),
+      ScopedArenaVector<std::pair<HInstruction*, size_t>>(allocator.Adapter(kArenaAllocMisc)) };
+  ScopedArenaVector<std::pair<HEnvironment*, size_t>> arm_env_uses[2] = {
+      ScopedArenaVector<std::pair<HEnvironment*, size_t>>(allocator.Adapter(kArenaAllocMisc)),
+      ScopedArenaVector<std::pair<HEnvironment*, size_t>>(allocator.Adapter(kArenaAllocMisc)) };
+  auto arm_of = [&](HBasicBlock* use_block) {
+    return arms[0]->Dominates(use_block) ? 0 : arms[1]->Dominates(use_block) ? 1 : -1;
+  };
+  for (const HUseListNode<HInstruction*>& use : allocation->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (is_companion(user)) {
+      continue;
+    }
+    int arm = arm_of(GetUseBlock(use));
+    if (arm < 0) {
+      return;
+    }
+    arm_finder[arm].Update(GetUseBlock(use));
+    arm_uses[arm].emplace_back(user, use.GetIndex());
+  }
+  for (const HUseListNode<HEnvironment*>& use : allocation->GetEnvUses()) {
+    HBasicBlock* use_block = use.GetUser()->GetHolder()->GetBlock();
+    int arm = arm_of(use_block);
+    if (arm < 0) {
+      return;
+    }
+    arm_finder[arm].Update(use_block);
+    arm_env_uses[arm].emplace_back(use.GetUser(), use.GetIndex());
+  }
+
+  // Validate both arms before mutating anything.
+  HInstruction* arm_insert_pos[2] = { nullptr, nullptr };
+  for (int i = 0; i < 2; ++i) {
+    HBasicBlock* arm_target = arm_finder[i].Get();
+    if (arm_target == nullptr) {
+      // All uses are in the other arm; the common dominator computation above
+      // should have led us to it, but the catch phi approximation can break
+      // that assumption.
+      return;
+    }
+    while (arm_target->GetLoopInformation() != block->GetLoopInformation()) {
+      arm_target = arm_target->GetDominator();
+      DCHECK(arm_target != nullptr);
+    }
+    if (!arms[i]->Dominates(arm_target)) {
+      // Hoisting out of a loop took us out of the arm.
+      return;
+    }
+    if (arm_target->GetTryCatchInformation() != nullptr) {
+      return;
+    }
+    arm_insert_pos[i] = FindInsertionPosition(allocation, arm_target);
+  }
+
+  // Materialize a copy of the allocation and its companions in each arm, and
+  // rewire that arm's uses to the copy.
+  MaybeRecordStat(stats_, MethodCompilationStat::kAllocationDuplicated);
+  for (int i = 0; i < 2; ++i) {
+    HInstruction* copy = allocation->Clone(graph_->GetAllocator());
+    HBasicBlock* insert_block = arm_insert_pos[i]->GetBlock();
+    insert_block->InsertInstructionBefore(copy, arm_insert_pos[i]);
+    if (allocation->HasEnvironment()) {
+      copy->CopyEnvironmentFrom(allocation->GetEnvironment());
+    }
+    for (HInstruction* companion : companions) {
+      HInstruction* companion_copy = companion->Clone(graph_->GetAllocator());
+      insert_block->InsertInstructionBefore(companion_copy, arm_insert_pos[i]);
+      for (size_t input = 0, e = companion_copy->InputCount(); input < e; ++input) {
+        if (companion_copy->InputAt(input) == allocation) {
+          companion_copy->ReplaceInput(copy, input);
+        }
+      }
+      if (companion->HasEnvironment()) {
+        companion_copy->CopyEnvironmentFrom(companion->GetEnvironment());
+      }
+    }
+    for (const std::pair<HInstruction*, size_t>& use : arm_uses[i]) {
+      use.first->ReplaceInput(copy, use.second);
+    }
+    for (const std::pair<HEnvironment*, size_t>& use : arm_env_uses[i]) {
+      use.first->RemoveAsUserOfInput(use.second);
+      use.first->SetRawEnvAt(use.second, copy);
+      copy->AddEnvUseAt(use.first, use.second);
+    }
+  }
+
+  // The original allocation and its companions are now dead.
+  for (auto it = companions.rbegin(); it != companions.rend(); ++it) {
+    (*it)->GetBlock()->RemoveInstruction(*it);
+  }
+  block->RemoveInstruction(allocation);
+}
+
 }  // namespace art
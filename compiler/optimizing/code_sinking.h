@@ -42,6 +42,13 @@ class CodeSinking : public HOptimization {
   // blocks, to these blocks.
   void SinkCodeToUncommonBranch(HBasicBlock* end_block);
 
+  // Try to move allocation-like instructions into the branches that consume
+  // their result, duplicating them when the uses are split across several
+  // branch arms. This is a form of partial dead code elimination: paths that
+  // merge back without using the object no longer pay for the allocation.
+  void SinkAllocationsToConsumingBranches();
+  void TrySinkAllocation(HInstruction* allocation);
+
   DISALLOW_COPY_AND_ASSIGN(CodeSinking);
 };
 
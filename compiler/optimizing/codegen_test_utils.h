@@ -216,6 +216,18 @@ inline int64_t SimulatorExecute<int64_t>(CodeSimulator* simulator, int64_t (*f)(
   return simulator->GetCReturnInt64();
 }
 
+template <>
+inline float SimulatorExecute<float>(CodeSimulator* simulator, float (*f)()) {
+  simulator->RunFrom(reinterpret_cast<intptr_t>(f));
+  return simulator->GetCReturnFloat();
+}
+
+template <>
+inline double SimulatorExecute<double>(CodeSimulator* simulator, double (*f)()) {
+  simulator->RunFrom(reinterpret_cast<intptr_t>(f));
+  return simulator->GetCReturnDouble();
+}
+
 template <typename Expected>
 static void VerifyGeneratedCode(InstructionSet target_isa,
                                 Expected (*f)(),
@@ -983,7 +983,7 @@ bool InductionVarRange::GenerateRangeOrLastValue(HInstruction* context,
         }
         break;
       case HInductionVarAnalysis::kPolynomial:
-        return GenerateLastValuePolynomial(info, trip, graph, block, lower);
+        return GenerateLastValuePolynomial(info, trip, graph, block, lower, needs_taken_test);
       case HInductionVarAnalysis::kGeometric:
         return GenerateLastValueGeometric(info, trip, graph, block, lower);
       case HInductionVarAnalysis::kWrapAround:
@@ -1017,16 +1017,19 @@ bool InductionVarRange::GenerateLastValuePolynomial(HInductionVarAnalysis::Induc
                                                     HInductionVarAnalysis::InductionInfo* trip,
                                                     HGraph* graph,
                                                     HBasicBlock* block,
-                                                    /*out*/HInstruction** result) const {
+                                                    /*out*/HInstruction** result,
+                                                    /*out*/bool* needs_taken_test) const {
   DCHECK(info != nullptr);
   DCHECK_EQ(info->induction_class, HInductionVarAnalysis::kPolynomial);
-  // Detect known coefficients and trip count (always taken).
+  // Detect known coefficients.
   int64_t a = 0;
   int64_t b = 0;
   int64_t m = 0;
-  if (IsConstant(info->op_a->op_a, kExact, &a) &&
-      IsConstant(info->op_a->op_b, kExact, &b) &&
-      IsConstant(trip->op_a, kExact, &m) && m >= 1) {
+  if (!IsConstant(info->op_a->op_a, kExact, &a) ||
+      !IsConstant(info->op_a->op_b, kExact, &b)) {
+    return false;
+  }
+  if (IsConstant(trip->op_a, kExact, &m) && m >= 1) {
     // Evaluate bounds on sum_i=0^m-1(a * i + b) + c for known
     // maximum index value m as a * (m * (m-1)) / 2 + b * m + c.
     HInstruction* c = nullptr;
@@ -1042,6 +1045,55 @@ bool InductionVarRange::GenerateLastValuePolynomial(HInductionVarAnalysis::Induc
       }
       return true;
     }
+    return false;
+  }
+  // Otherwise, evaluate the closed form for a symbolic trip count m directly as
+  // a * ((m * (m - 1)) / 2) + b * m + c. The sum is computed in 64-bit arithmetic
+  // so that the halving of the always-even product is exact before truncating to
+  // the required precision.
+  HInstruction* t = nullptr;
+  HInstruction* c = nullptr;
+  if (GenerateCode(trip->op_a, nullptr, graph, block, graph ? &t : nullptr, false, false) &&
+      GenerateCode(info->op_b, nullptr, graph, block, graph ? &c : nullptr, false, false)) {
+    if (graph != nullptr) {
+      DataType::Type type = info->type;
+      ArenaAllocator* allocator = graph->GetAllocator();
+      HInstruction* m64 = t;
+      if (t->GetType() != DataType::Type::kInt64) {
+        m64 = Insert(block, new (allocator) HTypeConversion(DataType::Type::kInt64, t, kNoDexPc));
+      }
+      HInstruction* product = Insert(block, new (allocator) HMul(
+          DataType::Type::kInt64,
+          m64,
+          Insert(block, new (allocator) HSub(
+              DataType::Type::kInt64, m64, graph->GetLongConstant(1)))));
+      HInstruction* half = Insert(block, new (allocator) HShr(
+          DataType::Type::kInt64, product, graph->GetIntConstant(1)));
+      HInstruction* sum = Insert(block, new (allocator) HAdd(
+          DataType::Type::kInt64,
+          Insert(block, new (allocator) HMul(
+              DataType::Type::kInt64, graph->GetLongConstant(a), half)),
+          Insert(block, new (allocator) HMul(
+              DataType::Type::kInt64, graph->GetLongConstant(b), m64))));
+      if (type != DataType::Type::kInt64) {
+        sum = Insert(block, new (allocator) HTypeConversion(type, sum, kNoDexPc));
+      }
+      *result = Insert(block, new (allocator) HAdd(type, sum, c));
+    }
+    // Guard with taken test if needed, selecting the initial value on a not-taken loop.
+    if (*needs_taken_test) {
+      HInstruction* is_taken = nullptr;
+      if (GenerateCode(trip->op_b, nullptr, graph, block, graph ? &is_taken : nullptr, false, false)) {
+        if (graph != nullptr) {
+          ArenaAllocator* allocator = graph->GetAllocator();
+          *result = Insert(block, new (allocator) HSelect(is_taken, *result, c, kNoDexPc));
+        }
+        *needs_taken_test = false;  // taken care of
+      } else {
+        return false;
+      }
+    }
+    return true;
   }
   return false;
 }
@@ -302,7 +302,8 @@ class InductionVarRange {
                                    HInductionVarAnalysis::InductionInfo* trip,
                                    HGraph* graph,
                                    HBasicBlock* block,
-                                   /*out*/HInstruction** result) const;
+                                   /*out*/HInstruction** result,
+                                   /*out*/bool* needs_taken_test) const;
 
   bool GenerateLastValueGeometric(HInductionVarAnalysis::InductionInfo* info,
                                   HInductionVarAnalysis::InductionInfo* trip,
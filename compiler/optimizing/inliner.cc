@@ -57,6 +57,13 @@ static constexpr size_t kMaximumNumberOfTotalInstructions = 1024;
 // are not reached.
 static constexpr size_t kMaximumNumberOfInstructionsForSmallMethod = 3;
 
+// Multiplier applied to the code item size limit when the call site provides
+// constant arguments. Conditionals and arithmetic on such arguments usually
+// fold away after substitution, so the raw code item size overestimates the
+// real cost; oversized candidates are still rejected on their
+// post-optimization instruction count in CanInlineBody.
+static constexpr size_t kCodeUnitsLimitMultiplierForConstantArguments = 4;
+
 // Limit the number of dex registers that we accumulate while inlining
 // to avoid creating large amount of nested environments.
 static constexpr size_t kMaximumNumberOfCumulatedDexRegisters = 32;
@@ -322,8 +329,7 @@ static dex::TypeIndex FindClassIndexIn(ObjPtr<mirror::Class> cls,
 
 HInliner::InlineCacheType HInliner::GetInlineCacheType(
     const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
-  DCHECK_EQ(classes.NumberOfReferences(), InlineCache::kIndividualCacheSize);
-  uint8_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
+  uint8_t number_of_types = classes.NumberOfReferences();
   if (number_of_types == 0) {
     return kInlineCacheUninitialized;
   } else if (number_of_types == 1) {
@@ -636,7 +642,7 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
 HInliner::InlineCacheType HInliner::GetInlineCacheAOT(
     HInvoke* invoke_instruction,
     /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
-  DCHECK_EQ(classes->NumberOfReferences(), InlineCache::kIndividualCacheSize);
+  DCHECK_EQ(classes->NumberOfReferences(), 0u);
   DCHECK_EQ(classes->RemainingSlots(), InlineCache::kIndividualCacheSize);
 
   const ProfileCompilationInfo* pci = codegen_->GetCompilerOptions().GetProfileCompilationInfo();
@@ -662,7 +668,13 @@ HInliner::InlineCacheType HInliner::GetInlineCacheAOT(
     return kInlineCacheMissingTypes;
   }
   if (dex_pc_data.is_megamorphic) {
-    return kInlineCacheMegamorphic;
+    // The profile keeps the dominant receiver types recorded before the call site
+    // overflowed the inline cache. Use them for guarded polymorphic inlining when
+    // the fallback path is a virtual call; the recorded set is incomplete, so a
+    // deoptimizing guard could deoptimize on every call.
+    if (dex_pc_data.classes.empty() || !UseOnlyPolymorphicInliningWithNoDeopt()) {
+      return kInlineCacheMegamorphic;
+    }
   }
   DCHECK_LE(dex_pc_data.classes.size(), InlineCache::kIndividualCacheSize);
 
@@ -920,8 +932,7 @@ bool HInliner::TryInlinePolymorphicCall(
 
   bool all_targets_inlined = true;
   bool one_target_inlined = false;
-  DCHECK_EQ(classes.NumberOfReferences(), InlineCache::kIndividualCacheSize);
-  uint8_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
+  uint8_t number_of_types = classes.NumberOfReferences();
   for (size_t i = 0; i != number_of_types; ++i) {
     DCHECK(classes.GetReference(i) != nullptr);
     Handle<mirror::Class> handle =
@@ -1089,8 +1100,7 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
 
   // Check whether we are actually calling the same method among
   // the different types seen.
-  DCHECK_EQ(classes.NumberOfReferences(), InlineCache::kIndividualCacheSize);
-  uint8_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
+  uint8_t number_of_types = classes.NumberOfReferences();
   for (size_t i = 0; i != number_of_types; ++i) {
     DCHECK(classes.GetReference(i) != nullptr);
     ArtMethod* new_method = nullptr;
@@ -1381,7 +1391,8 @@ bool HInliner::IsInliningSupported(const HInvoke* invoke_instruction,
 }
 
 // Returns whether our resource limits allow inlining this method.
-bool HInliner::IsInliningBudgetAvailable(ArtMethod* method,
+bool HInliner::IsInliningBudgetAvailable(const HInvoke* invoke_instruction,
+                                         ArtMethod* method,
                                          const CodeItemDataAccessor& accessor) const {
   if (CountRecursiveCallsOf(method) > kMaximumNumberOfRecursiveCalls) {
     LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedRecursiveBudget)
@@ -1393,13 +1404,28 @@ bool HInliner::IsInliningBudgetAvailable(ArtMethod* method,
 
   size_t inline_max_code_units = codegen_->GetCompilerOptions().GetInlineMaxCodeUnits();
   if (accessor.InsnsSizeInCodeUnits() > inline_max_code_units) {
-    LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedCodeItem)
-        << "Method " << method->PrettyMethod()
-        << " is not inlined because its code item is too big: "
-        << accessor.InsnsSizeInCodeUnits()
-        << " > "
-        << inline_max_code_units;
-    return false;
+    // The callee may still fold to a handful of instructions once the call
+    // site's constant arguments are substituted. Allow a larger code item in
+    // that case; CanInlineBody charges the budget with what actually survives
+    // constant folding and dead code elimination.
+    bool has_constant_argument = false;
+    for (size_t i = 0, e = invoke_instruction->GetNumberOfArguments(); i < e; ++i) {
+      if (invoke_instruction->InputAt(i)->IsConstant()) {
+        has_constant_argument = true;
+        break;
+      }
+    }
+    if (!has_constant_argument ||
+        accessor.InsnsSizeInCodeUnits() >
+            inline_max_code_units * kCodeUnitsLimitMultiplierForConstantArguments) {
+      LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedCodeItem)
+          << "Method " << method->PrettyMethod()
+          << " is not inlined because its code item is too big: "
+          << accessor.InsnsSizeInCodeUnits()
+          << " > "
+          << inline_max_code_units;
+      return false;
+    }
   }
 
   return true;
@@ -1467,7 +1493,7 @@ bool HInliner::TryBuildAndInline(HInvoke* invoke_instruction,
     return false;
   }
 
-  if (!IsInliningBudgetAvailable(method, accessor)) {
+  if (!IsInliningBudgetAvailable(invoke_instruction, method, accessor)) {
     return false;
   }
 
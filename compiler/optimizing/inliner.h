@@ -130,8 +130,13 @@ class HInliner : public HOptimization {
   // Returns whether the inlining budget allows inlining method.
   //
   // For example, this checks whether the function has grown too large and
-  // inlining should be prevented.
-  bool IsInliningBudgetAvailable(art::ArtMethod* method, const CodeItemDataAccessor& accessor) const
+  // inlining should be prevented. Call sites providing constant arguments are
+  // given a larger raw code item allowance, since the callee's code typically
+  // folds after substitution; the final decision on such callees is made on
+  // the post-optimization instruction count in CanInlineBody.
+  bool IsInliningBudgetAvailable(const HInvoke* invoke_instruction,
+                                 art::ArtMethod* method,
+                                 const CodeItemDataAccessor& accessor) const
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Inspects the body of a method (callee_graph) and returns whether it can be
@@ -2153,15 +2153,36 @@ void HInstructionBuilder::BuildStaticFieldAccess(const Instruction& instruction,
                                                        *dex_file_,
                                                        dex_pc));
   } else {
-    AppendInstruction(new (allocator_) HStaticFieldGet(cls,
-                                                       resolved_field,
-                                                       field_type,
-                                                       resolved_field->GetOffset(),
-                                                       resolved_field->IsVolatile(),
-                                                       field_index,
-                                                       class_def_index,
-                                                       *dex_file_,
-                                                       dex_pc));
+    HStaticFieldGet* field_get = new (allocator_) HStaticFieldGet(cls,
+                                                                  resolved_field,
+                                                                  field_type,
+                                                                  resolved_field->GetOffset(),
+                                                                  resolved_field->IsVolatile(),
+                                                                  field_index,
+                                                                  class_def_index,
+                                                                  *dex_file_,
+                                                                  dex_pc);
+    // A final reference field of an initialized class has already received its one and
+    // only value, so if that value is in the boot image, all future loads yield the same
+    // immune space reference and do not need a read barrier. Note that we check the
+    // actual initialization status here rather than `IsInitialized()`, whose static
+    // method/constructor shortcut can precede the class initializer. Reflective writes
+    // to final fields after initialization have unspecified semantics (JLS 17.5.3) and
+    // are not a supported way to invalidate this. java.lang.System is excluded because
+    // its `in`/`out`/`err` fields are final yet re-assigned through native code.
+    if (field_type == DataType::Type::kReference &&
+        klass->IsInitialized() &&
+        resolved_field->IsFinal() &&
+        !klass->DescriptorEquals("Ljava/lang/System;")) {
+      gc::Heap* heap = Runtime::Current()->GetHeap();
+      if (heap->ObjectIsInBootImageSpace(klass.Get())) {
+        ObjPtr<mirror::Object> value = resolved_field->GetObject(klass.Get());
+        if (value == nullptr || heap->ObjectIsInBootImageSpace(value)) {
+          field_get->SetLoadsBootImageValue();
+        }
+      }
+    }
+    AppendInstruction(field_get);
     UpdateLocal(source_or_dest_reg, current_block_->GetLastInstruction());
   }
 }
@@ -2742,6 +2742,260 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
   return true;
 }
 
+// Whether to fuse the %d conversion in TryReplaceStringFormat() below. This is a
+// deliberate deviation from java.util.Formatter, which localizes decimal digits for
+// locales whose zero digit is not the ASCII '0' (e.g. Persian); the fused stub always
+// produces ASCII digits. Logging-style format strings, the target of this
+// transformation, do not want localized output in the first place.
+static constexpr bool kFuseStringFormatDecimal = true;
+
+// Try to replace a call to String.format(String, Object...) with a constant format
+// string by the same single-pass HStringBuilderAppend runtime stub that serves fused
+// StringBuilder append chains; the stub computes the final length up front and fills
+// the result in one allocation.
+//
+// The format is decomposed at compile time: plain ASCII text becomes char arguments,
+// %s consumes the next element stored into the varargs array (which must be known to
+// be a java.lang.String) and %d consumes the int that was boxed for the element via
+// Integer.valueOf(). Everything else - width, flags, precision, argument indices,
+// other conversions, non-ASCII text - keeps the original call, as does any format
+// needing more than StringBuilderAppend::kMaxArgs units.
+static bool TryReplaceStringFormat(HInvokeStaticOrDirect* invoke) {
+  if (invoke->GetIntrinsic() != Intrinsics::kNone || invoke->CanThrowIntoCatchBlock()) {
+    return false;
+  }
+  if (invoke->GetType() != DataType::Type::kReference || invoke->GetNumberOfArguments() != 2u) {
+    return false;
+  }
+  HInstruction* format_arg = invoke->InputAt(0);
+  HInstruction* array_arg = invoke->InputAt(1);
+  if (!format_arg->IsLoadString() || !array_arg->IsNewArray()) {
+    return false;
+  }
+  HBasicBlock* block = invoke->GetBlock();
+  HNewArray* array = array_arg->AsNewArray();
+  if (array->GetBlock() != block || !array->GetLength()->IsIntConstant()) {
+    return false;
+  }
+
+  // String.format(String, Object[]) is the only two-argument "format" on String.
+  ArtMethod* method = invoke->GetResolvedMethod();
+  if (method == nullptr) {
+    return false;
+  }
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    if (!method->GetDeclaringClass()->IsStringClass() || method->GetNameView() != "format") {
+      return false;
+    }
+  }
+
+  // Decompose the format string into append units.
+  HGraph* graph = block->GetGraph();
+  HLoadString* load_string = format_arg->AsLoadString();
+  const char* format_data =
+      load_string->GetDexFile().StringDataByIdx(load_string->GetStringIndex());
+  StringBuilderAppend::Argument unit_kinds[StringBuilderAppend::kMaxArgs];
+  HInstruction* unit_values[StringBuilderAppend::kMaxArgs];
+  size_t unit_array_indexes[StringBuilderAppend::kMaxArgs];
+  uint32_t num_units = 0u;
+  int32_t num_specifiers = 0;
+  for (const char* ptr = format_data; *ptr != '\0'; ++ptr) {
+    char c = *ptr;
+    if ((c & 0x80) != 0) {
+      // Non-ASCII text; the MUTF-8 bytes no longer match the UTF-16 chars.
+      return false;
+    }
+    if (num_units == StringBuilderAppend::kMaxArgs) {
+      return false;
+    }
+    if (c == '%') {
+      char conversion = ptr[1];
+      if (conversion == 's') {
+        unit_kinds[num_units] = StringBuilderAppend::Argument::kString;
+      } else if (conversion == 'd' && kFuseStringFormatDecimal) {
+        unit_kinds[num_units] = StringBuilderAppend::Argument::kInt;
+      } else if (conversion == '%') {
+        unit_kinds[num_units] = StringBuilderAppend::Argument::kChar;
+        unit_values[num_units] = graph->GetIntConstant('%');
+      } else {
+        return false;
+      }
+      if (conversion != '%') {
+        unit_values[num_units] = nullptr;  // Filled from the varargs array below.
+        unit_array_indexes[num_units] = static_cast<size_t>(num_specifiers);
+        ++num_specifiers;
+      }
+      ++ptr;  // Skip the conversion character.
+    } else {
+      unit_kinds[num_units] = StringBuilderAppend::Argument::kChar;
+      unit_values[num_units] = graph->GetIntConstant(c);
+    }
+    ++num_units;
+  }
+  if (num_specifiers == 0) {
+    // Nothing to format; not worth special-casing (and String.format validated above
+    // only the conversions we recognized).
+    return false;
+  }
+  if (array->GetLength()->AsIntConstant()->GetValue() != num_specifiers) {
+    return false;
+  }
+
+  // The varargs array must be freshly allocated, filled once per element before the
+  // call and otherwise unused.
+  HInstruction* stored_values[StringBuilderAppend::kMaxArgs] = {};
+  for (const HUseListNode<HInstruction*>& use : array->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (user == invoke) {
+      DCHECK_EQ(use.GetIndex(), 1u);
+      continue;
+    }
+    if (!user->IsArraySet() ||
+        user->GetBlock() != block ||
+        use.GetIndex() != 0u ||
+        user->CanThrow() ||
+        !user->StrictlyDominates(invoke)) {
+      return false;
+    }
+    HArraySet* array_set = user->AsArraySet();
+    if (!array_set->InputAt(1)->IsIntConstant()) {
+      return false;
+    }
+    int32_t index = array_set->InputAt(1)->AsIntConstant()->GetValue();
+    if (index < 0 || index >= num_specifiers || stored_values[index] != nullptr) {
+      return false;
+    }
+    stored_values[index] = array_set->InputAt(2);
+  }
+  for (int32_t i = 0; i != num_specifiers; ++i) {
+    if (stored_values[i] == nullptr) {
+      return false;
+    }
+  }
+
+  // Classify the stored values against the specifiers. For %d we look through the
+  // Integer.valueOf() boxing and pass the int, so the boxing call must become dead.
+  HInstruction* boxing_calls[StringBuilderAppend::kMaxArgs];
+  uint32_t num_boxing_calls = 0u;
+  for (size_t i = 0; i != num_units; ++i) {
+    if (unit_values[i] != nullptr) {
+      continue;  // Literal character.
+    }
+    HInstruction* value = stored_values[unit_array_indexes[i]];
+    if (unit_kinds[i] == StringBuilderAppend::Argument::kString) {
+      ReferenceTypeInfo rti = value->GetReferenceTypeInfo();
+      if (!rti.IsValid()) {
+        return false;
+      }
+      ScopedObjectAccess soa(Thread::Current());
+      if (rti.GetTypeHandle().Get() != GetClassRoot<mirror::String>()) {
+        return false;
+      }
+      unit_values[i] = value;
+    } else {
+      DCHECK(unit_kinds[i] == StringBuilderAppend::Argument::kInt);
+      if (!value->IsInvokeStaticOrDirect() ||
+          value->AsInvokeStaticOrDirect()->GetIntrinsic() != Intrinsics::kIntegerValueOf) {
+        return false;
+      }
+      unit_values[i] = value->InputAt(0);
+      DCHECK_EQ(unit_values[i]->GetType(), DataType::Type::kInt32);
+      bool seen = false;
+      for (uint32_t j = 0; j != num_boxing_calls; ++j) {
+        seen = seen || boxing_calls[j] == value;
+      }
+      if (!seen) {
+        boxing_calls[num_boxing_calls] = value;
+        ++num_boxing_calls;
+      }
+    }
+  }
+
+  // All instructions feeding the call shall be removed; check that nothing else
+  // observes them, directly or through an environment.
+  auto is_removable = [&](HInstruction* user) {
+    if (user == invoke || (user->IsArraySet() && user->InputAt(0) == array)) {
+      return true;
+    }
+    for (uint32_t j = 0; j != num_boxing_calls; ++j) {
+      if (boxing_calls[j] == user) {
+        return true;
+      }
+    }
+    return false;
+  };
+  for (const HUseListNode<HEnvironment*>& use : array->GetEnvUses()) {
+    if (!is_removable(use.GetUser()->GetHolder())) {
+      return false;
+    }
+  }
+  for (uint32_t j = 0; j != num_boxing_calls; ++j) {
+    for (const HUseListNode<HInstruction*>& use : boxing_calls[j]->GetUses()) {
+      if (!(use.GetUser()->IsArraySet() && use.GetUser()->InputAt(0) == array)) {
+        return false;
+      }
+    }
+    for (const HUseListNode<HEnvironment*>& use : boxing_calls[j]->GetEnvUses()) {
+      if (!is_removable(use.GetUser()->GetHolder())) {
+        return false;
+      }
+    }
+  }
+
+  // Create the replacement instruction; argument i corresponds to the format bits
+  // at position i, matching the order StringBuilderAppend::AppendF() consumes them.
+  uint32_t format = 0u;
+  for (size_t i = 0; i != num_units; ++i) {
+    format |= static_cast<uint32_t>(unit_kinds[i]) << (i * StringBuilderAppend::kBitsPerArg);
+  }
+  HIntConstant* fmt = graph->GetIntConstant(static_cast<int32_t>(format));
+  ArenaAllocator* allocator = graph->GetAllocator();
+  HStringBuilderAppend* append =
+      new (allocator) HStringBuilderAppend(fmt, num_units, allocator, invoke->GetDexPc());
+  append->SetReferenceTypeInfo(invoke->GetReferenceTypeInfo());
+  for (size_t i = 0; i != num_units; ++i) {
+    append->SetArgumentAt(i, unit_values[i]);
+  }
+  block->InsertInstructionBefore(append, invoke);
+  DCHECK(!append->CanBeNull());
+  invoke->ReplaceWith(append);
+  // Copy environment, except for the instructions being removed; their values are
+  // dead apart from debugging (same treatment as the StringBuilder pattern above).
+  for (HEnvironment* env = invoke->GetEnvironment(); env != nullptr; env = env->GetParent()) {
+    for (size_t i = 0, size = env->Size(); i != size; ++i) {
+      HInstruction* at = env->GetInstructionAt(i);
+      if (at != nullptr && (at == array || is_removable(at)) && at != invoke) {
+        env->RemoveAsUserOfInput(i);
+        env->SetRawEnvAt(i, /*instruction=*/ nullptr);
+      }
+    }
+  }
+  append->CopyEnvironmentFrom(invoke->GetEnvironment());
+  // Remove the old invoke, the array stores, the boxing calls and the array. The
+  // boxing calls may reference each other through environments, so remove them
+  // bottom-up as they become unused.
+  block->RemoveInstruction(invoke);
+  while (array->HasNonEnvironmentUses()) {
+    block->RemoveInstruction(array->GetUses().front().GetUser());
+  }
+  for (uint32_t remaining = num_boxing_calls; remaining != 0u; ) {
+    uint32_t old_remaining = remaining;
+    for (uint32_t j = 0; j != num_boxing_calls; ++j) {
+      HInstruction* boxing = boxing_calls[j];
+      if (boxing != nullptr && !boxing->HasUses() && !boxing->HasEnvironmentUses()) {
+        block->RemoveInstruction(boxing);
+        boxing_calls[j] = nullptr;
+        --remaining;
+      }
+    }
+    CHECK_NE(remaining, old_remaining);
+  }
+  DCHECK(!array->HasEnvironmentUses());
+  block->RemoveInstruction(array);
+  return true;
+}
+
 // Certain allocation intrinsics are not removed by dead code elimination
 // because of potentially throwing an OOM exception or other side effects.
 // This method removes such intrinsics when special circumstances allow.
@@ -2843,6 +3097,12 @@ void InstructionSimplifierVisitor::VisitInvoke(HInvoke* instruction) {
       // These are replaced by intermediate representation in the instruction builder.
       LOG(FATAL) << "Unexpected " << static_cast<Intrinsics>(instruction->GetIntrinsic());
       UNREACHABLE();
+    case Intrinsics::kNone:
+      if (instruction->IsInvokeStaticOrDirect() &&
+          TryReplaceStringFormat(instruction->AsInvokeStaticOrDirect())) {
+        RecordSimplification();
+      }
+      break;
     default:
       break;
   }
@@ -1093,6 +1093,80 @@ static void GenerateCompareAndSet(CodeGeneratorARM64* codegen,
       (order == std::memory_order_release) || (order == std::memory_order_seq_cst);
   DCHECK(use_load_acquire || use_store_release || order == std::memory_order_relaxed);
 
+  if (codegen->GetInstructionSetFeatures().HasLSE() && !expected2.IsValid()) {
+    // A single CAS instruction replaces the load/store-exclusive loop. (We cannot
+    // use it with a valid `expected2` as it compares against only one value.)
+    // The instruction takes the expected value in the register that receives the
+    // old value and compares it against raw memory contents, so the copy of the
+    // expected reference must have heap poisoning applied.
+    __ Mov(old_value, expected);
+    if (type == DataType::Type::kReference) {
+      assembler->MaybePoisonHeapReference(old_value);
+      assembler->MaybePoisonHeapReference(new_value);
+    }
+    switch (type) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        if (use_load_acquire && use_store_release) {
+          __ Casalb(old_value, new_value, MemOperand(ptr));
+        } else if (use_load_acquire) {
+          __ Casab(old_value, new_value, MemOperand(ptr));
+        } else if (use_store_release) {
+          __ Caslb(old_value, new_value, MemOperand(ptr));
+        } else {
+          __ Casb(old_value, new_value, MemOperand(ptr));
+        }
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        if (use_load_acquire && use_store_release) {
+          __ Casalh(old_value, new_value, MemOperand(ptr));
+        } else if (use_load_acquire) {
+          __ Casah(old_value, new_value, MemOperand(ptr));
+        } else if (use_store_release) {
+          __ Caslh(old_value, new_value, MemOperand(ptr));
+        } else {
+          __ Cash(old_value, new_value, MemOperand(ptr));
+        }
+        break;
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+      case DataType::Type::kReference:
+        if (use_load_acquire && use_store_release) {
+          __ Casal(old_value, new_value, MemOperand(ptr));
+        } else if (use_load_acquire) {
+          __ Casa(old_value, new_value, MemOperand(ptr));
+        } else if (use_store_release) {
+          __ Casl(old_value, new_value, MemOperand(ptr));
+        } else {
+          __ Cas(old_value, new_value, MemOperand(ptr));
+        }
+        break;
+      default:
+        LOG(FATAL) << "Unexpected type: " << type;
+        UNREACHABLE();
+    }
+    if (type == DataType::Type::kReference) {
+      assembler->MaybeUnpoisonHeapReference(old_value);
+      assembler->MaybeUnpoisonHeapReference(new_value);
+    } else if (type == DataType::Type::kInt8) {
+      __ Sxtb(old_value, old_value);
+    } else if (type == DataType::Type::kInt16) {
+      __ Sxth(old_value, old_value);
+    }
+    // The CAS instruction does not set flags, so compare the old value with the
+    // expected value to provide the flag Z as described for the loop below.
+    __ Cmp(old_value, expected);
+    if (!strong) {
+      // A CAS instruction cannot fail spuriously, so the store result is needed
+      // only to report success by 1 in the same way as the loop below does.
+      __ Cset(store_result, eq);
+    }
+    __ B(cmp_failure, ne);
+    return;
+  }
+
   // repeat: {
   //   old_value = [ptr];  // Load exclusive.
   //   if (old_value != expected && old_value != expected2) goto cmp_failure;
@@ -1391,6 +1465,106 @@ enum class GetAndUpdateOp {
   kXor
 };
 
+// Memory operations from ARMv8.1 LSE that atomically load the old value and
+// store a combination of the old value and the argument.
+enum class LoadAtomicOp {
+  kAdd,
+  kClear,
+  kEor,
+  kSet
+};
+
+// The LSE mnemonics are formed as <op>[a][l][b|h] for the memory order
+// (acquire and/or release) and the size of the data (byte, halfword or the
+// size of the registers). All of them take the argument first, then the
+// register that receives the old value and finally the location.
+#define EMIT_LSE_ATOMIC_OP(op)                                  \
+  do {                                                          \
+    switch (type) {                                             \
+      case DataType::Type::kBool:                               \
+      case DataType::Type::kUint8:                              \
+      case DataType::Type::kInt8:                               \
+        if (use_load_acquire && use_store_release) {            \
+          __ op##alb(arg, old_value, MemOperand(ptr));          \
+        } else if (use_load_acquire) {                          \
+          __ op##ab(arg, old_value, MemOperand(ptr));           \
+        } else if (use_store_release) {                         \
+          __ op##lb(arg, old_value, MemOperand(ptr));           \
+        } else {                                                \
+          __ op##b(arg, old_value, MemOperand(ptr));            \
+        }                                                       \
+        break;                                                  \
+      case DataType::Type::kUint16:                             \
+      case DataType::Type::kInt16:                              \
+        if (use_load_acquire && use_store_release) {            \
+          __ op##alh(arg, old_value, MemOperand(ptr));          \
+        } else if (use_load_acquire) {                          \
+          __ op##ah(arg, old_value, MemOperand(ptr));           \
+        } else if (use_store_release) {                         \
+          __ op##lh(arg, old_value, MemOperand(ptr));           \
+        } else {                                                \
+          __ op##h(arg, old_value, MemOperand(ptr));            \
+        }                                                       \
+        break;                                                  \
+      case DataType::Type::kInt32:                              \
+      case DataType::Type::kInt64:                              \
+      case DataType::Type::kReference:                          \
+        if (use_load_acquire && use_store_release) {            \
+          __ op##al(arg, old_value, MemOperand(ptr));           \
+        } else if (use_load_acquire) {                          \
+          __ op##a(arg, old_value, MemOperand(ptr));            \
+        } else if (use_store_release) {                         \
+          __ op##l(arg, old_value, MemOperand(ptr));            \
+        } else {                                                \
+          __ op(arg, old_value, MemOperand(ptr));               \
+        }                                                       \
+        break;                                                  \
+      default:                                                  \
+        LOG(FATAL) << "Unexpected type: " << type;              \
+        UNREACHABLE();                                          \
+    }                                                           \
+  } while (0)
+
+// Emit an atomic swap (SWP and variants), leaving the old value in `old_value`.
+static void EmitSwap(MacroAssembler* masm,
+                     DataType::Type type,
+                     bool use_load_acquire,
+                     bool use_store_release,
+                     Register arg,
+                     Register old_value,
+                     Register ptr) {
+  EMIT_LSE_ATOMIC_OP(Swp);
+}
+
+// Emit an atomic load-<op> instruction (LDADD, LDCLR, LDEOR, LDSET and variants)
+// that applies the operation with `arg` to the memory at `ptr` and leaves the
+// old value in `old_value`.
+static void EmitLoadAtomicOp(MacroAssembler* masm,
+                             LoadAtomicOp op,
+                             DataType::Type type,
+                             bool use_load_acquire,
+                             bool use_store_release,
+                             Register arg,
+                             Register old_value,
+                             Register ptr) {
+  switch (op) {
+    case LoadAtomicOp::kAdd:
+      EMIT_LSE_ATOMIC_OP(Ldadd);
+      break;
+    case LoadAtomicOp::kClear:
+      EMIT_LSE_ATOMIC_OP(Ldclr);
+      break;
+    case LoadAtomicOp::kEor:
+      EMIT_LSE_ATOMIC_OP(Ldeor);
+      break;
+    case LoadAtomicOp::kSet:
+      EMIT_LSE_ATOMIC_OP(Ldset);
+      break;
+  }
+}
+
+#undef EMIT_LSE_ATOMIC_OP
+
 static void GenerateGetAndUpdate(CodeGeneratorARM64* codegen,
                                  GetAndUpdateOp get_and_update_op,
                                  DataType::Type load_store_type,
@@ -1400,9 +1574,64 @@ static void GenerateGetAndUpdate(CodeGeneratorARM64* codegen,
                                  CPURegister old_value) {
   MacroAssembler* masm = codegen->GetVIXLAssembler();
   UseScratchRegisterScope temps(masm);
-  Register store_result = temps.AcquireW();
+
+  bool use_load_acquire =
+      (order == std::memory_order_acquire) || (order == std::memory_order_seq_cst);
+  bool use_store_release =
+      (order == std::memory_order_release) || (order == std::memory_order_seq_cst);
+  DCHECK(use_load_acquire || use_store_release);
 
   DCHECK_EQ(old_value.GetSizeInBits(), arg.GetSizeInBits());
+  if (codegen->GetInstructionSetFeatures().HasLSE() &&
+      !arg.IsVRegister() &&
+      get_and_update_op != GetAndUpdateOp::kAddWithByteSwap) {
+    // Single atomic instructions replace the load/store-exclusive loop. Floating
+    // point addition and the byte-swapped addition still need to calculate the
+    // new value in registers and therefore keep using the CAS loop below.
+    Arm64Assembler* assembler = codegen->GetAssembler();
+    Register old_value_reg = old_value.IsX() ? old_value.X() : old_value.W();
+    Register arg_reg = arg.IsX() ? arg.X() : arg.W();
+    switch (get_and_update_op) {
+      case GetAndUpdateOp::kSet:
+        if (load_store_type == DataType::Type::kReference) {
+          assembler->MaybePoisonHeapReference(arg_reg);
+        }
+        EmitSwap(masm, load_store_type, use_load_acquire, use_store_release,
+                 arg_reg, old_value_reg, ptr);
+        if (load_store_type == DataType::Type::kReference) {
+          assembler->MaybeUnpoisonHeapReference(arg_reg);
+          assembler->MaybeUnpoisonHeapReference(old_value_reg);
+        }
+        break;
+      case GetAndUpdateOp::kAdd:
+        EmitLoadAtomicOp(masm, LoadAtomicOp::kAdd, load_store_type, use_load_acquire,
+                         use_store_release, arg_reg, old_value_reg, ptr);
+        break;
+      case GetAndUpdateOp::kAnd: {
+        // The memory operation is a bit clear; apply it to the inverted argument.
+        Register inverted_arg = arg.IsX() ? temps.AcquireX() : temps.AcquireW();
+        __ Mvn(inverted_arg, arg_reg);
+        EmitLoadAtomicOp(masm, LoadAtomicOp::kClear, load_store_type, use_load_acquire,
+                         use_store_release, inverted_arg, old_value_reg, ptr);
+        break;
+      }
+      case GetAndUpdateOp::kOr:
+        EmitLoadAtomicOp(masm, LoadAtomicOp::kSet, load_store_type, use_load_acquire,
+                         use_store_release, arg_reg, old_value_reg, ptr);
+        break;
+      case GetAndUpdateOp::kXor:
+        EmitLoadAtomicOp(masm, LoadAtomicOp::kEor, load_store_type, use_load_acquire,
+                         use_store_release, arg_reg, old_value_reg, ptr);
+        break;
+      case GetAndUpdateOp::kAddWithByteSwap:
+        LOG(FATAL) << "Unexpected op for LSE atomics";
+        UNREACHABLE();
+    }
+    return;
+  }
+
+  Register store_result = temps.AcquireW();
+
   Register old_value_reg;
   Register new_value;
   switch (get_and_update_op) {
@@ -1426,12 +1655,6 @@ static void GenerateGetAndUpdate(CodeGeneratorARM64* codegen,
       break;
   }
 
-  bool use_load_acquire =
-      (order == std::memory_order_acquire) || (order == std::memory_order_seq_cst);
-  bool use_store_release =
-      (order == std::memory_order_release) || (order == std::memory_order_seq_cst);
-  DCHECK(use_load_acquire || use_store_release);
-
   vixl::aarch64::Label loop_label;
   __ Bind(&loop_label);
   EmitLoadExclusive(codegen, load_store_type, ptr, old_value_reg, use_load_acquire);
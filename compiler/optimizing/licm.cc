@@ -61,6 +61,24 @@ static bool InputsAreDefinedBeforeLoop(HInstruction* instruction) {
   return true;
 }
 
+/**
+ * Returns whether `block` dominates every block from which the loop can be
+ * left. When it does, a throwing instruction in `block` is guaranteed to
+ * execute before any normal exit of the loop, so hoisting it to the
+ * pre-header cannot introduce an exception that would not have occurred.
+ */
+static bool DominatesAllLoopExits(HBasicBlock* block, HLoopInformation* loop_info) {
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    HBasicBlock* loop_block = it.Current();
+    for (HBasicBlock* successor : loop_block->GetSuccessors()) {
+      if (!loop_info->Contains(*successor) && !block->Dominates(loop_block)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 /**
  * If `environment` has a loop header phi, we replace it with its first input.
  */
@@ -102,12 +120,22 @@ bool LICM::Run() {
     SideEffects loop_effects = side_effects_.GetLoopEffects(block);
     HBasicBlock* pre_header = loop_info->GetPreHeader();
 
-    for (HBlocksInLoopIterator it_loop(*loop_info); !it_loop.Done(); it_loop.Advance()) {
+    // We can move an instruction that can throw only as long as no visible
+    // instruction (throw or write) may execute before it within the first
+    // iteration of the loop. Visiting the loop blocks in reverse post order
+    // keeps this flag consistent with execution order across block boundaries.
+    bool found_first_non_hoisted_visible_instruction_in_loop = false;
+    for (HBlocksInLoopReversePostOrderIterator it_loop(*loop_info);
+         !it_loop.Done();
+         it_loop.Advance()) {
       HBasicBlock* inner = it_loop.Current();
       DCHECK(inner->IsInLoop());
       if (inner->GetLoopInformation() != loop_info) {
         // Thanks to post order visit, inner loops were already visited.
         DCHECK(visited->IsBitSet(inner->GetBlockId()));
+        // The inner loop may write, throw or fail to terminate; conservatively
+        // stop hoisting throwing instructions past it.
+        found_first_non_hoisted_visible_instruction_in_loop = true;
         continue;
       }
       if (kIsDebugBuild) {
@@ -121,11 +149,9 @@ bool LICM::Run() {
       }
       DCHECK(!loop_info->IsIrreducible());
 
-      // We can move an instruction that can throw only as long as it is the first visible
-      // instruction (throw or write) in the loop. Note that the first potentially visible
-      // instruction that is not hoisted stops this optimization. Non-throwing instructions,
-      // on the other hand, can still be hoisted.
-      bool found_first_non_hoisted_visible_instruction_in_loop = !inner->IsLoopHeader();
+      // Note that the first potentially visible instruction that is not hoisted stops
+      // hoisting of throwing instructions. Non-throwing instructions, on the other
+      // hand, can still be hoisted.
       for (HInstructionIterator inst_it(inner->GetInstructions());
            !inst_it.Done();
            inst_it.Advance()) {
@@ -134,13 +160,16 @@ bool LICM::Run() {
         if (instruction->CanBeMoved() && InputsAreDefinedBeforeLoop(instruction)) {
           if (instruction->CanThrow()) {
             if (!found_first_non_hoisted_visible_instruction_in_loop) {
-              DCHECK(instruction->GetBlock()->IsLoopHeader());
-              if (instruction->IsClinitCheck()) {
+              if (instruction->IsClinitCheck() && inner->IsLoopHeader()) {
                 // clinit is only done once, and since all visible instructions
                 // in the loop header so far have been hoisted out, we can hoist
                 // the clinit check out also.
                 can_move = true;
-              } else if (!instruction->GetSideEffects().MayDependOn(loop_effects)) {
+              } else if (!instruction->GetSideEffects().MayDependOn(loop_effects) &&
+                         DominatesAllLoopExits(inner, loop_info)) {
+                // Loop-invariant checks such as HBoundsCheck and HNullCheck in
+                // the loop body can be hoisted as long as they are guaranteed
+                // to execute before the loop can be left.
                 can_move = true;
               }
             }
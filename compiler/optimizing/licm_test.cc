@@ -87,6 +87,49 @@ class LICMTest : public OptimizingUnitTest {
     exit_->AddInstruction(new (GetAllocator()) HExit());
   }
 
+  // Builds a do-while-shaped loop in CFG: the loop is left from the loop body
+  // rather than from the loop header, so the body dominates the loop exit.
+  void BuildDoWhileLoop() {
+    entry_ = new (GetAllocator()) HBasicBlock(graph_);
+    loop_preheader_ = new (GetAllocator()) HBasicBlock(graph_);
+    loop_header_ = new (GetAllocator()) HBasicBlock(graph_);
+    loop_body_ = new (GetAllocator()) HBasicBlock(graph_);
+    return_ = new (GetAllocator()) HBasicBlock(graph_);
+    exit_ = new (GetAllocator()) HBasicBlock(graph_);
+
+    graph_->AddBlock(entry_);
+    graph_->AddBlock(loop_preheader_);
+    graph_->AddBlock(loop_header_);
+    graph_->AddBlock(loop_body_);
+    graph_->AddBlock(return_);
+    graph_->AddBlock(exit_);
+
+    graph_->SetEntryBlock(entry_);
+    graph_->SetExitBlock(exit_);
+
+    // Set up loop flow in CFG.
+    entry_->AddSuccessor(loop_preheader_);
+    loop_preheader_->AddSuccessor(loop_header_);
+    loop_header_->AddSuccessor(loop_body_);
+    loop_body_->AddSuccessor(loop_header_);
+    loop_body_->AddSuccessor(return_);
+    return_->AddSuccessor(exit_);
+
+    // Provide boiler-plate instructions.
+    parameter_ = new (GetAllocator()) HParameterValue(graph_->GetDexFile(),
+                                                      dex::TypeIndex(0),
+                                                      0,
+                                                      DataType::Type::kReference);
+    entry_->AddInstruction(parameter_);
+    int_constant_ = graph_->GetIntConstant(42);
+    float_constant_ = graph_->GetFloatConstant(42.0f);
+    loop_preheader_->AddInstruction(new (GetAllocator()) HGoto());
+    loop_header_->AddInstruction(new (GetAllocator()) HGoto());
+    loop_body_->AddInstruction(new (GetAllocator()) HIf(parameter_));
+    return_->AddInstruction(new (GetAllocator()) HReturnVoid());
+    exit_->AddInstruction(new (GetAllocator()) HExit());
+  }
+
   // Performs LICM optimizations (after proper set up).
   void PerformLICM() {
     graph_->BuildDominatorTree();
@@ -211,4 +254,30 @@ TEST_F(LICMTest, NoArrayHoisting) {
   EXPECT_EQ(set_array->GetBlock(), loop_body_);
 }
 
+TEST_F(LICMTest, InvariantCheckHoisting) {
+  BuildDoWhileLoop();
+
+  // A loop-invariant null check in the loop body dominates the loop exit and
+  // can be hoisted even though it may throw.
+  HInstruction* null_check = new (GetAllocator()) HNullCheck(parameter_, 0);
+  loop_body_->InsertInstructionBefore(null_check, loop_body_->GetLastInstruction());
+
+  EXPECT_EQ(null_check->GetBlock(), loop_body_);
+  PerformLICM();
+  EXPECT_EQ(null_check->GetBlock(), loop_preheader_);
+}
+
+TEST_F(LICMTest, NoInvariantCheckHoisting) {
+  BuildLoop();
+
+  // The loop is left from the loop header, so a null check in the loop body
+  // is not guaranteed to execute and must not be hoisted.
+  HInstruction* null_check = new (GetAllocator()) HNullCheck(parameter_, 0);
+  loop_body_->InsertInstructionBefore(null_check, loop_body_->GetLastInstruction());
+
+  EXPECT_EQ(null_check->GetBlock(), loop_body_);
+  PerformLICM();
+  EXPECT_EQ(null_check->GetBlock(), loop_body_);
+}
+
 }  // namespace art
@@ -1169,7 +1169,22 @@ class LSEVisitor final : private HGraphDelegateVisitor {
   void VisitNewInstance(HNewInstance* new_instance) override {
     ReferenceInfo* ref_info = heap_location_collector_.FindReferenceInfoOf(new_instance);
     if (ref_info == nullptr) {
-      // new_instance isn't used for field accesses. No need to process it.
+      // new_instance isn't used for field accesses, so LSA created no reference info
+      // for it. The allocation itself may still be removable if it does not escape;
+      // DCE cannot remove it since HNewInstance can throw.
+      if (!new_instance->NeedsChecks() && !new_instance->IsFinalizable()) {
+        bool is_singleton;
+        bool is_singleton_and_not_returned;
+        bool is_singleton_and_not_deopt_visible;
+        CalculateEscape(new_instance,
+                        /* no_escape_fn= */ nullptr,
+                        &is_singleton,
+                        &is_singleton_and_not_returned,
+                        &is_singleton_and_not_deopt_visible);
+        if (is_singleton_and_not_returned && is_singleton_and_not_deopt_visible) {
+          singleton_new_instances_.push_back(new_instance);
+        }
+      }
       return;
     }
     if (ref_info->IsSingletonAndRemovable() && !new_instance->NeedsChecks()) {
@@ -1202,7 +1217,22 @@ class LSEVisitor final : private HGraphDelegateVisitor {
   void VisitNewArray(HNewArray* new_array) override {
     ReferenceInfo* ref_info = heap_location_collector_.FindReferenceInfoOf(new_array);
     if (ref_info == nullptr) {
-      // new_array isn't used for array accesses. No need to process it.
+      // new_array isn't used for array accesses. As for HNewInstance above, the
+      // allocation may still be removable if it cannot throw and does not escape.
+      if (new_array->GetLength()->IsIntConstant() &&
+          new_array->GetLength()->AsIntConstant()->GetValue() >= 0) {
+        bool is_singleton;
+        bool is_singleton_and_not_returned;
+        bool is_singleton_and_not_deopt_visible;
+        CalculateEscape(new_array,
+                        /* no_escape_fn= */ nullptr,
+                        &is_singleton,
+                        &is_singleton_and_not_returned,
+                        &is_singleton_and_not_deopt_visible);
+        if (is_singleton_and_not_returned && is_singleton_and_not_deopt_visible) {
+          singleton_new_instances_.push_back(new_array);
+        }
+      }
       return;
     }
     if (ref_info->IsSingletonAndRemovable()) {
@@ -998,6 +998,29 @@ TEST_F(LoadStoreEliminationTest, LoadDefaultValue) {
   ASSERT_FALSE(IsRemoved(store));
 }
 
+// An allocation that is never used for field accesses gets no heap location from
+// LSA, but it can still be eliminated when escape analysis shows it is unobservable.
+TEST_F(LoadStoreEliminationTest, UnusedNewInstanceElimination) {
+  CreateTestControlFlowGraph();
+
+  HInstruction* c0 = graph_->GetIntConstant(0);
+
+  HInstruction* cls = MakeClassLoad();
+  HInstruction* new_inst = MakeNewInstance(cls);
+  pre_header_->InsertInstructionBefore(cls, pre_header_->GetLastInstruction());
+  pre_header_->InsertInstructionBefore(new_inst, pre_header_->GetLastInstruction());
+  cls->CopyEnvironmentFrom(suspend_check_->GetEnvironment());
+  new_inst->CopyEnvironmentFrom(suspend_check_->GetEnvironment());
+
+  // array[0] = 1, so that the graph has a heap location and LSE runs.
+  HInstruction* store = AddArraySet(return_block_, array_, c0);
+
+  PerformLSE();
+
+  EXPECT_INS_REMOVED(new_inst);
+  EXPECT_INS_RETAINED(store);
+}
+
 // As it is not allowed to use defaults for VecLoads but allowed for regular loads,
 // check if there is a new created array, a VecLoad and a load used in a loop and after it,
 // VecLoad is not replaced with a default but the load is.
@@ -22,10 +22,12 @@
 #include "arch/x86/instruction_set_features_x86.h"
 #include "arch/x86_64/instruction_set_features_x86_64.h"
 #include "code_generator.h"
+#include "dex/method_reference.h"
 #include "driver/compiler_options.h"
 #include "linear_order.h"
 #include "mirror/array-inl.h"
 #include "mirror/string.h"
+#include "profile/profile_compilation_info.h"
 
 namespace art {
 
@@ -885,7 +887,24 @@ bool HLoopOptimization::TryFullUnrolling(LoopAnalysisInfo* analysis_info, bool g
   return true;
 }
 
+bool HLoopOptimization::IsScalarPeelingAndUnrollingAllowed() const {
+  // Peeling and unrolling duplicate loop code, so the transformations are only worth the
+  // code size growth for loops which actually run hot. Without profile information stay
+  // optimistic and rely on the architecture-specific heuristics alone; with a profile
+  // restrict the transformations to methods the profile marks as hot.
+  const ProfileCompilationInfo* profile = compiler_options_->GetProfileCompilationInfo();
+  if (profile == nullptr) {
+    return true;
+  }
+  MethodReference method_ref(&graph_->GetDexFile(), graph_->GetMethodIdx());
+  return profile->GetMethodHotness(method_ref).IsHot();
+}
+
 bool HLoopOptimization::TryPeelingAndUnrolling(LoopNode* node) {
+  if (!IsScalarPeelingAndUnrollingAllowed()) {
+    return false;
+  }
+
   HLoopInformation* loop_info = node->loop_info;
   int64_t trip_count = LoopAnalysis::GetLoopTripCount(loop_info, &induction_range_);
   LoopAnalysisInfo analysis_info(loop_info);
@@ -163,6 +163,11 @@ class HLoopOptimization : public HOptimization {
   // should be actually applied.
   bool TryFullUnrolling(LoopAnalysisInfo* analysis_info, bool generate_code = true);
 
+  // Returns whether the code-expanding scalar transformations (peeling, unrolling) may be
+  // applied to the method being compiled. With profile information available they are
+  // restricted to hot methods so that rarely executed loops do not pay the code size cost.
+  bool IsScalarPeelingAndUnrollingAllowed() const;
+
   // Tries to apply scalar loop peeling and unrolling.
   bool TryPeelingAndUnrolling(LoopNode* node);
 
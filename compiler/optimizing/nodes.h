@@ -7289,6 +7289,12 @@ class HStaticFieldGet final : public HExpression<1> {
   DataType::Type GetFieldType() const { return field_info_.GetFieldType(); }
   bool IsVolatile() const { return field_info_.IsVolatile(); }
 
+  // Whether this load always yields the same reference into the boot image (or null),
+  // allowing code generators to elide the read barrier. Set only for final fields of
+  // initialized boot image classes; see HInstructionBuilder::BuildStaticFieldAccess().
+  bool LoadsBootImageValue() const { return GetPackedFlag<kFlagLoadsBootImageValue>(); }
+  void SetLoadsBootImageValue() { SetPackedFlag<kFlagLoadsBootImageValue>(true); }
+
   void SetType(DataType::Type new_type) {
     DCHECK(DataType::IsIntegralType(GetType()));
     DCHECK(DataType::IsIntegralType(new_type));
@@ -7302,6 +7308,11 @@ class HStaticFieldGet final : public HExpression<1> {
   DEFAULT_COPY_CONSTRUCTOR(StaticFieldGet);
 
  private:
+  static constexpr size_t kFlagLoadsBootImageValue = kNumberOfGenericPackedBits;
+  static constexpr size_t kNumberOfStaticFieldGetPackedBits = kFlagLoadsBootImageValue + 1;
+  static_assert(kNumberOfStaticFieldGetPackedBits <= HInstruction::kMaxNumberOfPackedBits,
+                "Too many packed fields.");
+
   const FieldInfo field_info_;
 };
 
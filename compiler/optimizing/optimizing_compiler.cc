@@ -16,9 +16,11 @@
 
 #include "optimizing_compiler.h"
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 #include <stdint.h>
 
@@ -405,12 +407,35 @@ class OptimizingCompiler final : public Compiler {
   // This must be called before any other function that dumps data to the cfg
   void DumpInstructionSetFeaturesToCfg() const;
 
+  // When --dump-stats is enabled, remember `method_name` if it ranks among the
+  // methods with the largest arena memory use, together with its per-kind
+  // breakdown. The retained methods are reported by DumpArenaMemoryUse() when
+  // the compiler is destroyed.
+  void MaybeRecordArenaMemoryUse(const std::string& method_name,
+                                 size_t total_allocated,
+                                 ArenaAllocator* allocator,
+                                 ArenaStack* arena_stack) const;
+  void DumpArenaMemoryUse() const;
+
   std::unique_ptr<OptimizingCompilerStats> compilation_stats_;
 
   std::unique_ptr<std::ostream> visualizer_output_;
 
   mutable Mutex dump_mutex_;  // To synchronize visualizer writing.
 
+  // Number of methods whose arena memory use is retained for the --dump-stats report.
+  static constexpr size_t kArenaMemoryUseTopMethods = 10;
+
+  struct ArenaMemoryUse {
+    size_t total_allocated;
+    std::string method_name;
+    std::string details;
+  };
+
+  // Methods with the largest arena memory use, sorted by decreasing size.
+  mutable Mutex memory_use_mutex_;
+  mutable std::vector<ArenaMemoryUse> arena_memory_use_ GUARDED_BY(memory_use_mutex_);
+
   DISALLOW_COPY_AND_ASSIGN(OptimizingCompiler);
 };
 
@@ -419,7 +444,8 @@ static const int kMaximumCompilationTimeBeforeWarning = 100; /* ms */
 OptimizingCompiler::OptimizingCompiler(const CompilerOptions& compiler_options,
                                        CompiledMethodStorage* storage)
     : Compiler(compiler_options, storage, kMaximumCompilationTimeBeforeWarning),
-      dump_mutex_("Visualizer dump lock") {
+      dump_mutex_("Visualizer dump lock"),
+      memory_use_mutex_("Arena memory use lock") {
   // Enable C1visualizer output.
   const std::string& cfg_file_name = compiler_options.GetDumpCfgFileName();
   if (!cfg_file_name.empty()) {
@@ -436,7 +462,50 @@ OptimizingCompiler::OptimizingCompiler(const CompilerOptions& compiler_options,
 OptimizingCompiler::~OptimizingCompiler() {
   if (compilation_stats_.get() != nullptr) {
     compilation_stats_->Log();
+    DumpArenaMemoryUse();
+  }
+}
+
+void OptimizingCompiler::MaybeRecordArenaMemoryUse(const std::string& method_name,
+                                                   size_t total_allocated,
+                                                   ArenaAllocator* allocator,
+                                                   ArenaStack* arena_stack) const {
+  if (compilation_stats_.get() == nullptr) {
+    return;
+  }
+  MutexLock mu(Thread::Current(), memory_use_mutex_);
+  if (arena_memory_use_.size() == kArenaMemoryUseTopMethods &&
+      total_allocated <= arena_memory_use_.back().total_allocated) {
+    return;
   }
+  // Build the per-kind breakdown only for methods that actually enter the list.
+  std::ostringstream details;
+  MemStats mem_stats(allocator->GetMemStats());
+  MemStats peak_stats(arena_stack->GetPeakStats());
+  details << Dumpable<MemStats>(mem_stats) << Dumpable<MemStats>(peak_stats);
+  auto insert_pos = std::find_if(arena_memory_use_.begin(),
+                                 arena_memory_use_.end(),
+                                 [total_allocated](const ArenaMemoryUse& use) {
+                                   return use.total_allocated < total_allocated;
+                                 });
+  arena_memory_use_.insert(insert_pos,
+                           ArenaMemoryUse{total_allocated, method_name, details.str()});
+  if (arena_memory_use_.size() > kArenaMemoryUseTopMethods) {
+    arena_memory_use_.pop_back();
+  }
+}
+
+void OptimizingCompiler::DumpArenaMemoryUse() const {
+  MutexLock mu(Thread::Current(), memory_use_mutex_);
+  if (arena_memory_use_.empty()) {
+    return;
+  }
+  std::ostringstream oss;
+  oss << "Methods with the largest arena memory use:";
+  for (const ArenaMemoryUse& use : arena_memory_use_) {
+    oss << "\n" << use.method_name << ": " << use.total_allocated << " bytes\n" << use.details;
+  }
+  LOG(INFO) << oss.str();
 }
 
 void OptimizingCompiler::DumpInstructionSetFeaturesToCfg() const {
@@ -563,7 +632,8 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
         OptDef(OptimizationPass::kInstructionSimplifierX86_64),
         OptDef(OptimizationPass::kSideEffectsAnalysis),
         OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
-        OptDef(OptimizationPass::kX86MemoryOperandGeneration)
+        OptDef(OptimizationPass::kX86MemoryOperandGeneration),
+        OptDef(OptimizationPass::kScheduling)
       };
       return RunOptimizations(graph,
                               codegen,
@@ -676,6 +746,21 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
            "constant_folding$after_bce"),
     OptDef(OptimizationPass::kAggressiveInstructionSimplifier,
            "instruction_simplifier$after_bce"),
+    // Second loop optimization pass (only if the first one occurred). When an
+    // inner loop with a known small trip count has been fully unrolled, the
+    // simplification above folds its replicated exit conditions; DCE then
+    // deletes the dead loop skeleton, and re-running loop optimization lets
+    // the enclosing loop — now innermost — be unrolled or vectorized in turn
+    // (i.e. unroll-and-jam).
+    OptDef(OptimizationPass::kDeadCodeElimination,
+           "dead_code_elimination$after_loop_opt",
+           OptimizationPass::kLoopOptimization),
+    OptDef(OptimizationPass::kInductionVarAnalysis,
+           "induction_var_analysis$after_loop_opt",
+           OptimizationPass::kLoopOptimization),
+    OptDef(OptimizationPass::kLoopOptimization,
+           "loop_optimization$after_loop_opt",
+           OptimizationPass::kLoopOptimization),
     // Other high-level optimizations.
     OptDef(OptimizationPass::kLoadStoreElimination),
     OptDef(OptimizationPass::kCHAGuardOptimization),
@@ -1091,6 +1176,10 @@ CompiledMethod* OptimizingCompiler::Compile(const dex::CodeItem* code_item,
       if (kArenaAllocatorCountAllocations) {
         codegen.reset();  // Release codegen's ScopedArenaAllocator for memory accounting.
         size_t total_allocated = allocator.BytesAllocated() + arena_stack.PeakBytesAllocated();
+        if (compilation_stats_.get() != nullptr) {
+          MaybeRecordArenaMemoryUse(
+              dex_file.PrettyMethod(method_idx), total_allocated, &allocator, &arena_stack);
+        }
         if (total_allocated > kArenaAllocatorMemoryReportThreshold) {
           MemStats mem_stats(allocator.GetMemStats());
           MemStats peak_stats(arena_stack.GetPeakStats());
@@ -1434,6 +1523,10 @@ bool OptimizingCompiler::JitCompile(Thread* self,
   if (kArenaAllocatorCountAllocations) {
     codegen.reset();  // Release codegen's ScopedArenaAllocator for memory accounting.
     size_t total_allocated = allocator.BytesAllocated() + arena_stack.PeakBytesAllocated();
+    if (compilation_stats_.get() != nullptr) {
+      MaybeRecordArenaMemoryUse(
+          dex_file->PrettyMethod(method_idx), total_allocated, &allocator, &arena_stack);
+    }
     if (total_allocated > kArenaAllocatorMemoryReportThreshold) {
       MemStats mem_stats(allocator.GetMemStats());
       MemStats peak_stats(arena_stack.GetPeakStats());
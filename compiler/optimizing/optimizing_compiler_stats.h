@@ -80,6 +80,7 @@ enum class MethodCompilationStat {
   kSimplifyIf,
   kSimplifyThrowingInvoke,
   kInstructionSunk,
+  kAllocationDuplicated,
   kNotInlinedUnresolvedEntrypoint,
   kNotInlinedDexCache,
   kNotInlinedStackMaps,
@@ -228,6 +228,13 @@ LiveInterval* RegisterAllocator::Split(LiveInterval* interval, size_t position)
   }
 }
 
+// Returns whether `block` is only executed on an exceptional path. We have no
+// per-block profile information when allocating registers, so catch blocks and
+// blocks that unconditionally throw are our static approximation of cold code.
+static bool IsColdBlock(HBasicBlock* block) {
+  return block->IsCatchBlock() || block->GetLastInstruction()->IsThrow();
+}
+
 LiveInterval* RegisterAllocator::SplitBetween(LiveInterval* interval, size_t from, size_t to) {
   HBasicBlock* block_from = liveness_.GetBlockFromPosition(from / 2);
   HBasicBlock* block_to = liveness_.GetBlockFromPosition(to / 2);
@@ -261,8 +268,16 @@ LiveInterval* RegisterAllocator::SplitBetween(LiveInterval* interval, size_t fro
    * moves in B3.
    */
   if (block_from->GetDominator() != nullptr) {
+    const size_t last_candidate_position = block_to->GetLifetimeStart();
+    HBasicBlock* cold_block = nullptr;
     for (HBasicBlock* dominated : block_from->GetDominator()->GetDominatedBlocks()) {
       size_t position = dominated->GetLifetimeStart();
+      if (IsColdBlock(dominated) &&
+          (position > from) && (last_candidate_position > position) &&
+          (cold_block == nullptr || position < cold_block->GetLifetimeStart())) {
+        // Remember the earliest cold block on the way to the next use.
+        cold_block = dominated;
+      }
       if ((position > from) && (block_to->GetLifetimeStart() > position)) {
         // Even if we found a better block, we continue iterating in case
         // a dominated block is closer.
@@ -271,6 +286,13 @@ LiveInterval* RegisterAllocator::SplitBetween(LiveInterval* interval, size_t fro
         DCHECK_NE(block_to, block_from);
       }
     }
+    if (cold_block != nullptr) {
+      // Prefer splitting at the cold block even if a linearly earlier block was
+      // found above: the spilled part of the interval then covers the
+      // exceptional path while the hot code before it keeps its location, and
+      // the moves forced by the split execute only when an exception is thrown.
+      block_to = cold_block;
+    }
   }
 
   // If `to` is in a loop, find the outermost loop header which does not contain `from`.
@@ -69,25 +69,21 @@ static bool BlocksMergeTogether(HBasicBlock* block1, HBasicBlock* block2) {
   return block1->GetSingleSuccessor() == block2->GetSingleSuccessor();
 }
 
-// Returns nullptr if `block` has either no phis or there is more than one phi
-// with different inputs at `index1` and `index2`. Otherwise returns that phi.
-static HPhi* GetSingleChangedPhi(HBasicBlock* block, size_t index1, size_t index2) {
+// Collects the phis of `block` whose inputs at `index1` and `index2` differ.
+// Each of them needs its own HSelect if the diamond is to be removed.
+static void GetChangedPhis(HBasicBlock* block,
+                           size_t index1,
+                           size_t index2,
+                           /*out*/ ScopedArenaVector<HPhi*>* changed_phis) {
   DCHECK_NE(index1, index2);
+  DCHECK(changed_phis->empty());
 
-  HPhi* select_phi = nullptr;
   for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
     HPhi* phi = it.Current()->AsPhi();
     if (phi->InputAt(index1) != phi->InputAt(index2)) {
-      if (select_phi == nullptr) {
-        // First phi with different inputs for the two indices found.
-        select_phi = phi;
-      } else {
-        // More than one phis has different inputs for the two indices.
-        return nullptr;
-      }
+      changed_phis->push_back(phi);
     }
   }
-  return select_phi;
 }
 
 bool HSelectGenerator::Run() {
@@ -137,44 +133,51 @@ bool HSelectGenerator::Run() {
     DCHECK_NE(predecessor_index_true, predecessor_index_false);
 
     bool both_successors_return = true_block->IsSingleReturn() && false_block->IsSingleReturn();
-    HPhi* phi = GetSingleChangedPhi(merge_block, predecessor_index_true, predecessor_index_false);
-
-    HInstruction* true_value = nullptr;
-    HInstruction* false_value = nullptr;
-    if (both_successors_return) {
-      true_value = true_block->GetFirstInstruction()->InputAt(0);
-      false_value = false_block->GetFirstInstruction()->InputAt(0);
-    } else if (phi != nullptr) {
-      true_value = phi->InputAt(predecessor_index_true);
-      false_value = phi->InputAt(predecessor_index_false);
-    } else {
-      continue;
+    // Each phi of the merge block with distinct true/false inputs gets its own select; this
+    // covers e.g. clamp idioms which merge two values through the same diamond.
+    ScopedArenaVector<HPhi*> changed_phis(allocator.Adapter(kArenaAllocSelectGenerator));
+    if (!both_successors_return) {
+      GetChangedPhis(merge_block, predecessor_index_true, predecessor_index_false, &changed_phis);
+      if (changed_phis.empty()) {
+        continue;
+      }
     }
-    DCHECK(both_successors_return || phi != nullptr);
 
-    // Create the Select instruction and insert it in front of the If.
+    // Create the Select instructions and insert them in front of the If.
     HInstruction* condition = if_instruction->InputAt(0);
-    HSelect* select = new (graph_->GetAllocator()) HSelect(condition,
-                                                           true_value,
-                                                           false_value,
-                                                           if_instruction->GetDexPc());
+    HSelect* select = nullptr;
     if (both_successors_return) {
+      HInstruction* true_value = true_block->GetFirstInstruction()->InputAt(0);
+      HInstruction* false_value = false_block->GetFirstInstruction()->InputAt(0);
+      select = new (graph_->GetAllocator()) HSelect(condition,
+                                                    true_value,
+                                                    false_value,
+                                                    if_instruction->GetDexPc());
       if (true_value->GetType() == DataType::Type::kReference) {
         DCHECK(false_value->GetType() == DataType::Type::kReference);
         ReferenceTypePropagation::FixUpInstructionType(select, graph_->GetHandleCache());
       }
-    } else if (phi->GetType() == DataType::Type::kReference) {
-      select->SetReferenceTypeInfo(phi->GetReferenceTypeInfo());
-    }
-    block->InsertInstructionBefore(select, if_instruction);
-
-    // Remove the true branch which removes the corresponding Phi
-    // input if needed. If left only with the false branch, the Phi is
-    // automatically removed.
-    if (both_successors_return) {
+      block->InsertInstructionBefore(select, if_instruction);
+      // Remove the true branch which removes the corresponding Phi
+      // input if needed. If left only with the false branch, the Phi is
+      // automatically removed.
       false_block->GetFirstInstruction()->ReplaceInput(select, 0);
+      MaybeRecordStat(stats_, MethodCompilationStat::kSelectGenerated);
     } else {
-      phi->ReplaceInput(select, predecessor_index_false);
+      for (HPhi* phi : changed_phis) {
+        HInstruction* true_value = phi->InputAt(predecessor_index_true);
+        HInstruction* false_value = phi->InputAt(predecessor_index_false);
+        select = new (graph_->GetAllocator()) HSelect(condition,
+                                                      true_value,
+                                                      false_value,
+                                                      if_instruction->GetDexPc());
+        if (phi->GetType() == DataType::Type::kReference) {
+          select->SetReferenceTypeInfo(phi->GetReferenceTypeInfo());
+        }
+        block->InsertInstructionBefore(select, if_instruction);
+        phi->ReplaceInput(select, predecessor_index_false);
+        MaybeRecordStat(stats_, MethodCompilationStat::kSelectGenerated);
+      }
     }
 
     bool only_two_predecessors = (merge_block->GetPredecessors().size() == 2u);
@@ -184,31 +187,34 @@ bool HSelectGenerator::Run() {
     DCHECK_EQ(block->GetSingleSuccessor(), false_block);
     block->MergeWith(false_block);
     if (!both_successors_return && only_two_predecessors) {
-      DCHECK_EQ(only_two_predecessors, phi->GetBlock() == nullptr);
+      // Removing the true predecessor left every phi with a single input,
+      // so they have all been replaced by that input and removed.
+      DCHECK(merge_block->GetPhis().IsEmpty());
       DCHECK_EQ(block->GetSingleSuccessor(), merge_block);
       block->MergeWith(merge_block);
     }
 
-    MaybeRecordStat(stats_, MethodCompilationStat::kSelectGenerated);
-
     // Very simple way of finding common subexpressions in the generated HSelect statements
     // (since this runs after GVN). Lookup by condition, and reuse latest one if possible
     // (due to post order, latest select is most likely replacement). If needed, we could
-    // improve this by e.g. using the operands in the map as well.
-    auto it = cache.find(condition);
-    if (it == cache.end()) {
-      cache.Put(condition, select);
-    } else {
-      // Found cached value. See if latest can replace cached in the HIR.
-      HSelect* cached = it->second;
-      DCHECK_EQ(cached->GetCondition(), select->GetCondition());
-      if (cached->GetTrueValue() == select->GetTrueValue() &&
-          cached->GetFalseValue() == select->GetFalseValue() &&
-          select->StrictlyDominates(cached)) {
-       cached->ReplaceWith(select);
-       cached->GetBlock()->RemoveInstruction(cached);
+    // improve this by e.g. using the operands in the map as well. Only applicable when the
+    // diamond produced a single select, as the map holds one select per condition.
+    if (both_successors_return || changed_phis.size() == 1u) {
+      auto it = cache.find(condition);
+      if (it == cache.end()) {
+        cache.Put(condition, select);
+      } else {
+        // Found cached value. See if latest can replace cached in the HIR.
+        HSelect* cached = it->second;
+        DCHECK_EQ(cached->GetCondition(), select->GetCondition());
+        if (cached->GetTrueValue() == select->GetTrueValue() &&
+            cached->GetFalseValue() == select->GetFalseValue() &&
+            select->StrictlyDominates(cached)) {
+         cached->ReplaceWith(select);
+         cached->GetBlock()->RemoveInstruction(cached);
+        }
+        it->second = select;  // always cache latest
       }
-      it->second = select;  // always cache latest
     }
 
     // No need to update dominance information, as we are simplifying
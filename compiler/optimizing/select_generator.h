@@ -26,6 +26,9 @@
  *            \          /
  *     Phi [FalseValue, TrueValue]
  *
+ * (the merge block may carry several such phis; each one is replaced by
+ * its own Select on the shared condition)
+ *
  * and
  *
  *             If [ Condition ]
@@ -99,4 +99,48 @@ TEST_F(SelectGeneratorTest, testAdd) {
   EXPECT_TRUE(CheckGraphAndTrySelectGenerator());
 }
 
+// Test that a diamond merging several values generates one select per phi.
+TEST_F(SelectGeneratorTest, testMultiplePhis) {
+  InitGraphAndParameters();
+
+  HBasicBlock* if_block = AddNewBlock();
+  HBasicBlock* then_block = AddNewBlock();
+  HBasicBlock* else_block = AddNewBlock();
+
+  entry_block_->ReplaceSuccessor(return_block_, if_block);
+
+  if_block->AddSuccessor(then_block);
+  if_block->AddSuccessor(else_block);
+  then_block->AddSuccessor(return_block_);
+  else_block->AddSuccessor(return_block_);
+
+  HParameterValue* bool_param = new (GetAllocator()) HParameterValue(graph_->GetDexFile(),
+                                                                     dex::TypeIndex(0),
+                                                                     1,
+                                                                     DataType::Type::kBool);
+  entry_block_->AddInstruction(bool_param);
+  HIntConstant* const1 = graph_->GetIntConstant(1);
+  HIntConstant* const2 = graph_->GetIntConstant(2);
+
+  if_block->AddInstruction(new (GetAllocator()) HIf(bool_param));
+  then_block->AddInstruction(new (GetAllocator()) HGoto());
+  else_block->AddInstruction(new (GetAllocator()) HGoto());
+
+  HPhi* phi1 = new (GetAllocator()) HPhi(GetAllocator(), 0, 0, DataType::Type::kInt32);
+  return_block_->AddPhi(phi1);
+  phi1->AddInput(parameters_[0]);
+  phi1->AddInput(const1);
+
+  HPhi* phi2 = new (GetAllocator()) HPhi(GetAllocator(), 1, 0, DataType::Type::kInt32);
+  return_block_->AddPhi(phi2);
+  phi2->AddInput(parameters_[0]);
+  phi2->AddInput(const2);
+
+  EXPECT_TRUE(CheckGraphAndTrySelectGenerator());
+
+  // Both phis must have been replaced by selects and removed with the diamond.
+  EXPECT_EQ(phi1->GetBlock(), nullptr);
+  EXPECT_EQ(phi2->GetBlock(), nullptr);
+}
+
 }  // namespace art
@@ -270,22 +270,40 @@ void SsaLivenessAnalysis::ComputeLiveRanges() {
 }
 
 void SsaLivenessAnalysis::ComputeLiveInAndLiveOutSets() {
-  bool changed;
-  do {
-    changed = false;
-
-    for (const HBasicBlock* block : graph_->GetPostOrder()) {
-      // The live_in set depends on the kill set (which does not
-      // change in this loop), and the live_out set.  If the live_out
-      // set does not change, there is no need to update the live_in set.
-      if (UpdateLiveOut(*block) && UpdateLiveIn(*block)) {
-        if (kIsDebugBuild) {
-          CheckNoLiveInIrreducibleLoop(*block);
+  // Seed the worklist in post order, so that for acyclic control flow the
+  // live_in sets of all successors of a block are computed before the block
+  // itself. Backward branches then only reprocess the blocks actually
+  // affected by a change, instead of sweeping over the whole graph until
+  // the fixed point is reached.
+  ScopedArenaVector<const HBasicBlock*> worklist(allocator_->Adapter(kArenaAllocSsaLiveness));
+  ArenaBitVector in_worklist(
+      allocator_, graph_->GetBlocks().size(), /* expandable= */ false, kArenaAllocSsaLiveness);
+  in_worklist.ClearAllBits();
+  for (const HBasicBlock* block : graph_->GetPostOrder()) {
+    worklist.push_back(block);
+    in_worklist.SetBit(block->GetBlockId());
+  }
+
+  for (size_t i = 0; i < worklist.size(); ++i) {
+    const HBasicBlock* block = worklist[i];
+    in_worklist.ClearBit(block->GetBlockId());
+    // The live_in set depends on the kill set (which does not
+    // change in this loop), and the live_out set.  If the live_out
+    // set does not change, there is no need to update the live_in set.
+    if (UpdateLiveOut(*block) && UpdateLiveIn(*block)) {
+      if (kIsDebugBuild) {
+        CheckNoLiveInIrreducibleLoop(*block);
+      }
+      // A changed live_in set can only affect the live_out sets of
+      // the predecessors; reprocess those that are not already pending.
+      for (HBasicBlock* predecessor : block->GetPredecessors()) {
+        if (!in_worklist.IsBitSet(predecessor->GetBlockId())) {
+          worklist.push_back(predecessor);
+          in_worklist.SetBit(predecessor->GetBlockId());
         }
-        changed = true;
       }
     }
-  } while (changed);
+  }
 }
 
 bool SsaLivenessAnalysis::UpdateLiveOut(const HBasicBlock& block) {
@@ -1255,9 +1255,9 @@ class SsaLivenessAnalysis : public ValueObject {
   // kill sets, that do not take into account backward branches.
   void ComputeLiveRanges();
 
-  // After computing the initial sets, this method does a fixed point
-  // calculation over the live_in and live_out set to take into account
-  // backwards branches.
+  // After computing the initial sets, this method does a worklist-driven
+  // fixed point calculation over the live_in and live_out sets to take
+  // into account backwards branches.
   void ComputeLiveInAndLiveOutSets();
 
   // Update the live_in set of the block and returns whether it has changed.
@@ -712,6 +712,10 @@ class X86_64Assembler final : public Assembler {
   void xchgl(CpuRegister dst, CpuRegister src);
   void xchgq(CpuRegister dst, CpuRegister src);
   void xchgl(CpuRegister reg, const Address& address);
+  void xchgq(CpuRegister reg, const Address& address);
+
+  void xaddl(const Address& address, CpuRegister reg);
+  void xaddq(const Address& address, CpuRegister reg);
 
   void cmpb(const Address& address, const Immediate& imm);
   void cmpw(const Address& address, const Immediate& imm);
@@ -907,6 +911,14 @@ class X86_64Assembler final : public Assembler {
     lock()->cmpxchgq(address, reg);
   }
 
+  void LockXaddl(const Address& address, CpuRegister reg) {
+    lock()->xaddl(address, reg);
+  }
+
+  void LockXaddq(const Address& address, CpuRegister reg) {
+    lock()->xaddq(address, reg);
+  }
+
   //
   // Misc. functionality
   //
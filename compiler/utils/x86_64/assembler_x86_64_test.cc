@@ -961,6 +961,20 @@ TEST_F(AssemblerX86_64Test, Xchgl) {
   // DriverStr(Repeatrr(&x86_64::X86_64Assembler::xchgl, "xchgl %{reg2}, %{reg1}"), "xchgl");
 }
 
+TEST_F(AssemblerX86_64Test, XchgqMem) {
+  DriverStr(RepeatRA(&x86_64::X86_64Assembler::xchgq, "xchgq {mem}, %{reg}"), "xchgq_mem");
+}
+
+TEST_F(AssemblerX86_64Test, LockXaddl) {
+  DriverStr(RepeatAr(&x86_64::X86_64Assembler::LockXaddl,
+                     "lock xaddl %{reg}, {mem}"), "lock_xaddl");
+}
+
+TEST_F(AssemblerX86_64Test, LockXaddq) {
+  DriverStr(RepeatAR(&x86_64::X86_64Assembler::LockXaddq,
+                     "lock xaddq %{reg}, {mem}"), "lock_xaddq");
+}
+
 TEST_F(AssemblerX86_64Test, LockCmpxchgl) {
   DriverStr(RepeatAr(&x86_64::X86_64Assembler::LockCmpxchgl,
                      "lock cmpxchgl %{reg}, {mem}"), "lock_cmpxchgl");
@@ -2074,7 +2074,8 @@ class Dex2Oat final {
                                                   oat_filenames_,
                                                   dex_file_oat_index_map_,
                                                   class_loader,
-                                                  dirty_image_objects_.get()));
+                                                  dirty_image_objects_.get(),
+                                                  thread_count_));
 
       // We need to prepare method offsets in the image address space for resolving linker patches.
       TimingLogger::ScopedTiming t2("dex2oat Prepare image address space", timings_);
@@ -2197,6 +2198,12 @@ class Dex2Oat final {
 
         oat_writer.reset();
         // We may still need the ELF writer later for stripping.
+
+        // The compiled code of this oat file, including its debug info, has
+        // been written out; release it so that the memory and swap space peak
+        // of the remaining oat files and of image writing stays bounded by a
+        // single oat file's worth of compiled code.
+        driver_->FreeCompiledMethods(dex_files_per_oat_file_[i]);
       }
     }
 
@@ -185,7 +185,9 @@ static void AddImageMappings(Builder& builder) {
           .IntoKey(M::MultiImage)
       .Define("--dirty-image-objects=_")
           .WithType<std::string>()
-          .WithHelp("list of known dirty objects in the image. The image writer will group them"
+          .WithHelp("list of known dirty objects in the image. Each entry is a class descriptor,"
+                    " optionally followed by a dot-separated field path to nominate the object"
+                    " reached through it (e.g. from imgdiag). The image writer will group them"
                     " together")
           .IntoKey(M::DirtyImageObjects)
       .Define("--updatable-bcp-packages-file=_")
@@ -48,9 +48,11 @@
 #include "compiler_callbacks.h"
 #include "compiler_driver-inl.h"
 #include "dex/class_accessor-inl.h"
+#include "dex/code_item_accessors-inl.h"
 #include "dex/descriptors_names.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_annotations.h"
+#include "dex/dex_file_exception_helpers.h"
 #include "dex/dex_instruction-inl.h"
 #include "dex/verification_results.h"
 #include "dex/verified_method.h"
@@ -259,6 +261,7 @@ CompilerDriver::CompilerDriver(
     : compiler_options_(compiler_options),
       compiler_(),
       compiler_kind_(compiler_kind),
+      compiled_method_content_cache_lock_("compiled method content cache lock"),
       number_of_soft_verifier_failures_(0),
       had_hard_verifier_failure_(false),
       parallel_thread_count_(thread_count),
@@ -411,6 +414,130 @@ static void CompileMethodHarness(
   }
 }
 
+// Appends a separated string piece to a method content key. The separator prevents two
+// different sequences of pieces from concatenating to the same key.
+static void AppendContentKeyPiece(const char* piece, /*inout*/ std::string* key) {
+  key->append(piece);
+  key->push_back('\0');
+}
+
+static void AppendContentKeyValue(uint32_t value, /*inout*/ std::string* key) {
+  key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Appends the names of the symbols referenced by an index-carrying instruction. The raw dex
+// code of two methods in different dex files can be identical while referring to different
+// symbols, so the key must include the referenced names rather than the raw indexes alone.
+// Returns false for index types whose referenced content cannot be cheaply canonicalized
+// (method handles, call sites and standalone protos); callers must then skip caching.
+static bool AppendInstructionSymbols(const DexFile& dex_file,
+                                     const Instruction& inst,
+                                     /*inout*/ std::string* key) {
+  uint32_t index = 0u;
+  switch (Instruction::FormatOf(inst.Opcode())) {
+    case Instruction::k21c:
+    case Instruction::k31c:
+    case Instruction::k35c:
+    case Instruction::k3rc:
+      index = inst.VRegB();
+      break;
+    case Instruction::k22c:
+      index = inst.VRegC();
+      break;
+    default:
+      // Non-index formats have nothing to append; kIndexNone below does not read `index`.
+      break;
+  }
+  switch (Instruction::IndexTypeOf(inst.Opcode())) {
+    case Instruction::kIndexNone:
+    case Instruction::kIndexVtableOffset:
+    case Instruction::kIndexFieldOffset:
+      break;
+    case Instruction::kIndexTypeRef:
+      AppendContentKeyPiece(dex_file.StringByTypeIdx(dex::TypeIndex(index)), key);
+      break;
+    case Instruction::kIndexStringRef:
+      AppendContentKeyPiece(dex_file.StringDataByIdx(dex::StringIndex(index)), key);
+      break;
+    case Instruction::kIndexMethodRef: {
+      const dex::MethodId& method_id = dex_file.GetMethodId(index);
+      AppendContentKeyPiece(dex_file.GetMethodDeclaringClassDescriptor(method_id), key);
+      AppendContentKeyPiece(dex_file.GetMethodName(method_id), key);
+      AppendContentKeyPiece(dex_file.GetMethodSignature(method_id).ToString().c_str(), key);
+      break;
+    }
+    case Instruction::kIndexFieldRef: {
+      const dex::FieldId& field_id = dex_file.GetFieldId(index);
+      AppendContentKeyPiece(dex_file.GetFieldDeclaringClassDescriptor(field_id), key);
+      AppendContentKeyPiece(dex_file.GetFieldName(field_id), key);
+      AppendContentKeyPiece(dex_file.GetFieldTypeDescriptor(field_id), key);
+      break;
+    }
+    case Instruction::kIndexMethodAndProtoRef: {
+      const dex::MethodId& method_id = dex_file.GetMethodId(inst.VRegB());
+      AppendContentKeyPiece(dex_file.GetMethodDeclaringClassDescriptor(method_id), key);
+      AppendContentKeyPiece(dex_file.GetMethodName(method_id), key);
+      AppendContentKeyPiece(dex_file.GetMethodSignature(method_id).ToString().c_str(), key);
+      AppendContentKeyPiece(
+          dex_file.GetProtoSignature(dex_file.GetProtoId(dex::ProtoIndex(inst.VRegH())))
+              .ToString().c_str(),
+          key);
+      break;
+    }
+    case Instruction::kIndexUnknown:
+    case Instruction::kIndexMethodHandleRef:
+    case Instruction::kIndexCallSiteRef:
+    case Instruction::kIndexProtoRef:
+      // Method handles and call sites pull in encoded values that are not worth
+      // canonicalizing here; such methods are rare enough to just compile directly.
+      return false;
+  }
+  return true;
+}
+
+// Builds a key identifying the compiler input of a method up to renumbering of dex indexes:
+// the declaring class, the method name and signature, the raw dex code and the names of all
+// referenced symbols, and the try/catch layout with handler types. Two methods with equal
+// keys in the same class loader context produce identical compiled code as long as the
+// result carries no linker patches. Returns false if the method uses an instruction whose
+// referenced content is not covered by the key.
+static bool BuildMethodContentKey(const DexFile& dex_file,
+                                  const dex::CodeItem* code_item,
+                                  uint32_t access_flags,
+                                  InvokeType invoke_type,
+                                  uint32_t method_idx,
+                                  /*out*/ std::string* key) {
+  const dex::MethodId& method_id = dex_file.GetMethodId(method_idx);
+  AppendContentKeyPiece(dex_file.GetMethodDeclaringClassDescriptor(method_id), key);
+  AppendContentKeyPiece(dex_file.GetMethodName(method_id), key);
+  AppendContentKeyPiece(dex_file.GetMethodSignature(method_id).ToString().c_str(), key);
+  AppendContentKeyValue(access_flags, key);
+  AppendContentKeyValue(static_cast<uint32_t>(invoke_type), key);
+  CodeItemDataAccessor accessor(dex_file, code_item);
+  AppendContentKeyValue(accessor.RegistersSize(), key);
+  AppendContentKeyValue(accessor.InsSize(), key);
+  AppendContentKeyValue(accessor.OutsSize(), key);
+  key->append(reinterpret_cast<const char*>(accessor.Insns()),
+              accessor.InsnsSizeInCodeUnits() * sizeof(uint16_t));
+  for (const DexInstructionPcPair& pair : accessor) {
+    if (!AppendInstructionSymbols(dex_file, pair.Inst(), key)) {
+      return false;
+    }
+  }
+  for (const dex::TryItem& try_item : accessor.TryItems()) {
+    AppendContentKeyValue(try_item.start_addr_, key);
+    AppendContentKeyValue(try_item.insn_count_, key);
+    for (CatchHandlerIterator it(accessor, try_item); it.HasNext(); it.Next()) {
+      AppendContentKeyPiece(it.GetHandlerTypeIndex().IsValid()
+                                ? dex_file.StringByTypeIdx(it.GetHandlerTypeIndex())
+                                : "<any>",
+                            key);
+      AppendContentKeyValue(it.GetHandlerAddress(), key);
+    }
+  }
+  return true;
+}
+
 static void CompileMethodQuick(
     Thread* self,
     CompilerDriver* driver,
@@ -470,15 +597,48 @@ static void CompileMethodQuick(
               driver->ShouldCompileBasedOnProfile(method_ref);
 
       if (compile) {
-        // NOTE: if compiler declines to compile this method, it will return null.
-        compiled_method = driver->GetCompiler()->Compile(code_item,
-                                                         access_flags,
-                                                         invoke_type,
-                                                         class_def_idx,
-                                                         method_idx,
-                                                         class_loader,
-                                                         dex_file,
-                                                         dex_cache);
+        // Methods with profile inline caches get method-reference-specific compilation, so
+        // they must neither hit nor populate the content cache.
+        const ProfileCompilationInfo* profile =
+            driver->GetCompilerOptions().GetProfileCompilationInfo();
+        std::string content_key;
+        const bool use_content_cache =
+            (profile == nullptr || !profile->GetMethodHotness(method_ref).IsHot()) &&
+            BuildMethodContentKey(
+                dex_file, code_item, access_flags, invoke_type, method_idx, &content_key);
+        if (use_content_cache) {
+          CompiledMethod* cached = driver->GetContentCachedCompiledMethod(content_key);
+          if (cached != nullptr) {
+            // Allocate a fresh CompiledMethod so that ownership per method reference is
+            // preserved; the underlying arrays are deduplicated by the swap-space storage.
+            compiled_method = CompiledMethod::SwapAllocCompiledMethod(
+                driver->GetCompiledMethodStorage(),
+                cached->GetInstructionSet(),
+                cached->GetQuickCode(),
+                cached->GetVmapTable(),
+                cached->GetCFIInfo(),
+                cached->GetPatches());
+          }
+        }
+        if (compiled_method == nullptr) {
+          // NOTE: if compiler declines to compile this method, it will return null.
+          compiled_method = driver->GetCompiler()->Compile(code_item,
+                                                           access_flags,
+                                                           invoke_type,
+                                                           class_def_idx,
+                                                           method_idx,
+                                                           class_loader,
+                                                           dex_file,
+                                                           dex_cache);
+          if (compiled_method != nullptr &&
+              use_content_cache &&
+              !compiled_method->IsIntrinsic() &&
+              compiled_method->GetPatches().empty()) {
+            // Patches encode indexes into the compiling dex file and cannot be reused for a
+            // method from a different dex file, so only patch-free code is cached.
+            driver->PutContentCachedCompiledMethod(content_key, compiled_method);
+          }
+        }
         ProfileMethodsCheck check_type =
             driver->GetCompilerOptions().CheckProfiledMethodsCompiled();
         if (UNLIKELY(check_type != ProfileMethodsCheck::kNone)) {
@@ -1840,15 +2000,7 @@ void CompilerDriver::Verify(jobject jclass_loader,
   ThreadPool* verify_thread_pool =
       force_determinism ? single_thread_pool_.get() : parallel_thread_pool_.get();
   size_t verify_thread_count = force_determinism ? 1U : parallel_thread_count_;
-  for (const DexFile* dex_file : dex_files) {
-    CHECK(dex_file != nullptr);
-    VerifyDexFile(jclass_loader,
-                  *dex_file,
-                  dex_files,
-                  verify_thread_pool,
-                  verify_thread_count,
-                  timings);
-  }
+  VerifyDexFiles(jclass_loader, dex_files, verify_thread_pool, verify_thread_count, timings);
 
   if (!GetCompilerOptions().IsBootImage() && !GetCompilerOptions().IsBootImageExtension()) {
     // Merge all VerifierDeps into the main one.
@@ -1865,15 +2017,21 @@ void CompilerDriver::Verify(jobject jclass_loader,
 
 class VerifyClassVisitor : public CompilationVisitor {
  public:
-  VerifyClassVisitor(const ParallelCompilationManager* manager, verifier::HardFailLogMode log_level)
+  VerifyClassVisitor(const ParallelCompilationManager* manager,
+                     const std::vector<ClassReference>& classes,
+                     verifier::HardFailLogMode log_level)
      : manager_(manager),
+       classes_(classes),
        log_level_(log_level),
        sdk_version_(Runtime::Current()->GetTargetSdkVersion()) {}
 
-  void Visit(size_t class_def_index) REQUIRES(!Locks::mutator_lock_) override {
+  void Visit(size_t index) REQUIRES(!Locks::mutator_lock_) override {
     ScopedTrace trace(__FUNCTION__);
     ScopedObjectAccess soa(Thread::Current());
-    const DexFile& dex_file = *manager_->GetDexFile();
+    // `index` is into the flattened list of classes of all dex files, so that
+    // threads keep taking classes from other dex files once one is exhausted.
+    const DexFile& dex_file = *classes_[index].dex_file;
+    const size_t class_def_index = classes_[index].ClassDefIdx();
     const dex::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
     const char* descriptor = dex_file.GetClassDescriptor(class_def);
     ClassLinker* class_linker = manager_->GetClassLinker();
@@ -1883,7 +2041,7 @@ class VerifyClassVisitor : public CompilationVisitor {
         hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
     Handle<mirror::Class> klass(
         hs.NewHandle(class_linker->FindClass(soa.Self(), descriptor, class_loader)));
-    ClassReference ref(manager_->GetDexFile(), class_def_index);
+    ClassReference ref(&dex_file, class_def_index);
     verifier::FailureKind failure_kind;
     if (klass == nullptr) {
       CHECK(soa.Self()->IsExceptionPending());
@@ -2007,27 +2165,42 @@ class VerifyClassVisitor : public CompilationVisitor {
 
  private:
   const ParallelCompilationManager* const manager_;
+  const std::vector<ClassReference>& classes_;
   const verifier::HardFailLogMode log_level_;
   const uint32_t sdk_version_;
 };
 
-void CompilerDriver::VerifyDexFile(jobject class_loader,
-                                   const DexFile& dex_file,
-                                   const std::vector<const DexFile*>& dex_files,
-                                   ThreadPool* thread_pool,
-                                   size_t thread_count,
-                                   TimingLogger* timings) {
-  TimingLogger::ScopedTiming t("Verify Dex File", timings);
+void CompilerDriver::VerifyDexFiles(jobject class_loader,
+                                    const std::vector<const DexFile*>& dex_files,
+                                    ThreadPool* thread_pool,
+                                    size_t thread_count,
+                                    TimingLogger* timings) {
+  TimingLogger::ScopedTiming t("Verify Dex Files", timings);
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-  ParallelCompilationManager context(class_linker, class_loader, this, &dex_file, dex_files,
-                                     thread_pool);
+  // Flatten the classes of all dex files into a single work list. Distributing
+  // work at dex file granularity would leave all threads but one idle for most
+  // of the phase when one dex file holds the bulk of the classes.
+  size_t number_of_classes = 0u;
+  for (const DexFile* dex_file : dex_files) {
+    CHECK(dex_file != nullptr);
+    number_of_classes += dex_file->NumClassDefs();
+  }
+  std::vector<ClassReference> classes;
+  classes.reserve(number_of_classes);
+  for (const DexFile* dex_file : dex_files) {
+    for (uint32_t i = 0, e = dex_file->NumClassDefs(); i != e; ++i) {
+      classes.emplace_back(dex_file, i);
+    }
+  }
+  ParallelCompilationManager context(class_linker, class_loader, this, /* dex_file= */ nullptr,
+                                     dex_files, thread_pool);
   bool abort_on_verifier_failures = GetCompilerOptions().AbortOnHardVerifierFailure()
                                     || GetCompilerOptions().AbortOnSoftVerifierFailure();
   verifier::HardFailLogMode log_level = abort_on_verifier_failures
                               ? verifier::HardFailLogMode::kLogInternalFatal
                               : verifier::HardFailLogMode::kLogWarning;
-  VerifyClassVisitor visitor(&context, log_level);
-  context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
+  VerifyClassVisitor visitor(&context, classes, log_level);
+  context.ForAll(0, classes.size(), &visitor, thread_count);
 
   // Make initialized classes visibly initialized.
   class_linker->MakeInitializedClassesVisiblyInitialized(Thread::Current(), /*wait=*/ true);
@@ -2684,6 +2857,39 @@ CompiledMethod* CompilerDriver::RemoveCompiledMethod(const MethodReference& meth
   return ret;
 }
 
+CompiledMethod* CompilerDriver::GetContentCachedCompiledMethod(const std::string& key) {
+  MutexLock mu(Thread::Current(), compiled_method_content_cache_lock_);
+  auto it = compiled_method_content_cache_.find(key);
+  return (it != compiled_method_content_cache_.end()) ? it->second : nullptr;
+}
+
+void CompilerDriver::PutContentCachedCompiledMethod(const std::string& key,
+                                                    CompiledMethod* compiled_method) {
+  DCHECK(compiled_method != nullptr);
+  MutexLock mu(Thread::Current(), compiled_method_content_cache_lock_);
+  // Keep the first method compiled for this content; racing compilations of identical
+  // methods keep their own result without inserting.
+  if (compiled_method_content_cache_.find(key) == compiled_method_content_cache_.end()) {
+    compiled_method_content_cache_.Put(key, compiled_method);
+  }
+}
+
+void CompilerDriver::FreeCompiledMethods(const std::vector<const DexFile*>& dex_files) {
+  for (const DexFile* dex_file : dex_files) {
+    if (!compiled_methods_.HaveDexFile(dex_file)) {
+      continue;
+    }
+    for (uint32_t i = 0, e = dex_file->NumMethodIds(); i != e; ++i) {
+      CompiledMethod* compiled_method = nullptr;
+      compiled_methods_.Remove(MethodReference(dex_file, i), &compiled_method);
+      if (compiled_method != nullptr) {
+        CompiledMethod::ReleaseSwapAllocatedCompiledMethod(GetCompiledMethodStorage(),
+                                                           compiled_method);
+      }
+    }
+  }
+}
+
 bool CompilerDriver::GetCompiledClass(const ClassReference& ref, ClassStatus* status) const {
   DCHECK(status != nullptr);
   // The table doesn't know if something wasn't inserted. For this case it will return
@@ -137,6 +137,20 @@ class CompilerDriver {
   void AddCompiledMethod(const MethodReference& method_ref, CompiledMethod* const compiled_method);
   CompiledMethod* RemoveCompiledMethod(const MethodReference& method_ref);
 
+  // Content-addressed cache of compiled methods, used to skip re-running the optimizing
+  // compiler for methods whose dex code and referenced symbol names are identical to an
+  // already compiled method (e.g. library classes duplicated across dex files). The cached
+  // pointers are borrowed from compiled_methods_ and are only valid during CompileAll().
+  CompiledMethod* GetContentCachedCompiledMethod(const std::string& key)
+      REQUIRES(!compiled_method_content_cache_lock_);
+  void PutContentCachedCompiledMethod(const std::string& key, CompiledMethod* compiled_method)
+      REQUIRES(!compiled_method_content_cache_lock_);
+  // Release the compiled code of all methods from `dex_files`. Called once the
+  // oat file containing them (including its debug info) has been written, so
+  // that the peak memory and swap space usage is bounded by one oat file's
+  // worth of compiled code instead of everything compiled in this run.
+  void FreeCompiledMethods(const std::vector<const DexFile*>& dex_files);
+
   // Resolve compiling method's class. Returns null on failure.
   ObjPtr<mirror::Class> ResolveCompilingMethodsClass(const ScopedObjectAccess& soa,
                                                      Handle<mirror::DexCache> dex_cache,
@@ -253,12 +267,11 @@ class CompilerDriver {
               TimingLogger* timings,
               /*out*/ VerificationResults* verification_results);
 
-  void VerifyDexFile(jobject class_loader,
-                     const DexFile& dex_file,
-                     const std::vector<const DexFile*>& dex_files,
-                     ThreadPool* thread_pool,
-                     size_t thread_count,
-                     TimingLogger* timings)
+  void VerifyDexFiles(jobject class_loader,
+                      const std::vector<const DexFile*>& dex_files,
+                      ThreadPool* thread_pool,
+                      size_t thread_count,
+                      TimingLogger* timings)
       REQUIRES(!Locks::mutator_lock_);
 
   void SetVerified(jobject class_loader,
@@ -313,6 +326,12 @@ class CompilerDriver {
   // All method references that this compiler has compiled.
   MethodTable compiled_methods_;
 
+  // Maps method content keys (dex code bytes plus referenced symbol names) to the first
+  // patch-free CompiledMethod produced for that content.
+  mutable Mutex compiled_method_content_cache_lock_;
+  SafeMap<std::string, CompiledMethod*> compiled_method_content_cache_
+      GUARDED_BY(compiled_method_content_cache_lock_);
+
   std::atomic<uint32_t> number_of_soft_verifier_failures_;
 
   bool had_hard_verifier_failure_;
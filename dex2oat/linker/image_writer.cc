@@ -38,6 +38,7 @@
 #include "compiled_method.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_types.h"
+#include "dex/method_reference.h"
 #include "driver/compiler_options.h"
 #include "elf/elf_utils.h"
 #include "elf_file.h"
@@ -77,9 +78,11 @@
 #include "oat_file.h"
 #include "oat_file_manager.h"
 #include "optimizing/intrinsic_objects.h"
+#include "profile/profile_compilation_info.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "subtype_check.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 using ::art::mirror::Class;
@@ -636,6 +639,78 @@ void ImageWriter::SetImageBinSlot(mirror::Object* object, BinSlot bin_slot) {
   DCHECK(IsImageBinSlotAssigned(object));
 }
 
+// Find a field of the given name, searching the class and its superclasses. The first element
+// of a dirty object field path names a static field, the rest name instance fields.
+static ArtField* FindFieldByName(ObjPtr<mirror::Class> klass,
+                                 std::string_view field_name,
+                                 bool is_static)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  for (ObjPtr<mirror::Class> k = klass; k != nullptr; k = k->GetSuperClass()) {
+    const uint32_t num_fields = is_static ? k->NumStaticFields() : k->NumInstanceFields();
+    for (uint32_t i = 0; i < num_fields; ++i) {
+      ArtField* field = is_static ? k->GetStaticField(i) : k->GetInstanceField(i);
+      if (field_name == field->GetName()) {
+        return field;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void ImageWriter::ResolveDirtyObjects() {
+  if (dirty_image_objects_ == nullptr) {
+    return;
+  }
+  Thread* const self = Thread::Current();
+  ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+  for (const std::string& entry : *dirty_image_objects_) {
+    const size_t first_dot = entry.find('.');
+    if (first_dot == std::string::npos) {
+      // Plain class descriptor, matched by name during bin slot assignment.
+      continue;
+    }
+    const std::string descriptor = entry.substr(0, first_dot);
+    ObjPtr<mirror::Class> klass =
+        class_linker->LookupClass(self, descriptor.c_str(), /*class_loader=*/ nullptr);
+    if (klass == nullptr) {
+      LOG(WARNING) << "Dirty object entry " << entry << ": unknown class " << descriptor;
+      continue;
+    }
+    // Follow the field path from the class's static field through instance fields.
+    ObjPtr<mirror::Object> obj = nullptr;
+    bool is_static = true;
+    std::string_view remaining = std::string_view(entry).substr(first_dot + 1u);
+    while (true) {
+      const size_t dot = remaining.find('.');
+      const std::string_view field_name = remaining.substr(0, dot);
+      ObjPtr<mirror::Class> search_klass = is_static ? klass : obj->GetClass();
+      ArtField* field = FindFieldByName(search_klass, field_name, is_static);
+      if (field == nullptr || field->GetTypeAsPrimitiveType() != Primitive::kPrimNot) {
+        LOG(WARNING) << "Dirty object entry " << entry << ": no reference field " << field_name
+                     << " in " << search_klass->PrettyDescriptor();
+        obj = nullptr;
+        break;
+      }
+      obj = field->GetObject(is_static ? ObjPtr<mirror::Object>(field->GetDeclaringClass())
+                                       : obj);
+      if (obj == nullptr) {
+        VLOG(compiler) << "Dirty object entry " << entry << ": field " << field_name
+                       << " is null at compile time";
+        break;
+      }
+      if (dot == std::string_view::npos) {
+        break;
+      }
+      remaining = remaining.substr(dot + 1u);
+      is_static = false;
+    }
+    if (obj != nullptr) {
+      dirty_objects_.insert(obj.Ptr());
+    }
+  }
+  VLOG(compiler) << "Resolved " << dirty_objects_.size() << " dirty objects from field paths";
+}
+
 ImageWriter::Bin ImageWriter::AssignImageBinSlot(mirror::Object* object, size_t oat_index) {
   DCHECK(object != nullptr);
 
@@ -675,7 +750,11 @@ ImageWriter::Bin ImageWriter::AssignImageBinSlot(mirror::Object* object, size_t
     // We assume that "regular" bin objects are highly unlikely to become dirtied,
     // so packing them together will not result in a noticeably tighter dirty-to-clean ratio.
     //
-    if (object->IsClass()) {
+    if (!dirty_objects_.empty() && dirty_objects_.find(object) != dirty_objects_.end()) {
+      // Objects nominated through a field path in the dirty image objects list, resolved by
+      // ResolveDirtyObjects().
+      bin = Bin::kKnownDirty;
+    } else if (object->IsClass()) {
       bin = Bin::kClassVerified;
       ObjPtr<mirror::Class> klass = object->AsClass();
 
@@ -768,6 +847,18 @@ bool ImageWriter::WillMethodBeDirty(ArtMethod* m) const {
          declaring_class->GetStatus() != ClassStatus::kVisiblyInitialized;
 }
 
+bool ImageWriter::WillMethodBeHot(ArtMethod* m) const {
+  if (m->IsRuntimeMethod() || m->IsProxyMethod()) {
+    return false;
+  }
+  const ProfileCompilationInfo* profile = compiler_options_.GetProfileCompilationInfo();
+  if (profile == nullptr) {
+    return false;
+  }
+  MethodReference ref(m->GetDexFile(), m->GetDexMethodIndex());
+  return profile->GetMethodHotness(ref).IsInProfile();
+}
+
 bool ImageWriter::IsImageBinSlotAssigned(mirror::Object* object) const {
   DCHECK(object != nullptr);
 
@@ -1059,6 +1150,16 @@ class ImageWriter::PruneClassesVisitor : public ClassVisitor {
       classes_to_prune_.insert(klass.Ptr());
       if (klass->GetClassLoader() == class_loader_) {
         ++defined_class_count_;
+        // Count classes from the compiled dex files separately: these are classes the image
+        // loses only because of transitive dependencies on classes resolved through the class
+        // loader context (e.g. other feature splits), and will go through full DefineClass at
+        // run time.
+        ObjPtr<mirror::DexCache> dex_cache = klass->GetDexCache();
+        if (dex_cache != nullptr &&
+            image_writer_->dex_file_oat_index_map_.find(dex_cache->GetDexFile()) !=
+                image_writer_->dex_file_oat_index_map_.end()) {
+          ++compiled_dex_class_count_;
+        }
       }
     }
     return true;
@@ -1077,11 +1178,16 @@ class ImageWriter::PruneClassesVisitor : public ClassVisitor {
     return defined_class_count_;
   }
 
+  size_t GetCompiledDexClassCount() const {
+    return compiled_dex_class_count_;
+  }
+
  private:
   ImageWriter* const image_writer_;
   const ObjPtr<mirror::ClassLoader> class_loader_;
   HashSet<mirror::Class*> classes_to_prune_;
   size_t defined_class_count_;
+  size_t compiled_dex_class_count_ = 0u;
 };
 
 class ImageWriter::PruneClassLoaderClassesVisitor : public ClassLoaderVisitor {
@@ -1096,15 +1202,21 @@ class ImageWriter::PruneClassLoaderClassesVisitor : public ClassLoaderVisitor {
         Runtime::Current()->GetClassLinker()->ClassTableForClassLoader(class_loader);
     class_table->Visit(classes_visitor);
     removed_class_count_ += classes_visitor.Prune();
+    removed_compiled_dex_class_count_ += classes_visitor.GetCompiledDexClassCount();
   }
 
   size_t GetRemovedClassCount() const {
     return removed_class_count_;
   }
 
+  size_t GetRemovedCompiledDexClassCount() const {
+    return removed_compiled_dex_class_count_;
+  }
+
  private:
   ImageWriter* const image_writer_;
   size_t removed_class_count_;
+  size_t removed_compiled_dex_class_count_ = 0u;
 };
 
 void ImageWriter::VisitClassLoaders(ClassLoaderVisitor* visitor) {
@@ -1114,16 +1226,20 @@ void ImageWriter::VisitClassLoaders(ClassLoaderVisitor* visitor) {
 }
 
 void ImageWriter::ClearDexCache(ObjPtr<mirror::DexCache> dex_cache) {
-  // Clear methods.
+  // Clear methods. The array is materialized lazily and may still be null.
   mirror::MethodDexCacheType* resolved_methods = dex_cache->GetResolvedMethods();
-  for (size_t slot_idx = 0, num = dex_cache->NumResolvedMethods(); slot_idx != num; ++slot_idx) {
+  for (size_t slot_idx = 0, num = dex_cache->NumResolvedMethods();
+       resolved_methods != nullptr && slot_idx != num;
+       ++slot_idx) {
     mirror::MethodDexCachePair invalid(nullptr,
                                        mirror::MethodDexCachePair::InvalidIndexForSlot(slot_idx));
     mirror::DexCache::SetNativePair(resolved_methods, slot_idx, invalid);
   }
   // Clear fields.
   mirror::FieldDexCacheType* resolved_fields = dex_cache->GetResolvedFields();
-  for (size_t slot_idx = 0, num = dex_cache->NumResolvedFields(); slot_idx != num; ++slot_idx) {
+  for (size_t slot_idx = 0, num = dex_cache->NumResolvedFields();
+       resolved_fields != nullptr && slot_idx != num;
+       ++slot_idx) {
     mirror::FieldDexCachePair invalid(nullptr,
                                       mirror::FieldDexCachePair::InvalidIndexForSlot(slot_idx));
     mirror::DexCache::SetNativePair(resolved_fields, slot_idx, invalid);
@@ -1183,7 +1299,10 @@ void ImageWriter::PruneNonImageClasses() {
   {
     PruneClassLoaderClassesVisitor class_loader_visitor(this);
     VisitClassLoaders(&class_loader_visitor);
-    VLOG(compiler) << "Pruned " << class_loader_visitor.GetRemovedClassCount() << " classes";
+    VLOG(compiler) << "Pruned " << class_loader_visitor.GetRemovedClassCount() << " classes, "
+                   << class_loader_visitor.GetRemovedCompiledDexClassCount()
+                   << " of them from the compiled dex files (lost to class loader context"
+                   << " dependencies)";
   }
 
   // Completely clear DexCaches.
@@ -1375,9 +1494,21 @@ void ImageWriter::RecordNativeRelocations(ObjPtr<mirror::Class> klass, size_t oa
         break;
       }
     }
+    // Clean arrays with profile-hot methods get segregated into their own bin so the
+    // methods which actually get invoked are densely packed.
+    bool any_hot = false;
+    if (!any_dirty) {
+      for (auto& m : klass->GetMethods(target_ptr_size_)) {
+        if (WillMethodBeHot(&m)) {
+          any_hot = true;
+          break;
+        }
+      }
+    }
     NativeObjectRelocationType type = any_dirty
         ? NativeObjectRelocationType::kArtMethodDirty
-        : NativeObjectRelocationType::kArtMethodClean;
+        : (any_hot ? NativeObjectRelocationType::kArtMethodHot
+                   : NativeObjectRelocationType::kArtMethodClean);
     Bin bin_type = BinTypeForNativeRelocationType(type);
     // Forward the entire array at once, but header first.
     const size_t method_alignment = ArtMethod::Alignment(target_ptr_size_);
@@ -1395,7 +1526,8 @@ void ImageWriter::RecordNativeRelocations(ObjPtr<mirror::Class> klass, size_t oa
                   oat_index,
                   offset,
                   any_dirty ? NativeObjectRelocationType::kArtMethodArrayDirty
-                            : NativeObjectRelocationType::kArtMethodArrayClean
+                            : (any_hot ? NativeObjectRelocationType::kArtMethodArrayHot
+                                       : NativeObjectRelocationType::kArtMethodArrayClean)
               })).second;
     CHECK(inserted) << "Method array " << array << " already forwarded";
     image_info.IncrementBinSlotSize(bin_type, header_size);
@@ -2187,6 +2319,7 @@ void ImageWriter::LayoutHelper::FinalizeBinSlotOffsets() {
     for (size_t i = 0; i != kNumberOfBins; ++i) {
       Bin bin = enum_cast<Bin>(i);
       switch (bin) {
+        case Bin::kArtMethodHot:
         case Bin::kArtMethodClean:
         case Bin::kArtMethodDirty: {
           bin_offset = RoundUp(bin_offset, ArtMethod::Alignment(image_writer_->target_ptr_size_));
@@ -2363,6 +2496,9 @@ void ImageWriter::CalculateNewObjectOffsets() {
 
   gc::Heap* const heap = runtime->GetHeap();
 
+  // Resolve the objects nominated dirty through field paths before any bin slots are assigned.
+  ResolveDirtyObjects();
+
   // Leave space for the header, but do not write it yet, we need to
   // know where image_roots is going to end up
   image_objects_offset_begin_ = RoundUp(sizeof(ImageHeader), kObjectAlignment);  // 64-bit-alignment
@@ -2472,7 +2608,8 @@ std::pair<size_t, std::vector<ImageSection>> ImageWriter::ImageInfo::CreateImage
    * Method section
    */
   sections[ImageHeader::kSectionArtMethods] =
-      ImageSection(GetBinSlotOffset(Bin::kArtMethodClean),
+      ImageSection(GetBinSlotOffset(Bin::kArtMethodHot),
+                   GetBinSlotSize(Bin::kArtMethodHot) +
                    GetBinSlotSize(Bin::kArtMethodClean) +
                    GetBinSlotSize(Bin::kArtMethodDirty));
 
@@ -2733,6 +2870,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
     DCHECK(!IsInBootImage(pair.first));
     switch (relocation.type) {
       case NativeObjectRelocationType::kRuntimeMethod:
+      case NativeObjectRelocationType::kArtMethodHot:
       case NativeObjectRelocationType::kArtMethodClean:
       case NativeObjectRelocationType::kArtMethodDirty: {
         CopyAndFixupMethod(reinterpret_cast<ArtMethod*>(pair.first),
@@ -2753,6 +2891,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
         }
         break;
       }
+      case NativeObjectRelocationType::kArtMethodArrayHot:
       case NativeObjectRelocationType::kArtMethodArrayClean:
       case NativeObjectRelocationType::kArtMethodArrayDirty: {
         // For method arrays, copy just the header since the elements will
@@ -2994,11 +3133,43 @@ void ImageWriter::CopyAndFixupObjects() {
     }
   }
 
-  auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
-    DCHECK(obj != nullptr);
-    CopyAndFixupObject(obj);
-  };
-  Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  if (thread_count_ > 1u) {
+    // Copying and fixing up an object writes only to its (disjoint) copy in the image and
+    // to the atomic image bitmap; the bin slot and native relocation maps are fully
+    // constructed by now and only read. That makes the per-object work safe to shard
+    // across threads with no synchronization beyond the final Wait().
+    std::vector<Object*> objects;
+    auto collect_visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+      DCHECK(obj != nullptr);
+      if (IsImageBinSlotAssigned(obj)) {
+        objects.push_back(obj);
+      }
+    };
+    Runtime::Current()->GetHeap()->VisitObjects(collect_visitor);
+
+    Thread* const self = Thread::Current();
+    ThreadPool pool("Image object copy thread pool", thread_count_ - 1u);
+    pool.StartWorkers(self);
+    const size_t chunk_size = (objects.size() + thread_count_ - 1u) / thread_count_;
+    for (size_t begin = 0u; begin < objects.size(); begin += chunk_size) {
+      const size_t end = std::min(begin + chunk_size, objects.size());
+      pool.AddTask(self, new FunctionTask([this, &objects, begin, end](Thread* worker_self) {
+        ScopedObjectAccess soa(worker_self);
+        for (size_t i = begin; i != end; ++i) {
+          CopyAndFixupObject(objects[i]);
+        }
+      }));
+    }
+    // The current thread already holds the mutator lock, so have it participate in the
+    // copying rather than only waiting for the workers.
+    pool.Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+  } else {
+    auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+      DCHECK(obj != nullptr);
+      CopyAndFixupObject(obj);
+    };
+    Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  }
 
   // Fill the padding objects since they are required for in order traversal of the image space.
   for (ImageInfo& image_info : image_infos_) {
@@ -3368,6 +3539,9 @@ ImageWriter::Bin ImageWriter::BinTypeForNativeRelocationType(NativeObjectRelocat
   switch (type) {
     case NativeObjectRelocationType::kArtFieldArray:
       return Bin::kArtField;
+    case NativeObjectRelocationType::kArtMethodHot:
+    case NativeObjectRelocationType::kArtMethodArrayHot:
+      return Bin::kArtMethodHot;
     case NativeObjectRelocationType::kArtMethodClean:
     case NativeObjectRelocationType::kArtMethodArrayClean:
       return Bin::kArtMethodClean;
@@ -3480,7 +3654,8 @@ ImageWriter::ImageWriter(
     const std::vector<std::string>& oat_filenames,
     const HashMap<const DexFile*, size_t>& dex_file_oat_index_map,
     jobject class_loader,
-    const HashSet<std::string>* dirty_image_objects)
+    const HashSet<std::string>* dirty_image_objects,
+    size_t thread_count)
     : compiler_options_(compiler_options),
       boot_image_begin_(Runtime::Current()->GetHeap()->GetBootImagesStartAddress()),
       boot_image_size_(Runtime::Current()->GetHeap()->GetBootImagesSize()),
@@ -3495,7 +3670,8 @@ ImageWriter::ImageWriter(
       image_storage_mode_(image_storage_mode),
       oat_filenames_(oat_filenames),
       dex_file_oat_index_map_(dex_file_oat_index_map),
-      dirty_image_objects_(dirty_image_objects) {
+      dirty_image_objects_(dirty_image_objects),
+      thread_count_(thread_count) {
   DCHECK(compiler_options.IsBootImage() ||
          compiler_options.IsBootImageExtension() ||
          compiler_options.IsAppImage());
@@ -82,7 +82,8 @@ class ImageWriter final {
               const std::vector<std::string>& oat_filenames,
               const HashMap<const DexFile*, size_t>& dex_file_oat_index_map,
               jobject class_loader,
-              const HashSet<std::string>* dirty_image_objects);
+              const HashSet<std::string>* dirty_image_objects,
+              size_t thread_count);
 
   /*
    * Modifies the heap and collects information about objects and code so that
@@ -195,6 +196,10 @@ class ImageWriter final {
     // Non mirror fields must be below.
     // ArtFields should be always clean.
     kArtField,
+    // Clean ArtMethods of classes with profile-hot methods. Grouped into their own bin so
+    // that the methods the app actually invokes occupy a dense range of pages and cache lines
+    // instead of being interleaved with cold neighbors.
+    kArtMethodHot,
     // If the class is initialized, then the ArtMethods are probably clean.
     kArtMethodClean,
     // ArtMethods may be dirty if the class has native methods or a declaring class that isn't
@@ -216,6 +221,8 @@ class ImageWriter final {
 
   enum class NativeObjectRelocationType {
     kArtFieldArray,
+    kArtMethodHot,
+    kArtMethodArrayHot,
     kArtMethodClean,
     kArtMethodArrayClean,
     kArtMethodDirty,
@@ -410,6 +417,11 @@ class ImageWriter final {
 
   Bin AssignImageBinSlot(mirror::Object* object, size_t oat_index)
       REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Resolve the field-path entries of the dirty image objects list (class descriptor followed
+  // by a dot-separated field path, e.g. "Lfoo/Bar;.instance.cache") to the objects they reach,
+  // so that those objects can be binned as known dirty.
+  void ResolveDirtyObjects() REQUIRES_SHARED(Locks::mutator_lock_);
   void AssignImageBinSlot(mirror::Object* object, size_t oat_index, Bin bin)
       REQUIRES_SHARED(Locks::mutator_lock_);
   void RecordNativeRelocations(ObjPtr<mirror::Class> klass, size_t oat_index)
@@ -513,6 +525,9 @@ class ImageWriter final {
   // Return true if a method is likely to be dirtied at runtime.
   bool WillMethodBeDirty(ArtMethod* m) const REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return true if the method is in the compilation profile and should go in the hot bin.
+  bool WillMethodBeHot(ArtMethod* m) const REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Assign the offset for an ArtMethod.
   void AssignMethodOffset(ArtMethod* method,
                           NativeObjectRelocationType type,
@@ -555,7 +570,8 @@ class ImageWriter final {
     NativeObjectRelocationType type;
 
     bool IsArtMethodRelocation() const {
-      return type == NativeObjectRelocationType::kArtMethodClean ||
+      return type == NativeObjectRelocationType::kArtMethodHot ||
+          type == NativeObjectRelocationType::kArtMethodClean ||
           type == NativeObjectRelocationType::kArtMethodDirty ||
           type == NativeObjectRelocationType::kRuntimeMethod;
     }
@@ -684,6 +700,13 @@ class ImageWriter final {
   // Set of objects known to be dirty in the image. Can be nullptr if there are none.
   const HashSet<std::string>* dirty_image_objects_;
 
+  // Objects nominated through a field path in the dirty image objects list, resolved by
+  // ResolveDirtyObjects() before bin slot assignment.
+  HashSet<mirror::Object*> dirty_objects_;
+
+  // Number of threads available for copying and fixing up image objects.
+  const size_t thread_count_;
+
   // Objects are guaranteed to not cross the region size boundary.
   size_t region_size_ = 0u;
 
@@ -1068,15 +1068,11 @@ struct OatWriter::OrderedMethodData {
 
   // Bin each method according to the profile flags.
   //
-  // Groups by e.g.
-  //  -- not hot at all
-  //  -- hot
-  //  -- hot and startup
-  //  -- hot and post-startup
-  //  -- hot and startup and poststartup
-  //  -- startup
-  //  -- startup and post-startup
-  //  -- post-startup
+  // Groups into three major sections:
+  //  -- startup (in any combination with hot/post-startup)
+  //  -- post-startup and/or hot, but not startup
+  //  -- not sampled at all
+  // with the finer-grained flag combinations kept adjacent within each section.
   //
   // (See MethodHotness enum definition for up-to-date binning order.)
   bool operator<(const OrderedMethodData& other) const {
@@ -1101,24 +1097,29 @@ struct OatWriter::OrderedMethodData {
   // Used to determine relative order for OAT code layout when determining
   // binning.
   size_t GetMethodHotnessOrder() const {
-    bool hotness[] = {
-      method_hotness.IsHot(),
-      method_hotness.IsStartup(),
-      method_hotness.IsPostStartup()
-    };
-
-
-    // Note: Bin-to-bin order does not matter. If the kernel does or does not read-ahead
-    // any memory, it only goes into the buffer cache and does not grow the PSS until the first
-    // time that memory is referenced in the process.
-
-    size_t hotness_bits = 0;
-    for (size_t i = 0; i < arraysize(hotness); ++i) {
-      if (hotness[i]) {
-        hotness_bits |= (1 << i);
-      }
+    bool is_hot = method_hotness.IsHot();
+    bool is_startup = method_hotness.IsStartup();
+    bool is_post_startup = method_hotness.IsPostStartup();
+
+    // Major order: all startup-marked methods first, so the pages touched on a
+    // cold launch form a single contiguous run at the front of .text, then
+    // methods only sampled after startup, then methods never sampled at all.
+    //
+    // Note: Within a section, bin-to-bin order does not matter. If the kernel does or does
+    // not read-ahead any memory, it only goes into the buffer cache and does not grow the
+    // PSS until the first time that memory is referenced in the process.
+    size_t section;
+    if (is_startup) {
+      section = 0u;
+    } else if (is_hot || is_post_startup) {
+      section = 1u;
+    } else {
+      section = 2u;
     }
 
+    size_t hotness_bits =
+        (is_hot ? 1u : 0u) | (is_startup ? 2u : 0u) | (is_post_startup ? 4u : 0u);
+
     if (kIsDebugBuild) {
       // Check for bins that are always-empty given a real profile.
       if (method_hotness.IsHot() &&
@@ -1130,7 +1131,8 @@ struct OatWriter::OrderedMethodData {
       }
     }
 
-    return hotness_bits;
+    // Minor order: keep the fine-grained flag combinations adjacent within a section.
+    return (section << 3) | hotness_bits;
   }
 };
 
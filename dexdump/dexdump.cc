@@ -65,9 +65,10 @@ namespace art {
 struct Options gOptions;
 
 /*
- * Output file. Defaults to stdout.
+ * Output file. Defaults to stdout; thread-local so batch workers can dump into
+ * their own memory streams.
  */
-FILE* gOutFile = stdout;
+thread_local FILE* gOutFile = stdout;
 
 /*
  * Data types that match the definitions in the VM specification.
@@ -1832,20 +1833,26 @@ static void processDexFile(const char* fileName,
 
   // Iterate over all classes.
   char* package = nullptr;
-  const u4 classDefsSize = pDexFile->GetHeader().class_defs_size_;
-  for (u4 j = 0; j < classDefsSize; j++) {
-    dumpClass(pDexFile, j, &package);
-  }  // for
+  if (!gOptions.onlySections || gOptions.sectionClasses) {
+    const u4 classDefsSize = pDexFile->GetHeader().class_defs_size_;
+    for (u4 j = 0; j < classDefsSize; j++) {
+      dumpClass(pDexFile, j, &package);
+    }  // for
+  }
 
   // Iterate over all method handles.
-  for (u4 j = 0; j < pDexFile->NumMethodHandles(); ++j) {
-    dumpMethodHandle(pDexFile, j);
-  }  // for
+  if (!gOptions.onlySections || gOptions.sectionMethodHandles) {
+    for (u4 j = 0; j < pDexFile->NumMethodHandles(); ++j) {
+      dumpMethodHandle(pDexFile, j);
+    }  // for
+  }
 
   // Iterate over all call site ids.
-  for (u4 j = 0; j < pDexFile->NumCallSiteIds(); ++j) {
-    dumpCallSite(pDexFile, j);
-  }  // for
+  if (!gOptions.onlySections || gOptions.sectionCallSites) {
+    for (u4 j = 0; j < pDexFile->NumCallSiteIds(); ++j) {
+      dumpCallSite(pDexFile, j);
+    }  // for
+  }
 
   // Free the last package allocated.
   if (package != nullptr) {
@@ -48,13 +48,24 @@ struct Options {
   bool showFileHeaders;
   bool showSectionHeaders;
   bool verbose;
+  bool onlySections;            // restrict output to the sections selected below
+  bool sectionClasses;
+  bool sectionMethodHandles;
+  bool sectionCallSites;
+  int numThreads;               // number of files processed concurrently (0/1 = serial)
   OutputFormat outputFormat;
   const char* outputFileName;
 };
 
 /* Prototypes. */
 extern struct Options gOptions;
-extern FILE* gOutFile;
+
+/*
+ * The output stream is thread-local so that a batch invocation can process several files
+ * concurrently, each worker dumping into its own memory stream; the driver merges the
+ * buffers into the real output file in command-line order.
+ */
+extern thread_local FILE* gOutFile;
 int processFile(const char* fileName);
 
 }  // namespace art
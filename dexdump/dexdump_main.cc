@@ -25,9 +25,15 @@
 #include "dexdump.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include <android-base/logging.h>
 
 namespace art {
@@ -40,7 +46,7 @@ static const char* gProgName = "dexdump";
 static void usage() {
   LOG(ERROR) << "Copyright (C) 2007 The Android Open Source Project\n";
   LOG(ERROR) << gProgName << ": [-a] [-c] [-d] [-e] [-f] [-h] [-i] [-j] [-l layout] [-o outfile]"
-                  " dexfile...\n";
+                  " [-s sections] [-t threads] dexfile...\n";
   LOG(ERROR) << " -a : display annotations";
   LOG(ERROR) << " -c : verify checksum and exit";
   LOG(ERROR) << " -d : disassemble code sections";
@@ -52,6 +58,63 @@ static void usage() {
   LOG(ERROR) << " -j : disable dex file verification";
   LOG(ERROR) << " -l : output layout, either 'plain' or 'xml'";
   LOG(ERROR) << " -o : output file name (defaults to stdout)";
+  LOG(ERROR) << " -s : only emit the named sections, a comma-separated list drawn from";
+  LOG(ERROR) << "      'header', 'classes', 'methodhandles' and 'callsites'";
+  LOG(ERROR) << " -t : number of files to process concurrently (defaults to 1); output is";
+  LOG(ERROR) << "      still emitted in command-line order";
+}
+
+/*
+ * Processes the given files with a pool of worker threads. Each worker dumps into an in-memory
+ * stream of its own and the buffers are written to `sink` in command-line order, so the output
+ * is byte-identical to a serial run.
+ */
+static int processFilesParallel(char** fileNames, int fileCount, int numThreads, FILE* sink) {
+  struct FileOutput {
+    char* buffer = nullptr;
+    size_t size = 0u;
+    int result = 0;
+  };
+  std::vector<FileOutput> outputs(fileCount);
+  std::atomic<int> nextFile(0);
+  auto worker = [&]() {
+    while (true) {
+      const int fileIndex = nextFile.fetch_add(1);
+      if (fileIndex >= fileCount) {
+        break;
+      }
+      FileOutput& output = outputs[fileIndex];
+      FILE* memStream = open_memstream(&output.buffer, &output.size);
+      if (memStream == nullptr) {
+        PLOG(ERROR) << "Can't open memory stream for " << fileNames[fileIndex];
+        output.result = -1;
+        continue;
+      }
+      gOutFile = memStream;  // Thread-local.
+      output.result = processFile(fileNames[fileIndex]);
+      fclose(memStream);
+    }
+  };
+
+  const int numWorkers = std::min(numThreads, fileCount);
+  std::vector<std::thread> workers;
+  for (int i = 1; i < numWorkers; i++) {
+    workers.emplace_back(worker);
+  }
+  worker();  // The main thread's gOutFile is restored by the caller.
+  for (std::thread& t : workers) {
+    t.join();
+  }
+
+  int result = 0;
+  for (FileOutput& output : outputs) {
+    result |= output.result;
+    if (output.buffer != nullptr) {
+      fwrite(output.buffer, 1u, output.size, sink);
+      free(output.buffer);
+    }
+  }
+  return result;
 }
 
 /*
@@ -65,7 +128,7 @@ int dexdumpDriver(int argc, char** argv) {
 
   // Parse all arguments.
   while (true) {
-    const int ic = getopt(argc, argv, "acdefghijl:o:");
+    const int ic = getopt(argc, argv, "acdefghijl:o:s:t:");
     if (ic < 0) {
       break;  // done
     }
@@ -110,6 +173,29 @@ int dexdumpDriver(int argc, char** argv) {
       case 'o':  // output file
         gOptions.outputFileName = optarg;
         break;
+      case 's':  // only emit the named sections
+        gOptions.onlySections = true;
+        for (char* tok = strtok(optarg, ","); tok != nullptr; tok = strtok(nullptr, ",")) {
+          if (strcmp(tok, "header") == 0) {
+            gOptions.showFileHeaders = true;
+          } else if (strcmp(tok, "classes") == 0) {
+            gOptions.sectionClasses = true;
+          } else if (strcmp(tok, "methodhandles") == 0) {
+            gOptions.sectionMethodHandles = true;
+          } else if (strcmp(tok, "callsites") == 0) {
+            gOptions.sectionCallSites = true;
+          } else {
+            LOG(ERROR) << "Unknown section '" << tok << "'";
+            wantUsage = true;
+          }
+        }
+        break;
+      case 't':  // number of files processed concurrently
+        gOptions.numThreads = atoi(optarg);
+        if (gOptions.numThreads < 1) {
+          wantUsage = true;
+        }
+        break;
       default:
         wantUsage = true;
         break;
@@ -141,9 +227,15 @@ int dexdumpDriver(int argc, char** argv) {
 
   // Process all files supplied on command line.
   int result = 0;
-  while (optind < argc) {
-    result |= processFile(argv[optind++]);
-  }  // while
+  if (gOptions.numThreads > 1 && argc - optind > 1) {
+    FILE* sink = gOutFile;
+    result = processFilesParallel(&argv[optind], argc - optind, gOptions.numThreads, sink);
+    gOutFile = sink;
+  } else {
+    while (optind < argc) {
+      result |= processFile(argv[optind++]);
+    }  // while
+  }
   return result != 0 ? 1 : 0;
 }
 
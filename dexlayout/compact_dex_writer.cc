@@ -35,7 +35,8 @@ CompactDexLevel CompactDexWriter::GetCompactDexLevel() const {
 }
 
 CompactDexWriter::Container::Container()
-    : data_item_dedupe_(&data_section_) {}
+    : data_item_dedupe_(&data_section_),
+      code_item_dedupe_(&data_section_) {}
 
 uint32_t CompactDexWriter::WriteDebugInfoOffsetTable(Stream* stream) {
   const uint32_t start_offset = stream->Tell();
@@ -147,7 +148,7 @@ void CompactDexWriter::WriteCodeItem(Stream* stream,
   ScopedDataSectionItem data_item(stream,
                                   code_item,
                                   CompactDexFile::CodeItem::kAlignment,
-                                  /* deduper= */ nullptr);
+                                  code_item_dedupe_);
 
   CompactDexFile::CodeItem disk_code_item;
 
@@ -396,6 +397,7 @@ bool CompactDexWriter::Write(DexContainer* output, std::string* error_msg)  {
       static_cast<uint32_t>(output->GetDataSection()->Size()),
       kDataSectionAlignment));
   data_item_dedupe_ = &container->data_item_dedupe_;
+  code_item_dedupe_ = &container->code_item_dedupe_;
 
   // Starting offset is right after the header.
   main_stream->Seek(GetHeaderSize());
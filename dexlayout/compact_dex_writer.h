@@ -127,6 +127,10 @@ class CompactDexWriter : public DexWriter {
     VectorSection main_section_;
     VectorSection data_section_;
     Deduper data_item_dedupe_;
+    // Separate dedupe map for code items so that code only dedupes against code. Since the
+    // container (and with it the data section and the dedupe maps) is reused for all the dex
+    // files of an APK, identical items collapse to a single copy across multidex files.
+    Deduper code_item_dedupe_;
 
     friend class CompactDexWriter;
   };
@@ -170,6 +174,7 @@ class CompactDexWriter : public DexWriter {
   uint32_t owned_data_end_ = 0u;
 
   Deduper* data_item_dedupe_ = nullptr;
+  Deduper* code_item_dedupe_ = nullptr;
 
   DISALLOW_COPY_AND_ASSIGN(CompactDexWriter);
 };
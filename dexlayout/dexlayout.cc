@@ -1099,6 +1099,7 @@ void DexLayout::DumpCode(uint32_t idx,
   fprintf(out_file_, "      positions     : \n");
   if (debug_info != nullptr) {
     DexFile::DecodeDebugPositionInfo(debug_info->GetDebugInfo(),
+                                     debug_info->GetDebugInfo() + debug_info->GetDebugInfoSize(),
                                      [this](uint32_t idx) {
                                        return StringDataByIdx(idx, this->header_);
                                      },
@@ -1570,18 +1571,52 @@ void DexLayout::DumpDexFile() {
   }
 }
 
+// Returns true if the profile flags any method of the class as executed during startup.
+static bool ContainsStartupMethod(ProfileCompilationInfo* info,
+                                  const DexFile* dex_file,
+                                  dex_ir::ClassDef* class_def) {
+  dex_ir::ClassData* class_data = class_def->GetClassData();
+  if (class_data == nullptr) {
+    return false;
+  }
+  for (size_t i = 0; i < 2; ++i) {
+    for (auto& method : *(i == 0 ? class_data->DirectMethods() : class_data->VirtualMethods())) {
+      const dex_ir::MethodId* method_id = method.GetMethodId();
+      if (info->GetMethodHotness(MethodReference(dex_file, method_id->GetIndex())).IsStartup()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void DexLayout::LayoutClassDefsAndClassData(const DexFile* dex_file) {
-  std::vector<dex_ir::ClassDef*> new_class_def_order;
+  // Bucket 0: profile classes with startup-flagged methods and without an annotations
+  //   directory. Their class data forms the leading region which is paged in during launch;
+  //   an annotations directory would drag unrelated data into that region.
+  // Bucket 1: remaining profile classes.
+  // Bucket 2: classes missing from the profile.
+  std::vector<uint32_t> buckets;
+  buckets.reserve(header_->ClassDefs().Size());
   for (auto& class_def : header_->ClassDefs()) {
     dex::TypeIndex type_idx(class_def->ClassType()->GetIndex());
+    uint32_t bucket = 2u;
     if (info_->ContainsClass(*dex_file, type_idx)) {
-      new_class_def_order.push_back(class_def.get());
+      const bool startup_annotation_free =
+          class_def->Annotations() == nullptr &&
+          ContainsStartupMethod(info_, dex_file, class_def.get());
+      bucket = startup_annotation_free ? 0u : 1u;
     }
+    buckets.push_back(bucket);
   }
-  for (auto& class_def : header_->ClassDefs()) {
-    dex::TypeIndex type_idx(class_def->ClassType()->GetIndex());
-    if (!info_->ContainsClass(*dex_file, type_idx)) {
-      new_class_def_order.push_back(class_def.get());
+  std::vector<dex_ir::ClassDef*> new_class_def_order;
+  for (uint32_t bucket = 0u; bucket <= 2u; ++bucket) {
+    size_t class_def_index = 0u;
+    for (auto& class_def : header_->ClassDefs()) {
+      if (buckets[class_def_index] == bucket) {
+        new_class_def_order.push_back(class_def.get());
+      }
+      ++class_def_index;
     }
   }
   std::unordered_set<dex_ir::ClassData*> visited_class_data;
@@ -1620,21 +1655,27 @@ void DexLayout::LayoutStringData(const DexFile* dex_file) {
   const size_t num_strings = header_->StringIds().Size();
   std::vector<bool> is_shorty(num_strings, false);
   std::vector<bool> from_hot_method(num_strings, false);
+  std::vector<bool> from_startup_method(num_strings, false);
   for (auto& class_def : header_->ClassDefs()) {
     // A name of a profile class is probably going to get looked up by ClassTable::Lookup, mark it
     // as hot. Add its super class and interfaces as well, which can be used during initialization.
     const bool is_profile_class =
         info_->ContainsClass(*dex_file, dex::TypeIndex(class_def->ClassType()->GetIndex()));
     if (is_profile_class) {
+      // Profile classes are resolved during startup, so their names belong in the
+      // startup cluster as well.
       from_hot_method[class_def->ClassType()->GetStringId()->GetIndex()] = true;
+      from_startup_method[class_def->ClassType()->GetStringId()->GetIndex()] = true;
       const dex_ir::TypeId* superclass = class_def->Superclass();
       if (superclass != nullptr) {
         from_hot_method[superclass->GetStringId()->GetIndex()] = true;
+        from_startup_method[superclass->GetStringId()->GetIndex()] = true;
       }
       const dex_ir::TypeList* interfaces = class_def->Interfaces();
       if (interfaces != nullptr) {
         for (const dex_ir::TypeId* interface_type : *interfaces->GetTypeList()) {
           from_hot_method[interface_type->GetStringId()->GetIndex()] = true;
+          from_startup_method[interface_type->GetStringId()->GetIndex()] = true;
         }
       }
     }
@@ -1652,11 +1693,21 @@ void DexLayout::LayoutStringData(const DexFile* dex_file) {
         const bool is_clinit = is_profile_class &&
             (method.GetAccessFlags() & kAccConstructor) != 0 &&
             (method.GetAccessFlags() & kAccStatic) != 0;
-        const bool method_executed = is_clinit ||
-            info_->GetMethodHotness(MethodReference(dex_file, method_id->GetIndex())).IsInProfile();
+        const ProfileCompilationInfo::MethodHotness hotness =
+            info_->GetMethodHotness(MethodReference(dex_file, method_id->GetIndex()));
+        const bool method_executed = is_clinit || hotness.IsInProfile();
         if (!method_executed) {
           continue;
         }
+        // Clinits of profile classes run during launch, cluster the strings they
+        // reference together with those of startup-flagged methods.
+        const bool is_startup = is_clinit || hotness.IsStartup();
+        auto mark_string = [&](size_t index) {
+          from_hot_method[index] = true;
+          if (is_startup) {
+            from_startup_method[index] = true;
+          }
+        };
         is_shorty[method_id->Proto()->Shorty()->GetIndex()] = true;
         dex_ir::CodeFixups* fixups = code_item->GetCodeFixups();
         if (fixups == nullptr) {
@@ -1664,20 +1715,20 @@ void DexLayout::LayoutStringData(const DexFile* dex_file) {
         }
         // Add const-strings.
         for (dex_ir::StringId* id : fixups->StringIds()) {
-          from_hot_method[id->GetIndex()] = true;
+          mark_string(id->GetIndex());
         }
         // Add field classes, names, and types.
         for (dex_ir::FieldId* id : fixups->FieldIds()) {
           // TODO: Only visit field ids from static getters and setters.
-          from_hot_method[id->Class()->GetStringId()->GetIndex()] = true;
-          from_hot_method[id->Name()->GetIndex()] = true;
-          from_hot_method[id->Type()->GetStringId()->GetIndex()] = true;
+          mark_string(id->Class()->GetStringId()->GetIndex());
+          mark_string(id->Name()->GetIndex());
+          mark_string(id->Type()->GetStringId()->GetIndex());
         }
         // For clinits, add referenced method classes, names, and protos.
         if (is_clinit) {
           for (dex_ir::MethodId* id : fixups->MethodIds()) {
-            from_hot_method[id->Class()->GetStringId()->GetIndex()] = true;
-            from_hot_method[id->Name()->GetIndex()] = true;
+            mark_string(id->Class()->GetStringId()->GetIndex());
+            mark_string(id->Name()->GetIndex());
             is_shorty[id->Proto()->Shorty()->GetIndex()] = true;
           }
         }
@@ -1691,13 +1742,20 @@ void DexLayout::LayoutStringData(const DexFile* dex_file) {
   }
   std::sort(string_ids.begin(),
             string_ids.end(),
-            [&is_shorty, &from_hot_method](const dex_ir::StringId* a,
-                                           const dex_ir::StringId* b) {
+            [&is_shorty, &from_hot_method, &from_startup_method](const dex_ir::StringId* a,
+                                                                 const dex_ir::StringId* b) {
     const bool a_is_hot = from_hot_method[a->GetIndex()];
     const bool b_is_hot = from_hot_method[b->GetIndex()];
     if (a_is_hot != b_is_hot) {
       return a_is_hot < b_is_hot;
     }
+    // Within the hot partition, cluster strings referenced during startup so that
+    // launch touches a contiguous range of string data pages.
+    const bool a_is_startup = from_startup_method[a->GetIndex()];
+    const bool b_is_startup = from_startup_method[b->GetIndex()];
+    if (a_is_startup != b_is_startup) {
+      return a_is_startup < b_is_startup;
+    }
     // After hot methods are partitioned, subpartition shorties.
     const bool a_is_shorty = is_shorty[a->GetIndex()];
     const bool b_is_shorty = is_shorty[b->GetIndex()];
@@ -1727,6 +1785,32 @@ void DexLayout::LayoutStringData(const DexFile* dex_file) {
   CHECK_EQ(data_index, string_datas.Size());
 }
 
+// Orders encoded arrays so that the static values of startup classes lead the section.
+void DexLayout::LayoutEncodedArrays(const DexFile* dex_file) {
+  std::unordered_set<dex_ir::EncodedArrayItem*> startup_arrays;
+  for (auto& class_def : header_->ClassDefs()) {
+    dex_ir::EncodedArrayItem* static_values = class_def->StaticValues();
+    if (static_values == nullptr) {
+      continue;
+    }
+    dex::TypeIndex type_idx(class_def->ClassType()->GetIndex());
+    if (info_->ContainsClass(*dex_file, type_idx) &&
+        ContainsStartupMethod(info_, dex_file, class_def.get())) {
+      startup_arrays.insert(static_values);
+    }
+  }
+  // Stable sort to preserve the existing order within each partition.
+  const auto& encoded_arrays = header_->EncodedArrayItems();
+  std::stable_sort(encoded_arrays.begin(),
+                   encoded_arrays.end(),
+                   [&](const std::unique_ptr<dex_ir::EncodedArrayItem>& a,
+                       const std::unique_ptr<dex_ir::EncodedArrayItem>& b) {
+    const bool a_is_startup = startup_arrays.find(a.get()) != startup_arrays.end();
+    const bool b_is_startup = startup_arrays.find(b.get()) != startup_arrays.end();
+    return a_is_startup > b_is_startup;
+  });
+}
+
 // Orders code items according to specified class data ordering.
 void DexLayout::LayoutCodeItems(const DexFile* dex_file) {
   static constexpr InvokeType invoke_types[] = {
@@ -1817,6 +1901,7 @@ void DexLayout::LayoutCodeItems(const DexFile* dex_file) {
 void DexLayout::LayoutOutputFile(const DexFile* dex_file) {
   LayoutStringData(dex_file);
   LayoutClassDefsAndClassData(dex_file);
+  LayoutEncodedArrays(dex_file);
   LayoutCodeItems(dex_file);
 }
 
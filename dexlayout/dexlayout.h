@@ -173,9 +173,10 @@ class DexLayout {
   void LayoutClassDefsAndClassData(const DexFile* dex_file);
   void LayoutCodeItems(const DexFile* dex_file);
   void LayoutStringData(const DexFile* dex_file);
+  void LayoutEncodedArrays(const DexFile* dex_file);
 
   // Creates a new layout for the dex file based on profile info.
-  // Currently reorders ClassDefs, ClassDataItems, and CodeItems.
+  // Currently reorders ClassDefs, ClassDataItems, StringDatas, EncodedArrays, and CodeItems.
   void LayoutOutputFile(const DexFile* dex_file);
   bool OutputDexFile(const DexFile* input_dex_file,
                      bool compute_offsets,
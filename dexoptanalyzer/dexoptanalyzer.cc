@@ -16,6 +16,7 @@
 
 #include "dexoptanalyzer.h"
 
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <string_view>
@@ -125,6 +126,15 @@ NO_RETURN static void Usage(const char *fmt, ...) {
   UsageError("  --validate-bcp: validates the boot class path files (.art, .oat, .vdex).");
   UsageError("      Requires --isa and --image options to locate artifacts.");
   UsageError("");
+  UsageError("  --batch-file=<filename>: run the dexopt needed analysis for every entry of the");
+  UsageError("      given file with a single runtime, so the boot image is loaded only once for");
+  UsageError("      the whole package list. Each line holds the per-package options in command");
+  UsageError("      line syntax (--dex-file= is mandatory; --compiler-filter=,");
+  UsageError("      --class-loader-context=, --profile-analysis-result= and --downgrade are");
+  UsageError("      accepted; empty lines and lines starting with '#' are skipped). The verdict");
+  UsageError("      for each entry is written to standard output as '<dex-file> <return code>'");
+  UsageError("      and the process exits with kBatchModeSuccess = 51.");
+  UsageError("");
   UsageError("Return code:");
   UsageError("  To make it easier to integrate with the internal tools this command will make");
   UsageError("    available its result (dexoptNeeded) as the exit/return code. i.e. it will not");
@@ -238,11 +248,21 @@ class DexoptAnalyzer final {
         only_flatten_context_ = true;
       } else if (option == "--validate-bcp") {
         only_validate_bcp_ = true;
+      } else if (StartsWith(option, "--batch-file=")) {
+        batch_file_ = std::string(option.substr(strlen("--batch-file=")));
       } else {
         Usage("Unknown argument '%s'", raw_option);
       }
     }
 
+    if (!batch_file_.empty()) {
+      // The file descriptor options name files of a single package and cannot be meaningfully
+      // applied to every entry of a batch.
+      if (oat_fd_ >= 0 || vdex_fd_ >= 0 || zip_fd_ >= 0 || !context_fds_.empty()) {
+        Usage("File descriptor options cannot be used together with --batch-file");
+      }
+    }
+
     if (image_.empty()) {
       // If we don't receive the image, try to use the default one.
       // Tests may specify a different image (e.g. core image).
@@ -294,7 +314,12 @@ class DexoptAnalyzer final {
       return ReturnCode::kErrorCannotCreateRuntime;
     }
     std::unique_ptr<Runtime> runtime(Runtime::Current());
+    return AnalyzeDexFile();
+  }
 
+  // Run the dexopt needed analysis for the current dex file. The runtime must have been created;
+  // in batch mode this is called once per entry against the same runtime.
+  ReturnCode AnalyzeDexFile() const {
     // Only when the runtime is created can we create the class loader context: the
     // class loader context will open dex file and use the MemMap global lock that the
     // runtime owns.
@@ -450,11 +475,94 @@ class DexoptAnalyzer final {
     return ReturnCode::kFlattenClassLoaderContextSuccess;
   }
 
-  ReturnCode Run() const {
+  // Analyze every entry of the batch file with a single runtime, so the boot image is loaded and
+  // verified only once for the whole package list instead of once per exec'd analysis.
+  ReturnCode RunBatch() {
+    std::ifstream input(batch_file_);
+    if (!input.is_open()) {
+      LOG(ERROR) << "Failed to open batch file " << batch_file_;
+      return ReturnCode::kErrorInvalidArguments;
+    }
+
+    if (!CreateRuntime()) {
+      return ReturnCode::kErrorCannotCreateRuntime;
+    }
+    std::unique_ptr<Runtime> runtime(Runtime::Current());
+
+    std::string line;
+    while (std::getline(input, line)) {
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+      ParseBatchEntry(line);
+      ReturnCode verdict = AnalyzeDexFile();
+      std::cout << dex_file_ << " " << static_cast<int>(verdict) << "\n";
+    }
+    std::cout << std::flush;
+    return ReturnCode::kBatchModeSuccess;
+  }
+
+  // Parse one batch file entry: the per-package options in command line syntax, e.g.
+  //   --dex-file=/data/app/.../base.apk --compiler-filter=speed-profile \
+  //       --class-loader-context=PCL[]
+  // Options that an entry does not specify are reset to their defaults. Argument mistakes lead
+  // to exit(kErrorInvalidArguments) just as they do in ParseArgs.
+  void ParseBatchEntry(const std::string& line) {
+    dex_file_.clear();
+    context_str_.clear();
+    downgrade_ = false;
+    profile_analysis_result_ = ProfileAnalysisResult::kDontOptimizeSmallDelta;
+
+    for (const std::string& raw_option : android::base::Split(line, " ")) {
+      if (raw_option.empty()) {
+        continue;
+      }
+      const std::string_view option(raw_option);
+      if (StartsWith(option, "--dex-file=")) {
+        dex_file_ = std::string(option.substr(strlen("--dex-file=")));
+      } else if (StartsWith(option, "--isa=")) {
+        // Every entry is analyzed against the runtime created for --isa, so a per-entry isa is
+        // only accepted when it matches: the boot image checks would be meaningless against
+        // another isa's image.
+        InstructionSet isa = GetInstructionSetFromString(raw_option.c_str() + strlen("--isa="));
+        if (isa != isa_) {
+          Usage("Batch entry isa does not match --isa: '%s'", line.c_str());
+        }
+      } else if (StartsWith(option, "--compiler-filter=")) {
+        const char* filter_str = raw_option.c_str() + strlen("--compiler-filter=");
+        if (!CompilerFilter::ParseCompilerFilter(filter_str, &compiler_filter_)) {
+          Usage("Invalid compiler filter '%s'", raw_option.c_str());
+        }
+      } else if (StartsWith(option, "--class-loader-context=")) {
+        context_str_ = std::string(option.substr(strlen("--class-loader-context=")));
+      } else if (StartsWith(option, "--profile-analysis-result=")) {
+        int parse_result = std::stoi(std::string(
+            option.substr(strlen("--profile-analysis-result="))), nullptr, 0);
+        if (parse_result != static_cast<int>(ProfileAnalysisResult::kOptimize) &&
+            parse_result != static_cast<int>(ProfileAnalysisResult::kDontOptimizeSmallDelta) &&
+            parse_result != static_cast<int>(ProfileAnalysisResult::kDontOptimizeEmptyProfiles)) {
+          Usage("Invalid --profile-analysis-result= %d", parse_result);
+        }
+        profile_analysis_result_ = static_cast<ProfileAnalysisResult>(parse_result);
+      } else if (option == "--downgrade") {
+        downgrade_ = true;
+      } else {
+        Usage("Unknown batch file option '%s'", raw_option.c_str());
+      }
+    }
+
+    if (dex_file_.empty()) {
+      Usage("Batch file entry is missing --dex-file: '%s'", line.c_str());
+    }
+  }
+
+  ReturnCode Run() {
     if (only_flatten_context_) {
       return FlattenClassLoaderContext();
     } else if (only_validate_bcp_) {
       return ValidateBcp();
+    } else if (!batch_file_.empty()) {
+      return RunBatch();
     } else {
       return GetDexOptNeeded();
     }
@@ -470,6 +578,7 @@ class DexoptAnalyzer final {
   ProfileAnalysisResult profile_analysis_result_;
   bool downgrade_;
   std::string image_;
+  std::string batch_file_;
   std::vector<const char*> runtime_args_;
   int oat_fd_ = -1;
   int vdex_fd_ = -1;
@@ -34,6 +34,11 @@ enum class ReturnCode {
   // code to communicate that the flattening code path was taken.
   kFlattenClassLoaderContextSuccess = 50,
 
+  // Success return code when executed with --batch-file. The per-package
+  // dexoptNeeded verdicts are written to standard output instead of being
+  // encoded in the exit code.
+  kBatchModeSuccess = 51,
+
   kErrorInvalidArguments = 101,
   kErrorCannotCreateRuntime = 102,
   kErrorUnknownDexOptNeeded = 103
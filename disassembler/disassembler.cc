@@ -17,6 +17,7 @@
 #include "disassembler.h"
 
 #include <ostream>
+#include <sstream>
 
 #include "android-base/logging.h"
 #include "android-base/stringprintf.h"
@@ -42,6 +43,15 @@ Disassembler::Disassembler(DisassemblerOptions* disassembler_options)
   CHECK(disassembler_options_ != nullptr);
 }
 
+size_t Disassembler::Classify(const uint8_t* begin, /*out*/ InstructionCategory* category) {
+  // Generic fallback for instruction sets without a cheap classification path: pay for a full
+  // format into a discarded stream to learn the instruction length. Targets should override
+  // this with raw encoding checks.
+  std::ostringstream discard;
+  *category = InstructionCategory::kUnknown;
+  return Dump(discard, begin);
+}
+
 Disassembler* Disassembler::Create(InstructionSet instruction_set, DisassemblerOptions* options) {
   switch (instruction_set) {
 #ifdef ART_ENABLE_CODEGEN_arm
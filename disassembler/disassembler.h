@@ -63,6 +63,15 @@ class DisassemblerOptions {
 
 class Disassembler {
  public:
+  // Coarse classification of a single instruction, available without formatting its operands.
+  enum class InstructionCategory {
+    kUnknown,    // The disassembler has no cheap classification for this instruction set.
+    kOther,
+    kBranch,     // Branches, calls and returns.
+    kLoadStore,
+    kNop,
+  };
+
   // Creates a Disassembler for the given InstructionSet with the
   // non-null DisassemblerOptions which become owned by the
   // Disassembler.
@@ -76,6 +85,10 @@ class Disassembler {
   virtual size_t Dump(std::ostream& os, const uint8_t* begin) = 0;
   // Dump instructions within a range.
   virtual void Dump(std::ostream& os, const uint8_t* begin, const uint8_t* end) = 0;
+  // Classify a single instruction returning its length. This is the cheap phase of a two-phase
+  // disassembly: callers that only count instructions or match branches can walk code with
+  // Classify and call Dump solely for the instructions they decide to print.
+  virtual size_t Classify(const uint8_t* begin, /*out*/ InstructionCategory* category);
 
   const DisassemblerOptions* GetDisassemblerOptions() const {
     return disassembler_options_;
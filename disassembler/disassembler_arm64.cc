@@ -144,5 +144,30 @@ void DisassemblerArm64::Dump(std::ostream& os, const uint8_t* begin, const uint8
   }
 }
 
+size_t DisassemblerArm64::Classify(const uint8_t* begin, /*out*/ InstructionCategory* category) {
+  // Classify from the major encoding groups (op0, bits 28-25) without driving the vixl decoder:
+  // visitor dispatch and operand formatting dominate the cost of Dump, and callers that only
+  // count instructions or match branches need neither.
+  const uint32_t encoding = reinterpret_cast<const Instruction*>(begin)->GetInstructionBits();
+  const uint32_t op0 = (encoding >> 25) & 0xfu;
+  if (encoding == 0xd503201fu) {  // NOP.
+    *category = InstructionCategory::kNop;
+  } else if ((op0 & 0xeu) == 0xau) {
+    // 101x: branches, exception generation and system instructions. Filter out the system
+    // (0b1101010100x...) and exception generation (0b11010100x...) encodings so that only
+    // actual control transfers report kBranch.
+    if ((encoding & 0xffc00000u) == 0xd5000000u || (encoding & 0xff000000u) == 0xd4000000u) {
+      *category = InstructionCategory::kOther;
+    } else {
+      *category = InstructionCategory::kBranch;
+    }
+  } else if ((op0 & 0x5u) == 0x4u) {  // x1x0: loads and stores.
+    *category = InstructionCategory::kLoadStore;
+  } else {
+    *category = InstructionCategory::kOther;
+  }
+  return kInstructionSize;
+}
+
 }  // namespace arm64
 }  // namespace art
@@ -83,6 +83,7 @@ class DisassemblerArm64 final : public Disassembler {
 
   size_t Dump(std::ostream& os, const uint8_t* begin) override;
   void Dump(std::ostream& os, const uint8_t* begin, const uint8_t* end) override;
+  size_t Classify(const uint8_t* begin, /*out*/ InstructionCategory* category) override;
 
  private:
   vixl::aarch64::Decoder decoder;
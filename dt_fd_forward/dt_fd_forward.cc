@@ -32,6 +32,7 @@
 
 #include "dt_fd_forward.h"
 
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,7 @@
 #include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <poll.h>
 
@@ -285,6 +287,39 @@ IOResult FdForwardTransport::WriteFully(const void* data, size_t ndata) {
   return WriteFullyWithoutChecks(data, ndata);
 }
 
+IOResult FdForwardTransport::WritevFullyWithoutChecks(struct iovec* iov, int iovcnt) {
+  ScopedEventFdLock sefdl(write_lock_fd_);
+  while (iovcnt > 0) {
+    ssize_t res = TEMP_FAILURE_RETRY(writev(write_fd_, iov, iovcnt));
+    if (res < 0) {
+      DT_IO_ERROR("Failed writev()");
+      return IOResult::kError;
+    } else if (res == 0) {
+      return IOResult::kEOF;
+    }
+    // Skip over the fully written iovecs and adjust the first partially written one, if any.
+    size_t written = static_cast<size_t>(res);
+    while (iovcnt > 0 && written >= iov[0].iov_len) {
+      written -= iov[0].iov_len;
+      ++iov;
+      --iovcnt;
+    }
+    if (iovcnt > 0) {
+      iov[0].iov_base = static_cast<uint8_t*>(iov[0].iov_base) + written;
+      iov[0].iov_len -= written;
+    }
+  }
+  return IOResult::kOk;
+}
+
+IOResult FdForwardTransport::WritevFully(struct iovec* iov, int iovcnt) {
+  std::lock_guard<std::mutex> lk(state_mutex_);
+  if (state_ != TransportState::kOpen) {
+    return IOResult::kInterrupt;
+  }
+  return WritevFullyWithoutChecks(iov, iovcnt);
+}
+
 static void SendAcceptMessage(int fd) {
   TEMP_FAILURE_RETRY(send(fd, kAcceptMessage, sizeof(kAcceptMessage), MSG_EOR));
 }
@@ -590,29 +625,46 @@ jdwpTransportError FdForwardTransport::ReadPacket(jdwpPacket* pkt) {
   }
 }
 
-// A class that writes a packet to the transport.
+// A class that writes a packet to the transport. The fixed-size header is assembled on the stack
+// and sent together with the payload as a single vectored write, so each packet costs one syscall
+// and the payload is never copied.
 class PacketWriter {
  public:
   PacketWriter(FdForwardTransport* transport, const jdwpPacket* pkt)
-      : transport_(transport), pkt_(pkt), data_() {}
+      : transport_(transport), pkt_(pkt), header_size_(0) {}
 
   bool WriteFully() {
     PushInt32(pkt_->type.cmd.len);
     PushInt32(pkt_->type.cmd.id);
     PushByte(pkt_->type.cmd.flags);
+    void* payload;
+    size_t payload_len;
     if ((pkt_->type.reply.flags & JDWPTRANSPORT_FLAGS_REPLY) == JDWPTRANSPORT_FLAGS_REPLY) {
       PushInt16(pkt_->type.reply.errorCode);
-      PushData(pkt_->type.reply.data, pkt_->type.reply.len - 11);
+      payload = pkt_->type.reply.data;
+      payload_len = pkt_->type.reply.len - kHeaderSize;
     } else {
       PushByte(pkt_->type.cmd.cmdSet);
       PushByte(pkt_->type.cmd.cmd);
-      PushData(pkt_->type.cmd.data, pkt_->type.cmd.len - 11);
+      payload = pkt_->type.cmd.data;
+      payload_len = pkt_->type.cmd.len - kHeaderSize;
     }
-    IOResult res = transport_->WriteFully(data_.data(), data_.size());
+    DCHECK_EQ(header_size_, kHeaderSize);
+    struct iovec iov[2];
+    iov[0] = { header_, header_size_ };
+    int iovcnt = 1;
+    if (payload_len != 0) {
+      iov[1] = { payload, payload_len };
+      iovcnt = 2;
+    }
+    IOResult res = transport_->WritevFully(iov, iovcnt);
     return res == IOResult::kOk;
   }
 
  private:
+  // A JDWP packet starts with an 11 byte header (see the jdwpPacket len fields above).
+  static constexpr size_t kHeaderSize = 11;
+
   void PushInt32(int32_t data) {
     data = HostToNetwork(data);
     PushData(&data, sizeof(data));
@@ -622,17 +674,19 @@ class PacketWriter {
     PushData(&data, sizeof(data));
   }
   void PushByte(jbyte data) {
-    data_.push_back(HostToNetwork(data));
+    header_[header_size_++] = static_cast<uint8_t>(HostToNetwork(data));
   }
 
   void PushData(void* d, size_t size) {
-    uint8_t* bytes = reinterpret_cast<uint8_t*>(d);
-    data_.insert(data_.end(), bytes, bytes + size);
+    DCHECK_LE(header_size_ + size, kHeaderSize);
+    memcpy(header_ + header_size_, d, size);
+    header_size_ += size;
   }
 
   FdForwardTransport* transport_;
   const jdwpPacket* pkt_;
-  std::vector<uint8_t> data_;
+  uint8_t header_[kHeaderSize];
+  size_t header_size_;
 };
 
 jdwpTransportError FdForwardTransport::WritePacket(const jdwpPacket* pkt) {
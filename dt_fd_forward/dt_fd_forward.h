@@ -43,6 +43,7 @@
 
 #include <arpa/inet.h>
 #include <sys/eventfd.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <poll.h>
 
@@ -111,6 +112,10 @@ class FdForwardTransport : public jdwpTransportEnv {
 
   IOResult WriteFully(const void* data, size_t ndata);  // REQUIRES(!state_mutex_);
   IOResult WriteFullyWithoutChecks(const void* data, size_t ndata);  // REQUIRES(state_mutex_);
+  // Vectored variants used to write a packet header and payload with a single syscall. The iovec
+  // array is modified in place to track partial writes.
+  IOResult WritevFully(struct iovec* iov, int iovcnt);  // REQUIRES(!state_mutex_);
+  IOResult WritevFullyWithoutChecks(struct iovec* iov, int iovcnt);  // REQUIRES(state_mutex_);
   IOResult ReadFully(void* data, size_t ndata);  // REQUIRES(!state_mutex_);
   IOResult ReadUpToMax(void* data, size_t ndata, /*out*/size_t* amount_read);
       // REQUIRES(state_mutex_);
@@ -58,6 +58,81 @@ namespace art {
 
 using android::base::StringPrintf;
 
+// Aggregated private-dirty attribution for dirty boot-image objects, keyed by class descriptor so
+// that the results of diffing several processes (e.g. a set of zygote children) and several boot
+// image components can be combined into one ranking. Written out in a format that dex2oat's
+// --dirty-image-objects option can consume directly (comment lines start with '#', every other
+// line is a class descriptor); see ReadCommentedInputFromFile in dex2oat.
+class DirtyImageObjectsReport {
+ public:
+  // Start attributing dirty objects to `pid`. Per-class process counts are incremented at most
+  // once per process.
+  void BeginProcess(pid_t pid) {
+    pids_.push_back(pid);
+    classes_seen_in_current_process_.clear();
+  }
+
+  void AddDirtyObject(const std::string& descriptor, size_t dirty_bytes, size_t object_size) {
+    ClassStats& stats = stats_[descriptor];
+    ++stats.dirty_object_count;
+    stats.dirty_byte_count += dirty_bytes;
+    stats.object_byte_count += object_size;
+    if (classes_seen_in_current_process_.insert(descriptor).second) {
+      ++stats.process_count;
+    }
+  }
+
+  // Write the ranked report to `out_filename`. Classes are ordered by their aggregate byte-exact
+  // dirty cost across all diffed processes, most expensive first.
+  bool Write(const std::string& out_filename, std::ostream& os) const {
+    std::ofstream out(out_filename, std::ofstream::out | std::ofstream::trunc);
+    if (!out.is_open()) {
+      os << "Could not open " << out_filename << " for writing\n";
+      return false;
+    }
+    // Pairs of (aggregate dirty byte count, descriptor), ranked descending.
+    std::vector<std::pair<size_t, const std::string*>> ranked;
+    ranked.reserve(stats_.size());
+    for (const auto& entry : stats_) {
+      ranked.emplace_back(entry.second.dirty_byte_count, &entry.first);
+    }
+    std::sort(ranked.rbegin(), ranked.rend());
+    out << "# Dirty boot image classes, ranked by private-dirty bytes aggregated over "
+        << pids_.size() << " process(es):";
+    for (pid_t pid : pids_) {
+      out << " " << pid;
+    }
+    out << "\n";
+    out << "# This file can be passed to dex2oat via --dirty-image-objects=.\n";
+    for (const auto& ranked_pair : ranked) {
+      const ClassStats& stats = stats_.find(*ranked_pair.second)->second;
+      out << "# dirty_bytes=" << stats.dirty_byte_count
+          << " dirty_objects=" << stats.dirty_object_count
+          << " object_bytes=" << stats.object_byte_count
+          << " processes=" << stats.process_count << "\n";
+      out << *ranked_pair.second << "\n";
+    }
+    os << "Wrote " << ranked.size() << " dirty image classes to " << out_filename << "\n";
+    return true;
+  }
+
+ private:
+  struct ClassStats {
+    // Number of objects of this class that were dirty, summed over all diffed processes.
+    size_t dirty_object_count = 0;
+    // Byte-exact dirtiness of those objects (only the bytes that actually differed).
+    size_t dirty_byte_count = 0;
+    // Total size of the dirty objects.
+    size_t object_byte_count = 0;
+    // Number of diffed processes in which at least one object of this class was dirty.
+    size_t process_count = 0;
+  };
+
+  std::map<std::string, ClassStats> stats_;
+  std::vector<pid_t> pids_;
+  std::set<std::string> classes_seen_in_current_process_;
+};
+
 namespace {
 
 constexpr size_t kMaxAddressPrint = 5;
@@ -382,10 +457,12 @@ class RegionSpecializedBase<mirror::Object> : public RegionCommon<mirror::Object
                         ArrayRef<uint8_t> zygote_contents,
                         const backtrace_map_t& boot_map,
                         const ImageHeader& image_header,
-                        bool dump_dirty_objects)
+                        bool dump_dirty_objects,
+                        DirtyImageObjectsReport* dirty_objects_report)
       : RegionCommon<mirror::Object>(os, remote_contents, zygote_contents, boot_map, image_header),
         os_(*os),
-        dump_dirty_objects_(dump_dirty_objects) { }
+        dump_dirty_objects_(dump_dirty_objects),
+        dirty_objects_report_(dirty_objects_report) { }
 
   // Define a common public type name for use by RegionData.
   using VisitorClass = ImgObjectVisitor;
@@ -433,7 +510,14 @@ class RegionSpecializedBase<mirror::Object> : public RegionCommon<mirror::Object
       }
       dirty_entries_.push_back(entry);
     }
-    class_data_[klass].AddDirtyObject(entry, entry_remote);
+    ClassData& class_data = class_data_[klass];
+    size_t dirty_bytes_before = class_data.dirty_object_byte_count;
+    class_data.AddDirtyObject(entry, entry_remote);
+    if (dirty_objects_report_ != nullptr) {
+      dirty_objects_report_->AddDirtyObject(GetClassDescriptor(klass),
+                                            class_data.dirty_object_byte_count - dirty_bytes_before,
+                                            entry_size);
+    }
   }
 
   void DiffEntryContents(mirror::Object* entry,
@@ -651,6 +735,9 @@ class RegionSpecializedBase<mirror::Object> : public RegionCommon<mirror::Object
 
   std::ostream& os_;
   bool dump_dirty_objects_;
+  // If non-null, dirty objects are additionally attributed to their class descriptor here so that
+  // the caller can aggregate attributions across several diffed processes.
+  DirtyImageObjectsReport* const dirty_objects_report_;
   std::unordered_set<mirror::Object*> dirty_objects_;
   std::map<mirror::Class*, ClassData> class_data_;
 
@@ -711,7 +798,8 @@ class RegionSpecializedBase<ArtMethod> : public RegionCommon<ArtMethod> {
                         ArrayRef<uint8_t> zygote_contents,
                         const backtrace_map_t& boot_map,
                         const ImageHeader& image_header,
-                        bool dump_dirty_objects ATTRIBUTE_UNUSED)
+                        bool dump_dirty_objects ATTRIBUTE_UNUSED,
+                        DirtyImageObjectsReport* dirty_objects_report ATTRIBUTE_UNUSED)
       : RegionCommon<ArtMethod>(os, remote_contents, zygote_contents, boot_map, image_header),
         os_(*os) {
     // Prepare the table for offset to member lookups.
@@ -951,13 +1039,15 @@ class RegionData : public RegionSpecializedBase<T> {
              ArrayRef<uint8_t> zygote_contents,
              const backtrace_map_t& boot_map,
              const ImageHeader& image_header,
-             bool dump_dirty_objects)
+             bool dump_dirty_objects,
+             DirtyImageObjectsReport* dirty_objects_report)
       : RegionSpecializedBase<T>(os,
                                  remote_contents,
                                  zygote_contents,
                                  boot_map,
                                  image_header,
-                                 dump_dirty_objects),
+                                 dump_dirty_objects,
+                                 dirty_objects_report),
         os_(*os) {
     CHECK(!remote_contents.empty());
   }
@@ -1117,11 +1207,13 @@ class ImgDiagDumper {
   explicit ImgDiagDumper(std::ostream* os,
                          pid_t image_diff_pid,
                          pid_t zygote_diff_pid,
-                         bool dump_dirty_objects)
+                         bool dump_dirty_objects,
+                         DirtyImageObjectsReport* dirty_objects_report)
       : os_(os),
         image_diff_pid_(image_diff_pid),
         zygote_diff_pid_(zygote_diff_pid),
         dump_dirty_objects_(dump_dirty_objects),
+        dirty_objects_report_(dirty_objects_report),
         zygote_pid_only_(false) {}
 
   bool Init() {
@@ -1596,7 +1688,8 @@ class ImgDiagDumper {
                                                   zygote_contents,
                                                   boot_map,
                                                   image_header,
-                                                  dump_dirty_objects_);
+                                                  dump_dirty_objects_,
+                                                  dirty_objects_report_);
     object_region_data.ProcessRegion(mapping_data,
                                      remotes,
                                      image_begin_unaligned);
@@ -1607,7 +1700,8 @@ class ImgDiagDumper {
                                                 zygote_contents,
                                                 boot_map,
                                                 image_header,
-                                                dump_dirty_objects_);
+                                                dump_dirty_objects_,
+                                                dirty_objects_report_);
     artmethod_region_data.ProcessRegion(mapping_data,
                                         remotes,
                                         image_begin_unaligned);
@@ -1798,6 +1892,9 @@ class ImgDiagDumper {
   pid_t image_diff_pid_;  // Dump image diff against boot.art if pid is non-negative
   pid_t zygote_diff_pid_;  // Dump image diff against zygote boot.art if pid is non-negative
   bool dump_dirty_objects_;  // Adds dumping of objects that are dirty.
+  // If non-null, per-class dirty-object attribution is accumulated here (may be shared with the
+  // dumpers of other diffed processes).
+  DirtyImageObjectsReport* const dirty_objects_report_;
   bool zygote_pid_only_;  // The user only specified a pid for the zygote.
 
   // BacktraceMap used for finding the memory mapping of the image file.
@@ -1826,31 +1923,43 @@ class ImgDiagDumper {
 
 static int DumpImage(Runtime* runtime,
                      std::ostream* os,
-                     pid_t image_diff_pid,
+                     const std::vector<pid_t>& image_diff_pids,
                      pid_t zygote_diff_pid,
-                     bool dump_dirty_objects) {
+                     bool dump_dirty_objects,
+                     const std::string& dirty_image_objects_out) {
   ScopedObjectAccess soa(Thread::Current());
   gc::Heap* heap = runtime->GetHeap();
   const std::vector<gc::space::ImageSpace*>& image_spaces = heap->GetBootImageSpaces();
   CHECK(!image_spaces.empty());
-  ImgDiagDumper img_diag_dumper(os,
-                                image_diff_pid,
-                                zygote_diff_pid,
-                                dump_dirty_objects);
-  if (!img_diag_dumper.Init()) {
-    return EXIT_FAILURE;
-  }
-  for (gc::space::ImageSpace* image_space : image_spaces) {
-    const ImageHeader& image_header = image_space->GetImageHeader();
-    if (!image_header.IsValid()) {
-      fprintf(stderr, "Invalid image header %s\n", image_space->GetImageLocation().c_str());
+  DirtyImageObjectsReport dirty_objects_report;
+  const bool want_report = !dirty_image_objects_out.empty();
+  for (pid_t image_diff_pid : image_diff_pids) {
+    if (want_report && image_diff_pid >= 0) {
+      dirty_objects_report.BeginProcess(image_diff_pid);
+    }
+    ImgDiagDumper img_diag_dumper(os,
+                                  image_diff_pid,
+                                  zygote_diff_pid,
+                                  dump_dirty_objects,
+                                  want_report ? &dirty_objects_report : nullptr);
+    if (!img_diag_dumper.Init()) {
       return EXIT_FAILURE;
     }
+    for (gc::space::ImageSpace* image_space : image_spaces) {
+      const ImageHeader& image_header = image_space->GetImageHeader();
+      if (!image_header.IsValid()) {
+        fprintf(stderr, "Invalid image header %s\n", image_space->GetImageLocation().c_str());
+        return EXIT_FAILURE;
+      }
 
-    if (!img_diag_dumper.Dump(image_header, image_space->GetImageLocation())) {
-      return EXIT_FAILURE;
+      if (!img_diag_dumper.Dump(image_header, image_space->GetImageLocation())) {
+        return EXIT_FAILURE;
+      }
     }
   }
+  if (want_report && !dirty_objects_report.Write(dirty_image_objects_out, *os)) {
+    return EXIT_FAILURE;
+  }
   return EXIT_SUCCESS;
 }
 
@@ -1873,10 +1982,12 @@ struct ImgDiagArgs : public CmdlineArgs {
     if (StartsWith(option, "--image-diff-pid=")) {
       const char* image_diff_pid = raw_option + strlen("--image-diff-pid=");
 
-      if (!android::base::ParseInt(image_diff_pid, &image_diff_pid_)) {
+      pid_t pid;
+      if (!android::base::ParseInt(image_diff_pid, &pid)) {
         *error_msg = "Image diff pid out of range";
         return kParseError;
       }
+      image_diff_pids_.push_back(pid);
     } else if (StartsWith(option, "--zygote-diff-pid=")) {
       const char* zygote_diff_pid = raw_option + strlen("--zygote-diff-pid=");
 
@@ -1886,6 +1997,8 @@ struct ImgDiagArgs : public CmdlineArgs {
       }
     } else if (option == "--dump-dirty-objects") {
       dump_dirty_objects_ = true;
+    } else if (StartsWith(option, "--dirty-image-objects-out=")) {
+      dirty_image_objects_out_ = raw_option + strlen("--dirty-image-objects-out=");
     } else {
       return kParseUnknownArgument;
     }
@@ -1902,16 +2015,20 @@ struct ImgDiagArgs : public CmdlineArgs {
 
     // Perform our own checks.
 
-    if (kill(image_diff_pid_,
-             /*sig*/0) != 0) {  // No signal is sent, perform error-checking only.
-      // Check if the pid exists before proceeding.
-      if (errno == ESRCH) {
-        *error_msg = "Process specified does not exist";
-      } else {
-        *error_msg = StringPrintf("Failed to check process status: %s", strerror(errno));
+    for (pid_t image_diff_pid : image_diff_pids_) {
+      if (kill(image_diff_pid,
+               /*sig*/0) != 0) {  // No signal is sent, perform error-checking only.
+        // Check if the pid exists before proceeding.
+        if (errno == ESRCH) {
+          *error_msg = StringPrintf("Process specified does not exist, pid: %d",
+                                    static_cast<int>(image_diff_pid));
+        } else {
+          *error_msg = StringPrintf("Failed to check process status: %s", strerror(errno));
+        }
+        return kParseError;
       }
-      return kParseError;
-    } else if (instruction_set_ != InstructionSet::kNone && instruction_set_ != kRuntimeISA) {
+    }
+    if (instruction_set_ != InstructionSet::kNone && instruction_set_ != kRuntimeISA) {
       // Don't allow different ISAs since the images are ISA-specific.
       // Right now the code assumes both the runtime ISA and the remote ISA are identical.
       *error_msg = "Must use the default runtime ISA; changing ISA is not supported.";
@@ -1934,31 +2051,45 @@ struct ImgDiagArgs : public CmdlineArgs {
 
     usage +=  // Optional.
         "  --image-diff-pid=<pid>: provide the PID of a process whose boot.art you want to diff.\n"
+        "      May be specified multiple times to aggregate the diff over several processes\n"
+        "      (e.g. a set of zygote children).\n"
         "      Example: --image-diff-pid=$(pid zygote)\n"
         "  --zygote-diff-pid=<pid>: provide the PID of the zygote whose boot.art you want to diff "
         "against.\n"
         "      Example: --zygote-diff-pid=$(pid zygote)\n"
         "  --dump-dirty-objects: additionally output dirty objects of interest.\n"
+        "  --dirty-image-objects-out=<file>: write the classes of dirty boot image objects,\n"
+        "      ranked by private-dirty bytes aggregated over all diffed processes, to <file>\n"
+        "      in a format suitable for dex2oat's --dirty-image-objects option.\n"
+        "      Example: --dirty-image-objects-out=/data/local/tmp/dirty-image-objects.txt\n"
         "\n";
 
     return usage;
   }
 
  public:
-  pid_t image_diff_pid_ = -1;
+  std::vector<pid_t> image_diff_pids_;
   pid_t zygote_diff_pid_ = -1;
   bool dump_dirty_objects_ = false;
+  std::string dirty_image_objects_out_;
 };
 
 struct ImgDiagMain : public CmdlineMain<ImgDiagArgs> {
   bool ExecuteWithRuntime(Runtime* runtime) override {
     CHECK(args_ != nullptr);
 
+    // With no --image-diff-pid, pass a single invalid pid so that ImgDiagDumper::Init can apply
+    // its --zygote-diff-pid-only handling (or report the missing-pid error).
+    std::vector<pid_t> image_diff_pids = args_->image_diff_pids_;
+    if (image_diff_pids.empty()) {
+      image_diff_pids.push_back(-1);
+    }
     return DumpImage(runtime,
                      args_->os_,
-                     args_->image_diff_pid_,
+                     image_diff_pids,
                      args_->zygote_diff_pid_,
-                     args_->dump_dirty_objects_) == EXIT_SUCCESS;
+                     args_->dump_dirty_objects_,
+                     args_->dirty_image_objects_out_) == EXIT_SUCCESS;
   }
 };
 
@@ -101,13 +101,13 @@ const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
 template <bool kCount>
 ArenaAllocatorStatsImpl<kCount>::ArenaAllocatorStatsImpl()
     : num_allocations_(0u),
-      alloc_stats_(kNumArenaAllocKinds, 0u) {
+      alloc_stats_{} {
 }
 
 template <bool kCount>
 void ArenaAllocatorStatsImpl<kCount>::Copy(const ArenaAllocatorStatsImpl& other) {
   num_allocations_ = other.num_allocations_;
-  std::copy_n(other.alloc_stats_.begin(), kNumArenaAllocKinds, alloc_stats_.begin());
+  std::copy_n(other.alloc_stats_, kNumArenaAllocKinds, alloc_stats_);
 }
 
 template <bool kCount>
@@ -124,7 +124,7 @@ size_t ArenaAllocatorStatsImpl<kCount>::NumAllocations() const {
 template <bool kCount>
 size_t ArenaAllocatorStatsImpl<kCount>::BytesAllocated() const {
   const size_t init = 0u;  // Initial value of the correct type.
-  return std::accumulate(alloc_stats_.begin(), alloc_stats_.end(), init);
+  return std::accumulate(alloc_stats_, alloc_stats_ + kNumArenaAllocKinds, init);
 }
 
 template <bool kCount>
@@ -167,10 +167,6 @@ void ArenaAllocatorStatsImpl<kCount>::Dump(std::ostream& os, const Arena* first,
 // to be explicitly instantiated if kArenaAllocatorCountAllocations is true. Explicit
 // instantiation of the specialization ArenaAllocatorStatsImpl<false> does not do anything
 // but requires the warning "-Winstantiation-after-specialization" to be turned off.
-//
-// To avoid bit-rot of the ArenaAllocatorStatsImpl<true>, instantiate it also in debug builds
-// (but keep the unnecessary code out of release builds) as we do not usually compile with
-// kArenaAllocatorCountAllocations set to true.
 template class ArenaAllocatorStatsImpl<kArenaAllocatorCountAllocations || kIsDebugBuild>;
 #pragma GCC diagnostic pop
 
@@ -22,7 +22,6 @@
 
 #include "bit_utils.h"
 #include "debug_stack.h"
-#include "dchecked_vector.h"
 #include "macros.h"
 #include "memory_tool.h"
 
@@ -38,7 +37,11 @@ class MemStats;
 template <typename T>
 class ArenaAllocatorAdapter;
 
-static constexpr bool kArenaAllocatorCountAllocations = false;
+// Per-kind byte counters cost a single indexed add on the allocation path, so they are
+// enabled unconditionally: they are what allows attributing arena memory to individual
+// optimizing passes on problem methods in production dex2oat runs (see the --dump-stats
+// handling in OptimizingCompiler).
+static constexpr bool kArenaAllocatorCountAllocations = true;
 
 // Type of allocation for memory tuning.
 enum ArenaAllocKind {
@@ -142,7 +145,10 @@ class ArenaAllocatorStatsImpl {
 
  private:
   size_t num_allocations_;
-  dchecked_vector<size_t> alloc_stats_;  // Bytes used by various allocation kinds.
+  // Bytes used by various allocation kinds. A plain array rather than a vector so that
+  // constructing an allocator does not cost a heap allocation now that the stats are
+  // always enabled.
+  size_t alloc_stats_[kNumArenaAllocKinds];
 
   static const char* const kAllocNames[];
 };
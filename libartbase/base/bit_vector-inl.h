@@ -19,6 +19,8 @@
 
 #include "bit_vector.h"
 
+#include <algorithm>
+
 #include <android-base/logging.h>
 
 #include "bit_utils.h"
@@ -28,16 +30,17 @@ namespace art {
 inline bool BitVector::IndexIterator::operator==(const IndexIterator& other) const {
   DCHECK(bit_storage_ == other.bit_storage_);
   DCHECK_EQ(storage_size_, other.storage_size_);
+  DCHECK_EQ(limit_bit_index_, other.limit_bit_index_);
   return bit_index_ == other.bit_index_;
 }
 
 inline uint32_t BitVector::IndexIterator::operator*() const {
-  DCHECK_LT(bit_index_, BitSize());
+  DCHECK_LT(bit_index_, limit_bit_index_);
   return bit_index_;
 }
 
 inline BitVector::IndexIterator& BitVector::IndexIterator::operator++() {
-  DCHECK_LT(bit_index_, BitSize());
+  DCHECK_LT(bit_index_, limit_bit_index_);
   bit_index_ = FindIndex(bit_index_ + 1u);
   return *this;
 }
@@ -49,7 +52,7 @@ inline BitVector::IndexIterator BitVector::IndexIterator::operator++(int) {
 }
 
 inline uint32_t BitVector::IndexIterator::FindIndex(uint32_t start_index) const {
-  DCHECK_LE(start_index, BitSize());
+  DCHECK_LE(start_index, limit_bit_index_);
   uint32_t word_index = start_index / kWordBits;
   if (UNLIKELY(word_index == storage_size_)) {
     return start_index;
@@ -59,30 +62,43 @@ inline uint32_t BitVector::IndexIterator::FindIndex(uint32_t start_index) const
   word &= static_cast<uint32_t>(-1) << (start_index & 0x1f);
   while (word == 0u) {
     ++word_index;
-    if (UNLIKELY(word_index == storage_size_)) {
-      return BitSize();
+    if (UNLIKELY(word_index == storage_size_ || word_index * kWordBits >= limit_bit_index_)) {
+      return limit_bit_index_;
     }
     word = bit_storage_[word_index];
   }
-  return word_index * 32u + CTZ(word);
+  // A set bit at or above the limit terminates the iteration as well.
+  return std::min(word_index * kWordBits + CTZ(word), limit_bit_index_);
 }
 
-inline BitVector::IndexIterator::IndexIterator(const BitVector* bit_vector, begin_tag)
+inline BitVector::IndexIterator::IndexIterator(const BitVector* bit_vector,
+                                               uint32_t start_index,
+                                               uint32_t limit_index,
+                                               begin_tag)
   : bit_storage_(bit_vector->GetRawStorage()),
     storage_size_(bit_vector->storage_size_),
-    bit_index_(FindIndex(0u)) { }
+    limit_bit_index_(limit_index),
+    bit_index_(FindIndex(start_index)) {
+  DCHECK_LE(limit_bit_index_, BitSize());
+}
 
-inline BitVector::IndexIterator::IndexIterator(const BitVector* bit_vector, end_tag)
+inline BitVector::IndexIterator::IndexIterator(const BitVector* bit_vector,
+                                               uint32_t limit_index,
+                                               end_tag)
   : bit_storage_(bit_vector->GetRawStorage()),
     storage_size_(bit_vector->storage_size_),
-    bit_index_(BitSize()) { }
+    limit_bit_index_(limit_index),
+    bit_index_(limit_index) {
+  DCHECK_LE(limit_bit_index_, BitSize());
+}
 
 inline BitVector::IndexIterator BitVector::IndexContainer::begin() const {
-  return IndexIterator(bit_vector_, IndexIterator::begin_tag());
+  DCHECK_LE(begin_bit_, end_bit_);
+  return IndexIterator(bit_vector_, begin_bit_, end_bit_, IndexIterator::begin_tag());
 }
 
 inline BitVector::IndexIterator BitVector::IndexContainer::end() const {
-  return IndexIterator(bit_vector_, IndexIterator::end_tag());
+  return IndexIterator(bit_vector_, end_bit_, IndexIterator::end_tag());
 }
 
 inline void BitVector::ClearAllBits() {
@@ -246,6 +246,30 @@ uint32_t BitVector::NumSetBits(uint32_t end) const {
   return NumSetBits(storage_, end);
 }
 
+uint32_t BitVector::NumSetBits(uint32_t begin, uint32_t end) const {
+  DCHECK_LE(begin, end);
+  DCHECK_LE(end, storage_size_ * kWordBits);
+  if (begin == end) {
+    return 0u;
+  }
+  uint32_t word_begin = WordIndex(begin);
+  uint32_t word_end = WordIndex(end);
+  uint32_t begin_mask = 0xffffffffu << (begin & 0x1f);
+  uint32_t partial_word_bits = end & 0x1f;
+  if (word_begin == word_end) {
+    DCHECK_NE(partial_word_bits, 0u);
+    return POPCOUNT(storage_[word_begin] & begin_mask & ~(0xffffffffu << partial_word_bits));
+  }
+  uint32_t count = POPCOUNT(storage_[word_begin] & begin_mask);
+  for (uint32_t word = word_begin + 1u; word < word_end; word++) {
+    count += POPCOUNT(storage_[word]);
+  }
+  if (partial_word_bits != 0u) {
+    count += POPCOUNT(storage_[word_end] & ~(0xffffffffu << partial_word_bits));
+  }
+  return count;
+}
+
 void BitVector::SetInitialBits(uint32_t num_bits) {
   // If num_bits is 0, clear everything.
   if (num_bits == 0) {
@@ -68,15 +68,16 @@ class BitVector {
 
     // Helper function to check for end without comparing with bit_vector.Indexes().end().
     bool Done() const {
-      return bit_index_ == BitSize();
+      return bit_index_ == limit_bit_index_;
     }
 
    private:
     struct begin_tag { };
     struct end_tag { };
 
-    IndexIterator(const BitVector* bit_vector, begin_tag);
-    IndexIterator(const BitVector* bit_vector, end_tag);
+    IndexIterator(const BitVector* bit_vector, uint32_t start_index, uint32_t limit_index,
+                  begin_tag);
+    IndexIterator(const BitVector* bit_vector, uint32_t limit_index, end_tag);
 
     uint32_t BitSize() const {
       return storage_size_ * kWordBits;
@@ -84,24 +85,32 @@ class BitVector {
 
     uint32_t FindIndex(uint32_t start_index) const;
     const uint32_t* const bit_storage_;
-    const uint32_t storage_size_;  // Size of vector in words.
-    uint32_t bit_index_;           // Current index (size in bits).
+    const uint32_t storage_size_;    // Size of vector in words.
+    const uint32_t limit_bit_index_; // Indexes at or above this limit are not visited.
+    uint32_t bit_index_;             // Current index (size in bits).
 
     friend class BitVector::IndexContainer;
   };
 
   /**
-   * @brief BitVector wrapper class for iteration across indexes of set bits.
+   * @brief BitVector wrapper class for iteration across indexes of set bits,
+   * optionally restricted to a sub-range [begin_bit, end_bit) of the vector.
    */
   class IndexContainer {
    public:
-    explicit IndexContainer(const BitVector* bit_vector) : bit_vector_(bit_vector) { }
+    explicit IndexContainer(const BitVector* bit_vector)
+        : IndexContainer(bit_vector, 0u, bit_vector->storage_size_ * kWordBits) { }
+
+    IndexContainer(const BitVector* bit_vector, uint32_t begin_bit, uint32_t end_bit)
+        : bit_vector_(bit_vector), begin_bit_(begin_bit), end_bit_(end_bit) { }
 
     IndexIterator begin() const;
     IndexIterator end() const;
 
    private:
     const BitVector* const bit_vector_;
+    const uint32_t begin_bit_;
+    const uint32_t end_bit_;
   };
 
   // MoveConstructible but not MoveAssignable, CopyConstructible or CopyAssignable.
@@ -203,10 +212,18 @@ class BitVector {
   // Count the number of bits that are set in range [0, end).
   uint32_t NumSetBits(uint32_t end) const;
 
+  // Count the number of bits that are set in range [begin, end).
+  uint32_t NumSetBits(uint32_t begin, uint32_t end) const;
+
   IndexContainer Indexes() const {
     return IndexContainer(this);
   }
 
+  // View of the indexes of set bits in range [begin, end).
+  IndexContainer Indexes(uint32_t begin, uint32_t end) const {
+    return IndexContainer(this, begin, end);
+  }
+
   uint32_t GetStorageSize() const {
     return storage_size_;
   }
@@ -196,6 +196,71 @@ TEST(BitVector, UnionIfNotIn) {
   }
 }
 
+TEST(BitVector, IndexRange) {
+  const size_t kBits = 160;
+
+  BitVector bv(kBits, false, Allocator::GetMallocAllocator());
+  bv.SetBit(0);
+  bv.SetBit(17);
+  bv.SetBit(31);
+  bv.SetBit(32);
+  bv.SetBit(100);
+  bv.SetBit(kBits - 1);
+
+  // Empty range.
+  EXPECT_TRUE(bv.Indexes(17, 17).begin().Done());
+  EXPECT_TRUE(bv.Indexes(17, 17).begin() == bv.Indexes(17, 17).end());
+
+  // Range with no set bits.
+  EXPECT_TRUE(bv.Indexes(33, 100).begin().Done());
+
+  // Full range matches the unrestricted iteration.
+  BitVector::IndexIterator full = bv.Indexes(0, kBits).begin();
+  for (uint32_t idx : bv.Indexes()) {
+    EXPECT_FALSE(full.Done());
+    EXPECT_EQ(idx, *full);
+    ++full;
+  }
+  EXPECT_TRUE(full.Done());
+
+  // Sub-range includes begin but excludes end.
+  BitVector::IndexIterator it = bv.Indexes(17, 100).begin();
+  EXPECT_EQ(17u, *it);
+  ++it;
+  EXPECT_EQ(31u, *it);
+  ++it;
+  EXPECT_EQ(32u, *it);
+  ++it;
+  EXPECT_TRUE(it.Done());
+  EXPECT_TRUE(it == bv.Indexes(17, 100).end());
+}
+
+TEST(BitVector, NumSetBitsRange) {
+  const size_t kBits = 160;
+
+  BitVector bv(kBits, false, Allocator::GetMallocAllocator());
+  bv.SetBit(0);
+  bv.SetBit(17);
+  bv.SetBit(31);
+  bv.SetBit(32);
+  bv.SetBit(100);
+  bv.SetBit(kBits - 1);
+
+  EXPECT_EQ(0u, bv.NumSetBits(17, 17));
+  EXPECT_EQ(0u, bv.NumSetBits(1, 17));
+  EXPECT_EQ(1u, bv.NumSetBits(17, 18));  // Both ends within one word.
+  EXPECT_EQ(2u, bv.NumSetBits(17, 32));
+  EXPECT_EQ(3u, bv.NumSetBits(17, 33));
+  EXPECT_EQ(4u, bv.NumSetBits(17, 101));
+  EXPECT_EQ(5u, bv.NumSetBits(17, kBits));
+  EXPECT_EQ(bv.NumSetBits(), bv.NumSetBits(0u, kBits));
+
+  // Consistency with the single-argument overload.
+  for (uint32_t end = 0; end <= kBits; ++end) {
+    EXPECT_EQ(bv.NumSetBits(end), bv.NumSetBits(0u, end));
+  }
+}
+
 TEST(BitVector, Subset) {
   {
     BitVector first(2, true, Allocator::GetMallocAllocator());
@@ -17,6 +17,7 @@
 #include "flags.h"
 
 #include <algorithm>
+#include <tuple>
 
 #include "android-base/parsebool.h"
 #include "android-base/parseint.h"
@@ -103,7 +104,9 @@ Flag<Value>::Flag(const std::string& name, Value default_value, FlagType type) :
              GeneratePhenotypeName(name),
              type),
     initialized_{false},
-    default_{default_value} {
+    default_{default_value},
+    snapshot_value_{default_value},
+    snapshot_origin_{FlagOrigin::kDefaultValue} {
   ALL_FLAGS.push_front(this);
 }
 
@@ -117,28 +120,30 @@ void Flag<Value>::Reload() {
   initialized_ = true;
 
   // The cmdline flags are loaded by the parsed_options infra. No action needed here.
-  if (type_ == FlagType::kCmdlineOnly) {
-    return;
-  }
-
-  // Load system properties.
-  from_system_property_ = std::nullopt;
-  const std::string sysprop = ::android::base::GetProperty(system_property_name_, kUndefinedValue);
-  if (sysprop != kUndefinedValue) {
-    if (!ParseValue(sysprop, &from_system_property_)) {
-      LOG(ERROR) << "Failed to parse " << system_property_name_ << "=" << sysprop;
+  if (type_ != FlagType::kCmdlineOnly) {
+    // Load system properties.
+    from_system_property_ = std::nullopt;
+    const std::string sysprop =
+        ::android::base::GetProperty(system_property_name_, kUndefinedValue);
+    if (sysprop != kUndefinedValue) {
+      if (!ParseValue(sysprop, &from_system_property_)) {
+        LOG(ERROR) << "Failed to parse " << system_property_name_ << "=" << sysprop;
+      }
     }
-  }
 
-  // Load the server-side configuration.
-  from_server_setting_ = std::nullopt;
-  const std::string server_config =
-      ::android::base::GetProperty(server_setting_name_, kUndefinedValue);
-  if (server_config != kUndefinedValue) {
-    if (!ParseValue(server_config, &from_server_setting_)) {
-      LOG(ERROR) << "Failed to parse " << server_setting_name_ << "=" << server_config;
+    // Load the server-side configuration.
+    from_server_setting_ = std::nullopt;
+    const std::string server_config =
+        ::android::base::GetProperty(server_setting_name_, kUndefinedValue);
+    if (server_config != kUndefinedValue) {
+      if (!ParseValue(server_config, &from_server_setting_)) {
+        LOG(ERROR) << "Failed to parse " << server_setting_name_ << "=" << server_config;
+      }
     }
   }
+
+  // Refresh the snapshot served by GetValueAndOrigin().
+  std::tie(snapshot_value_, snapshot_origin_) = ResolveValueAndOrigin();
 }
 
 template <typename Value>
@@ -194,18 +194,12 @@ class Flag : public FlagBase {
   }
 
   // Returns the value and the origin of that value for the given flag.
+  //
+  // The value is resolved once per Reload() (i.e. per ReloadAllFlags() call)
+  // and served from a snapshot here, so reads do not walk the lookup chain.
   ALWAYS_INLINE std::pair<Value, FlagOrigin> GetValueAndOrigin() const {
     DCHECK(initialized_);
-    if (from_server_setting_.has_value()) {
-      return std::pair{from_server_setting_.value(), FlagOrigin::kServerSetting};
-    }
-    if (from_system_property_.has_value()) {
-      return std::pair{from_system_property_.value(), FlagOrigin::kSystemProperty};
-    }
-    if (from_command_line_.has_value()) {
-      return std::pair{from_command_line_.value(), FlagOrigin::kCmdlineArg};
-    }
-    return std::pair{default_, FlagOrigin::kDefaultValue};
+    return std::pair{snapshot_value_, snapshot_origin_};
   }
 
   void Dump(std::ostream& oss) const override;
@@ -219,12 +213,34 @@ class Flag : public FlagBase {
   void Reload() override;
 
  private:
+  // Resolve the value through the full lookup chain:
+  //   server setting > system property > cmdline arg > default value.
+  // Called by Reload() to refresh the snapshot served by GetValueAndOrigin().
+  std::pair<Value, FlagOrigin> ResolveValueAndOrigin() const {
+    if (from_server_setting_.has_value()) {
+      return std::pair{from_server_setting_.value(), FlagOrigin::kServerSetting};
+    }
+    if (from_system_property_.has_value()) {
+      return std::pair{from_system_property_.value(), FlagOrigin::kSystemProperty};
+    }
+    if (from_command_line_.has_value()) {
+      return std::pair{from_command_line_.value(), FlagOrigin::kCmdlineArg};
+    }
+    return std::pair{default_, FlagOrigin::kDefaultValue};
+  }
+
   bool initialized_;
   const Value default_;
   std::optional<Value> from_command_line_;
   std::optional<Value> from_system_property_;
   std::optional<Value> from_server_setting_;
 
+  // Snapshot of the resolved value and its origin, refreshed by Reload().
+  // Cmdline values are parsed before Runtime::Init triggers the reload, so
+  // the snapshot is never stale in the documented flag lifecycle.
+  Value snapshot_value_;
+  FlagOrigin snapshot_origin_;
+
   friend class TestFlag;
 };
 
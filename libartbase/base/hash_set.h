@@ -18,6 +18,11 @@
 #define ART_LIBARTBASE_BASE_HASH_SET_H_
 
 #include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include <functional>
 #include <iterator>
@@ -163,6 +168,11 @@ using DefaultPred = typename std::conditional<std::is_same<T, std::string>::valu
 // EmptyFn needs to implement two functions MakeEmpty(T& item) and IsEmpty(const T& item).
 // TODO: We could get rid of this requirement by using a bitmap, though maybe this would be slower
 // and more complicated.
+// Tables that own their storage additionally keep one control byte per bucket, holding either
+// an empty marker or seven bits of the element's hash. Lookups probe groups of control bytes
+// at once, so negative lookups typically touch a single cache line of metadata instead of
+// walking the slot array. Tables mapped from a serialized image and tables backed by a caller
+// provided buffer have no control bytes and fall back to probing the slots directly.
 template <class T,
           class EmptyFn = DefaultEmptyFn<T>,
           class HashFn = DefaultHashFn<T>,
@@ -228,6 +238,7 @@ class HashSet {
         elements_until_expand_(0u),
         owns_data_(false),
         data_(nullptr),
+        control_(nullptr),
         min_load_factor_(min_load_factor),
         max_load_factor_(max_load_factor) {
     DCHECK_GT(min_load_factor, 0.0);
@@ -244,12 +255,14 @@ class HashSet {
         elements_until_expand_(other.elements_until_expand_),
         owns_data_(false),
         data_(nullptr),
+        control_(nullptr),
         min_load_factor_(other.min_load_factor_),
         max_load_factor_(other.max_load_factor_) {
     AllocateStorage(other.NumBuckets());
     for (size_t i = 0; i < num_buckets_; ++i) {
       ElementForIndex(i) = other.data_[i];
     }
+    RebuildControlBytes();
   }
 
   // noexcept required so that the move constructor is used instead of copy constructor.
@@ -264,6 +277,7 @@ class HashSet {
         elements_until_expand_(other.elements_until_expand_),
         owns_data_(other.owns_data_),
         data_(other.data_),
+        control_(other.control_),
         min_load_factor_(other.min_load_factor_),
         max_load_factor_(other.max_load_factor_) {
     other.num_elements_ = 0u;
@@ -271,6 +285,7 @@ class HashSet {
     other.elements_until_expand_ = 0u;
     other.owns_data_ = false;
     other.data_ = nullptr;
+    other.control_ = nullptr;
   }
 
   // Construct with pre-existing buffer, usually stack-allocated,
@@ -292,6 +307,7 @@ class HashSet {
         elements_until_expand_(buffer_size * max_load_factor),
         owns_data_(false),
         data_(buffer),
+        control_(nullptr),
         min_load_factor_(min_load_factor),
         max_load_factor_(max_load_factor) {
     DCHECK_GT(min_load_factor, 0.0);
@@ -319,6 +335,7 @@ class HashSet {
     if (!make_copy_of_data) {
       owns_data_ = false;
       data_ = const_cast<T*>(reinterpret_cast<const T*>(ptr + offset));
+      control_ = nullptr;
       offset += sizeof(*data_) * num_buckets_;
     } else {
       AllocateStorage(num_buckets_);
@@ -327,6 +344,7 @@ class HashSet {
       for (size_t i = 0; i < num_buckets_; ++i) {
         offset = ReadFromBytes(ptr, offset, &data_[i]);
       }
+      RebuildControlBytes();
     }
     // Caller responsible for aligning.
     *read_count = offset;
@@ -423,6 +441,9 @@ class HashSet {
       // If the next element is empty, we are done. Make sure to clear the current empty index.
       if (emptyfn_.IsEmpty(next_element)) {
         emptyfn_.MakeEmpty(ElementForIndex(empty_index));
+        if (control_ != nullptr) {
+          SetControlByte(empty_index, kControlEmpty);
+        }
         break;
       }
       // Otherwise try to see if the next element can fill the current empty index.
@@ -445,6 +466,9 @@ class HashSet {
         // If the target index isn't within our current range it must have been probed from before
         // the empty index.
         ElementForIndex(empty_index) = std::move(next_element);
+        if (control_ != nullptr) {
+          SetControlByte(empty_index, control_[next_index]);
+        }
         filled = true;  // TODO: Optimize
         empty_index = next_index;
       }
@@ -514,6 +538,9 @@ class HashSet {
     size_t index = FindIndexImpl(element, hash, find_fail_fn);
     if (find_failed) {
       data_[index] = std::forward<U>(element);
+      if (control_ != nullptr) {
+        SetControlByte(index, ControlByteForHash(hash));
+      }
       ++num_elements_;
     }
     return std::make_pair(iterator(this, index), find_failed);
@@ -527,6 +554,7 @@ class HashSet {
     swap(emptyfn_, other.emptyfn_);
     swap(pred_, other.pred_);
     std::swap(data_, other.data_);
+    std::swap(control_, other.control_);
     std::swap(num_buckets_, other.num_buckets_);
     std::swap(num_elements_, other.num_elements_);
     std::swap(elements_until_expand_, other.elements_until_expand_);
@@ -634,6 +662,15 @@ class HashSet {
   }
 
  private:
+  // Number of control bytes probed at once; matches a 16 byte SIMD register.
+  static constexpr size_t kControlGroupSize = 16u;
+  // Control byte value for an empty slot. Hash fragments only use the low seven bits, so
+  // the high bit distinguishes empty control bytes from occupied ones.
+  static constexpr uint8_t kControlEmpty = 0x80u;
+
+  using ControlAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<uint8_t>;
+  using ControlAllocTraits = std::allocator_traits<ControlAlloc>;
+
   T& ElementForIndex(size_t index) {
     DCHECK_LT(index, NumBuckets());
     DCHECK(data_ != nullptr);
@@ -679,6 +716,9 @@ class HashSet {
   size_t FindIndexImpl(const K& element, size_t hash, FailFn fail_fn) const {
     DCHECK_NE(NumBuckets(), 0u);
     DCHECK_EQ(hashfn_(element), hash);
+    if (control_ != nullptr) {
+      return FindIndexWithControlBytes(element, hash, fail_fn);
+    }
     size_t index = IndexForHash(hash);
     while (true) {
       const T& slot = ElementForIndex(index);
@@ -692,6 +732,51 @@ class HashSet {
     }
   }
 
+  // Group probing version of FindIndexImpl(). Probes `kControlGroupSize` control bytes at
+  // a time; only slots whose control byte matches the hash fragment are compared and the
+  // probe sequence ends at the first empty control byte, the same slot where the plain
+  // linear probe would have ended.
+  template <typename K, typename FailFn>
+  size_t FindIndexWithControlBytes(const K& element, size_t hash, FailFn fail_fn) const {
+    DCHECK(control_ != nullptr);
+    DCHECK_GE(NumBuckets(), kControlGroupSize);
+    const uint8_t h2 = ControlByteForHash(hash);
+    size_t index = IndexForHash(hash);
+    while (true) {
+      uint32_t match_mask;
+      uint32_t empty_mask;
+      LoadControlGroup(control_ + index, h2, &match_mask, &empty_mask);
+      if (empty_mask != 0u) {
+        // Ignore matches past the first empty control byte; they belong to other probe
+        // sequences.
+        match_mask &= (1u << CTZ(empty_mask)) - 1u;
+      }
+      while (match_mask != 0u) {
+        size_t candidate = index + CTZ(match_mask);
+        if (candidate >= num_buckets_) {
+          candidate -= num_buckets_;
+        }
+        const T& slot = ElementForIndex(candidate);
+        DCHECK(!emptyfn_.IsEmpty(slot));
+        if (pred_(slot, element)) {
+          return candidate;
+        }
+        match_mask &= match_mask - 1u;  // Clear the lowest set bit.
+      }
+      if (empty_mask != 0u) {
+        size_t empty_index = index + CTZ(empty_mask);
+        if (empty_index >= num_buckets_) {
+          empty_index -= num_buckets_;
+        }
+        return fail_fn(empty_index);
+      }
+      index += kControlGroupSize;
+      if (index >= num_buckets_) {
+        index -= num_buckets_;
+      }
+    }
+  }
+
   bool IsFreeSlot(size_t index) const {
     return emptyfn_.IsEmpty(ElementForIndex(index));
   }
@@ -705,6 +790,16 @@ class HashSet {
       allocfn_.construct(allocfn_.address(data_[i]));
       emptyfn_.MakeEmpty(data_[i]);
     }
+    if (num_buckets_ >= kControlGroupSize) {
+      // One control byte per bucket plus a mirror of the first group so that unaligned
+      // group loads never read past the array when the probe sequence wraps around.
+      ControlAlloc control_alloc(allocfn_);
+      control_ = ControlAllocTraits::allocate(control_alloc, num_buckets_ + kControlGroupSize);
+      memset(control_, kControlEmpty, num_buckets_ + kControlGroupSize);
+    } else {
+      // Too few buckets for the mirrored group to stay consistent; probe the slots directly.
+      control_ = nullptr;
+    }
   }
 
   void DeallocateStorage() {
@@ -715,9 +810,14 @@ class HashSet {
       if (data_ != nullptr) {
         allocfn_.deallocate(data_, NumBuckets());
       }
+      if (control_ != nullptr) {
+        ControlAlloc control_alloc(allocfn_);
+        ControlAllocTraits::deallocate(control_alloc, control_, NumBuckets() + kControlGroupSize);
+      }
       owns_data_ = false;
     }
     data_ = nullptr;
+    control_ = nullptr;
     num_buckets_ = 0;
   }
 
@@ -735,6 +835,7 @@ class HashSet {
     }
     DCHECK_GE(new_size, size());
     T* const old_data = data_;
+    uint8_t* const old_control = control_;
     size_t old_num_buckets = num_buckets_;
     // Reinsert all of the old elements.
     const bool owned_data = owns_data_;
@@ -742,7 +843,12 @@ class HashSet {
     for (size_t i = 0; i < old_num_buckets; ++i) {
       T& element = old_data[i];
       if (!emptyfn_.IsEmpty(element)) {
-        data_[FirstAvailableSlot(IndexForHash(hashfn_(element)))] = std::move(element);
+        const size_t element_hash = hashfn_(element);
+        const size_t new_index = FirstAvailableSlot(IndexForHash(element_hash));
+        data_[new_index] = std::move(element);
+        if (control_ != nullptr) {
+          SetControlByte(new_index, ControlByteForHash(element_hash));
+        }
       }
       if (owned_data) {
         allocfn_.destroy(allocfn_.address(element));
@@ -750,6 +856,11 @@ class HashSet {
     }
     if (owned_data) {
       allocfn_.deallocate(old_data, old_num_buckets);
+      if (old_control != nullptr) {
+        ControlAlloc control_alloc(allocfn_);
+        ControlAllocTraits::deallocate(
+            control_alloc, old_control, old_num_buckets + kControlGroupSize);
+      }
     }
 
     // When we hit elements_until_expand_, we are at the max load factor and must expand again.
@@ -776,6 +887,76 @@ class HashSet {
     return index;
   }
 
+  static uint8_t ControlByteForHash(size_t hash) {
+    return static_cast<uint8_t>(hash & 0x7fu);
+  }
+
+  // Store a control byte, mirroring the first group past the end of the array so that
+  // group loads which wrap around the table see consistent data.
+  void SetControlByte(size_t index, uint8_t value) {
+    DCHECK(control_ != nullptr);
+    DCHECK_LT(index, NumBuckets());
+    control_[index] = value;
+    if (index < kControlGroupSize) {
+      control_[num_buckets_ + index] = value;
+    }
+  }
+
+  // Recompute all control bytes from the slot array. Used when slots were filled directly
+  // instead of through InsertWithHash(), i.e. when copying or deserializing a table.
+  void RebuildControlBytes() {
+    if (control_ == nullptr) {
+      return;
+    }
+    memset(control_, kControlEmpty, num_buckets_ + kControlGroupSize);
+    for (size_t i = 0; i < num_buckets_; ++i) {
+      if (!emptyfn_.IsEmpty(data_[i])) {
+        SetControlByte(i, ControlByteForHash(hashfn_(data_[i])));
+      }
+    }
+  }
+
+  // Load `kControlGroupSize` control bytes starting at `control` and compute bit masks
+  // (bit i corresponds to control[i]) of the bytes equal to `h2` and of the empty bytes.
+  // The empty mask is exact; the match mask may rarely contain a false positive, which
+  // only costs an extra comparison against a non-empty slot.
+  ALWAYS_INLINE void LoadControlGroup(const uint8_t* control,
+                                      uint8_t h2,
+                                      /*out*/ uint32_t* match_mask,
+                                      /*out*/ uint32_t* empty_mask) const {
+#if defined(__SSE2__)
+    const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+    const __m128i match = _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(h2)));
+    *match_mask = static_cast<uint32_t>(_mm_movemask_epi8(match));
+    // Only kControlEmpty has the high bit set, so the sign mask is exactly the empty mask.
+    *empty_mask = static_cast<uint32_t>(_mm_movemask_epi8(group));
+#else
+    uint64_t words[2];
+    memcpy(words, control, sizeof(words));
+    const uint64_t dup = h2 * UINT64_C(0x0101010101010101);
+    uint32_t match = 0u;
+    uint32_t empty = 0u;
+    for (size_t i = 0; i != 2u; ++i) {
+      // SWAR byte equality: lanes equal to `h2` end up with their high bit set. Borrow
+      // propagation can also set the high bit of a lane directly above a matching lane,
+      // hence the false positives mentioned above.
+      const uint64_t x = words[i] ^ dup;
+      const uint64_t eq = (x - UINT64_C(0x0101010101010101)) & ~x & UINT64_C(0x8080808080808080);
+      match |= CompressHighBits(eq) << (i * 8u);
+      empty |= CompressHighBits(words[i] & UINT64_C(0x8080808080808080)) << (i * 8u);
+    }
+    *match_mask = match;
+    *empty_mask = empty;
+#endif
+  }
+
+#if !defined(__SSE2__)
+  // Compress the high bits of the eight lanes of `lane_mask` into the low eight bits.
+  static ALWAYS_INLINE uint32_t CompressHighBits(uint64_t lane_mask) {
+    return static_cast<uint32_t>((lane_mask * UINT64_C(0x0002040810204081)) >> 56);
+  }
+#endif
+
   // Return new offset.
   template <typename Elem>
   static size_t WriteToBytes(uint8_t* ptr, size_t offset, Elem n) {
@@ -803,6 +984,9 @@ class HashSet {
   size_t elements_until_expand_;  // Maximum number of elements until we expand the table.
   bool owns_data_;  // If we own data_ and are responsible for freeing it.
   T* data_;  // Backing storage.
+  // One control byte per bucket plus a mirror of the first group, or null when the storage
+  // is not owned (serialized tables, caller provided buffers) or too small for group probes.
+  uint8_t* control_;
   double min_load_factor_;
   double max_load_factor_;
 
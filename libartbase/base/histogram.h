@@ -80,6 +80,14 @@ template <class Value> class Histogram {
     return sum_ * kAdjust;
   }
 
+  Value AdjustedMin() const {
+    return min_value_added_ * kAdjust;
+  }
+
+  Value AdjustedMax() const {
+    return max_value_added_ * kAdjust;
+  }
+
   Value Min() const {
     return min_value_added_;
   }
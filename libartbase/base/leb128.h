@@ -17,6 +17,9 @@
 #ifndef ART_LIBARTBASE_BASE_LEB128_H_
 #define ART_LIBARTBASE_BASE_LEB128_H_
 
+#include <string.h>
+
+#include <algorithm>
 #include <vector>
 
 #include <android-base/logging.h>
@@ -59,6 +62,52 @@ static inline uint32_t DecodeUnsignedLeb128WithoutMovingCursor(const uint8_t* da
   return DecodeUnsignedLeb128(&data);
 }
 
+// Decodes `kCount` consecutive unsigned LEB128 values, updating the given pointer
+// to point just past the end of the last value. While at least eight encoded bytes
+// remain before `end`, the decoder loads them at once and extracts runs of
+// single-byte values - by far the most common encoding in dex files - without a
+// branch per value; multi-byte values and the tail of the buffer are decoded with
+// DecodeUnsignedLeb128(). Like DecodeUnsignedLeb128(), this trusts the input to
+// contain `kCount` well-formed values before `end`.
+template <size_t kCount>
+static inline void DecodeUnsignedLeb128Batch(const uint8_t** data,
+                                             const uint8_t* end,
+                                             uint32_t (&out)[kCount]) {
+  static_assert(kCount != 0u, "Must decode at least one value");
+  const uint8_t* ptr = *data;
+  size_t i = 0;
+  while (i != kCount) {
+    if (UNLIKELY(end - ptr < static_cast<ptrdiff_t>(sizeof(uint64_t)))) {
+      // Too close to the end of the buffer for a word-sized load; decode the
+      // remaining values one at a time.
+      do {
+        out[i++] = DecodeUnsignedLeb128(&ptr);
+      } while (i != kCount);
+      break;
+    }
+    // Note: Dex files are little-endian, as are all supported architectures.
+    uint64_t chunk;
+    memcpy(&chunk, ptr, sizeof(chunk));
+    // Bytes with the continuation (high) bit clear each terminate a value, so the
+    // bytes before the first continuation bit form a run of single-byte values.
+    const uint64_t continuation_bits = chunk & UINT64_C(0x8080808080808080);
+    const size_t single_byte_run = (continuation_bits != 0u)
+        ? static_cast<size_t>(CTZ(continuation_bits)) / kBitsPerByte
+        : sizeof(uint64_t);
+    const size_t run = std::min(single_byte_run, kCount - i);
+    for (size_t j = 0; j != run; ++j) {
+      out[i + j] = static_cast<uint32_t>((chunk >> (j * kBitsPerByte)) & 0x7fu);
+    }
+    i += run;
+    ptr += run;
+    if (i != kCount && run == single_byte_run && single_byte_run != sizeof(uint64_t)) {
+      // The next value starts with a continuation bit.
+      out[i++] = DecodeUnsignedLeb128(&ptr);
+    }
+  }
+  *data = ptr;
+}
+
 static inline bool DecodeUnsignedLeb128Checked(const uint8_t** data,
                                                const void* end,
                                                uint32_t* out) {
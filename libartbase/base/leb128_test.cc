@@ -172,6 +172,42 @@ TEST(Leb128Test, UnsignedStream) {
   EXPECT_EQ(data_size, static_cast<size_t>(encoded_data_ptr - encoded_data));
 }
 
+TEST(Leb128Test, UnsignedBatch) {
+  // Encode a number of entries.
+  uint8_t encoded_data[5 * arraysize(uleb128_tests)];
+  uint8_t* end = encoded_data;
+  for (size_t i = 0; i < arraysize(uleb128_tests); ++i) {
+    end = EncodeUnsignedLeb128(end, uleb128_tests[i].decoded);
+  }
+  // Decode all of them with a single batch call.
+  const uint8_t* encoded_data_ptr = encoded_data;
+  uint32_t decoded[arraysize(uleb128_tests)];
+  DecodeUnsignedLeb128Batch(&encoded_data_ptr, end, decoded);
+  for (size_t i = 0; i < arraysize(uleb128_tests); ++i) {
+    EXPECT_EQ(decoded[i], uleb128_tests[i].decoded) << " i = " << i;
+  }
+  EXPECT_EQ(end, encoded_data_ptr);
+}
+
+TEST(Leb128Test, UnsignedBatchSingleByteRuns) {
+  // Runs of single-byte values exercise the word-sized fast path; starting close
+  // to `end` exercises the scalar fall-back.
+  uint8_t encoded_data[64];
+  for (size_t i = 0; i < arraysize(encoded_data); ++i) {
+    encoded_data[i] = static_cast<uint8_t>(i & 0x7f);
+  }
+  const uint8_t* const end = encoded_data + arraysize(encoded_data);
+  for (size_t start = 0; start + 3 <= arraysize(encoded_data); ++start) {
+    const uint8_t* ptr = encoded_data + start;
+    uint32_t decoded[3];
+    DecodeUnsignedLeb128Batch(&ptr, end, decoded);
+    for (size_t i = 0; i < arraysize(decoded); ++i) {
+      EXPECT_EQ(decoded[i], start + i) << " start = " << start << " i = " << i;
+    }
+    EXPECT_EQ(ptr, encoded_data + start + 3) << " start = " << start;
+  }
+}
+
 TEST(Leb128Test, SignedSinglesVector) {
   // Test individual encodings.
   for (size_t i = 0; i < arraysize(sleb128_tests); ++i) {
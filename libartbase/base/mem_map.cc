@@ -833,6 +833,24 @@ void MemMap::MadviseDontNeedAndZero() {
   }
 }
 
+void MemMap::MadviseWillNeed(size_t offset, size_t length) {
+  DCHECK_LE(offset, size_);
+  DCHECK_LE(length, size_ - offset);
+  if (length == 0u) {
+    return;
+  }
+#ifndef _WIN32
+  // Expand to page boundaries; madvise requires a page-aligned address and the
+  // base mapping is page-aligned, so this cannot leave the mapping.
+  uint8_t* const page_begin = AlignDown(begin_ + offset, kPageSize);
+  uint8_t* const page_end = AlignUp(begin_ + offset + length, kPageSize);
+  int result = madvise(page_begin, page_end - page_begin, MADV_WILLNEED);
+  if (result == -1) {
+    PLOG(WARNING) << "madvise failed";
+  }
+#endif
+}
+
 int MemMap::MadviseDontFork() {
 #if defined(__linux__)
   if (base_begin_ != nullptr || base_size_ != 0) {
@@ -233,6 +233,11 @@ class MemMap {
   void MadviseDontNeedAndZero();
   int MadviseDontFork();
 
+  // Hint the kernel to read ahead the given sub-range of the mapping. This is
+  // useful for file-backed mappings where the pages would otherwise be faulted
+  // in one by one on first access. Benign no-op on platforms without madvise.
+  void MadviseWillNeed(size_t offset, size_t length);
+
   int GetProtect() const {
     return prot_;
   }
@@ -50,6 +50,8 @@
   METRIC(FullGcTracingThroughputAvg, MetricsAverage)                    \
   METRIC(JitMethodCompileTotalTime, MetricsCounter)                     \
   METRIC(JitMethodCompileCount, MetricsCounter)                         \
+  METRIC(ProcessSpawnTotalTime, MetricsCounter)                         \
+  METRIC(ProcessSpawnCount, MetricsCounter)                             \
   METRIC(YoungGcCollectionTime, MetricsHistogram, 15, 0, 60'000)        \
   METRIC(FullGcCollectionTime, MetricsHistogram, 15, 0, 60'000)         \
   METRIC(YoungGcThroughput, MetricsHistogram, 15, 0, 10'000)            \
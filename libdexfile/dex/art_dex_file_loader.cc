@@ -427,6 +427,20 @@ std::unique_ptr<const DexFile> ArtDexFileLoader::OpenOneDexFileFromZip(
         LOG(WARNING) << "Can't mmap dex file " << location << "!" << entry_name << " directly; "
                      << "is your ZIP file corrupted? Falling back to extraction.";
         // Try again with Extraction which still has a chance of recovery.
+      } else if (map.Size() >= sizeof(DexFile::Header)) {
+        // The mapping is file-backed and faulted in from the APK on demand.
+        // Hint the regions touched on virtually every open - the header and
+        // the string ids table - so that the kernel reads them ahead in bulk.
+        map.MadviseWillNeed(/*offset=*/ 0u, sizeof(DexFile::Header));
+        const DexFile::Header* header = reinterpret_cast<const DexFile::Header*>(map.Begin());
+        uint32_t string_ids_off = header->string_ids_off_;
+        uint32_t string_ids_size = header->string_ids_size_;
+        // The header has not been verified yet, so validate the bounds before
+        // passing them to the kernel.
+        if (string_ids_off <= map.Size() &&
+            string_ids_size <= (map.Size() - string_ids_off) / sizeof(dex::StringId)) {
+          map.MadviseWillNeed(string_ids_off, string_ids_size * sizeof(dex::StringId));
+        }
       }
     }
   }
@@ -237,6 +237,7 @@ template <typename Visitor>
 inline bool CodeItemDebugInfoAccessor::DecodeDebugPositionInfo(const Visitor& visitor) const {
   return dex_file_->DecodeDebugPositionInfo(
       dex_file_->GetDebugInfoStream(DebugInfoOffset()),
+      dex_file_->DataBegin() + dex_file_->DataSize(),
       [this](uint32_t idx) {
         return dex_file_->StringDataByIdx(dex::StringIndex(idx));
       },
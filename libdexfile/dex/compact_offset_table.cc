@@ -60,6 +60,41 @@ uint32_t CompactOffsetTable::Accessor::GetOffset(uint32_t index) const {
   return current_offset;
 }
 
+void CompactOffsetTable::Accessor::GetOffsets(const uint32_t* indices,
+                                              size_t count,
+                                              uint32_t* out_offsets) const {
+  size_t i = 0;
+  while (i != count) {
+    const uint32_t block_index = indices[i] / kElementsPerIndex;
+    const uint8_t* block = data_begin_ + table_[block_index];
+    uint16_t bit_mask = *block;
+    ++block;
+    bit_mask = (bit_mask << kBitsPerByte) | *block;
+    ++block;
+    // Decode the block's lebs at most once, resuming where the previous index
+    // in the same block left off.
+    uint32_t current_offset = minimum_offset_;
+    size_t next_bit = 0;
+    do {
+      DCHECK(i == 0 || indices[i - 1] <= indices[i]) << "indices must be sorted";
+      const size_t bit_index = indices[i] % kElementsPerIndex;
+      if ((bit_mask & (1 << bit_index)) == 0) {
+        // Bit is not set means the offset is 0.
+        out_offsets[i] = 0u;
+      } else {
+        for (size_t bit = next_bit; bit <= bit_index; ++bit) {
+          if ((bit_mask & (1 << bit)) != 0) {
+            current_offset += DecodeUnsignedLeb128(&block);
+          }
+        }
+        next_bit = bit_index + 1u;
+        out_offsets[i] = current_offset;
+      }
+      ++i;
+    } while (i != count && indices[i] / kElementsPerIndex == block_index);
+  }
+}
+
 void CompactOffsetTable::Build(const std::vector<uint32_t>& offsets,
                                std::vector<uint8_t>* out_data) {
   static constexpr size_t kNumOffsets = 2;
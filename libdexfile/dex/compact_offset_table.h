@@ -45,6 +45,13 @@ class CompactOffsetTable {
     // Return the offset for the index.
     uint32_t GetOffset(uint32_t index) const;
 
+    // Return the offsets for `count` indices, which must be sorted in
+    // ascending order. Indices that fall into the same leb block share the
+    // bit mask read and the leb prefix decode, so clustered batch queries
+    // (e.g. the methods of one class in a stack trace) decode each block
+    // once instead of once per index.
+    void GetOffsets(const uint32_t* indices, size_t count, uint32_t* out_offsets) const;
+
    private:
     const uint32_t* const table_;
     const uint32_t minimum_offset_;
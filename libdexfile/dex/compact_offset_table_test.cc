@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <numeric>
 #include <vector>
 
 #include <android-base/logging.h>
@@ -83,6 +84,23 @@ TEST(CompactOffsetTableTest, TestBuildAndAccess) {
     for (size_t i = 0; i < offsets.size(); ++i) {
       EXPECT_EQ(offsets[i], accessor2.GetOffset(i));
     }
+
+    // The batched lookup must agree with the single-index lookup for sorted
+    // queries, including duplicates and indices whose offset is 0.
+    std::vector<uint32_t> indices = {0, 1, 1, 4, 5, 15, 16, 17, 30, 31, 32,
+                                     static_cast<uint32_t>(offsets.size() - 1)};
+    std::vector<uint32_t> batched(indices.size());
+    accessor2.GetOffsets(indices.data(), indices.size(), batched.data());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      EXPECT_EQ(offsets[indices[i]], batched[i]) << "index " << indices[i];
+    }
+
+    // All indices at once.
+    std::vector<uint32_t> all_indices(offsets.size());
+    std::iota(all_indices.begin(), all_indices.end(), 0u);
+    std::vector<uint32_t> all_offsets(offsets.size());
+    accessor2.GetOffsets(all_indices.data(), all_indices.size(), all_offsets.data());
+    EXPECT_EQ(offsets, all_offsets);
   }
 }
 
@@ -375,6 +375,7 @@ bool DexFile::DecodeDebugLocalInfo(uint32_t registers_size,
 
 template<typename DexDebugNewPosition, typename IndexToStringData>
 bool DexFile::DecodeDebugPositionInfo(const uint8_t* stream,
+                                      const uint8_t* stream_end,
                                       const IndexToStringData& index_to_string_data,
                                       const DexDebugNewPosition& position_functor) {
   if (stream == nullptr) {
@@ -395,17 +396,16 @@ bool DexFile::DecodeDebugPositionInfo(const uint8_t* stream,
       case DBG_ADVANCE_LINE:
         entry.line_ += DecodeSignedLeb128(&stream);
         break;
-      case DBG_START_LOCAL:
-        DecodeUnsignedLeb128(&stream);  // reg.
-        DecodeUnsignedLeb128P1(&stream);  // name.
-        DecodeUnsignedLeb128P1(&stream);  // descriptor.
+      case DBG_START_LOCAL: {
+        uint32_t skipped[3];  // reg, name, descriptor.
+        DecodeUnsignedLeb128Batch(&stream, stream_end, skipped);
         break;
-      case DBG_START_LOCAL_EXTENDED:
-        DecodeUnsignedLeb128(&stream);  // reg.
-        DecodeUnsignedLeb128P1(&stream);  // name.
-        DecodeUnsignedLeb128P1(&stream);  // descriptor.
-        DecodeUnsignedLeb128P1(&stream);  // signature.
+      }
+      case DBG_START_LOCAL_EXTENDED: {
+        uint32_t skipped[4];  // reg, name, descriptor, signature.
+        DecodeUnsignedLeb128Batch(&stream, stream_end, skipped);
         break;
+      }
       case DBG_END_LOCAL:
       case DBG_RESTART_LOCAL:
         DecodeUnsignedLeb128(&stream);  // reg.
@@ -690,8 +690,11 @@ class DexFile {
                             const NewLocalCallback& new_local) const;
 
   // Returns false if there is no debugging information or if it cannot be decoded.
+  // `stream_end` bounds the encoded data, e.g. the end of the data section; it is
+  // used to decode runs of LEB128 values at once, not to validate the stream.
   template<typename DexDebugNewPosition, typename IndexToStringData>
   static bool DecodeDebugPositionInfo(const uint8_t* stream,
+                                      const uint8_t* stream_end,
                                       const IndexToStringData& index_to_string_data,
                                       const DexDebugNewPosition& position_functor);
 
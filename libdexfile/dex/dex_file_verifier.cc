@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <bitset>
+#include <cstring>
 #include <limits>
 #include <memory>
 
@@ -1643,6 +1644,29 @@ bool DexFileVerifier::CheckIntraStringDataItem() {
 
   for (uint32_t i = 0; i < size; i++) {
     CHECK_LT(i, size);  // b/15014252 Prevents hitting the impossible case below
+
+    // Fast path: validate a whole word of ASCII characters at a time. Every code unit in
+    // the range [0x01, 0x7f] is encoded as a single byte with the high bit clear, so a
+    // word without zero bytes and without high bits covers sizeof(uint64_t) code units.
+    // The subtraction turns a zero byte into a byte with the high bit set; bytes that
+    // are already above 0x7f trip the check directly. Borrow propagation can only cause
+    // a spurious fall through to the byte-wise checks below.
+    static constexpr size_t kWordSize = sizeof(uint64_t);
+    static constexpr uint64_t kHighBits = 0x8080808080808080u;
+    static constexpr uint64_t kLowBits = 0x0101010101010101u;
+    while (i + kWordSize <= size && ptr_ + kWordSize <= file_end) {
+      uint64_t word;
+      memcpy(&word, ptr_, kWordSize);
+      if (((word | (word - kLowBits)) & kHighBits) != 0u) {
+        break;
+      }
+      ptr_ += kWordSize;
+      i += kWordSize;
+    }
+    if (i == size) {
+      break;
+    }
+
     if (UNLIKELY(ptr_ >= file_end)) {
       ErrorStringPrintf("String data would go beyond end-of-file");
       return false;
@@ -16,6 +16,12 @@
 
 #include "utf.h"
 
+#if defined(__aarch64__) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
 #include <android-base/strings.h>
@@ -27,6 +33,110 @@ namespace art {
 
 using android::base::StringAppendF;
 
+namespace {
+
+// Returns the length of the leading run of ASCII bytes (high bit clear) in
+// `[utf8, utf8 + byte_count)`. Strings handed to the conversion routines are
+// overwhelmingly ASCII, so this is vectorized where SIMD is available and the
+// scalar decoding loops only run from the first non-ASCII byte onwards.
+inline size_t CountLeadingAsciiBytes(const char* utf8, size_t byte_count) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(utf8);
+  size_t i = 0;
+#if defined(__aarch64__) || defined(__ARM_NEON__)
+  for (; i + 16 <= byte_count; i += 16) {
+    const uint8x16_t chunk = vld1q_u8(p + i);
+#if defined(__aarch64__)
+    if (vmaxvq_u8(chunk) >= 0x80u) {
+      break;
+    }
+#else
+    const uint8x8_t high_bits = vorr_u8(vget_low_u8(chunk), vget_high_u8(chunk));
+    if ((vget_lane_u64(vreinterpret_u64_u8(high_bits), 0) & UINT64_C(0x8080808080808080)) != 0u) {
+      break;
+    }
+#endif
+  }
+#elif defined(__SSE2__)
+  for (; i + 16 <= byte_count; i += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+    if (_mm_movemask_epi8(chunk) != 0) {
+      break;
+    }
+  }
+#endif
+  for (; i != byte_count && p[i] < 0x80u; ++i) {}
+  return i;
+}
+
+// Returns the length of the leading run of UTF-16 characters in `[utf16, utf16 + char_count)`
+// that encode as a single modified UTF-8 byte, i.e. are in [0x01, 0x7f].
+inline size_t CountLeadingAsciiChars(const uint16_t* utf16, size_t char_count) {
+  size_t i = 0;
+#if defined(__aarch64__)
+  for (; i + 8 <= char_count; i += 8) {
+    // `ch - 1 <= 0x7e` (unsigned) is equivalent to `1 <= ch && ch <= 0x7f`.
+    const uint16x8_t chunk = vsubq_u16(vld1q_u16(utf16 + i), vdupq_n_u16(1u));
+    if (vmaxvq_u16(chunk) > 0x7eu) {
+      break;
+    }
+  }
+#elif defined(__SSE2__)
+  for (; i + 8 <= char_count; i += 8) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16 + i));
+    // `ch - 1 <= 0x7e` (unsigned) is equivalent to `1 <= ch && ch <= 0x7f`. SSE2 only has
+    // signed 16-bit comparisons, so bias both sides by 0x8000.
+    const __m128i biased = _mm_sub_epi16(chunk, _mm_set1_epi16(0x8001));
+    const __m128i too_big = _mm_cmpgt_epi16(biased, _mm_set1_epi16(0x7e - 0x8000));
+    if (_mm_movemask_epi8(too_big) != 0) {
+      break;
+    }
+  }
+#endif
+  for (; i != char_count && utf16[i] - 1u < 0x7fu; ++i) {}
+  return i;
+}
+
+// Zero-extends `count` ASCII bytes to UTF-16 characters.
+inline void ConvertAsciiToUtf16(uint16_t* utf16_out, const char* utf8_in, size_t count) {
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(utf8_in);
+  size_t i = 0;
+#if defined(__aarch64__) || defined(__ARM_NEON__)
+  for (; i + 8 <= count; i += 8) {
+    vst1q_u16(utf16_out + i, vmovl_u8(vld1_u8(in + i)));
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= count; i += 8) {
+    const __m128i chunk = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(utf16_out + i), _mm_unpacklo_epi8(chunk, zero));
+  }
+#endif
+  for (; i != count; ++i) {
+    utf16_out[i] = in[i];
+  }
+}
+
+// Narrows `count` UTF-16 characters, all known to be in [0x01, 0x7f], to ASCII bytes.
+inline void ConvertAsciiToModifiedUtf8(char* utf8_out, const uint16_t* utf16_in, size_t count) {
+  uint8_t* out = reinterpret_cast<uint8_t*>(utf8_out);
+  size_t i = 0;
+#if defined(__aarch64__) || defined(__ARM_NEON__)
+  for (; i + 8 <= count; i += 8) {
+    vst1_u8(out + i, vmovn_u16(vld1q_u16(utf16_in + i)));
+  }
+#elif defined(__SSE2__)
+  for (; i + 8 <= count; i += 8) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16_in + i));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(chunk, chunk));
+  }
+#endif
+  for (; i != count; ++i) {
+    out[i] = dchecked_integral_cast<uint8_t>(utf16_in[i]);
+  }
+}
+
+}  // namespace
+
 // This is used only from debugger and test code.
 size_t CountModifiedUtf8Chars(const char* utf8) {
   return CountModifiedUtf8Chars(utf8, strlen(utf8));
@@ -51,15 +161,18 @@ size_t CountModifiedUtf8Chars(const char* utf8, size_t byte_count) {
   DCHECK_LE(byte_count, strlen(utf8));
   size_t len = 0;
   const char* end = utf8 + byte_count;
-  for (; utf8 < end; ++utf8) {
-    int ic = *utf8;
-    len++;
-    if (LIKELY((ic & 0x80) == 0)) {
-      // One-byte encoding.
-      continue;
+  while (utf8 < end) {
+    // Bulk-count leading one-byte encodings; each is a single UTF-16 character.
+    const size_t ascii_bytes = CountLeadingAsciiBytes(utf8, end - utf8);
+    utf8 += ascii_bytes;
+    len += ascii_bytes;
+    if (utf8 == end) {
+      break;
     }
+    const int ic = *utf8;
+    len++;
     // Two- or three-byte encoding.
-    utf8++;
+    utf8 += 2;
     if ((ic & 0x20) == 0) {
       // Two-byte encoding.
       continue;
@@ -100,16 +213,20 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, size_t out_chars,
 
   if (LIKELY(out_chars == in_bytes)) {
     // Common case where all characters are ASCII.
-    for (const char *p = in_start; p < in_end;) {
-      // Safe even if char is signed because ASCII characters always have
-      // the high bit cleared.
-      *out_p++ = dchecked_integral_cast<uint16_t>(*p++);
-    }
+    ConvertAsciiToUtf16(out_p, in_start, in_bytes);
     return;
   }
 
-  // String contains non-ASCII characters.
+  // String contains non-ASCII characters. Bulk-convert ASCII runs and decode the
+  // multi-byte sequences in between one at a time.
   for (const char *p = in_start; p < in_end;) {
+    const size_t ascii_bytes = CountLeadingAsciiBytes(p, in_end - p);
+    ConvertAsciiToUtf16(out_p, p, ascii_bytes);
+    p += ascii_bytes;
+    out_p += ascii_bytes;
+    if (p == in_end) {
+      break;
+    }
     const uint32_t ch = GetUtf16FromUtf8(&p);
     const uint16_t leading = GetLeadingUtf16Char(ch);
     const uint16_t trailing = GetTrailingUtf16Char(ch);
@@ -125,52 +242,57 @@ void ConvertUtf16ToModifiedUtf8(char* utf8_out, size_t byte_count,
                                 const uint16_t* utf16_in, size_t char_count) {
   if (LIKELY(byte_count == char_count)) {
     // Common case where all characters are ASCII.
-    const uint16_t *utf16_end = utf16_in + char_count;
-    for (const uint16_t *p = utf16_in; p < utf16_end;) {
-      *utf8_out++ = dchecked_integral_cast<char>(*p++);
-    }
+    ConvertAsciiToModifiedUtf8(utf8_out, utf16_in, char_count);
     return;
   }
 
-  // String contains non-ASCII characters.
-  while (char_count--) {
+  // String contains non-ASCII characters. Bulk-convert ASCII runs and encode the
+  // remaining characters one at a time.
+  while (char_count != 0u) {
+    const size_t ascii_chars = CountLeadingAsciiChars(utf16_in, char_count);
+    ConvertAsciiToModifiedUtf8(utf8_out, utf16_in, ascii_chars);
+    utf16_in += ascii_chars;
+    utf8_out += ascii_chars;
+    char_count -= ascii_chars;
+    if (char_count == 0u) {
+      break;
+    }
+    char_count--;
+    // CountLeadingAsciiChars() guarantees that `ch` is not a one-byte encoding.
     const uint16_t ch = *utf16_in++;
-    if (ch > 0 && ch <= 0x7f) {
-      *utf8_out++ = ch;
-    } else {
-      // Char_count == 0 here implies we've encountered an unpaired
-      // surrogate and we have no choice but to encode it as 3-byte UTF
-      // sequence. Note that unpaired surrogates can occur as a part of
-      // "normal" operation.
-      if ((ch >= 0xd800 && ch <= 0xdbff) && (char_count > 0)) {
-        const uint16_t ch2 = *utf16_in;
-
-        // Check if the other half of the pair is within the expected
-        // range. If it isn't, we will have to emit both "halves" as
-        // separate 3 byte sequences.
-        if (ch2 >= 0xdc00 && ch2 <= 0xdfff) {
-          utf16_in++;
-          char_count--;
-          const uint32_t code_point = (ch << 10) + ch2 - 0x035fdc00;
-          *utf8_out++ = (code_point >> 18) | 0xf0;
-          *utf8_out++ = ((code_point >> 12) & 0x3f) | 0x80;
-          *utf8_out++ = ((code_point >> 6) & 0x3f) | 0x80;
-          *utf8_out++ = (code_point & 0x3f) | 0x80;
-          continue;
-        }
-      }
 
-      if (ch > 0x07ff) {
-        // Three byte encoding.
-        *utf8_out++ = (ch >> 12) | 0xe0;
-        *utf8_out++ = ((ch >> 6) & 0x3f) | 0x80;
-        *utf8_out++ = (ch & 0x3f) | 0x80;
-      } else /*(ch > 0x7f || ch == 0)*/ {
-        // Two byte encoding.
-        *utf8_out++ = (ch >> 6) | 0xc0;
-        *utf8_out++ = (ch & 0x3f) | 0x80;
+    // Char_count == 0 here implies we've encountered an unpaired
+    // surrogate and we have no choice but to encode it as 3-byte UTF
+    // sequence. Note that unpaired surrogates can occur as a part of
+    // "normal" operation.
+    if ((ch >= 0xd800 && ch <= 0xdbff) && (char_count > 0)) {
+      const uint16_t ch2 = *utf16_in;
+
+      // Check if the other half of the pair is within the expected
+      // range. If it isn't, we will have to emit both "halves" as
+      // separate 3 byte sequences.
+      if (ch2 >= 0xdc00 && ch2 <= 0xdfff) {
+        utf16_in++;
+        char_count--;
+        const uint32_t code_point = (ch << 10) + ch2 - 0x035fdc00;
+        *utf8_out++ = (code_point >> 18) | 0xf0;
+        *utf8_out++ = ((code_point >> 12) & 0x3f) | 0x80;
+        *utf8_out++ = ((code_point >> 6) & 0x3f) | 0x80;
+        *utf8_out++ = (code_point & 0x3f) | 0x80;
+        continue;
       }
     }
+
+    if (ch > 0x07ff) {
+      // Three byte encoding.
+      *utf8_out++ = (ch >> 12) | 0xe0;
+      *utf8_out++ = ((ch >> 6) & 0x3f) | 0x80;
+      *utf8_out++ = (ch & 0x3f) | 0x80;
+    } else /*(ch > 0x7f || ch == 0)*/ {
+      // Two byte encoding.
+      *utf8_out++ = (ch >> 6) | 0xc0;
+      *utf8_out++ = (ch & 0x3f) | 0x80;
+    }
   }
 }
 
@@ -240,11 +362,15 @@ size_t CountUtf8Bytes(const uint16_t* chars, size_t char_count) {
   size_t result = 0;
   const uint16_t *end = chars + char_count;
   while (chars < end) {
-    const uint16_t ch = *chars++;
-    if (LIKELY(ch != 0 && ch < 0x80)) {
-      result++;
-      continue;
+    // Bulk-count leading characters with one-byte encodings.
+    const size_t ascii_chars = CountLeadingAsciiChars(chars, end - chars);
+    chars += ascii_chars;
+    result += ascii_chars;
+    if (chars == end) {
+      break;
     }
+    const uint16_t ch = *chars++;
+    DCHECK(ch == 0 || ch >= 0x80);
     if (ch < 0x800) {
       result += 2;
       continue;
@@ -147,6 +147,11 @@ static const NativeBridgeRuntimeCallbacks* runtime_callbacks = nullptr;
 // The app's code cache directory.
 static char* app_code_cache_dir = nullptr;
 
+// The filename of the native bridge library. Recorded by LoadNativeBridge; the library itself is
+// only opened on first use, so that processes which never run translated code do not pay for a
+// library load during runtime bring-up.
+static char* native_bridge_filename = nullptr;
+
 // Code cache directory (relative to the application private directory)
 // Ideally we'd like to call into framework to retrieve this name. However that's considered an
 // implementation detail and will require either hacks or consistent refactorings. We compromise
@@ -171,6 +176,13 @@ static void ReleaseAppCodeCacheDir() {
   }
 }
 
+static void ReleaseNativeBridgeFilename() {
+  if (native_bridge_filename != nullptr) {
+    delete[] native_bridge_filename;
+    native_bridge_filename = nullptr;
+  }
+}
+
 // We only allow simple names for the library. It is supposed to be a file in
 // /system/lib or /vendor/lib. Only allow a small range of characters, that is
 // names consisting of [a-zA-Z0-9._-] and starting with [a-zA-Z].
@@ -224,6 +236,56 @@ static void CloseNativeBridge(bool with_error) {
   state = NativeBridgeState::kClosed;
   had_error |= with_error;
   ReleaseAppCodeCacheDir();
+  ReleaseNativeBridgeFilename();
+}
+
+// Performs the library load deferred by LoadNativeBridge. Returns true if the bridge callbacks
+// are available afterwards; on failure the native bridge is closed with an error.
+static bool EnsureNativeBridgeLoaded() {
+  if (callbacks != nullptr) {
+    return true;
+  }
+  if (native_bridge_filename == nullptr) {
+    return false;
+  }
+
+  // Try to open the library. We assume this library is provided by the
+  // platform rather than the ART APEX itself, so use the system namespace
+  // to avoid requiring a static linker config link to it from the
+  // com_android_art namespace.
+  void* handle = OpenSystemLibrary(native_bridge_filename, RTLD_LAZY);
+
+  if (handle != nullptr) {
+    callbacks = reinterpret_cast<NativeBridgeCallbacks*>(dlsym(handle,
+                                                               kNativeBridgeInterfaceSymbol));
+    if (callbacks != nullptr) {
+      if (isCompatibleWith(NAMESPACE_VERSION)) {
+        // Store the handle for later.
+        native_bridge_handle = handle;
+      } else {
+        ALOGW("Unsupported native bridge API in %s (is version %d not compatible with %d)",
+              native_bridge_filename, callbacks->version, NAMESPACE_VERSION);
+        callbacks = nullptr;
+        dlclose(handle);
+      }
+    } else {
+      dlclose(handle);
+      ALOGW("Unsupported native bridge API in %s: %s not found",
+            native_bridge_filename, kNativeBridgeInterfaceSymbol);
+    }
+  } else {
+    ALOGW("Failed to load native bridge implementation: %s", dlerror());
+  }
+
+  // Two failure conditions: could not find library (dlopen failed), or could not find native
+  // bridge interface (dlsym failed). Both are an error and close the native bridge.
+  if (callbacks == nullptr) {
+    CloseNativeBridge(true);
+    return false;
+  }
+  // The filename is no longer needed, release the memory.
+  ReleaseNativeBridgeFilename();
+  return true;
 }
 
 bool LoadNativeBridge(const char* nb_library_filename,
@@ -249,42 +311,14 @@ bool LoadNativeBridge(const char* nb_library_filename,
     if (!NativeBridgeNameAcceptable(nb_library_filename)) {
       CloseNativeBridge(true);
     } else {
-      // Try to open the library. We assume this library is provided by the
-      // platform rather than the ART APEX itself, so use the system namespace
-      // to avoid requiring a static linker config link to it from the
-      // com_android_art namespace.
-      void* handle = OpenSystemLibrary(nb_library_filename, RTLD_LAZY);
-
-      if (handle != nullptr) {
-        callbacks = reinterpret_cast<NativeBridgeCallbacks*>(dlsym(handle,
-                                                                   kNativeBridgeInterfaceSymbol));
-        if (callbacks != nullptr) {
-          if (isCompatibleWith(NAMESPACE_VERSION)) {
-            // Store the handle for later.
-            native_bridge_handle = handle;
-          } else {
-            ALOGW("Unsupported native bridge API in %s (is version %d not compatible with %d)",
-                  nb_library_filename, callbacks->version, NAMESPACE_VERSION);
-            callbacks = nullptr;
-            dlclose(handle);
-          }
-        } else {
-          dlclose(handle);
-          ALOGW("Unsupported native bridge API in %s: %s not found",
-                nb_library_filename, kNativeBridgeInterfaceSymbol);
-        }
-      } else {
-        ALOGW("Failed to load native bridge implementation: %s", dlerror());
-      }
-
-      // Two failure conditions: could not find library (dlopen failed), or could not find native
-      // bridge interface (dlsym failed). Both are an error and close the native bridge.
-      if (callbacks == nullptr) {
-        CloseNativeBridge(true);
-      } else {
-        runtime_callbacks = runtime_cbs;
-        state = NativeBridgeState::kOpened;
-      }
+      // Record the validated library name but defer the actual library load to the first use
+      // (EnsureNativeBridgeLoaded). Most processes never run translated code, and opening the
+      // bridge library here would add a library load to every process start.
+      const size_t len = strlen(nb_library_filename) + 1;
+      native_bridge_filename = new char[len];
+      memcpy(native_bridge_filename, nb_library_filename, len);
+      runtime_callbacks = runtime_cbs;
+      state = NativeBridgeState::kOpened;
     }
     return state == NativeBridgeState::kOpened;
   }
@@ -364,6 +398,12 @@ bool PreInitializeNativeBridge(const char* app_data_dir_in, const char* instruct
     return false;
   }
 
+  // Only processes that will actually run translated code get here, so this is where the
+  // library load deferred by LoadNativeBridge takes place.
+  if (!EnsureNativeBridgeLoaded()) {
+    return false;
+  }
+
   if (app_data_dir_in != nullptr) {
     // Create the path to the application code cache directory.
     // The memory will be release after Initialization or when the native bridge is closed.
@@ -528,8 +568,12 @@ void UnloadNativeBridge() {
     case NativeBridgeState::kOpened:
     case NativeBridgeState::kPreInitialized:
     case NativeBridgeState::kInitialized:
-      // Unload.
-      dlclose(native_bridge_handle);
+      // Unload. The handle is null if the deferred library load never happened.
+      if (native_bridge_handle != nullptr) {
+        dlclose(native_bridge_handle);
+        native_bridge_handle = nullptr;
+        callbacks = nullptr;
+      }
       CloseNativeBridge(false);
       break;
 
@@ -583,7 +627,7 @@ bool NativeBridgeIsSupported(const char* libpath) {
 }
 
 uint32_t NativeBridgeGetVersion() {
-  if (NativeBridgeAvailable()) {
+  if (NativeBridgeAvailable() && EnsureNativeBridgeLoaded()) {
     return callbacks->version;
   }
   return 0;
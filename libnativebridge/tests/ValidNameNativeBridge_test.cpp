@@ -24,10 +24,16 @@ TEST_F(NativeBridgeTest, ValidName) {
     // Check that the name is acceptable.
     EXPECT_EQ(true, NativeBridgeNameAcceptable(kTestName));
 
-    // Now check what happens on LoadNativeBridge.
+    // Now check what happens on LoadNativeBridge. The library load is deferred
+    // to first use, so this succeeds even though the library doesn't exist.
     EXPECT_EQ(false, NativeBridgeError());
     LoadNativeBridge(kTestName, nullptr);
-    // This will lead to an error as the library doesn't exist.
+    EXPECT_EQ(false, NativeBridgeError());
+    EXPECT_EQ(true, NativeBridgeAvailable());
+
+    // The deferred load happens on first use and fails as the library doesn't
+    // exist.
+    EXPECT_EQ(false, PreInitializeNativeBridge(nullptr, "isa"));
     EXPECT_EQ(true, NativeBridgeError());
     EXPECT_EQ(false, NativeBridgeAvailable());
 }
@@ -25,6 +25,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <android-base/file.h>
@@ -68,15 +69,30 @@ std::mutex g_namespaces_mutex;
 LibraryNamespaces* g_namespaces = new LibraryNamespaces;
 NativeLoaderNamespace* g_nativeloader_extra_libs_namespace = nullptr;
 
+// Cache of caller_location -> exported APEX namespace lookups. Deriving the
+// namespace involves string mangling and a linker query, and the same few
+// locations are looked up again for every JNI library loaded from an APEX.
+// Failed lookups are cached as nullptr. Exported namespaces live for the
+// whole process, so entries never become stale.
+std::mutex g_exported_namespaces_mutex;
+std::unordered_map<std::string, android_namespace_t*> g_exported_namespaces
+    GUARDED_BY(g_exported_namespaces_mutex);
+
 android_namespace_t* FindExportedNamespace(const char* caller_location) {
+  std::lock_guard<std::mutex> guard(g_exported_namespaces_mutex);
+  auto it = g_exported_namespaces.find(caller_location);
+  if (it != g_exported_namespaces.end()) {
+    return it->second;
+  }
+  android_namespace_t* boot_namespace = nullptr;
   auto name = nativeloader::FindApexNamespaceName(caller_location);
   if (name.ok()) {
-    android_namespace_t* boot_namespace = android_get_exported_namespace(name->c_str());
+    boot_namespace = android_get_exported_namespace(name->c_str());
     LOG_ALWAYS_FATAL_IF((boot_namespace == nullptr),
                         "Error finding namespace of apex: no namespace called %s", name->c_str());
-    return boot_namespace;
   }
-  return nullptr;
+  g_exported_namespaces.emplace(caller_location, boot_namespace);
+  return boot_namespace;
 }
 
 Result<void> CreateNativeloaderDefaultNamespaceLibsLink(NativeLoaderNamespace& ns)
@@ -119,11 +135,15 @@ Result<NativeLoaderNamespace*> GetNativeloaderExtraLibsNamespace() REQUIRES(g_na
 // then load it in the nativeloader-extra-libs namespace, otherwise return
 // nullptr without error.
 Result<void*> TryLoadNativeloaderExtraLib(const char* path) {
-  const char* links = getenv("NATIVELOADER_DEFAULT_NAMESPACE_LIBS");
-  if (links == nullptr || *links == 0) {
-    return nullptr;
-  }
-  std::vector<std::string> lib_list = base::Split(links, ":");
+  // The environment variable does not change over the process lifetime, so
+  // parse it only once instead of on every library load without a classloader.
+  static const std::vector<std::string> lib_list = []() -> std::vector<std::string> {
+    const char* links = getenv("NATIVELOADER_DEFAULT_NAMESPACE_LIBS");
+    if (links == nullptr || *links == 0) {
+      return {};
+    }
+    return base::Split(links, ":");
+  }();
   if (std::find(lib_list.begin(), lib_list.end(), path) == lib_list.end()) {
     return nullptr;
   }
@@ -180,6 +200,8 @@ void ResetNativeLoader() {
   g_namespaces->Reset();
   delete g_nativeloader_extra_libs_namespace;
   g_nativeloader_extra_libs_namespace = nullptr;
+  std::lock_guard<std::mutex> exported_guard(g_exported_namespaces_mutex);
+  g_exported_namespaces.clear();
 #endif
 }
 
@@ -27,12 +27,14 @@
 #include <climits>
 #include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <numeric>
 #include <random>
 #include <string>
 #include <vector>
 
 #include "android-base/file.h"
+#include "android-base/unique_fd.h"
 
 #include "base/arena_allocator.h"
 #include "base/bit_utils.h"
@@ -40,6 +42,7 @@
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/malloc_arena_pool.h"
+#include "base/memfd.h"
 #include "base/os.h"
 #include "base/safe_map.h"
 #include "base/scoped_flock.h"
@@ -55,9 +58,9 @@
 namespace art {
 
 const uint8_t ProfileCompilationInfo::kProfileMagic[] = { 'p', 'r', 'o', '\0' };
-// Last profile version: New extensible profile format.
-const uint8_t ProfileCompilationInfo::kProfileVersion[] = { '0', '1', '5', '\0' };
-const uint8_t ProfileCompilationInfo::kProfileVersionForBootImage[] = { '0', '1', '6', '\0' };
+// Last profile version: Megamorphic inline caches keep their dominant receiver types.
+const uint8_t ProfileCompilationInfo::kProfileVersion[] = { '0', '1', '7', '\0' };
+const uint8_t ProfileCompilationInfo::kProfileVersionForBootImage[] = { '0', '1', '8', '\0' };
 
 static_assert(sizeof(ProfileCompilationInfo::kProfileVersion) == 4,
               "Invalid profile version size");
@@ -587,9 +590,10 @@ void ProfileCompilationInfo::DexPcData::AddClass(const dex::TypeIndex& type_idx)
   }
 
   // Check if the adding the type will cause the cache to become megamorphic.
+  // Keep the types recorded so far; they are the dominant receivers for the site
+  // and still allow guarded polymorphic inlining.
   if (classes.size() + 1 >= ProfileCompilationInfo::kIndividualInlineCacheSize) {
     is_megamorphic = true;
-    classes.clear();
     return;
   }
 
@@ -721,7 +725,7 @@ bool ProfileCompilationInfo::AddClass(const DexFile& dex_file,
   if (!type_index.IsValid()) {
     return false;
   }
-  data->class_set.insert(type_index);
+  data->AddClass(type_index);
   return true;
 }
 
@@ -800,6 +804,19 @@ bool ProfileCompilationInfo::Load(const std::string& filename, bool clear_if_inv
   return false;
 }
 
+// Returns true if all the bytes were successfully written to the file descriptor.
+static bool WriteBuffer(int fd, const void* buffer, size_t byte_count) {
+  while (byte_count > 0) {
+    int bytes_written = TEMP_FAILURE_RETRY(write(fd, buffer, byte_count));
+    if (bytes_written == -1) {
+      return false;
+    }
+    byte_count -= bytes_written;  // Reduce the number of remaining bytes.
+    reinterpret_cast<const uint8_t*&>(buffer) += bytes_written;  // Move the buffer forward.
+  }
+  return true;
+}
+
 bool ProfileCompilationInfo::Save(const std::string& filename, uint64_t* bytes_written) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
   std::string error;
@@ -820,6 +837,47 @@ bool ProfileCompilationInfo::Save(const std::string& filename, uint64_t* bytes_w
 
   int fd = profile_file->Fd();
 
+  // Serialize to an in-memory file first and skip the flash write entirely when the profile on
+  // disk already has identical content. The profile saver re-saves periodically even when the
+  // in-memory info ends up equal to the last save; comparing against the existing file costs a
+  // read, which is much cheaper than rewriting the whole profile every save period.
+  android::base::unique_fd memfd(memfd_create_compat("profile-save", /*flags=*/ 0));
+  if (memfd >= 0) {
+    if (!Save(memfd.get())) {
+      VLOG(profiler) << "Failed to serialize profile info for " << filename;
+      return false;
+    }
+    std::string new_content;
+    std::string old_content;
+    if (lseek(memfd.get(), 0, SEEK_SET) != 0 ||
+        !android::base::ReadFdToString(memfd.get(), &new_content)) {
+      PLOG(WARNING) << "Could not read back serialized profile for: " << filename;
+      return false;
+    }
+    if (android::base::ReadFdToString(fd, &old_content) && new_content == old_content) {
+      VLOG(profiler) << "Profile info in " << filename << " is already up to date";
+      if (bytes_written != nullptr) {
+        *bytes_written = 0u;
+      }
+      return true;
+    }
+    if (!profile_file->ClearContent()) {
+      PLOG(WARNING) << "Could not clear profile file: " << filename;
+      return false;
+    }
+    if (!WriteBuffer(fd, new_content.data(), new_content.size())) {
+      VLOG(profiler) << "Failed to save profile info to " << filename;
+      return false;
+    }
+    if (bytes_written != nullptr) {
+      *bytes_written = new_content.size();
+    }
+    VLOG(profiler) << "Successfully saved profile info to " << filename
+                   << " Size: " << new_content.size();
+    return true;
+  }
+
+  // Could not create an in-memory file; write directly.
   // We need to clear the data because we don't support appending to the profiles yet.
   if (!profile_file->ClearContent()) {
     PLOG(WARNING) << "Could not clear profile file: " << filename;
@@ -845,19 +903,6 @@ bool ProfileCompilationInfo::Save(const std::string& filename, uint64_t* bytes_w
   return result;
 }
 
-// Returns true if all the bytes were successfully written to the file descriptor.
-static bool WriteBuffer(int fd, const void* buffer, size_t byte_count) {
-  while (byte_count > 0) {
-    int bytes_written = TEMP_FAILURE_RETRY(write(fd, buffer, byte_count));
-    if (bytes_written == -1) {
-      return false;
-    }
-    byte_count -= bytes_written;  // Reduce the number of remaining bytes.
-    reinterpret_cast<const uint8_t*&>(buffer) += bytes_written;  // Move the buffer forward.
-  }
-  return true;
-}
-
 /**
  * Serialization format:
  *
@@ -911,7 +956,11 @@ static bool WriteBuffer(int fd, const void* buffer, size_t byte_count) {
  *    (M|dex_map_size)
  *    type_index_diff[dex_map_size]
  * where `M` stands for special encodings indicating missing types (kIsMissingTypesEncoding)
- * or memamorphic call (kIsMegamorphicEncoding) which both imply `dex_map_size == 0`.
+ * or megamorphic call (kIsMegamorphicEncoding). Missing types imply `dex_map_size == 0`.
+ * The megamorphic encoding is followed by
+ *    dex_map_size
+ *    type_index_diff[dex_map_size]
+ * recording the dominant receiver types seen before the call site overflowed the cache.
  **/
 bool ProfileCompilationInfo::Save(int fd) {
   uint64_t start = NanoTime();
@@ -1251,10 +1300,6 @@ bool ProfileCompilationInfo::AddMethod(const ProfileMethodInfo& pmi,
       FindOrAddDexPc(inline_cache, cache.dex_pc)->SetIsMissingTypes();
       continue;
     }
-    if  (cache.is_megamorphic) {
-      FindOrAddDexPc(inline_cache, cache.dex_pc)->SetIsMegamorphic();
-      continue;
-    }
     for (const TypeReference& class_ref : cache.classes) {
       DexPcData* dex_pc_data = FindOrAddDexPc(inline_cache, cache.dex_pc);
       if (dex_pc_data->is_missing_types || dex_pc_data->is_megamorphic) {
@@ -1269,6 +1314,10 @@ bool ProfileCompilationInfo::AddMethod(const ProfileMethodInfo& pmi,
         dex_pc_data->SetIsMissingTypes();
       }
     }
+    if (cache.is_megamorphic) {
+      // Record the megamorphic flag after the classes so the dominant receivers are kept.
+      FindOrAddDexPc(inline_cache, cache.dex_pc)->SetIsMegamorphic();
+    }
   }
   return true;
 }
@@ -1329,14 +1378,16 @@ bool ProfileCompilationInfo::VerifyProfileData(const std::vector<const DexFile*>
         CHECK_LT(method_it.first, dex_data->num_method_ids);
 
         // Verify class indices of inline caches.
-        const InlineCacheMap &inline_cache_map = method_it.second;
+        const InlineCacheMap &inline_cache_map = *method_it.second;
         for (const auto& inline_cache_it : inline_cache_map) {
           const DexPcData& dex_pc_data = inline_cache_it.second;
-          if (dex_pc_data.is_missing_types || dex_pc_data.is_megamorphic) {
+          if (dex_pc_data.is_missing_types) {
             // No class indices to verify.
             CHECK(dex_pc_data.classes.empty());
             continue;
           }
+          // Note: Megamorphic entries keep their dominant receiver types,
+          // so their class indices are verified as well.
 
           for (const dex::TypeIndex& type_index : dex_pc_data.classes) {
             if (type_index.index_ >= dex_data->num_type_ids) {
@@ -1883,16 +1934,29 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
     if (merge_classes) {
       // Classes are ordered by the `TypeIndex`, so we have the classes with a `TypeId`
       // in the dex file first, followed by classes using extra descriptors.
-      auto it = other_dex_data->class_set.lower_bound(dex::TypeIndex(num_type_ids));
-      dex_data->class_set.insert(other_dex_data->class_set.begin(), it);
-      for (auto end = other_dex_data->class_set.end(); it != end; ++it) {
+      auto other_end = std::lower_bound(other_dex_data->class_set.begin(),
+                                        other_dex_data->class_set.end(),
+                                        dex::TypeIndex(num_type_ids));
+      if (dex_data->class_set.empty()) {
+        dex_data->class_set.assign(other_dex_data->class_set.begin(), other_end);
+      } else {
+        // Both class sets are sorted, so merge them as a sorted set union.
+        ArenaVector<dex::TypeIndex> merged(dex_data->class_set.get_allocator());
+        merged.reserve(
+            dex_data->class_set.size() + (other_end - other_dex_data->class_set.begin()));
+        std::set_union(dex_data->class_set.begin(), dex_data->class_set.end(),
+                       other_dex_data->class_set.begin(), other_end,
+                       std::back_inserter(merged));
+        dex_data->class_set.swap(merged);
+      }
+      for (auto it = other_end, end = other_dex_data->class_set.end(); it != end; ++it) {
         ExtraDescriptorIndex new_extra_descriptor_index =
             extra_descriptors_remap[it->index_ - num_type_ids];
         if (new_extra_descriptor_index >= DexFile::kDexNoIndex16 - num_type_ids) {
           // Cannot represent the type with new extra descriptor index.
           return false;
         }
-        dex_data->class_set.insert(dex::TypeIndex(num_type_ids + new_extra_descriptor_index));
+        dex_data->AddClass(dex::TypeIndex(num_type_ids + new_extra_descriptor_index));
       }
     }
 
@@ -1903,15 +1967,13 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
       if (inline_cache == nullptr) {
         return false;
       }
-      const auto& other_inline_cache = other_method_it.second;
+      const auto& other_inline_cache = *other_method_it.second;
       for (const auto& other_ic_it : other_inline_cache) {
         uint16_t other_dex_pc = other_ic_it.first;
         const ArenaSet<dex::TypeIndex>& other_class_set = other_ic_it.second.classes;
         DexPcData* dex_pc_data = FindOrAddDexPc(inline_cache, other_dex_pc);
         if (other_ic_it.second.is_missing_types) {
           dex_pc_data->SetIsMissingTypes();
-        } else if (other_ic_it.second.is_megamorphic) {
-          dex_pc_data->SetIsMegamorphic();
         } else {
           for (dex::TypeIndex type_index : other_class_set) {
             if (type_index.index_ >= num_type_ids) {
@@ -1925,6 +1987,10 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
             }
             dex_pc_data->AddClass(type_index);
           }
+          if (other_ic_it.second.is_megamorphic) {
+            // Merge the classes first so the dominant receivers survive the merge.
+            dex_pc_data->SetIsMegamorphic();
+          }
         }
       }
     }
@@ -2026,14 +2092,16 @@ std::string ProfileCompilationInfo::DumpInfo(const std::vector<const DexFile*>&
       }
 
       os << "[";
-      for (const auto& inline_cache_it : method_it.second) {
+      for (const auto& inline_cache_it : *method_it.second) {
         os << "{" << std::hex << inline_cache_it.first << std::dec << ":";
         if (inline_cache_it.second.is_missing_types) {
           os << "MT";
-        } else if (inline_cache_it.second.is_megamorphic) {
-          os << "MM";
         } else {
           const char* separator = "";
+          if (inline_cache_it.second.is_megamorphic) {
+            os << "MM";
+            separator = ":";
+          }
           for (dex::TypeIndex type_index : inline_cache_it.second.classes) {
             os << separator << type_index.index_;
             separator = ",";
@@ -2170,7 +2238,7 @@ bool ProfileCompilationInfo::GenerateTestProfile(int fd,
       if (c < (number_of_classes / kFavorSplit)) {
         type_idx %= kFavorFirstN;
       }
-      data->class_set.insert(dex::TypeIndex(type_idx));
+      data->AddClass(dex::TypeIndex(type_idx));
     }
   }
   return info.Save(fd);
@@ -2209,7 +2277,7 @@ bool ProfileCompilationInfo::GenerateTestProfile(
           profile_key, checksum, dex_file->NumTypeIds(), dex_file->NumMethodIds());
     for (uint32_t class_index : create_shuffled_range(classes_required_in_profile,
                                                       number_of_classes)) {
-      data->class_set.insert(dex_file->GetClassDef(class_index).class_idx_);
+      data->AddClass(dex_file->GetClassDef(class_index).class_idx_);
     }
 
     uint32_t number_of_methods = dex_file->NumMethodIds();
@@ -2241,9 +2309,43 @@ ProfileCompilationInfo::DexFileData::FindOrAddHotMethod(uint16_t method_index) {
     LOG(ERROR) << "Invalid method index " << method_index << ". num_method_ids=" << num_method_ids;
     return nullptr;
   }
-  return &(method_map.FindOrAdd(
-      method_index,
-      InlineCacheMap(std::less<uint16_t>(), allocator_->Adapter(kArenaAllocProfile)))->second);
+  // Profile loading and merging iterate methods in ascending order, so the
+  // new entry usually belongs at the end of the vector.
+  auto it = method_map.end();
+  if (!method_map.empty() && method_map.back().first >= method_index) {
+    it = std::lower_bound(method_map.begin(), method_map.end(), method_index,
+                          [](const auto& entry, uint16_t index) { return entry.first < index; });
+    if (it->first == method_index) {
+      return it->second;
+    }
+  }
+  void* storage = allocator_->Alloc(sizeof(InlineCacheMap), kArenaAllocProfile);
+  InlineCacheMap* inline_cache =
+      new (storage) InlineCacheMap(std::less<uint16_t>(), allocator_->Adapter(kArenaAllocProfile));
+  method_map.insert(it, std::make_pair(method_index, inline_cache));
+  return inline_cache;
+}
+
+void ProfileCompilationInfo::DexFileData::AddClass(dex::TypeIndex type_index) {
+  // The serialized format stores type indexes in ascending order, so insertions
+  // during loading and merging usually append to the vector.
+  if (class_set.empty() || class_set.back() < type_index) {
+    class_set.push_back(type_index);
+    return;
+  }
+  auto it = std::lower_bound(class_set.begin(), class_set.end(), type_index);
+  if (*it != type_index) {
+    class_set.insert(it, type_index);
+  }
+}
+
+bool ProfileCompilationInfo::DexFileData::MethodMapsEqual(const MethodMap& lhs,
+                                                          const MethodMap& rhs) {
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                    [](const auto& lhs_entry, const auto& rhs_entry) {
+                      return lhs_entry.first == rhs_entry.first &&
+                          *lhs_entry.second == *rhs_entry.second;
+                    });
 }
 
 // Mark a method as executed at least once.
@@ -2298,9 +2400,10 @@ ProfileCompilationInfo::MethodHotness ProfileCompilationInfo::DexFileData::GetHo
       ret.AddFlag(static_cast<MethodHotness::Flag>(flag));
     }
   });
-  auto it = method_map.find(dex_method_index);
-  if (it != method_map.end()) {
-    ret.SetInlineCacheMap(&it->second);
+  auto it = std::lower_bound(method_map.begin(), method_map.end(), dex_method_index,
+                             [](const auto& entry, uint32_t index) { return entry.first < index; });
+  if (it != method_map.end() && it->first == dex_method_index) {
+    ret.SetInlineCacheMap(it->second);
     ret.AddFlag(MethodHotness::kFlagHot);
   }
   return ret;
@@ -2463,7 +2566,7 @@ const uint8_t* ProfileCompilationInfo::GetVersion() const {
 }
 
 bool ProfileCompilationInfo::DexFileData::ContainsClass(dex::TypeIndex type_index) const {
-  return class_set.find(type_index) != class_set.end();
+  return std::binary_search(class_set.begin(), class_set.end(), type_index);
 }
 
 uint32_t ProfileCompilationInfo::DexFileData::ClassesDataSize() const {
@@ -2518,7 +2621,7 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::DexFileData::R
       }
       type_index = num_type_ids + new_extra_descriptor_index;
     }
-    class_set.insert(dex::TypeIndex(type_index));
+    AddClass(dex::TypeIndex(type_index));
   }
   return ProfileLoadStatus::kSuccess;
 }
@@ -2553,12 +2656,17 @@ uint32_t ProfileCompilationInfo::DexFileData::MethodsDataSize(
     size_t num_hot_methods = method_map.size();
     size_t num_dex_pc_entries = 0u;
     size_t num_class_entries = 0u;
+    size_t num_megamorphic_entries = 0u;
     for (const auto& method_entry : method_map) {
-      const InlineCacheMap& inline_cache_map = method_entry.second;
+      const InlineCacheMap& inline_cache_map = *method_entry.second;
       num_dex_pc_entries += inline_cache_map.size();
       for (const auto& inline_cache_entry : inline_cache_map) {
         const DexPcData& dex_pc_data = inline_cache_entry.second;
         num_class_entries += dex_pc_data.classes.size();
+        if (dex_pc_data.is_megamorphic) {
+          // The megamorphic encoding is followed by the number of retained classes.
+          num_megamorphic_entries += 1u;
+        }
       }
     }
 
@@ -2578,7 +2686,8 @@ uint32_t ProfileCompilationInfo::DexFileData::MethodsDataSize(
            saved_bitmap_byte_size +                   // Bitmap data.
            num_hot_methods * kPerHotMethodSize +      // Data for hot methods.
            num_dex_pc_entries * kPerDexPcEntrySize +  // Data for dex pc entries.
-           num_class_entries * kPerClassEntrySize;    // Data for inline cache class entries.
+           num_class_entries * kPerClassEntrySize +   // Data for inline cache class entries.
+           num_megamorphic_entries * sizeof(uint8_t);  // Retained class counts.
   }
   if (method_flags != nullptr) {
     *method_flags = local_method_flags;
@@ -2627,10 +2736,10 @@ void ProfileCompilationInfo::DexFileData::WriteMethods(SafeBuffer& buffer) const
   uint16_t last_method_index = 0;
   for (const auto& method_entry : method_map) {
     uint16_t method_index = method_entry.first;
-    const InlineCacheMap& inline_cache_map = method_entry.second;
+    const InlineCacheMap& inline_cache_map = *method_entry.second;
 
     // Store the difference between the method indices for better compression.
-    // The SafeMap is ordered by method_id, so the difference will always be non negative.
+    // The method map is sorted by method_id, so the difference will always be non negative.
     DCHECK_GE(method_index, last_method_index);
     uint16_t diff_with_last_method_index = method_index - last_method_index;
     last_method_index = method_index;
@@ -2648,9 +2757,8 @@ void ProfileCompilationInfo::DexFileData::WriteMethods(SafeBuffer& buffer) const
       // Add the dex pc.
       buffer.WriteUintAndAdvance(dex_pc);
 
-      // Add the megamorphic/missing_types encoding if needed and continue.
-      // In either cases we don't add any classes to the profiles and so there's
-      // no point to continue.
+      // Add the missing_types encoding if needed and continue. In that case we
+      // don't add any classes to the profile and so there's no point to continue.
       // TODO: in case we miss types there is still value to add the rest of the
       // classes. (This requires changing profile version or using a new section type.)
       if (dex_pc_data.is_missing_types) {
@@ -2659,14 +2767,17 @@ void ProfileCompilationInfo::DexFileData::WriteMethods(SafeBuffer& buffer) const
         DCHECK_EQ(classes.size(), 0u);
         buffer.WriteUintAndAdvance(kIsMissingTypesEncoding);
         continue;
-      } else if (dex_pc_data.is_megamorphic) {
-        DCHECK_EQ(classes.size(), 0u);
-        buffer.WriteUintAndAdvance(kIsMegamorphicEncoding);
-        continue;
       }
 
+      if (dex_pc_data.is_megamorphic) {
+        // Mark the call site as megamorphic but keep the dominant receiver types
+        // recorded before the cache overflowed; dex2oat can still use them for
+        // guarded polymorphic inlining.
+        buffer.WriteUintAndAdvance(kIsMegamorphicEncoding);
+      } else {
+        DCHECK_NE(classes.size(), 0u) << "InlineCache contains a dex_pc with 0 classes";
+      }
       DCHECK_LT(classes.size(), ProfileCompilationInfo::kIndividualInlineCacheSize);
-      DCHECK_NE(classes.size(), 0u) << "InlineCache contains a dex_pc with 0 classes";
 
       // Add the number of classes for the dex PC.
       buffer.WriteUintAndAdvance(dchecked_integral_cast<uint8_t>(classes.size()));
@@ -2777,39 +2888,51 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::DexFileData::R
         }
         if (inline_cache_classes_size == kIsMissingTypesEncoding) {
           dex_pc_data->SetIsMissingTypes();
-        } else if (inline_cache_classes_size == kIsMegamorphicEncoding) {
-          dex_pc_data->SetIsMegamorphic();
-        } else if (inline_cache_classes_size >= kIndividualInlineCacheSize) {
+          continue;
+        }
+        const bool is_megamorphic = (inline_cache_classes_size == kIsMegamorphicEncoding);
+        if (is_megamorphic) {
+          // The megamorphic encoding is followed by the number of retained
+          // dominant receiver types.
+          if (!buffer.ReadUintAndAdvance(&inline_cache_classes_size)) {
+            *error = "Error reading megamorphic inline cache classes size.";
+            return ProfileLoadStatus::kBadData;
+          }
+        }
+        if (inline_cache_classes_size >= kIndividualInlineCacheSize) {
           *error = "Inline cache size too large.";
           return ProfileLoadStatus::kBadData;
-        } else {
-          uint16_t type_index = 0u;
-          for (size_t i = 0; i != inline_cache_classes_size; ++i) {
-            uint16_t type_index_diff;
-            if (!buffer.ReadUintAndAdvance(&type_index_diff)) {
-              *error = "Error reading inline cache type index diff.";
-              return ProfileLoadStatus::kBadData;
-            }
-            if (type_index_diff == 0u && i != 0u) {
-              *error = "Duplicate inline cache type index.";
-              return ProfileLoadStatus::kBadData;
-            }
-            if (type_index_diff >= num_valid_type_indexes - type_index) {
-              *error = "Invalid inline cache type index.";
-              return ProfileLoadStatus::kBadData;
-            }
-            type_index += type_index_diff;
-            if (type_index >= num_type_ids) {
-              ExtraDescriptorIndex new_extra_descriptor_index =
-                  extra_descriptors_remap[type_index - num_type_ids];
-              if (new_extra_descriptor_index >= DexFile::kDexNoIndex16 - num_type_ids) {
-                *error = "Remapped inline cache type index out of range.";
-                return ProfileLoadStatus::kMergeError;
-              }
-              type_index = num_type_ids + new_extra_descriptor_index;
+        }
+        uint16_t type_index = 0u;
+        for (size_t i = 0; i != inline_cache_classes_size; ++i) {
+          uint16_t type_index_diff;
+          if (!buffer.ReadUintAndAdvance(&type_index_diff)) {
+            *error = "Error reading inline cache type index diff.";
+            return ProfileLoadStatus::kBadData;
+          }
+          if (type_index_diff == 0u && i != 0u) {
+            *error = "Duplicate inline cache type index.";
+            return ProfileLoadStatus::kBadData;
+          }
+          if (type_index_diff >= num_valid_type_indexes - type_index) {
+            *error = "Invalid inline cache type index.";
+            return ProfileLoadStatus::kBadData;
+          }
+          type_index += type_index_diff;
+          if (type_index >= num_type_ids) {
+            ExtraDescriptorIndex new_extra_descriptor_index =
+                extra_descriptors_remap[type_index - num_type_ids];
+            if (new_extra_descriptor_index >= DexFile::kDexNoIndex16 - num_type_ids) {
+              *error = "Remapped inline cache type index out of range.";
+              return ProfileLoadStatus::kMergeError;
             }
-            dex_pc_data->AddClass(dex::TypeIndex(type_index));
+            type_index = num_type_ids + new_extra_descriptor_index;
           }
+          dex_pc_data->AddClass(dex::TypeIndex(type_index));
+        }
+        if (is_megamorphic) {
+          // Set the flag after adding the classes so they are retained.
+          dex_pc_data->SetIsMegamorphic();
         }
       }
     }
@@ -2839,9 +2962,10 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::DexFileData::S
   return ProfileLoadStatus::kSuccess;
 }
 
+template <typename ClassSet>
 void ProfileCompilationInfo::DexFileData::WriteClassSet(
     SafeBuffer& buffer,
-    const ArenaSet<dex::TypeIndex>& class_set) {
+    const ClassSet& class_set) {
   // Store the difference between the type indexes for better compression.
   uint16_t last_type_index = 0u;
   for (const dex::TypeIndex& type_index : class_set) {
@@ -21,6 +21,7 @@
 #include <list>
 #include <set>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "base/arena_containers.h"
@@ -131,7 +132,9 @@ class ProfileCompilationInfo {
 
   // Encodes the actual inline cache for a given dex pc (whether or not the receiver is
   // megamorphic and its possible types).
-  // If the receiver is megamorphic or is missing types the set of classes will be empty.
+  // If the receiver is missing types the set of classes will be empty. If the receiver is
+  // megamorphic the set keeps the dominant receiver types recorded before the call site
+  // overflowed the cache, so the compiler can still do guarded polymorphic inlining.
   struct DexPcData : public ArenaObject<kArenaAllocProfile> {
     explicit DexPcData(ArenaAllocator* allocator)
         : DexPcData(allocator->Adapter(kArenaAllocProfile)) {}
@@ -143,7 +146,7 @@ class ProfileCompilationInfo {
     void SetIsMegamorphic() {
       if (is_missing_types) return;
       is_megamorphic = true;
-      classes.clear();
+      // Keep the already recorded classes; they are the dominant receivers for the site.
     }
     void SetIsMissingTypes() {
       is_megamorphic = false;
@@ -167,8 +170,12 @@ class ProfileCompilationInfo {
   // The inline cache map: DexPc -> DexPcData.
   using InlineCacheMap = ArenaSafeMap<uint16_t, DexPcData>;
 
-  // Maps a method dex index to its inline cache.
-  using MethodMap = ArenaSafeMap<uint16_t, InlineCacheMap>;
+  // Maps a method dex index to its inline cache, stored as a flat vector sorted
+  // by method index. The serialized format is ordered by method index, so loads
+  // and merges insert in ascending order and mostly append. The inline cache
+  // maps are allocated separately in the arena so that the pointers handed out
+  // through `MethodHotness` remain stable when the vector reallocates.
+  using MethodMap = ArenaVector<std::pair<uint16_t, InlineCacheMap*>>;
 
   // Profile method hotness information for a single method. Also includes a pointer to the inline
   // cache map.
@@ -335,7 +342,7 @@ class ProfileCompilationInfo {
     DCHECK(type_index.IsValid());
     DCHECK(type_index.index_ <= data->num_type_ids ||
            type_index.index_ - data->num_type_ids < extra_descriptors_.size());
-    data->class_set.insert(type_index);
+    data->AddClass(type_index);
   }
 
   // Add a class with the specified `type_index` to the profile. The `type_index`
@@ -352,7 +359,7 @@ class ProfileCompilationInfo {
     if (data == nullptr) {  // Checksum/num_type_ids/num_method_ids mismatch or too many dex files.
       return false;
     }
-    data->class_set.insert(type_index);
+    data->AddClass(type_index);
     return true;
   }
 
@@ -386,7 +393,9 @@ class ProfileCompilationInfo {
     if (data == nullptr) {
       return false;
     }
-    data->class_set.insert(index_begin, index_end);
+    for (Iterator it = index_begin; it != index_end; ++it) {
+      data->AddClass(*it);
+    }
     return true;
   }
 
@@ -733,8 +742,8 @@ class ProfileCompilationInfo {
           profile_key(key),
           profile_index(index),
           checksum(location_checksum),
-          method_map(std::less<uint16_t>(), allocator->Adapter(kArenaAllocProfile)),
-          class_set(std::less<dex::TypeIndex>(), allocator->Adapter(kArenaAllocProfile)),
+          method_map(allocator->Adapter(kArenaAllocProfile)),
+          class_set(allocator->Adapter(kArenaAllocProfile)),
           num_type_ids(num_types),
           num_method_ids(num_methods),
           bitmap_storage(allocator->Adapter(kArenaAllocProfile)),
@@ -764,7 +773,7 @@ class ProfileCompilationInfo {
     bool operator==(const DexFileData& other) const {
       return checksum == other.checksum &&
           num_method_ids == other.num_method_ids &&
-          method_map == other.method_map &&
+          MethodMapsEqual(method_map, other.method_map) &&
           class_set == other.class_set &&
           (BitMemoryRegion::Compare(method_bitmap, other.method_bitmap) == 0);
     }
@@ -772,6 +781,9 @@ class ProfileCompilationInfo {
     // Mark a method as executed at least once.
     bool AddMethod(MethodHotness::Flag flags, size_t index);
 
+    // Add a class to the sorted `class_set` unless it is already recorded.
+    void AddClass(dex::TypeIndex type_index);
+
     void MergeBitmap(const DexFileData& other) {
       DCHECK_EQ(bitmap_storage.size(), other.bitmap_storage.size());
       for (size_t i = 0; i < bitmap_storage.size(); ++i) {
@@ -811,9 +823,10 @@ class ProfileCompilationInfo {
     uint32_t checksum;
     // The methods' profile information.
     MethodMap method_map;
-    // The classes which have been profiled. Note that these don't necessarily include
-    // all the classes that can be found in the inline caches reference.
-    ArenaSet<dex::TypeIndex> class_set;
+    // The classes which have been profiled, sorted by type index. Note that these
+    // don't necessarily include all the classes that can be found in the inline
+    // caches reference.
+    ArenaVector<dex::TypeIndex> class_set;
     // Find the inline caches of the the given method index. Add an empty entry if
     // no previous data is found.
     InlineCacheMap* FindOrAddHotMethod(uint16_t method_index);
@@ -829,7 +842,14 @@ class ProfileCompilationInfo {
     template <typename Fn>
     void ForMethodBitmapHotnessFlags(Fn fn) const;
 
-    static void WriteClassSet(SafeBuffer& buffer, const ArenaSet<dex::TypeIndex>& class_set);
+    // Compare the actual inline cache contents, as the `method_map` entries
+    // hold pointers to arena-allocated inline cache maps.
+    static bool MethodMapsEqual(const MethodMap& lhs, const MethodMap& rhs);
+
+    // Write type index diffs for a sorted class set (the flat `class_set` or
+    // the `ArenaSet<>` of inline cache classes).
+    template <typename ClassSet>
+    static void WriteClassSet(SafeBuffer& buffer, const ClassSet& class_set);
     size_t MethodFlagBitmapIndex(MethodHotness::Flag flag, size_t method_index) const;
     static size_t FlagBitmapIndex(MethodHotness::Flag flag);
 
@@ -17,12 +17,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <atomic>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <set>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -343,6 +347,8 @@ class OatDumperOptions {
                    bool list_classes,
                    bool list_methods,
                    bool dump_header_only,
+                   bool summary_only,
+                   uint32_t dump_threads,
                    const char* export_dex_location,
                    const char* app_image,
                    const char* app_oat,
@@ -356,6 +362,8 @@ class OatDumperOptions {
       list_classes_(list_classes),
       list_methods_(list_methods),
       dump_header_only_(dump_header_only),
+      summary_only_(summary_only),
+      dump_threads_(dump_threads),
       export_dex_location_(export_dex_location),
       app_image_(app_image),
       app_oat_(app_oat),
@@ -371,6 +379,8 @@ class OatDumperOptions {
   const bool list_classes_;
   const bool list_methods_;
   const bool dump_header_only_;
+  const bool summary_only_;
+  const uint32_t dump_threads_;
   const char* const export_dex_location_;
   const char* const app_image_;
   const char* const app_oat_;
@@ -386,15 +396,7 @@ class OatDumper {
       options_(options),
       resolved_addr2instr_(0),
       instruction_set_(oat_file_.GetOatHeader().GetInstructionSet()),
-      disassembler_(Disassembler::Create(instruction_set_,
-                                         new DisassemblerOptions(
-                                             options_.absolute_addresses_,
-                                             oat_file.Begin(),
-                                             oat_file.End(),
-                                             /* can_read_literals_= */ true,
-                                             Is64BitInstructionSet(instruction_set_)
-                                                 ? &Thread::DumpThreadOffset<PointerSize::k64>
-                                                 : &Thread::DumpThreadOffset<PointerSize::k32>))) {
+      disassembler_(MakeDisassembler()) {
     CHECK(options_.class_loader_ != nullptr);
     CHECK(options_.class_filter_ != nullptr);
     CHECK(options_.method_filter_ != nullptr);
@@ -809,6 +811,8 @@ class OatDumper {
   }
 
   bool AddStatsObject(const void* address) {
+    // Serialized because parallel class dumping feeds the stats from several worker threads.
+    std::lock_guard<std::mutex> lock(stats_lock_);
     return seen_stats_objects_.insert(address).second;  // Inserted new entry.
   }
 
@@ -858,6 +862,20 @@ class OatDumper {
     offsets_.insert(oat_method.GetVmapTableOffset());
   }
 
+  // Create a disassembler for the opened oat file. Called once by the constructor and once per
+  // worker thread when the class dump runs in parallel.
+  Disassembler* MakeDisassembler() {
+    return Disassembler::Create(instruction_set_,
+                                new DisassemblerOptions(
+                                    options_.absolute_addresses_,
+                                    oat_file_.Begin(),
+                                    oat_file_.End(),
+                                    /* can_read_literals_= */ true,
+                                    Is64BitInstructionSet(instruction_set_)
+                                        ? &Thread::DumpThreadOffset<PointerSize::k64>
+                                        : &Thread::DumpThreadOffset<PointerSize::k32>));
+  }
+
   bool DumpOatDexFile(std::ostream& os, const OatDexFile& oat_dex_file) {
     bool success = true;
     bool stop_analysis = false;
@@ -899,35 +917,26 @@ class OatDumper {
                          table_offset + table_size - 1);
     }
 
-    VariableIndentationOutputStream vios(&os);
-    ScopedIndentation indent1(&vios);
-    for (ClassAccessor accessor : dex_file->GetClasses()) {
-      // TODO: Support regex
-      const char* descriptor = accessor.GetDescriptor();
-      if (DescriptorToDot(descriptor).find(options_.class_filter_) == std::string::npos) {
-        continue;
-      }
-
-      const uint16_t class_def_index = accessor.GetClassDefIndex();
-      uint32_t oat_class_offset = oat_dex_file.GetOatClassOffset(class_def_index);
-      const OatFile::OatClass oat_class = oat_dex_file.GetOatClass(class_def_index);
-      os << StringPrintf("%zd: %s (offset=0x%08x) (type_idx=%d)",
-                         static_cast<ssize_t>(class_def_index),
-                         descriptor,
-                         oat_class_offset,
-                         accessor.GetClassIdx().index_)
-         << " (" << oat_class.GetStatus() << ")"
-         << " (" << oat_class.GetType() << ")\n";
-      // TODO: include bitmap here if type is kOatClassSomeCompiled?
-      if (options_.list_classes_) {
-        continue;
-      }
-      if (!DumpOatClass(&vios, oat_class, *dex_file, accessor, &stop_analysis)) {
-        success = false;
-      }
-      if (stop_analysis) {
-        os << std::flush;
-        return success;
+    // The addr2instr search stops at the first matching method and the verifier type analysis
+    // needs the runtime's attached main thread, so both stay on the serial path.
+    size_t num_threads = std::max<size_t>(options_.dump_threads_, 1u);
+    if (num_threads > 1u && resolved_addr2instr_ == 0 && Runtime::Current() == nullptr) {
+      success = DumpOatDexFileClassesParallel(os, oat_dex_file, *dex_file, num_threads);
+    } else {
+      for (ClassAccessor accessor : dex_file->GetClasses()) {
+        // TODO: Support regex
+        if (DescriptorToDot(accessor.GetDescriptor()).find(options_.class_filter_) ==
+                std::string::npos) {
+          continue;
+        }
+        if (!DumpOatDexFileClass(
+                os, oat_dex_file, *dex_file, accessor, disassembler_, &stop_analysis)) {
+          success = false;
+        }
+        if (stop_analysis) {
+          os << std::flush;
+          return success;
+        }
       }
     }
     os << "\n";
@@ -935,6 +944,82 @@ class OatDumper {
     return success;
   }
 
+  // Dump a single class of an oat dex file: the class header line plus, unless only listing
+  // classes, all of its methods.
+  bool DumpOatDexFileClass(std::ostream& os,
+                           const OatDexFile& oat_dex_file,
+                           const DexFile& dex_file,
+                           const ClassAccessor& accessor,
+                           Disassembler* disasm,
+                           bool* stop_analysis) {
+    VariableIndentationOutputStream vios(&os);
+    ScopedIndentation indent1(&vios);
+    const char* descriptor = accessor.GetDescriptor();
+    const uint16_t class_def_index = accessor.GetClassDefIndex();
+    uint32_t oat_class_offset = oat_dex_file.GetOatClassOffset(class_def_index);
+    const OatFile::OatClass oat_class = oat_dex_file.GetOatClass(class_def_index);
+    os << StringPrintf("%zd: %s (offset=0x%08x) (type_idx=%d)",
+                       static_cast<ssize_t>(class_def_index),
+                       descriptor,
+                       oat_class_offset,
+                       accessor.GetClassIdx().index_)
+       << " (" << oat_class.GetStatus() << ")"
+       << " (" << oat_class.GetType() << ")\n";
+    // TODO: include bitmap here if type is kOatClassSomeCompiled?
+    if (options_.list_classes_) {
+      return true;
+    }
+    return DumpOatClass(&vios, oat_class, dex_file, accessor, disasm, stop_analysis);
+  }
+
+  // Dump the filtered classes of an oat dex file over several worker threads. Each class is
+  // dumped into its own buffer and the buffers are written out in class-def order, so the output
+  // is identical to the serial path for any thread count.
+  bool DumpOatDexFileClassesParallel(std::ostream& os,
+                                     const OatDexFile& oat_dex_file,
+                                     const DexFile& dex_file,
+                                     size_t num_threads) {
+    std::vector<uint32_t> class_def_indices;
+    for (ClassAccessor accessor : dex_file.GetClasses()) {
+      // TODO: Support regex
+      if (DescriptorToDot(accessor.GetDescriptor()).find(options_.class_filter_) !=
+              std::string::npos) {
+        class_def_indices.push_back(accessor.GetClassDefIndex());
+      }
+    }
+    std::vector<std::string> buffers(class_def_indices.size());
+    std::atomic<size_t> next_class(0u);
+    std::atomic<bool> success(true);
+    auto dump_classes = [&]() {
+      // The disassemblers keep per-instance state, so each worker gets its own.
+      std::unique_ptr<Disassembler> disasm(MakeDisassembler());
+      for (size_t i = next_class.fetch_add(1u, std::memory_order_relaxed);
+           i < class_def_indices.size();
+           i = next_class.fetch_add(1u, std::memory_order_relaxed)) {
+        std::ostringstream buffer;
+        ClassAccessor accessor(dex_file, class_def_indices[i]);
+        bool stop_analysis = false;
+        if (!DumpOatDexFileClass(
+                buffer, oat_dex_file, dex_file, accessor, disasm.get(), &stop_analysis)) {
+          success.store(false, std::memory_order_relaxed);
+        }
+        buffers[i] = buffer.str();
+      }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1u; i < num_threads; ++i) {
+      workers.emplace_back(dump_classes);
+    }
+    dump_classes();
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    for (const std::string& buffer : buffers) {
+      os << buffer;
+    }
+    return success.load(std::memory_order_relaxed);
+  }
+
   // Backwards compatible Dex file export. If dex_file is nullptr (valid Vdex file not present) the
   // Dex resource is extracted from the oat_dex_file and its checksum is repaired since it's not
   // unquickened. Otherwise the dex_file has been fully unquickened and is expected to verify the
@@ -1049,6 +1134,7 @@ class OatDumper {
                     const OatFile::OatClass& oat_class,
                     const DexFile& dex_file,
                     const ClassAccessor& class_accessor,
+                    Disassembler* disasm,
                     bool* stop_analysis) {
     bool success = true;
     bool addr_found = false;
@@ -1062,6 +1148,7 @@ class OatDumper {
                          method.GetIndex(),
                          method.GetCodeItem(),
                          method.GetAccessFlags(),
+                         disasm,
                          &addr_found)) {
         success = false;
       }
@@ -1088,6 +1175,7 @@ class OatDumper {
                      uint32_t dex_method_idx,
                      const dex::CodeItem* code_item,
                      uint32_t method_access_flags,
+                     Disassembler* disasm,
                      bool* addr_found) {
     bool success = true;
 
@@ -1120,6 +1208,37 @@ class OatDumper {
       }
     }
 
+    if (options_.summary_only_) {
+      // Size-regression jobs only need the sizes: decode the method header and the CodeInfo, but
+      // skip the dex code, the verifier type analysis and the disassembler.
+      ScopedIndentation indent1(vios);
+      const OatQuickMethodHeader* method_header = oat_method.GetOatQuickMethodHeader();
+      if (AddStatsObject(method_header)) {
+        std::lock_guard<std::mutex> lock(stats_lock_);
+        stats_["QuickMethodHeader"].AddBytes(sizeof(*method_header));
+      }
+      if (AddStatsObject(oat_method.GetQuickCode())) {
+        std::lock_guard<std::mutex> lock(stats_lock_);
+        stats_["Code"].AddBytes(code_size);
+      }
+      size_t code_info_size = 0u;
+      if (IsMethodGeneratedByOptimizingCompiler(oat_method, code_item_accessor)) {
+        const uint8_t* code_info_data = oat_method.GetVmapTable();
+        size_t num_read_bits = 0u;
+        CodeInfo code_info(code_info_data, &num_read_bits);
+        code_info_size = BitsToBytesRoundUp(num_read_bits);
+        if (AddStatsObject(code_info_data)) {
+          std::lock_guard<std::mutex> lock(stats_lock_);
+          code_info.CollectSizeStats(code_info_data, stats_["CodeInfo"]);
+        }
+      }
+      vios->Stream() << StringPrintf("code_offset=0x%08x code_size=%u code_info_size=%zu\n",
+                                     code_offset,
+                                     code_size,
+                                     code_info_size);
+      return success;
+    }
+
     // Everything below is indented at least once.
     ScopedIndentation indent1(vios);
 
@@ -1182,6 +1301,7 @@ class OatDumper {
       uint32_t method_header_offset = oat_method.GetOatQuickMethodHeaderOffset();
       const OatQuickMethodHeader* method_header = oat_method.GetOatQuickMethodHeader();
       if (AddStatsObject(method_header)) {
+        std::lock_guard<std::mutex> lock(stats_lock_);
         stats_["QuickMethodHeader"].AddBytes(sizeof(*method_header));
       }
       if (options_.absolute_addresses_) {
@@ -1248,6 +1368,7 @@ class OatDumper {
         uint32_t aligned_code_begin = AlignCodeOffset(code_offset);
         uint64_t aligned_code_end = aligned_code_begin + code_size;
         if (AddStatsObject(code)) {
+          std::lock_guard<std::mutex> lock(stats_lock_);
           stats_["Code"].AddBytes(code_size);
         }
 
@@ -1276,7 +1397,7 @@ class OatDumper {
           success = false;
           if (options_.disassemble_code_) {
             if (aligned_code_begin + kPrologueBytes <= oat_file_.Size()) {
-              DumpCode(vios, oat_method, code_item_accessor, true, kPrologueBytes);
+              DumpCode(vios, oat_method, code_item_accessor, disasm, true, kPrologueBytes);
             }
           }
         } else if (code_size > kMaxCodeSize) {
@@ -1290,11 +1411,11 @@ class OatDumper {
           success = false;
           if (options_.disassemble_code_) {
             if (aligned_code_begin + kPrologueBytes <= oat_file_.Size()) {
-              DumpCode(vios, oat_method, code_item_accessor, true, kPrologueBytes);
+              DumpCode(vios, oat_method, code_item_accessor, disasm, true, kPrologueBytes);
             }
           }
         } else if (options_.disassemble_code_) {
-          DumpCode(vios, oat_method, code_item_accessor, !success, 0);
+          DumpCode(vios, oat_method, code_item_accessor, disasm, !success, 0);
         }
       }
     }
@@ -1504,6 +1625,7 @@ class OatDumper {
   void DumpCode(VariableIndentationOutputStream* vios,
                 const OatFile::OatMethod& oat_method,
                 const CodeItemDataAccessor& code_item_accessor,
+                Disassembler* disasm,
                 bool bad_input, size_t code_size) {
     const void* quick_code = oat_method.GetQuickCode();
 
@@ -1518,6 +1640,7 @@ class OatDumper {
       // The optimizing compiler outputs its CodeInfo data in the vmap table.
       CodeInfo code_info(oat_method.GetVmapTable());
       if (AddStatsObject(oat_method.GetVmapTable())) {
+        std::lock_guard<std::mutex> lock(stats_lock_);
         code_info.CollectSizeStats(oat_method.GetVmapTable(), stats_["CodeInfo"]);
       }
       std::unordered_map<uint32_t, std::vector<StackMap>> stack_maps;
@@ -1528,7 +1651,7 @@ class OatDumper {
       const uint8_t* quick_native_pc = reinterpret_cast<const uint8_t*>(quick_code);
       size_t offset = 0;
       while (offset < code_size) {
-        offset += disassembler_->Dump(vios->Stream(), quick_native_pc + offset);
+        offset += disasm->Dump(vios->Stream(), quick_native_pc + offset);
         auto it = stack_maps.find(offset);
         if (it != stack_maps.end()) {
           ScopedIndentation indent1(vios);
@@ -1543,7 +1666,7 @@ class OatDumper {
       const uint8_t* quick_native_pc = reinterpret_cast<const uint8_t*>(quick_code);
       size_t offset = 0;
       while (offset < code_size) {
-        offset += disassembler_->Dump(vios->Stream(), quick_native_pc + offset);
+        offset += disasm->Dump(vios->Stream(), quick_native_pc + offset);
       }
     }
   }
@@ -1678,6 +1801,9 @@ class OatDumper {
   const InstructionSet instruction_set_;
   std::set<uintptr_t> offsets_;
   Disassembler* disassembler_;
+  // Guards stats_ and seen_stats_objects_, which are shared by the worker threads of a parallel
+  // class dump.
+  std::mutex stats_lock_;
   Stats stats_;
   std::unordered_set<const void*> seen_stats_objects_;
 };
@@ -3079,6 +3205,14 @@ struct OatdumpArgs : public CmdlineArgs {
       disassemble_code_ = false;
     } else if (option =="--header-only") {
       dump_header_only_ = true;
+    } else if (option == "--summary-only") {
+      summary_only_ = true;
+    } else if (StartsWith(option, "--dump-threads=")) {
+      if (!android::base::ParseUint(raw_option + strlen("--dump-threads="), &dump_threads_) ||
+          dump_threads_ == 0u) {
+        *error_msg = "Dump thread count parsing failed";
+        return kParseError;
+      }
     } else if (StartsWith(option, "--symbolize=")) {
       oat_filename_ = raw_option + strlen("--symbolize=");
       symbolize_ = true;
@@ -3176,6 +3310,15 @@ struct OatdumpArgs : public CmdlineArgs {
         "  --header-only may be used to print only the oat header.\n"
         "      Example: --header-only\n"
         "\n"
+        "  --summary-only may be used to print one line per method with the code and CodeInfo\n"
+        "      sizes instead of the full method dump, e.g. for oat size tracking.\n"
+        "      Example: --summary-only\n"
+        "\n"
+        "  --dump-threads=<n> may be used to dump the classes of each oat dex file over n\n"
+        "      worker threads. The output is stitched back together in class order. Only\n"
+        "      effective when dumping runs without a runtime (plain --oat-file dumps).\n"
+        "      Example: --dump-threads=8\n"
+        "\n"
         "  --list-classes may be used to list target file classes (can be used with filters).\n"
         "      Example: --list-classes\n"
         "      Example: --list-classes --class-filter=com.example.foo\n"
@@ -3234,7 +3377,9 @@ struct OatdumpArgs : public CmdlineArgs {
   bool list_classes_ = false;
   bool list_methods_ = false;
   bool dump_header_only_ = false;
+  bool summary_only_ = false;
   bool imt_stat_dump_ = false;
+  uint32_t dump_threads_ = 1;
   uint32_t addr2instr_ = 0;
   const char* export_dex_location_ = nullptr;
   const char* app_image_ = nullptr;
@@ -3258,6 +3403,8 @@ struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
         args_->list_classes_,
         args_->list_methods_,
         args_->dump_header_only_,
+        args_->summary_only_,
+        args_->dump_threads_,
         args_->export_dex_location_,
         args_->app_image_,
         args_->app_oat_,
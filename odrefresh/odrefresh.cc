@@ -28,6 +28,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdlib>
@@ -36,11 +37,13 @@
 #include <iosfwd>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -1119,120 +1122,177 @@ class OnDeviceRefresh final {
     return true;
   }
 
-  WARN_UNUSED bool CompileSystemServerArtifacts(const std::string& staging_dir,
-                                                OdrMetrics& metrics,
-                                                uint32_t* dex2oat_invocation_count,
-                                                std::string* error_msg) const {
-    ScopedOdrCompilationTimer compilation_timer(metrics);
-    std::vector<std::string> classloader_context;
-
-    const std::string dex2oat = config_.GetDex2Oat();
+  // Compile the system_server jar at `jar_index` in `systemserver_compilable_jars_`. The class
+  // loader context of a jar consists of the jars preceding it on the system server classpath and
+  // encodes only their dex files, so a jar depends on the boot extension artifacts but not on the
+  // compiled artifacts of the preceding jars, and independent invocations can run concurrently.
+  // On failure, `failure_status` receives the OdrMetrics status the caller should report.
+  WARN_UNUSED bool CompileSystemServerJar(const std::string& staging_dir,
+                                          size_t jar_index,
+                                          /*out*/ OdrMetrics::Status* failure_status,
+                                          /*out*/ std::string* error_msg) const {
+    const std::string& jar = systemserver_compilable_jars_[jar_index];
     const InstructionSet isa = config_.GetSystemServerIsa();
-    for (const std::string& jar : systemserver_compilable_jars_) {
-      std::vector<std::string> args;
-      args.emplace_back(dex2oat);
-      args.emplace_back("--dex-file=" + jar);
-
-      AddDex2OatCommonOptions(&args);
-      AddDex2OatConcurrencyArguments(&args);
-      AddDex2OatDebugInfo(&args);
-      AddDex2OatInstructionSet(&args, isa);
-      const std::string jar_name(android::base::Basename(jar));
-      const std::string profile = Concatenate({GetAndroidRoot(), "/framework/", jar_name, ".prof"});
-      std::string compiler_filter =
-          android::base::GetProperty("dalvik.vm.systemservercompilerfilter", "speed");
-      if (compiler_filter == "speed-profile") {
-        AddDex2OatProfileAndCompilerFilter(&args, profile);
-      } else {
-        args.emplace_back("--compiler-filter=" + compiler_filter);
-      }
-
-      const std::string image_location = GetSystemServerImagePath(/*on_system=*/false, jar);
-      const std::string install_location = android::base::Dirname(image_location);
-      if (classloader_context.empty()) {
-        // All images are in the same directory, we only need to check on the first iteration.
-        if (!EnsureDirectoryExists(install_location)) {
-          metrics.SetStatus(OdrMetrics::Status::kIoError);
-          return false;
-        }
-      }
 
-      OdrArtifacts artifacts = OdrArtifacts::ForSystemServer(image_location);
-      CHECK_EQ(artifacts.OatPath(), GetApexDataOdexFilename(jar.c_str(), isa));
+    std::vector<std::string> args;
+    args.emplace_back(config_.GetDex2Oat());
+    args.emplace_back("--dex-file=" + jar);
 
-      const std::pair<const std::string, const char*> location_kind_pairs[] = {
-          std::make_pair(artifacts.ImagePath(), "app-image"),
-          std::make_pair(artifacts.OatPath(), "oat"),
-          std::make_pair(artifacts.VdexPath(), "output-vdex")
-      };
+    AddDex2OatCommonOptions(&args);
+    AddDex2OatConcurrencyArguments(&args);
+    AddDex2OatDebugInfo(&args);
+    AddDex2OatInstructionSet(&args, isa);
+    const std::string jar_name(android::base::Basename(jar));
+    const std::string profile = Concatenate({GetAndroidRoot(), "/framework/", jar_name, ".prof"});
+    std::string compiler_filter =
+        android::base::GetProperty("dalvik.vm.systemservercompilerfilter", "speed");
+    if (compiler_filter == "speed-profile") {
+      AddDex2OatProfileAndCompilerFilter(&args, profile);
+    } else {
+      args.emplace_back("--compiler-filter=" + compiler_filter);
+    }
 
-      std::vector<std::unique_ptr<File>> staging_files;
-      for (const auto& location_kind_pair : location_kind_pairs) {
-        auto& [location, kind] = location_kind_pair;
-        const std::string staging_location = GetStagingLocation(staging_dir, location);
-        std::unique_ptr<File> staging_file(OS::CreateEmptyFile(staging_location.c_str()));
-        if (staging_file == nullptr) {
-          PLOG(ERROR) << "Failed to create " << kind << " file: " << staging_location;
-          metrics.SetStatus(OdrMetrics::Status::kIoError);
-          EraseFiles(staging_files);
-          return false;
-        }
-        args.emplace_back(android::base::StringPrintf("--%s-fd=%d", kind, staging_file->Fd()));
-        staging_files.emplace_back(std::move(staging_file));
-      }
-      args.emplace_back("--oat-location=" + artifacts.OatPath());
-
-      if (!config_.GetUpdatableBcpPackagesFile().empty()) {
-        const std::string& bcp_packages = config_.GetUpdatableBcpPackagesFile();
-        if (!OS::FileExists(bcp_packages.c_str())) {
-          *error_msg = "Cannot compile system_server JARs: missing " + QuotePath(bcp_packages);
-          metrics.SetStatus(OdrMetrics::Status::kIoError);
-          EraseFiles(staging_files);
-          return false;
-        }
-        args.emplace_back("--updatable-bcp-packages-file=" + bcp_packages);
-      }
+    const std::string image_location = GetSystemServerImagePath(/*on_system=*/false, jar);
+    const std::string install_location = android::base::Dirname(image_location);
 
-      args.emplace_back("--runtime-arg");
-      args.emplace_back(Concatenate({"-Xbootclasspath:", config_.GetDex2oatBootClasspath()}));
-      const std::string context_path = android::base::Join(classloader_context, ':');
-      args.emplace_back(Concatenate({"--class-loader-context=PCL[", context_path, "]"}));
-      const std::string extension_image = GetBootImageExtensionImage(/*on_system=*/false);
-      args.emplace_back(Concatenate({"--boot-image=", GetBootImage(), ":", extension_image}));
+    OdrArtifacts artifacts = OdrArtifacts::ForSystemServer(image_location);
+    CHECK_EQ(artifacts.OatPath(), GetApexDataOdexFilename(jar.c_str(), isa));
 
-      const time_t timeout = GetSubprocessTimeout();
-      const std::string cmd_line = android::base::Join(args, ' ');
-      LOG(INFO) << "Compiling " << jar << ": " << cmd_line << " [timeout " << timeout << "s]";
-      if (config_.GetDryRun()) {
-        LOG(INFO) << "Compilation skipped (dry-run).";
-        return true;
-      }
+    const std::pair<const std::string, const char*> location_kind_pairs[] = {
+        std::make_pair(artifacts.ImagePath(), "app-image"),
+        std::make_pair(artifacts.OatPath(), "oat"),
+        std::make_pair(artifacts.VdexPath(), "output-vdex")
+    };
 
-      bool timed_out = false;
-      int dex2oat_exit_code = ExecAndReturnCode(args, timeout, &timed_out, error_msg);
-      if (dex2oat_exit_code != 0) {
-        if (timed_out) {
-          metrics.SetStatus(OdrMetrics::Status::kTimeLimitExceeded);
-        } else {
-          metrics.SetStatus(OdrMetrics::Status::kDex2OatError);
-        }
+    std::vector<std::unique_ptr<File>> staging_files;
+    for (const auto& location_kind_pair : location_kind_pairs) {
+      auto& [location, kind] = location_kind_pair;
+      const std::string staging_location = GetStagingLocation(staging_dir, location);
+      std::unique_ptr<File> staging_file(OS::CreateEmptyFile(staging_location.c_str()));
+      if (staging_file == nullptr) {
+        PLOG(ERROR) << "Failed to create " << kind << " file: " << staging_location;
+        *failure_status = OdrMetrics::Status::kIoError;
         EraseFiles(staging_files);
         return false;
       }
+      args.emplace_back(android::base::StringPrintf("--%s-fd=%d", kind, staging_file->Fd()));
+      staging_files.emplace_back(std::move(staging_file));
+    }
+    args.emplace_back("--oat-location=" + artifacts.OatPath());
 
-      if (!MoveOrEraseFiles(staging_files, install_location)) {
-        metrics.SetStatus(OdrMetrics::Status::kInstallFailed);
+    if (!config_.GetUpdatableBcpPackagesFile().empty()) {
+      const std::string& bcp_packages = config_.GetUpdatableBcpPackagesFile();
+      if (!OS::FileExists(bcp_packages.c_str())) {
+        *error_msg = "Cannot compile system_server JARs: missing " + QuotePath(bcp_packages);
+        *failure_status = OdrMetrics::Status::kIoError;
+        EraseFiles(staging_files);
         return false;
       }
+      args.emplace_back("--updatable-bcp-packages-file=" + bcp_packages);
+    }
+
+    args.emplace_back("--runtime-arg");
+    args.emplace_back(Concatenate({"-Xbootclasspath:", config_.GetDex2oatBootClasspath()}));
+    const std::vector<std::string> classloader_context(
+        systemserver_compilable_jars_.begin(),
+        systemserver_compilable_jars_.begin() + jar_index);
+    const std::string context_path = android::base::Join(classloader_context, ':');
+    args.emplace_back(Concatenate({"--class-loader-context=PCL[", context_path, "]"}));
+    const std::string extension_image = GetBootImageExtensionImage(/*on_system=*/false);
+    args.emplace_back(Concatenate({"--boot-image=", GetBootImage(), ":", extension_image}));
+
+    const time_t timeout = GetSubprocessTimeout();
+    const std::string cmd_line = android::base::Join(args, ' ');
+    LOG(INFO) << "Compiling " << jar << ": " << cmd_line << " [timeout " << timeout << "s]";
+    if (config_.GetDryRun()) {
+      LOG(INFO) << "Compilation skipped (dry-run).";
+      return true;
+    }
 
-      *dex2oat_invocation_count = *dex2oat_invocation_count + 1;
-      ReportNextBootAnimationProgress(*dex2oat_invocation_count);
-      classloader_context.emplace_back(jar);
+    bool timed_out = false;
+    int dex2oat_exit_code = ExecAndReturnCode(args, timeout, &timed_out, error_msg);
+    if (dex2oat_exit_code != 0) {
+      *failure_status = timed_out ? OdrMetrics::Status::kTimeLimitExceeded
+                                  : OdrMetrics::Status::kDex2OatError;
+      EraseFiles(staging_files);
+      return false;
+    }
+
+    if (!MoveOrEraseFiles(staging_files, install_location)) {
+      *failure_status = OdrMetrics::Status::kInstallFailed;
+      return false;
     }
 
     return true;
   }
 
+  WARN_UNUSED bool CompileSystemServerArtifacts(const std::string& staging_dir,
+                                                OdrMetrics& metrics,
+                                                uint32_t* dex2oat_invocation_count,
+                                                std::string* error_msg) const {
+    ScopedOdrCompilationTimer compilation_timer(metrics);
+    if (systemserver_compilable_jars_.empty()) {
+      return true;
+    }
+
+    // All images are installed in the same directory, so a single check suffices.
+    const std::string first_image_location =
+        GetSystemServerImagePath(/*on_system=*/false, systemserver_compilable_jars_.front());
+    if (!EnsureDirectoryExists(android::base::Dirname(first_image_location))) {
+      metrics.SetStatus(OdrMetrics::Status::kIoError);
+      return false;
+    }
+
+    if (config_.GetDryRun()) {
+      // A dry run logs the leading jar's command-line and stops, like the sequential code did.
+      OdrMetrics::Status failure_status = OdrMetrics::Status::kOK;
+      return CompileSystemServerJar(staging_dir, /*jar_index=*/0u, &failure_status, error_msg);
+    }
+
+    // The jars only depend on the boot extension image, so their dex2oat invocations can be
+    // pipelined across cores. Each subprocess still honors the dalvik.vm.boot-dex2oat-*
+    // concurrency settings, so cap the number of concurrent invocations to keep the core
+    // oversubscription modest.
+    const size_t num_workers =
+        std::min<size_t>(systemserver_compilable_jars_.size(),
+                         std::max<size_t>(std::thread::hardware_concurrency() / 2u, 1u));
+    std::atomic<size_t> next_jar_index(0u);
+    std::atomic<bool> success(true);
+    std::mutex results_mutex;
+    auto worker = [&]() {
+      while (true) {
+        const size_t jar_index = next_jar_index.fetch_add(1u);
+        if (jar_index >= systemserver_compilable_jars_.size() || !success.load()) {
+          break;
+        }
+        OdrMetrics::Status failure_status = OdrMetrics::Status::kOK;
+        std::string jar_error_msg;
+        if (CompileSystemServerJar(staging_dir, jar_index, &failure_status, &jar_error_msg)) {
+          std::lock_guard<std::mutex> lock(results_mutex);
+          *dex2oat_invocation_count = *dex2oat_invocation_count + 1;
+          ReportNextBootAnimationProgress(*dex2oat_invocation_count);
+        } else {
+          std::lock_guard<std::mutex> lock(results_mutex);
+          // Report the first failure; jobs already running are left to finish.
+          if (success.exchange(false)) {
+            metrics.SetStatus(failure_status);
+            *error_msg = jar_error_msg;
+          }
+        }
+      }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1u; i != num_workers; ++i) {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& w : workers) {
+      w.join();
+    }
+
+    return success.load();
+  }
+
   void ReportNextBootAnimationProgress(uint32_t current_compilation) const {
     uint32_t number_of_compilations =
         config_.GetBootExtensionIsas().size() + systemserver_compilable_jars_.size();
@@ -1293,6 +1353,15 @@ class OnDeviceRefresh final {
 
     const auto& bcp_instruction_sets = config_.GetBootExtensionIsas();
     DCHECK(!bcp_instruction_sets.empty() && bcp_instruction_sets.size() <= 2);
+
+    // The system_server artifact check only stats files on /data and does not depend on the boot
+    // extension outputs, so overlap its I/O with the boot extension compilations.
+    bool systemserver_artifacts_exist = false;
+    std::string systemserver_check_error_msg;
+    std::thread systemserver_check([&]() {
+      systemserver_artifacts_exist = SystemServerArtifactsExistOnData(&systemserver_check_error_msg);
+    });
+
     for (const InstructionSet isa : bcp_instruction_sets) {
       auto stage = (isa == bcp_instruction_sets.front()) ?
                        OdrMetrics::Stage::kPrimaryBootClasspath :
@@ -1302,18 +1371,21 @@ class OnDeviceRefresh final {
         // Remove artifacts we are about to generate. Ordinarily these are removed in the checking
         // step, but this is not always run (e.g. during manual testing).
         if (!RemoveBootExtensionArtifactsFromData(isa)) {
+            systemserver_check.join();
             return ExitCode::kCleanupFailed;
         }
 
         if (!CheckCompilationSpace()) {
           metrics.SetStatus(OdrMetrics::Status::kNoSpace);
           // Return kOkay so odsign will keep and sign whatever we have been able to compile.
+          systemserver_check.join();
           return ExitCode::kOkay;
         }
 
         if (!CompileBootExtensionArtifacts(
                 isa, staging_dir, metrics, &dex2oat_invocation_count, &error_msg)) {
           LOG(ERROR) << "Compilation of BCP failed: " << error_msg;
+          systemserver_check.join();
           if (!config_.GetDryRun() && !CleanDirectory(staging_dir)) {
             return ExitCode::kCleanupFailed;
           }
@@ -1322,7 +1394,8 @@ class OnDeviceRefresh final {
       }
     }
 
-    if (force_compile || !SystemServerArtifactsExistOnData(&error_msg)) {
+    systemserver_check.join();
+    if (force_compile || !systemserver_artifacts_exist) {
       metrics.SetStage(OdrMetrics::Stage::kSystemServerClasspath);
 
       if (!CheckCompilationSpace()) {
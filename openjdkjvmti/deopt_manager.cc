@@ -32,6 +32,7 @@
 #include <functional>
 #include <iosfwd>
 #include <mutex>
+#include <vector>
 
 #include "deopt_manager.h"
 
@@ -39,6 +40,7 @@
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/mutex-inl.h"
+#include "class_linker.h"
 #include "dex/dex_file_annotations.h"
 #include "dex/modifiers.h"
 #include "events-inl.h"
@@ -70,14 +72,17 @@ bool JvmtiMethodInspectionCallback::IsMethodBeingInspected(art::ArtMethod* metho
   // Non-java-debuggable runtimes we need to assume that any method might not be debuggable and
   // therefore potentially being inspected (due to inlines). If we are debuggable we rely hard on
   // inlining not being done since we don't keep track of which methods get inlined where and simply
-  // look to see if the method is breakpointed.
+  // look to see if the method is breakpointed. Breakpoints are tracked on the canonical method, so
+  // copied default-method implementations need to be mapped back before the lookup.
   return !art::Runtime::Current()->IsJavaDebuggable() ||
       manager_->HaveLocalsChanged() ||
-      manager_->MethodHasBreakpoints(method);
+      manager_->MethodHasBreakpoints(method->GetCanonicalMethod());
 }
 
 bool JvmtiMethodInspectionCallback::IsMethodSafeToJit(art::ArtMethod* method) {
-  return !manager_->MethodHasBreakpoints(method);
+  // Also keep the jit away from copies of a breakpointed default method; they execute the same
+  // code item as the canonical method and must stay in the interpreter.
+  return !manager_->MethodHasBreakpoints(method->GetCanonicalMethod());
 }
 
 bool JvmtiMethodInspectionCallback::MethodNeedsDebugVersion(
@@ -265,7 +270,7 @@ void DeoptManager::AddMethodBreakpoint(art::ArtMethod* method) {
     deoptimization_status_lock_.ExclusiveUnlock(self);
     return;
   } else if (is_default) {
-    AddDeoptimizeAllMethodsLocked(self);
+    PerformDefaultMethodDeoptimization(self, method);
   } else {
     PerformLimitedDeoptimization(self, method);
   }
@@ -302,7 +307,7 @@ void DeoptManager::RemoveMethodBreakpoint(art::ArtMethod* method) {
     return;
   } else if (is_last_breakpoint) {
     if (UNLIKELY(is_default)) {
-      RemoveDeoptimizeAllMethodsLocked(self);
+      PerformDefaultMethodUndeoptimization(self, method);
     } else {
       PerformLimitedUndeoptimization(self, method);
     }
@@ -397,6 +402,76 @@ void DeoptManager::PerformLimitedUndeoptimization(art::Thread* self, art::ArtMet
   art::Runtime::Current()->GetInstrumentation()->Undeoptimize(method);
 }
 
+namespace {
+
+// Collects the copied implementations that interface linking placed in classes implementing the
+// interface declaring `canonical`. The canonical method itself is not part of the result.
+class CollectDefaultMethodCopiesVisitor : public art::ClassVisitor {
+ public:
+  explicit CollectDefaultMethodCopiesVisitor(art::ArtMethod* canonical) : canonical_(canonical) {}
+
+  bool operator()(art::ObjPtr<art::mirror::Class> klass)
+      override REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    // Copied methods are only set up once a class reaches the resolved status.
+    if (klass->IsResolved()) {
+      for (art::ArtMethod& m : klass->GetCopiedMethods(art::kRuntimePointerSize)) {
+        if (m.GetCanonicalMethod() == canonical_) {
+          copies_.push_back(&m);
+        }
+      }
+    }
+    return true;
+  }
+
+  const std::vector<art::ArtMethod*>& GetCopies() const {
+    return copies_;
+  }
+
+ private:
+  art::ArtMethod* const canonical_;
+  std::vector<art::ArtMethod*> copies_;
+};
+
+}  // namespace
+
+void DeoptManager::PerformDefaultMethodDeoptimization(art::Thread* self, art::ArtMethod* method) {
+  DCHECK(method->IsDefault());
+  ScopedDeoptimizationContext sdc(self, this);
+  art::Runtime* runtime = art::Runtime::Current();
+  art::instrumentation::Instrumentation* instrumentation = runtime->GetInstrumentation();
+  // Deoptimize the interface method itself (invoke-super can target it directly) and every copy
+  // currently spread into an implementing class. Classes linked after this point inherit the
+  // deoptimized entrypoint when ArtMethod::CopyFrom copies the interface method, and the
+  // inspection callback above keeps the jit away from such copies, so they execute in the
+  // interpreter without any extra bookkeeping here.
+  instrumentation->Deoptimize(method);
+  CollectDefaultMethodCopiesVisitor visitor(method);
+  runtime->GetClassLinker()->VisitClasses(&visitor);
+  for (art::ArtMethod* copy : visitor.GetCopies()) {
+    instrumentation->Deoptimize(copy);
+  }
+}
+
+void DeoptManager::PerformDefaultMethodUndeoptimization(art::Thread* self, art::ArtMethod* method) {
+  DCHECK(method->IsDefault());
+  ScopedDeoptimizationContext sdc(self, this);
+  art::Runtime* runtime = art::Runtime::Current();
+  art::instrumentation::Instrumentation* instrumentation = runtime->GetInstrumentation();
+  instrumentation->Undeoptimize(method);
+  CollectDefaultMethodCopiesVisitor visitor(method);
+  runtime->GetClassLinker()->VisitClasses(&visitor);
+  for (art::ArtMethod* copy : visitor.GetCopies()) {
+    if (instrumentation->IsDeoptimized(copy)) {
+      instrumentation->Undeoptimize(copy);
+    } else {
+      // A copy created while the breakpoint was live inherited the deoptimized entrypoint from
+      // the interface method but was never registered; recompute the entrypoint it should have
+      // under the current instrumentation level.
+      instrumentation->InstallStubsForMethod(copy);
+    }
+  }
+}
+
 void DeoptManager::PerformGlobalDeoptimization(art::Thread* self) {
   ScopedDeoptimizationContext sdc(self, this);
   art::Runtime::Current()->GetInstrumentation()->DeoptimizeEverything(
@@ -168,6 +168,16 @@ class DeoptManager {
       RELEASE(deoptimization_status_lock_)
       REQUIRES(!art::Roles::uninterruptible_, !art::Locks::mutator_lock_);
 
+  // Deoptimize a breakpointed default method together with the copies interface linking placed in
+  // the implementing classes, instead of deoptimizing the whole world.
+  void PerformDefaultMethodDeoptimization(art::Thread* self, art::ArtMethod* method)
+      RELEASE(deoptimization_status_lock_)
+      REQUIRES(!art::Roles::uninterruptible_, !art::Locks::mutator_lock_);
+
+  void PerformDefaultMethodUndeoptimization(art::Thread* self, art::ArtMethod* method)
+      RELEASE(deoptimization_status_lock_)
+      REQUIRES(!art::Roles::uninterruptible_, !art::Locks::mutator_lock_);
+
   static constexpr const char* kDeoptManagerInstrumentationKey = "JVMTI_DeoptManager";
 
   art::Mutex deoptimization_status_lock_ ACQUIRED_BEFORE(art::Locks::classlinker_classes_lock_);
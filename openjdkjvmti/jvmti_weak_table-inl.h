@@ -35,6 +35,8 @@
 #include "jvmti_weak_table.h"
 
 #include <limits>
+#include <utility>
+#include <vector>
 
 #include <android-base/logging.h>
 
@@ -65,8 +67,6 @@ void JvmtiWeakTable<T>::AssertLocked() {
 
 template <typename T>
 void JvmtiWeakTable<T>::UpdateTableWithReadBarrier() {
-  update_since_last_sweep_ = true;
-
   auto WithReadBarrierUpdater = [&](const art::GcRoot<art::mirror::Object>& original_root,
                                     art::mirror::Object* original_obj ATTRIBUTE_UNUSED)
      REQUIRES_SHARED(art::Locks::mutator_lock_) {
@@ -74,25 +74,71 @@ void JvmtiWeakTable<T>::UpdateTableWithReadBarrier() {
   };
 
   UpdateTableWith<decltype(WithReadBarrierUpdater), kIgnoreNull>(WithReadBarrierUpdater);
+
+  // Publish only once all shards are consistent again; per-object slow paths serialize on
+  // update_lock_ and re-check the flag, so they cannot observe a half-done update.
+  update_since_last_sweep_.store(true, std::memory_order_release);
+}
+
+template <typename T>
+bool JvmtiWeakTable<T>::GetTagImpl(art::Thread* self,
+                                   art::ObjPtr<art::mirror::Object> obj,
+                                   T* result) {
+  {
+    Shard& shard = ShardFor(obj.Ptr());
+    art::MutexLock mu(self, shard.lock);
+    auto it = shard.map.find(art::GcRoot<art::mirror::Object>(obj));
+    if (it != shard.map.end()) {
+      *result = it->second;
+      return true;
+    }
+  }
+
+  // Performance optimization: To avoid multiple table updates, ensure that during GC we
+  // only update once. See the comment on the implementation of GetTagSlowPath.
+  if (art::kUseReadBarrier &&
+      self != nullptr &&
+      self->GetIsGcMarking() &&
+      !update_since_last_sweep_.load(std::memory_order_acquire)) {
+    return GetTagSlowPath(self, obj, result);
+  }
+
+  return false;
 }
 
 template <typename T>
-bool JvmtiWeakTable<T>::GetTagSlowPath(art::Thread* self, art::ObjPtr<art::mirror::Object> obj, T* result) {
+bool JvmtiWeakTable<T>::GetTagSlowPath(art::Thread* self,
+                                       art::ObjPtr<art::mirror::Object> obj,
+                                       T* result) {
   // Under concurrent GC, there is a window between moving objects and sweeping of system
   // weaks in which mutators are active. We may receive a to-space object pointer in obj,
   // but still have from-space pointers in the table. Explicitly update the table once.
   // Note: this will keep *all* objects in the table live, but should be a rare occurrence.
-  UpdateTableWithReadBarrier();
-  return GetTagLocked(self, obj, result);
+  art::MutexLock mu(self, update_lock_);
+  if (!update_since_last_sweep_.load(std::memory_order_relaxed)) {
+    UpdateTableWithReadBarrier();
+  }
+  Shard& shard = ShardFor(obj.Ptr());
+  art::MutexLock mu2(self, shard.lock);
+  auto it = shard.map.find(art::GcRoot<art::mirror::Object>(obj));
+  if (it != shard.map.end()) {
+    *result = it->second;
+    return true;
+  }
+  return false;
 }
 
 template <typename T>
 bool JvmtiWeakTable<T>::Remove(art::ObjPtr<art::mirror::Object> obj, /* out */ T* tag) {
   art::Thread* self = art::Thread::Current();
+  // See GetTag for why the shards may be used directly when weak-ref access is enabled.
+  if (art::kUseReadBarrier && self != nullptr && LIKELY(self->GetWeakRefAccessEnabled())) {
+    return RemoveImpl(self, obj, tag);
+  }
   art::MutexLock mu(self, allow_disallow_lock_);
   Wait(self);
 
-  return RemoveLocked(self, obj, tag);
+  return RemoveImpl(self, obj, tag);
 }
 template <typename T>
 bool JvmtiWeakTable<T>::RemoveLocked(art::ObjPtr<art::mirror::Object> obj, T* tag) {
@@ -100,31 +146,49 @@ bool JvmtiWeakTable<T>::RemoveLocked(art::ObjPtr<art::mirror::Object> obj, T* ta
   allow_disallow_lock_.AssertHeld(self);
   Wait(self);
 
-  return RemoveLocked(self, obj, tag);
+  return RemoveImpl(self, obj, tag);
 }
 
 template <typename T>
-bool JvmtiWeakTable<T>::RemoveLocked(art::Thread* self, art::ObjPtr<art::mirror::Object> obj, T* tag) {
-  auto it = tagged_objects_.find(art::GcRoot<art::mirror::Object>(obj));
-  if (it != tagged_objects_.end()) {
-    if (tag != nullptr) {
-      *tag = it->second;
+bool JvmtiWeakTable<T>::RemoveImpl(art::Thread* self,
+                                   art::ObjPtr<art::mirror::Object> obj,
+                                   T* tag) {
+  {
+    Shard& shard = ShardFor(obj.Ptr());
+    art::MutexLock mu(self, shard.lock);
+    auto it = shard.map.find(art::GcRoot<art::mirror::Object>(obj));
+    if (it != shard.map.end()) {
+      if (tag != nullptr) {
+        *tag = it->second;
+      }
+      shard.map.erase(it);
+      return true;
     }
-    tagged_objects_.erase(it);
-    return true;
   }
 
-  if (art::kUseReadBarrier && self->GetIsGcMarking() && !update_since_last_sweep_) {
+  if (art::kUseReadBarrier &&
+      self->GetIsGcMarking() &&
+      !update_since_last_sweep_.load(std::memory_order_acquire)) {
     // Under concurrent GC, there is a window between moving objects and sweeping of system
     // weaks in which mutators are active. We may receive a to-space object pointer in obj,
     // but still have from-space pointers in the table. Explicitly update the table once.
     // Note: this will keep *all* objects in the table live, but should be a rare occurrence.
-
-    // Update the table.
-    UpdateTableWithReadBarrier();
+    art::MutexLock mu(self, update_lock_);
+    if (!update_since_last_sweep_.load(std::memory_order_relaxed)) {
+      UpdateTableWithReadBarrier();
+    }
 
     // And try again.
-    return RemoveLocked(self, obj, tag);
+    Shard& shard = ShardFor(obj.Ptr());
+    art::MutexLock mu2(self, shard.lock);
+    auto it = shard.map.find(art::GcRoot<art::mirror::Object>(obj));
+    if (it != shard.map.end()) {
+      if (tag != nullptr) {
+        *tag = it->second;
+      }
+      shard.map.erase(it);
+      return true;
+    }
   }
 
   // Not in here.
@@ -134,10 +198,14 @@ bool JvmtiWeakTable<T>::RemoveLocked(art::Thread* self, art::ObjPtr<art::mirror:
 template <typename T>
 bool JvmtiWeakTable<T>::Set(art::ObjPtr<art::mirror::Object> obj, T new_tag) {
   art::Thread* self = art::Thread::Current();
+  // See GetTag for why the shards may be used directly when weak-ref access is enabled.
+  if (art::kUseReadBarrier && self != nullptr && LIKELY(self->GetWeakRefAccessEnabled())) {
+    return SetImpl(self, obj, new_tag);
+  }
   art::MutexLock mu(self, allow_disallow_lock_);
   Wait(self);
 
-  return SetLocked(self, obj, new_tag);
+  return SetImpl(self, obj, new_tag);
 }
 template <typename T>
 bool JvmtiWeakTable<T>::SetLocked(art::ObjPtr<art::mirror::Object> obj, T new_tag) {
@@ -145,32 +213,52 @@ bool JvmtiWeakTable<T>::SetLocked(art::ObjPtr<art::mirror::Object> obj, T new_ta
   allow_disallow_lock_.AssertHeld(self);
   Wait(self);
 
-  return SetLocked(self, obj, new_tag);
+  return SetImpl(self, obj, new_tag);
 }
 
 template <typename T>
-bool JvmtiWeakTable<T>::SetLocked(art::Thread* self, art::ObjPtr<art::mirror::Object> obj, T new_tag) {
-  auto it = tagged_objects_.find(art::GcRoot<art::mirror::Object>(obj));
-  if (it != tagged_objects_.end()) {
-    it->second = new_tag;
-    return true;
-  }
+bool JvmtiWeakTable<T>::SetImpl(art::Thread* self,
+                                art::ObjPtr<art::mirror::Object> obj,
+                                T new_tag) {
+  {
+    Shard& shard = ShardFor(obj.Ptr());
+    art::MutexLock mu(self, shard.lock);
+    auto it = shard.map.find(art::GcRoot<art::mirror::Object>(obj));
+    if (it != shard.map.end()) {
+      it->second = new_tag;
+      return true;
+    }
 
-  if (art::kUseReadBarrier && self->GetIsGcMarking() && !update_since_last_sweep_) {
-    // Under concurrent GC, there is a window between moving objects and sweeping of system
-    // weaks in which mutators are active. We may receive a to-space object pointer in obj,
-    // but still have from-space pointers in the table. Explicitly update the table once.
-    // Note: this will keep *all* objects in the table live, but should be a rare occurrence.
+    if (!art::kUseReadBarrier ||
+        !self->GetIsGcMarking() ||
+        update_since_last_sweep_.load(std::memory_order_acquire)) {
+      // New element.
+      auto insert_it = shard.map.emplace(art::GcRoot<art::mirror::Object>(obj), new_tag);
+      DCHECK(insert_it.second);
+      return false;
+    }
+  }
 
-    // Update the table.
+  // Under concurrent GC, there is a window between moving objects and sweeping of system
+  // weaks in which mutators are active. We may receive a to-space object pointer in obj,
+  // but still have from-space pointers in the table. Explicitly update the table once.
+  // Note: this will keep *all* objects in the table live, but should be a rare occurrence.
+  art::MutexLock mu(self, update_lock_);
+  if (!update_since_last_sweep_.load(std::memory_order_relaxed)) {
     UpdateTableWithReadBarrier();
+  }
 
-    // And try again.
-    return SetLocked(self, obj, new_tag);
+  // And try again.
+  Shard& shard = ShardFor(obj.Ptr());
+  art::MutexLock mu2(self, shard.lock);
+  auto it = shard.map.find(art::GcRoot<art::mirror::Object>(obj));
+  if (it != shard.map.end()) {
+    it->second = new_tag;
+    return true;
   }
 
   // New element.
-  auto insert_it = tagged_objects_.emplace(art::GcRoot<art::mirror::Object>(obj), new_tag);
+  auto insert_it = shard.map.emplace(art::GcRoot<art::mirror::Object>(obj), new_tag);
   DCHECK(insert_it.second);
   return false;
 }
@@ -189,14 +277,14 @@ void JvmtiWeakTable<T>::Sweep(art::IsMarkedVisitor* visitor) {
   // to ensure we compare against to-space pointers. But we want to do this only once. Once
   // sweeping is done, we know all objects are to-space pointers until the next GC cycle,
   // so we re-enable the explicit update for the next marking.
-  update_since_last_sweep_ = false;
+  update_since_last_sweep_.store(false, std::memory_order_release);
 }
 
 template <typename T>
 template <bool kHandleNull>
 void JvmtiWeakTable<T>::SweepImpl(art::IsMarkedVisitor* visitor) {
   art::Thread* self = art::Thread::Current();
-  art::MutexLock mu(self, allow_disallow_lock_);
+  art::MutexLock mu(self, update_lock_);
 
   auto IsMarkedUpdater = [&](const art::GcRoot<art::mirror::Object>& original_root ATTRIBUTE_UNUSED,
                              art::mirror::Object* original_obj) {
@@ -210,38 +298,59 @@ void JvmtiWeakTable<T>::SweepImpl(art::IsMarkedVisitor* visitor) {
 template <typename T>
 template <typename Updater, typename JvmtiWeakTable<T>::TableUpdateNullTarget kTargetNull>
 ALWAYS_INLINE inline void JvmtiWeakTable<T>::UpdateTableWith(Updater& updater) {
-  // We optimistically hope that elements will still be well-distributed when re-inserting them.
-  // So play with the map mechanics, and postpone rehashing. This avoids the need of a side
-  // vector and two passes.
-  float original_max_load_factor = tagged_objects_.max_load_factor();
-  tagged_objects_.max_load_factor(std::numeric_limits<float>::max());
-  // For checking that a max load-factor actually does what we expect.
-  size_t original_bucket_count = tagged_objects_.bucket_count();
-
-  for (auto it = tagged_objects_.begin(); it != tagged_objects_.end();) {
-    DCHECK(!it->first.IsNull());
-    art::mirror::Object* original_obj = it->first.template Read<art::kWithoutReadBarrier>();
-    art::mirror::Object* target_obj = updater(it->first, original_obj);
-    if (original_obj != target_obj) {
-      if (kTargetNull == kIgnoreNull && target_obj == nullptr) {
-        // Ignore null target, don't do anything.
-      } else {
-        T tag = it->second;
-        it = tagged_objects_.erase(it);
-        if (target_obj != nullptr) {
-          tagged_objects_.emplace(art::GcRoot<art::mirror::Object>(target_obj), tag);
-          DCHECK_EQ(original_bucket_count, tagged_objects_.bucket_count());
-        } else if (kTargetNull == kCallHandleNull) {
-          HandleNullSweep(tag);
+  art::Thread* self = art::Thread::Current();
+  // Entries whose updated pointer belongs to a different shard are collected here and
+  // re-inserted after the batch for their original shard is done, so that only one shard
+  // lock is held at a time.
+  std::vector<std::pair<art::mirror::Object*, T>> migrated;
+
+  for (size_t i = 0; i != kNumShards; ++i) {
+    Shard& shard = shards_[i];
+    art::MutexLock mu(self, shard.lock);
+
+    // We optimistically hope that elements will still be well-distributed when re-inserting them.
+    // So play with the map mechanics, and postpone rehashing. This avoids the need of a second
+    // pass over entries that stay within their shard.
+    float original_max_load_factor = shard.map.max_load_factor();
+    shard.map.max_load_factor(std::numeric_limits<float>::max());
+    // For checking that a max load-factor actually does what we expect.
+    size_t original_bucket_count = shard.map.bucket_count();
+
+    for (auto it = shard.map.begin(); it != shard.map.end();) {
+      DCHECK(!it->first.IsNull());
+      art::mirror::Object* original_obj = it->first.template Read<art::kWithoutReadBarrier>();
+      art::mirror::Object* target_obj = updater(it->first, original_obj);
+      if (original_obj != target_obj) {
+        if (kTargetNull == kIgnoreNull && target_obj == nullptr) {
+          // Ignore null target, don't do anything.
+        } else {
+          T tag = it->second;
+          it = shard.map.erase(it);
+          if (target_obj != nullptr) {
+            if (&ShardFor(target_obj) == &shard) {
+              shard.map.emplace(art::GcRoot<art::mirror::Object>(target_obj), tag);
+              DCHECK_EQ(original_bucket_count, shard.map.bucket_count());
+            } else {
+              migrated.emplace_back(target_obj, tag);
+            }
+          } else if (kTargetNull == kCallHandleNull) {
+            HandleNullSweep(tag);
+          }
+          continue;  // Iterator was implicitly updated by erase.
         }
-        continue;  // Iterator was implicitly updated by erase.
       }
+      it++;
     }
-    it++;
+
+    shard.map.max_load_factor(original_max_load_factor);
+    // TODO: consider rehash here.
   }
 
-  tagged_objects_.max_load_factor(original_max_load_factor);
-  // TODO: consider rehash here.
+  for (const auto& pair : migrated) {
+    Shard& shard = ShardFor(pair.first);
+    art::MutexLock mu(self, shard.lock);
+    shard.map.emplace(art::GcRoot<art::mirror::Object>(pair.first), pair.second);
+  }
 }
 
 template <typename T>
@@ -336,8 +445,13 @@ jvmtiError JvmtiWeakTable<T>::GetTaggedObjects(jvmtiEnv* jvmti_env,
   size_t initial_object_size;
   size_t initial_tag_size;
   if (tag_count == 0) {
-    initial_object_size = (object_result_ptr != nullptr) ? tagged_objects_.size() : 0;
-    initial_tag_size = (tag_result_ptr != nullptr) ? tagged_objects_.size() : 0;
+    size_t table_size = 0;
+    for (Shard& shard : shards_) {
+      art::MutexLock shard_mu(self, shard.lock);
+      table_size += shard.map.size();
+    }
+    initial_object_size = (object_result_ptr != nullptr) ? table_size : 0;
+    initial_tag_size = (tag_result_ptr != nullptr) ? table_size : 0;
   } else {
     initial_object_size = initial_tag_size = kDefaultSize;
   }
@@ -347,29 +461,32 @@ jvmtiError JvmtiWeakTable<T>::GetTaggedObjects(jvmtiEnv* jvmti_env,
   ReleasableContainer<T, JvmtiAllocator<T>> selected_tags(allocator, initial_tag_size);
 
   size_t count = 0;
-  for (auto& pair : tagged_objects_) {
-    bool select;
-    if (tag_count > 0) {
-      select = false;
-      for (size_t i = 0; i != static_cast<size_t>(tag_count); ++i) {
-        if (tags[i] == pair.second) {
-          select = true;
-          break;
+  for (Shard& shard : shards_) {
+    art::MutexLock shard_mu(self, shard.lock);
+    for (auto& pair : shard.map) {
+      bool select;
+      if (tag_count > 0) {
+        select = false;
+        for (size_t i = 0; i != static_cast<size_t>(tag_count); ++i) {
+          if (tags[i] == pair.second) {
+            select = true;
+            break;
+          }
         }
+      } else {
+        select = true;
       }
-    } else {
-      select = true;
-    }
 
-    if (select) {
-      art::ObjPtr<art::mirror::Object> obj = pair.first.template Read<art::kWithReadBarrier>();
-      if (obj != nullptr) {
-        count++;
-        if (object_result_ptr != nullptr) {
-          selected_objects.Pushback(jni_env->AddLocalReference<jobject>(obj));
-        }
-        if (tag_result_ptr != nullptr) {
-          selected_tags.Pushback(pair.second);
+      if (select) {
+        art::ObjPtr<art::mirror::Object> obj = pair.first.template Read<art::kWithReadBarrier>();
+        if (obj != nullptr) {
+          count++;
+          if (object_result_ptr != nullptr) {
+            selected_objects.Pushback(jni_env->AddLocalReference<jobject>(obj));
+          }
+          if (tag_result_ptr != nullptr) {
+            selected_tags.Pushback(pair.second);
+          }
         }
       }
     }
@@ -391,11 +508,14 @@ art::ObjPtr<art::mirror::Object> JvmtiWeakTable<T>::Find(T tag) {
   art::MutexLock mu(self, allow_disallow_lock_);
   Wait(self);
 
-  for (auto& pair : tagged_objects_) {
-    if (tag == pair.second) {
-      art::ObjPtr<art::mirror::Object> obj = pair.first.template Read<art::kWithReadBarrier>();
-      if (obj != nullptr) {
-        return obj;
+  for (Shard& shard : shards_) {
+    art::MutexLock shard_mu(self, shard.lock);
+    for (auto& pair : shard.map) {
+      if (tag == pair.second) {
+        art::ObjPtr<art::mirror::Object> obj = pair.first.template Read<art::kWithReadBarrier>();
+        if (obj != nullptr) {
+          return obj;
+        }
       }
     }
   }
@@ -32,6 +32,7 @@
 #ifndef ART_OPENJDKJVMTI_JVMTI_WEAK_TABLE_H_
 #define ART_OPENJDKJVMTI_JVMTI_WEAK_TABLE_H_
 
+#include <atomic>
 #include <unordered_map>
 
 #include "base/globals.h"
@@ -50,11 +51,18 @@ class EventHandler;
 
 // A system-weak container mapping objects to elements of the template type. This corresponds
 // to a weak hash map. For historical reasons the stored value is called "tag."
+//
+// The mapping is sharded by object address so that per-object operations from different threads
+// (e.g. heap-iteration callbacks querying tags while application threads set them) mostly take
+// different locks. The inherited allow_disallow_lock_ only implements the system-weak access
+// protocol (and the coarse Lock()/Unlock() API below); with the concurrent-copying collector,
+// readers whose weak-ref access is enabled do not need to take it at all.
 template <typename T>
 class JvmtiWeakTable : public art::gc::SystemWeakHolder {
  public:
   JvmtiWeakTable()
       : art::gc::SystemWeakHolder(art::kTaggingLockLevel),
+        update_lock_("JVMTI weak table update lock", art::kTaggingUpdateLock),
         update_since_last_sweep_(false) {
   }
 
@@ -82,10 +90,16 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
       REQUIRES_SHARED(art::Locks::mutator_lock_)
       REQUIRES(!allow_disallow_lock_) {
     art::Thread* self = art::Thread::Current();
+    // Fast path: with the concurrent-copying collector the GC runs a checkpoint on all threads
+    // before disabling weak-ref access, so a reader that observes enabled access can use the
+    // shards directly. This mirrors JavaVMExt::DecodeWeakGlobal.
+    if (art::kUseReadBarrier && self != nullptr && LIKELY(self->GetWeakRefAccessEnabled())) {
+      return GetTagImpl(self, obj, result);
+    }
     art::MutexLock mu(self, allow_disallow_lock_);
     Wait(self);
 
-    return GetTagLocked(self, obj, result);
+    return GetTagImpl(self, obj, result);
   }
   bool GetTagLocked(art::ObjPtr<art::mirror::Object> obj, /* out */ T* result)
       REQUIRES_SHARED(art::Locks::mutator_lock_)
@@ -94,7 +108,7 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
     allow_disallow_lock_.AssertHeld(self);
     Wait(self);
 
-    return GetTagLocked(self, obj, result);
+    return GetTagImpl(self, obj, result);
   }
 
   // Sweep the container. DO NOT CALL MANUALLY.
@@ -131,55 +145,75 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
   virtual void HandleNullSweep(T tag ATTRIBUTE_UNUSED) {}
 
  private:
+  struct HashGcRoot {
+    size_t operator()(const art::GcRoot<art::mirror::Object>& r) const
+        REQUIRES_SHARED(art::Locks::mutator_lock_) {
+      return reinterpret_cast<uintptr_t>(r.Read<art::kWithoutReadBarrier>());
+    }
+  };
+
+  struct EqGcRoot {
+    bool operator()(const art::GcRoot<art::mirror::Object>& r1,
+                    const art::GcRoot<art::mirror::Object>& r2) const
+        REQUIRES_SHARED(art::Locks::mutator_lock_) {
+      return r1.Read<art::kWithoutReadBarrier>() == r2.Read<art::kWithoutReadBarrier>();
+    }
+  };
+
+  using TagAllocator = JvmtiAllocator<std::pair<const art::GcRoot<art::mirror::Object>, T>>;
+  using TagMap = std::unordered_map<art::GcRoot<art::mirror::Object>,
+                                    T,
+                                    HashGcRoot,
+                                    EqGcRoot,
+                                    TagAllocator>;
+
+  // The number of independently locked map shards. Must be a power of two.
+  static constexpr size_t kNumShards = 8;
+
+  struct Shard {
+    Shard() : lock("JVMTI weak table shard lock", art::kTaggingShardLock) {}
+
+    art::Mutex lock;
+    TagMap map GUARDED_BY(lock);
+  };
+
+  ALWAYS_INLINE Shard& ShardFor(art::mirror::Object* obj) {
+    // Objects are at least kObjectAlignment-aligned, so drop the always-zero low bits.
+    return shards_[(reinterpret_cast<uintptr_t>(obj) / art::kObjectAlignment) % kNumShards];
+  }
+
   ALWAYS_INLINE
-  bool SetLocked(art::Thread* self, art::ObjPtr<art::mirror::Object> obj, T tag)
+  bool SetImpl(art::Thread* self, art::ObjPtr<art::mirror::Object> obj, T tag)
       REQUIRES_SHARED(art::Locks::mutator_lock_)
-      REQUIRES(allow_disallow_lock_);
+      REQUIRES(!update_lock_);
 
   ALWAYS_INLINE
-  bool RemoveLocked(art::Thread* self, art::ObjPtr<art::mirror::Object> obj, /* out */ T* tag)
+  bool RemoveImpl(art::Thread* self, art::ObjPtr<art::mirror::Object> obj, /* out */ T* tag)
       REQUIRES_SHARED(art::Locks::mutator_lock_)
-      REQUIRES(allow_disallow_lock_);
+      REQUIRES(!update_lock_);
 
-  bool GetTagLocked(art::Thread* self, art::ObjPtr<art::mirror::Object> obj, /* out */ T* result)
+  bool GetTagImpl(art::Thread* self, art::ObjPtr<art::mirror::Object> obj, /* out */ T* result)
       REQUIRES_SHARED(art::Locks::mutator_lock_)
-      REQUIRES(allow_disallow_lock_) {
-    auto it = tagged_objects_.find(art::GcRoot<art::mirror::Object>(obj));
-    if (it != tagged_objects_.end()) {
-      *result = it->second;
-      return true;
-    }
-
-    // Performance optimization: To avoid multiple table updates, ensure that during GC we
-    // only update once. See the comment on the implementation of GetTagSlowPath.
-    if (art::kUseReadBarrier &&
-        self != nullptr &&
-        self->GetIsGcMarking() &&
-        !update_since_last_sweep_) {
-      return GetTagSlowPath(self, obj, result);
-    }
-
-    return false;
-  }
+      REQUIRES(!update_lock_);
 
   // Slow-path for GetTag. We didn't find the object, but we might be storing from-pointers and
   // are asked to retrieve with a to-pointer.
   ALWAYS_INLINE
   bool GetTagSlowPath(art::Thread* self, art::ObjPtr<art::mirror::Object> obj, /* out */ T* result)
       REQUIRES_SHARED(art::Locks::mutator_lock_)
-      REQUIRES(allow_disallow_lock_);
+      REQUIRES(!update_lock_);
 
   // Update the table by doing read barriers on each element, ensuring that to-space pointers
   // are stored.
   ALWAYS_INLINE
   void UpdateTableWithReadBarrier()
       REQUIRES_SHARED(art::Locks::mutator_lock_)
-      REQUIRES(allow_disallow_lock_);
+      REQUIRES(update_lock_);
 
   template <bool kHandleNull>
   void SweepImpl(art::IsMarkedVisitor* visitor)
       REQUIRES_SHARED(art::Locks::mutator_lock_)
-      REQUIRES(!allow_disallow_lock_);
+      REQUIRES(!update_lock_);
 
   enum TableUpdateNullTarget {
     kIgnoreNull,
@@ -187,39 +221,28 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
     kCallHandleNull
   };
 
+  // Visit every entry in every shard, replacing (or removing) entries whose object the updater
+  // maps to a new pointer. Entries whose new pointer hashes to a different shard are migrated,
+  // taking only one shard lock at a time. Readers that miss during a migration serialize on
+  // update_lock_ in their slow path and retry.
   template <typename Updater, TableUpdateNullTarget kTargetNull>
   void UpdateTableWith(Updater& updater)
       REQUIRES_SHARED(art::Locks::mutator_lock_)
-      REQUIRES(allow_disallow_lock_);
+      REQUIRES(update_lock_);
 
   template <typename Storage, class Allocator = JvmtiAllocator<T>>
   struct ReleasableContainer;
 
-  struct HashGcRoot {
-    size_t operator()(const art::GcRoot<art::mirror::Object>& r) const
-        REQUIRES_SHARED(art::Locks::mutator_lock_) {
-      return reinterpret_cast<uintptr_t>(r.Read<art::kWithoutReadBarrier>());
-    }
-  };
+  Shard shards_[kNumShards];
 
-  struct EqGcRoot {
-    bool operator()(const art::GcRoot<art::mirror::Object>& r1,
-                    const art::GcRoot<art::mirror::Object>& r2) const
-        REQUIRES_SHARED(art::Locks::mutator_lock_) {
-      return r1.Read<art::kWithoutReadBarrier>() == r2.Read<art::kWithoutReadBarrier>();
-    }
-  };
+  // Serializes whole-table updates (the read-barrier refresh during marking and the GC-driven
+  // sweep), which can migrate entries between shards.
+  art::Mutex update_lock_;
 
-  using TagAllocator = JvmtiAllocator<std::pair<const art::GcRoot<art::mirror::Object>, T>>;
-  std::unordered_map<art::GcRoot<art::mirror::Object>,
-                     T,
-                     HashGcRoot,
-                     EqGcRoot,
-                     TagAllocator> tagged_objects_
-      GUARDED_BY(allow_disallow_lock_)
-      GUARDED_BY(art::Locks::mutator_lock_);
   // To avoid repeatedly scanning the whole table, remember if we did that since the last sweep.
-  bool update_since_last_sweep_;
+  // Written under update_lock_ (set only once the refresh completed), cleared at the end of the
+  // sweep; read concurrently by the per-object fast paths.
+  std::atomic<bool> update_since_last_sweep_;
 };
 
 }  // namespace openjdkjvmti
@@ -18,6 +18,7 @@
 
 #include <ios>
 #include <unordered_map>
+#include <vector>
 
 #include "android-base/logging.h"
 #include "android-base/thread_annotations.h"
@@ -29,6 +30,7 @@
 #include "base/mutex.h"
 #include "base/utils.h"
 #include "class_linker.h"
+#include "class_table.h"
 #include "deopt_manager.h"
 #include "dex/primitive.h"
 #include "events-inl.h"
@@ -41,6 +43,7 @@
 #include "handle.h"
 #include "handle_scope.h"
 #include "java_frame_root_info.h"
+#include "jni/java_vm_ext.h"
 #include "jni/jni_env_ext.h"
 #include "jni/jni_id_manager.h"
 #include "jni/jni_internal.h"
@@ -1428,6 +1431,30 @@ jvmtiError HeapUtil::FollowReferences(jvmtiEnv* env,
   return ERR(NONE);
 }
 
+namespace {
+
+// Cache of the most recent loaded-classes enumeration, kept as weak globals tagged with the
+// ClassTable generation the enumeration observed. Agents commonly poll GetLoadedClasses and
+// walking every class table under the class linker lock gets more expensive as classes
+// accumulate; while no class table has changed, later calls can be answered from the cache
+// without taking that lock. Weak refs cleared by class unloading are filtered out on read.
+struct LoadedClassesCache {
+  LoadedClassesCache()
+      : lock("JVMTI loaded classes cache lock", art::kPostMutatorTopLockLevel) {}
+
+  art::Mutex lock;
+  bool valid GUARDED_BY(lock) = false;
+  uint64_t generation GUARDED_BY(lock) = 0u;
+  std::vector<jweak> classes GUARDED_BY(lock);
+};
+
+LoadedClassesCache& GetLoadedClassesCache() {
+  static LoadedClassesCache cache;
+  return cache;
+}
+
+}  // namespace
+
 jvmtiError HeapUtil::GetLoadedClasses(jvmtiEnv* env,
                                       jint* class_count_ptr,
                                       jclass** classes_ptr) {
@@ -1452,24 +1479,52 @@ jvmtiError HeapUtil::GetLoadedClasses(jvmtiEnv* env,
   };
 
   art::Thread* self = art::Thread::Current();
-  ReportClassVisitor rcv(self);
+  art::JavaVMExt* vm = art::Runtime::Current()->GetJavaVM();
+  LoadedClassesCache& cache = GetLoadedClassesCache();
+  std::vector<jclass> classes;
   {
     art::ScopedObjectAccess soa(self);
-    art::Runtime::Current()->GetClassLinker()->VisitClasses(&rcv);
+    art::MutexLock mu(self, cache.lock);
+    // Sample the generation before walking the tables; a class inserted while we walk then
+    // leaves the cache tagged with an older generation and the next call rebuilds it.
+    uint64_t generation = art::ClassTable::GetGlobalGeneration();
+    if (cache.valid && cache.generation == generation) {
+      for (jweak weak_klass : cache.classes) {
+        art::ObjPtr<art::mirror::Object> klass = self->DecodeJObject(weak_klass);
+        // Cleared weak refs are classes that were unloaded since the cache was built.
+        if (klass != nullptr) {
+          classes.push_back(soa.Env()->AddLocalReference<jclass>(klass));
+        }
+      }
+    } else {
+      ReportClassVisitor rcv(self);
+      art::Runtime::Current()->GetClassLinker()->VisitClasses(&rcv);
+      for (jweak weak_klass : cache.classes) {
+        vm->DeleteWeakGlobalRef(self, weak_klass);
+      }
+      cache.classes.clear();
+      cache.classes.reserve(rcv.classes_.size());
+      for (jclass klass : rcv.classes_) {
+        cache.classes.push_back(vm->AddWeakGlobalRef(self, self->DecodeJObject(klass)));
+      }
+      cache.generation = generation;
+      cache.valid = true;
+      classes = std::move(rcv.classes_);
+    }
   }
 
-  size_t size = rcv.classes_.size();
-  jclass* classes = nullptr;
+  size_t size = classes.size();
+  jclass* out_classes = nullptr;
   jvmtiError alloc_ret = env->Allocate(static_cast<jlong>(size * sizeof(jclass)),
-                                       reinterpret_cast<unsigned char**>(&classes));
+                                       reinterpret_cast<unsigned char**>(&out_classes));
   if (alloc_ret != ERR(NONE)) {
     return alloc_ret;
   }
 
   for (size_t i = 0; i < size; ++i) {
-    classes[i] = rcv.classes_[i];
+    out_classes[i] = classes[i];
   }
-  *classes_ptr = classes;
+  *classes_ptr = out_classes;
   *class_count_ptr = static_cast<jint>(size);
 
   return ERR(NONE);
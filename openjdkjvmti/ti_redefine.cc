@@ -33,6 +33,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <iterator>
 #include <limits>
 #include <sstream>
@@ -67,9 +68,11 @@
 #include "dex/art_dex_file_loader.h"
 #include "dex/class_accessor-inl.h"
 #include "dex/class_accessor.h"
+#include "dex/code_item_accessors-inl.h"
 #include "dex/dex_file.h"
 #include "dex/dex_file_loader.h"
 #include "dex/dex_file_types.h"
+#include "dex/dex_instruction-inl.h"
 #include "dex/primitive.h"
 #include "dex/signature-inl.h"
 #include "dex/signature.h"
@@ -824,7 +827,8 @@ void DoAllocateObsoleteMethodsCallback(art::Thread* t, void* vdata) NO_THREAD_SA
 // updated so they will be run.
 // TODO Rewrite so we can do this only once regardless of how many redefinitions there are.
 void Redefiner::ClassRedefinition::FindAndAllocateObsoleteMethods(
-    art::ObjPtr<art::mirror::Class> art_klass) {
+    art::ObjPtr<art::mirror::Class> art_klass,
+    /*out*/std::unordered_set<art::ArtMethod*>* obsoleted_methods) {
   DCHECK(!IsStructuralRedefinition());
   art::ScopedAssertNoThreadSuspension ns("No thread suspension during thread stack walking");
   art::ObjPtr<art::mirror::ClassExt> ext = art_klass->GetExtData();
@@ -856,8 +860,9 @@ void Redefiner::ClassRedefinition::FindAndAllocateObsoleteMethods(
     // After we've done walking all threads' stacks and updating method pointers on them,
     // update JIT data structures (used by the stack walk above) to point to the new methods.
     art::jit::Jit* jit = art::Runtime::Current()->GetJit();
-    if (jit != nullptr) {
-      for (const ObsoleteMap::ObsoleteMethodPair& it : *ctx.obsolete_map) {
+    for (const ObsoleteMap::ObsoleteMethodPair& it : *ctx.obsolete_map) {
+      obsoleted_methods->insert(it.old_method);
+      if (jit != nullptr) {
         // Notify the JIT we are making this obsolete method. It will update the jit's internal
         // structures to keep track of the new obsolete method.
         jit->GetCodeCache()->MoveObsoleteMethod(it.old_method, it.obsolete_method);
@@ -2554,8 +2559,131 @@ void Redefiner::ClassRedefinition::ReverifyClass(const RedefinitionDataIter &cur
   CHECK_NE(failure, art::verifier::FailureKind::kHardFailure);
 }
 
-void Redefiner::ClassRedefinition::UpdateMethods(art::ObjPtr<art::mirror::Class> mclass,
-                                                 const art::dex::ClassDef& class_def) {
+// Returns whether the new code item is an exact semantic match for the old one: the raw bytecode
+// must be identical and every symbolic reference in it must resolve to the same string, type,
+// field or method in both dex files. Identical bytes alone are not sufficient since the ID tables
+// of the new dex file may have shifted, giving the same index a different meaning.
+static bool IsMethodBytecodeUnchanged(const art::DexFile& old_dex_file,
+                                      const art::dex::CodeItem* old_code_item,
+                                      const art::DexFile& new_dex_file,
+                                      const art::dex::CodeItem* new_code_item) {
+  art::CodeItemDataAccessor old_code(old_dex_file, old_code_item);
+  art::CodeItemDataAccessor new_code(new_dex_file, new_code_item);
+  if (old_code.RegistersSize() != new_code.RegistersSize() ||
+      old_code.InsSize() != new_code.InsSize() ||
+      old_code.OutsSize() != new_code.OutsSize() ||
+      old_code.TriesSize() != new_code.TriesSize() ||
+      old_code.InsnsSizeInCodeUnits() != new_code.InsnsSizeInCodeUnits()) {
+    return false;
+  }
+  if (memcmp(old_code.Insns(),
+             new_code.Insns(),
+             old_code.InsnsSizeInCodeUnits() * sizeof(uint16_t)) != 0) {
+    return false;
+  }
+  // The instruction streams are identical so referenced indices are numerically equal in both
+  // files. Check that each index also names the same thing in both files.
+  for (const art::DexInstructionPcPair& pair : old_code) {
+    const art::Instruction& inst = pair.Inst();
+    uint32_t index;
+    switch (art::Instruction::FormatOf(inst.Opcode())) {
+      case art::Instruction::k21c:
+      case art::Instruction::k31c:
+      case art::Instruction::k35c:
+      case art::Instruction::k3rc:
+      case art::Instruction::k45cc:
+      case art::Instruction::k4rcc:
+        index = inst.VRegB();
+        break;
+      case art::Instruction::k22c:
+        index = inst.VRegC();
+        break;
+      default:
+        continue;
+    }
+    switch (art::Instruction::IndexTypeOf(inst.Opcode())) {
+      case art::Instruction::kIndexTypeRef:
+        if (strcmp(old_dex_file.StringByTypeIdx(art::dex::TypeIndex(index)),
+                   new_dex_file.StringByTypeIdx(art::dex::TypeIndex(index))) != 0) {
+          return false;
+        }
+        break;
+      case art::Instruction::kIndexStringRef:
+        if (strcmp(old_dex_file.GetStringDataByIdx(art::dex::StringIndex(index)),
+                   new_dex_file.GetStringDataByIdx(art::dex::StringIndex(index))) != 0) {
+          return false;
+        }
+        break;
+      case art::Instruction::kIndexFieldRef: {
+        const art::dex::FieldId& old_id = old_dex_file.GetFieldId(index);
+        const art::dex::FieldId& new_id = new_dex_file.GetFieldId(index);
+        if (strcmp(old_dex_file.GetFieldDeclaringClassDescriptor(old_id),
+                   new_dex_file.GetFieldDeclaringClassDescriptor(new_id)) != 0 ||
+            strcmp(old_dex_file.GetFieldName(old_id), new_dex_file.GetFieldName(new_id)) != 0 ||
+            strcmp(old_dex_file.GetFieldTypeDescriptor(old_id),
+                   new_dex_file.GetFieldTypeDescriptor(new_id)) != 0) {
+          return false;
+        }
+        break;
+      }
+      case art::Instruction::kIndexMethodRef: {
+        const art::dex::MethodId& old_id = old_dex_file.GetMethodId(index);
+        const art::dex::MethodId& new_id = new_dex_file.GetMethodId(index);
+        if (strcmp(old_dex_file.GetMethodDeclaringClassDescriptor(old_id),
+                   new_dex_file.GetMethodDeclaringClassDescriptor(new_id)) != 0 ||
+            strcmp(old_dex_file.GetMethodName(old_id), new_dex_file.GetMethodName(new_id)) != 0 ||
+            old_dex_file.GetMethodSignature(old_id) != new_dex_file.GetMethodSignature(new_id)) {
+          return false;
+        }
+        break;
+      }
+      case art::Instruction::kIndexNone:
+      case art::Instruction::kIndexVtableOffset:
+      case art::Instruction::kIndexFieldOffset:
+        break;
+      default:
+        // Proto, call-site and method-handle references are rare enough that comparing them is not
+        // worth the trouble; conservatively treat the method as changed.
+        return false;
+    }
+  }
+  // The try/handler tables live outside the instruction stream, so compare them explicitly.
+  auto old_tries = old_code.TryItems();
+  auto new_tries = new_code.TryItems();
+  auto new_try = new_tries.begin();
+  for (auto old_try = old_tries.begin(); old_try != old_tries.end(); ++old_try, ++new_try) {
+    if (old_try->start_addr_ != new_try->start_addr_ ||
+        old_try->insn_count_ != new_try->insn_count_) {
+      return false;
+    }
+    art::CatchHandlerIterator old_handler(old_code, *old_try);
+    art::CatchHandlerIterator new_handler(new_code, *new_try);
+    for (; old_handler.HasNext() && new_handler.HasNext();
+         old_handler.Next(), new_handler.Next()) {
+      art::dex::TypeIndex old_type = old_handler.GetHandlerTypeIndex();
+      art::dex::TypeIndex new_type = new_handler.GetHandlerTypeIndex();
+      if (old_handler.GetHandlerAddress() != new_handler.GetHandlerAddress() ||
+          old_type.IsValid() != new_type.IsValid()) {
+        return false;
+      }
+      if (old_type.IsValid() &&
+          strcmp(old_dex_file.StringByTypeIdx(old_type),
+                 new_dex_file.StringByTypeIdx(new_type)) != 0) {
+        return false;
+      }
+    }
+    if (old_handler.HasNext() || new_handler.HasNext()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Redefiner::ClassRedefinition::UpdateMethods(
+    art::ObjPtr<art::mirror::Class> mclass,
+    const art::dex::ClassDef& class_def,
+    const std::unordered_set<art::ArtMethod*>& obsoleted_methods,
+    /*out*/std::unordered_set<art::ArtMethod*>* retained_methods) {
   art::ClassLinker* linker = driver_->runtime_->GetClassLinker();
   art::PointerSize image_pointer_size = linker->GetImagePointerSize();
   const art::dex::TypeId& declaring_class_id = dex_file_->GetTypeId(class_def.class_idx_);
@@ -2582,14 +2710,28 @@ void Redefiner::ClassRedefinition::UpdateMethods(art::ObjPtr<art::mirror::Class>
                                                                   *proto_id);
     CHECK(method_id != nullptr);
     uint32_t dex_method_idx = dex_file_->GetIndexForMethodId(*method_id);
+    // Grab the old code item before the method is repointed at the new dex file.
+    const art::dex::CodeItem* old_code_item = method.HasCodeItem() ? method.GetCodeItem() : nullptr;
+    const art::dex::CodeItem* new_code_item = nullptr;
     method.SetDexMethodIndex(dex_method_idx);
-    linker->SetEntryPointsToInterpreter(&method);
     if (method.HasCodeItem()) {
-      method.SetCodeItem(
-          dex_file_->GetCodeItem(dex_file_->FindCodeItemOffset(class_def, dex_method_idx)));
+      new_code_item =
+          dex_file_->GetCodeItem(dex_file_->FindCodeItemOffset(class_def, dex_method_idx));
+      method.SetCodeItem(new_code_item);
+    }
+    // A method whose bytecode is unchanged and whose frames did not need obsolete copies behaves
+    // exactly as before, so it can keep its (possibly compiled) entry points. If re-verification
+    // is needed we cannot tell yet what the final environment will allow, so retain nothing.
+    if (!needs_reverify_ &&
+        old_code_item != nullptr &&
+        obsoleted_methods.find(&method) == obsoleted_methods.end() &&
+        IsMethodBytecodeUnchanged(old_dex_file, old_code_item, *dex_file_, new_code_item)) {
+      retained_methods->insert(&method);
+    } else {
+      linker->SetEntryPointsToInterpreter(&method);
+      // Clear all the intrinsics related flags.
+      method.SetNotIntrinsic();
     }
-    // Clear all the intrinsics related flags.
-    method.SetNotIntrinsic();
   }
 }
 
@@ -3001,12 +3143,14 @@ void Redefiner::ClassRedefinition::UpdateClassStructurally(const RedefinitionDat
 void Redefiner::ClassRedefinition::UpdateClassInPlace(const RedefinitionDataIter& holder) {
   art::ObjPtr<art::mirror::Class> mclass(holder.GetMirrorClass());
   // TODO Rewrite so we don't do a stack walk for each and every class.
-  FindAndAllocateObsoleteMethods(mclass);
+  std::unordered_set<art::ArtMethod*> obsoleted_methods;
+  FindAndAllocateObsoleteMethods(mclass, &obsoleted_methods);
   art::ObjPtr<art::mirror::DexCache> new_dex_cache(holder.GetNewDexCache());
   art::ObjPtr<art::mirror::Object> original_dex_file(holder.GetOriginalDexFile());
   DCHECK_EQ(dex_file_->NumClassDefs(), 1u);
   const art::dex::ClassDef& class_def = dex_file_->GetClassDef(0);
-  UpdateMethods(mclass, class_def);
+  std::unordered_set<art::ArtMethod*> retained_methods;
+  UpdateMethods(mclass, class_def, obsoleted_methods, &retained_methods);
   UpdateFields(mclass);
 
   art::ObjPtr<art::mirror::ClassExt> ext(mclass->GetExtData());
@@ -3038,9 +3182,9 @@ void Redefiner::ClassRedefinition::UpdateClassInPlace(const RedefinitionDataIter
         driver_->runtime_->GetClassLinker()->GetImagePointerSize();
     auto code_cache = jit->GetCodeCache();
     // Non-invokable methods don't have any JIT data associated with them so we don't need to tell
-    // the jit about them.
+    // the jit about them. Methods that kept their entry points also keep their JIT code.
     for (art::ArtMethod& method : mclass->GetDeclaredMethods(image_pointer_size)) {
-      if (method.IsInvokable()) {
+      if (method.IsInvokable() && retained_methods.find(&method) == retained_methods.end()) {
         code_cache->NotifyMethodRedefined(&method);
       }
     }
@@ -34,6 +34,7 @@
 
 #include <functional>
 #include <string>
+#include <unordered_set>
 
 #include <jni.h>
 
@@ -184,7 +185,11 @@ class Redefiner {
         /*out*/RedefinitionDataIter* cur_data)
           REQUIRES_SHARED(art::Locks::mutator_lock_);
 
-    void FindAndAllocateObsoleteMethods(art::ObjPtr<art::mirror::Class> art_klass)
+    // 'obsoleted_methods' is filled with the declared methods for which obsolete copies were
+    // created because they had active frames on some stack.
+    void FindAndAllocateObsoleteMethods(
+        art::ObjPtr<art::mirror::Class> art_klass,
+        /*out*/std::unordered_set<art::ArtMethod*>* obsoleted_methods)
         REQUIRES(art::Locks::mutator_lock_);
 
     art::ObjPtr<art::mirror::Class> AllocateNewClassObject(
@@ -233,8 +238,13 @@ class Redefiner {
     void UpdateFields(art::ObjPtr<art::mirror::Class> mclass)
         REQUIRES(art::Locks::mutator_lock_);
 
+    // Updates the declared methods to point into the new dex file. Methods whose bytecode is
+    // unchanged and which have no obsolete copy keep their entry points; the ArtMethods in
+    // 'retained_methods' are the ones that did so.
     void UpdateMethods(art::ObjPtr<art::mirror::Class> mclass,
-                       const art::dex::ClassDef& class_def)
+                       const art::dex::ClassDef& class_def,
+                       const std::unordered_set<art::ArtMethod*>& obsoleted_methods,
+                       /*out*/std::unordered_set<art::ArtMethod*>* retained_methods)
         REQUIRES(art::Locks::mutator_lock_);
 
     void UpdateClass(const RedefinitionDataIter& cur_data)
@@ -75,7 +75,7 @@ namespace openjdkjvmti {
 class TransformationFaultHandler final : public art::FaultHandler {
  public:
   explicit TransformationFaultHandler(art::FaultManager* manager)
-      : art::FaultHandler(manager),
+      : art::FaultHandler(manager, "jvmti transformation"),
         uninitialized_class_definitions_lock_("JVMTI Initialized class definitions lock",
                                               art::LockLevel::kSignalHandlingLock),
         class_definition_initialized_cond_("JVMTI Initialized class definitions condition",
@@ -326,8 +326,11 @@ class ReferredObjectsFinder {
  public:
   explicit ReferredObjectsFinder(
       std::vector<std::pair<std::string, art::mirror::Object*>>* referred_objects,
-      art::mirror::Object** min_nonnull_ptr)
-      : referred_objects_(referred_objects), min_nonnull_ptr_(min_nonnull_ptr) {}
+      art::mirror::Object** min_nonnull_ptr,
+      bool emit_field_names)
+      : referred_objects_(referred_objects),
+        min_nonnull_ptr_(min_nonnull_ptr),
+        emit_field_names_(emit_field_names) {}
 
   // For art::mirror::Object::VisitReferences.
   void operator()(art::ObjPtr<art::mirror::Object> obj, art::MemberOffset offset,
@@ -338,15 +341,20 @@ class ReferredObjectsFinder {
       return;
     }
     art::mirror::Object* ref = obj->GetFieldObject<art::mirror::Object>(offset);
-    art::ArtField* field;
-    if (is_static) {
-      field = art::ArtField::FindStaticFieldWithOffset(obj->AsClass(), offset.Uint32Value());
-    } else {
-      field = art::ArtField::FindInstanceFieldWithOffset(obj->GetClass(), offset.Uint32Value());
-    }
     std::string field_name = "";
-    if (field != nullptr) {
-      field_name = field->PrettyField(/*with_type=*/true);
+    // Skip the field lookup and prettification when the caller does not emit
+    // per-object field ids; for normal instances and object arrays it would be
+    // recomputed for every single reference in the heap.
+    if (emit_field_names_) {
+      art::ArtField* field;
+      if (is_static) {
+        field = art::ArtField::FindStaticFieldWithOffset(obj->AsClass(), offset.Uint32Value());
+      } else {
+        field = art::ArtField::FindInstanceFieldWithOffset(obj->GetClass(), offset.Uint32Value());
+      }
+      if (field != nullptr) {
+        field_name = field->PrettyField(/*with_type=*/true);
+      }
     }
     referred_objects_->emplace_back(std::move(field_name), ref);
     if (!*min_nonnull_ptr_ || (ref && *min_nonnull_ptr_ > ref)) {
@@ -364,6 +372,7 @@ class ReferredObjectsFinder {
   // fork.
   std::vector<std::pair<std::string, art::mirror::Object*>>* referred_objects_;
   art::mirror::Object** min_nonnull_ptr_;
+  const bool emit_field_names_;
 };
 
 class RootFinder : public art::SingleRootVisitor {
@@ -495,13 +504,23 @@ void ForInstanceReferenceField(art::mirror::Class* klass, F fn) NO_THREAD_SAFETY
 }
 
 bool IsIgnored(const std::vector<std::string>& ignored_types,
+               std::map<art::mirror::Class*, bool>* ignored_cache,
                art::mirror::Object* obj) NO_THREAD_SAFETY_ANALYSIS {
-  if (obj->IsClass()) {
+  if (ignored_types.empty() || obj->IsClass()) {
     return false;
   }
+  // Cache the decision per class; prettifying the descriptor and comparing it
+  // against the configured list for every object (and every referred object)
+  // is a large part of the dump time on big heaps.
   art::mirror::Class* klass = obj->GetClass();
-  return std::find(ignored_types.begin(), ignored_types.end(), PrettyType(klass)) !=
-         ignored_types.end();
+  auto it = ignored_cache->find(klass);
+  if (it != ignored_cache->end()) {
+    return it->second;
+  }
+  bool ignored = std::find(ignored_types.begin(), ignored_types.end(), PrettyType(klass)) !=
+                 ignored_types.end();
+  ignored_cache->emplace(klass, ignored);
+  return ignored;
 }
 
 size_t EncodedSize(uint64_t n) {
@@ -624,6 +643,7 @@ void DumpPerfetto(art::Thread* self) {
             std::map<std::string, uint64_t> interned_fields{{"", 0}};
             std::map<std::string, uint64_t> interned_locations{{"", 0}};
             std::map<uintptr_t, uint64_t> interned_classes{{0, 0}};
+            std::map<art::mirror::Class*, bool> ignored_cache;
 
             std::map<art::RootType, std::vector<art::mirror::Object*>> root_objects;
             RootFinder rcf(&root_objects);
@@ -658,7 +678,8 @@ void DumpPerfetto(art::Thread* self) {
 
             art::Runtime::Current()->GetHeap()->VisitObjectsPaused(
                 [&writer, &interned_fields, &interned_locations, &reference_field_ids,
-                 &reference_object_ids, &interned_classes, &ignored_types, &prev_object_id](
+                 &reference_object_ids, &interned_classes, &ignored_types, &ignored_cache,
+                 &prev_object_id](
                     art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
                   if (obj->IsClass()) {
                     art::mirror::Class* klass = obj->AsClass().Ptr();
@@ -708,7 +729,7 @@ void DumpPerfetto(art::Thread* self) {
                           obj->AsClass()->GetLocation()));
                   }
 
-                  if (IsIgnored(ignored_types, obj)) {
+                  if (IsIgnored(ignored_types, &ignored_cache, obj)) {
                     return;
                   }
 
@@ -729,14 +750,15 @@ void DumpPerfetto(art::Thread* self) {
                   if (obj->SizeOf() != klass->GetObjectSize())
                     object_proto->set_self_size(obj->SizeOf());
 
+                  const bool emit_field_ids =
+                      klass->GetClassFlags() != art::mirror::kClassFlagObjectArray &&
+                      klass->GetClassFlags() != art::mirror::kClassFlagNormal;
+
                   std::vector<std::pair<std::string, art::mirror::Object*>>
                       referred_objects;
                   art::mirror::Object* min_nonnull_ptr = nullptr;
-                  ReferredObjectsFinder objf(&referred_objects, &min_nonnull_ptr);
+                  ReferredObjectsFinder objf(&referred_objects, &min_nonnull_ptr, emit_field_ids);
 
-                  const bool emit_field_ids =
-                      klass->GetClassFlags() != art::mirror::kClassFlagObjectArray &&
-                      klass->GetClassFlags() != art::mirror::kClassFlagNormal;
                   if (klass->GetClassFlags() != art::mirror::kClassFlagNormal) {
                     obj->VisitReferences(objf, art::VoidFunctor());
                   } else {
@@ -760,7 +782,7 @@ void DumpPerfetto(art::Thread* self) {
                   if (base_obj_id) {
                     for (auto& p : referred_objects) {
                       art::mirror::Object*& referred_obj = p.second;
-                      if (!referred_obj || IsIgnored(ignored_types, referred_obj)) {
+                      if (!referred_obj || IsIgnored(ignored_types, &ignored_cache, referred_obj)) {
                         referred_obj = nullptr;
                         continue;
                       }
@@ -16,6 +16,11 @@
 
 #include "profile_assistant.h"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "base/os.h"
 #include "base/unix_file/fd_file.h"
 
@@ -26,6 +31,37 @@ namespace art {
 static constexpr const uint32_t kMinNewMethodsForCompilation = 100;
 static constexpr const uint32_t kMinNewClassesForCompilation = 50;
 
+// Load the profile file at the given index and merge it into `info`. Shared by
+// the serial and the multi-threaded merge paths.
+static ProfileAssistant::ProcessingResult LoadAndMergeProfile(
+    const ScopedFlock& profile_file,
+    size_t index,
+    const ProfileCompilationInfo::ProfileLoadFilterFn& filter_fn,
+    const ProfileAssistant::Options& options,
+    /*inout*/ ProfileCompilationInfo* info) {
+  ProfileCompilationInfo cur_info(options.IsBootImageMerge());
+  if (!cur_info.Load(profile_file->Fd(), /*merge_classes=*/ true, filter_fn)) {
+    LOG(WARNING) << "Could not load profile file at index " << index;
+    if (options.IsForceMerge()) {
+      // If we have to merge forcefully, ignore load failures.
+      // This is useful for boot image profiles to ignore stale profiles which are
+      // cleared lazily.
+      return ProfileAssistant::kSuccess;
+    }
+    // TODO: Do we really need to use a different error code for version mismatch?
+    ProfileCompilationInfo wrong_info(!options.IsBootImageMerge());
+    if (wrong_info.Load(profile_file->Fd(), /*merge_classes=*/ true, filter_fn)) {
+      return ProfileAssistant::kErrorDifferentVersions;
+    }
+    return ProfileAssistant::kErrorBadProfiles;
+  }
+
+  if (!info->MergeWith(cur_info)) {
+    LOG(WARNING) << "Could not merge profile file at index " << index;
+    return ProfileAssistant::kErrorBadProfiles;
+  }
+  return ProfileAssistant::kSuccess;
+}
 
 ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
         const std::vector<ScopedFlock>& profile_files,
@@ -52,27 +88,56 @@ ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
   uint32_t number_of_classes = info.GetNumberOfResolvedClasses();
 
   // Merge all current profiles.
-  for (size_t i = 0; i < profile_files.size(); i++) {
-    ProfileCompilationInfo cur_info(options.IsBootImageMerge());
-    if (!cur_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
-      LOG(WARNING) << "Could not load profile file at index " << i;
-      if (options.IsForceMerge()) {
-        // If we have to merge forcefully, ignore load failures.
-        // This is useful for boot image profiles to ignore stale profiles which are
-        // cleared lazily.
-        continue;
+  size_t num_threads =
+      std::min<size_t>(std::max<uint32_t>(options.GetMergeThreads(), 1u), profile_files.size());
+  if (num_threads <= 1u) {
+    for (size_t i = 0; i < profile_files.size(); i++) {
+      ProcessingResult result =
+          LoadAndMergeProfile(profile_files[i], i, filter_fn, options, &info);
+      if (result != kSuccess) {
+        return result;
       }
-      // TODO: Do we really need to use a different error code for version mismatch?
-      ProfileCompilationInfo wrong_info(!options.IsBootImageMerge());
-      if (wrong_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
-        return kErrorDifferentVersions;
+    }
+  } else {
+    // Tree-reduce merge: shard the inputs across worker threads. Each worker
+    // streams its shard one profile at a time into a thread-local accumulator,
+    // so at most one loaded input per thread is resident at any time. The
+    // accumulators are then combined into the reference info. Shards are
+    // contiguous and combined in shard order so that the result does not
+    // depend on thread scheduling.
+    std::vector<std::unique_ptr<ProfileCompilationInfo>> shard_infos;
+    std::vector<ProcessingResult> shard_results(num_threads, kSuccess);
+    for (size_t t = 0; t != num_threads; ++t) {
+      shard_infos.push_back(std::make_unique<ProfileCompilationInfo>(options.IsBootImageMerge()));
+    }
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t != num_threads; ++t) {
+      threads.emplace_back([&, t]() {
+        size_t shard_begin = t * profile_files.size() / num_threads;
+        size_t shard_end = (t + 1u) * profile_files.size() / num_threads;
+        for (size_t i = shard_begin; i != shard_end; ++i) {
+          ProcessingResult result =
+              LoadAndMergeProfile(profile_files[i], i, filter_fn, options, shard_infos[t].get());
+          if (result != kSuccess) {
+            shard_results[t] = result;
+            return;
+          }
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    for (ProcessingResult result : shard_results) {
+      if (result != kSuccess) {
+        return result;
       }
-      return kErrorBadProfiles;
     }
-
-    if (!info.MergeWith(cur_info)) {
-      LOG(WARNING) << "Could not merge profile file at index " << i;
-      return kErrorBadProfiles;
+    for (size_t t = 0; t != num_threads; ++t) {
+      if (!info.MergeWith(*shard_infos[t])) {
+        LOG(WARNING) << "Could not merge profile shard " << t;
+        return kErrorBadProfiles;
+      }
     }
   }
 
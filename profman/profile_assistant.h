@@ -46,6 +46,7 @@ class ProfileAssistant {
     static constexpr bool kBootImageMergeDefault = false;
     static constexpr uint32_t kMinNewMethodsPercentChangeForCompilation = 20;
     static constexpr uint32_t kMinNewClassesPercentChangeForCompilation = 20;
+    static constexpr uint32_t kMergeThreadsDefault = 1;
 
     Options()
         : force_merge_(kForceMergeDefault),
@@ -53,7 +54,8 @@ class ProfileAssistant {
           min_new_methods_percent_change_for_compilation_(
               kMinNewMethodsPercentChangeForCompilation),
           min_new_classes_percent_change_for_compilation_(
-              kMinNewClassesPercentChangeForCompilation) {
+              kMinNewClassesPercentChangeForCompilation),
+          merge_threads_(kMergeThreadsDefault) {
     }
 
     bool IsForceMerge() const { return force_merge_; }
@@ -64,6 +66,7 @@ class ProfileAssistant {
     uint32_t GetMinNewClassesPercentChangeForCompilation() const {
         return min_new_classes_percent_change_for_compilation_;
     }
+    uint32_t GetMergeThreads() const { return merge_threads_; }
 
     void SetForceMerge(bool value) { force_merge_ = value; }
     void SetBootImageMerge(bool value) { boot_image_merge_ = value; }
@@ -73,6 +76,7 @@ class ProfileAssistant {
     void SetMinNewClassesPercentChangeForCompilation(uint32_t value) {
       min_new_classes_percent_change_for_compilation_ = value;
     }
+    void SetMergeThreads(uint32_t value) { merge_threads_ = value; }
 
    private:
     // If true, performs a forced merge, without analyzing if there is a
@@ -84,6 +88,10 @@ class ProfileAssistant {
     bool boot_image_merge_;
     uint32_t min_new_methods_percent_change_for_compilation_;
     uint32_t min_new_classes_percent_change_for_compilation_;
+    // Number of threads used to merge the current profiles. When greater than 1,
+    // the inputs are sharded across worker threads which merge into thread-local
+    // accumulators that are combined into the reference profile at the end.
+    uint32_t merge_threads_;
   };
 
   // Process the profile information present in the given files. Returns one of
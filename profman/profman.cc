@@ -192,6 +192,9 @@ NO_RETURN static void Usage(const char *fmt, ...) {
   UsageError("      the min percent of new methods to trigger a compilation.");
   UsageError("  --min-new-classes-percent-change=percentage between 0 and 100 (default 20)");
   UsageError("      the min percent of new classes to trigger a compilation.");
+  UsageError("  --merge-threads=number of threads used to merge the input profiles (default 1).");
+  UsageError("      The inputs are sharded across threads and merged into per-thread");
+  UsageError("      accumulators which are combined into the reference profile at the end.");
   UsageError("");
 
   exit(EXIT_FAILURE);
@@ -461,6 +464,13 @@ class ProfMan final {
                         100u);
         profile_assistant_options_.SetMinNewClassesPercentChangeForCompilation(
             min_new_classes_percent_change);
+      } else if (StartsWith(option, "--merge-threads=")) {
+        uint32_t merge_threads;
+        ParseUintOption(raw_option,
+                        "--merge-threads=",
+                        &merge_threads,
+                        1u);
+        profile_assistant_options_.SetMergeThreads(merge_threads);
       } else if (option == "--copy-and-update-profile-key") {
         copy_and_update_profile_key_ = true;
       } else if (option == "--boot-image-merge") {
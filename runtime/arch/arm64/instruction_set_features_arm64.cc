@@ -19,6 +19,13 @@
 #if defined(ART_TARGET_ANDROID) && defined(__aarch64__)
 #include <asm/hwcap.h>
 #include <sys/auxv.h>
+#include <sys/prctl.h>
+
+// Older kernel headers may lack the SVE prctl interface.
+#if !defined(PR_SVE_GET_VL)
+#define PR_SVE_GET_VL 51
+#define PR_SVE_VL_LEN_MASK 0xffff
+#endif
 #endif
 
 #include <fstream>
@@ -28,6 +35,8 @@
 #include <android-base/stringprintf.h>
 #include <android-base/strings.h>
 
+#include "base/bit_utils.h"
+#include "base/globals.h"
 #include "base/stl_util.h"
 
 #include <cpu_features_macros.h>
@@ -42,6 +51,25 @@ namespace art {
 
 using android::base::StringPrintf;
 
+// Detect the vector length, in bits, of the SVE implementation on the current
+// CPU. The kernel reports the length in bytes via prctl; any multiple of
+// 128 bits up to 2048 is architecturally valid, but the vectorizer assumes a
+// power-of-two register size, so round down. Falls back to the build-time
+// default when detection is unavailable.
+static size_t DetectSVEVectorLength() {
+#if defined(ART_TARGET_ANDROID) && defined(__aarch64__)
+  int sve_vl = prctl(PR_SVE_GET_VL);
+  if (sve_vl > 0) {
+    size_t vl_bits =
+        TruncToPowerOfTwo(static_cast<size_t>(sve_vl & PR_SVE_VL_LEN_MASK) * kBitsPerByte);
+    if (vl_bits >= 128u) {
+      return vl_bits;
+    }
+  }
+#endif
+  return kArm64DefaultSVEVectorLength;
+}
+
 Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromVariant(
     const std::string& variant, std::string* error_msg) {
   // The CPU variant string is passed to ART through --instruction-set-variant option.
@@ -126,6 +154,7 @@ Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromVariant(
 
   // Currently there are no cpu variants which support SVE.
   bool has_sve = false;
+  size_t sve_vl = kArm64DefaultSVEVectorLength;
 
   if (!needs_a53_835769_fix) {
     // Check to see if this is an expected variant.
@@ -155,7 +184,8 @@ Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromVariant(
                                                                 has_lse,
                                                                 has_fp16,
                                                                 has_dotprod,
-                                                                has_sve));
+                                                                has_sve,
+                                                                sve_vl));
 }
 
 Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromBitmap(uint32_t bitmap) {
@@ -165,13 +195,17 @@ Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromBitmap(uint32_t bitmap)
   bool has_fp16 = (bitmap & kFP16BitField) != 0;
   bool has_dotprod = (bitmap & kDotProdBitField) != 0;
   bool has_sve = (bitmap & kSVEBitField) != 0;
+  // The SVE vector length is not encoded in the bitmap; detect it when the
+  // bitmap says the feature is present.
+  size_t sve_vl = has_sve ? DetectSVEVectorLength() : kArm64DefaultSVEVectorLength;
   return Arm64FeaturesUniquePtr(new Arm64InstructionSetFeatures(is_a53,
                                                                 is_a53,
                                                                 has_crc,
                                                                 has_lse,
                                                                 has_fp16,
                                                                 has_dotprod,
-                                                                has_sve));
+                                                                has_sve,
+                                                                sve_vl));
 }
 
 Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromCppDefines() {
@@ -207,13 +241,16 @@ Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromCppDefines() {
   has_sve = true;
 #endif
 
+  size_t sve_vl = has_sve ? DetectSVEVectorLength() : kArm64DefaultSVEVectorLength;
+
   return Arm64FeaturesUniquePtr(new Arm64InstructionSetFeatures(needs_a53_835769_fix,
                                                                 needs_a53_843419_fix,
                                                                 has_crc,
                                                                 has_lse,
                                                                 has_fp16,
                                                                 has_dotprod,
-                                                                has_sve));
+                                                                has_sve,
+                                                                sve_vl));
 }
 
 Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromCpuInfo() {
@@ -239,13 +276,16 @@ Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromHwcap() {
   has_sve = hwcaps & HWCAP_SVE ? true : false;
 #endif
 
+  size_t sve_vl = has_sve ? DetectSVEVectorLength() : kArm64DefaultSVEVectorLength;
+
   return Arm64FeaturesUniquePtr(new Arm64InstructionSetFeatures(needs_a53_835769_fix,
                                                                 needs_a53_843419_fix,
                                                                 has_crc,
                                                                 has_lse,
                                                                 has_fp16,
                                                                 has_dotprod,
-                                                                has_sve));
+                                                                has_sve,
+                                                                sve_vl));
 }
 
 Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromAssembly() {
@@ -256,13 +296,15 @@ Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromAssembly() {
 Arm64FeaturesUniquePtr Arm64InstructionSetFeatures::FromCpuFeatures() {
 #ifdef CPU_FEATURES_ARCH_AARCH64
   auto features = cpu_features::GetAarch64Info().features;
+  size_t sve_vl = features.sve ? DetectSVEVectorLength() : kArm64DefaultSVEVectorLength;
   return Arm64FeaturesUniquePtr(new Arm64InstructionSetFeatures(false,
                                                                 false,
                                                                 features.crc32,
                                                                 features.atomics,
                                                                 features.fphp,
                                                                 features.asimddp,
-                                                                features.sve));
+                                                                features.sve,
+                                                                sve_vl));
 #else
   UNIMPLEMENTED(WARNING);
   return FromCppDefines();
@@ -419,7 +461,8 @@ Arm64InstructionSetFeatures::AddFeaturesFromSplitString(
                                       has_lse,
                                       has_fp16,
                                       has_dotprod,
-                                      has_sve));
+                                      has_sve,
+                                      sve_vector_length_));
 }
 
 std::unique_ptr<const InstructionSetFeatures>
@@ -433,7 +476,8 @@ Arm64InstructionSetFeatures::AddRuntimeDetectedFeatures(
                                       arm64_features->has_lse_,
                                       arm64_features->has_fp16_,
                                       arm64_features->has_dotprod_,
-                                      arm64_features->has_sve_));
+                                      arm64_features->has_sve_,
+                                      arm64_features->sve_vector_length_));
 }
 
 }  // namespace art
@@ -100,9 +100,10 @@ class Arm64InstructionSetFeatures final : public InstructionSetFeatures {
     return kArm64AllowSVE && has_sve_;
   }
 
+  // The SVE vector length in bits, detected at runtime where possible,
+  // otherwise the build-time default. Only meaningful when HasSVE() is true.
   size_t GetSVEVectorLength() const {
-    // TODO: support SVE vector length detection.
-    return kArm64DefaultSVEVectorLength;
+    return sve_vector_length_;
   }
 
   virtual ~Arm64InstructionSetFeatures() {}
@@ -123,7 +124,8 @@ class Arm64InstructionSetFeatures final : public InstructionSetFeatures {
                               bool has_lse,
                               bool has_fp16,
                               bool has_dotprod,
-                              bool has_sve)
+                              bool has_sve,
+                              size_t sve_vector_length)
       : InstructionSetFeatures(),
         fix_cortex_a53_835769_(needs_a53_835769_fix),
         fix_cortex_a53_843419_(needs_a53_843419_fix),
@@ -131,7 +133,8 @@ class Arm64InstructionSetFeatures final : public InstructionSetFeatures {
         has_lse_(has_lse),
         has_fp16_(has_fp16),
         has_dotprod_(has_dotprod),
-        has_sve_(has_sve) {
+        has_sve_(has_sve),
+        sve_vector_length_(sve_vector_length) {
   }
 
   // Bitmap positions for encoding features as a bitmap.
@@ -151,6 +154,9 @@ class Arm64InstructionSetFeatures final : public InstructionSetFeatures {
   const bool has_fp16_;     // ARMv8.2 FP16 extensions.
   const bool has_dotprod_;  // optional in ARMv8.2, mandatory in ARMv8.4.
   const bool has_sve_;      // optional in ARMv8.2.
+  const size_t sve_vector_length_;  // SVE vector length in bits; a property of
+                                    // the device rather than the feature set,
+                                    // so not part of the bitmap or string form.
 
   DISALLOW_COPY_AND_ASSIGN(Arm64InstructionSetFeatures);
 };
@@ -48,6 +48,22 @@ namespace art {
 // All methods must have a name, all the way to "main".
 static constexpr bool kStrictUnwindChecks = true;
 
+// Memoized result of a previous unwind from the same thread. A repeated
+// collection from the same (pc, sp) whose covered stack region is unchanged
+// must produce the same frames, so periodic sampling of a thread sitting in
+// the same state pays one hash pass over the stack instead of a full
+// libunwindstack walk.
+struct CachedBacktrace {
+  uintptr_t leaf_pc = 0u;
+  uintptr_t leaf_sp = 0u;
+  size_t skip_count = 0u;
+  // End of the stack region the unwind depended on (sp of the outermost
+  // frame the unwinder reached), and the hash of [leaf_sp, outer_sp).
+  uintptr_t outer_sp = 0u;
+  uint64_t stack_hash = 0u;
+  std::vector<uintptr_t> frames;
+};
+
 struct UnwindHelper : public TLSData {
   static constexpr const char* kTlsKey = "UnwindHelper::kTlsKey";
 
@@ -79,23 +95,68 @@ struct UnwindHelper : public TLSData {
 
   unwindstack::Unwinder* Unwinder() { return &unwinder_; }
 
+  CachedBacktrace* Cache(uintptr_t pc, uintptr_t sp) {
+    return &cache_[(pc ^ (sp >> 4)) % kCacheEntries];
+  }
+
  private:
+  static constexpr size_t kCacheEntries = 16u;
+
   unwindstack::LocalUpdatableMaps maps_;
   unwindstack::ArchEnum arch_;
   std::shared_ptr<unwindstack::Memory> memory_;
   std::unique_ptr<unwindstack::JitDebug> jit_;
   std::unique_ptr<unwindstack::DexFiles> dex_;
   unwindstack::Unwinder unwinder_;
+  CachedBacktrace cache_[kCacheEntries];
 };
 
+// Bound on how much stack a cache entry may cover; hashing a deeper stack
+// would approach the cost of the unwind it is meant to avoid.
+static constexpr size_t kMaxCachedStackBytes = 16 * KB;
+
+static uint64_t HashStackRegion(uintptr_t begin, uintptr_t end) {
+  uint64_t hash = 0xcbf29ce484222325u;
+  for (uintptr_t p = begin; p + sizeof(uintptr_t) <= end; p += sizeof(uintptr_t)) {
+    hash = (hash ^ *reinterpret_cast<const uintptr_t*>(p)) * 0x100000001b3u;
+  }
+  return hash;
+}
+
 void BacktraceCollector::Collect() {
-  unwindstack::Unwinder* unwinder = UnwindHelper::Get(Thread::Current(), max_depth_)->Unwinder();
-  if (!CollectImpl(unwinder)) {
+  UnwindHelper* helper = UnwindHelper::Get(Thread::Current(), max_depth_);
+  unwindstack::Unwinder* unwinder = helper->Unwinder();
+
+  // Capture the current (pc, sp) as the cache key. This capture is separate
+  // from the one in CollectImpl() so that the frames seen by callers (and the
+  // skip counts they rely on) stay unchanged.
+  std::unique_ptr<unwindstack::Regs> key_regs(unwindstack::Regs::CreateFromLocal());
+  RegsGetLocal(key_regs.get());
+  const uintptr_t leaf_pc = static_cast<uintptr_t>(key_regs->pc());
+  const uintptr_t leaf_sp = static_cast<uintptr_t>(key_regs->sp());
+  CachedBacktrace* cached = helper->Cache(leaf_pc, leaf_sp);
+  if (cached->leaf_pc == leaf_pc &&
+      cached->leaf_sp == leaf_sp &&
+      cached->skip_count == skip_count_ &&
+      cached->frames.size() <= max_depth_ &&
+      HashStackRegion(leaf_sp, cached->outer_sp) == cached->stack_hash) {
+    // Same position and identical covered stack content: the unwind would
+    // retrace the same steps, so reuse the memoized frames.
+    num_frames_ = cached->frames.size();
+    for (size_t i = 0; i != num_frames_; ++i) {
+      out_frames_[i] = cached->frames[i];
+    }
+    return;
+  }
+
+  bool success = CollectImpl(unwinder);
+  if (!success) {
     // Reparse process mmaps to detect newly loaded libraries and retry,
     // but only if any maps changed (we don't want to hide racy failures).
     bool any_changed;
-    UnwindHelper::Get(Thread::Current(), max_depth_)->Reparse(&any_changed);
-    if (!any_changed || !CollectImpl(unwinder)) {
+    helper->Reparse(&any_changed);
+    success = any_changed && CollectImpl(unwinder);
+    if (!success) {
       if (kStrictUnwindChecks) {
         std::vector<unwindstack::FrameData>& frames = unwinder->frames();
         LOG(ERROR) << "Failed to unwind stack (error " << unwinder->LastErrorCodeString() << "):";
@@ -110,6 +171,19 @@ void BacktraceCollector::Collect() {
       }
     }
   }
+
+  // Memoize the result if the unwind covered a reasonably small stack region.
+  if (success && num_frames_ != 0u && !unwinder->frames().empty()) {
+    const uintptr_t outer_sp = static_cast<uintptr_t>(unwinder->frames().back().sp);
+    if (outer_sp > leaf_sp && outer_sp - leaf_sp <= kMaxCachedStackBytes) {
+      cached->leaf_pc = leaf_pc;
+      cached->leaf_sp = leaf_sp;
+      cached->skip_count = skip_count_;
+      cached->outer_sp = outer_sp;
+      cached->stack_hash = HashStackRegion(leaf_sp, outer_sp);
+      cached->frames.assign(out_frames_, out_frames_ + num_frames_);
+    }
+  }
 }
 
 bool BacktraceCollector::CollectImpl(unwindstack::Unwinder* unwinder) {
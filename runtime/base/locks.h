@@ -73,6 +73,8 @@ enum LockLevel : uint8_t {
   kRosAllocBracketLock,
   kRosAllocBulkFreeLock,
   kAllocSpaceLock,
+  kTaggingShardLock,
+  kTaggingUpdateLock,
   kTaggingLockLevel,
   kTransactionLogLock,
   kCustomTlsLock,
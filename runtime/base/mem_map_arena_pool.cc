@@ -26,11 +26,16 @@
 #include <android-base/logging.h>
 
 #include "base/arena_allocator-inl.h"
+#include "base/globals.h"
 #include "base/mem_map.h"
 #include "base/systrace.h"
 
 namespace art {
 
+// Bound on the dirty (not yet madvised) bytes retained by free arenas in the
+// pool; see MemMapArenaPool::FreeArenaChain().
+static constexpr size_t kMaxRetainedDirtyBytes = 8 * MB;
+
 class MemMapArena final : public Arena {
  public:
   MemMapArena(size_t size, bool low_4gb, const char* name);
@@ -54,8 +59,12 @@ MemMapArena::MemMapArena(size_t size, bool low_4gb, const char* name)
 
 MemMap MemMapArena::Allocate(size_t size, bool low_4gb, const char* name) {
   // Round up to a full page as that's the smallest unit of allocation for mmap()
-  // and we want to be able to use all memory that we actually allocate.
-  size = RoundUp(size, kPageSize);
+  // and we want to be able to use all memory that we actually allocate. Beyond
+  // that, round up to a power of two so that maps fall into a small number of
+  // size classes and freed maps can be reused for later requests of similar
+  // size instead of issuing a fresh mmap/munmap pair for every odd-sized
+  // arena. The padding is virtual address space only until actually touched.
+  size = RoundUpToPowerOfTwo(RoundUp(size, kPageSize));
   std::string error_msg;
   MemMap map = MemMap::MapAnonymous(name,
                                     size,
@@ -105,9 +114,21 @@ Arena* MemMapArenaPool::AllocArena(size_t size) {
   Arena* ret = nullptr;
   {
     std::lock_guard<std::mutex> lock(lock_);
-    if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
-      ret = free_arenas_;
-      free_arenas_ = free_arenas_->next_;
+    // Best-fit scan of the free list. Checking only the head, as this used to
+    // do, issued a fresh mmap whenever the most recently freed arena happened
+    // to be too small, leaving reusable maps stranded further down the list.
+    Arena** best = nullptr;
+    for (Arena** link = &free_arenas_; *link != nullptr; link = &(*link)->next_) {
+      if ((*link)->Size() >= size && (best == nullptr || (*link)->Size() < (*best)->Size())) {
+        best = link;
+        if ((*link)->Size() == size) {
+          break;
+        }
+      }
+    }
+    if (best != nullptr) {
+      ret = *best;
+      *best = ret->next_;
     }
   }
   if (ret == nullptr) {
@@ -159,6 +180,17 @@ void MemMapArenaPool::FreeArenaChain(Arena* first) {
     std::lock_guard<std::mutex> lock(lock_);
     last->next_ = free_arenas_;
     free_arenas_ = first;
+    // Keep all the maps (reusing an address range is the point of the pool) but
+    // bound the dirty pages they pin: madvise out arenas beyond the retention
+    // budget, counting from the head so the most recently freed -- and thus
+    // still cache-warm -- arenas keep their pages.
+    size_t retained_bytes = 0;
+    for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
+      retained_bytes += arena->GetBytesAllocated();
+      if (retained_bytes > kMaxRetainedDirtyBytes) {
+        arena->Release();
+      }
+    }
   }
 }
 
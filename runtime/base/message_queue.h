@@ -17,10 +17,13 @@
 #ifndef ART_RUNTIME_BASE_MESSAGE_QUEUE_H_
 #define ART_RUNTIME_BASE_MESSAGE_QUEUE_H_
 
+#include <array>
+#include <atomic>
 #include <deque>
 #include <optional>
 #include <variant>
 
+#include "base/bit_utils.h"
 #include "base/time_utils.h"
 #include "mutex.h"
 #include "thread.h"
@@ -89,19 +92,46 @@ struct TimeoutExpiredMessage {};
 //     )
 //
 // For additional examples, see message_queue_test.cc.
+//
+// Internally the queue is split in two tiers. Producers first try to publish into a small bounded
+// lock-free ring buffer, so concurrent senders do not serialize on the queue mutex and only take
+// the futex-based sleep/wake path when a consumer is actually blocked. If the ring is full, the
+// producer falls back to the mutex-protected overflow list; once a message has overflowed,
+// subsequent sends also go to the overflow list until the consumer drains it, so the overall FIFO
+// order of messages from any single producer is preserved. Consumers always take the mutex, which
+// keeps the receive side simple and safe for multiple consumers.
 template <typename... MessageTypes>
 class MessageQueue {
  public:
   using Message = std::variant<TimeoutExpiredMessage, MessageTypes...>;
 
+  MessageQueue() {
+    for (size_t i = 0; i < kRingCapacity; i++) {
+      ring_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
   // Adds a message to the message queue, which can later be received with ReceiveMessage. See class
   // comment for more details.
   void SendMessage(Message message) {
     // TimeoutExpiredMessage should not be sent manually.
     DCHECK(!std::holds_alternative<TimeoutExpiredMessage>(message));
+    if (!overflow_in_use_.load(std::memory_order_acquire) && TryEnqueueRing(message)) {
+      // Only wake a consumer if one announced itself as waiting. The fence orders our enqueue
+      // before the num_waiters_ read against the consumer's waiter registration before its final
+      // emptiness re-check, so a sleeping consumer cannot be missed.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (num_waiters_.load(std::memory_order_relaxed) != 0u) {
+        Thread* self = Thread::Current();
+        MutexLock lock{self, mutex_};
+        cv_.Signal(self);
+      }
+      return;
+    }
     Thread* self = Thread::Current();
     MutexLock lock{self, mutex_};
-    messages_.push_back(message);
+    overflow_in_use_.store(true, std::memory_order_release);
+    overflow_.push_back(message);
     cv_.Signal(self);
   }
 
@@ -129,21 +159,36 @@ class MessageQueue {
         return TimeoutExpiredMessage{};
       }
 
-      // Check if there is a message in the queue.
-      if (messages_.size() > 0) {
-        Message message = messages_.front();
-        messages_.pop_front();
+      // Check if there is a message in the queue. The ring holds the older messages, so it is
+      // drained before the overflow list.
+      Message message;
+      if (TryDequeueRing(&message)) {
+        return message;
+      }
+      if (overflow_.size() > 0) {
+        message = overflow_.front();
+        overflow_.pop_front();
+        if (overflow_.empty()) {
+          overflow_in_use_.store(false, std::memory_order_release);
+        }
         return message;
       }
 
-      // Otherwise, wait until we have a message or a timeout.
-      if (deadline_milliseconds_.has_value()) {
-        DCHECK_LE(current_time, deadline_milliseconds_.value());
-        int64_t timeout = static_cast<int64_t>(deadline_milliseconds_.value() - current_time);
-        cv_.TimedWait(self, timeout, /*ns=*/0);
-      } else {
-        cv_.Wait(self);
+      // Otherwise, wait until we have a message or a timeout. Announce the wait before re-checking
+      // the ring one last time; together with the fence in SendMessage this guarantees that either
+      // we see the producer's message or the producer sees our registration and signals.
+      num_waiters_.fetch_add(1u, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (RingEmpty()) {
+        if (deadline_milliseconds_.has_value()) {
+          DCHECK_LE(current_time, deadline_milliseconds_.value());
+          int64_t timeout = static_cast<int64_t>(deadline_milliseconds_.value() - current_time);
+          cv_.TimedWait(self, timeout, /*ns=*/0);
+        } else {
+          cv_.Wait(self);
+        }
       }
+      num_waiters_.fetch_sub(1u, std::memory_order_relaxed);
     }
   }
 
@@ -158,10 +203,78 @@ class MessageQueue {
   }
 
  private:
+  // Number of slots in the lock-free ring. Must be a power of two so that the slot index can be
+  // computed by masking the position counters. Messages beyond this bound fall back to overflow_.
+  static constexpr size_t kRingCapacity = 64;
+  static_assert(IsPowerOfTwo(kRingCapacity), "ring capacity must be a power of two");
+
+  // A ring slot. The sequence number encodes whether the slot is free for the producer whose
+  // position maps to it (sequence == position), filled and ready for a consumer
+  // (sequence == position + 1), or still in use from a previous lap.
+  struct RingCell {
+    std::atomic<size_t> sequence;
+    Message message;
+  };
+
+  // Attempt to publish a message into the ring without taking the mutex. Returns false if the ring
+  // is full, in which case the caller must fall back to the overflow list.
+  bool TryEnqueueRing(const Message& message) {
+    size_t pos = ring_enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      RingCell& cell = ring_[pos & (kRingCapacity - 1u)];
+      size_t seq = cell.sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (ring_enqueue_pos_.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed)) {
+          cell.message = message;
+          cell.sequence.store(pos + 1u, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // The slot is still occupied by a message a full lap behind: the ring is full.
+        return false;
+      } else {
+        // Another producer claimed this position; reload and try the next one.
+        pos = ring_enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Attempt to take the oldest message out of the ring. Consumers are serialized by mutex_, so the
+  // dequeue position needs no atomicity of its own.
+  bool TryDequeueRing(Message* message) REQUIRES(mutex_) {
+    RingCell& cell = ring_[ring_dequeue_pos_ & (kRingCapacity - 1u)];
+    size_t seq = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(ring_dequeue_pos_ + 1u) != 0) {
+      return false;
+    }
+    *message = cell.message;
+    // Mark the slot free for the producer that will reach it on the next lap.
+    cell.sequence.store(ring_dequeue_pos_ + kRingCapacity, std::memory_order_release);
+    ring_dequeue_pos_++;
+    return true;
+  }
+
+  bool RingEmpty() const REQUIRES(mutex_) {
+    const RingCell& cell = ring_[ring_dequeue_pos_ & (kRingCapacity - 1u)];
+    size_t seq = cell.sequence.load(std::memory_order_acquire);
+    return static_cast<intptr_t>(seq) - static_cast<intptr_t>(ring_dequeue_pos_ + 1u) != 0;
+  }
+
   Mutex mutex_{"MessageQueue Mutex"};
   ConditionVariable cv_{"MessageQueue ConditionVariable", mutex_};
 
-  std::deque<Message> messages_ GUARDED_BY(mutex_);
+  std::array<RingCell, kRingCapacity> ring_;
+  std::atomic<size_t> ring_enqueue_pos_{0u};
+  size_t ring_dequeue_pos_ GUARDED_BY(mutex_) = 0u;
+  // Number of consumers blocked (or about to block) in ReceiveMessage. Producers on the lock-free
+  // path only take the mutex to signal when this is non-zero.
+  std::atomic<size_t> num_waiters_{0u};
+
+  // Overflow list for messages that did not fit in the ring, and flag directing producers to it
+  // while it is non-empty so that per-producer FIFO order is maintained.
+  std::deque<Message> overflow_ GUARDED_BY(mutex_);
+  std::atomic<bool> overflow_in_use_{false};
   std::optional<uint64_t> deadline_milliseconds_ GUARDED_BY(mutex_);
 };
 
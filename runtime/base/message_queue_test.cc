@@ -212,6 +212,24 @@ TEST_F(MessageQueueTest, SwitchReceiveReturn) {
                                 [&]([[maybe_unused]] const auto& message) { return false; }));
 }
 
+TEST_F(MessageQueueTest, ManyMessagesInOrder) {
+  TestMessageQueue queue;
+
+  // Send well more messages than the internal lock-free ring can hold before receiving any, so
+  // that the later sends take the overflow path, and check that FIFO order is still preserved
+  // across the ring/overflow boundary.
+  constexpr int kNumMessages = 1000;
+  for (int i = 0; i < kNumMessages; i++) {
+    queue.SendMessage(IntMessage{i});
+  }
+
+  for (int i = 0; i < kNumMessages; i++) {
+    auto message = queue.ReceiveMessage();
+    ASSERT_TRUE(std::holds_alternative<IntMessage>(message));
+    ASSERT_EQ(std::get<IntMessage>(message).value, i);
+  }
+}
+
 TEST_F(MessageQueueTest, ReceiveInOrder) {
   TestMessageQueue queue;
 
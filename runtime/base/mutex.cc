@@ -118,20 +118,23 @@ static void BackOff(uint32_t i) {
   }
 }
 
-// Wait until pred(testLoc->load(std::memory_order_relaxed)) holds, or until a
-// short time interval, on the order of kernel context-switch time, passes.
-// Return true if the predicate test succeeded, false if we timed out.
+// Wait until pred(testLoc->load(std::memory_order_relaxed)) holds, or until roughly
+// max_iters back-offs, a short time interval on the order of kernel context-switch
+// time, have passed. Return true if the predicate test succeeded, false if we timed
+// out.
 template<typename Pred>
-static inline bool WaitBrieflyFor(AtomicInteger* testLoc, Thread* self, Pred pred) {
+static inline bool WaitBrieflyFor(AtomicInteger* testLoc,
+                                  Thread* self,
+                                  uint32_t max_iters,
+                                  Pred pred) {
   // TODO: Tune these parameters correctly. BackOff(3) should take on the order of 100 cycles. So
   // this should result in retrying <= 10 times, usually waiting around 100 cycles each. The
   // maximum delay should be significantly less than the expected futex() context switch time, so
   // there should be little danger of this worsening things appreciably. If the lock was only
   // held briefly by a running thread, this should help immensely.
   static constexpr uint32_t kMaxBackOff = 3;  // Should probably be <= kSpinMax above.
-  static constexpr uint32_t kMaxIters = 50;
   JNIEnvExt* const env = self == nullptr ? nullptr : self->GetJniEnv();
-  for (uint32_t i = 1; i <= kMaxIters; ++i) {
+  for (uint32_t i = 1; i <= max_iters; ++i) {
     BackOff(std::min(i, kMaxBackOff));
     if (pred(testLoc->load(std::memory_order_relaxed))) {
       return true;
@@ -173,6 +176,7 @@ class ScopedContentionRecorder final : public ValueObject {
         blocked_tid_(kLogLockContentions ? blocked_tid : 0),
         owner_tid_(kLogLockContentions ? owner_tid : 0),
         start_nano_time_(kLogLockContentions ? NanoTime() : 0) {
+    mutex->contention_count_.fetch_add(1, std::memory_order_relaxed);
     if (ATraceEnabled()) {
       std::string msg = StringPrintf("Lock contention on %s (owner tid: %" PRIu64 ")",
                                      mutex->GetName(), owner_tid);
@@ -199,23 +203,19 @@ BaseMutex::BaseMutex(const char* name, LockLevel level)
     : name_(name),
       level_(level),
       should_respond_to_empty_checkpoint_request_(false) {
-  if (kLogLockContentions) {
-    ScopedAllMutexesLock mu(this);
-    std::set<BaseMutex*>** all_mutexes_ptr = &gAllMutexData->all_mutexes;
-    if (*all_mutexes_ptr == nullptr) {
-      // We leak the global set of all mutexes to avoid ordering issues in global variable
-      // construction/destruction.
-      *all_mutexes_ptr = new std::set<BaseMutex*>();
-    }
-    (*all_mutexes_ptr)->insert(this);
+  ScopedAllMutexesLock mu(this);
+  std::set<BaseMutex*>** all_mutexes_ptr = &gAllMutexData->all_mutexes;
+  if (*all_mutexes_ptr == nullptr) {
+    // We leak the global set of all mutexes to avoid ordering issues in global variable
+    // construction/destruction.
+    *all_mutexes_ptr = new std::set<BaseMutex*>();
   }
+  (*all_mutexes_ptr)->insert(this);
 }
 
 BaseMutex::~BaseMutex() {
-  if (kLogLockContentions) {
-    ScopedAllMutexesLock mu(this);
-    gAllMutexData->all_mutexes->erase(this);
-  }
+  ScopedAllMutexesLock mu(this);
+  gAllMutexData->all_mutexes->erase(this);
 }
 
 void BaseMutex::DumpAll(std::ostream& os) {
@@ -244,6 +244,24 @@ void BaseMutex::DumpAll(std::ostream& os) {
   }
 }
 
+void BaseMutex::DumpContentionCounters(std::ostream& os) {
+  os << "Mutex contention counts:";
+  {
+    ScopedAllMutexesLock mu(reinterpret_cast<const BaseMutex*>(-1));
+    std::set<BaseMutex*>* all_mutexes = gAllMutexData->all_mutexes;
+    if (all_mutexes != nullptr) {
+      // One "name"=count pair per contended mutex, on a single line for easy scraping.
+      for (const BaseMutex* mutex : *all_mutexes) {
+        uint32_t count = mutex->contention_count_.load(std::memory_order_relaxed);
+        if (count != 0u) {
+          os << " \"" << mutex->name_ << "\"=" << count;
+        }
+      }
+    }
+  }
+  os << "\n";
+}
+
 void BaseMutex::CheckSafeToWait(Thread* self) {
   if (self == nullptr) {
     CheckUnattachedThread(level_);
@@ -331,6 +349,18 @@ void BaseMutex::RecordContention(uint64_t blocked_tid,
   }
 }
 
+void BaseMutex::AdjustSpinBudget(bool spin_succeeded) {
+  // Racy read-modify-write is fine, the budget is only a heuristic. Spinning pays
+  // off when the owner's recent hold times are shorter than a context switch, so
+  // grow the budget additively while spinning succeeds and shrink it
+  // multiplicatively once hold times exceed what the budget covers.
+  uint32_t budget = GetSpinBudget();
+  uint32_t new_budget = spin_succeeded
+      ? std::min(budget + kSpinItersStep, kMaxSpinIters)
+      : std::max(budget / 2, kMinSpinIters);
+  spin_budget_.store(new_budget, std::memory_order_relaxed);
+}
+
 void BaseMutex::DumpContention(std::ostream& os) const {
   if (kLogLockContentions) {
     const ContentionLogData* data = contention_log_data_;
@@ -448,8 +478,11 @@ void Mutex::ExclusiveLock(Thread* self) {
         // Empirically, it appears important to spin again each time through the loop; if we
         // bother to go to sleep and wake up, we should be fairly persistent in trying for the
         // lock.
-        if (!WaitBrieflyFor(&state_and_contenders_, self,
-                            [](int32_t v) { return (v & kHeldMask) == 0; })) {
+        bool acquirable_by_spinning =
+            WaitBrieflyFor(&state_and_contenders_, self, GetSpinBudget(),
+                           [](int32_t v) { return (v & kHeldMask) == 0; });
+        AdjustSpinBudget(acquirable_by_spinning);
+        if (!acquirable_by_spinning) {
           // Increment contender count. We can't create enough threads for this to overflow.
           increment_contenders();
           // Make cur_state again reflect the expected value of state_and_contenders.
@@ -610,7 +643,7 @@ bool Mutex::ExclusiveTryLockWithSpinning(Thread* self) {
       return true;
     }
 #if ART_USE_FUTEXES
-    if (!WaitBrieflyFor(&state_and_contenders_, self,
+    if (!WaitBrieflyFor(&state_and_contenders_, self, GetSpinBudget(),
             [](int32_t v) { return (v & kHeldMask) == 0; })) {
       return false;
     }
@@ -772,7 +805,10 @@ void ReaderWriterMutex::ExclusiveLock(Thread* self) {
     } else {
       // Failed to acquire, hang up.
       ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
-      if (!WaitBrieflyFor(&state_, self, [](int32_t v) { return v == 0; })) {
+      bool acquirable_by_spinning =
+          WaitBrieflyFor(&state_, self, GetSpinBudget(), [](int32_t v) { return v == 0; });
+      AdjustSpinBudget(acquirable_by_spinning);
+      if (!acquirable_by_spinning) {
         num_contenders_.fetch_add(1);
         if (UNLIKELY(should_respond_to_empty_checkpoint_request_)) {
           self->CheckEmptyCheckpointFromMutex();
@@ -851,7 +887,7 @@ bool ReaderWriterMutex::ExclusiveLockWithTimeout(Thread* self, int64_t ms, int32
         return false;  // Timed out.
       }
       ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
-      if (!WaitBrieflyFor(&state_, self, [](int32_t v) { return v == 0; })) {
+      if (!WaitBrieflyFor(&state_, self, GetSpinBudget(), [](int32_t v) { return v == 0; })) {
         num_contenders_.fetch_add(1);
         if (UNLIKELY(should_respond_to_empty_checkpoint_request_)) {
           self->CheckEmptyCheckpointFromMutex();
@@ -895,7 +931,10 @@ bool ReaderWriterMutex::ExclusiveLockWithTimeout(Thread* self, int64_t ms, int32
 void ReaderWriterMutex::HandleSharedLockContention(Thread* self, int32_t cur_state) {
   // Owner holds it exclusively, hang up.
   ScopedContentionRecorder scr(this, SafeGetTid(self), GetExclusiveOwnerTid());
-  if (!WaitBrieflyFor(&state_, self, [](int32_t v) { return v >= 0; })) {
+  bool acquirable_by_spinning =
+      WaitBrieflyFor(&state_, self, GetSpinBudget(), [](int32_t v) { return v >= 0; });
+  AdjustSpinBudget(acquirable_by_spinning);
+  if (!acquirable_by_spinning) {
     num_contenders_.fetch_add(1);
     if (UNLIKELY(should_respond_to_empty_checkpoint_request_)) {
       self->CheckEmptyCheckpointFromMutex();
@@ -70,7 +70,10 @@ constexpr bool kLogLockContentions = false;
 #endif
 constexpr size_t kContentionLogSize = 4;
 constexpr size_t kContentionLogDataSize = kLogLockContentions ? 1 : 0;
-constexpr size_t kAllMutexDataSize = kLogLockContentions ? 1 : 0;
+// The registry of all mutexes is always maintained so that the always-on contention
+// counters can be dumped via DumpContentionCounters(); the detailed contention log
+// above stays opt-in.
+constexpr size_t kAllMutexDataSize = 1;
 
 // Base class for all Mutex implementations
 class BaseMutex {
@@ -87,6 +90,11 @@ class BaseMutex {
 
   static void DumpAll(std::ostream& os);
 
+  // Dump one "name"=count pair per contended mutex on a single line, fed from the
+  // always-on contention counters. Machine-readable, unlike DumpAll() which needs
+  // kLogLockContentions builds.
+  static void DumpContentionCounters(std::ostream& os);
+
   bool ShouldRespondToEmptyCheckpointRequest() const {
     return should_respond_to_empty_checkpoint_request_;
   }
@@ -115,6 +123,17 @@ class BaseMutex {
   void RecordContention(uint64_t blocked_tid, uint64_t owner_tid, uint64_t nano_time_blocked);
   void DumpContention(std::ostream& os) const;
 
+  // Bounds for the adaptive spin budget used before falling back to a futex wait.
+  static constexpr uint32_t kMinSpinIters = 5;
+  static constexpr uint32_t kMaxSpinIters = 50;
+  static constexpr uint32_t kSpinItersStep = 5;
+
+  uint32_t GetSpinBudget() const {
+    return static_cast<uint32_t>(spin_budget_.load(std::memory_order_relaxed));
+  }
+
+  void AdjustSpinBudget(bool spin_succeeded);
+
   const char* const name_;
 
   // A log entry that records contention but makes no guarantee that either tid will be held live.
@@ -138,15 +157,23 @@ class BaseMutex {
   };
   ContentionLogData contention_log_data_[kContentionLogDataSize];
 
+  // Number of times this mutex has been contended, maintained regardless of
+  // kLogLockContentions: it costs one relaxed increment on the already expensive
+  // contended path and feeds the DumpContentionCounters() output.
+  AtomicInteger contention_count_;
+
+  // Iteration budget for briefly spinning on a contended lock before falling back
+  // to a futex wait. Adapted from recent outcomes as a proxy for the owner's hold
+  // times: a spin that observed the lock becoming free grows the budget, one that
+  // still ended in a futex wait shrinks it.
+  AtomicInteger spin_budget_{kMaxSpinIters};
+
   const LockLevel level_;  // Support for lock hierarchy.
   bool should_respond_to_empty_checkpoint_request_;
 
  public:
   bool HasEverContended() const {
-    if (kLogLockContentions) {
-      return contention_log_data_->contention_count.load(std::memory_order_seq_cst) > 0;
-    }
-    return false;
+    return contention_count_.load(std::memory_order_relaxed) > 0;
   }
 };
 
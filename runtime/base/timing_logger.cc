@@ -40,6 +40,9 @@ CumulativeLogger::CumulativeLogger(const std::string& name)
       lock_name_("CumulativeLoggerLock" + name),
       lock_(new Mutex(lock_name_.c_str(), kDefaultMutexLevel, true)) {
   Reset();
+  // Preallocate room for the distinct labels so that AddPair() typically does
+  // not allocate; the set of labels stabilizes after the first few iterations.
+  cumulative_timers_.reserve(kInitialTimersCapacity);
 }
 
 CumulativeLogger::~CumulativeLogger() {
@@ -132,9 +135,12 @@ TimingLogger::TimingLogger(const char* name,
                            bool verbose,
                            TimingLogger::TimingKind kind)
     : name_(name), precise_(precise), verbose_(verbose), kind_(kind) {
+  timings_.reserve(kInitialTimingsCapacity);
 }
 
 void TimingLogger::Reset() {
+  // clear() retains the capacity, so recording splits after a Reset() does not
+  // allocate until the number of splits exceeds all previous iterations.
   timings_.clear();
 }
 
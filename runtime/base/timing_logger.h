@@ -74,6 +74,9 @@ class CumulativeLogger {
   }
 
   static constexpr uint64_t kAdjust = 1000;
+  // Initial capacity for the cumulative timers, covering the usual number of
+  // distinct labels so that accumulation does not allocate in steady state.
+  static constexpr size_t kInitialTimersCapacity = 32;
   // Use a vector to keep dirty memory to minimal number of pages. Using a
   // hashtable would be performant, but could lead to more dirty pages. Also, we
   // don't expect this vector to be too big.
@@ -92,6 +95,13 @@ class TimingLogger {
  public:
   static constexpr size_t kIndexNotFound = static_cast<size_t>(-1);
 
+  // Number of timing records (a split produces a start and an end record) to
+  // preallocate so that recording splits does not allocate while the measured
+  // phase - e.g. a GC pause - is running. The vector keeps its capacity across
+  // Reset(), so the storage is reused from iteration to iteration and only
+  // grows if an iteration produces more splits than any one before it.
+  static constexpr size_t kInitialTimingsCapacity = 128;
+
   // Kind of timing we are going to do. We collect time at the nano second.
   enum class TimingKind {
     kMonotonic,
@@ -38,6 +38,7 @@ void ClassHierarchyAnalysis::AddDependency(ArtMethod* method,
   const auto it = cha_dependency_map_.insert(
       decltype(cha_dependency_map_)::value_type(method, ListOfDependentPairs())).first;
   it->second.push_back({dependent_method, dependent_header});
+  cha_dependent_header_map_[dependent_header].push_back(method);
 }
 
 static const ClassHierarchyAnalysis::ListOfDependentPairs s_empty_vector;
@@ -51,31 +52,59 @@ const ClassHierarchyAnalysis::ListOfDependentPairs& ClassHierarchyAnalysis::GetD
   return s_empty_vector;
 }
 
+void ClassHierarchyAnalysis::EraseFromDependentHeaderMap(ArtMethod* method,
+                                                         const ListOfDependentPairs& dependents) {
+  for (const MethodAndMethodHeaderPair& dependent : dependents) {
+    auto reverse_it = cha_dependent_header_map_.find(dependent.second);
+    DCHECK(reverse_it != cha_dependent_header_map_.end());
+    std::vector<ArtMethod*>& methods = reverse_it->second;
+    methods.erase(std::remove(methods.begin(), methods.end(), method), methods.end());
+    if (methods.empty()) {
+      cha_dependent_header_map_.erase(reverse_it);
+    }
+  }
+}
+
 void ClassHierarchyAnalysis::RemoveAllDependenciesFor(ArtMethod* method) {
-  cha_dependency_map_.erase(method);
+  auto it = cha_dependency_map_.find(method);
+  if (it == cha_dependency_map_.end()) {
+    return;
+  }
+  EraseFromDependentHeaderMap(method, it->second);
+  cha_dependency_map_.erase(it);
 }
 
 void ClassHierarchyAnalysis::RemoveDependentsWithMethodHeaders(
     const std::unordered_set<OatQuickMethodHeader*>& method_headers) {
-  // Iterate through all entries in the dependency map and remove any entry that
-  // contains one of those in method_headers.
-  for (auto map_it = cha_dependency_map_.begin(); map_it != cha_dependency_map_.end(); ) {
-    ListOfDependentPairs& dependents = map_it->second;
-    dependents.erase(
-        std::remove_if(
-            dependents.begin(),
-            dependents.end(),
-            [&method_headers](MethodAndMethodHeaderPair& dependent) {
-              return method_headers.find(dependent.second) != method_headers.end();
-            }),
-        dependents.end());
-
-    // Remove the map entry if there are no more dependents.
-    if (dependents.empty()) {
-      map_it = cha_dependency_map_.erase(map_it);
-    } else {
-      map_it++;
+  // Use the reverse index so that the work is proportional to the freed code, not to
+  // the number of dependencies recorded for the whole code cache. This runs under
+  // cha_lock_ during code cache collections and used to stall class linking.
+  for (OatQuickMethodHeader* method_header : method_headers) {
+    auto reverse_it = cha_dependent_header_map_.find(method_header);
+    if (reverse_it == cha_dependent_header_map_.end()) {
+      // Compiled code without CHA dependencies, or dependencies that have already
+      // been removed by an invalidation.
+      continue;
+    }
+    for (ArtMethod* method : reverse_it->second) {
+      auto map_it = cha_dependency_map_.find(method);
+      DCHECK(map_it != cha_dependency_map_.end());
+      ListOfDependentPairs& dependents = map_it->second;
+      dependents.erase(
+          std::remove_if(
+              dependents.begin(),
+              dependents.end(),
+              [method_header](MethodAndMethodHeaderPair& dependent) {
+                return dependent.second == method_header;
+              }),
+          dependents.end());
+
+      // Remove the map entry if there are no more dependents.
+      if (dependents.empty()) {
+        cha_dependency_map_.erase(map_it);
+      }
     }
+    cha_dependent_header_map_.erase(reverse_it);
   }
 }
 
@@ -711,6 +740,7 @@ void ClassHierarchyAnalysis::RemoveDependenciesForLinearAlloc(const LinearAlloc*
     // Use unsafe to avoid locking since the allocator is going to be deleted.
     if (linear_alloc->ContainsUnsafe(it->first)) {
       // About to delete the ArtMethod, erase the entry from the map.
+      EraseFromDependentHeaderMap(it->first, it->second);
       it = cha_dependency_map_.erase(it);
     } else {
       ++it;
@@ -166,11 +166,22 @@ class ClassHierarchyAnalysis {
       std::unordered_set<ArtMethod*>& invalidated_single_impl_methods)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Remove `method` from the reverse index entries of all of `dependents`.
+  // Called when the cha_dependency_map_ entry for `method` goes away.
+  void EraseFromDependentHeaderMap(ArtMethod* method, const ListOfDependentPairs& dependents)
+      REQUIRES(Locks::cha_lock_);
+
   // A map that maps a method to a set of compiled code that assumes that method has a
   // single implementation, which is used to do CHA-based devirtualization.
   std::unordered_map<ArtMethod*, ListOfDependentPairs> cha_dependency_map_
     GUARDED_BY(Locks::cha_lock_);
 
+  // Reverse index of cha_dependency_map_: for each dependent method header, the methods
+  // whose dependent lists reference it. This makes removing dependents when compiled
+  // code is freed proportional to the freed code instead of the whole dependency map.
+  std::unordered_map<OatQuickMethodHeader*, std::vector<ArtMethod*>> cha_dependent_header_map_
+    GUARDED_BY(Locks::cha_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(ClassHierarchyAnalysis);
 };
 
@@ -90,4 +90,32 @@ TEST_F(CHATest, CHACheckDependency) {
   ASSERT_TRUE(cha.GetDependents(METHOD3).empty());
 }
 
+TEST_F(CHATest, CHARemoveDependentsSharedHeader) {
+  ClassHierarchyAnalysis cha;
+  MutexLock cha_mu(Thread::Current(), *Locks::cha_lock_);
+
+  // METHOD_HEADER3 records dependencies on both METHOD1 and METHOD2.
+  cha.AddDependency(METHOD1, METHOD3, METHOD_HEADER3);
+  cha.AddDependency(METHOD2, METHOD3, METHOD_HEADER3);
+  cha.AddDependency(METHOD1, METHOD2, METHOD_HEADER2);
+
+  std::unordered_set<OatQuickMethodHeader*> headers;
+  headers.insert(METHOD_HEADER3);
+  cha.RemoveDependentsWithMethodHeaders(headers);
+  ASSERT_TRUE(cha.GetDependents(METHOD2).empty());
+  auto dependents = cha.GetDependents(METHOD1);
+  ASSERT_EQ(dependents.size(), 1u);
+  ASSERT_EQ(dependents[0].first, METHOD2);
+  ASSERT_EQ(dependents[0].second, METHOD_HEADER2);
+
+  // Removing by method must also unlink the reverse index so that removing the
+  // dependent's header later does not see a stale entry.
+  cha.RemoveAllDependenciesFor(METHOD1);
+  headers.insert(METHOD_HEADER2);
+  cha.RemoveDependentsWithMethodHeaders(headers);
+  ASSERT_TRUE(cha.GetDependents(METHOD1).empty());
+  ASSERT_TRUE(cha.GetDependents(METHOD2).empty());
+  ASSERT_TRUE(cha.GetDependents(METHOD3).empty());
+}
+
 }  // namespace art
@@ -4352,20 +4352,31 @@ ObjPtr<mirror::Class> ClassLinker::InsertClass(const char* descriptor,
     }
     LOG(INFO) << "Loaded class " << descriptor << source;
   }
-  {
+  const ObjPtr<mirror::ClassLoader> class_loader = klass->GetClassLoader();
+  ClassTable* class_table = ClassTableForClassLoader(class_loader);
+  if (class_table == nullptr) {
+    // First class inserted for this class loader; registering the loader and creating
+    // its class table needs the global lock.
+    WriterMutexLock mu(Thread::Current(), *Locks::classlinker_classes_lock_);
+    class_table = InsertClassTableForClassLoader(class_loader);
+  }
+  VerifyObject(klass);
+  // The per-table lock is held across the lookup and the insertion, so concurrent
+  // inserts of the same descriptor agree on a single winner without serializing
+  // unrelated class loaders on the global lock.
+  ObjPtr<mirror::Class> existing = class_table->TryInsertWithHash(descriptor, klass, hash);
+  if (existing != nullptr) {
+    return existing;
+  }
+  if (class_loader != nullptr) {
+    // This is necessary because we need to have the card dirtied for remembered sets.
+    WriteBarrier::ForEveryFieldWrite(class_loader);
+  }
+  if (!kUseReadBarrier) {
+    // Non-CC collectors track roots inserted while concurrent marking is running. The
+    // class stays reachable from this thread's stack until the log entry is added, so
+    // logging after the table insertion cannot lose it.
     WriterMutexLock mu(Thread::Current(), *Locks::classlinker_classes_lock_);
-    const ObjPtr<mirror::ClassLoader> class_loader = klass->GetClassLoader();
-    ClassTable* const class_table = InsertClassTableForClassLoader(class_loader);
-    ObjPtr<mirror::Class> existing = class_table->Lookup(descriptor, hash);
-    if (existing != nullptr) {
-      return existing;
-    }
-    VerifyObject(klass);
-    class_table->InsertWithHash(klass, hash);
-    if (class_loader != nullptr) {
-      // This is necessary because we need to have the card dirtied for remembered sets.
-      WriteBarrier::ForEveryFieldWrite(class_loader);
-    }
     if (log_new_roots_) {
       new_class_roots_.push_back(GcRoot<mirror::Class>(klass));
     }
@@ -4403,11 +4414,12 @@ ObjPtr<mirror::Class> ClassLinker::LookupClass(Thread* self,
   return LookupClass(self, descriptor, ComputeModifiedUtf8Hash(descriptor), class_loader);
 }
 
-ObjPtr<mirror::Class> ClassLinker::LookupClass(Thread* self,
+ObjPtr<mirror::Class> ClassLinker::LookupClass(Thread* self ATTRIBUTE_UNUSED,
                                                const char* descriptor,
                                                size_t hash,
                                                ObjPtr<mirror::ClassLoader> class_loader) {
-  ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
+  // The reader lock taken by ClassTable::Lookup is sufficient; taking the global
+  // classlinker_classes_lock_ here would serialize lookups across unrelated loaders.
   ClassTable* const class_table = ClassTableForClassLoader(class_loader);
   if (class_table != nullptr) {
     ObjPtr<mirror::Class> result = class_table->Lookup(descriptor, hash);
@@ -4526,6 +4538,48 @@ bool ClassLinker::AttemptSupertypeVerification(Thread* self,
   return false;
 }
 
+// Returns whether runtime verification of `klass` can be optimistically deferred to a
+// background thread because the vdex file records a successful compile-time verification
+// whose environment-dependent type checks merely need to be re-established.
+static bool CanDeferClassVerification(Handle<mirror::Class> klass,
+                                      ClassStatus oat_file_class_status)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (oat_file_class_status != ClassStatus::kResolved) {
+    // `VdexFile::ComputeClassStatus` did not request a runtime re-verification.
+    return false;
+  }
+  Runtime* const runtime = Runtime::Current();
+  if (runtime->IsAotCompiler()) {
+    // The compiler handles soft failures with ClassStatus::kRetryVerificationAtRuntime.
+    return false;
+  }
+  if (runtime->IsJavaDebuggable()) {
+    // Threads created by ThreadPool ("runtime threads") are not allowed to load classes
+    // when debuggable, so the background re-verification could never lift access checks.
+    return false;
+  }
+  if (runtime->IsVerificationSoftFail()) {
+    // Forced soft failures must run the full verifier to mark the methods appropriately.
+    return false;
+  }
+  if (klass->GetClassLoader() == nullptr) {
+    // Only defer for app classes; boot classes are loaded during startup where the
+    // background verification thread pool is not yet available.
+    return false;
+  }
+  const DexFile& dex_file = klass->GetDexFile();
+  const OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
+  if (oat_dex_file == nullptr || oat_dex_file->GetOatFile() == nullptr) {
+    return false;
+  }
+  const VdexFile* vdex_file = oat_dex_file->GetOatFile()->GetVdexFile();
+  // Only defer when the compile-time verifier fully checked the class; a class without
+  // a verifier deps entry may contain structurally invalid bytecode which must be
+  // rejected before execution.
+  return vdex_file != nullptr &&
+         vdex_file->HasVerifiedClass(dex_file, klass->GetDexClassDefIndex());
+}
+
 verifier::FailureKind ClassLinker::VerifyClass(Thread* self,
                                                verifier::VerifierDeps* verifier_deps,
                                                Handle<mirror::Class> klass,
@@ -4680,6 +4734,27 @@ verifier::FailureKind ClassLinker::VerifyClass(Thread* self,
   std::string error_msg;
   verifier::FailureKind verifier_failure = verifier::FailureKind::kNoFailure;
   if (!preverified) {
+    if (CanDeferClassVerification(klass, oat_file_class_status)) {
+      // The verifier successfully checked the class when the app was compiled, but the
+      // type checks recorded in the vdex file no longer hold in this class loading
+      // environment, typically on the first launch after an update of one of the app's
+      // dependencies. The bytecode is known to be structurally valid, so instead of
+      // re-verifying on the loading thread, let execution proceed with access checks in
+      // the interpreter and re-verify the methods in the background, which lifts the
+      // access checks on success.
+      {
+        ObjectLock<mirror::Class> lock(self, klass);
+        self->AssertNoPendingException();
+        // Make sure all classes referenced by catch blocks are resolved.
+        ResolveClassExceptionHandlerTypes(klass);
+        // As this is an optimistic verified status, make sure the methods are _not_
+        // marked kAccSkipAccessChecks until the background re-verification succeeds.
+        klass->SetVerificationAttempted();
+        mirror::Class::SetStatus(klass, ClassStatus::kVerified, self);
+      }
+      Runtime::Current()->GetOatFileManager().EnqueueBackgroundReverification(self, klass.Get());
+      return verifier::FailureKind::kAccessChecksFailure;
+    }
     verifier_failure = PerformClassVerification(self, verifier_deps, klass, log_level, &error_msg);
   }
 
@@ -7684,9 +7759,12 @@ class ClassLinker::LinkInterfaceMethodsHelper {
   void CheckNoStaleMethodsInDexCache() REQUIRES_SHARED(Locks::mutator_lock_) {
     if (kIsDebugBuild) {
       PointerSize pointer_size = class_linker_->GetImagePointerSize();
-      // Check that there are no stale methods are in the dex cache array.
+      // Check that there are no stale methods are in the dex cache array. The array is
+      // materialized lazily and may still be null.
       auto* resolved_methods = klass_->GetDexCache()->GetResolvedMethods();
-      for (size_t i = 0, count = klass_->GetDexCache()->NumResolvedMethods(); i < count; ++i) {
+      for (size_t i = 0, count = klass_->GetDexCache()->NumResolvedMethods();
+           resolved_methods != nullptr && i < count;
+           ++i) {
         auto pair = mirror::DexCache::GetNativePair(resolved_methods, i);
         ArtMethod* m = pair.object;
         CHECK(move_table_.find(m) == move_table_.end() ||
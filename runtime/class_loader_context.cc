@@ -607,6 +607,19 @@ std::string ClassLoaderContext::EncodeContext(const std::string& base_dir,
     DCHECK_EQ(GetParentChainSize(), stored_context->GetParentChainSize());
   }
 
+  // Queries without a stored context are pure functions of the (immutable at
+  // this point) chain and can be memoized. Queries with a stored context
+  // depend on the remapped locations and are not worth caching.
+  const bool cacheable = (stored_context == nullptr);
+  std::string cache_key;
+  if (cacheable) {
+    cache_key = (for_dex2oat ? "d|" : "o|") + base_dir;
+    auto it = cached_encodings_.find(cache_key);
+    if (it != cached_encodings_.end()) {
+      return it->second;
+    }
+  }
+
   std::ostringstream out;
   if (class_loader_chain_ == nullptr) {
     // We can get in this situation if the context was created with a class path containing the
@@ -623,7 +636,11 @@ std::string ClassLoaderContext::EncodeContext(const std::string& base_dir,
       for_dex2oat,
       (stored_context == nullptr ? nullptr : stored_context->class_loader_chain_.get()),
       out);
-  return out.str();
+  std::string encoded(out.str());
+  if (cacheable) {
+    cached_encodings_.Put(cache_key, encoded);
+  }
+  return encoded;
 }
 
 void ClassLoaderContext::EncodeClassPath(const std::string& base_dir,
@@ -23,6 +23,7 @@
 
 #include "arch/instruction_set.h"
 #include "base/dchecked_vector.h"
+#include "base/safe_map.h"
 #include "dex/dex_file.h"
 #include "handle_scope.h"
 #include "mirror/class_loader.h"
@@ -364,6 +365,15 @@ class ClassLoaderContext {
   // The class loader chain.
   std::unique_ptr<ClassLoaderInfo> class_loader_chain_;
 
+  // Memoized EncodeContext results for queries without a stored context,
+  // keyed by base_dir with a for_dex2oat marker prefix. Encoding requires the
+  // dex files to be opened and the chain cannot be mutated afterwards
+  // (RemoveLocationsFromClassPaths CHECKs for unopened dex files), so entries
+  // never need invalidating. Deep shared-library chains are re-encoded on
+  // every oat file open otherwise. Like the rest of this class, this cache is
+  // not thread-safe.
+  mutable SafeMap<std::string, std::string> cached_encodings_;
+
   // The opening state of the dex files.
   ContextDexFilesState dex_files_state_;
 
@@ -22,6 +22,8 @@
 
 namespace art {
 
+Atomic<uint64_t> ClassTable::global_generation_(0u);
+
 ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
   Runtime* const runtime = Runtime::Current();
   classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
@@ -30,6 +32,7 @@ ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock
 
 void ClassTable::FreezeSnapshot() {
   WriterMutexLock mu(Thread::Current(), lock_);
+  num_frozen_sets_ = classes_.size();
   classes_.push_back(ClassSet());
 }
 
@@ -37,16 +40,23 @@ ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
                                               ObjPtr<mirror::Class> klass,
                                               size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  // Should only be updating latest table.
+  // Should only be updating a non-frozen table; search the newer sets first as the
+  // class being updated was inserted recently.
   DescriptorHashPair pair(descriptor, hash);
-  auto existing_it = classes_.back().FindWithHash(pair, hash);
-  if (existing_it == classes_.back().end()) {
-    for (const ClassSet& class_set : classes_) {
-      if (class_set.FindWithHash(pair, hash) != class_set.end()) {
-        LOG(FATAL) << "Updating class found in frozen table " << descriptor;
-      }
+  ClassSet::iterator existing_it;
+  size_t containing_set_index = classes_.size();
+  for (size_t i = classes_.size(); i != 0u; ) {
+    --i;
+    existing_it = classes_[i].FindWithHash(pair, hash);
+    if (existing_it != classes_[i].end()) {
+      containing_set_index = i;
+      break;
     }
+  }
+  if (containing_set_index == classes_.size()) {
     LOG(FATAL) << "Updating class not found " << descriptor;
+  } else if (containing_set_index < num_frozen_sets_) {
+    LOG(FATAL) << "Updating class found in frozen table " << descriptor;
   }
   const ObjPtr<mirror::Class> existing = existing_it->Read();
   CHECK_NE(existing, klass) << descriptor;
@@ -57,6 +67,7 @@ ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
   // Update the element in the hash set with the new class. This is safe to do since the descriptor
   // doesn't change.
   *existing_it = TableSlot(klass, hash);
+  IncrementGlobalGeneration();
   return existing;
 }
 
@@ -74,7 +85,7 @@ size_t ClassTable::CountDefiningLoaderClasses(ObjPtr<mirror::ClassLoader> defini
 size_t ClassTable::NumZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader) const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
+  for (size_t i = 0; i < num_frozen_sets_; ++i) {
     sum += CountDefiningLoaderClasses(defining_loader, classes_[i]);
   }
   return sum;
@@ -82,13 +93,17 @@ size_t ClassTable::NumZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader)
 
 size_t ClassTable::NumNonZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader) const {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  return CountDefiningLoaderClasses(defining_loader, classes_.back());
+  size_t sum = 0;
+  for (size_t i = num_frozen_sets_; i < classes_.size(); ++i) {
+    sum += CountDefiningLoaderClasses(defining_loader, classes_[i]);
+  }
+  return sum;
 }
 
 size_t ClassTable::NumReferencedZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
+  for (size_t i = 0; i < num_frozen_sets_; ++i) {
     sum += classes_[i].size();
   }
   return sum;
@@ -96,7 +111,11 @@ size_t ClassTable::NumReferencedZygoteClasses() const {
 
 size_t ClassTable::NumReferencedNonZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  return classes_.back().size();
+  size_t sum = 0;
+  for (size_t i = num_frozen_sets_; i < classes_.size(); ++i) {
+    sum += classes_[i].size();
+  }
+  return sum;
 }
 
 ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
@@ -117,7 +136,37 @@ void ClassTable::Insert(ObjPtr<mirror::Class> klass) {
 
 void ClassTable::InsertWithHash(ObjPtr<mirror::Class> klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  GetInsertionSetLocked().InsertWithHash(TableSlot(klass, hash), hash);
+  IncrementGlobalGeneration();
+}
+
+ObjPtr<mirror::Class> ClassTable::TryInsertWithHash(const char* descriptor,
+                                                    ObjPtr<mirror::Class> klass,
+                                                    size_t hash) {
+  DescriptorHashPair pair(descriptor, hash);
+  WriterMutexLock mu(Thread::Current(), lock_);
+  for (ClassSet& class_set : classes_) {
+    auto it = class_set.FindWithHash(pair, hash);
+    if (it != class_set.end()) {
+      return it->Read();
+    }
+  }
+  GetInsertionSetLocked().InsertWithHash(TableSlot(klass, hash), hash);
+  IncrementGlobalGeneration();
+  return nullptr;
+}
+
+ClassTable::ClassSet& ClassTable::GetInsertionSetLocked() {
+  Runtime* const runtime = Runtime::Current();
+  if (UNLIKELY(classes_.back().size() >= kMaxInsertionSetSize) && !runtime->IsAotCompiler()) {
+    // Growing the set rehashes all of its slots with the lock held, stalling
+    // concurrent lookups, so keep the insertion set bounded and start a new one
+    // once it is full. The previous set becomes read-mostly from here on.
+    // The AOT compiler keeps a single set as the image writer serializes it as one.
+    classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
+                                runtime->GetHashTableMaxLoadFactor()));
+  }
+  return classes_.back();
 }
 
 bool ClassTable::Remove(const char* descriptor) {
@@ -127,6 +176,7 @@ bool ClassTable::Remove(const char* descriptor) {
     auto it = class_set.find(pair);
     if (it != class_set.end()) {
       class_set.erase(it);
+      IncrementGlobalGeneration();
       return true;
     }
   }
@@ -177,6 +227,9 @@ size_t ClassTable::ReadFromMemory(uint8_t* ptr) {
 void ClassTable::AddClassSet(ClassSet&& set) {
   WriterMutexLock mu(Thread::Current(), lock_);
   classes_.insert(classes_.begin(), std::move(set));
+  // The added set is never inserted into, treat it like a frozen snapshot.
+  ++num_frozen_sets_;
+  IncrementGlobalGeneration();
 }
 
 void ClassTable::ClearStrongRoots() {
@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "base/allocator.h"
+#include "base/atomic.h"
 #include "base/hash_set.h"
 #include "base/macros.h"
 #include "base/mutex.h"
@@ -217,6 +218,15 @@ class ClassTable {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Insert the class if no class with the same descriptor is present yet, holding the
+  // table lock across the lookup and the insertion. Returns the pre-existing class with
+  // a matching descriptor if there is one, null if the class was inserted.
+  ObjPtr<mirror::Class> TryInsertWithHash(const char* descriptor,
+                                          ObjPtr<mirror::Class> klass,
+                                          size_t hash)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Returns true if the class was found and removed, false otherwise.
   bool Remove(const char* descriptor)
       REQUIRES(!lock_)
@@ -257,27 +267,59 @@ class ClassTable {
     return lock_;
   }
 
+  // Value of a process-wide counter incremented whenever any ClassTable gains or loses a class.
+  // Clients that enumerate all loaded classes can record the generation their enumeration
+  // observed and cheaply detect whether it may have gone stale.
+  static uint64_t GetGlobalGeneration() {
+    return global_generation_.load(std::memory_order_relaxed);
+  }
+
  private:
+  // Maximum number of elements in the set new classes are inserted into. When the set
+  // is full a fresh one is started so that a single growth rehash, which runs with
+  // `lock_` held and blocks concurrent lookups, stays bounded no matter how many
+  // classes the table holds.
+  static constexpr size_t kMaxInsertionSetSize = 2048;
+
   size_t CountDefiningLoaderClasses(ObjPtr<mirror::ClassLoader> defining_loader,
                                     const ClassSet& set) const
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return the class set new classes are inserted into, starting a new set if the
+  // current one has reached kMaxInsertionSetSize. Lookup searches all sets, so
+  // spilled sets simply become read-mostly.
+  ClassSet& GetInsertionSetLocked()
+      REQUIRES(lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Return true if we inserted the oat file, false if it already exists.
   bool InsertOatFileLocked(const OatFile* oat_file)
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Incremented with the modified table's lock held so that a reader which samples the
+  // generation before visiting the tables can never observe a value that already accounts
+  // for a class the visit will miss.
+  static void IncrementGlobalGeneration() {
+    global_generation_.fetch_add(1u, std::memory_order_relaxed);
+  }
+
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
   // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
   std::vector<ClassSet> classes_ GUARDED_BY(lock_);
+  // Number of leading frozen snapshot sets in `classes_`. Sets past this index were
+  // started to keep the insertion set bounded and count as non-zygote classes.
+  size_t num_frozen_sets_ GUARDED_BY(lock_) = 0u;
   // Extra strong roots that can be either dex files or dex caches. Dex files used by the class
   // loader which may not be owned by the class loader must be held strongly live. Also dex caches
   // are held live to prevent them being unloading once they have classes in them.
   std::vector<GcRoot<mirror::Object>> strong_roots_ GUARDED_BY(lock_);
   // Keep track of oat files with GC roots associated with dex caches in `strong_roots_`.
   std::vector<const OatFile*> oat_files_ GUARDED_BY(lock_);
+  // See GetGlobalGeneration().
+  static Atomic<uint64_t> global_generation_;
 
   friend class linker::ImageWriter;  // for InsertWithoutLocks.
 };
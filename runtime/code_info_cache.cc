@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_info_cache.h"
+
+#include "oat_quick_method_header.h"
+
+namespace art {
+
+std::atomic<uint32_t> CodeInfoCache::global_generation_(0u);
+
+CodeInfo CodeInfoCache::GetCodeInfo(const OatQuickMethodHeader* header) {
+  DCHECK(header != nullptr);
+  uint32_t generation = global_generation_.load(std::memory_order_acquire);
+  if (UNLIKELY(generation != generation_)) {
+    // JIT code has been freed since the entries were filled; the header
+    // addresses they are keyed by may have been reused.
+    Clear();
+    generation_ = generation;
+  }
+  size_t victim = 0;
+  for (size_t i = 0; i != kSize; ++i) {
+    if (keys_[i] == header) {
+      ticks_[i] = ++tick_;
+      return entries_[i];
+    }
+    if (ticks_[i] < ticks_[victim]) {
+      victim = i;
+    }
+  }
+  keys_[victim] = header;
+  entries_[victim] = CodeInfo(header);
+  ticks_[victim] = ++tick_;
+  return entries_[victim];
+}
+
+}  // namespace art
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CODE_INFO_CACHE_H_
+#define ART_RUNTIME_CODE_INFO_CACHE_H_
+
+#include <algorithm>
+#include <atomic>
+
+#include "base/macros.h"
+#include "stack_map.h"
+
+namespace art {
+
+class OatQuickMethodHeader;
+
+// Small thread-local cache of decoded CodeInfo, keyed by the method header of
+// the compiled code. Decoding the bit-packed CodeInfo header and table
+// metadata is a nontrivial constant cost per query, and the same method's
+// CodeInfo is decoded several times while processing a single frame during
+// exception delivery and deoptimization -- and again on the next throw through
+// the same frames. All operations must be done from the owning thread, or at a
+// point when the owning thread is suspended.
+//
+// An OatQuickMethodHeader* is not a stable key for JIT code: once the code is
+// freed, the memory can be reused for a different method (see
+// JitCodeCache::FreeAllMethodHeaders). The cache therefore records the global
+// generation counter at fill time; the JIT code cache increments the counter
+// before freeing any code, and a lookup that observes a newer generation
+// discards all entries. Oat code is never unmapped while the runtime runs.
+class CodeInfoCache {
+ public:
+  // Catch handler search plus vreg copying touches at most a few distinct
+  // methods per throw; a handful of entries already captures the reuse.
+  static constexpr size_t kSize = 4;
+
+  CodeInfoCache() {}
+
+  // Return the decoded CodeInfo for `header`, decoding on a miss. The result
+  // is returned by value: a reference into the cache could be evicted by a
+  // nested lookup while still in use.
+  CodeInfo GetCodeInfo(const OatQuickMethodHeader* header);
+
+  void Clear() {
+    std::fill(std::begin(keys_), std::end(keys_), nullptr);
+  }
+
+  // Invalidate the cached entries of all threads. Called by the JIT code
+  // cache before freeing code, so that a reused method header address cannot
+  // alias a stale decoded entry.
+  static void IncrementGlobalGeneration() {
+    global_generation_.fetch_add(1u, std::memory_order_seq_cst);
+  }
+
+ private:
+  static std::atomic<uint32_t> global_generation_;
+
+  // Generation observed when the entries were filled.
+  uint32_t generation_ = 0u;
+  // Pseudo-time of the last hit on each entry, for least-recently-used
+  // eviction. The tick counter monotonically increases per lookup.
+  uint64_t tick_ = 0u;
+  uint64_t ticks_[kSize] = {};
+  const OatQuickMethodHeader* keys_[kSize] = {};
+  CodeInfo entries_[kSize];
+
+  DISALLOW_COPY_AND_ASSIGN(CodeInfoCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CODE_INFO_CACHE_H_
@@ -46,7 +46,16 @@ void CompatFramework::LogChange(uint64_t change_id) {
 }
 
 void CompatFramework::ReportChange(uint64_t change_id, ChangeState state) {
-  MutexLock mu(Thread::Current(), reported_compat_changes_lock_);
+  Thread* self = Thread::Current();
+  {
+    // The change has usually been reported already; check with the lock held shared
+    // so that concurrent queries for reported changes do not serialize.
+    ReaderMutexLock mu(self, reported_compat_changes_lock_);
+    if (reported_compat_changes_.count(change_id) != 0) {
+      return;
+    }
+  }
+  WriterMutexLock mu(self, reported_compat_changes_lock_);
   bool already_reported = reported_compat_changes_.count(change_id) != 0;
   if (already_reported) {
     return;
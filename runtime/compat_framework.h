@@ -69,9 +69,11 @@ class CompatFramework {
   // A set of disabled compat changes for the running app, all other changes are enabled.
   std::set<uint64_t> disabled_compat_changes_;
 
-  // A set of reported compat changes for the running app.
+  // A set of reported compat changes for the running app. Readers take the lock shared
+  // so that the common already-reported case does not serialize hot callers such as the
+  // hidden API checks.
   std::set<uint64_t> reported_compat_changes_ GUARDED_BY(reported_compat_changes_lock_);
-  Mutex reported_compat_changes_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  ReaderWriterMutex reported_compat_changes_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 };
 
 }  // namespace art
@@ -1332,6 +1332,173 @@ bool ElfFileImpl<ElfTypes>::Load(File* file,
   return true;
 }
 
+template <typename ElfTypes>
+bool ElfFileImpl<ElfTypes>::MapLazySection(File* file,
+                                           Elf_Off offset,
+                                           size_t size,
+                                           const char* label,
+                                           bool low_4gb,
+                                           /*out*/uint8_t** target,
+                                           std::string* error_msg) {
+  int64_t file_length = file->GetLength();
+  if (file_length < 0 ||
+      static_cast<uint64_t>(file_length) < static_cast<uint64_t>(offset) + size) {
+    *error_msg = StringPrintf("File size of %" PRId64 " bytes not large enough to contain %s of "
+                              "%zd bytes at offset %" PRIu64 ": '%s'",
+                              file_length, label, size, static_cast<uint64_t>(offset),
+                              file->GetPath().c_str());
+    return false;
+  }
+  MemMap map = MemMap::MapFile(size,
+                               PROT_READ,
+                               MAP_PRIVATE,
+                               file->Fd(),
+                               offset,
+                               low_4gb,
+                               file->GetPath().c_str(),
+                               error_msg);
+  if (!map.IsValid()) {
+    *error_msg = StringPrintf("Failed to map %s from %s: %s",
+                              label, file->GetPath().c_str(), error_msg->c_str());
+    return false;
+  }
+  *target = map.Begin();
+  lazy_section_maps_.push_back(std::move(map));
+  return true;
+}
+
+template <typename ElfTypes>
+bool ElfFileImpl<ElfTypes>::FindFileOffsetForVirtualAddress(Elf_Addr vaddr,
+                                                            /*out*/Elf_Off* offset) const {
+  for (Elf_Word i = 0; i < GetProgramHeaderNum(); i++) {
+    Elf_Phdr* program_header = GetProgramHeader(i);
+    if (program_header->p_type == PT_LOAD &&
+        program_header->p_vaddr <= vaddr &&
+        vaddr < program_header->p_vaddr + program_header->p_filesz) {
+      *offset = program_header->p_offset + (vaddr - program_header->p_vaddr);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename ElfTypes>
+bool ElfFileImpl<ElfTypes>::MapDynamicSymbolSections(File* file,
+                                                     bool low_4gb,
+                                                     std::string* error_msg) {
+  CHECK(program_header_only_) << file->GetPath();
+  CHECK(base_address_ == nullptr) << "Already loaded: " << file->GetPath();
+
+  dynamic_program_header_ = FindProgamHeaderByType(PT_DYNAMIC);
+  if (dynamic_program_header_ == nullptr) {
+    *error_msg = StringPrintf("Failed to find PT_DYNAMIC program header in ELF file: '%s'",
+                              file->GetPath().c_str());
+    return false;
+  }
+
+  // Map the dynamic table to find where the hash, .dynsym and .dynstr live.
+  uint8_t* dynamic_target = nullptr;
+  if (!MapLazySection(file,
+                      GetDynamicProgramHeader().p_offset,
+                      GetDynamicProgramHeader().p_filesz,
+                      "dynamic section",
+                      low_4gb,
+                      &dynamic_target,
+                      error_msg)) {
+    return false;
+  }
+  dynamic_section_start_ = reinterpret_cast<Elf_Dyn*>(dynamic_target);
+
+  Elf_Addr hash_vaddr = 0;
+  Elf_Addr dynsym_vaddr = 0;
+  Elf_Addr dynstr_vaddr = 0;
+  size_t dynstr_size = 0;
+  for (Elf_Word i = 0; i < GetDynamicNum(); i++) {
+    Elf_Dyn& elf_dyn = GetDynamic(i);
+    switch (elf_dyn.d_tag) {
+      case DT_HASH: {
+        hash_vaddr = elf_dyn.d_un.d_ptr;
+        break;
+      }
+      case DT_SYMTAB: {
+        dynsym_vaddr = elf_dyn.d_un.d_ptr;
+        break;
+      }
+      case DT_STRTAB: {
+        dynstr_vaddr = elf_dyn.d_un.d_ptr;
+        break;
+      }
+      case DT_STRSZ: {
+        dynstr_size = elf_dyn.d_un.d_val;
+        break;
+      }
+    }
+  }
+  if (hash_vaddr == 0 || dynsym_vaddr == 0 || dynstr_vaddr == 0 || dynstr_size == 0) {
+    *error_msg = StringPrintf("Missing DT_HASH/DT_SYMTAB/DT_STRTAB/DT_STRSZ entry "
+                              "in ELF file: '%s'",
+                              file->GetPath().c_str());
+    return false;
+  }
+  Elf_Off hash_offset;
+  Elf_Off dynsym_offset;
+  Elf_Off dynstr_offset;
+  if (!FindFileOffsetForVirtualAddress(hash_vaddr, &hash_offset) ||
+      !FindFileOffsetForVirtualAddress(dynsym_vaddr, &dynsym_offset) ||
+      !FindFileOffsetForVirtualAddress(dynstr_vaddr, &dynstr_offset)) {
+    *error_msg = StringPrintf("Dynamic table entry does not refer to a PT_LOAD segment "
+                              "in ELF file: '%s'",
+                              file->GetPath().c_str());
+    return false;
+  }
+
+  // The hash table header tells us how many symbols .dynsym holds; map the
+  // header first to size the full table and the symbol table.
+  uint8_t* hash_header = nullptr;
+  if (!MapLazySection(file,
+                      hash_offset,
+                      2 * sizeof(Elf_Word),
+                      "hash section header",
+                      low_4gb,
+                      &hash_header,
+                      error_msg)) {
+    return false;
+  }
+  const size_t nbucket = reinterpret_cast<Elf_Word*>(hash_header)[0];
+  const size_t nchain = reinterpret_cast<Elf_Word*>(hash_header)[1];
+
+  uint8_t* hash_target = nullptr;
+  uint8_t* dynsym_target = nullptr;
+  uint8_t* dynstr_target = nullptr;
+  if (!MapLazySection(file,
+                      hash_offset,
+                      (2u + nbucket + nchain) * sizeof(Elf_Word),
+                      "hash section",
+                      low_4gb,
+                      &hash_target,
+                      error_msg) ||
+      !MapLazySection(file,
+                      dynsym_offset,
+                      nchain * sizeof(Elf_Sym),
+                      "dynsym section",
+                      low_4gb,
+                      &dynsym_target,
+                      error_msg) ||
+      !MapLazySection(file,
+                      dynstr_offset,
+                      dynstr_size,
+                      "dynstr section",
+                      low_4gb,
+                      &dynstr_target,
+                      error_msg)) {
+    return false;
+  }
+  hash_section_start_ = reinterpret_cast<Elf_Word*>(hash_target);
+  dynsym_section_start_ = reinterpret_cast<Elf_Sym*>(dynsym_target);
+  dynstr_section_start_ = reinterpret_cast<char*>(dynstr_target);
+  return true;
+}
+
 template <typename ElfTypes>
 bool ElfFileImpl<ElfTypes>::ValidPointer(const uint8_t* start) const {
   for (const MemMap& segment : segments_) {
@@ -1600,6 +1767,10 @@ bool ElfFile::Load(File* file,
   DELEGATE_TO_IMPL(Load, file, executable, low_4gb, reservation, error_msg);
 }
 
+bool ElfFile::MapDynamicSymbolSections(File* file, bool low_4gb, /*out*/std::string* error_msg) {
+  DELEGATE_TO_IMPL(MapDynamicSymbolSections, file, low_4gb, error_msg);
+}
+
 const uint8_t* ElfFile::FindDynamicSymbolAddress(const std::string& symbol_name) const {
   DELEGATE_TO_IMPL(FindDynamicSymbolAddress, symbol_name);
 }
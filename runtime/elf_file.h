@@ -60,6 +60,11 @@ class ElfFile {
             /*inout*/MemMap* reservation,
             /*out*/std::string* error_msg);
 
+  // Lazy alternative to Load() when the caller only needs
+  // FindDynamicSymbolAddress(): maps just the few pages holding the dynamic
+  // table, hash, .dynsym and .dynstr instead of whole program segments.
+  bool MapDynamicSymbolSections(File* file, bool low_4gb, /*out*/std::string* error_msg);
+
   const uint8_t* FindDynamicSymbolAddress(const std::string& symbol_name) const;
 
   size_t Size() const;
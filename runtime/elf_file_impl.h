@@ -123,6 +123,12 @@ class ElfFileImpl {
             /*inout*/MemMap* reservation,
             /*out*/std::string* error_msg);
 
+  // Lazy alternative to Load() for symbol lookup only: maps just the sections
+  // needed by FindDynamicSymbolAddress() (the dynamic table, hash, .dynsym and
+  // .dynstr) instead of whole program segments. Since nothing is loaded, the
+  // returned symbol addresses are file virtual addresses.
+  bool MapDynamicSymbolSections(File* file, bool low_4gb, /*out*/std::string* error_msg);
+
   bool Strip(File* file, std::string* error_msg);
 
  private:
@@ -180,6 +186,20 @@ class ElfFileImpl {
 
   Elf_Phdr* FindProgamHeaderByType(Elf_Word type) const;
 
+  // Map `size` bytes of the file at `offset` as a standalone mapping owned by
+  // this ElfFileImpl and return its start through `target`. Used for
+  // on-demand section mapping.
+  bool MapLazySection(File* file,
+                      Elf_Off offset,
+                      size_t size,
+                      const char* label,
+                      bool low_4gb,
+                      /*out*/uint8_t** target,
+                      std::string* error_msg);
+
+  // Translate a virtual address to a file offset using the PT_LOAD program headers.
+  bool FindFileOffsetForVirtualAddress(Elf_Addr vaddr, /*out*/Elf_Off* offset) const;
+
   Elf_Dyn* FindDynamicByType(Elf_Sword type) const;
   Elf_Word FindDynamicValueByType(Elf_Sword type) const;
 
@@ -196,6 +216,9 @@ class ElfFileImpl {
   Elf_Ehdr* header_;
   std::vector<MemMap> segments_;
 
+  // Standalone mappings of individual sections created by MapDynamicSymbolSections().
+  std::vector<MemMap> lazy_section_maps_;
+
   // Pointer to start of first PT_LOAD program segment after Load()
   // when program_header_only_ is true.
   uint8_t* base_address_;
@@ -86,6 +86,13 @@ extern uint32_t JniMethodStart(Thread* self) {
     CHECK(!native_method->IsFastNative()) << native_method->PrettyMethod();
   }
 
+  if (UNLIKELY(self->IsJniStayRunnableRegionActive())) {
+    // A ScopedStayRunnableForJni region above guarantees this native method is
+    // short-running; stay runnable as we do for @FastNative methods and pay only a
+    // suspend check on the way out.
+    return saved_local_ref_cookie;
+  }
+
   // Transition out of runnable.
   self->TransitionFromRunnableToSuspended(kNative);
   return saved_local_ref_cookie;
@@ -103,6 +110,16 @@ static void GoToRunnable(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
     CHECK(!native_method->IsFastNative()) << native_method->PrettyMethod();
   }
 
+  if (UNLIKELY(self->IsJniStayRunnableRegionActive())) {
+    // JniMethodStart elided the transition, so we are still runnable; just honor any
+    // suspend request raised while the native method ran.
+    if (UNLIKELY(self->TestAllFlags())) {
+      DCHECK(Locks::mutator_lock_->IsSharedHeld(self));
+      self->CheckSuspend();
+    }
+    return;
+  }
+
   self->TransitionFromSuspendedToRunnable();
 }
 
@@ -14,8 +14,12 @@
  * limitations under the License.
  */
 
+#include <cstring>
+
 #include "art_method-inl.h"
+#include "base/atomic.h"
 #include "base/callee_save_type.h"
+#include "base/casts.h"
 #include "base/enums.h"
 #include "callee_save_frame.h"
 #include "common_throws.h"
@@ -1787,6 +1791,82 @@ class ComputeNativeCallFrameSize {
   uint32_t num_stack_entries_;
 };
 
+// Methods without compiled JNI stubs go through the generic JNI trampoline on
+// every call, and the native frame size walk over the shorty is the only part
+// of the layout computation that does not depend on the argument values.
+// Processes use few distinct native method shorties, so a small lock-free
+// direct-mapped cache keyed by shorty content (plus the @CriticalNative flag)
+// makes repeat calls skip the walk. Entries are published once and never
+// evicted; colliding shorties simply stay uncached.
+class GenericJniStackSizeCache {
+ public:
+  static bool Lookup(bool critical_native,
+                     const char* shorty,
+                     uint32_t shorty_len,
+                     uint32_t* num_stack_entries) {
+    if (shorty_len > kMaxShortyLength) {
+      return false;
+    }
+    Entry& entry = entries_[IndexFor(critical_native, shorty, shorty_len)];
+    if (entry.state.load(std::memory_order_acquire) != kFull) {
+      return false;
+    }
+    if (entry.critical_native != (critical_native ? 1u : 0u) ||
+        strcmp(entry.shorty, shorty) != 0) {
+      return false;
+    }
+    *num_stack_entries = entry.num_stack_entries;
+    return true;
+  }
+
+  static void Store(bool critical_native,
+                    const char* shorty,
+                    uint32_t shorty_len,
+                    uint32_t num_stack_entries) {
+    if (shorty_len > kMaxShortyLength) {
+      return;
+    }
+    Entry& entry = entries_[IndexFor(critical_native, shorty, shorty_len)];
+    uint32_t expected = kEmpty;
+    if (!entry.state.compare_exchange_strong(expected, kBusy, std::memory_order_relaxed)) {
+      return;  // Slot already claimed, possibly by a colliding shorty.
+    }
+    memcpy(entry.shorty, shorty, shorty_len + 1u);
+    entry.critical_native = critical_native ? 1u : 0u;
+    entry.num_stack_entries = dchecked_integral_cast<uint16_t>(num_stack_entries);
+    entry.state.store(kFull, std::memory_order_release);
+  }
+
+ private:
+  enum State : uint32_t {
+    kEmpty = 0u,
+    kBusy = 1u,
+    kFull = 2u,
+  };
+
+  static constexpr size_t kNumEntries = 64u;  // Power of two.
+  static constexpr uint32_t kMaxShortyLength = 19u;
+
+  struct Entry {
+    Atomic<uint32_t> state;
+    char shorty[kMaxShortyLength + 1u];
+    uint8_t critical_native;
+    uint16_t num_stack_entries;
+  };
+
+  static size_t IndexFor(bool critical_native, const char* shorty, uint32_t shorty_len) {
+    uint32_t hash = critical_native ? 0x9e3779b9u : 0u;
+    for (uint32_t i = 0; i != shorty_len; ++i) {
+      hash = hash * 31u + static_cast<uint8_t>(shorty[i]);
+    }
+    return hash & (kNumEntries - 1u);
+  }
+
+  static Entry entries_[kNumEntries];
+};
+
+GenericJniStackSizeCache::Entry GenericJniStackSizeCache::entries_[kNumEntries];
+
 class ComputeGenericJniFrameSize final : public ComputeNativeCallFrameSize {
  public:
   explicit ComputeGenericJniFrameSize(bool critical_native)
@@ -1796,7 +1876,20 @@ class ComputeGenericJniFrameSize final : public ComputeNativeCallFrameSize {
       REQUIRES_SHARED(Locks::mutator_lock_) {
     DCHECK_EQ(Runtime::Current()->GetClassLinker()->GetImagePointerSize(), kRuntimePointerSize);
 
-    Walk(shorty, shorty_len);
+    uint32_t cached_stack_entries = 0u;
+    if (GenericJniStackSizeCache::Lookup(critical_native_,
+                                         shorty,
+                                         shorty_len,
+                                         &cached_stack_entries)) {
+      if (kIsDebugBuild) {
+        Walk(shorty, shorty_len);
+        DCHECK_EQ(num_stack_entries_, cached_stack_entries);
+      }
+      num_stack_entries_ = cached_stack_entries;
+    } else {
+      Walk(shorty, shorty_len);
+      GenericJniStackSizeCache::Store(critical_native_, shorty, shorty_len, num_stack_entries_);
+    }
 
     // Add space for cookie.
     DCHECK_ALIGNED(managed_sp, sizeof(uintptr_t));
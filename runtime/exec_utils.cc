@@ -16,6 +16,7 @@
 
 #include "exec_utils.h"
 
+#include <spawn.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <string>
@@ -24,8 +25,11 @@
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
 
+#include "base/time_utils.h"
 #include "runtime.h"
 
+extern "C" char** environ;
+
 namespace art {
 
 using android::base::StringPrintf;
@@ -36,41 +40,51 @@ std::string ToCommandLine(const std::vector<std::string>& args) {
   return android::base::Join(args, ' ');
 }
 
-// Fork and execute a command specified in a subprocess.
+// Spawn a subprocess executing the command specified.
 // If there is a runtime (Runtime::Current != nullptr) then the subprocess is created with the
 // same environment that existed when the runtime was started.
-// Returns the process id of the child process on success, -1 otherwise.
+// Returns the process id of the child process on success, -1 otherwise with errno set to the
+// reason the spawn failed.
 pid_t ExecWithoutWait(std::vector<std::string>& arg_vector) {
   // Convert the args to char pointers.
   const char* program = arg_vector[0].c_str();
   std::vector<char*> args;
+  args.reserve(arg_vector.size() + 1);
   for (const auto& arg : arg_vector) {
     args.push_back(const_cast<char*>(arg.c_str()));
   }
   args.push_back(nullptr);
 
-  // fork and exec
-  pid_t pid = fork();
-  if (pid == 0) {
-    // no allocation allowed between fork and exec
+  // (b/30160149): protect subprocesses from modifications to LD_LIBRARY_PATH, etc.
+  // Use the snapshot of the environment from the time the runtime was created.
+  Runtime* runtime = Runtime::Current();
+  char** envp = (runtime == nullptr) ? environ : runtime->GetEnvSnapshot();
 
-    // change process groups, so we don't get reaped by ProcessManager
-    setpgid(0, 0);
+  posix_spawnattr_t attr;
+  int res = posix_spawnattr_init(&attr);
+  if (res == 0) {
+    // Change process groups, so we don't get reaped by ProcessManager.
+    res = posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+  }
 
-    // (b/30160149): protect subprocesses from modifications to LD_LIBRARY_PATH, etc.
-    // Use the snapshot of the environment from the time the runtime was created.
-    char** envp = (Runtime::Current() == nullptr) ? nullptr : Runtime::Current()->GetEnvSnapshot();
-    if (envp == nullptr) {
-      execv(program, &args[0]);
-    } else {
-      execve(program, &args[0], envp);
+  // Use posix_spawn rather than fork+exec so that the launch does not copy the parent's page
+  // tables; for a large parent such as system_server spawning dex2oat, fork makes the launch
+  // slow and briefly doubles committed memory.
+  pid_t pid = -1;
+  if (res == 0) {
+    uint64_t start_time = MicroTime();
+    res = posix_spawn(&pid, program, /*file_actions=*/nullptr, &attr, args.data(), envp);
+    if (res == 0 && runtime != nullptr) {
+      runtime->GetMetrics()->ProcessSpawnTotalTime()->Add(MicroTime() - start_time);
+      runtime->GetMetrics()->ProcessSpawnCount()->AddOne();
     }
-    PLOG(ERROR) << "Failed to execve(" << ToCommandLine(arg_vector) << ")";
-    // _exit to avoid atexit handlers in child.
-    _exit(1);
-  } else {
-    return pid;
+    posix_spawnattr_destroy(&attr);
+  }
+  if (res != 0) {
+    errno = res;
+    return -1;
   }
+  return pid;
 }
 
 }  // namespace
@@ -78,7 +92,7 @@ pid_t ExecWithoutWait(std::vector<std::string>& arg_vector) {
 int ExecAndReturnCode(std::vector<std::string>& arg_vector, std::string* error_msg) {
   pid_t pid = ExecWithoutWait(arg_vector);
   if (pid == -1) {
-    *error_msg = StringPrintf("Failed to execv(%s) because fork failed: %s",
+    *error_msg = StringPrintf("Failed to execv(%s) because posix_spawn failed: %s",
                               ToCommandLine(arg_vector).c_str(), strerror(errno));
     return -1;
   }
@@ -87,7 +101,7 @@ int ExecAndReturnCode(std::vector<std::string>& arg_vector, std::string* error_m
   int status = -1;
   pid_t got_pid = TEMP_FAILURE_RETRY(waitpid(pid, &status, 0));
   if (got_pid != pid) {
-    *error_msg = StringPrintf("Failed after fork for execv(%s) because waitpid failed: "
+    *error_msg = StringPrintf("Failed after posix_spawn for execv(%s) because waitpid failed: "
                               "wanted %d, got %d: %s",
                               ToCommandLine(arg_vector).c_str(), pid, got_pid, strerror(errno));
     return -1;
@@ -107,7 +121,7 @@ int ExecAndReturnCode(std::vector<std::string>& arg_vector,
   // Start subprocess.
   pid_t pid = ExecWithoutWait(arg_vector);
   if (pid == -1) {
-    *error_msg = StringPrintf("Failed to execv(%s) because fork failed: %s",
+    *error_msg = StringPrintf("Failed to execv(%s) because posix_spawn failed: %s",
                               ToCommandLine(arg_vector).c_str(), strerror(errno));
     return -1;
   }
@@ -152,7 +166,7 @@ int ExecAndReturnCode(std::vector<std::string>& arg_vector,
   int status = -1;
   pid_t got_pid = TEMP_FAILURE_RETRY(waitpid(pid, &status, 0));
   if (got_pid != pid) {
-    *error_msg = StringPrintf("Failed after fork for execv(%s) because waitpid failed: "
+    *error_msg = StringPrintf("Failed after posix_spawn for execv(%s) because waitpid failed: "
                               "wanted %d, got %d: %s",
                               ToCommandLine(arg_vector).c_str(), pid, got_pid, strerror(errno));
     return -1;
@@ -22,7 +22,7 @@
 
 namespace art {
 
-// Wrapper on fork/execv to run a command in a subprocess.
+// Wrapper on posix_spawn to run a command in a subprocess.
 // These spawn child processes using the environment as it was set when the single instance
 // of the runtime (Runtime::Current()) was started.  If no instance of the runtime was started, it
 // will use the current environment settings.
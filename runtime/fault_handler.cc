@@ -24,6 +24,7 @@
 #include "base/logging.h"  // For VLOG
 #include "base/safe_copy.h"
 #include "base/stl_util.h"
+#include "base/time_utils.h"
 #include "dex/dex_file_types.h"
 #include "mirror/class.h"
 #include "mirror/object_reference.h"
@@ -123,7 +124,8 @@ static bool SafeVerifyClassClass(mirror::Class* cls) REQUIRES_SHARED(Locks::muta
 #endif
 
 
-FaultManager::FaultManager() : initialized_(false) {
+FaultManager::FaultManager()
+    : initialized_(false), handled_fault_count_(0), handled_fault_total_ns_(0) {
   sigaction(SIGSEGV, nullptr, &oldaction_);
 }
 
@@ -179,6 +181,7 @@ bool FaultManager::HandleFaultByOtherHandlers(int sig, siginfo_t* info, void* co
   DCHECK(Runtime::Current()->IsStarted());
   for (const auto& handler : other_handlers_) {
     if (handler->Action(sig, info, context)) {
+      handler->RecordHit();
       return true;
     }
   }
@@ -207,6 +210,7 @@ static std::ostream& PrintSignalInfo(std::ostream& os, siginfo_t* info) {
 }
 
 bool FaultManager::HandleFault(int sig, siginfo_t* info, void* context) {
+  const uint64_t handling_start_ns = NanoTime();
   if (VLOG_IS_ON(signals)) {
     PrintSignalInfo(VLOG_STREAM(signals) << "Handling fault:" << "\n", info);
   }
@@ -223,6 +227,8 @@ bool FaultManager::HandleFault(int sig, siginfo_t* info, void* context) {
       if (handler->Action(sig, info, context)) {
         // We have handled a signal so it's time to return from the
         // signal handler to the appropriate place.
+        handler->RecordHit();
+        RecordHandledFault(handling_start_ns);
         return true;
       }
     }
@@ -232,6 +238,7 @@ bool FaultManager::HandleFault(int sig, siginfo_t* info, void* context) {
   // we can give more information about so call all registered handlers to
   // see if it is.
   if (HandleFaultByOtherHandlers(sig, info, context)) {
+    RecordHandledFault(handling_start_ns);
     return true;
   }
 
@@ -240,6 +247,27 @@ bool FaultManager::HandleFault(int sig, siginfo_t* info, void* context) {
   return false;
 }
 
+void FaultManager::RecordHandledFault(uint64_t handling_start_ns) {
+  handled_fault_count_.fetch_add(1u, std::memory_order_relaxed);
+  handled_fault_total_ns_.fetch_add(NanoTime() - handling_start_ns, std::memory_order_relaxed);
+}
+
+void FaultManager::DumpForSigQuit(std::ostream& os) {
+  const uint64_t count = handled_fault_count_.load(std::memory_order_relaxed);
+  os << "Implicit check faults handled: " << count;
+  if (count != 0) {
+    os << " (mean signal-entry-to-resume latency "
+       << (handled_fault_total_ns_.load(std::memory_order_relaxed) / count) << "ns)";
+  }
+  os << "\n";
+  for (const auto& handler : generated_code_handlers_) {
+    os << "  " << handler->GetName() << ": " << handler->GetHitCount() << "\n";
+  }
+  for (const auto& handler : other_handlers_) {
+    os << "  " << handler->GetName() << ": " << handler->GetHitCount() << "\n";
+  }
+}
+
 void FaultManager::AddHandler(FaultHandler* handler, bool generated_code) {
   DCHECK(initialized_);
   if (generated_code) {
@@ -355,34 +383,39 @@ bool FaultManager::IsInGeneratedCode(siginfo_t* siginfo, void* context, bool che
   return !check_dex_pc || dexpc != dex::kDexNoIndex;
 }
 
-FaultHandler::FaultHandler(FaultManager* manager) : manager_(manager) {
+FaultHandler::FaultHandler(FaultManager* manager, const char* name)
+    : manager_(manager), name_(name), hit_count_(0) {
 }
 
 //
 // Null pointer fault handler
 //
-NullPointerHandler::NullPointerHandler(FaultManager* manager) : FaultHandler(manager) {
+NullPointerHandler::NullPointerHandler(FaultManager* manager)
+    : FaultHandler(manager, "null pointer check") {
   manager_->AddHandler(this, true);
 }
 
 //
 // Suspension fault handler
 //
-SuspensionHandler::SuspensionHandler(FaultManager* manager) : FaultHandler(manager) {
+SuspensionHandler::SuspensionHandler(FaultManager* manager)
+    : FaultHandler(manager, "suspension check") {
   manager_->AddHandler(this, true);
 }
 
 //
 // Stack overflow fault handler
 //
-StackOverflowHandler::StackOverflowHandler(FaultManager* manager) : FaultHandler(manager) {
+StackOverflowHandler::StackOverflowHandler(FaultManager* manager)
+    : FaultHandler(manager, "stack overflow check") {
   manager_->AddHandler(this, true);
 }
 
 //
 // Stack trace handler, used to help get a stack trace from SIGSEGV inside of compiled code.
 //
-JavaStackTraceHandler::JavaStackTraceHandler(FaultManager* manager) : FaultHandler(manager) {
+JavaStackTraceHandler::JavaStackTraceHandler(FaultManager* manager)
+    : FaultHandler(manager, "java stack trace") {
   manager_->AddHandler(this, false);
 }
 
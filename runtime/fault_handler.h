@@ -21,8 +21,10 @@
 #include <signal.h>
 #include <stdint.h>
 
+#include <iosfwd>
 #include <vector>
 
+#include "base/atomic.h"
 #include "base/locks.h"  // For annotalysis.
 #include "runtime_globals.h"  // For CanDoImplicitNullCheckOn.
 
@@ -65,7 +67,13 @@ class FaultManager {
   bool IsInGeneratedCode(siginfo_t* siginfo, void *context, bool check_dex_pc)
                          NO_THREAD_SAFETY_ANALYSIS;
 
+  // Dump per-handler hit counts and fault handling latency.
+  void DumpForSigQuit(std::ostream& os);
+
  private:
+  // Account one handled fault, from signal entry to resumption.
+  void RecordHandledFault(uint64_t handling_start_ns);
+
   // The HandleFaultByOtherHandlers function is only called by HandleFault function for generated code.
   bool HandleFaultByOtherHandlers(int sig, siginfo_t* info, void* context)
                                   NO_THREAD_SAFETY_ANALYSIS;
@@ -74,23 +82,46 @@ class FaultManager {
   std::vector<FaultHandler*> other_handlers_;
   struct sigaction oldaction_;
   bool initialized_;
+
+  // Signal-entry-to-resume latency accounting for handled faults. Updated with
+  // relaxed atomics from the signal handler, read from DumpForSigQuit().
+  Atomic<uint64_t> handled_fault_count_;
+  Atomic<uint64_t> handled_fault_total_ns_;
+
   DISALLOW_COPY_AND_ASSIGN(FaultManager);
 };
 
 class FaultHandler {
  public:
-  explicit FaultHandler(FaultManager* manager);
+  FaultHandler(FaultManager* manager, const char* name);
   virtual ~FaultHandler() {}
   FaultManager* GetFaultManager() {
     return manager_;
   }
 
+  const char* GetName() const {
+    return name_;
+  }
+
+  // Number of faults this handler successfully handled. Updated with relaxed
+  // atomics from the signal handler, read from FaultManager::DumpForSigQuit().
+  uint64_t GetHitCount() const {
+    return hit_count_.load(std::memory_order_relaxed);
+  }
+
+  void RecordHit() {
+    hit_count_.fetch_add(1u, std::memory_order_relaxed);
+  }
+
   virtual bool Action(int sig, siginfo_t* siginfo, void* context) = 0;
 
  protected:
   FaultManager* const manager_;
 
  private:
+  const char* const name_;
+  Atomic<uint64_t> hit_count_;
+
   DISALLOW_COPY_AND_ASSIGN(FaultHandler);
 };
 
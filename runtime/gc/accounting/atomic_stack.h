@@ -89,7 +89,7 @@ class AtomicStack {
 
   // Returns false if we overflowed the stack.
   bool AtomicPushBack(T* value) REQUIRES_SHARED(Locks::mutator_lock_) {
-    return AtomicPushBackInternal(value, growth_limit_);
+    return AtomicPushBackInternal(value, growth_limit_.load(std::memory_order_relaxed));
   }
 
   // Atomically bump the back index by the given number of
@@ -105,7 +105,8 @@ class AtomicStack {
     do {
       index = back_index_.load(std::memory_order_relaxed);
       new_index = index + num_slots;
-      if (UNLIKELY(static_cast<size_t>(new_index) >= growth_limit_)) {
+      if (UNLIKELY(static_cast<size_t>(new_index) >=
+                   growth_limit_.load(std::memory_order_relaxed))) {
         // Stack overflow.
         return false;
       }
@@ -135,7 +136,7 @@ class AtomicStack {
       debug_is_sorted_ = false;
     }
     const int32_t index = back_index_.load(std::memory_order_relaxed);
-    DCHECK_LT(static_cast<size_t>(index), growth_limit_);
+    DCHECK_LT(static_cast<size_t>(index), growth_limit_.load(std::memory_order_relaxed));
     back_index_.store(index + 1, std::memory_order_relaxed);
     begin_[index].Assign(value);
   }
@@ -167,7 +168,25 @@ class AtomicStack {
   }
 
   bool IsFull() const {
-    return Size() == growth_limit_;
+    return Size() == growth_limit_.load(std::memory_order_relaxed);
+  }
+
+  // Attempt to double the growth limit, up to `limit` which must be <= Capacity(). The backing
+  // mapping already reserves `capacity_` entries and its anonymous pages are committed lazily by
+  // the kernel, so raising the limit links in new pages without touching memory or moving the
+  // stack; the bump-index fast path stays a single compare and swap. May be called concurrently
+  // with the atomic push operations. Returns false if the growth limit already reached `limit`.
+  bool Grow(size_t limit) {
+    DCHECK_LE(limit, capacity_);
+    size_t old_limit = growth_limit_.load(std::memory_order_relaxed);
+    while (old_limit < limit) {
+      const size_t new_limit = std::min(old_limit * 2, limit);
+      if (growth_limit_.CompareAndSetWeakRelaxed(old_limit, new_limit)) {
+        return true;
+      }
+      old_limit = growth_limit_.load(std::memory_order_relaxed);
+    }
+    return false;
   }
 
   size_t Size() const {
@@ -191,7 +210,7 @@ class AtomicStack {
   // Will clear the stack.
   void Resize(size_t new_capacity) {
     capacity_ = new_capacity;
-    growth_limit_ = new_capacity;
+    growth_limit_.store(new_capacity, std::memory_order_relaxed);
     Init();
   }
 
@@ -275,8 +294,9 @@ class AtomicStack {
   AtomicInteger front_index_;
   // Base of the atomic stack.
   StackReference<T>* begin_;
-  // Current maximum which we can push back to, must be <= capacity_.
-  size_t growth_limit_;
+  // Current maximum which we can push back to, must be <= capacity_. Grows elastically via
+  // Grow(); concurrent with the atomic push operations.
+  Atomic<size_t> growth_limit_;
   // Maximum number of elements.
   size_t capacity_;
   // Whether or not the stack is sorted, only updated in debug mode to avoid performance overhead.
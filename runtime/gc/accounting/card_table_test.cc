@@ -25,6 +25,7 @@
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
 #include "scoped_thread_state_change-inl.h"
+#include "space_bitmap-inl.h"
 #include "thread_pool.h"
 
 namespace art {
@@ -145,7 +146,40 @@ TEST_F(CardTableTest, TestModifyCardsAtomic) {
   }
 }
 
-// TODO: Add test for CardTable::Scan.
+TEST_F(CardTableTest, TestScanSparseDirtyCards) {
+  CommonSetup();
+  ContinuousSpaceBitmap bitmap(
+      ContinuousSpaceBitmap::Create("test bitmap", HeapBegin(), HeapLimit() - HeapBegin()));
+  // Dirty a sparse set of cards, including short runs, so that dirty cards land both inside
+  // and across the chunks that the clean-card fast path in Scan() skips in one compare.
+  size_t expected_cards = 0;
+  size_t card_index = 0;
+  for (uint8_t* addr = HeapBegin(); addr < HeapLimit();
+       addr += CardTable::kCardSize, ++card_index) {
+    if (card_index % 59 == 0 || card_index % 257 < 3) {
+      card_table_->MarkCard(addr);
+      ++expected_cards;
+    }
+  }
+  auto visitor = [](mirror::Object* obj ATTRIBUTE_UNUSED) {};
+  EXPECT_EQ(expected_cards,
+            card_table_->Scan<false>(
+                &bitmap, HeapBegin(), HeapLimit(), visitor, CardTable::kCardDirty));
+  // A sub-range with unaligned endpoints must only scan the cards it covers.
+  uint8_t* const sub_begin = HeapBegin() + 3 * CardTable::kCardSize + kObjectAlignment;
+  uint8_t* const sub_end = HeapLimit() - 5 * CardTable::kCardSize - kObjectAlignment;
+  size_t expected_sub_cards = 0;
+  for (uint8_t* addr = AlignDown(sub_begin, CardTable::kCardSize);
+       addr < AlignUp(sub_end, CardTable::kCardSize);
+       addr += CardTable::kCardSize) {
+    if (*card_table_->CardFromAddr(addr) == CardTable::kCardDirty) {
+      ++expected_sub_cards;
+    }
+  }
+  EXPECT_EQ(expected_sub_cards,
+            card_table_->Scan<false>(&bitmap, sub_begin, sub_end, visitor, CardTable::kCardDirty));
+}
+
 }  // namespace accounting
 }  // namespace gc
 }  // namespace art
@@ -426,10 +426,10 @@ void ModUnionTableReferenceCache::UpdateAndMarkReferences(MarkObjectVisitor* vis
     has_target_reference = false;
     uintptr_t start = reinterpret_cast<uintptr_t>(card_table->AddrFromCard(card));
     uintptr_t end = start + CardTable::kCardSize;
-    space::ContinuousSpace* space =
-        heap_->FindContinuousSpaceFromObject(reinterpret_cast<mirror::Object*>(start), false);
-    DCHECK(space != nullptr);
-    ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
+    // All cards in cleared_cards_ come from ProcessCards()/SetCards() over space_, so there is
+    // no need for a space lookup per card.
+    DCHECK(space_->HasAddress(reinterpret_cast<mirror::Object*>(start)));
+    ContinuousSpaceBitmap* live_bitmap = space_->GetLiveBitmap();
     live_bitmap->VisitMarkedRange(start, end, add_visitor);
     // Update the corresponding references for the card.
     auto found = references_.find(card);
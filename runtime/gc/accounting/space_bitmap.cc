@@ -16,6 +16,8 @@
 
 #include "space_bitmap-inl.h"
 
+#include <limits>
+
 #include "android-base/stringprintf.h"
 
 #include "art_field-inl.h"
@@ -168,7 +170,10 @@ void SpaceBitmap<kAlignment>::SweepWalk(const SpaceBitmap<kAlignment>& live_bitm
     return;
   }
 
-  size_t buffer_size = sizeof(intptr_t) * kBitsPerIntPtrT;
+  // Batch up to this many dead objects per callback so the bulk free paths (e.g.
+  // RosAlloc::BulkFree) amortize their locking over larger runs. Must be able to hold at least
+  // one full bitmap word of pointers beyond the flush threshold, see pointer_end below.
+  size_t buffer_size = 1024;
   Atomic<uintptr_t>* live = live_bitmap.bitmap_begin_;
   Atomic<uintptr_t>* mark = mark_bitmap.bitmap_begin_;
   const size_t start = OffsetToIndex(sweep_begin - live_bitmap.heap_begin_);
@@ -195,11 +200,23 @@ void SpaceBitmap<kAlignment>::SweepWalk(const SpaceBitmap<kAlignment>& live_bitm
         live[i].load(std::memory_order_relaxed) & ~mark[i].load(std::memory_order_relaxed);
     if (UNLIKELY(garbage != 0)) {
       uintptr_t ptr_base = IndexToOffset(i) + live_bitmap.heap_begin_;
-      do {
-        const size_t shift = CTZ(garbage);
-        garbage ^= (static_cast<uintptr_t>(1)) << shift;
-        *cur_pointer++ = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
-      } while (garbage != 0);
+      if (garbage == std::numeric_limits<uintptr_t>::max()) {
+        // Fully dead word, common when entire runs of short-lived objects die together: expand
+        // to a contiguous pointer range with a straight stride loop instead of per-bit CTZ, and
+        // advance the batch cursor by the word's popcount.
+        const size_t num_dead = POPCOUNT(garbage);
+        DCHECK_EQ(num_dead, static_cast<size_t>(kBitsPerIntPtrT));
+        for (size_t bit = 0; bit < num_dead; ++bit) {
+          cur_pointer[bit] = reinterpret_cast<mirror::Object*>(ptr_base + bit * kAlignment);
+        }
+        cur_pointer += num_dead;
+      } else {
+        do {
+          const size_t shift = CTZ(garbage);
+          garbage ^= (static_cast<uintptr_t>(1)) << shift;
+          *cur_pointer++ = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
+        } while (garbage != 0);
+      }
       // Make sure that there are always enough slots available for an
       // entire word of one bits.
       if (cur_pointer >= pointer_end) {
@@ -88,6 +88,52 @@ TEST_F(SpaceBitmapTest, ScanRange) {
   }
 }
 
+TEST_F(SpaceBitmapTest, SweepWalkFullAndPartialWords) {
+  uint8_t* heap_begin = reinterpret_cast<uint8_t*>(0x10000000);
+  size_t heap_capacity = 16 * MB;
+
+  ContinuousSpaceBitmap live_bitmap(
+      ContinuousSpaceBitmap::Create("live bitmap", heap_begin, heap_capacity));
+  ContinuousSpaceBitmap mark_bitmap(
+      ContinuousSpaceBitmap::Create("mark bitmap", heap_begin, heap_capacity));
+  EXPECT_TRUE(live_bitmap.IsValid());
+  EXPECT_TRUE(mark_bitmap.IsValid());
+
+  // Make the first bitmap word fully dead, the second word half dead (odd bits survive) and the
+  // third word fully live, covering both the whole-word and per-bit sweep paths.
+  for (size_t j = 0; j < static_cast<size_t>(kBitsPerIntPtrT) * 3; ++j) {
+    mirror::Object* obj = reinterpret_cast<mirror::Object*>(heap_begin + j * kObjectAlignment);
+    live_bitmap.Set(obj);
+    const size_t word = j / kBitsPerIntPtrT;
+    if (word == 2 || (word == 1 && (j & 1) == 1)) {
+      mark_bitmap.Set(obj);
+    }
+  }
+
+  struct SweepContext {
+    const ContinuousSpaceBitmap* mark_bitmap;
+    size_t swept;
+  };
+  SweepContext context = { &mark_bitmap, 0u };
+  auto callback = [](size_t num_ptrs, mirror::Object** ptrs, void* arg) {
+    SweepContext* ctx = reinterpret_cast<SweepContext*>(arg);
+    for (size_t i = 0; i < num_ptrs; ++i) {
+      // Only unmarked objects may be reported dead.
+      EXPECT_FALSE(ctx->mark_bitmap->Test(ptrs[i]));
+    }
+    ctx->swept += num_ptrs;
+  };
+  ContinuousSpaceBitmap::SweepWalk(
+      live_bitmap,
+      mark_bitmap,
+      reinterpret_cast<uintptr_t>(heap_begin),
+      reinterpret_cast<uintptr_t>(heap_begin) + 3 * kBitsPerIntPtrT * kObjectAlignment,
+      callback,
+      &context);
+  // One fully dead word plus the even bits of the half-dead word.
+  EXPECT_EQ(context.swept, static_cast<size_t>(kBitsPerIntPtrT) + kBitsPerIntPtrT / 2);
+}
+
 TEST_F(SpaceBitmapTest, ClearRange) {
   uint8_t* heap_begin = reinterpret_cast<uint8_t*>(0x10000000);
   size_t heap_capacity = 16 * MB;
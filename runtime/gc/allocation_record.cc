@@ -50,6 +50,27 @@ AllocRecordObjectMap::~AllocRecordObjectMap() {
   Clear();
 }
 
+void AllocRecordObjectMap::SetSampleIntervalBytes(size_t bytes) {
+  sample_interval_bytes_.store(bytes, std::memory_order_relaxed);
+  if (bytes != 0u) {
+    sample_dist_ = std::geometric_distribution<size_t>(1.0 / bytes);
+  }
+}
+
+size_t AllocRecordObjectMap::NextSampleInterval() {
+  // The geometric distribution has mean (interval - 1), so shift by one to get the configured
+  // mean and to never return 0.
+  return sample_dist_(sample_rng_) + 1;
+}
+
+// Per-thread countdown to the next sampled allocation, so unsampled allocations never contend on
+// alloc_tracker_lock_. There will always be a slot allocated for it at thread creation; see
+// HeapSampler::GetBytesUntilSample.
+static size_t* GetBytesUntilSample() {
+  thread_local size_t bytes_until_sample = 0;
+  return &bytes_until_sample;
+}
+
 void AllocRecordObjectMap::VisitRoots(RootVisitor* visitor) {
   CHECK_LE(recent_record_max_, alloc_record_max_);
   BufferedRootVisitor<kDefaultBufferedRootCount> buffered_visitor(visitor, RootInfo(kRootDebugger));
@@ -153,11 +174,17 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
       }
       CHECK(records != nullptr);
       records->SetMaxStackDepth(heap->GetAllocTrackerStackDepth());
+      records->SetSampleIntervalBytes(
+          android::base::GetUintProperty<size_t>("dalvik.vm.allocTrackerSampleBytes", 0u));
       size_t sz = sizeof(AllocRecordStackTraceElement) * records->max_stack_depth_ +
                   sizeof(AllocRecord) + sizeof(AllocRecordStackTrace);
       LOG(INFO) << "Enabling alloc tracker (" << records->alloc_record_max_ << " entries of "
                 << records->max_stack_depth_ << " frames, taking up to "
                 << PrettySize(sz * records->alloc_record_max_) << ")";
+      size_t sample_interval = records->sample_interval_bytes_.load(std::memory_order_relaxed);
+      if (sample_interval != 0u) {
+        LOG(INFO) << "Alloc tracker sampling one allocation per " << PrettySize(sample_interval);
+      }
     }
     Runtime::Current()->GetInstrumentation()->InstrumentQuickAllocEntryPoints();
     {
@@ -185,6 +212,20 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
 void AllocRecordObjectMap::RecordAllocation(Thread* self,
                                             ObjPtr<mirror::Object>* obj,
                                             size_t byte_count) {
+  // When sampling, most allocations only decrement the per-thread countdown and return without
+  // walking the stack or touching alloc_tracker_lock_.
+  const size_t sample_interval = sample_interval_bytes_.load(std::memory_order_relaxed);
+  if (sample_interval != 0u) {
+    size_t* const bytes_until_sample = GetBytesUntilSample();
+    if (LIKELY(*bytes_until_sample > byte_count)) {
+      *bytes_until_sample -= byte_count;
+      return;
+    }
+    // Crossed the sample point; the distance to the next one is picked below, under the lock that
+    // is taken anyway to store the record.
+    *bytes_until_sample = 0;
+  }
+
   // Get stack trace outside of lock in case there are allocations during the stack walk.
   // b/27858645.
   AllocRecordStackTrace trace;
@@ -238,6 +279,10 @@ void AllocRecordObjectMap::RecordAllocation(Thread* self,
 
   DCHECK_LE(Size(), alloc_record_max_);
 
+  if (sample_interval != 0u) {
+    *GetBytesUntilSample() = NextSampleInterval();
+  }
+
   // Erase extra unfilled elements.
   trace.SetTid(self->GetTid());
 
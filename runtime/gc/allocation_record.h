@@ -19,7 +19,9 @@
 
 #include <list>
 #include <memory>
+#include <random>
 
+#include "base/atomic.h"
 #include "base/mutex.h"
 #include "gc_root.h"
 #include "obj_ptr.h"
@@ -295,7 +297,17 @@ class AllocRecordObjectMap {
 
   void Clear() REQUIRES(Locks::alloc_tracker_lock_);
 
+  // Set the sampling interval in allocated bytes, or 0 to record every allocation. When sampling,
+  // RecordAllocation only records allocations that cross a per-thread sample point and skips both
+  // the stack walk and the tracker lock for all others, so tracking can stay enabled cheaply.
+  void SetSampleIntervalBytes(size_t bytes) REQUIRES(Locks::alloc_tracker_lock_);
+
  private:
+  // Draw the number of bytes until the next sample from a geometric distribution with mean
+  // sample_interval_bytes_, so that samples are an unbiased estimate of the allocation stream
+  // even for periodic allocation patterns.
+  size_t NextSampleInterval() REQUIRES(Locks::alloc_tracker_lock_);
+
   size_t alloc_record_max_ GUARDED_BY(Locks::alloc_tracker_lock_) = kDefaultNumAllocRecords;
   size_t recent_record_max_ GUARDED_BY(Locks::alloc_tracker_lock_) = kDefaultNumRecentRecords;
   size_t max_stack_depth_ = kDefaultAllocStackDepth;
@@ -303,6 +315,13 @@ class AllocRecordObjectMap {
   ConditionVariable new_record_condition_ GUARDED_BY(Locks::alloc_tracker_lock_);
   // see the comment in typedef of EntryList
   EntryList entries_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  // Sampling interval in bytes, 0 means record every allocation. Read lock-free on the allocation
+  // fast path, written only while tracking is being (re-)enabled.
+  Atomic<size_t> sample_interval_bytes_{0};
+  // RNG state for picking sample intervals; only touched when a sample fires, under the lock that
+  // is taken anyway to store the record.
+  std::minstd_rand sample_rng_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  std::geometric_distribution<size_t> sample_dist_ GUARDED_BY(Locks::alloc_tracker_lock_);
 
   void SetMaxStackDepth(size_t max_stack_depth) REQUIRES(Locks::alloc_tracker_lock_);
 };
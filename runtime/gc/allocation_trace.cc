@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "allocation_trace.h"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <queue>
+#include <sstream>
+
+#include "base/casts.h"
+#include "base/logging.h"  // For VLOG
+#include "class_root-inl.h"
+#include "handle_scope-inl.h"
+#include "heap.h"
+#include "mirror/array-alloc-inl.h"
+#include "mirror/array-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-alloc-inl.h"
+#include "mirror/object_array-inl.h"
+#include "obj_ptr-inl.h"
+#include "object_callbacks.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace gc {
+
+AllocationTraceRecorder::AllocationTraceRecorder(size_t max_entries)
+    : SystemWeakHolder(kAllocTrackerLock),
+      max_entries_(max_entries) {}
+
+void AllocationTraceRecorder::Start() {
+  Thread* self = Thread::Current();
+  Runtime* runtime = Runtime::Current();
+  // Register the weak holder first so that no recorded root can miss a sweep.
+  runtime->AddSystemWeakHolder(this);
+  ScopedObjectAccess soa(self);
+  runtime->GetHeap()->SetAllocationListener(this);
+}
+
+void AllocationTraceRecorder::Stop() {
+  Thread* self = Thread::Current();
+  Runtime* runtime = Runtime::Current();
+  {
+    ScopedObjectAccess soa(self);
+    runtime->GetHeap()->RemoveAllocationListener();
+  }
+  runtime->RemoveSystemWeakHolder(this);
+  MutexLock mu(self, allow_disallow_lock_);
+  // Objects still tracked outlived the recording; their entries keep
+  // kLifetimeUnknown.
+  live_objects_.clear();
+}
+
+void AllocationTraceRecorder::ObjectAllocated(Thread* self,
+                                              ObjPtr<mirror::Object>* obj,
+                                              size_t byte_count) {
+  MutexLock mu(self, allow_disallow_lock_);
+  Wait(self);
+  if (UNLIKELY(entries_.size() >= max_entries_)) {
+    return;  // Trace full; drop further allocations.
+  }
+  std::string temp;
+  const char* descriptor = (*obj)->GetClass()->GetDescriptor(&temp);
+  uint32_t class_id;
+  auto it = class_ids_.find(descriptor);
+  if (it != class_ids_.end()) {
+    class_id = it->second;
+  } else {
+    class_id = dchecked_integral_cast<uint32_t>(descriptors_.size());
+    descriptors_.push_back(descriptor);
+    class_ids_.Put(descriptors_.back(), class_id);
+  }
+  const uint32_t index = dchecked_integral_cast<uint32_t>(entries_.size());
+  entries_.push_back(AllocationTraceEntry{class_id,
+                                          dchecked_integral_cast<uint32_t>(byte_count),
+                                          AllocationTraceEntry::kLifetimeUnknown});
+  live_objects_.emplace_back(GcRoot<mirror::Object>(*obj), index);
+}
+
+void AllocationTraceRecorder::Sweep(IsMarkedVisitor* visitor) {
+  MutexLock mu(Thread::Current(), allow_disallow_lock_);
+  const uint32_t alloc_count = dchecked_integral_cast<uint32_t>(entries_.size());
+  size_t count_deleted = 0;
+  auto it = live_objects_.begin();
+  while (it != live_objects_.end()) {
+    // This does not need a read barrier because this is called by GC.
+    mirror::Object* old_object = it->first.Read<kWithoutReadBarrier>();
+    mirror::Object* new_object = old_object == nullptr ? nullptr : visitor->IsMarked(old_object);
+    if (new_object == nullptr) {
+      entries_[it->second].lifetime = alloc_count - it->second;
+      *it = live_objects_.back();
+      live_objects_.pop_back();
+      ++count_deleted;
+    } else {
+      if (UNLIKELY(old_object != new_object)) {
+        it->first = GcRoot<mirror::Object>(new_object);
+      }
+      ++it;
+    }
+  }
+  VLOG(heap) << "Allocation trace sweep recorded " << count_deleted << " deaths at allocation "
+             << alloc_count;
+}
+
+void AllocationTraceRecorder::Dump(std::ostream& os) {
+  MutexLock mu(Thread::Current(), allow_disallow_lock_);
+  os << "# ART allocation trace v1\n";
+  for (size_t i = 0; i != descriptors_.size(); ++i) {
+    os << "class " << i << " " << descriptors_[i] << "\n";
+  }
+  for (const AllocationTraceEntry& entry : entries_) {
+    os << "alloc " << entry.class_id << " " << entry.byte_count << " ";
+    if (entry.lifetime == AllocationTraceEntry::kLifetimeUnknown) {
+      os << "-\n";
+    } else {
+      os << entry.lifetime << "\n";
+    }
+  }
+}
+
+bool AllocationTraceRecorder::Load(std::istream& is,
+                                   std::vector<std::string>* descriptors,
+                                   std::vector<AllocationTraceEntry>* entries) {
+  DCHECK(descriptors != nullptr);
+  DCHECK(entries != nullptr);
+  std::string line;
+  while (std::getline(is, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream line_stream(line);
+    std::string tag;
+    line_stream >> tag;
+    if (tag == "class") {
+      uint32_t id;
+      std::string descriptor;
+      if (!(line_stream >> id >> descriptor) || id != descriptors->size()) {
+        return false;
+      }
+      descriptors->push_back(descriptor);
+    } else if (tag == "alloc") {
+      AllocationTraceEntry entry;
+      std::string lifetime;
+      if (!(line_stream >> entry.class_id >> entry.byte_count >> lifetime) ||
+          entry.class_id >= descriptors->size()) {
+        return false;
+      }
+      if (lifetime == "-") {
+        entry.lifetime = AllocationTraceEntry::kLifetimeUnknown;
+      } else {
+        entry.lifetime = dchecked_integral_cast<uint32_t>(std::stoul(lifetime));
+      }
+      entries->push_back(entry);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t AllocationTraceRecorder::NumEntries() {
+  MutexLock mu(Thread::Current(), allow_disallow_lock_);
+  return entries_.size();
+}
+
+size_t AllocationTraceReplayer::Replay(Thread* self,
+                                       const std::vector<AllocationTraceEntry>& entries) {
+  // Pre-compute the maximum number of concurrently live objects so that one
+  // object array can root the whole live window during the replay.
+  size_t max_live = 0;
+  {
+    // Min-heap of death sequence numbers of currently live objects.
+    std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> deaths;
+    for (size_t i = 0; i != entries.size(); ++i) {
+      while (!deaths.empty() && deaths.top() <= i) {
+        deaths.pop();
+      }
+      uint64_t death = (entries[i].lifetime == AllocationTraceEntry::kLifetimeUnknown)
+          ? static_cast<uint64_t>(entries.size())
+          : static_cast<uint64_t>(i) + entries[i].lifetime;
+      deaths.push(death);
+      max_live = std::max(max_live, deaths.size());
+    }
+  }
+
+  StackHandleScope<1> hs(self);
+  ObjPtr<mirror::Class> array_class = GetClassRoot<mirror::ObjectArray<mirror::Object>>();
+  Handle<mirror::ObjectArray<mirror::Object>> live(
+      hs.NewHandle(mirror::ObjectArray<mirror::Object>::Alloc(
+          self, array_class, dchecked_integral_cast<int32_t>(std::max<size_t>(max_live, 1u)))));
+  CHECK(live != nullptr);
+
+  // Replay sized allocations, clearing each slot when the recorded lifetime
+  // expires so the heap sees the recorded live-set shape.
+  const uint32_t data_offset = mirror::Array::DataOffset(sizeof(int8_t)).Uint32Value();
+  std::priority_queue<std::pair<uint64_t, int32_t>,
+                      std::vector<std::pair<uint64_t, int32_t>>,
+                      std::greater<std::pair<uint64_t, int32_t>>> deaths;
+  std::vector<int32_t> free_slots;
+  int32_t next_slot = 0;
+  size_t allocated = 0;
+  for (size_t i = 0; i != entries.size(); ++i) {
+    while (!deaths.empty() && deaths.top().first <= i) {
+      int32_t slot = deaths.top().second;
+      deaths.pop();
+      live->Set(slot, nullptr);
+      free_slots.push_back(slot);
+    }
+    const AllocationTraceEntry& entry = entries[i];
+    int32_t length = (entry.byte_count > data_offset)
+        ? dchecked_integral_cast<int32_t>(entry.byte_count - data_offset)
+        : 0;
+    ObjPtr<mirror::ByteArray> array = mirror::ByteArray::Alloc(self, length);
+    CHECK(array != nullptr);
+    ++allocated;
+    int32_t slot;
+    if (!free_slots.empty()) {
+      slot = free_slots.back();
+      free_slots.pop_back();
+    } else {
+      slot = next_slot++;
+    }
+    live->Set(slot, array);
+    uint64_t death = (entry.lifetime == AllocationTraceEntry::kLifetimeUnknown)
+        ? static_cast<uint64_t>(entries.size())
+        : static_cast<uint64_t>(i) + entry.lifetime;
+    deaths.emplace(death, slot);
+  }
+  return allocated;
+}
+
+}  // namespace gc
+}  // namespace art
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_ALLOCATION_TRACE_H_
+#define ART_RUNTIME_GC_ALLOCATION_TRACE_H_
+
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "allocation_listener.h"
+#include "base/locks.h"
+#include "base/safe_map.h"
+#include "gc_root.h"
+#include "obj_ptr.h"
+#include "system_weak.h"
+
+namespace art {
+
+class IsMarkedVisitor;
+class Thread;
+
+namespace gc {
+
+// One recorded allocation. Entries are stored in allocation order, so the
+// index of an entry doubles as its allocation sequence number.
+struct AllocationTraceEntry {
+  // Lifetime value for objects still reachable when recording stopped.
+  static constexpr uint32_t kLifetimeUnknown = std::numeric_limits<uint32_t>::max();
+
+  // Index into the class descriptor table of the trace.
+  uint32_t class_id;
+  // Object size in bytes.
+  uint32_t byte_count;
+  // Upper bound of the object's lifetime, measured in subsequent allocations:
+  // the allocation count at the first GC that found the object dead, minus the
+  // entry's own allocation sequence number.
+  uint32_t lifetime;
+};
+
+// Records a (size, class, lifetime-hint) stream of all allocations via the
+// AllocationListener hook, for offline replay against a differently tuned
+// heap. Lifetimes are observed by keeping a weak root per recorded object and
+// noting the allocation count of the GC that sweeps it, so the per-allocation
+// overhead is a table append and a descriptor lookup; no stack walking.
+//
+// Typical use:
+//   AllocationTraceRecorder recorder;
+//   recorder.Start();
+//   ... workload ...
+//   recorder.Stop();
+//   recorder.Dump(os);
+class AllocationTraceRecorder : public AllocationListener, public SystemWeakHolder {
+ public:
+  // Entries are 12 bytes plus a tracked weak root while the object is alive,
+  // so the default cap bounds the recorder at roughly a few hundred MiB.
+  static constexpr size_t kDefaultMaxEntries = 16 * 1024 * 1024;
+
+  explicit AllocationTraceRecorder(size_t max_entries = kDefaultMaxEntries);
+
+  // Register as the heap's allocation listener and as a system weak holder.
+  // Only one allocation listener can be installed at a time.
+  void Start() REQUIRES(!Locks::mutator_lock_, !allow_disallow_lock_);
+  // Unregister; remaining live objects keep kLifetimeUnknown.
+  void Stop() REQUIRES(!Locks::mutator_lock_, !allow_disallow_lock_);
+
+  // AllocationListener implementation.
+  void ObjectAllocated(Thread* self, ObjPtr<mirror::Object>* obj, size_t byte_count) override
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  // SystemWeakHolder implementation: update moved roots and record the death
+  // of unmarked objects.
+  void Sweep(IsMarkedVisitor* visitor) override
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  // Write the trace in a line-based text format: "class <id> <descriptor>"
+  // lines for the descriptor table followed by "alloc <class_id> <byte_count>
+  // <lifetime>" lines in allocation order ("-" for unknown lifetimes).
+  void Dump(std::ostream& os) REQUIRES(!allow_disallow_lock_);
+
+  // Parse a trace produced by Dump(). Returns false on malformed input.
+  static bool Load(std::istream& is,
+                   std::vector<std::string>* descriptors,
+                   std::vector<AllocationTraceEntry>* entries);
+
+  size_t NumEntries() REQUIRES(!allow_disallow_lock_);
+
+ private:
+  const size_t max_entries_;
+  std::vector<AllocationTraceEntry> entries_ GUARDED_BY(allow_disallow_lock_);
+  // Descriptor table and its inverse, interning class names by descriptor so
+  // entries stay valid across class unloading and moving GC.
+  std::vector<std::string> descriptors_ GUARDED_BY(allow_disallow_lock_);
+  SafeMap<std::string, uint32_t> class_ids_ GUARDED_BY(allow_disallow_lock_);
+  // Weak roots of recorded objects not yet observed dead, paired with the
+  // entry index (== allocation sequence number) of their birth.
+  std::vector<std::pair<GcRoot<mirror::Object>, uint32_t>> live_objects_
+      GUARDED_BY(allow_disallow_lock_);
+};
+
+// Replays a recorded trace against the current heap: every entry becomes a
+// byte array allocation of the recorded size, kept reachable until the trace
+// says the original object died. What matters for GC tuning is the
+// size/lifetime shape of the allocation stream, not the exact types.
+class AllocationTraceReplayer {
+ public:
+  // Returns the number of objects allocated. Allocations may suspend and
+  // trigger GC, like the workload that produced the trace.
+  size_t Replay(Thread* self, const std::vector<AllocationTraceEntry>& entries)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+};
+
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_ALLOCATION_TRACE_H_
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "allocation_trace.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "common_runtime_test.h"
+#include "handle_scope-inl.h"
+#include "heap.h"
+#include "mirror/array-alloc-inl.h"
+#include "mirror/array-inl.h"
+#include "mirror/object-inl.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace gc {
+
+class AllocationTraceTest : public CommonRuntimeTest {
+};
+
+TEST_F(AllocationTraceTest, RecordDumpLoadReplay) {
+  Thread* self = Thread::Current();
+  AllocationTraceRecorder recorder;
+  recorder.Start();
+  {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<1> hs(self);
+    // One survivor kept live across the GC, plus short-lived garbage.
+    Handle<mirror::ByteArray> survivor = hs.NewHandle(mirror::ByteArray::Alloc(self, 100));
+    ASSERT_TRUE(survivor != nullptr);
+    for (size_t i = 0; i != 100; ++i) {
+      ASSERT_TRUE(mirror::ByteArray::Alloc(self, 16) != nullptr);
+    }
+  }
+  // The GC sweeps the recorder's weak roots and records the garbage deaths.
+  Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references= */ false);
+  recorder.Stop();
+  // Other threads may have allocated as well; we only rely on our own
+  // allocations being present.
+  ASSERT_GE(recorder.NumEntries(), 101u);
+
+  std::stringstream trace;
+  recorder.Dump(trace);
+  std::vector<std::string> descriptors;
+  std::vector<AllocationTraceEntry> entries;
+  ASSERT_TRUE(AllocationTraceRecorder::Load(trace, &descriptors, &entries));
+  EXPECT_EQ(entries.size(), recorder.NumEntries());
+  EXPECT_TRUE(std::find(descriptors.begin(), descriptors.end(), "[B") != descriptors.end());
+  // The collected garbage must have an observed (finite) lifetime.
+  EXPECT_TRUE(std::any_of(entries.begin(), entries.end(), [](const AllocationTraceEntry& entry) {
+    return entry.lifetime != AllocationTraceEntry::kLifetimeUnknown;
+  }));
+
+  // Replaying the loaded trace re-executes the allocation stream.
+  ScopedObjectAccess soa(self);
+  AllocationTraceReplayer replayer;
+  EXPECT_EQ(replayer.Replay(self, entries), entries.size());
+}
+
+TEST_F(AllocationTraceTest, LoadRejectsMalformedInput) {
+  std::vector<std::string> descriptors;
+  std::vector<AllocationTraceEntry> entries;
+  {
+    std::stringstream bad_tag("bogus 1 2 3\n");
+    EXPECT_FALSE(AllocationTraceRecorder::Load(bad_tag, &descriptors, &entries));
+  }
+  {
+    std::stringstream bad_class_id("class 0 [B\nalloc 7 16 -\n");
+    descriptors.clear();
+    entries.clear();
+    EXPECT_FALSE(AllocationTraceRecorder::Load(bad_class_id, &descriptors, &entries));
+  }
+}
+
+}  // namespace gc
+}  // namespace art
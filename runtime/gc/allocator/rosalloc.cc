@@ -2191,6 +2191,41 @@ void RosAlloc::DumpStats(std::ostream& os) {
   os << "\n";
 }
 
+void RosAlloc::GetFragmentationStats(FragmentationStats* stats) {
+  DCHECK(stats != nullptr);
+  stats->brackets.assign(kNumOfSizeBrackets, FragmentationStats::Bracket());
+  stats->run_footprint_bytes = 0;
+  stats->run_live_bytes = 0;
+  stats->num_sparse_runs = 0;
+  Thread* self = Thread::Current();
+  ReaderMutexLock rmu(self, bulk_free_lock_);
+  MutexLock lock_mu(self, lock_);
+  for (size_t i = 0; i < page_map_size_; ) {
+    if (page_map_[i] == kPageMapRun) {
+      Run* run = reinterpret_cast<Run*>(base_ + i * kPageSize);
+      const size_t idx = run->size_bracket_idx_;
+      FragmentationStats::Bracket* bracket = &stats->brackets[idx];
+      const size_t num_used_slots = numOfSlots[idx] - run->NumberOfFreeSlots();
+      bracket->bracket_size = bracketSizes[idx];
+      bracket->num_runs++;
+      bracket->footprint_bytes += numOfPages[idx] * kPageSize;
+      bracket->live_bytes += num_used_slots * bracketSizes[idx];
+      if (num_used_slots * kSparseRunOccupancyDivisor <= numOfSlots[idx]) {
+        bracket->num_sparse_runs++;
+      }
+      i += numOfPages[idx];
+    } else {
+      // Free pages, large objects and their parts do not contribute to run fragmentation.
+      ++i;
+    }
+  }
+  for (const FragmentationStats::Bracket& bracket : stats->brackets) {
+    stats->run_footprint_bytes += bracket.footprint_bytes;
+    stats->run_live_bytes += bracket.live_bytes;
+    stats->num_sparse_runs += bracket.num_sparse_runs;
+  }
+}
+
 }  // namespace allocator
 }  // namespace gc
 }  // namespace art
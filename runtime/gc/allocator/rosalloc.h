@@ -935,6 +935,30 @@ class RosAlloc {
   void DumpStats(std::ostream& os)
       REQUIRES(Locks::mutator_lock_) REQUIRES(!lock_) REQUIRES(!bulk_free_lock_);
 
+  // A run is considered sparse when at most 1/kSparseRunOccupancyDivisor of its slots are used.
+  static constexpr size_t kSparseRunOccupancyDivisor = 4;
+
+  // Fragmentation accounting for the runs, per size bracket plus totals.
+  struct FragmentationStats {
+    struct Bracket {
+      size_t bracket_size = 0;     // Slot size of the bracket in bytes.
+      size_t num_runs = 0;
+      size_t num_sparse_runs = 0;
+      size_t footprint_bytes = 0;  // Pages backing the runs of this bracket.
+      size_t live_bytes = 0;       // Bytes in used slots.
+    };
+    std::vector<Bracket> brackets;  // One entry per size bracket.
+    size_t run_footprint_bytes = 0;  // Totals over all brackets.
+    size_t run_live_bytes = 0;
+    size_t num_sparse_runs = 0;
+  };
+
+  // Collect fragmentation stats for the runs. Unlike DumpStats, this does not require the
+  // mutators to be suspended: runs with thread-local free lists may be concurrently updated by
+  // their owning threads, so the live byte counts are (slightly stale) estimates, which is
+  // sufficient for telemetry and trim policy decisions.
+  void GetFragmentationStats(FragmentationStats* stats) REQUIRES(!lock_, !bulk_free_lock_);
+
  private:
   friend std::ostream& operator<<(std::ostream& os, RosAlloc::PageMapKind rhs);
 
@@ -20,6 +20,7 @@
 #include "barrier.h"
 #include "base/enums.h"
 #include "base/file_utils.h"
+#include "base/bounded_fifo.h"
 #include "base/histogram-inl.h"
 #include "base/quasi_atomic.h"
 #include "base/stl_util.h"
@@ -45,6 +46,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -66,6 +68,49 @@ static constexpr size_t kReadBarrierMarkStackSize = 512 * KB;
 static constexpr size_t kSweepArrayChunkFreeSize = 1024;
 // Verify that there are no missing card marks.
 static constexpr bool kVerifyNoMissingCardMarks = kIsDebugBuild;
+// If true, drain the mark stacks through a small prefetch FIFO so the object header (and then
+// its class) is being pulled into cache while earlier refs are scanned. Marking is otherwise
+// cache-miss bound on little cores.
+static constexpr bool kUseMarkStackPrefetch = true;
+
+// Pops refs off `mark_stack` through a bounded FIFO, prefetching each object's header as it
+// enters the FIFO and its class as it leaves, then hands the ref to `processor`. Mirrors the
+// prefetch pipeline in MarkSweep::MarkStackTask. Returns the number of refs processed.
+template <typename Processor>
+static size_t DrainMarkStackWithPrefetch(accounting::AtomicStack<mirror::Object>* mark_stack,
+                                         const Processor& processor)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  size_t count = 0;
+  if (!kUseMarkStackPrefetch) {
+    while (!mark_stack->IsEmpty()) {
+      processor(mark_stack->PopBack());
+      ++count;
+    }
+    return count;
+  }
+  // TODO: Tune this.
+  static constexpr size_t kFifoSize = 4;
+  BoundedFifoPowerOfTwo<mirror::Object*, kFifoSize> prefetch_fifo;
+  for (;;) {
+    while (!mark_stack->IsEmpty() && prefetch_fifo.size() < kFifoSize) {
+      mirror::Object* const obj = mark_stack->PopBack();
+      DCHECK(obj != nullptr);
+      __builtin_prefetch(obj);
+      prefetch_fifo.push_back(obj);
+    }
+    if (UNLIKELY(prefetch_fifo.empty())) {
+      break;
+    }
+    mirror::Object* const obj = prefetch_fifo.front();
+    prefetch_fifo.pop_front();
+    // The header line was prefetched when the ref entered the FIFO, so reading the class word
+    // is cheap; start pulling the class object in while the fields are scanned.
+    __builtin_prefetch(obj->GetClass<kVerifyNone, kWithoutReadBarrier>());
+    processor(obj);
+    ++count;
+  }
+  return count;
+}
 
 ConcurrentCopying::ConcurrentCopying(Heap* heap,
                                      bool young_gen,
@@ -140,6 +185,10 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
               "thread local mark stack", kMarkStackSize, kMarkStackSize);
       pooled_mark_stacks_.push_back(mark_stack);
     }
+    for (size_t i = 0; i < kMarkStackCacheSize; ++i) {
+      pooled_mark_stack_cache_[i].store(nullptr, std::memory_order_relaxed);
+      revoked_mark_stack_cache_[i].store(nullptr, std::memory_order_relaxed);
+    }
   }
   if (use_generational_cc_) {
     // Allocate sweep array free buffer.
@@ -201,6 +250,12 @@ void ConcurrentCopying::MarkHeapReference(mirror::HeapReference<mirror::Object>*
 }
 
 ConcurrentCopying::~ConcurrentCopying() {
+  // The caches are normally drained back into the pool at the end of each collection; delete
+  // any stragglers before deleting the pool itself.
+  for (size_t i = 0; i < kMarkStackCacheSize; ++i) {
+    delete pooled_mark_stack_cache_[i].exchange(nullptr, std::memory_order_relaxed);
+    delete revoked_mark_stack_cache_[i].exchange(nullptr, std::memory_order_relaxed);
+  }
   STLDeleteElements(&pooled_mark_stacks_);
 }
 
@@ -968,6 +1023,65 @@ class ConcurrentCopying::CaptureRootsForMarkingVisitor : public RootVisitor {
   Thread* const self_;
 };
 
+// Scans one shard of the concurrent runtime roots (see Runtime::VisitConcurrentRootShard) on a
+// GC pool worker. Each worker constructs its own visitor so captured references land on the
+// worker's thread-local mark stack.
+class ConcurrentCopying::ConcurrentRootsScanTask : public SelfDeletingTask {
+ public:
+  ConcurrentRootsScanTask(ConcurrentCopying* concurrent_copying,
+                          bool capture_roots_for_marking,
+                          size_t shard)
+      : concurrent_copying_(concurrent_copying),
+        capture_roots_for_marking_(capture_roots_for_marking),
+        shard_(shard) {}
+
+  void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    if (capture_roots_for_marking_) {
+      // Workers race on the mark bitmap, so the test-and-set must be atomic.
+      CaptureRootsForMarkingVisitor</*kAtomicTestAndSet=*/ true> visitor(concurrent_copying_,
+                                                                         self);
+      Runtime::Current()->VisitConcurrentRootShard(&visitor, kVisitRootFlagAllRoots, shard_);
+    } else {
+      Runtime::Current()->VisitConcurrentRootShard(concurrent_copying_,
+                                                   kVisitRootFlagAllRoots,
+                                                   shard_);
+    }
+  }
+
+ private:
+  ConcurrentCopying* const concurrent_copying_;
+  const bool capture_roots_for_marking_;
+  const size_t shard_;
+};
+
+void ConcurrentCopying::VisitConcurrentRootsParallel(bool capture_roots_for_marking) {
+  Thread* const self = Thread::Current();
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  // Match the policy of the other parallel GC phases: only fan out when we have a pool and the
+  // process is jank perceptible, so background apps leave the cores to the foreground.
+  size_t thread_count = 1;
+  if (thread_pool != nullptr && Runtime::Current()->InJankPerceptibleProcessState()) {
+    thread_count = heap_->GetConcGCThreadCount() + 1;
+  }
+  if (thread_count > 1) {
+    for (size_t shard = 0; shard < Runtime::kNumConcurrentRootShards; ++shard) {
+      thread_pool->AddTask(self, new ConcurrentRootsScanTask(this,
+                                                             capture_roots_for_marking,
+                                                             shard));
+    }
+    thread_pool->SetMaxActiveWorkers(thread_count - 1);
+    thread_pool->StartWorkers(self);
+    // The GC thread steals shards off the queue alongside the workers.
+    thread_pool->Wait(self, true, true);
+    thread_pool->StopWorkers(self);
+  } else if (capture_roots_for_marking) {
+    CaptureRootsForMarkingVisitor visitor(this, self);
+    Runtime::Current()->VisitConcurrentRoots(&visitor, kVisitRootFlagAllRoots);
+  } else {
+    Runtime::Current()->VisitConcurrentRoots(this, kVisitRootFlagAllRoots);
+  }
+}
+
 class ConcurrentCopying::RevokeThreadLocalMarkStackCheckpoint : public Closure {
  public:
   RevokeThreadLocalMarkStackCheckpoint(ConcurrentCopying* concurrent_copying,
@@ -1279,14 +1393,16 @@ void ConcurrentCopying::ProcessMarkStackForMarkingAndComputeLiveBytes() {
                                });
   {
     MutexLock mu(thread_running_gc_, mark_stack_lock_);
+    FlushMarkStackCaches(/*refill_pool_cache=*/ false);
     CHECK(revoked_mark_stacks_.empty());
     CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
   }
 
-  while (!gc_mark_stack_->IsEmpty()) {
-    mirror::Object* ref = gc_mark_stack_->PopBack();
-    AddLiveBytesAndScanRef(ref);
-  }
+  DrainMarkStackWithPrefetch(gc_mark_stack_,
+                             [this] (mirror::Object* ref)
+                                 REQUIRES_SHARED(Locks::mutator_lock_) {
+                               AddLiveBytesAndScanRef(ref);
+                             });
 }
 
 class ConcurrentCopying::ImmuneSpaceCaptureRefsVisitor {
@@ -1407,8 +1523,7 @@ void ConcurrentCopying::MarkingPhase() {
   // Scan runtime roots
   {
     TimingLogger::ScopedTiming split2("VisitConcurrentRoots", GetTimings());
-    CaptureRootsForMarkingVisitor visitor(this, self);
-    Runtime::Current()->VisitConcurrentRoots(&visitor, kVisitRootFlagAllRoots);
+    VisitConcurrentRootsParallel(/*capture_roots_for_marking=*/ true);
   }
   {
     // TODO: don't visit the transaction roots if it's not active.
@@ -1604,7 +1719,7 @@ void ConcurrentCopying::CopyingPhase() {
 
   {
     TimingLogger::ScopedTiming split2("VisitConcurrentRoots", GetTimings());
-    Runtime::Current()->VisitConcurrentRoots(this, kVisitRootFlagAllRoots);
+    VisitConcurrentRootsParallel(/*capture_roots_for_marking=*/ false);
   }
   {
     // TODO: don't visit the transaction roots if it's not active.
@@ -1805,6 +1920,57 @@ void ConcurrentCopying::ExpandGcMarkStack() {
   DCHECK(!gc_mark_stack_->IsFull());
 }
 
+accounting::ObjectStack* ConcurrentCopying::TryPopPooledMarkStackCache() {
+  for (size_t i = 0; i < kMarkStackCacheSize; ++i) {
+    accounting::ObjectStack* mark_stack = pooled_mark_stack_cache_[i].load(std::memory_order_relaxed);
+    if (mark_stack != nullptr &&
+        pooled_mark_stack_cache_[i].CompareAndSet(mark_stack,
+                                                  nullptr,
+                                                  CASMode::kStrong,
+                                                  std::memory_order_acquire)) {
+      return mark_stack;
+    }
+  }
+  return nullptr;
+}
+
+bool ConcurrentCopying::TryPushRevokedMarkStackCache(accounting::ObjectStack* mark_stack) {
+  for (size_t i = 0; i < kMarkStackCacheSize; ++i) {
+    if (revoked_mark_stack_cache_[i].load(std::memory_order_relaxed) == nullptr &&
+        revoked_mark_stack_cache_[i].CompareAndSetStrongRelease(nullptr, mark_stack)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ConcurrentCopying::FlushMarkStackCaches(bool refill_pool_cache) {
+  for (size_t i = 0; i < kMarkStackCacheSize; ++i) {
+    accounting::ObjectStack* mark_stack =
+        revoked_mark_stack_cache_[i].exchange(nullptr, std::memory_order_acquire);
+    if (mark_stack != nullptr) {
+      revoked_mark_stacks_.push_back(mark_stack);
+    }
+  }
+  for (size_t i = 0; i < kMarkStackCacheSize; ++i) {
+    if (refill_pool_cache) {
+      if (pooled_mark_stack_cache_[i].load(std::memory_order_relaxed) == nullptr &&
+          !pooled_mark_stacks_.empty()) {
+        accounting::ObjectStack* mark_stack = pooled_mark_stacks_.back();
+        pooled_mark_stacks_.pop_back();
+        DCHECK(mark_stack->IsEmpty());
+        pooled_mark_stack_cache_[i].store(mark_stack, std::memory_order_release);
+      }
+    } else {
+      accounting::ObjectStack* mark_stack =
+          pooled_mark_stack_cache_[i].exchange(nullptr, std::memory_order_acquire);
+      if (mark_stack != nullptr) {
+        pooled_mark_stacks_.push_back(mark_stack);
+      }
+    }
+  }
+}
+
 void ConcurrentCopying::PushOntoMarkStack(Thread* const self, mirror::Object* to_ref) {
   CHECK_EQ(is_mark_stack_push_disallowed_.load(std::memory_order_relaxed), 0)
       << " " << to_ref << " " << mirror::Object::PrettyTypeOf(to_ref);
@@ -1822,27 +1988,34 @@ void ConcurrentCopying::PushOntoMarkStack(Thread* const self, mirror::Object* to
       // Otherwise, use a thread-local mark stack.
       accounting::AtomicStack<mirror::Object>* tl_mark_stack = self->GetThreadLocalMarkStack();
       if (UNLIKELY(tl_mark_stack == nullptr || tl_mark_stack->IsFull())) {
-        MutexLock mu(self, mark_stack_lock_);
-        // Get a new thread local mark stack.
-        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack;
-        if (!pooled_mark_stacks_.empty()) {
-          // Use a pooled mark stack.
-          new_tl_mark_stack = pooled_mark_stacks_.back();
-          pooled_mark_stacks_.pop_back();
-        } else {
-          // None pooled. Create a new one.
-          new_tl_mark_stack =
-              accounting::AtomicStack<mirror::Object>::Create(
-                  "thread local mark stack", 4 * KB, 4 * KB);
+        // Fast path: hand the full stack off and grab a pooled one through the lock-free
+        // caches. With many mutator threads the mutex fallback below convoys badly.
+        bool handed_off =
+            tl_mark_stack == nullptr || TryPushRevokedMarkStackCache(tl_mark_stack);
+        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack =
+            handed_off ? TryPopPooledMarkStackCache() : nullptr;
+        if (UNLIKELY(new_tl_mark_stack == nullptr)) {
+          MutexLock mu(self, mark_stack_lock_);
+          if (!handed_off) {
+            // Store the old full stack into a vector.
+            revoked_mark_stacks_.push_back(tl_mark_stack);
+          }
+          // Get a new thread local mark stack.
+          if (!pooled_mark_stacks_.empty()) {
+            // Use a pooled mark stack.
+            new_tl_mark_stack = pooled_mark_stacks_.back();
+            pooled_mark_stacks_.pop_back();
+          } else {
+            // None pooled. Create a new one.
+            new_tl_mark_stack =
+                accounting::AtomicStack<mirror::Object>::Create(
+                    "thread local mark stack", 4 * KB, 4 * KB);
+          }
         }
         DCHECK(new_tl_mark_stack != nullptr);
         DCHECK(new_tl_mark_stack->IsEmpty());
         new_tl_mark_stack->PushBack(to_ref);
         self->SetThreadLocalMarkStack(new_tl_mark_stack);
-        if (tl_mark_stack != nullptr) {
-          // Store the old full stack into a vector.
-          revoked_mark_stacks_.push_back(tl_mark_stack);
-        }
       } else {
         tl_mark_stack->PushBack(to_ref);
       }
@@ -2103,11 +2276,11 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
                                               REQUIRES_SHARED(Locks::mutator_lock_) {
                                             ProcessMarkStackRef(ref);
                                           });
-    while (!gc_mark_stack_->IsEmpty()) {
-      mirror::Object* to_ref = gc_mark_stack_->PopBack();
-      ProcessMarkStackRef(to_ref);
-      ++count;
-    }
+    count += DrainMarkStackWithPrefetch(gc_mark_stack_,
+                                        [this] (mirror::Object* ref)
+                                            REQUIRES_SHARED(Locks::mutator_lock_) {
+                                          ProcessMarkStackRef(ref);
+                                        });
     gc_mark_stack_->Reset();
   } else if (mark_stack_mode == kMarkStackModeShared) {
     // Do an empty checkpoint to avoid a race with a mutator preempted in the middle of a read
@@ -2117,6 +2290,7 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
     // Process the shared GC mark stack with a lock.
     {
       MutexLock mu(thread_running_gc_, mark_stack_lock_);
+      FlushMarkStackCaches(/*refill_pool_cache=*/ false);
       CHECK(revoked_mark_stacks_.empty());
       CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
     }
@@ -2134,8 +2308,11 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
         }
         gc_mark_stack_->Reset();
       }
-      for (mirror::Object* ref : refs) {
-        ProcessMarkStackRef(ref);
+      for (size_t i = 0; i < refs.size(); ++i) {
+        if (kUseMarkStackPrefetch && i + 1u < refs.size()) {
+          __builtin_prefetch(refs[i + 1]);
+        }
+        ProcessMarkStackRef(refs[i]);
         ++count;
       }
     }
@@ -2144,15 +2321,16 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
              static_cast<uint32_t>(kMarkStackModeGcExclusive));
     {
       MutexLock mu(thread_running_gc_, mark_stack_lock_);
+      FlushMarkStackCaches(/*refill_pool_cache=*/ false);
       CHECK(revoked_mark_stacks_.empty());
       CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
     }
     // Process the GC mark stack in the exclusive mode. No need to take the lock.
-    while (!gc_mark_stack_->IsEmpty()) {
-      mirror::Object* to_ref = gc_mark_stack_->PopBack();
-      ProcessMarkStackRef(to_ref);
-      ++count;
-    }
+    count += DrainMarkStackWithPrefetch(gc_mark_stack_,
+                                        [this] (mirror::Object* ref)
+                                            REQUIRES_SHARED(Locks::mutator_lock_) {
+                                          ProcessMarkStackRef(ref);
+                                        });
     gc_mark_stack_->Reset();
   }
 
@@ -2174,12 +2352,18 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
   std::vector<accounting::AtomicStack<mirror::Object>*> mark_stacks;
   {
     MutexLock mu(thread_running_gc_, mark_stack_lock_);
+    // Harvest stacks parked in the lock-free revoked cache and keep the pooled cache topped up
+    // so mutators keep hitting the lock-free path while marking continues.
+    FlushMarkStackCaches(/*refill_pool_cache=*/ true);
     // Make a copy of the mark stack vector.
     mark_stacks = revoked_mark_stacks_;
     revoked_mark_stacks_.clear();
   }
   for (accounting::AtomicStack<mirror::Object>* mark_stack : mark_stacks) {
     for (StackReference<mirror::Object>* p = mark_stack->Begin(); p != mark_stack->End(); ++p) {
+      if (kUseMarkStackPrefetch && p + 1 != mark_stack->End()) {
+        __builtin_prefetch((p + 1)->AsMirrorPtr());
+      }
       mirror::Object* to_ref = p->AsMirrorPtr();
       processor(to_ref);
       ++count;
@@ -2198,6 +2382,7 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
   }
   if (disable_weak_ref_access) {
     MutexLock mu(thread_running_gc_, mark_stack_lock_);
+    FlushMarkStackCaches(/*refill_pool_cache=*/ false);
     CHECK(revoked_mark_stacks_.empty());
     CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
   }
@@ -2443,6 +2628,7 @@ void ConcurrentCopying::CheckEmptyMarkStack() {
     // Shared, GC-exclusive, or off.
     MutexLock mu(thread_running_gc_, mark_stack_lock_);
     CHECK(gc_mark_stack_->IsEmpty());
+    FlushMarkStackCaches(/*refill_pool_cache=*/ false);
     CHECK(revoked_mark_stacks_.empty());
     CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
   }
@@ -3712,6 +3898,7 @@ void ConcurrentCopying::FinishPhase() {
   Thread* const self = Thread::Current();
   {
     MutexLock mu(self, mark_stack_lock_);
+    FlushMarkStackCaches(/*refill_pool_cache=*/ false);
     CHECK(revoked_mark_stacks_.empty());
     CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
   }
@@ -144,6 +144,13 @@ class ConcurrentCopying : public GarbageCollector {
   bool IsActive() const {
     return is_active_;
   }
+  // Cumulative copy statistics, exported by Heap::GetGcPerformanceSnapshot.
+  uint64_t GetCumulativeBytesMoved() const {
+    return cumulative_bytes_moved_;
+  }
+  uint64_t GetCumulativeObjectsMoved() const {
+    return cumulative_objects_moved_;
+  }
   Barrier& GetBarrier() {
     return *gc_barrier_;
   }
@@ -324,6 +331,12 @@ class ConcurrentCopying : public GarbageCollector {
   void ActivateReadBarrierEntrypoints();
 
   void CaptureThreadRootsForMarking() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Visit the class-linker, intern-table and other concurrent roots, sharding the scan over the
+  // heap's worker thread pool when one is available so the scan scales with core count. If
+  // `capture_roots_for_marking` is true the roots are captured onto mark stacks for the
+  // two-phase marking used with generational CC instead of being marked directly.
+  void VisitConcurrentRootsParallel(bool capture_roots_for_marking)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
   void AddLiveBytesAndScanRef(mirror::Object* ref) REQUIRES_SHARED(Locks::mutator_lock_);
   bool TestMarkBitmapForRef(mirror::Object* ref) REQUIRES_SHARED(Locks::mutator_lock_);
   template <bool kAtomic = false>
@@ -332,6 +345,16 @@ class ConcurrentCopying : public GarbageCollector {
   void ProcessMarkStackForMarkingAndComputeLiveBytes() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
 
+  // Try to pop an empty mark stack from the lock-free pool cache. Returns nullptr on a miss.
+  accounting::ObjectStack* TryPopPooledMarkStackCache();
+  // Try to hand off a full thread-local mark stack via the lock-free revoked cache. Returns
+  // false when every slot is occupied and the caller must fall back to mark_stack_lock_.
+  bool TryPushRevokedMarkStackCache(accounting::ObjectStack* mark_stack);
+  // Move cached revoked stacks into revoked_mark_stacks_ and either top the pooled cache up
+  // from pooled_mark_stacks_ (`refill_pool_cache`) or drain it back into the pool so the pool
+  // size invariants hold.
+  void FlushMarkStackCaches(bool refill_pool_cache) REQUIRES(mark_stack_lock_);
+
   void RemoveThreadMarkStackMapping(Thread* thread, accounting::ObjectStack* tl_mark_stack)
       REQUIRES(mark_stack_lock_);
   void AddThreadMarkStackMapping(Thread* thread, accounting::ObjectStack* tl_mark_stack)
@@ -379,6 +402,13 @@ class ConcurrentCopying : public GarbageCollector {
   static constexpr size_t kMarkStackPoolSize = 256;
   std::vector<accounting::ObjectStack*> pooled_mark_stacks_
       GUARDED_BY(mark_stack_lock_);
+  // Lock-free caches in front of pooled_mark_stacks_ and revoked_mark_stacks_ so that mutators
+  // in PushOntoMarkStack() can acquire a fresh thread-local mark stack and hand off a full one
+  // without taking mark_stack_lock_. A slot holds nullptr when empty and is claimed with CAS.
+  // The GC refills and drains the caches while holding mark_stack_lock_.
+  static constexpr size_t kMarkStackCacheSize = 32;
+  Atomic<accounting::ObjectStack*> pooled_mark_stack_cache_[kMarkStackCacheSize];
+  Atomic<accounting::ObjectStack*> revoked_mark_stack_cache_[kMarkStackCacheSize];
   Thread* thread_running_gc_;
   bool is_marking_;                       // True while marking is ongoing.
   // True while we might dispatch on the read barrier entrypoints.
@@ -511,6 +541,7 @@ class ConcurrentCopying : public GarbageCollector {
   class ImmuneSpaceCaptureRefsVisitor;
   template <bool kAtomicTestAndSet = false> class CaptureRootsForMarkingVisitor;
   class CaptureThreadRootsForMarkingAndCheckpoint;
+  class ConcurrentRootsScanTask;
   template <bool kHandleInterRegionRefs> class ComputeLiveBytesAndMarkRefFieldsVisitor;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(ConcurrentCopying);
@@ -308,6 +308,23 @@ uint64_t GarbageCollector::GetTotalPausedTimeNs() {
   return pause_histogram_.AdjustedSum();
 }
 
+void GarbageCollector::GetPauseHistogramStats(uint64_t* sum_ns,
+                                              uint64_t* count,
+                                              uint64_t* min_ns,
+                                              uint64_t* max_ns) {
+  MutexLock mu(Thread::Current(), pause_histogram_lock_);
+  *count = pause_histogram_.SampleSize();
+  if (*count == 0) {
+    *sum_ns = 0;
+    *min_ns = 0;
+    *max_ns = 0;
+    return;
+  }
+  *sum_ns = pause_histogram_.AdjustedSum();
+  *min_ns = pause_histogram_.AdjustedMin();
+  *max_ns = pause_histogram_.AdjustedMax();
+}
+
 void GarbageCollector::DumpPerformanceInfo(std::ostream& os) {
   const CumulativeLogger& logger = GetCumulativeTimings();
   const size_t iterations = logger.GetIterations();
@@ -86,6 +86,9 @@ class GarbageCollector : public RootVisitor, public IsMarkedVisitor, public Mark
     return total_thread_cpu_time_ns_;
   }
   uint64_t GetTotalPausedTimeNs() REQUIRES(!pause_histogram_lock_);
+  // Snapshot the pause histogram into sum/count/min/max (times in ns) without resetting it.
+  void GetPauseHistogramStats(uint64_t* sum_ns, uint64_t* count, uint64_t* min_ns,
+                              uint64_t* max_ns) REQUIRES(!pause_histogram_lock_);
   int64_t GetTotalFreedBytes() const {
     return total_freed_bytes_;
   }
@@ -54,6 +54,10 @@ namespace collector {
 static constexpr bool kUseRecursiveMark = false;
 static constexpr bool kUseMarkStackPrefetch = true;
 static constexpr size_t kSweepArrayChunkFreeSize = 1024;
+// Concurrently re-scan and re-clean cards dirtied early in the mutator window
+// (see PreCleanCards()) so that the RecursiveMarkDirtyObjects call in the
+// pause only handles the recently-dirtied tail. Applies to all concurrent
+// mark-sweep variants, including sticky collections.
 static constexpr bool kPreCleanCards = true;
 
 // Parallelism options.
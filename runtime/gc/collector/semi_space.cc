@@ -16,6 +16,7 @@
 
 #include "semi_space-inl.h"
 
+#include <algorithm>
 #include <climits>
 #include <functional>
 #include <numeric>
@@ -48,6 +49,7 @@
 #include "runtime.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "write_barrier-inl.h"
 
 using ::art::mirror::Object;
@@ -58,6 +60,11 @@ namespace collector {
 
 static constexpr bool kProtectFromSpace = true;
 static constexpr bool kStoreStackTraces = false;
+// Minimum number of mark stack entries before we bother with the parallel copy phase.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
+// Size of the to-space blocks handed out to the copy workers. Large enough that refills are
+// rare, small enough that the unused tails of the last blocks don't waste much to-space.
+static constexpr size_t kParallelCopyBufferBytes = 64 * KB;
 
 void SemiSpace::BindBitmaps() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
@@ -91,7 +98,14 @@ SemiSpace::SemiSpace(Heap* heap, const std::string& name_prefix)
       objects_moved_(0U),
       saved_bytes_(0U),
       collector_name_(name_),
-      swap_semi_spaces_(true) {
+      swap_semi_spaces_(true),
+      support_parallel_copy_(true),
+      to_space_bump_(nullptr),
+      to_space_uses_blocks_(false),
+      parallel_lock_("semi space parallel lock"),
+      parallel_objects_moved_(0U),
+      parallel_bytes_moved_(0U),
+      parallel_saved_bytes_(0U) {
 }
 
 void SemiSpace::RunPhases() {
@@ -141,6 +155,9 @@ void SemiSpace::InitializePhase() {
     mark_bitmap_ = heap_->GetMarkBitmap();
   }
   fallback_space_ = GetHeap()->GetNonMovingSpace();
+  to_space_bump_ = to_space_->IsBumpPointerSpace() ? to_space_->AsBumpPointerSpace() : nullptr;
+  to_space_uses_blocks_ = false;
+  serial_copy_buffer_ = CopyBuffer();
 }
 
 void SemiSpace::ProcessReferences(Thread* self) {
@@ -427,21 +444,28 @@ static inline size_t CopyAvoidingDirtyingPages(void* dest, const void* src, size
 mirror::Object* SemiSpace::MarkNonForwardedObject(mirror::Object* obj) {
   const size_t object_size = obj->SizeOf();
   size_t bytes_allocated, unused_bytes_tl_bulk_allocated;
-  // Copy it to the to-space.
-  mirror::Object* forward_address = to_space_->AllocThreadUnsafe(
-      self_, object_size, &bytes_allocated, nullptr, &unused_bytes_tl_bulk_allocated);
-
-  if (forward_address != nullptr && to_space_live_bitmap_ != nullptr) {
-    to_space_live_bitmap_->Set(forward_address);
-  }
-  // If it's still null, attempt to use the fallback space.
-  if (UNLIKELY(forward_address == nullptr)) {
-    forward_address = fallback_space_->AllocThreadUnsafe(
+  mirror::Object* forward_address;
+  if (UNLIKELY(to_space_uses_blocks_)) {
+    // The parallel phase carved blocks out of the to-space, so later serial allocations must
+    // stay in blocks too or the space is no longer walkable.
+    forward_address = AllocForCopy(&serial_copy_buffer_, object_size, &bytes_allocated);
+  } else {
+    // Copy it to the to-space.
+    forward_address = to_space_->AllocThreadUnsafe(
         self_, object_size, &bytes_allocated, nullptr, &unused_bytes_tl_bulk_allocated);
-    CHECK(forward_address != nullptr) << "Out of memory in the to-space and fallback space.";
-    accounting::ContinuousSpaceBitmap* bitmap = fallback_space_->GetLiveBitmap();
-    if (bitmap != nullptr) {
-      bitmap->Set(forward_address);
+
+    if (forward_address != nullptr && to_space_live_bitmap_ != nullptr) {
+      to_space_live_bitmap_->Set(forward_address);
+    }
+    // If it's still null, attempt to use the fallback space.
+    if (UNLIKELY(forward_address == nullptr)) {
+      forward_address = fallback_space_->AllocThreadUnsafe(
+          self_, object_size, &bytes_allocated, nullptr, &unused_bytes_tl_bulk_allocated);
+      CHECK(forward_address != nullptr) << "Out of memory in the to-space and fallback space.";
+      accounting::ContinuousSpaceBitmap* bitmap = fallback_space_->GetLiveBitmap();
+      if (bitmap != nullptr) {
+        bitmap->Set(forward_address);
+      }
     }
   }
   ++objects_moved_;
@@ -585,9 +609,346 @@ void SemiSpace::ScanObject(Object* obj) {
       visitor, visitor);
 }
 
+class SemiSpace::ParallelMarkStackTask : public Task {
+ public:
+  ParallelMarkStackTask(ThreadPool* thread_pool,
+                        SemiSpace* collector,
+                        size_t mark_stack_size,
+                        StackReference<mirror::Object>* mark_stack)
+      : thread_pool_(thread_pool),
+        collector_(collector),
+        mark_stack_pos_(mark_stack_size) {
+    // We may have to copy part of an existing mark stack when another mark stack overflows.
+    if (mark_stack_size != 0) {
+      DCHECK(mark_stack != nullptr);
+      std::copy(mark_stack, mark_stack + mark_stack_size, mark_stack_);
+    }
+  }
+
+  static const size_t kMaxSize = 1 * KB;
+
+ private:
+  class ParallelMarkVisitor {
+   public:
+    explicit ParallelMarkVisitor(ParallelMarkStackTask* chunk_task) : chunk_task_(chunk_task) {}
+
+    void operator()(ObjPtr<Object> obj, MemberOffset offset, bool /* is_static */) const
+        ALWAYS_INLINE REQUIRES(Locks::heap_bitmap_lock_)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      // Object was already verified when we scanned it.
+      chunk_task_->MarkAndUpdate(obj->GetFieldObjectReferenceAddr<kVerifyNone>(offset));
+    }
+
+    void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const
+        REQUIRES(Locks::heap_bitmap_lock_)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      chunk_task_->collector_->DelayReferenceReferent(klass, ref);
+    }
+
+    // TODO: Remove NO_THREAD_SAFETY_ANALYSIS when clang better understands visitors.
+    void VisitRootIfNonNull(mirror::CompressedReference<mirror::Object>* root) const
+        NO_THREAD_SAFETY_ANALYSIS {
+      if (!root->IsNull()) {
+        VisitRoot(root);
+      }
+    }
+
+    void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
+        NO_THREAD_SAFETY_ANALYSIS {
+      chunk_task_->MarkAndUpdate(root);
+    }
+
+   private:
+    ParallelMarkStackTask* const chunk_task_;
+  };
+
+  // Mark through one reference slot, updating it if the target moved. Unlike the serial
+  // MarkObject(), the object may have been claimed by another worker, in which case the slot is
+  // simply updated with the forwarding address that worker publishes.
+  template<typename CompressedReferenceType>
+  ALWAYS_INLINE void MarkAndUpdate(CompressedReferenceType* obj_ptr)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    mirror::Object* obj = obj_ptr->AsMirrorPtr();
+    if (obj == nullptr || collector_->to_space_->HasAddress(obj)) {
+      return;
+    }
+    bool push = false;
+    mirror::Object* forward_address = collector_->MarkObjectParallel(
+        obj, buffer_, &push, &objects_moved_, &bytes_moved_, &saved_bytes_);
+    if (push) {
+      MarkStackPush(forward_address);
+    }
+    if (obj != forward_address) {
+      obj_ptr->Assign(forward_address);
+    }
+  }
+
+  ALWAYS_INLINE void MarkStackPush(Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (UNLIKELY(mark_stack_pos_ == kMaxSize)) {
+      // Mark stack overflow, give 1/2 the stack to the thread pool as a new work task. Tasks
+      // added by a worker land in its work-stealing deque, so idle workers pick them up.
+      mark_stack_pos_ /= 2;
+      auto* task = new ParallelMarkStackTask(thread_pool_,
+                                             collector_,
+                                             kMaxSize - mark_stack_pos_,
+                                             mark_stack_ + mark_stack_pos_);
+      thread_pool_->AddTask(Thread::Current(), task);
+    }
+    DCHECK(obj != nullptr);
+    DCHECK_LT(mark_stack_pos_, kMaxSize);
+    mark_stack_[mark_stack_pos_++].Assign(obj);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+  // Scans all of the objects, copying the ones in the from-space as it goes.
+  void Run(Thread* self ATTRIBUTE_UNUSED) override
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    buffer_ = collector_->AcquireCopyBuffer();
+    ParallelMarkVisitor visitor(this);
+    while (mark_stack_pos_ != 0) {
+      Object* obj = mark_stack_[--mark_stack_pos_].AsMirrorPtr();
+      DCHECK(obj != nullptr);
+      DCHECK(!collector_->from_space_->HasAddress(obj));
+      // Turn off read barrier as in ScanObject().
+      obj->VisitReferences</*kVisitNativeRoots=*/true, kDefaultVerifyFlags, kWithoutReadBarrier>(
+          visitor, visitor);
+    }
+    collector_->ReleaseCopyBuffer(buffer_);
+    // Flush the statistics once per task rather than once per object.
+    collector_->parallel_objects_moved_.fetch_add(objects_moved_, std::memory_order_relaxed);
+    collector_->parallel_bytes_moved_.fetch_add(bytes_moved_, std::memory_order_relaxed);
+    collector_->parallel_saved_bytes_.fetch_add(saved_bytes_, std::memory_order_relaxed);
+  }
+
+  ThreadPool* const thread_pool_;
+  SemiSpace* const collector_;
+  // Thread local mark stack for this task.
+  StackReference<mirror::Object> mark_stack_[kMaxSize];
+  // Mark stack position.
+  size_t mark_stack_pos_;
+  // To-space buffer held for the duration of the task, null when the to-space is not a bump
+  // pointer space.
+  CopyBuffer* buffer_ = nullptr;
+  // Task local statistics, flushed into the collector at the end of Run().
+  size_t objects_moved_ = 0;
+  size_t bytes_moved_ = 0;
+  size_t saved_bytes_ = 0;
+};
+
+mirror::Object* SemiSpace::AllocForCopy(CopyBuffer* buffer,
+                                        size_t object_size,
+                                        size_t* bytes_allocated) {
+  mirror::Object* forward_address = nullptr;
+  if (buffer != nullptr) {
+    DCHECK(to_space_bump_ != nullptr);
+    const size_t alloc_size = RoundUp(object_size, space::BumpPointerSpace::kAlignment);
+    if (UNLIKELY(buffer->pos == nullptr || buffer->pos + alloc_size > buffer->end)) {
+      // Report the objects carved out of the old block before dropping it; the unused tail stays
+      // zero, which the space walk tolerates.
+      if (buffer->objects != 0u) {
+        to_space_bump_->RecordBlockAllocation(buffer->objects, buffer->bytes);
+        buffer->objects = 0;
+        buffer->bytes = 0;
+      }
+      // Large objects get a block of their own so that they don't waste a whole buffer.
+      const size_t block_size = std::max(alloc_size, kParallelCopyBufferBytes);
+      uint8_t* block = to_space_bump_->AllocGcBlock(block_size);
+      if (LIKELY(block != nullptr)) {
+        buffer->pos = block;
+        buffer->end = block + block_size;
+      } else {
+        buffer->pos = nullptr;
+        buffer->end = nullptr;
+      }
+    }
+    if (LIKELY(buffer->pos != nullptr)) {
+      forward_address = reinterpret_cast<mirror::Object*>(buffer->pos);
+      buffer->pos += alloc_size;
+      ++buffer->objects;
+      buffer->bytes += alloc_size;
+      *bytes_allocated = alloc_size;
+    }
+    // A null forward_address means the to-space is exhausted; fall through to the fallback space.
+  } else {
+    // Not a bump pointer to-space (e.g. homogeneous space compaction), the space's allocator is
+    // thread-safe.
+    size_t unused_bytes_tl_bulk_allocated;
+    forward_address = to_space_->Alloc(
+        Thread::Current(), object_size, bytes_allocated, nullptr,
+        &unused_bytes_tl_bulk_allocated);
+  }
+  if (LIKELY(forward_address != nullptr)) {
+    if (to_space_live_bitmap_ != nullptr) {
+      to_space_live_bitmap_->AtomicTestAndSet(forward_address);
+    }
+  } else {
+    size_t unused_bytes_tl_bulk_allocated;
+    forward_address = fallback_space_->Alloc(
+        Thread::Current(), object_size, bytes_allocated, nullptr,
+        &unused_bytes_tl_bulk_allocated);
+    CHECK(forward_address != nullptr) << "Out of memory in the to-space and fallback space.";
+    accounting::ContinuousSpaceBitmap* bitmap = fallback_space_->GetLiveBitmap();
+    if (bitmap != nullptr) {
+      bitmap->AtomicTestAndSet(forward_address);
+    }
+  }
+  return forward_address;
+}
+
+mirror::Object* SemiSpace::MarkObjectParallel(mirror::Object* obj,
+                                              CopyBuffer* buffer,
+                                              bool* push,
+                                              size_t* objects_moved,
+                                              size_t* bytes_moved,
+                                              size_t* saved_bytes) {
+  *push = false;
+  if (from_space_->HasAddress(obj)) {
+    while (true) {
+      LockWord lock_word = obj->GetLockWord(/*as_volatile=*/ true);
+      if (lock_word.GetState() == LockWord::kForwardingAddress) {
+        mirror::Object* forward_address =
+            reinterpret_cast<mirror::Object*>(lock_word.ForwardingAddress());
+        if (LIKELY(forward_address != nullptr)) {
+          return forward_address;
+        }
+        // A null forwarding address is the claim marker of a worker which is still copying the
+        // object (no object can forward to null); spin until the real address is published.
+        continue;
+      }
+      // Claim the object by installing a null forwarding address so that exactly one worker
+      // copies it; losers spin above until the winner publishes the copy.
+      if (!obj->CasLockWord(lock_word,
+                            LockWord::FromForwardingAddress(0u),
+                            CASMode::kWeak,
+                            std::memory_order_acquire)) {
+        continue;
+      }
+      const size_t object_size = obj->SizeOf();
+      size_t bytes_allocated = 0;
+      mirror::Object* forward_address = AllocForCopy(buffer, object_size, &bytes_allocated);
+      *objects_moved += 1;
+      *bytes_moved += bytes_allocated;
+      *saved_bytes +=
+          CopyAvoidingDirtyingPages(reinterpret_cast<void*>(forward_address), obj, object_size);
+      // The claim overwrote the from-space lock word and the copy inherited the claim marker;
+      // restore the original lock word in the copy before publishing.
+      forward_address->SetLockWord(lock_word, false);
+      if (kUseBakerReadBarrier) {
+        forward_address->AssertReadBarrierState();
+      }
+      DCHECK(to_space_->HasAddress(forward_address) ||
+             fallback_space_->HasAddress(forward_address));
+      // Publishing the forwarding address releases the copied contents to the spinning workers.
+      obj->SetLockWord(LockWord::FromForwardingAddress(reinterpret_cast<size_t>(forward_address)),
+                       /*as_volatile=*/ true);
+      *push = true;
+      return forward_address;
+    }
+  }
+  if (!immune_spaces_.IsInImmuneRegion(obj)) {
+    DCHECK(!to_space_->HasAddress(obj)) << "Tried to mark " << obj << " in to-space";
+    auto slow_path = [this](const mirror::Object* ref) {
+      CHECK(!to_space_->HasAddress(ref)) << "Marking " << ref << " in to_space_";
+      // Marking a large object, make sure its aligned as a consistency check.
+      CHECK_ALIGNED(ref, kPageSize);
+    };
+    if (!mark_bitmap_->AtomicTestAndSet(obj, slow_path)) {
+      // This object was not previously marked.
+      *push = true;
+    }
+  }
+  return obj;
+}
+
+SemiSpace::CopyBuffer* SemiSpace::AcquireCopyBuffer() {
+  if (to_space_bump_ == nullptr) {
+    // Workers allocate through the to-space's thread-safe allocator instead.
+    return nullptr;
+  }
+  MutexLock mu(Thread::Current(), parallel_lock_);
+  if (free_copy_buffers_.empty()) {
+    copy_buffers_.push_back(std::make_unique<CopyBuffer>());
+    free_copy_buffers_.push_back(copy_buffers_.back().get());
+  }
+  CopyBuffer* buffer = free_copy_buffers_.back();
+  free_copy_buffers_.pop_back();
+  return buffer;
+}
+
+void SemiSpace::ReleaseCopyBuffer(CopyBuffer* buffer) {
+  if (buffer == nullptr) {
+    return;
+  }
+  MutexLock mu(Thread::Current(), parallel_lock_);
+  free_copy_buffers_.push_back(buffer);
+}
+
+void SemiSpace::RetireCopyBuffers() {
+  MutexLock mu(Thread::Current(), parallel_lock_);
+  if (to_space_bump_ != nullptr) {
+    for (const std::unique_ptr<CopyBuffer>& buffer : copy_buffers_) {
+      to_space_bump_->RecordBlockAllocation(buffer->objects, buffer->bytes);
+    }
+    if (serial_copy_buffer_.objects != 0u) {
+      to_space_bump_->RecordBlockAllocation(serial_copy_buffer_.objects,
+                                            serial_copy_buffer_.bytes);
+    }
+  }
+  serial_copy_buffer_ = CopyBuffer();
+  copy_buffers_.clear();
+  free_copy_buffers_.clear();
+}
+
+size_t SemiSpace::GetThreadCount() const {
+  if (!support_parallel_copy_ || heap_->GetThreadPool() == nullptr) {
+    return 1;
+  }
+  return heap_->GetParallelGCThreadCount() + 1;
+}
+
+void SemiSpace::ProcessMarkStackParallel(size_t thread_count) {
+  Thread* self = Thread::Current();
+  ThreadPool* thread_pool = GetHeap()->GetThreadPool();
+  const size_t chunk_size = std::min(mark_stack_->Size() / thread_count + 1,
+                                     static_cast<size_t>(ParallelMarkStackTask::kMaxSize));
+  CHECK_GT(chunk_size, 0U);
+  // Split the current mark stack up into work tasks.
+  for (auto* it = mark_stack_->Begin(), *end = mark_stack_->End(); it < end; ) {
+    const size_t delta = std::min(static_cast<size_t>(end - it), chunk_size);
+    thread_pool->AddTask(self, new ParallelMarkStackTask(thread_pool, this, delta, it));
+    it += delta;
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, true);
+  thread_pool->StopWorkers(self);
+  mark_stack_->Reset();
+  // Fold the task statistics into the serial counters now that the workers are quiescent.
+  objects_moved_ += parallel_objects_moved_.load(std::memory_order_relaxed);
+  bytes_moved_ += parallel_bytes_moved_.load(std::memory_order_relaxed);
+  saved_bytes_ += parallel_saved_bytes_.load(std::memory_order_relaxed);
+  parallel_objects_moved_.store(0, std::memory_order_relaxed);
+  parallel_bytes_moved_.store(0, std::memory_order_relaxed);
+  parallel_saved_bytes_.store(0, std::memory_order_relaxed);
+  if (to_space_bump_ != nullptr) {
+    // The workers carved blocks out of the to-space, so any serial allocations which follow
+    // (e.g. during reference processing) must stay in blocks too to keep the space walkable.
+    to_space_uses_blocks_ = true;
+  }
+}
+
 // Scan anything that's on the mark stack.
 void SemiSpace::ProcessMarkStack() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  const size_t thread_count = GetThreadCount();
+  if (thread_count > 1 && mark_stack_->Size() >= kMinimumParallelMarkStackSize) {
+    ProcessMarkStackParallel(thread_count);
+  }
   while (!mark_stack_->IsEmpty()) {
     Object* obj = mark_stack_->PopBack();
     ScanObject(obj);
@@ -644,10 +1005,13 @@ void SemiSpace::FinishPhase() {
       from_space_->GetMemMap()->Protect(PROT_NONE);
     }
   }
+  // Report any outstanding copy buffer allocations to the to-space before detaching from it.
+  RetireCopyBuffers();
   // Null the "to" and "from" spaces since compacting from one to the other isn't valid until
   // further action is done by the heap.
   to_space_ = nullptr;
   from_space_ = nullptr;
+  to_space_bump_ = nullptr;
   CHECK(mark_stack_->IsEmpty());
   mark_stack_->Reset();
   // Clear all of the spaces' mark bitmaps.
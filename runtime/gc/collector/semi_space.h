@@ -18,10 +18,12 @@
 #define ART_RUNTIME_GC_COLLECTOR_SEMI_SPACE_H_
 
 #include <memory>
+#include <vector>
 
 #include "base/atomic.h"
 #include "base/locks.h"
 #include "base/macros.h"
+#include "base/mutex.h"
 #include "garbage_collector.h"
 #include "gc/accounting/heap_bitmap.h"
 #include "gc_root.h"
@@ -48,6 +50,7 @@ typedef AtomicStack<mirror::Object> ObjectStack;
 }  // namespace accounting
 
 namespace space {
+class BumpPointerSpace;
 class ContinuousMemMapAllocSpace;
 class ContinuousSpace;
 }  // namespace space
@@ -195,6 +198,15 @@ class SemiSpace : public GarbageCollector {
   void ProcessMarkStack() override
       REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
 
+  // Copy the transitive closure in parallel on the heap's thread pool, with per-worker to-space
+  // buffers and work distribution through the pool's work-stealing deques. Called by
+  // ProcessMarkStack() when a thread pool exists and the mark stack is large enough.
+  void ProcessMarkStackParallel(size_t thread_count)
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_);
+
+  // Number of threads the copy phase may use, including the calling thread.
+  size_t GetThreadCount() const;
+
   inline mirror::Object* GetForwardingAddressInFromSpace(mirror::Object* obj) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -241,7 +253,73 @@ class SemiSpace : public GarbageCollector {
   // Whether or not we swap the semi spaces in the heap during the marking phase.
   bool swap_semi_spaces_;
 
+  // Whether the parallel copy phase may be used. Subclasses which override
+  // MarkNonForwardedObject() (the zygote compactor and its bins) must keep this false since the
+  // parallel path does not go through the override.
+  bool support_parallel_copy_;
+
  private:
+  // Per-worker bump allocation buffer, carved out of a bump pointer to-space in blocks so that
+  // parallel copying does not contend on the space's end pointer per object. When the to-space
+  // is not a bump pointer space, workers allocate through the space's thread-safe allocator
+  // instead and no buffers are handed out.
+  struct CopyBuffer {
+    uint8_t* pos = nullptr;
+    uint8_t* end = nullptr;
+    // Objects / bytes carved out of blocks and not yet reported to the space.
+    size_t objects = 0;
+    size_t bytes = 0;
+  };
+
+  class ParallelMarkStackTask;
+
+  // Copy `obj` from the from-space, or mark it in place, racing with other workers. Returns the
+  // forwarded address and sets *push when the caller must scan the returned object. Statistics
+  // are accumulated into the caller's counters and flushed once per task.
+  mirror::Object* MarkObjectParallel(mirror::Object* obj,
+                                     CopyBuffer* buffer,
+                                     bool* push,
+                                     size_t* objects_moved,
+                                     size_t* bytes_moved,
+                                     size_t* saved_bytes)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Allocate to-space (or fallback space) memory for a copied object, refilling the worker's
+  // buffer with a new block as needed. Also sets the relevant live bitmap bit.
+  mirror::Object* AllocForCopy(CopyBuffer* buffer, size_t object_size, size_t* bytes_allocated)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Hand out / take back a worker buffer for the duration of one task.
+  CopyBuffer* AcquireCopyBuffer() REQUIRES(!parallel_lock_);
+  void ReleaseCopyBuffer(CopyBuffer* buffer) REQUIRES(!parallel_lock_);
+
+  // Report outstanding buffer allocations to the to-space and drop all buffers.
+  void RetireCopyBuffers() REQUIRES(!parallel_lock_);
+
+  // The to-space as a bump pointer space, or null. Cached in InitializePhase.
+  space::BumpPointerSpace* to_space_bump_;
+
+  // Once the parallel phase has carved blocks out of a bump pointer to-space, later serial
+  // allocations must stay in blocks too or the space is no longer walkable.
+  bool to_space_uses_blocks_;
+
+  // Serial counterpart of the worker buffers, used by MarkNonForwardedObject once
+  // to_space_uses_blocks_ is set.
+  CopyBuffer serial_copy_buffer_;
+
+  // Guards the buffer free list; leaf lock taken by workers around task start and end.
+  Mutex parallel_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<std::unique_ptr<CopyBuffer>> copy_buffers_ GUARDED_BY(parallel_lock_);
+  std::vector<CopyBuffer*> free_copy_buffers_ GUARDED_BY(parallel_lock_);
+
+  // Statistics flushed by the parallel tasks, folded into the plain counters after each
+  // parallel phase.
+  Atomic<size_t> parallel_objects_moved_;
+  Atomic<size_t> parallel_bytes_moved_;
+  Atomic<size_t> parallel_saved_bytes_;
+
   class BitmapSetSlowPathVisitor;
   class MarkObjectVisitor;
   class VerifyNoFromSpaceReferencesVisitor;
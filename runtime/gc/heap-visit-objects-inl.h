@@ -19,6 +19,10 @@
 
 #include "heap.h"
 
+#include <algorithm>
+#include <functional>
+
+#include "base/atomic.h"
 #include "base/mutex-inl.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/space/bump_pointer_space-walk-inl.h"
@@ -28,6 +32,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
@@ -108,8 +113,19 @@ inline void Heap::VisitObjectsInternal(Visitor&& visitor) {
     // Visit objects in bump pointer space.
     bump_pointer_space_->Walk(visitor);
   }
+  VisitAllocationStackRange(allocation_stack_->Begin(), allocation_stack_->End(), visitor);
+  {
+    ReaderMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
+    GetLiveBitmap()->Visit<Visitor>(visitor);
+  }
+}
+
+template <typename Visitor>
+inline void Heap::VisitAllocationStackRange(StackReference<mirror::Object>* begin,
+                                            StackReference<mirror::Object>* end,
+                                            Visitor&& visitor) {
   // TODO: Switch to standard begin and end to use ranged a based loop.
-  for (auto* it = allocation_stack_->Begin(), *end = allocation_stack_->End(); it < end; ++it) {
+  for (auto* it = begin; it < end; ++it) {
     mirror::Object* const obj = it->AsMirrorPtr();
 
     mirror::Class* kls = nullptr;
@@ -157,10 +173,152 @@ inline void Heap::VisitObjectsInternal(Visitor&& visitor) {
       visitor(obj);
     }
   }
+}
+
+template <typename Visitor>
+inline void Heap::VisitObjectsParallel(Visitor* visitors, size_t num_visitors) {
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertSharedHeld(self);
+  DCHECK(!Locks::mutator_lock_->IsExclusiveHeld(self)) << "Call VisitObjectsPaused() instead";
+  DCHECK_GT(num_visitors, 0u);
+  if (num_visitors == 1u || GetThreadPool() == nullptr) {
+    // No workers to partition the heap across.
+    VisitObjects(visitors[0]);
+    return;
+  }
+  // As in VisitObjects(), a concurrent moving collection must be kept from
+  // running in between the pauses of the walk. The walk itself happens with
+  // all threads suspended, which lets the pool workers visit objects without
+  // any coordination with the mutators.
+  if (IsGcConcurrentAndMoving()) {
+    IncrementDisableMovingGC(self);
+  }
   {
-    ReaderMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
-    GetLiveBitmap()->Visit<Visitor>(visitor);
+    ScopedThreadSuspension sts(self, kWaitingForVisitObjects);
+    ScopedSuspendAll ssa(__FUNCTION__);
+    VisitObjectsParallelInternal(self, visitors, num_visitors);
+  }
+  if (IsGcConcurrentAndMoving()) {
+    DecrementDisableMovingGC(self);
+  }
+}
+
+template <typename Visitor>
+inline void Heap::VisitObjectsParallelInternal(Thread* self,
+                                               Visitor* visitors,
+                                               size_t num_visitors) {
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  ThreadPool* thread_pool = GetThreadPool();
+  DCHECK(thread_pool != nullptr);
+  // Cap the parallelism at the number of visitor instances, counting the
+  // caller which drains work units alongside the pool workers.
+  const size_t thread_count = std::min(num_visitors, thread_pool->GetThreadCount() + 1);
+  // Partition the heap into work units which each visit a disjoint set of
+  // objects, so every object is reported to exactly one visitor. Several work
+  // units per thread give the claiming loop below some slack to balance units
+  // of uneven cost.
+  const size_t target_units = thread_count * 4;
+  // Address range per bitmap work unit. Scanning empty bitmap ranges is cheap,
+  // so sparsely populated spaces do not make their units more expensive.
+  static constexpr size_t kBitmapChunkBytes = 4 * MB;
+  std::vector<std::function<void(Visitor&)>> work_units;
+  if (region_space_ != nullptr) {
+    DCHECK(IsGcConcurrentAndMoving());
+    const size_t num_regions = region_space_->GetNumRegions();
+    const size_t regions_per_unit = std::max<size_t>(num_regions / target_units, 1u);
+    for (size_t begin = 0u; begin < num_regions; begin += regions_per_unit) {
+      const size_t end = std::min(begin + regions_per_unit, num_regions);
+      work_units.push_back([=](Visitor& visitor) NO_THREAD_SAFETY_ANALYSIS {
+        region_space_->WalkRange(visitor, begin, end);
+      });
+    }
+  }
+  if (bump_pointer_space_ != nullptr) {
+    // One unit per block (the main block plus TLABs); GetBlockRanges() takes
+    // the space's block_lock_ only long enough to snapshot the boundaries.
+    for (const std::pair<uint8_t*, uint8_t*>& range : bump_pointer_space_->GetBlockRanges()) {
+      work_units.push_back([=](Visitor& visitor) NO_THREAD_SAFETY_ANALYSIS {
+        space::BumpPointerSpace::WalkBlock(range.first, range.second, visitor);
+      });
+    }
+  }
+  {
+    StackReference<mirror::Object>* stack_begin = allocation_stack_->Begin();
+    StackReference<mirror::Object>* stack_end = allocation_stack_->End();
+    const size_t stack_size = stack_end - stack_begin;
+    const size_t entries_per_unit = std::max<size_t>(stack_size / target_units, 1u);
+    for (auto* it = stack_begin; it < stack_end; it += entries_per_unit) {
+      auto* unit_end = std::min(it + entries_per_unit, stack_end);
+      work_units.push_back([=](Visitor& visitor) NO_THREAD_SAFETY_ANALYSIS {
+        VisitAllocationStackRange(it, unit_end, visitor);
+      });
+    }
+  }
+  for (space::ContinuousSpace* space : continuous_spaces_) {
+    accounting::ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
+    if (live_bitmap == nullptr || space->IsRegionSpace()) {
+      // The region space is walked region by region above.
+      continue;
+    }
+    for (uintptr_t begin = live_bitmap->HeapBegin(), limit = live_bitmap->HeapLimit();
+         begin < limit;
+         begin += kBitmapChunkBytes) {
+      const uintptr_t end = std::min(begin + kBitmapChunkBytes, limit);
+      work_units.push_back([=](Visitor& visitor) NO_THREAD_SAFETY_ANALYSIS {
+        // An object is visited by the unit covering its first word.
+        live_bitmap->VisitMarkedRange(begin, end, visitor);
+      });
+    }
+  }
+  for (space::DiscontinuousSpace* space : discontinuous_spaces_) {
+    accounting::LargeObjectBitmap* live_bitmap = space->GetLiveBitmap();
+    for (uintptr_t begin = live_bitmap->HeapBegin(), limit = live_bitmap->HeapLimit();
+         begin < limit;
+         begin += kBitmapChunkBytes) {
+      const uintptr_t end = std::min(begin + kBitmapChunkBytes, limit);
+      work_units.push_back([=](Visitor& visitor) NO_THREAD_SAFETY_ANALYSIS {
+        live_bitmap->VisitMarkedRange(begin, end, visitor);
+      });
+    }
+  }
+  // Hold the bitmap lock on behalf of all workers for the duration of the
+  // walk, as the GC does for its parallel phases.
+  ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  Atomic<size_t> next_work_unit(0u);
+  class VisitTask : public SelfDeletingTask {
+   public:
+    VisitTask(std::vector<std::function<void(Visitor&)>>* work_units,
+              Atomic<size_t>* next_work_unit,
+              Visitor* visitor)
+        : work_units_(work_units), next_work_unit_(next_work_unit), visitor_(visitor) {}
+
+    void Run(Thread* self ATTRIBUTE_UNUSED) override {
+      for (size_t i = next_work_unit_->fetch_add(1u, std::memory_order_relaxed);
+           i < work_units_->size();
+           i = next_work_unit_->fetch_add(1u, std::memory_order_relaxed)) {
+        (*work_units_)[i](*visitor_);
+      }
+    }
+
+   private:
+    std::vector<std::function<void(Visitor&)>>* const work_units_;
+    Atomic<size_t>* const next_work_unit_;
+    Visitor* const visitor_;
+  };
+  for (size_t i = 1u; i < thread_count; ++i) {
+    thread_pool->AddTask(self, new VisitTask(&work_units, &next_work_unit, &visitors[i]));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  // Drain work units on the calling thread with the first visitor while the
+  // workers run.
+  for (size_t i = next_work_unit.fetch_add(1u, std::memory_order_relaxed);
+       i < work_units.size();
+       i = next_work_unit.fetch_add(1u, std::memory_order_relaxed)) {
+    work_units[i](visitors[0]);
   }
+  thread_pool->Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ true);
+  thread_pool->StopWorkers(self);
 }
 
 }  // namespace gc
@@ -156,6 +156,10 @@ static constexpr bool kCompactZygote = kMovingCollector;
 // How many reserve entries are at the end of the allocation stack, these are only needed if the
 // allocation stack overflows.
 static constexpr size_t kAllocationStackReserveSize = 1024;
+// How far the allocation stack may grow elastically beyond its initial growth limit before an
+// overflow forces a collection. The elastic region is reserved up front but its pages are only
+// committed if an allocation burst actually grows into it.
+static constexpr size_t kAllocationStackElasticFactor = 4;
 // Default mark stack size in bytes.
 static const size_t kDefaultMarkStackSize = 64 * KB;
 // Define space name.
@@ -276,6 +280,7 @@ Heap::Heap(size_t initial_size,
            bool verify_pre_gc_heap,
            bool verify_pre_sweeping_heap,
            bool verify_post_gc_heap,
+           bool incremental_gc_verification,
            bool verify_pre_gc_rosalloc,
            bool verify_pre_sweeping_rosalloc,
            bool verify_post_gc_rosalloc,
@@ -285,7 +290,10 @@ Heap::Heap(size_t initial_size,
            bool use_generational_cc,
            uint64_t min_interval_homogeneous_space_compaction_by_oom,
            bool dump_region_info_before_gc,
-           bool dump_region_info_after_gc)
+           bool dump_region_info_after_gc,
+           bool use_region_space_huge_pages,
+           bool use_adaptive_tlab_size,
+           bool use_numa_local_regions)
     : non_moving_space_(nullptr),
       rosalloc_space_(nullptr),
       dlmalloc_space_(nullptr),
@@ -334,11 +342,16 @@ Heap::Heap(size_t initial_size,
       native_objects_notified_(0),
       num_bytes_freed_revoke_(0),
       num_bytes_alive_after_gc_(0),
+      last_young_gc_promoted_bytes_(0),
+      defer_full_gcs_(false),
+      deferred_full_gc_pending_(false),
       verify_missing_card_marks_(false),
       verify_system_weaks_(false),
       verify_pre_gc_heap_(verify_pre_gc_heap),
       verify_pre_sweeping_heap_(verify_pre_sweeping_heap),
       verify_post_gc_heap_(verify_post_gc_heap),
+      incremental_gc_verification_(incremental_gc_verification),
+      verification_slice_index_(0),
       verify_mod_union_table_(false),
       verify_pre_gc_rosalloc_(verify_pre_gc_rosalloc),
       verify_pre_sweeping_rosalloc_(verify_pre_sweeping_rosalloc),
@@ -371,6 +384,7 @@ Heap::Heap(size_t initial_size,
       concurrent_copying_collector_(nullptr),
       is_running_on_memory_tool_(Runtime::Current()->IsRunningOnMemoryTool()),
       use_tlab_(use_tlab),
+      use_adaptive_tlab_size_(use_adaptive_tlab_size),
       main_space_backup_(nullptr),
       min_interval_homogeneous_space_compaction_by_oom_(
           min_interval_homogeneous_space_compaction_by_oom),
@@ -379,6 +393,7 @@ Heap::Heap(size_t initial_size,
       max_gc_requested_(0u),
       pending_collector_transition_(nullptr),
       pending_heap_trim_(nullptr),
+      pending_region_page_release_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       use_generational_cc_(use_generational_cc),
       running_collection_is_blocking_(false),
@@ -595,11 +610,12 @@ Heap::Heap(size_t initial_size,
   if (foreground_collector_type_ == kCollectorTypeCC) {
     CHECK(separate_non_moving_space);
     // Reserve twice the capacity, to allow evacuating every region for explicit GCs.
-    MemMap region_space_mem_map =
-        space::RegionSpace::CreateMemMap(kRegionSpaceName, capacity_ * 2, request_begin);
+    MemMap region_space_mem_map = space::RegionSpace::CreateMemMap(
+        kRegionSpaceName, capacity_ * 2, request_begin, use_region_space_huge_pages);
     CHECK(region_space_mem_map.IsValid()) << "No region space mem map";
     region_space_ = space::RegionSpace::Create(
-        kRegionSpaceName, std::move(region_space_mem_map), use_generational_cc_);
+        kRegionSpaceName, std::move(region_space_mem_map), use_generational_cc_,
+        use_numa_local_regions);
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_)) {
     // Create bump pointer spaces.
@@ -698,7 +714,8 @@ Heap::Heap(size_t initial_size,
   num_bytes_allocated_.store(0, std::memory_order_relaxed);
   mark_stack_.reset(accounting::ObjectStack::Create("mark stack", kDefaultMarkStackSize,
                                                     kDefaultMarkStackSize));
-  const size_t alloc_stack_capacity = max_allocation_stack_size_ + kAllocationStackReserveSize;
+  const size_t alloc_stack_capacity =
+      max_allocation_stack_size_ * kAllocationStackElasticFactor + kAllocationStackReserveSize;
   allocation_stack_.reset(accounting::ObjectStack::Create(
       "allocation stack", max_allocation_stack_size_, alloc_stack_capacity));
   live_stack_.reset(accounting::ObjectStack::Create(
@@ -1066,7 +1083,13 @@ void Heap::UpdateProcessState(ProcessState old_process_state, ProcessState new_p
 void Heap::CreateThreadPool() {
   const size_t num_threads = std::max(parallel_gc_threads_, conc_gc_threads_);
   if (num_threads != 0) {
-    thread_pool_.reset(new ThreadPool("Heap thread pool", num_threads));
+    // Use work-stealing deques: parallel marking spawns many small tasks from the
+    // workers themselves, which would otherwise contend on the central task queue lock.
+    thread_pool_.reset(new ThreadPool("Heap thread pool",
+                                      num_threads,
+                                      /*create_peers=*/ false,
+                                      ThreadPoolWorker::kDefaultStackSize,
+                                      /*use_work_stealing=*/ true));
   }
 }
 
@@ -1251,6 +1274,14 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
     rosalloc_space_->DumpStats(os);
   }
 
+  if (rosalloc_space_ != nullptr) {
+    allocator::RosAlloc::FragmentationStats stats;
+    rosalloc_space_->GetFragmentationStats(&stats);
+    os << "RosAlloc run fragmentation: footprint " << PrettySize(stats.run_footprint_bytes)
+       << " live " << PrettySize(stats.run_live_bytes)
+       << " sparse runs: " << stats.num_sparse_runs << "\n";
+  }
+
   os << "Native bytes total: " << GetNativeBytes()
      << " registered: " << native_bytes_registered_.load(std::memory_order_relaxed) << "\n";
 
@@ -1289,6 +1320,46 @@ void Heap::ResetGcPerformanceInfo() {
   }
 }
 
+void Heap::GetGcPerformanceSnapshot(GcPerformanceSnapshot* snapshot) {
+  *snapshot = GcPerformanceSnapshot();  // Zero-initialize all fields.
+  snapshot->gc_count = GetGcCount();
+  snapshot->gc_time_ns = GetGcTime();
+  snapshot->gc_cpu_time_ns = GetTotalGcCpuTime();
+  snapshot->blocking_gc_count = GetBlockingGcCount();
+  snapshot->blocking_gc_time_ns = GetBlockingGcTime();
+  snapshot->time_waiting_for_gc_ns = total_wait_time_;
+  for (auto* collector : garbage_collectors_) {
+    uint64_t sum_ns;
+    uint64_t count;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    collector->GetPauseHistogramStats(&sum_ns, &count, &min_ns, &max_ns);
+    if (count != 0) {
+      snapshot->pause_time_min_ns = (snapshot->pause_count == 0)
+          ? min_ns
+          : std::min(snapshot->pause_time_min_ns, min_ns);
+      snapshot->pause_time_max_ns = std::max(snapshot->pause_time_max_ns, max_ns);
+      snapshot->pause_count += count;
+      snapshot->pause_time_sum_ns += sum_ns;
+    }
+  }
+  snapshot->bytes_allocated_ever = GetBytesAllocatedEver();
+  snapshot->objects_allocated_ever = GetObjectsAllocatedEver();
+  snapshot->bytes_freed_ever = GetBytesFreedEver();
+  snapshot->objects_freed_ever = GetObjectsFreedEver();
+  snapshot->bytes_allocated = GetBytesAllocated();
+  snapshot->total_memory = GetTotalMemory();
+  snapshot->max_memory = GetMaxMemory();
+  if (concurrent_copying_collector_ != nullptr) {
+    snapshot->cc_bytes_moved += concurrent_copying_collector_->GetCumulativeBytesMoved();
+    snapshot->cc_objects_moved += concurrent_copying_collector_->GetCumulativeObjectsMoved();
+  }
+  if (young_concurrent_copying_collector_ != nullptr) {
+    snapshot->cc_bytes_moved += young_concurrent_copying_collector_->GetCumulativeBytesMoved();
+    snapshot->cc_objects_moved += young_concurrent_copying_collector_->GetCumulativeObjectsMoved();
+  }
+}
+
 uint64_t Heap::GetGcCount() const {
   uint64_t gc_count = 0U;
   for (auto* collector : garbage_collectors_) {
@@ -1512,6 +1583,24 @@ void Heap::Trim(Thread* self) {
   TrimSpaces(self);
   // Trim arenas that may have been used by JIT or verifier.
   runtime->GetArenaPool()->TrimMaps();
+  // Trimming cannot reclaim the pages of partially used runs; when run fragmentation leaves
+  // enough of the rosalloc footprint dead, a homogeneous space compaction is worth its pause.
+  if (rosalloc_space_ != nullptr &&
+      rosalloc_space_ == main_space_ &&
+      !CareAboutPauseTimes() &&
+      SupportHomogeneousSpaceCompactAndCollectorTransitions()) {
+    allocator::RosAlloc::FragmentationStats stats;
+    rosalloc_space_->GetFragmentationStats(&stats);
+    const size_t wasted_bytes =
+        UnsignedDifference(stats.run_footprint_bytes, stats.run_live_bytes);
+    if (wasted_bytes >= kMinWastedBytesForHomogeneousSpaceCompact &&
+        stats.run_live_bytes * 4 < stats.run_footprint_bytes * 3) {
+      VLOG(heap) << "RosAlloc run fragmentation: " << PrettySize(wasted_bytes) << " wasted of "
+                 << PrettySize(stats.run_footprint_bytes)
+                 << "; requesting homogeneous space compaction";
+      RequestCollectorTransition(kCollectorTypeHomogeneousSpaceCompact, 0);
+    }
+  }
 }
 
 class TrimIndirectReferenceTableClosure : public Closure {
@@ -2211,7 +2300,11 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
       : SemiSpace(heap, "zygote collector"),
         bin_live_bitmap_(nullptr),
         bin_mark_bitmap_(nullptr),
-        is_running_on_memory_tool_(is_running_on_memory_tool) {}
+        is_running_on_memory_tool_(is_running_on_memory_tool) {
+    // The parallel copy phase does not go through the MarkNonForwardedObject() override and the
+    // bins are not thread-safe.
+    support_parallel_copy_ = false;
+  }
 
   void BuildBins(space::ContinuousSpace* space) REQUIRES_SHARED(Locks::mutator_lock_) {
     bin_live_bitmap_ = space->GetLiveBitmap();
@@ -2715,12 +2808,21 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
   collector->Run(gc_cause, clear_soft_references || runtime->IsZygote());
   IncrementFreedEver();
   RequestTrim(self);
+  RequestRetainedRegionPageRelease(self);
   // Collect cleared references.
   SelfDeletingTask* clear = reference_processor_->CollectClearedReferences(self);
   // Grow the heap so that we know when to perform the next GC.
   GrowForUtilization(collector, bytes_allocated_before_gc);
   old_native_bytes_allocated_.store(GetNativeBytes());
+  const size_t old_num_bytes_alive = num_bytes_alive_after_gc_;
   num_bytes_alive_after_gc_ = bytes_allocated_before_gc - current_gc_iteration_.GetFreedBytes();
+  if (gc_type == collector::kGcTypeSticky) {
+    // The growth of live data across a young collection approximates the bytes it promoted to
+    // the old generation.
+    last_young_gc_promoted_bytes_.store(
+        UnsignedDifference(num_bytes_alive_after_gc_, old_num_bytes_alive),
+        std::memory_order_relaxed);
+  }
   LogGC(gc_cause, collector);
   FinishGC(self, gc_type);
   // Actually enqueue all cleared references. Do this after the GC has officially finished since
@@ -2865,6 +2967,15 @@ class ScanVisitor {
 };
 
 // Verify a reference from an object.
+// Number of address slices used by incremental heap verification (see
+// Heap::VerifyHeapReferences). Each verification pass checks one slice, so a
+// full sweep of the heap completes every kVerificationSlices passes.
+static constexpr size_t kVerificationSlices = 8;
+// Address-chunk granularity used to assign objects to verification slices.
+// Chunk-sized runs keep each pass cache- and card-local instead of striping
+// individual objects across slices.
+static constexpr size_t kVerificationChunkBytes = 128 * KB;
+
 class VerifyReferenceVisitor : public SingleRootVisitor {
  public:
   VerifyReferenceVisitor(Thread* self, Heap* heap, size_t* fail_count, bool verify_referent)
@@ -3020,10 +3131,26 @@ class VerifyReferenceVisitor : public SingleRootVisitor {
 // Verify all references within an object, for use with HeapBitmap::Visit.
 class VerifyObjectVisitor {
  public:
-  VerifyObjectVisitor(Thread* self, Heap* heap, size_t* fail_count, bool verify_referent)
-      : self_(self), heap_(heap), fail_count_(fail_count), verify_referent_(verify_referent) {}
+  VerifyObjectVisitor(Thread* self,
+                      Heap* heap,
+                      size_t* fail_count,
+                      bool verify_referent,
+                      bool incremental = false,
+                      size_t slice_index = 0u)
+      : self_(self),
+        heap_(heap),
+        fail_count_(fail_count),
+        verify_referent_(verify_referent),
+        incremental_(incremental),
+        slice_index_(slice_index) {}
 
   void operator()(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (incremental_ &&
+        ((reinterpret_cast<uintptr_t>(obj) / kVerificationChunkBytes) % kVerificationSlices) !=
+            slice_index_) {
+      // Not part of the slice verified by this pass; a later pass covers it.
+      return;
+    }
     // Note: we are verifying the references in obj but not obj itself, this is because obj must
     // be live or else how did we find it in the live bitmap?
     VerifyReferenceVisitor visitor(self_, heap_, fail_count_, verify_referent_);
@@ -3047,12 +3174,19 @@ class VerifyObjectVisitor {
   Heap* const heap_;
   size_t* const fail_count_;
   const bool verify_referent_;
+  const bool incremental_;
+  const size_t slice_index_;
 };
 
 void Heap::PushOnAllocationStackWithInternalGC(Thread* self, ObjPtr<mirror::Object>* obj) {
   // Slow path, the allocation stack push back must have already failed.
   DCHECK(!allocation_stack_->AtomicPushBack(obj->Ptr()));
   do {
+    // Grow the allocation stack elastically before resorting to a collection, so that allocation
+    // bursts do not force GCs at arbitrary points.
+    if (allocation_stack_->Grow(max_allocation_stack_size_ * kAllocationStackElasticFactor)) {
+      continue;
+    }
     // TODO: Add handle VerifyObject.
     StackHandleScope<1> hs(self);
     HandleWrapperObjPtr<mirror::Object> wrapper(hs.NewHandleWrapper(obj));
@@ -3075,6 +3209,10 @@ void Heap::PushOnThreadLocalAllocationStackWithInternalGC(Thread* self,
   StackReference<mirror::Object>* end_address;
   while (!allocation_stack_->AtomicBumpBack(kThreadLocalAllocationStackSize, &start_address,
                                             &end_address)) {
+    // Grow the allocation stack elastically before resorting to a collection, as above.
+    if (allocation_stack_->Grow(max_allocation_stack_size_ * kAllocationStackElasticFactor)) {
+      continue;
+    }
     // TODO: Add handle VerifyObject.
     StackHandleScope<1> hs(self);
     HandleWrapperObjPtr<mirror::Object> wrapper(hs.NewHandleWrapper(obj));
@@ -3104,7 +3242,16 @@ size_t Heap::VerifyHeapReferences(bool verify_referents) {
   // thread-local allocation stacks.
   RevokeAllThreadLocalAllocationStacks(self);
   size_t fail_count = 0;
-  VerifyObjectVisitor visitor(self, this, &fail_count, verify_referents);
+  // In incremental mode only the current address slice is verified; the slice
+  // rotates every pass so a full sweep of the heap completes every
+  // kVerificationSlices passes at roughly 1/kVerificationSlices of the cost
+  // per pass. Roots are always verified since they are cheap by comparison.
+  const size_t slice_index = verification_slice_index_;
+  if (incremental_gc_verification_) {
+    verification_slice_index_ = (verification_slice_index_ + 1u) % kVerificationSlices;
+  }
+  VerifyObjectVisitor visitor(
+      self, this, &fail_count, verify_referents, incremental_gc_verification_, slice_index);
   // Verify objects in the allocation stack since these will be objects which were:
   // 1. Allocated prior to the GC (pre GC verification).
   // 2. Allocated during the GC (pre sweep GC verification).
@@ -3518,6 +3665,31 @@ void Heap::DumpForSigQuit(std::ostream& os) {
   os << "Heap: " << GetPercentFree() << "% free, " << PrettySize(GetBytesAllocated()) << "/"
      << PrettySize(GetTotalMemory()) << "; " << GetObjectsAllocated() << " objects\n";
   DumpGcPerformanceInfo(os);
+  // Single machine-parsable line so fleet tooling can scrape bugreports without parsing the
+  // human-readable dump above.
+  GcPerformanceSnapshot snapshot;
+  GetGcPerformanceSnapshot(&snapshot);
+  os << "GC perf snapshot:"
+     << " gc_count=" << snapshot.gc_count
+     << " gc_time_ns=" << snapshot.gc_time_ns
+     << " gc_cpu_time_ns=" << snapshot.gc_cpu_time_ns
+     << " blocking_gc_count=" << snapshot.blocking_gc_count
+     << " blocking_gc_time_ns=" << snapshot.blocking_gc_time_ns
+     << " time_waiting_for_gc_ns=" << snapshot.time_waiting_for_gc_ns
+     << " pause_count=" << snapshot.pause_count
+     << " pause_time_sum_ns=" << snapshot.pause_time_sum_ns
+     << " pause_time_min_ns=" << snapshot.pause_time_min_ns
+     << " pause_time_max_ns=" << snapshot.pause_time_max_ns
+     << " bytes_allocated_ever=" << snapshot.bytes_allocated_ever
+     << " objects_allocated_ever=" << snapshot.objects_allocated_ever
+     << " bytes_freed_ever=" << snapshot.bytes_freed_ever
+     << " objects_freed_ever=" << snapshot.objects_freed_ever
+     << " bytes_allocated=" << snapshot.bytes_allocated
+     << " total_memory=" << snapshot.total_memory
+     << " max_memory=" << snapshot.max_memory
+     << " cc_bytes_moved=" << snapshot.cc_bytes_moved
+     << " cc_objects_moved=" << snapshot.cc_objects_moved
+     << "\n";
 }
 
 size_t Heap::GetPercentFree() {
@@ -3782,6 +3954,37 @@ bool Heap::RequestConcurrentGC(Thread* self,
   return true;  // Vacuously.
 }
 
+bool Heap::RequestYoungGC(Thread* self, size_t promotion_byte_budget) {
+  if (gc_plan_.empty() || gc_plan_.front() != collector::kGcTypeSticky) {
+    // This configuration has no young collections.
+    return false;
+  }
+  bool force_full = false;
+  if (promotion_byte_budget != 0u &&
+      last_young_gc_promoted_bytes_.load(std::memory_order_relaxed) > promotion_byte_budget) {
+    // The last young collection promoted more than the caller is willing to pay for; further
+    // young collections would keep growing the old generation, so upgrade to a full collection.
+    force_full = true;
+  } else {
+    // ConcurrentGC runs next_gc_type_ unless forced full; steer the requested collection to be
+    // young. Racy against GrowForUtilization like all other next_gc_type_ accesses.
+    next_gc_type_ = collector::kGcTypeSticky;
+  }
+  return RequestConcurrentGC(self, kGcCauseBackground, force_full, GetCurrentGcNum());
+}
+
+void Heap::NotifyIdleWindowEnd() {
+  defer_full_gcs_.store(true, std::memory_order_relaxed);
+}
+
+void Heap::NotifyIdleWindowBegin(Thread* self) {
+  defer_full_gcs_.store(false, std::memory_order_relaxed);
+  if (deferred_full_gc_pending_.exchange(false, std::memory_order_relaxed)) {
+    // Run the full collection we skipped during the traffic peak now that the process is idle.
+    RequestConcurrentGC(self, kGcCauseBackground, /*force_full=*/ true, GetCurrentGcNum());
+  }
+}
+
 void Heap::ConcurrentGC(Thread* self, GcCause cause, bool force_full, uint32_t requested_gc_num) {
   if (!Runtime::Current()->IsShuttingDown(self)) {
     // Wait for any GCs currently running to finish. If this incremented GC number, we're done.
@@ -3791,6 +3994,16 @@ void Heap::ConcurrentGC(Thread* self, GcCause cause, bool force_full, uint32_t r
       // If forcing full and next gc type is sticky, override with a non-sticky type.
       if (force_full && next_gc_type == collector::kGcTypeSticky) {
         next_gc_type = NonStickyGcType();
+      } else if (defer_full_gcs_.load(std::memory_order_relaxed) &&
+                 cause == kGcCauseBackground &&
+                 next_gc_type != collector::kGcTypeSticky &&
+                 !gc_plan_.empty() &&
+                 gc_plan_.front() == collector::kGcTypeSticky) {
+        // Inside a traffic peak (see NotifyIdleWindowEnd): try a young collection instead and
+        // leave the full collection for the next idle window. Best effort only; if the young
+        // collection cannot reclaim anything, the fallback loop below still runs a larger one.
+        deferred_full_gc_pending_.store(true, std::memory_order_relaxed);
+        next_gc_type = collector::kGcTypeSticky;
       }
       // If we can't run the GC type we wanted to run, find the next appropriate one and try
       // that instead. E.g. can't do partial, so do full instead.
@@ -3879,6 +4092,45 @@ class Heap::HeapTrimTask : public HeapTask {
   }
 };
 
+class Heap::ReleaseRegionPagesTask : public HeapTask {
+ public:
+  explicit ReleaseRegionPagesTask(uint64_t delta_time) : HeapTask(NanoTime() + delta_time) { }
+  void Run(Thread* self) override {
+    gc::Heap* heap = Runtime::Current()->GetHeap();
+    heap->ClearPendingRetainedRegionPageRelease(self);
+    space::RegionSpace* region_space = heap->GetRegionSpace();
+    if (region_space != nullptr &&
+        region_space->ReleaseRetainedClearedPages(kRetainedRegionPageReleaseQuantum) ==
+            kRetainedRegionPageReleaseQuantum) {
+      // More regions may be pending; release them in a later quantum so allocators and
+      // back-to-back GCs get a chance to reuse the still-mapped pages first.
+      heap->RequestRetainedRegionPageRelease(self);
+    }
+  }
+};
+
+void Heap::ClearPendingRetainedRegionPageRelease(Thread* self) {
+  MutexLock mu(self, *pending_task_lock_);
+  pending_region_page_release_ = nullptr;
+}
+
+void Heap::RequestRetainedRegionPageRelease(Thread* self) {
+  if (region_space_ == nullptr || !CanAddHeapTask(self)) {
+    return;
+  }
+  ReleaseRegionPagesTask* added_task = nullptr;
+  {
+    MutexLock mu(self, *pending_task_lock_);
+    if (pending_region_page_release_ != nullptr) {
+      // A release task is already queued; it reschedules itself while work remains.
+      return;
+    }
+    added_task = new ReleaseRegionPagesTask(kRetainedRegionPageReleaseWait);
+    pending_region_page_release_ = added_task;
+  }
+  task_processor_->AddTask(self, added_task);
+}
+
 void Heap::ClearPendingTrim(Thread* self) {
   MutexLock mu(self, *pending_task_lock_);
   pending_heap_trim_ = nullptr;
@@ -4052,28 +4304,61 @@ void Heap::NotifyNativeAllocations(JNIEnv* env) {
 void Heap::RegisterNativeAllocation(JNIEnv* env, size_t bytes) {
   // Cautiously check for a wrapped negative bytes argument.
   DCHECK(sizeof(size_t) < 8 || bytes < (std::numeric_limits<size_t>::max() / 2));
-  native_bytes_registered_.fetch_add(bytes, std::memory_order_relaxed);
-  uint32_t objects_notified =
-      native_objects_notified_.fetch_add(1, std::memory_order_relaxed);
-  if (objects_notified % kNotifyNativeInterval == kNotifyNativeInterval - 1
-      || bytes > kCheckImmediatelyThreshold) {
-    CheckGCForNative(ThreadForEnv(env));
+  Thread* self = ThreadForEnv(env);
+  // Accumulate into thread-local counters and only flush into the shared atomics once a
+  // threshold builds up, mirroring the thread-local object counts for Java allocations. The
+  // global counter may thus lag by up to kCheckImmediatelyThreshold bytes per thread; the
+  // pending bytes are flushed on thread detach.
+  const size_t pending_bytes = self->GetPendingNativeBytesRegistered() + bytes;
+  const size_t pending_objects = self->GetPendingNativeObjectsNotified() + 1;
+  if (pending_objects < kNotifyNativeInterval && pending_bytes <= kCheckImmediatelyThreshold) {
+    self->SetPendingNativeBytesRegistered(pending_bytes);
+    self->SetPendingNativeObjectsNotified(pending_objects);
+    return;
+  }
+  self->SetPendingNativeBytesRegistered(0);
+  self->SetPendingNativeObjectsNotified(0);
+  native_bytes_registered_.fetch_add(pending_bytes, std::memory_order_relaxed);
+  native_objects_notified_.fetch_add(pending_objects, std::memory_order_relaxed);
+  CheckGCForNative(self);
+}
+
+void Heap::RegisterNativeFree(JNIEnv* env, size_t bytes) {
+  // First cancel against this thread's unflushed registrations, which keeps the alloc/free
+  // churn of short-lived native buffers entirely thread-local.
+  Thread* self = ThreadForEnv(env);
+  const size_t pending_bytes = self->GetPendingNativeBytesRegistered();
+  const size_t cancelled_bytes = std::min(pending_bytes, bytes);
+  self->SetPendingNativeBytesRegistered(pending_bytes - cancelled_bytes);
+  bytes -= cancelled_bytes;
+  if (bytes == 0) {
+    return;
   }
-}
-
-void Heap::RegisterNativeFree(JNIEnv*, size_t bytes) {
   size_t allocated;
   size_t new_freed_bytes;
   do {
     allocated = native_bytes_registered_.load(std::memory_order_relaxed);
+    // We should not be registering more free than allocated bytes, but other threads'
+    // registrations may still be buffered thread-locally, so keep the counter clamped at zero
+    // rather than asserting.
     new_freed_bytes = std::min(allocated, bytes);
-    // We should not be registering more free than allocated bytes.
-    // But correctly keep going in non-debug builds.
-    DCHECK_EQ(new_freed_bytes, bytes);
   } while (!native_bytes_registered_.CompareAndSetWeakRelaxed(allocated,
                                                               allocated - new_freed_bytes));
 }
 
+void Heap::FlushNativeAllocationAccounting(Thread* self) {
+  const size_t pending_bytes = self->GetPendingNativeBytesRegistered();
+  const size_t pending_objects = self->GetPendingNativeObjectsNotified();
+  if (pending_bytes != 0) {
+    self->SetPendingNativeBytesRegistered(0);
+    native_bytes_registered_.fetch_add(pending_bytes, std::memory_order_relaxed);
+  }
+  if (pending_objects != 0) {
+    self->SetPendingNativeObjectsNotified(0);
+    native_objects_notified_.fetch_add(pending_objects, std::memory_order_relaxed);
+  }
+}
+
 size_t Heap::GetTotalMemory() const {
   return std::max(target_footprint_.load(std::memory_order_relaxed), GetBytesAllocated());
 }
@@ -4336,6 +4621,32 @@ void Heap::RemoveGcPauseListener() {
   gc_pause_listener_.store(nullptr, std::memory_order_relaxed);
 }
 
+size_t Heap::AdaptiveTlabSize(Thread* self, size_t default_tlab_size, size_t max_tlab_size) {
+  if (!use_adaptive_tlab_size_) {
+    return default_tlab_size;
+  }
+  const size_t gc_num = GetCurrentGcNum();
+  const size_t idle_gcs = gc_num - self->GetTlabLastRefillGcNum();
+  size_t desired = self->GetTlabDesiredSize();
+  if (desired == 0u) {
+    // First refill for this thread; start small and let the feedback loop grow the TLAB.
+    desired = kAdaptiveTlabInitialSize;
+  } else if (idle_gcs == 0u) {
+    // Refilling again within the same GC cycle: the thread is allocating faster than the
+    // current TLAB size can absorb, so grow exponentially.
+    desired = std::min(desired * 2, max_tlab_size);
+  } else {
+    // GC cycles passed without a refill: the thread has slowed down, so shrink by one halving
+    // per idle cycle (capped) to return memory headroom to the heap.
+    desired = std::max(desired >> std::min(idle_gcs, static_cast<size_t>(4)),
+                       kAdaptiveTlabMinSize);
+  }
+  desired = std::min(desired, max_tlab_size);
+  self->SetTlabDesiredSize(desired);
+  self->SetTlabLastRefillGcNum(gc_num);
+  return desired;
+}
+
 mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                        AllocatorType allocator_type,
                                        size_t alloc_size,
@@ -4369,7 +4680,9 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
   } else if (allocator_type == kAllocatorTypeTLAB) {
     DCHECK(bump_pointer_space_ != nullptr);
     size_t next_tlab_size = JHPCalculateNextTlabSize(self,
-                                                     kDefaultTLABSize,
+                                                     AdaptiveTlabSize(self,
+                                                                      kDefaultTLABSize,
+                                                                      kAdaptiveTlabMaxSize),
                                                      alloc_size,
                                                      &take_sample,
                                                      &bytes_until_sample);
@@ -4397,14 +4710,16 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
         size_t def_pr_tlab_size = kUsePartialTlabs
                                       ? kPartialTlabSize
                                       : gc::space::RegionSpace::kRegionSize;
+        def_pr_tlab_size =
+            AdaptiveTlabSize(self, def_pr_tlab_size, space::RegionSpace::kRegionSize);
         size_t next_pr_tlab_size = JHPCalculateNextTlabSize(self,
                                                             def_pr_tlab_size,
                                                             alloc_size,
                                                             &take_sample,
                                                             &bytes_until_sample);
-        const size_t new_tlab_size = kUsePartialTlabs
-            ? std::max(alloc_size, next_pr_tlab_size)
-            : next_pr_tlab_size;
+        // With adaptive sizing the desired size may be smaller than alloc_size, so always make
+        // room for the triggering allocation.
+        const size_t new_tlab_size = std::max(alloc_size, next_pr_tlab_size);
         // Try to allocate a tlab.
         if (!region_space_->AllocNewTlab(self, new_tlab_size, bytes_tl_bulk_allocated)) {
           // Failed to allocate a tlab. Try non-tlab.
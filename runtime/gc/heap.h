@@ -53,6 +53,7 @@ class IsMarkedVisitor;
 class Mutex;
 class ReflectiveValueVisitor;
 class RootVisitor;
+template <typename MirrorType> class StackReference;
 class StackVisitor;
 class Thread;
 class ThreadPool;
@@ -142,6 +143,10 @@ class Heap {
   static constexpr size_t kDefaultLongPauseLogThreshold = MsToNs(5);
   static constexpr size_t kDefaultLongGCLogThreshold = MsToNs(100);
   static constexpr size_t kDefaultTLABSize = 32 * KB;
+  // Bounds for the adaptive TLAB sizing policy, see AdaptiveTlabSize.
+  static constexpr size_t kAdaptiveTlabInitialSize = 8 * KB;
+  static constexpr size_t kAdaptiveTlabMinSize = 4 * KB;
+  static constexpr size_t kAdaptiveTlabMaxSize = 256 * KB;
   static constexpr double kDefaultTargetUtilization = 0.75;
   static constexpr double kDefaultHeapGrowthMultiplier = 2.0;
   // Primitive arrays larger than this size are put in the large object space.
@@ -179,6 +184,15 @@ class Heap {
 
   // How often we allow heap trimming to happen (nanoseconds).
   static constexpr uint64_t kHeapTrimWait = MsToNs(5000);
+  // How long after a GC completes the first quantum of retained region space pages is
+  // released, and the spacing between subsequent quanta (nanoseconds). See
+  // RequestRetainedRegionPageRelease.
+  static constexpr uint64_t kRetainedRegionPageReleaseWait = MsToNs(100);
+  // Number of retained region space regions whose pages are released per quantum.
+  static constexpr size_t kRetainedRegionPageReleaseQuantum = 8;
+  // Minimum number of bytes wasted by rosalloc run fragmentation before Trim considers a
+  // homogeneous space compaction worthwhile, in addition to a utilization threshold.
+  static constexpr size_t kMinWastedBytesForHomogeneousSpaceCompact = 8 * MB;
   // How long we wait after a transition request to perform a collector transition (nanoseconds).
   static constexpr uint64_t kCollectorTransitionWait = MsToNs(5000);
   // Whether the transition-wait applies or not. Zero wait will stress the
@@ -216,6 +230,7 @@ class Heap {
        bool verify_pre_gc_heap,
        bool verify_pre_sweeping_heap,
        bool verify_post_gc_heap,
+       bool incremental_gc_verification,
        bool verify_pre_gc_rosalloc,
        bool verify_pre_sweeping_rosalloc,
        bool verify_post_gc_rosalloc,
@@ -225,7 +240,10 @@ class Heap {
        bool use_generational_cc,
        uint64_t min_interval_homogeneous_space_compaction_by_oom,
        bool dump_region_info_before_gc,
-       bool dump_region_info_after_gc);
+       bool dump_region_info_after_gc,
+       bool use_region_space_huge_pages = false,
+       bool use_adaptive_tlab_size = false,
+       bool use_numa_local_regions = false);
 
   ~Heap();
 
@@ -304,6 +322,18 @@ class Heap {
   ALWAYS_INLINE void VisitObjectsPaused(Visitor&& visitor)
       REQUIRES(Locks::mutator_lock_, !Locks::heap_bitmap_lock_, !*gc_complete_lock_);
 
+  // Parallel variant of VisitObjects(). Suspends the mutators, partitions the
+  // heap (region space regions, the allocation stack and space bitmap address
+  // ranges) into work units and drains them on the GC thread pool, with each
+  // work unit running against the visitor instance of the worker that claimed
+  // it. Every object is visited by exactly one of the `visitors`; the caller
+  // merges the per-visitor results afterwards. Falls back to a walk of the
+  // whole heap with `visitors[0]` when the thread pool is unavailable.
+  template <typename Visitor>
+  ALWAYS_INLINE void VisitObjectsParallel(Visitor* visitors, size_t num_visitors)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::heap_bitmap_lock_, !*gc_complete_lock_);
+
   void VisitReflectiveTargets(ReflectiveValueVisitor* visitor)
       REQUIRES(Locks::mutator_lock_, !Locks::heap_bitmap_lock_, !*gc_complete_lock_);
 
@@ -316,6 +346,10 @@ class Heap {
       REQUIRES(!*gc_complete_lock_, !*pending_task_lock_, !process_state_update_lock_);
   void RegisterNativeFree(JNIEnv* env, size_t bytes);
 
+  // Flush native allocation accounting still buffered in the given thread into the global
+  // counters. Called on thread detach; see RegisterNativeAllocation.
+  void FlushNativeAllocationAccounting(Thread* self);
+
   // Notify the garbage collector of malloc allocations that might be reclaimable
   // as a result of Java garbage collection. Each such call represents approximately
   // kNotifyNativeInterval such allocations.
@@ -633,7 +667,7 @@ class Heap {
       REQUIRES(!*gc_complete_lock_, !*pending_task_lock_, !process_state_update_lock_);
 
   // Deflate monitors, ... and trim the spaces.
-  void Trim(Thread* self) REQUIRES(!*gc_complete_lock_);
+  void Trim(Thread* self) REQUIRES(!*gc_complete_lock_, !*pending_task_lock_);
 
   void RevokeThreadLocalBuffers(Thread* thread);
   void RevokeRosAllocThreadLocalBuffers(Thread* thread);
@@ -754,6 +788,39 @@ class Heap {
       REQUIRES(!*gc_complete_lock_);
   void ResetGcPerformanceInfo() REQUIRES(!*gc_complete_lock_);
 
+  // Machine-readable snapshot of the cumulative GC performance counters. Plain data so callers
+  // can ship the fields to a metrics pipeline without parsing the human-readable dump.
+  struct GcPerformanceSnapshot {
+    // Aggregated over all garbage collectors.
+    uint64_t gc_count;
+    uint64_t gc_time_ns;
+    uint64_t gc_cpu_time_ns;
+    uint64_t blocking_gc_count;
+    uint64_t blocking_gc_time_ns;
+    uint64_t time_waiting_for_gc_ns;
+    // Pause histogram aggregated over all collectors.
+    uint64_t pause_count;
+    uint64_t pause_time_sum_ns;
+    uint64_t pause_time_min_ns;
+    uint64_t pause_time_max_ns;
+    // Allocation and free counters.
+    uint64_t bytes_allocated_ever;
+    uint64_t objects_allocated_ever;
+    uint64_t bytes_freed_ever;
+    uint64_t objects_freed_ever;
+    uint64_t bytes_allocated;
+    uint64_t total_memory;
+    uint64_t max_memory;
+    // ConcurrentCopying copy statistics; zero when the CC collector is not in use.
+    uint64_t cc_bytes_moved;
+    uint64_t cc_objects_moved;
+  };
+
+  // Fills *snapshot from the cumulative counters without stopping the world. The counters are
+  // read individually, so fields may be mutually skewed by concurrent GC activity, which is
+  // acceptable for trend monitoring. Does not reset any statistics.
+  void GetGcPerformanceSnapshot(GcPerformanceSnapshot* snapshot) REQUIRES(!*gc_complete_lock_);
+
   // Thread pool.
   void CreateThreadPool();
   void DeleteThreadPool();
@@ -827,6 +894,12 @@ class Heap {
   // Request an asynchronous trim.
   void RequestTrim(Thread* self) REQUIRES(!*pending_task_lock_);
 
+  // Request paced background release of the region space pages that ClearFromSpace kept mapped
+  // for reuse. The task releases a small quantum of regions per run and reschedules itself
+  // while retained regions remain, so pages that back-to-back GCs would re-fault stay warm for
+  // a short while after each collection.
+  void RequestRetainedRegionPageRelease(Thread* self) REQUIRES(!*pending_task_lock_);
+
   // Retrieve the current GC number, i.e. the number n such that we completed n GCs so far.
   // Provides acquire ordering, so that if we read this first, and then check whether a GC is
   // required, we know that the GC number read actually preceded the test.
@@ -842,6 +915,28 @@ class Heap {
   bool RequestConcurrentGC(Thread* self, GcCause cause, bool force_full, uint32_t observed_gc_num)
       REQUIRES(!*pending_task_lock_);
 
+  // Explicit generational tuning hooks for latency-critical callers.
+  //
+  // Request a concurrent young-only (sticky) collection. If `promotion_byte_budget` is non-zero
+  // and the previous young collection promoted more than this many bytes into the old
+  // generation, the request is upgraded to a full collection since further young collections
+  // would keep growing the old generation. Returns false if this configuration has no young
+  // collections or the request could not be queued.
+  bool RequestYoungGC(Thread* self, size_t promotion_byte_budget)
+      REQUIRES(!*pending_task_lock_);
+
+  // Bytes promoted to the old generation by the last young collection.
+  size_t GetLastYoungGcPromotedBytes() const {
+    return last_young_gc_promoted_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Demarcate idle windows. Between NotifyIdleWindowEnd and the next NotifyIdleWindowBegin,
+  // background full collections are downgraded to young collections where possible; the
+  // deferred full collection is requested when the idle window opens. Called explicitly by
+  // embedders, in the same spirit as NotifyNativeAllocations.
+  void NotifyIdleWindowBegin(Thread* self) REQUIRES(!*pending_task_lock_);
+  void NotifyIdleWindowEnd();
+
   // Whether or not we may use a garbage collector, used so that we only create collectors we need.
   bool MayUseCollector(CollectorType type) const;
 
@@ -966,6 +1061,7 @@ class Heap {
   class ConcurrentGCTask;
   class CollectorTransitionTask;
   class HeapTrimTask;
+  class ReleaseRegionPagesTask;
   class TriggerPostForkCCGcTask;
   class ReduceTargetFootprintTask;
 
@@ -1095,6 +1191,12 @@ class Heap {
                                    size_t* bytes_tl_bulk_allocated)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns the TLAB refill size for `self`. If the adaptive TLAB sizing policy is disabled this
+  // is simply `default_tlab_size`. Otherwise the per-thread desired size is grown exponentially
+  // when the thread refills more than once within a single GC cycle and shrunk when GC cycles
+  // pass without a refill, clamped to [kAdaptiveTlabMinSize, max_tlab_size].
+  size_t AdaptiveTlabSize(Thread* self, size_t default_tlab_size, size_t max_tlab_size);
+
   void ThrowOutOfMemoryError(Thread* self, size_t byte_count, AllocatorType allocator_type)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -1208,6 +1310,7 @@ class Heap {
 
   void ClearPendingTrim(Thread* self) REQUIRES(!*pending_task_lock_);
   void ClearPendingCollectorTransition(Thread* self) REQUIRES(!*pending_task_lock_);
+  void ClearPendingRetainedRegionPageRelease(Thread* self) REQUIRES(!*pending_task_lock_);
 
   // What kind of concurrency behavior is the runtime after? Currently true for concurrent mark
   // sweep GC, false for other GC types.
@@ -1230,6 +1333,18 @@ class Heap {
   template <typename Visitor>
   ALWAYS_INLINE void VisitObjectsInternalRegionSpace(Visitor&& visitor)
       REQUIRES(Locks::mutator_lock_, !Locks::heap_bitmap_lock_, !*gc_complete_lock_);
+  template <typename Visitor>
+  ALWAYS_INLINE void VisitObjectsParallelInternal(Thread* self,
+                                                  Visitor* visitors,
+                                                  size_t num_visitors)
+      REQUIRES(Locks::mutator_lock_, !Locks::heap_bitmap_lock_);
+  // Visit the objects in the allocation stack range `[begin, end)`, skipping
+  // entries racing with an ongoing allocation.
+  template <typename Visitor>
+  ALWAYS_INLINE void VisitAllocationStackRange(StackReference<mirror::Object>* begin,
+                                               StackReference<mirror::Object>* end,
+                                               Visitor&& visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   void UpdateGcCountRateHistograms() REQUIRES(gc_complete_lock_);
 
@@ -1472,6 +1587,18 @@ class Heap {
   // how many bytes have been allocated since the last GC
   size_t num_bytes_alive_after_gc_;
 
+  // Growth of live data across the last sticky (young) collection, which approximates the bytes
+  // promoted to the old generation by it. Used by RequestYoungGC promotion budgets.
+  Atomic<size_t> last_young_gc_promoted_bytes_;
+
+  // When true (between NotifyIdleWindowEnd and NotifyIdleWindowBegin), background full
+  // collections are downgraded to young collections where possible.
+  Atomic<bool> defer_full_gcs_;
+
+  // Set when a full collection was downgraded while deferring; consumed by
+  // NotifyIdleWindowBegin, which then requests the deferred full collection.
+  Atomic<bool> deferred_full_gc_pending_;
+
   // Info related to the current or previous GC iteration.
   collector::Iteration current_gc_iteration_;
 
@@ -1481,6 +1608,13 @@ class Heap {
   const bool verify_pre_gc_heap_;
   const bool verify_pre_sweeping_heap_;
   const bool verify_post_gc_heap_;
+  // If true, each verification pass only checks a rotating address slice of
+  // the heap (see VerifyHeapReferences), keeping always-on verification cheap
+  // while a full sweep still completes across consecutive passes.
+  const bool incremental_gc_verification_;
+  // Next slice to verify in incremental mode. Only accessed from
+  // VerifyHeapReferences with the mutator lock exclusively held.
+  size_t verification_slice_index_;
   const bool verify_mod_union_table_;
   bool verify_pre_gc_rosalloc_;
   bool verify_pre_sweeping_rosalloc_;
@@ -1585,6 +1719,10 @@ class Heap {
   const bool is_running_on_memory_tool_;
   const bool use_tlab_;
 
+  // If true, TLAB refill sizes are adapted per thread based on refill frequency rather than
+  // always using the allocator's default size.
+  const bool use_adaptive_tlab_size_;
+
   // Pointer to the space which becomes the new main space when we do homogeneous space compaction.
   // Use unique_ptr since the space is only added during the homogeneous compaction phase.
   std::unique_ptr<space::MallocSpace> main_space_backup_;
@@ -1621,6 +1759,7 @@ class Heap {
   // Active tasks which we can modify (change target time, desired collector type, etc..).
   CollectorTransitionTask* pending_collector_transition_ GUARDED_BY(pending_task_lock_);
   HeapTrimTask* pending_heap_trim_ GUARDED_BY(pending_task_lock_);
+  ReleaseRegionPagesTask* pending_region_page_release_ GUARDED_BY(pending_task_lock_);
 
   // Whether or not we use homogeneous space compaction to avoid OOM errors.
   bool use_homogeneous_space_compaction_for_oom_;
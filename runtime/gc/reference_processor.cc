@@ -174,6 +174,14 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
     DCHECK(finalizer_reference_queue_.IsEmpty());
     DCHECK(phantom_reference_queue_.IsEmpty());
   }
+  // Only shard the queue draining over the GC thread pool for concurrent collections with the
+  // concurrent copying collector; its marking entry points are safe to call from multiple
+  // threads. Paused collections keep the serial loops to not lengthen the pause with task
+  // startup overhead.
+  ThreadPool* thread_pool = nullptr;
+  if (concurrent && kUseReadBarrier) {
+    thread_pool = Runtime::Current()->GetHeap()->GetThreadPool();
+  }
   // Unless required to clear soft references with white references, preserve some white referents.
   if (!clear_soft_references) {
     TimingLogger::ScopedTiming split(concurrent ? "ForwardSoftReferences" :
@@ -183,7 +191,7 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
     }
     // TODO: Add smarter logic for preserving soft references. The behavior should be a conditional
     // mark if the SoftReference is supposed to be preserved.
-    soft_reference_queue_.ForwardSoftReferences(collector);
+    soft_reference_queue_.ForwardSoftReferences(collector, thread_pool);
     collector->ProcessMarkStack();
     if (concurrent) {
       StopPreservingReferences(self);
@@ -192,6 +200,11 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
   // Clear all remaining soft and weak references with white referents.
   soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
   weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  if (concurrent) {
+    // The soft and weak queues are drained: blocked GetReferent() callers with references on
+    // those queues can make progress now instead of waiting for the finalizer phase below.
+    BroadcastForSlowPath(self);
+  }
   {
     TimingLogger::ScopedTiming t2(concurrent ? "EnqueueFinalizerReferences" :
         "(Paused)EnqueueFinalizerReferences", timings);
@@ -199,7 +212,9 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
       StartPreservingReferences(self);
     }
     // Preserve all white objects with finalize methods and schedule them for finalization.
-    finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_, collector);
+    finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_,
+                                                          collector,
+                                                          thread_pool);
     collector->ProcessMarkStack();
     if (concurrent) {
       StopPreservingReferences(self);
@@ -282,6 +297,10 @@ class ClearedReferenceTask : public HeapTask {
     ScopedObjectAccess soa(thread);
     jvalue args[1];
     args[0].l = cleared_references_;
+    // `cleared_references_` is the head of the pendingNext-linked circular
+    // list built by the GC, so this single call splices all references cleared
+    // by the collection into the unenqueued list under one lock; per-queue
+    // work only happens later in ReferenceQueueDaemon.
     InvokeWithJValues(soa, nullptr, WellKnownClasses::java_lang_ref_ReferenceQueue_add, args);
     soa.Env()->DeleteGlobalRef(cleared_references_);
   }
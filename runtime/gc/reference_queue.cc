@@ -24,10 +24,15 @@
 #include "mirror/object-inl.h"
 #include "mirror/reference-inl.h"
 #include "object_callbacks.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
 
+// Minimum number of references a parallel task processes in ForwardSoftReferences and
+// EnqueueFinalizerReferences, so task overhead does not dominate for short queues.
+static constexpr size_t kParallelReferenceChunkSize = 512;
+
 ReferenceQueue::ReferenceQueue(Mutex* lock) : lock_(lock), list_(nullptr) {
 }
 
@@ -153,7 +158,54 @@ void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
 }
 
 void ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
-                                                collector::GarbageCollector* collector) {
+                                                collector::GarbageCollector* collector,
+                                                ThreadPool* thread_pool) {
+  if (thread_pool != nullptr && !IsEmpty()) {
+    // In transaction mode nothing is enqueued (see DelayReferenceReferent), so the parallel path
+    // does not need the transaction variants of the setters below.
+    DCHECK(!Runtime::Current()->IsActiveTransaction());
+    // Drain the queue first since DequeuePendingReference is not thread safe; the dequeue is
+    // cheap pointer chasing while the per-reference marking below dominates with large
+    // finalizable populations, so only the latter is sharded over the pool.
+    std::vector<mirror::FinalizerReference*> refs;
+    while (!IsEmpty()) {
+      refs.push_back(DequeuePendingReference()->AsFinalizerReference().Ptr());
+    }
+    Thread* const self = Thread::Current();
+    const size_t chunk_size =
+        std::max(kParallelReferenceChunkSize,
+                 refs.size() / (thread_pool->GetThreadCount() + 1) + 1);
+    for (size_t i = 0; i < refs.size(); i += chunk_size) {
+      const size_t end = std::min(i + chunk_size, refs.size());
+      thread_pool->AddTask(
+          self,
+          new FunctionTask([this, cleared_references, collector, &refs, i, end](Thread* thread)
+                               NO_THREAD_SAFETY_ANALYSIS {
+            for (size_t j = i; j < end; ++j) {
+              mirror::FinalizerReference* ref = refs[j];
+              mirror::HeapReference<mirror::Object>* referent_addr =
+                  ref->GetReferentReferenceAddr();
+              // do_atomic_update is true since workers may race on referents reachable through
+              // more than one reference.
+              if (!collector->IsNullOrMarkedHeapReference(referent_addr,
+                                                          /*do_atomic_update=*/ true)) {
+                ObjPtr<mirror::Object> forward_address =
+                    collector->MarkObject(referent_addr->AsMirrorPtr());
+                // Move the updated referent to the zombie field.
+                ref->SetZombie<false>(forward_address);
+                ref->ClearReferent<false>();
+                // The cleared queue is shared between the workers; use the locked enqueue.
+                cleared_references->AtomicEnqueueIfNotEnqueued(thread, ref);
+              }
+              DisableReadBarrierForReference(ref->AsReference());
+            }
+          }));
+    }
+    thread_pool->StartWorkers(self);
+    thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+    thread_pool->StopWorkers(self);
+    return;
+  }
   while (!IsEmpty()) {
     ObjPtr<mirror::FinalizerReference> ref = DequeuePendingReference()->AsFinalizerReference();
     mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
@@ -177,11 +229,45 @@ void ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_referenc
   }
 }
 
-void ReferenceQueue::ForwardSoftReferences(MarkObjectVisitor* visitor) {
+void ReferenceQueue::ForwardSoftReferences(MarkObjectVisitor* visitor, ThreadPool* thread_pool) {
   if (UNLIKELY(IsEmpty())) {
     return;
   }
   const ObjPtr<mirror::Reference> head = list_;
+  if (thread_pool != nullptr) {
+    // Collect the non-null referent slots, then shard the marking over the pool. The list walk
+    // is cheap compared to marking the referents' object graphs.
+    std::vector<mirror::HeapReference<mirror::Object>*> referent_addrs;
+    ObjPtr<mirror::Reference> ref = head;
+    do {
+      mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
+      if (referent_addr->AsMirrorPtr() != nullptr) {
+        referent_addrs.push_back(referent_addr);
+      }
+      ref = ref->GetPendingNext();
+    } while (LIKELY(ref != head));
+    Thread* const self = Thread::Current();
+    const size_t chunk_size =
+        std::max(kParallelReferenceChunkSize,
+                 referent_addrs.size() / (thread_pool->GetThreadCount() + 1) + 1);
+    for (size_t i = 0; i < referent_addrs.size(); i += chunk_size) {
+      const size_t end = std::min(i + chunk_size, referent_addrs.size());
+      thread_pool->AddTask(
+          self,
+          new FunctionTask([visitor, &referent_addrs, i, end](Thread* thread ATTRIBUTE_UNUSED)
+                               NO_THREAD_SAFETY_ANALYSIS {
+            for (size_t j = i; j < end; ++j) {
+              // do_atomic_update is true since workers may race on referents reachable through
+              // more than one soft reference.
+              visitor->MarkHeapReference(referent_addrs[j], /*do_atomic_update=*/ true);
+            }
+          }));
+    }
+    thread_pool->StartWorkers(self);
+    thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+    thread_pool->StopWorkers(self);
+    return;
+  }
   ObjPtr<mirror::Reference> ref = head;
   do {
     mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
@@ -40,6 +40,7 @@ class Reference;
 
 class IsMarkedVisitor;
 class MarkObjectVisitor;
+class ThreadPool;
 
 namespace gc {
 
@@ -78,15 +79,19 @@ class ReferenceQueue {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Enqueues finalizer references with white referents.  White referents are blackened, moved to
-  // the zombie field, and the referent field is cleared.
+  // the zombie field, and the referent field is cleared. If `thread_pool` is non-null the
+  // per-reference work is sharded over the pool's workers; the collector's marking entry points
+  // must then be safe to call from multiple threads (true for concurrent copying).
   void EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
-                                  collector::GarbageCollector* collector)
+                                  collector::GarbageCollector* collector,
+                                  ThreadPool* thread_pool = nullptr)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Walks the reference list marking any references subject to the reference clearing policy.
   // References with a black referent are removed from the list.  References with white referents
-  // biased toward saving are blackened and also removed from the list.
-  void ForwardSoftReferences(MarkObjectVisitor* visitor)
+  // biased toward saving are blackened and also removed from the list. If `thread_pool` is
+  // non-null the referent marking is sharded over the pool's workers.
+  void ForwardSoftReferences(MarkObjectVisitor* visitor, ThreadPool* thread_pool = nullptr)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Unlink the reference list clearing references objects with white referents. Cleared references
@@ -28,10 +28,7 @@ namespace gc {
 namespace space {
 
 template <typename Visitor>
-inline void BumpPointerSpace::Walk(Visitor&& visitor) {
-  uint8_t* pos = Begin();
-  uint8_t* end = End();
-  uint8_t* main_end = pos;
+inline void BumpPointerSpace::WalkBlock(uint8_t* pos, uint8_t* end, Visitor&& visitor) {
   // Internal indirection w/ NO_THREAD_SAFETY_ANALYSIS. Optimally, we'd like to have an annotation
   // like
   //   REQUIRES_AS(visitor.operator(mirror::Object*))
@@ -44,52 +41,25 @@ inline void BumpPointerSpace::Walk(Visitor&& visitor) {
   auto no_thread_safety_analysis_visit = [&](mirror::Object* obj) NO_THREAD_SAFETY_ANALYSIS {
     visitor(obj);
   };
-
-  {
-    MutexLock mu(Thread::Current(), block_lock_);
-    // If we have 0 blocks then we need to update the main header since we have bump pointer style
-    // allocation into an unbounded region (actually bounded by Capacity()).
-    if (num_blocks_ == 0) {
-      UpdateMainBlock();
-    }
-    main_end = Begin() + main_block_size_;
-    if (num_blocks_ == 0) {
-      // We don't have any other blocks, this means someone else may be allocating into the main
-      // block. In this case, we don't want to try and visit the other blocks after the main block
-      // since these could actually be part of the main block.
-      end = main_end;
-    }
+  mirror::Object* obj = reinterpret_cast<mirror::Object*>(pos);
+  const mirror::Object* end_obj = reinterpret_cast<const mirror::Object*>(end);
+  // We don't know how many objects are allocated in the current block. When we hit a null class
+  // assume its the end. TODO: Have a thread update the header when it flushes the block?
+  // There is a race condition where a thread has just allocated an object but not set the
+  // class, so the walk must not assume objects past the first null class are valid.
+  // No read barrier because obj may not be a valid object.
+  while (obj < end_obj && obj->GetClass<kDefaultVerifyFlags, kWithoutReadBarrier>() != nullptr) {
+    no_thread_safety_analysis_visit(obj);
+    obj = GetNextObject(obj);
   }
-  // Walk all of the objects in the main block first.
-  while (pos < main_end) {
-    mirror::Object* obj = reinterpret_cast<mirror::Object*>(pos);
-    // No read barrier because obj may not be a valid object.
-    if (obj->GetClass<kDefaultVerifyFlags, kWithoutReadBarrier>() == nullptr) {
-      // There is a race condition where a thread has just allocated an object but not set the
-      // class. We can't know the size of this object, so we don't visit it and exit the function
-      // since there is guaranteed to be not other blocks.
-      return;
-    } else {
-      no_thread_safety_analysis_visit(obj);
-      pos = reinterpret_cast<uint8_t*>(GetNextObject(obj));
-    }
-  }
-  // Walk the other blocks (currently only TLABs).
-  while (pos < end) {
-    BlockHeader* header = reinterpret_cast<BlockHeader*>(pos);
-    size_t block_size = header->size_;
-    pos += sizeof(BlockHeader);  // Skip the header so that we know where the objects
-    mirror::Object* obj = reinterpret_cast<mirror::Object*>(pos);
-    const mirror::Object* end_obj = reinterpret_cast<const mirror::Object*>(pos + block_size);
-    CHECK_LE(reinterpret_cast<const uint8_t*>(end_obj), End());
-    // We don't know how many objects are allocated in the current block. When we hit a null class
-    // assume its the end. TODO: Have a thread update the header when it flushes the block?
-    // No read barrier because obj may not be a valid object.
-    while (obj < end_obj && obj->GetClass<kDefaultVerifyFlags, kWithoutReadBarrier>() != nullptr) {
-      no_thread_safety_analysis_visit(obj);
-      obj = GetNextObject(obj);
-    }
-    pos += block_size;
+}
+
+template <typename Visitor>
+inline void BumpPointerSpace::Walk(Visitor&& visitor) {
+  // Walk all of the objects in the main block first, then the other blocks
+  // (currently only TLABs).
+  for (const std::pair<uint8_t*, uint8_t*>& range : GetBlockRanges()) {
+    WalkBlock(range.first, range.second, visitor);
   }
 }
 
@@ -162,6 +162,42 @@ uint8_t* BumpPointerSpace::AllocBlock(size_t bytes) {
   return storage;
 }
 
+std::vector<std::pair<uint8_t*, uint8_t*>> BumpPointerSpace::GetBlockRanges() {
+  std::vector<std::pair<uint8_t*, uint8_t*>> ranges;
+  uint8_t* pos = Begin();
+  uint8_t* end = End();
+  uint8_t* main_end = pos;
+  {
+    MutexLock mu(Thread::Current(), block_lock_);
+    // If we have 0 blocks then we need to update the main header since we have bump pointer style
+    // allocation into an unbounded region (actually bounded by Capacity()).
+    if (num_blocks_ == 0) {
+      UpdateMainBlock();
+    }
+    main_end = Begin() + main_block_size_;
+    if (num_blocks_ == 0) {
+      // We don't have any other blocks, this means someone else may be allocating into the main
+      // block. In this case, we don't want to report the blocks after the main block since these
+      // could actually be part of the main block.
+      end = main_end;
+    }
+  }
+  if (pos < main_end) {
+    ranges.emplace_back(pos, main_end);
+  }
+  // The other blocks (currently only TLABs) are prefixed by a BlockHeader recording their size.
+  pos = main_end;
+  while (pos < end) {
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(pos);
+    size_t block_size = header->size_;
+    pos += sizeof(BlockHeader);  // Skip the header so that the range starts at the objects.
+    CHECK_LE(pos + block_size, End());
+    ranges.emplace_back(pos, pos + block_size);
+    pos += block_size;
+  }
+  return ranges;
+}
+
 accounting::ContinuousSpaceBitmap::SweepCallback* BumpPointerSpace::GetSweepCallback() {
   UNIMPLEMENTED(FATAL);
   UNREACHABLE();
@@ -209,6 +245,11 @@ void BumpPointerSpace::RevokeThreadLocalBuffersLocked(Thread* thread) {
   thread->ResetTlab();
 }
 
+uint8_t* BumpPointerSpace::AllocGcBlock(size_t bytes) {
+  MutexLock mu(Thread::Current(), block_lock_);
+  return AllocBlock(bytes);
+}
+
 bool BumpPointerSpace::AllocNewTlab(Thread* self, size_t bytes) {
   MutexLock mu(Thread::Current(), block_lock_);
   RevokeThreadLocalBuffersLocked(self);
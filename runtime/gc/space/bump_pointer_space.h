@@ -17,6 +17,9 @@
 #ifndef ART_RUNTIME_GC_SPACE_BUMP_POINTER_SPACE_H_
 #define ART_RUNTIME_GC_SPACE_BUMP_POINTER_SPACE_H_
 
+#include <utility>
+#include <vector>
+
 #include "space.h"
 
 #include "base/mutex.h"
@@ -143,6 +146,18 @@ class BumpPointerSpace final : public ContinuousMemMapAllocSpace {
   // Allocate a new TLAB, returns false if the allocation failed.
   bool AllocNewTlab(Thread* self, size_t bytes) REQUIRES(!block_lock_);
 
+  // Allocate a raw block for a GC worker to carve copied objects out of, returns null on
+  // failure. The block is headed like a TLAB block and its unused tail stays zero, which the
+  // space walk tolerates, so the owner does not need to fill leftover space with dummy objects.
+  // The owner must report the objects it carves out through RecordBlockAllocation().
+  uint8_t* AllocGcBlock(size_t bytes) REQUIRES(!block_lock_);
+
+  // Record objects / bytes carved out of a block returned by AllocGcBlock().
+  void RecordBlockAllocation(size_t objects, size_t bytes) {
+    objects_allocated_.fetch_add(objects, std::memory_order_relaxed);
+    bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
   BumpPointerSpace* AsBumpPointerSpace() override {
     return this;
   }
@@ -153,6 +168,19 @@ class BumpPointerSpace final : public ContinuousMemMapAllocSpace {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!block_lock_);
 
+  // Return the `[begin, end)` object ranges of the main block and all thread
+  // blocks, taking block_lock_ only long enough to snapshot the boundaries.
+  // Together with WalkBlock() this lets a walk of the space be sharded per
+  // block across worker threads instead of holding the lock for the duration.
+  std::vector<std::pair<uint8_t*, uint8_t*>> GetBlockRanges() REQUIRES(!block_lock_);
+
+  // Visit the objects in the block range `[pos, end)`, where `pos` is the
+  // first object of a block. Stops at the first object without a class, as
+  // Walk() does for a block racing with an ongoing allocation.
+  template <typename Visitor>
+  ALWAYS_INLINE static void WalkBlock(uint8_t* pos, uint8_t* end, Visitor&& visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   accounting::ContinuousSpaceBitmap::SweepCallback* GetSweepCallback() override;
 
   // Record objects / bytes freed.
@@ -1140,7 +1140,9 @@ class ImageSpace::Loader {
 
     void operator()(mirror::Object* obj) const
         NO_THREAD_SAFETY_ANALYSIS {
-      if (!visited_->Set(obj)) {
+      // The walk may be sharded across threads and bits for neighboring objects
+      // share a bitmap word, so the bitmap update needs to be atomic.
+      if (!visited_->AtomicTestAndSet(obj)) {
         // Not already visited.
         obj->VisitReferences</*visit native roots*/false, kVerifyNone, kWithoutReadBarrier>(
             *this,
@@ -1285,7 +1287,36 @@ class ImageSpace::Loader {
       uintptr_t objects_begin = reinterpret_cast<uintptr_t>(target_base + objects_section.Offset());
       uintptr_t objects_end = reinterpret_cast<uintptr_t>(target_base + objects_section.End());
       FixupObjectVisitor<ForwardObject> fixup_object_visitor(&visited_bitmap, forward_object);
-      bitmap->VisitMarkedRange(objects_begin, objects_end, fixup_object_visitor);
+      // The fixup is embarrassingly parallel over disjoint address ranges: each
+      // object is patched by the shard owning its start address and the visited
+      // bitmap is updated with atomic test-and-set. Shard the walk over the
+      // runtime thread pool when the objects section is large enough for the
+      // task overhead to pay off.
+      Runtime::ScopedThreadPoolUsage stpu;
+      ThreadPool* const pool = stpu.GetThreadPool();
+      Thread* const self = Thread::Current();
+      static constexpr uintptr_t kMinShardSize = 1u * MB;
+      const uintptr_t objects_size = objects_end - objects_begin;
+      const bool use_parallel = pool != nullptr && objects_size >= 2u * kMinShardSize;
+      if (use_parallel) {
+        const size_t num_shards = std::min<size_t>(pool->GetThreadCount() + 1u,
+                                                   objects_size / kMinShardSize);
+        const uintptr_t shard_size = RoundUp(objects_size / num_shards + 1u, kPageSize);
+        for (uintptr_t shard_begin = objects_begin;
+             shard_begin < objects_end;
+             shard_begin += shard_size) {
+          const uintptr_t shard_end = std::min(shard_begin + shard_size, objects_end);
+          auto function = [=](Thread*) NO_THREAD_SAFETY_ANALYSIS {
+            bitmap->VisitMarkedRange(shard_begin, shard_end, fixup_object_visitor);
+          };
+          pool->AddTask(self, new FunctionTask(std::move(function)));
+        }
+        // Go to native since we don't want to suspend while holding the mutator lock.
+        ScopedThreadSuspension sts(self, kNative);
+        pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+      } else {
+        bitmap->VisitMarkedRange(objects_begin, objects_end, fixup_object_visitor);
+      }
       // Fixup image roots.
       CHECK(app_image_objects.InSource(reinterpret_cast<uintptr_t>(
           image_header->GetImageRoots<kWithoutReadBarrier>().Ptr())));
@@ -35,6 +35,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "space-inl.h"
 #include "thread-current-inl.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
@@ -622,6 +623,64 @@ void LargeObjectSpace::SweepCallback(size_t num_ptrs, mirror::Object** ptrs, voi
   context->freed.bytes += space->FreeList(self, num_ptrs, ptrs);
 }
 
+// Collects the dead objects reported by SweepWalk into a per-shard list, see SweepParallel.
+static void CollectGarbageCallback(size_t num_ptrs, mirror::Object** ptrs, void* arg) {
+  std::vector<mirror::Object*>* garbage = reinterpret_cast<std::vector<mirror::Object*>*>(arg);
+  garbage->insert(garbage->end(), ptrs, ptrs + num_ptrs);
+}
+
+collector::ObjectBytePair LargeObjectSpace::SweepParallel(
+    accounting::LargeObjectBitmap* live_bitmap,
+    accounting::LargeObjectBitmap* mark_bitmap,
+    bool swap_bitmaps,
+    uintptr_t sweep_begin,
+    uintptr_t sweep_end,
+    ThreadPool* thread_pool,
+    size_t thread_count) {
+  Thread* const self = Thread::Current();
+  // Shard boundaries must not share bitmap words so that the bitmap clears below touch disjoint
+  // words. One bitmap word covers this many bytes of heap.
+  const uintptr_t kShardGranularity = kLargeObjectAlignment * kBitsPerIntPtrT;
+  const uintptr_t shard_size =
+      RoundUp((sweep_end - sweep_begin) / thread_count + 1, kShardGranularity);
+  Atomic<size_t> freed_objects(0);
+  Atomic<size_t> freed_bytes(0);
+  for (uintptr_t shard_begin = sweep_begin; shard_begin < sweep_end; shard_begin += shard_size) {
+    const uintptr_t shard_end = std::min(shard_begin + shard_size, sweep_end);
+    thread_pool->AddTask(self, new FunctionTask(
+        [this, live_bitmap, mark_bitmap, swap_bitmaps, shard_begin, shard_end, &freed_objects,
+         &freed_bytes](Thread* worker) {
+          // Per-shard list of dead objects; the freed totals are merged at the end.
+          std::vector<mirror::Object*> garbage;
+          accounting::LargeObjectBitmap::SweepWalk(*live_bitmap,
+                                                   *mark_bitmap,
+                                                   shard_begin,
+                                                   shard_end,
+                                                   CollectGarbageCallback,
+                                                   &garbage);
+          if (garbage.empty()) {
+            return;
+          }
+          if (!swap_bitmaps) {
+            // The GC holds the heap bitmap lock exclusively for the duration of the sweep and
+            // shards cover disjoint bitmap words, so these clears do not race.
+            for (mirror::Object* obj : garbage) {
+              live_bitmap->Clear(obj);
+            }
+          }
+          freed_bytes.fetch_add(FreeList(worker, garbage.size(), &garbage[0]),
+                                std::memory_order_relaxed);
+          freed_objects.fetch_add(garbage.size(), std::memory_order_relaxed);
+        }));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, true);
+  thread_pool->StopWorkers(self);
+  return collector::ObjectBytePair(freed_objects.load(std::memory_order_relaxed),
+                                   freed_bytes.load(std::memory_order_relaxed));
+}
+
 collector::ObjectBytePair LargeObjectSpace::Sweep(bool swap_bitmaps) {
   if (Begin() >= End()) {
     return collector::ObjectBytePair(0, 0);
@@ -631,11 +690,28 @@ collector::ObjectBytePair LargeObjectSpace::Sweep(bool swap_bitmaps) {
   if (swap_bitmaps) {
     std::swap(live_bitmap, mark_bitmap);
   }
-  AllocSpace::SweepCallbackContext scc(swap_bitmaps, this);
   std::pair<uint8_t*, uint8_t*> range = GetBeginEndAtomic();
+  const uintptr_t sweep_begin = reinterpret_cast<uintptr_t>(range.first);
+  const uintptr_t sweep_end = reinterpret_cast<uintptr_t>(range.second);
+  Heap* const heap = Runtime::Current()->GetHeap();
+  ThreadPool* const thread_pool = heap->GetThreadPool();
+  size_t thread_count = 1;
+  if (thread_pool != nullptr && Runtime::Current()->InJankPerceptibleProcessState()) {
+    thread_count = heap->GetConcGCThreadCount() + 1;
+  }
+  if (thread_count > 1 && sweep_end - sweep_begin >= kMinParallelSweepBytes) {
+    return SweepParallel(live_bitmap,
+                         mark_bitmap,
+                         swap_bitmaps,
+                         sweep_begin,
+                         sweep_end,
+                         thread_pool,
+                         thread_count);
+  }
+  AllocSpace::SweepCallbackContext scc(swap_bitmaps, this);
   accounting::LargeObjectBitmap::SweepWalk(*live_bitmap, *mark_bitmap,
-                                           reinterpret_cast<uintptr_t>(range.first),
-                                           reinterpret_cast<uintptr_t>(range.second),
+                                           sweep_begin,
+                                           sweep_end,
                                            SweepCallback,
                                            &scc);
   return scc.freed;
@@ -28,6 +28,9 @@
 #include <vector>
 
 namespace art {
+
+class ThreadPool;
+
 namespace gc {
 namespace space {
 
@@ -117,10 +120,24 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   virtual std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const = 0;
 
  protected:
+  // Sweeps smaller than this run serially since sharding has a fixed task overhead.
+  static constexpr size_t kMinParallelSweepBytes = 16 * MB;
+
   explicit LargeObjectSpace(const std::string& name, uint8_t* begin, uint8_t* end,
                             const char* lock_name);
   static void SweepCallback(size_t num_ptrs, mirror::Object** ptrs, void* arg);
 
+  // Shards the sweep of [sweep_begin, sweep_end) across the GC thread pool. Each task collects
+  // the dead objects of its shard into a local list and frees them, merging the freed totals at
+  // the end. Only called while the GC holds the heap bitmap lock exclusively.
+  collector::ObjectBytePair SweepParallel(accounting::LargeObjectBitmap* live_bitmap,
+                                          accounting::LargeObjectBitmap* mark_bitmap,
+                                          bool swap_bitmaps,
+                                          uintptr_t sweep_begin,
+                                          uintptr_t sweep_end,
+                                          ThreadPool* thread_pool,
+                                          size_t thread_count) REQUIRES(!lock_);
+
   // Used to ensure mutual exclusion when the allocation spaces data structures,
   // including the allocation counters below, are being modified.
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
@@ -56,34 +56,41 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes,
   mirror::Object* obj;
   if (LIKELY(num_bytes <= kRegionSize)) {
     // Non-large object.
-    obj = (kForEvac ? evac_region_ : current_region_)->Alloc(num_bytes,
-                                                             bytes_allocated,
-                                                             usable_size,
-                                                             bytes_tl_bulk_allocated);
+    Atomic<Region*>& alloc_region = kForEvac ? evac_region_ : current_region_;
+    Region* r = alloc_region.load(std::memory_order_acquire);
+    obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
     if (LIKELY(obj != nullptr)) {
       return obj;
     }
+    // The region was full. If another thread has installed a fresh region in the meantime, retry
+    // against it without taking region_lock_, so refill races do not convoy on the mutex.
+    while (true) {
+      Region* const refreshed = alloc_region.load(std::memory_order_acquire);
+      if (refreshed == r) {
+        break;
+      }
+      r = refreshed;
+      obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
+      if (LIKELY(obj != nullptr)) {
+        return obj;
+      }
+    }
     MutexLock mu(Thread::Current(), region_lock_);
-    // Retry with current region since another thread may have updated
-    // current_region_ or evac_region_.  TODO: fix race.
-    obj = (kForEvac ? evac_region_ : current_region_)->Alloc(num_bytes,
-                                                             bytes_allocated,
-                                                             usable_size,
-                                                             bytes_tl_bulk_allocated);
+    // Retry one more time now that region installs are serialized by the lock.
+    obj = alloc_region.load(std::memory_order_relaxed)->Alloc(num_bytes,
+                                                              bytes_allocated,
+                                                              usable_size,
+                                                              bytes_tl_bulk_allocated);
     if (LIKELY(obj != nullptr)) {
       return obj;
     }
-    Region* r = AllocateRegion(kForEvac);
+    r = AllocateRegion(kForEvac);
     if (LIKELY(r != nullptr)) {
       obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
       CHECK(obj != nullptr);
-      // Do our allocation before setting the region, this makes sure no threads race ahead
+      // Do our allocation before publishing the region, this makes sure no threads race ahead
       // and fill in the region before we allocate the object. b/63153464
-      if (kForEvac) {
-        evac_region_ = r;
-      } else {
-        current_region_ = r;
-      }
+      alloc_region.store(r, std::memory_order_release);
       return obj;
     }
   } else {
@@ -233,7 +240,16 @@ inline void RegionSpace::WalkInternal(Visitor&& visitor) {
   // issues (the classloader classes lock and the monitor lock). We
   // call this with threads suspended.
   Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
-  for (size_t i = 0; i < num_regions_; ++i) {
+  WalkRangeInternal<kToSpaceOnly>(visitor, /*begin_region_idx=*/ 0u, num_regions_);
+}
+
+template<bool kToSpaceOnly, typename Visitor>
+inline void RegionSpace::WalkRangeInternal(Visitor&& visitor,
+                                           size_t begin_region_idx,
+                                           size_t end_region_idx) {
+  DCHECK_LE(begin_region_idx, end_region_idx);
+  DCHECK_LE(end_region_idx, num_regions_);
+  for (size_t i = begin_region_idx; i < end_region_idx; ++i) {
     Region* r = &regions_[i];
     if (r->IsFree() || (kToSpaceOnly && !r->IsInToSpace())) {
       continue;
@@ -304,6 +320,15 @@ inline void RegionSpace::WalkToSpace(Visitor&& visitor) {
   WalkInternal</* kToSpaceOnly= */ true>(visitor);
 }
 
+template <typename Visitor>
+inline void RegionSpace::WalkRange(Visitor&& visitor,
+                                   size_t begin_region_idx,
+                                   size_t end_region_idx) {
+  // No assert on the mutator lock here: the suspension is coordinated by the
+  // thread driving the parallel walk, not by the worker calling this.
+  WalkRangeInternal</* kToSpaceOnly= */ false>(visitor, begin_region_idx, end_region_idx);
+}
+
 inline mirror::Object* RegionSpace::GetNextObject(mirror::Object* obj) {
   const uintptr_t position = reinterpret_cast<uintptr_t>(obj) + obj->SizeOf();
   return reinterpret_cast<mirror::Object*>(RoundUp(position, kAlignment));
@@ -13,6 +13,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include <deque>
 
 #include "bump_pointer_space-inl.h"
@@ -47,9 +51,15 @@ static constexpr uint32_t kPoisonDeadObject = 0xBADDB01D;  // "BADDROID"
 // Whether we check a region's live bytes count against the region bitmap.
 static constexpr bool kCheckLiveBytesAgainstRegionBitmap = kIsDebugBuild;
 
+// mbind(2) policy constants from <linux/mempolicy.h>, which neither bionic nor
+// glibc exports without libnuma; the syscall is invoked directly below.
+static constexpr int kMemPolicyLocal = 4;                   // MPOL_LOCAL
+static constexpr unsigned int kMemPolicyFlagMove = 1u << 1;  // MPOL_MF_MOVE
+
 MemMap RegionSpace::CreateMemMap(const std::string& name,
                                  size_t capacity,
-                                 uint8_t* requested_begin) {
+                                 uint8_t* requested_begin,
+                                 bool use_huge_pages) {
   CHECK_ALIGNED(capacity, kRegionSize);
   std::string error_msg;
   // Ask for the capacity of an additional kRegionSize so that we can align the map by kRegionSize
@@ -91,15 +101,37 @@ MemMap RegionSpace::CreateMemMap(const std::string& name,
   CHECK_ALIGNED(mem_map.Begin(), kRegionSize);
   CHECK_ALIGNED(mem_map.End(), kRegionSize);
   CHECK_EQ(mem_map.Size(), capacity);
+  if (use_huge_pages) {
+#ifdef MADV_HUGEPAGE
+    // Only the 2MB-aligned interior can be backed by transparent huge pages; kRegionSize
+    // alignment of the map does not guarantee 2MB alignment of its ends. This is advisory, so
+    // a failure (e.g. THP disabled by the kernel) is logged and otherwise ignored.
+    static constexpr size_t kHugePageSize = 2 * MB;
+    uint8_t* const huge_begin = AlignUp(mem_map.Begin(), kHugePageSize);
+    uint8_t* const huge_end = AlignDown(mem_map.End(), kHugePageSize);
+    if (huge_begin < huge_end &&
+        madvise(huge_begin, huge_end - huge_begin, MADV_HUGEPAGE) != 0) {
+      PLOG(WARNING) << "Failed to madvise region space " << name << " with MADV_HUGEPAGE";
+    }
+#else
+    LOG(WARNING) << "MADV_HUGEPAGE is not supported on this platform; "
+                 << "ignoring UseRegionSpaceHugePages for " << name;
+#endif
+  }
   return mem_map;
 }
 
-RegionSpace* RegionSpace::Create(
-    const std::string& name, MemMap&& mem_map, bool use_generational_cc) {
-  return new RegionSpace(name, std::move(mem_map), use_generational_cc);
+RegionSpace* RegionSpace::Create(const std::string& name,
+                                 MemMap&& mem_map,
+                                 bool use_generational_cc,
+                                 bool use_numa_local_regions) {
+  return new RegionSpace(name, std::move(mem_map), use_generational_cc, use_numa_local_regions);
 }
 
-RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc)
+RegionSpace::RegionSpace(const std::string& name,
+                         MemMap&& mem_map,
+                         bool use_generational_cc,
+                         bool use_numa_local_regions)
     : ContinuousMemMapAllocSpace(name,
                                  std::move(mem_map),
                                  mem_map.Begin(),
@@ -108,6 +140,7 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
                                  kGcRetentionPolicyAlwaysCollect),
       region_lock_("Region lock", kRegionSpaceRegionLock),
       use_generational_cc_(use_generational_cc),
+      use_numa_local_regions_(use_numa_local_regions),
       time_(1U),
       num_regions_(mem_map_.Size() / kRegionSize),
       madvise_time_(0U),
@@ -408,8 +441,8 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
     DCHECK(!r->is_newly_allocated_);
   }
   DCHECK_EQ(num_expected_large_tails, 0U);
-  current_region_ = &full_region_;
-  evac_region_ = &full_region_;
+  current_region_.store(&full_region_, std::memory_order_relaxed);
+  evac_region_.store(&full_region_, std::memory_order_relaxed);
 }
 
 static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end) {
@@ -501,8 +534,40 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
 
   // Madvise the memory ranges.
   uint64_t start_time = NanoTime();
+  // Keep the pages of the first few cleared regions mapped: back-to-back GC cycles re-fault
+  // them almost immediately as evacuation destinations or TLABs. They are zeroed in place here
+  // and their pages released later, with pacing, by the Heap's background task (see
+  // Heap::RequestRetainedRegionPageRelease), unless the allocator reuses them first.
+  size_t retain_budget;
+  {
+    MutexLock mu(Thread::Current(), region_lock_);
+    retain_budget = kMaxRetainedClearedRegions > retained_cleared_regions_.size()
+                        ? kMaxRetainedClearedRegions - retained_cleared_regions_.size()
+                        : 0u;
+  }
   for (const auto &iter : madvise_list) {
-    ZeroAndProtectRegion(iter.first, iter.second);
+    uint8_t* range_begin = iter.first;
+    if (retain_budget != 0u) {
+      const size_t regions_in_range = (iter.second - range_begin) / kRegionSize;
+      const size_t to_retain = std::min(retain_budget, regions_in_range);
+      uint8_t* const retain_end = range_begin + to_retain * kRegionSize;
+      memset(range_begin, 0, retain_end - range_begin);
+      if (kProtectClearedRegions) {
+        CheckedCall(mprotect, __FUNCTION__, range_begin, retain_end - range_begin, PROT_NONE);
+      }
+      {
+        MutexLock mu(Thread::Current(), region_lock_);
+        for (uint8_t* p = range_begin; p != retain_end; p += kRegionSize) {
+          retained_cleared_regions_.push_back(static_cast<size_t>(p - Begin()) / kRegionSize);
+        }
+      }
+      retain_budget -= to_retain;
+      range_begin = retain_end;
+      if (range_begin == iter.second) {
+        continue;
+      }
+    }
+    ZeroAndProtectRegion(range_begin, iter.second);
   }
   madvise_time_ += NanoTime() - start_time;
 
@@ -631,11 +696,42 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
   }
   // Update non_free_region_index_limit_.
   SetNonFreeRegionLimit(new_non_free_region_index_limit);
-  evac_region_ = nullptr;
+  evac_region_.store(nullptr, std::memory_order_relaxed);
   num_non_free_regions_ += num_evac_regions_;
   num_evac_regions_ = 0;
 }
 
+size_t RegionSpace::ReleaseRetainedClearedPages(size_t max_regions) {
+  size_t released = 0;
+  Thread* self = Thread::Current();
+  while (released < max_regions) {
+    MutexLock mu(self, region_lock_);
+    Region* r = nullptr;
+    while (!retained_cleared_regions_.empty()) {
+      Region* candidate = &regions_[retained_cleared_regions_.front()];
+      retained_cleared_regions_.pop_front();
+      if (candidate->IsFree()) {
+        r = candidate;
+        break;
+      }
+      // The region was re-allocated while its pages were still mapped, so there is nothing to
+      // release.
+    }
+    if (r == nullptr) {
+      break;
+    }
+    // Release a single region per critical section. Unlike in ClearFromSpace, region_lock_
+    // must be held across the madvise call: the region is already free and could otherwise be
+    // re-allocated while its pages are being dropped. A single region is small enough for the
+    // syscall not to stall allocators noticeably.
+    const uint64_t start_time = NanoTime();
+    ZeroAndProtectRegion(r->Begin(), r->End());
+    madvise_time_ += NanoTime() - start_time;
+    ++released;
+  }
+  return released;
+}
+
 void RegionSpace::CheckLiveBytesAgainstRegionBitmap(Region* r) {
   if (r->LiveBytes() == static_cast<size_t>(-1)) {
     // Live bytes count is undefined for `r`; nothing to check here.
@@ -727,8 +823,9 @@ bool RegionSpace::LogFragmentationAllocFailure(std::ostream& os,
   size_t max_contiguous_allocation = 0;
   MutexLock mu(Thread::Current(), region_lock_);
 
-  if (current_region_->End() - current_region_->Top() > 0) {
-    max_contiguous_allocation = current_region_->End() - current_region_->Top();
+  Region* const current_region = current_region_.load(std::memory_order_relaxed);
+  if (current_region->End() - current_region->Top() > 0) {
+    max_contiguous_allocation = current_region->End() - current_region->Top();
   }
 
   size_t max_contiguous_free_regions = 0;
@@ -781,8 +878,8 @@ void RegionSpace::Clear() {
   }
   SetNonFreeRegionLimit(0);
   DCHECK_EQ(num_non_free_regions_, 0u);
-  current_region_ = &full_region_;
-  evac_region_ = &full_region_;
+  current_region_.store(&full_region_, std::memory_order_relaxed);
+  evac_region_.store(&full_region_, std::memory_order_relaxed);
 }
 
 void RegionSpace::Protect() {
@@ -1034,6 +1131,33 @@ void RegionSpace::TraceHeapSize() {
   heap->TraceHeapSize(heap->GetBytesAllocated() + EvacBytes());
 }
 
+void RegionSpace::BindRegionToLocalNumaNode(Region* r) {
+#if defined(__linux__) && defined(__NR_mbind)
+  // Freed regions have had their pages released with madvise, so this mostly
+  // installs the policy for pages faulted in by the upcoming allocations;
+  // MPOL_MF_MOVE migrates any that are still resident. The syscall is cheap
+  // relative to filling a region, so issuing it under region_lock_ is fine.
+  // Failures (e.g. a kernel built without CONFIG_NUMA) are logged once and
+  // otherwise ignored; the region is still usable, just not node-bound.
+  if (syscall(__NR_mbind,
+              r->Begin(),
+              kRegionSize,
+              kMemPolicyLocal,
+              /* nodemask= */ nullptr,
+              /* maxnode= */ 0ul,
+              kMemPolicyFlagMove) != 0) {
+    static bool warned = false;  // Guarded by region_lock_.
+    if (!warned) {
+      warned = true;
+      PLOG(WARNING) << "mbind failed for " << GetName()
+                    << "; continuing without NUMA-local regions";
+    }
+  }
+#else
+  UNUSED(r);
+#endif
+}
+
 RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
   if (!for_evac && (num_non_free_regions_ + 1) * 2 > num_regions_) {
     return nullptr;
@@ -1061,6 +1185,13 @@ RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
         r->SetNewlyAllocated();
         ++num_non_free_regions_;
       }
+      if (use_numa_local_regions_) {
+        // The caller is the thread that will fill the region: a mutator for a TLAB or
+        // direct allocation, a GC worker for an evacuation region. Either way, bind the
+        // region to the caller's node so both the allocation and the later scan of the
+        // region stay node-local.
+        BindRegionToLocalNumaNode(r);
+      }
       if (kCyclicRegionAllocation) {
         // Move the cyclic allocation region marker to the region
         // following the one that was just allocated.
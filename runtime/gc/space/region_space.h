@@ -22,6 +22,7 @@
 #include "space.h"
 #include "thread.h"
 
+#include <deque>
 #include <functional>
 #include <map>
 
@@ -61,8 +62,22 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // Create a region space mem map with the requested sizes. The requested base address is not
   // guaranteed to be granted, if it is required, the caller should call Begin on the returned
   // space to confirm the request was granted.
-  static MemMap CreateMemMap(const std::string& name, size_t capacity, uint8_t* requested_begin);
-  static RegionSpace* Create(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  // Create the mem map backing the region space. If `use_huge_pages` is true, the 2MB-aligned
+  // portion of the map is advised with MADV_HUGEPAGE so the kernel can back it with transparent
+  // huge pages, reducing dTLB pressure during object graph traversal (opt-in via
+  // -XX:UseRegionSpaceHugePages).
+  static MemMap CreateMemMap(const std::string& name,
+                             size_t capacity,
+                             uint8_t* requested_begin,
+                             bool use_huge_pages = false);
+  // Create the region space. If `use_numa_local_regions` is true, each region is bound to the
+  // NUMA node of the thread it is allocated for via mbind(2), so mutators allocate from
+  // node-local memory and GC workers copy into node-local evacuation regions (opt-in via
+  // -XX:UseNumaLocalRegions; a no-op on single-node devices and !CONFIG_NUMA kernels).
+  static RegionSpace* Create(const std::string& name,
+                             MemMap&& mem_map,
+                             bool use_generational_cc,
+                             bool use_numa_local_regions = false);
 
   // Allocate `num_bytes`, returns null if the space is full.
   mirror::Object* Alloc(Thread* self,
@@ -215,6 +230,15 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   template <typename Visitor>
   ALWAYS_INLINE void WalkToSpace(Visitor&& visitor) REQUIRES(Locks::mutator_lock_);
 
+  // Visit the objects in regions `[begin_region_idx, end_region_idx)`. Large
+  // objects are visited by the chunk holding their first region, so disjoint
+  // ranges covering all regions visit every object exactly once. Used by
+  // Heap::VisitObjectsParallel() to partition the walk across worker threads;
+  // the caller is responsible for suspending the mutators for the duration.
+  template <typename Visitor>
+  ALWAYS_INLINE void WalkRange(Visitor&& visitor, size_t begin_region_idx, size_t end_region_idx)
+      REQUIRES(Locks::mutator_lock_);
+
   // Scans regions and calls visitor for objects in unevac-space corresponding
   // to the bits set in 'bitmap'.
   // Cannot acquire region_lock_ as visitor may need to acquire it for allocation.
@@ -384,8 +408,23 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     return madvise_time_;
   }
 
+  // Maximum number of cleared from-space regions whose pages ClearFromSpace keeps mapped
+  // (zeroed in place) instead of madvising them inline, so that back-to-back GC cycles can
+  // reuse the warm pages for the next evacuation without re-faulting them. The retained pages
+  // are released gradually by ReleaseRetainedClearedPages.
+  static constexpr size_t kMaxRetainedClearedRegions = 32;
+
+  // Release the pages of up to `max_regions` retained cleared regions that are still free and
+  // return the number of regions released. Retained regions that have been re-allocated in the
+  // meantime are simply dropped from the pending list: their still-mapped pages are in use
+  // again, which is the point of retaining them. Returns 0 when nothing is pending.
+  size_t ReleaseRetainedClearedPages(size_t max_regions) REQUIRES(!region_lock_);
+
  private:
-  RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  RegionSpace(const std::string& name,
+              MemMap&& mem_map,
+              bool use_generational_cc,
+              bool use_numa_local_regions);
 
   class Region {
    public:
@@ -639,6 +678,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   template<bool kToSpaceOnly, typename Visitor>
   ALWAYS_INLINE void WalkInternal(Visitor&& visitor) NO_THREAD_SAFETY_ANALYSIS;
 
+  template<bool kToSpaceOnly, typename Visitor>
+  ALWAYS_INLINE void WalkRangeInternal(Visitor&& visitor, size_t begin_region_idx,
+                                       size_t end_region_idx) NO_THREAD_SAFETY_ANALYSIS;
+
   // Visitor will be iterating on objects in increasing address order.
   template<typename Visitor>
   ALWAYS_INLINE void WalkNonLargeRegion(Visitor&& visitor, const Region* r)
@@ -736,10 +779,16 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // objects earlier in debug mode.
   void PoisonDeadObjectsInUnevacuatedRegion(Region* r);
 
+  // Bind the pages of region `r` to the NUMA node of the calling thread with
+  // mbind(2). Only called when use_numa_local_regions_ is set.
+  void BindRegionToLocalNumaNode(Region* r) REQUIRES(region_lock_);
+
   Mutex region_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
   // Cached version of Heap::use_generational_cc_.
   const bool use_generational_cc_;
+  // Whether regions are bound to the allocating thread's NUMA node (see Create()).
+  const bool use_numa_local_regions_;
   uint32_t time_;                  // The time as the number of collections since the startup.
   size_t num_regions_;             // The number of regions in this space.
   uint64_t madvise_time_;          // The amount of time spent in madvise for purging pages.
@@ -767,8 +816,16 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   //   for all `i >= non_free_region_index_limit_`, `regions_[i].IsFree()` is true.
   size_t non_free_region_index_limit_ GUARDED_BY(region_lock_);
 
-  Region* current_region_;         // The region currently used for allocation.
-  Region* evac_region_;            // The region currently used for evacuation.
+  // Indices of cleared regions whose pages are still mapped (zeroed and free), waiting to be
+  // either reused by the allocator or released by ReleaseRetainedClearedPages.
+  std::deque<size_t> retained_cleared_regions_ GUARDED_BY(region_lock_);
+
+  // The regions currently used for allocation and evacuation. Accessed lock-free in the
+  // allocation fast path: new regions are published with a release store after the installing
+  // thread has done its own allocation, and readers that observe a stale pointer retry against
+  // the new region without taking region_lock_.
+  Atomic<Region*> current_region_;
+  Atomic<Region*> evac_region_;
   Region full_region_;             // The fake/sentinel region that looks full.
 
   // Index into the region array pointing to the starting region when
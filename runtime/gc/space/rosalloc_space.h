@@ -158,6 +158,10 @@ class RosAllocSpace : public MallocSpace {
 
   void DumpStats(std::ostream& os);
 
+  void GetFragmentationStats(allocator::RosAlloc::FragmentationStats* stats) {
+    rosalloc_->GetFragmentationStats(stats);
+  }
+
  protected:
   RosAllocSpace(MemMap&& mem_map,
                 size_t initial_size,
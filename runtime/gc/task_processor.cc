@@ -16,17 +16,21 @@
 
 #include "task_processor.h"
 
+#include <algorithm>
+
 #include "base/time_utils.h"
 #include "scoped_thread_state_change-inl.h"
 
 namespace art {
 namespace gc {
 
-TaskProcessor::TaskProcessor()
+TaskProcessor::TaskProcessor(uint64_t slack_ns)
     : lock_("Task processor lock", kReferenceProcessorLock),
       cond_("Task processor condition", lock_),
       is_running_(false),
-      running_thread_(nullptr) {
+      running_thread_(nullptr),
+      slack_ns_(slack_ns),
+      wakeup_time_(0u) {
 }
 
 TaskProcessor::~TaskProcessor() {
@@ -38,11 +42,24 @@ TaskProcessor::~TaskProcessor() {
   }
 }
 
+void TaskProcessor::MaybeSignal(Thread* self, uint64_t target_time) {
+  // Only wake the waiter if it is sleeping and would otherwise wake too late for the task; a
+  // task due within the slack window of the pending wakeup is serviced by that wakeup, so
+  // near-simultaneous additions coalesce into a single wake.
+  if (wakeup_time_ != 0u &&
+      (wakeup_time_ == kWakeupIndefinite || target_time + slack_ns_ < wakeup_time_)) {
+    // The woken waiter recomputes its wakeup from the queue; elide further signals until then.
+    wakeup_time_ = 0u;
+    cond_.Signal(self);
+  }
+}
+
 void TaskProcessor::AddTask(Thread* self, HeapTask* task) {
   ScopedThreadStateChange tsc(self, kWaitingForTaskProcessor);
   MutexLock mu(self, lock_);
-  tasks_.insert(task);
-  cond_.Signal(self);
+  tasks_.push_back(task);
+  std::push_heap(tasks_.begin(), tasks_.end(), CompareByTargetRunTime());
+  MaybeSignal(self, task->GetTargetRunTime());
 }
 
 HeapTask* TaskProcessor::GetTask(Thread* self) {
@@ -53,16 +70,20 @@ HeapTask* TaskProcessor::GetTask(Thread* self) {
       if (!is_running_) {
         return nullptr;
       }
+      wakeup_time_ = kWakeupIndefinite;
       cond_.Wait(self);  // Empty queue, wait until we are signalled.
+      wakeup_time_ = 0u;
     } else {
       // Non empty queue, look at the top element and see if we are ready to run it.
       const uint64_t current_time = NanoTime();
-      HeapTask* task = *tasks_.begin();
-      // If we are shutting down, return the task right away without waiting. Otherwise return the
-      // task if it is late enough.
+      HeapTask* task = tasks_.front();
+      // If we are shutting down, return the task right away without waiting. Otherwise return
+      // the task once it is due, counting tasks within the slack window as due so that one
+      // wakeup drains all near-simultaneous tasks.
       uint64_t target_time = task->GetTargetRunTime();
-      if (!is_running_ || target_time <= current_time) {
-        tasks_.erase(tasks_.begin());
+      if (!is_running_ || target_time <= current_time + slack_ns_) {
+        std::pop_heap(tasks_.begin(), tasks_.end(), CompareByTargetRunTime());
+        tasks_.pop_back();
         return task;
       }
       DCHECK_GT(target_time, current_time);
@@ -70,7 +91,9 @@ HeapTask* TaskProcessor::GetTask(Thread* self) {
       const uint64_t delta_time = target_time - current_time;
       const uint64_t ms_delta = NsToMs(delta_time);
       const uint64_t ns_delta = delta_time - MsToNs(ms_delta);
+      wakeup_time_ = target_time;
       cond_.TimedWait(self, static_cast<int64_t>(ms_delta), static_cast<int32_t>(ns_delta));
+      wakeup_time_ = 0u;
     }
   }
   UNREACHABLE();
@@ -79,22 +102,13 @@ HeapTask* TaskProcessor::GetTask(Thread* self) {
 void TaskProcessor::UpdateTargetRunTime(Thread* self, HeapTask* task, uint64_t new_target_time) {
   MutexLock mu(self, lock_);
   // Find the task.
-  auto range = tasks_.equal_range(task);
-  for (auto it = range.first; it != range.second; ++it) {
-    if (*it == task) {
-      // Check if the target time was updated, if so re-insert then wait.
-      if (new_target_time != task->GetTargetRunTime()) {
-        tasks_.erase(it);
-        task->SetTargetRunTime(new_target_time);
-        tasks_.insert(task);
-        // If we became the first task then we may need to signal since we changed the task that we
-        // are sleeping on.
-        if (*tasks_.begin() == task) {
-          cond_.Signal(self);
-        }
-        return;
-      }
-    }
+  auto it = std::find(tasks_.begin(), tasks_.end(), task);
+  if (it != tasks_.end() && new_target_time != task->GetTargetRunTime()) {
+    // Re-establish the heap property with the updated key, then wake the waiter in case the
+    // task now runs before the pending wakeup.
+    task->SetTargetRunTime(new_target_time);
+    std::make_heap(tasks_.begin(), tasks_.end(), CompareByTargetRunTime());
+    MaybeSignal(self, new_target_time);
   }
 }
 
@@ -112,6 +126,7 @@ void TaskProcessor::Stop(Thread* self) {
   MutexLock mu(self, lock_);
   is_running_ = false;
   running_thread_ = nullptr;
+  wakeup_time_ = 0u;
   cond_.Broadcast(self);
 }
 
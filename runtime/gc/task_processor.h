@@ -17,8 +17,9 @@
 #ifndef ART_RUNTIME_GC_TASK_PROCESSOR_H_
 #define ART_RUNTIME_GC_TASK_PROCESSOR_H_
 
+#include <limits>
 #include <memory>
-#include <set>
+#include <vector>
 
 #include "base/mutex.h"
 #include "runtime_globals.h"
@@ -52,7 +53,13 @@ class HeapTask : public SelfDeletingTask {
 // Used to process GC tasks (heap trim, heap transitions, concurrent GC).
 class TaskProcessor {
  public:
-  TaskProcessor();
+  // Tasks whose target run time is within this window of a wakeup are serviced by that wakeup,
+  // so that near-simultaneous background tasks (heap trims, concurrent GC requests) batch into
+  // one daemon wakeup instead of several short sleeps. A task may thus run up to the slack
+  // earlier or later than its target time.
+  static constexpr uint64_t kDefaultSlackNs = 2 * 1000 * 1000;  // 2 ms.
+
+  explicit TaskProcessor(uint64_t slack_ns = kDefaultSlackNs);
   virtual ~TaskProcessor();
   void AddTask(Thread* self, HeapTask* task) REQUIRES(!lock_);
   HeapTask* GetTask(Thread* self) REQUIRES(!lock_);
@@ -67,18 +74,34 @@ class TaskProcessor {
   Thread* GetRunningThread() const REQUIRES(!lock_);
 
  private:
+  // Comparator for the binary min-heap in tasks_; the std::*_heap algorithms build a max-heap,
+  // so order by greater target run time.
   class CompareByTargetRunTime {
    public:
     bool operator()(const HeapTask* a, const HeapTask* b) const {
-      return a->GetTargetRunTime() < b->GetTargetRunTime();
+      return a->GetTargetRunTime() > b->GetTargetRunTime();
     }
   };
 
+  // Wakeup time of a waiter blocked on an empty queue.
+  static constexpr uint64_t kWakeupIndefinite = std::numeric_limits<uint64_t>::max();
+
+  // Signal the waiter in GetTask if it would otherwise sleep past the given target time.
+  void MaybeSignal(Thread* self, uint64_t target_time) REQUIRES(lock_);
+
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ConditionVariable cond_ GUARDED_BY(lock_);
   bool is_running_ GUARDED_BY(lock_);
-  std::multiset<HeapTask*, CompareByTargetRunTime> tasks_ GUARDED_BY(lock_);
+  // Binary min-heap of the pending tasks, ordered by target run time.
+  std::vector<HeapTask*> tasks_ GUARDED_BY(lock_);
   Thread* running_thread_ GUARDED_BY(lock_);
+  // See kDefaultSlackNs.
+  const uint64_t slack_ns_;
+  // Absolute time in ns at which the waiter in GetTask wakes on its own, used to elide signals
+  // for tasks that the pending wakeup will service anyway: 0 when no waiter is sleeping,
+  // kWakeupIndefinite while the waiter blocks on an empty queue. GetTask has a single caller
+  // (the heap task daemon), so there is at most one sleeping waiter to track.
+  uint64_t wakeup_time_ GUARDED_BY(lock_);
 
   DISALLOW_COPY_AND_ASSIGN(TaskProcessor);
 };
@@ -30,23 +30,18 @@
 namespace art {
 
 template<size_t kNumReferences>
-inline FixedSizeHandleScope<kNumReferences>::FixedSizeHandleScope(BaseHandleScope* link,
-                                                                  ObjPtr<mirror::Object> fill_value)
-    : HandleScope(link, kNumReferences) {
+inline FixedSizeHandleScope<kNumReferences>::FixedSizeHandleScope(BaseHandleScope* link)
+    : HandleScope(link, /*num_references=*/ 0u) {
   if (kDebugLocking) {
     Locks::mutator_lock_->AssertSharedHeld(Thread::Current());
   }
   static_assert(kNumReferences >= 1, "FixedSizeHandleScope must contain at least 1 reference");
   DCHECK_EQ(&storage_[0], GetReferences());  // TODO: Figure out how to use a compile assert.
-  for (size_t i = 0; i < kNumReferences; ++i) {
-    SetReference(i, fill_value);
-  }
 }
 
 template<size_t kNumReferences>
-inline StackHandleScope<kNumReferences>::StackHandleScope(Thread* self,
-                                                          ObjPtr<mirror::Object> fill_value)
-    : FixedSizeHandleScope<kNumReferences>(self->GetTopHandleScope(), fill_value),
+inline StackHandleScope<kNumReferences>::StackHandleScope(Thread* self)
+    : FixedSizeHandleScope<kNumReferences>(self->GetTopHandleScope()),
       self_(self) {
   DCHECK_EQ(self, Thread::Current());
   if (kDebugLocking) {
@@ -104,12 +99,9 @@ inline void HandleScope::SetReference(size_t i, ObjPtr<mirror::Object> object) {
 }
 
 inline bool HandleScope::Contains(StackReference<mirror::Object>* handle_scope_entry) const {
-  // A HandleScope should always contain something. One created by the
-  // jni_compiler should have a jobject/jclass as a native method is
-  // passed in a this pointer or a class
-  DCHECK_GT(NumberOfReferences(), 0U);
+  // Only live slots can hand out handles, so an empty scope contains nothing.
   return &GetReferences()[0] <= handle_scope_entry &&
-      handle_scope_entry <= &GetReferences()[number_of_references_ - 1];
+      handle_scope_entry < &GetReferences()[NumberOfReferences()];
 }
 
 template <typename Visitor>
@@ -129,9 +121,13 @@ inline MutableHandle<T> FixedSizeHandleScope<kNumReferences>::NewHandle(T* objec
 template<size_t kNumReferences> template<class MirrorType>
 inline MutableHandle<MirrorType> FixedSizeHandleScope<kNumReferences>::NewHandle(
     ObjPtr<MirrorType> object) {
-  SetReference(pos_, object);
-  MutableHandle<MirrorType> h(GetHandle<MirrorType>(pos_));
-  ++pos_;
+  // Store the reference before growing the live count so that a concurrent
+  // root visit never sees an uninitialized slot.
+  const size_t pos = NumberOfReferences();
+  DCHECK_LT(pos, kNumReferences);
+  SetReference(pos, object);
+  MutableHandle<MirrorType> h(GetHandle<MirrorType>(pos));
+  ++number_of_references_;
   return h;
 }
 
@@ -82,7 +82,9 @@ class PACKED(4) BaseHandleScope {
   BaseHandleScope* const link_;
 
   // Number of handlerized references. -1 for variable sized handle scopes.
-  const int32_t number_of_references_;
+  // Fixed size scopes start at 0 and grow as handles are created, so that
+  // the GC only visits slots that actually hold a reference.
+  int32_t number_of_references_;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(BaseHandleScope);
@@ -191,12 +193,11 @@ class PACKED(4) FixedSizeHandleScope : public HandleScope {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   size_t RemainingSlots() const {
-    return kNumReferences - pos_;
+    return kNumReferences - NumberOfReferences();
   }
 
  private:
-  explicit ALWAYS_INLINE FixedSizeHandleScope(BaseHandleScope* link,
-                                              ObjPtr<mirror::Object> fill_value = nullptr)
+  explicit ALWAYS_INLINE FixedSizeHandleScope(BaseHandleScope* link)
       REQUIRES_SHARED(Locks::mutator_lock_);
   ALWAYS_INLINE ~FixedSizeHandleScope() REQUIRES_SHARED(Locks::mutator_lock_) {}
 
@@ -207,11 +208,10 @@ class PACKED(4) FixedSizeHandleScope : public HandleScope {
   }
 
   // Reference storage needs to be first as expected by the HandleScope layout.
+  // Slots at and above NumberOfReferences() are uninitialized; new handles
+  // bump the live reference count instead of pre-filling the whole array.
   StackReference<mirror::Object> storage_[kNumReferences];
 
-  // Position new handles will be created.
-  uint32_t pos_ = 0;
-
   template<size_t kNumRefs> friend class StackHandleScope;
   friend class VariableSizedHandleScope;
 };
@@ -220,9 +220,7 @@ class PACKED(4) FixedSizeHandleScope : public HandleScope {
 template<size_t kNumReferences>
 class PACKED(4) StackHandleScope final : public FixedSizeHandleScope<kNumReferences> {
  public:
-  explicit ALWAYS_INLINE StackHandleScope(Thread* self,
-                                          ObjPtr<mirror::Object> fill_value = nullptr)
-      REQUIRES_SHARED(Locks::mutator_lock_);
+  explicit ALWAYS_INLINE StackHandleScope(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_);
 
   ALWAYS_INLINE ~StackHandleScope() REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -52,7 +52,8 @@ TEST_F(HandleScopeTest, Offsets) {
   static const size_t kNumReferences = 0x9ABC;
   StackHandleScope<kNumReferences> test_table(soa.Self());
   ObjPtr<mirror::Class> c = class_linker->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
-  test_table.SetReference(0, c.Ptr());
+  EXPECT_EQ(test_table.NumberOfReferences(), 0u);  // Scopes start with no live references.
+  test_table.NewHandle(c);
 
   uint8_t* table_base_ptr = reinterpret_cast<uint8_t*>(&test_table);
 
@@ -65,7 +66,7 @@ TEST_F(HandleScopeTest, Offsets) {
   {
     uint32_t* num_ptr = reinterpret_cast<uint32_t*>(table_base_ptr +
         HandleScope::NumberOfReferencesOffset(kRuntimePointerSize));
-    EXPECT_EQ(*num_ptr, static_cast<size_t>(kNumReferences));
+    EXPECT_EQ(*num_ptr, 1u);  // Only the handle created above is live.
   }
 
   {
@@ -501,10 +501,13 @@ bool ShouldDenyAccessToMemberImpl(T* member, ApiList api_list, AccessMethod acce
   DCHECK(hiddenApiPolicy != EnforcementPolicy::kDisabled)
       << "Should never enter this function when access checks are completely disabled";
 
-  MemberSignature member_signature(member);
-
   // Check for an exemption first. Exempted APIs are treated as SDK.
-  if (member_signature.DoesPrefixMatchAny(runtime->GetHiddenApiExemptions())) {
+  // Note: The exemption list is empty unless the framework has installed one. Do not
+  // build the member signature just to match it against nothing; accesses which do not
+  // log (AccessMethod::kNone) are not memoized in the access flags and would pay for
+  // the signature strings on every evaluation.
+  const std::vector<std::string>& exemptions = runtime->GetHiddenApiExemptions();
+  if (UNLIKELY(!exemptions.empty()) && MemberSignature(member).DoesPrefixMatchAny(exemptions)) {
     // Avoid re-examining the exemption list next time.
     // Note this results in no warning for the member, which seems like what one would expect.
     // Exemptions effectively adds new members to the public API list.
@@ -536,6 +539,8 @@ bool ShouldDenyAccessToMemberImpl(T* member, ApiList api_list, AccessMethod acce
   }
 
   if (access_method != AccessMethod::kNone) {
+    MemberSignature member_signature(member);
+
     // Warn if blocked signature is being accessed or it is not exempted.
     if (deny_access || !member_signature.DoesPrefixMatchAny(kWarningExemptions)) {
       // Print a log message with information about this class member access.
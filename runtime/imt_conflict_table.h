@@ -41,18 +41,22 @@ class ImtConflictTable {
 
  public:
   // Build a new table copying `other` and adding the new entry formed of
-  // the pair { `interface_method`, `implementation_method` }
+  // the pair { `interface_method`, `implementation_method` }.
+  // The new entry is placed first: the runtime only grows the table after the
+  // assembly stub's linear scan missed, so most-recently-used ordering lets
+  // subsequent calls dispatching on the same interface method hit the head of
+  // the walk instead of scanning the whole table again.
   ImtConflictTable(ImtConflictTable* other,
                    ArtMethod* interface_method,
                    ArtMethod* implementation_method,
                    PointerSize pointer_size) {
+    SetInterfaceMethod(0, pointer_size, interface_method);
+    SetImplementationMethod(0, pointer_size, implementation_method);
     const size_t count = other->NumEntries(pointer_size);
     for (size_t i = 0; i < count; ++i) {
-      SetInterfaceMethod(i, pointer_size, other->GetInterfaceMethod(i, pointer_size));
-      SetImplementationMethod(i, pointer_size, other->GetImplementationMethod(i, pointer_size));
+      SetInterfaceMethod(i + 1, pointer_size, other->GetInterfaceMethod(i, pointer_size));
+      SetImplementationMethod(i + 1, pointer_size, other->GetImplementationMethod(i, pointer_size));
     }
-    SetInterfaceMethod(count, pointer_size, interface_method);
-    SetImplementationMethod(count, pointer_size, implementation_method);
     // Add the null marker.
     SetInterfaceMethod(count + 1, pointer_size, nullptr);
     SetImplementationMethod(count + 1, pointer_size, nullptr);
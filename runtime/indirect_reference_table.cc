@@ -74,6 +74,7 @@ IndirectReferenceTable::IndirectReferenceTable(size_t max_count,
       kind_(desired_kind),
       max_entries_(max_count),
       current_num_holes_(0),
+      reserved_entries_end_(0),
       resizable_(resizable) {
   CHECK(error_msg != nullptr);
   CHECK_NE(desired_kind, kJniTransitionOrInvalid);
@@ -261,6 +262,20 @@ IndirectRef IndirectReferenceTable::Add(IRTSegmentState previous_state,
   VerifyObject(obj);
   DCHECK(table_ != nullptr);
 
+  if (LIKELY(top_index < reserved_entries_end_ &&
+             previous_state.top_index == last_known_previous_state_.top_index &&
+             current_num_holes_ == 0)) {
+    // Pre-reserved fast path: the reservation guarantees room below reserved_entries_end_,
+    // and the hole bookkeeping is up to date for this segment with no holes to fill, so
+    // the new reference goes at the top and the add reduces to a pointer bump.
+    table_[top_index].Add(obj);
+    segment_state_.top_index = top_index + 1;
+    if (kDebugIRT) {
+      LOG(INFO) << "+++ added at " << top_index << " (reserved) top=" << segment_state_.top_index;
+    }
+    return ToIndirectRef(top_index);
+  }
+
   if (top_index == max_entries_) {
     if (resizable_ == ResizableCapacity::kNo) {
       std::ostringstream oss;
@@ -394,6 +409,19 @@ bool IndirectReferenceTable::Remove(IRTSegmentState previous_state, IndirectRef
     return false;
   }
 
+  if (LIKELY(idx == top_index - 1 &&
+             idx < reserved_entries_end_ &&
+             previous_state.top_index == last_known_previous_state_.top_index &&
+             current_num_holes_ == 0 &&
+             ToIndirectRef(idx) == iref)) {
+    // Pre-reserved fast path: removing the top-most entry of a segment without holes
+    // just lowers the top index. The full iref comparison subsumes CheckEntry(); a
+    // stale reference falls through to the diagnostic slow path below.
+    *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
+    segment_state_.top_index = idx;
+    return true;
+  }
+
   RecoverHoles(previous_state);
   CheckHoleCount(table_, current_num_holes_, previous_state, segment_state_);
 
@@ -500,6 +528,9 @@ void IndirectReferenceTable::SetSegmentState(IRTSegmentState new_state) {
 bool IndirectReferenceTable::EnsureFreeCapacity(size_t free_capacity, std::string* error_msg) {
   size_t top_index = segment_state_.top_index;
   if (top_index < max_entries_ && top_index + free_capacity <= max_entries_) {
+    if (top_index + free_capacity > reserved_entries_end_) {
+      reserved_entries_end_ = top_index + free_capacity;
+    }
     return true;
   }
 
@@ -524,6 +555,9 @@ bool IndirectReferenceTable::EnsureFreeCapacity(size_t free_capacity, std::strin
                  << " Resizing failed: " << *error_msg;
     return false;
   }
+  if (top_index + free_capacity > reserved_entries_end_) {
+    reserved_entries_end_ = top_index + free_capacity;
+  }
   return true;
 }
 
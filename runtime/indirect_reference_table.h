@@ -320,6 +320,15 @@ class IndirectReferenceTable {
 
   void SetSegmentState(IRTSegmentState new_state);
 
+  // Prime the hole bookkeeping for a fresh segment whose bottom is the current top
+  // index, e.g. right after a local frame push. Adds into the new segment can then
+  // take the reserved pointer-bump fast path immediately instead of falling back
+  // to hole recovery on first use.
+  void NoteFreshSegment() {
+    last_known_previous_state_ = segment_state_;
+    current_num_holes_ = 0;
+  }
+
   static Offset SegmentStateOffset(size_t pointer_size ATTRIBUTE_UNUSED) {
     // Note: Currently segment_state_ is at offset 0. We're testing the expected value in
     //       jni_internal_test to make sure it stays correct. It is not OFFSETOF_MEMBER, as that
@@ -421,6 +430,13 @@ class IndirectReferenceTable {
   size_t current_num_holes_;
   IRTSegmentState last_known_previous_state_;
 
+  // One past the last table index covered by an explicit capacity reservation
+  // (EnsureFreeCapacity, i.e. JNI EnsureLocalCapacity/PushLocalFrame). Adds and
+  // removes below this index in a segment with up-to-date hole bookkeeping skip
+  // the overflow check and hole recovery and reduce to a pointer bump. Never
+  // exceeds max_entries_, so it stays valid across resizes and segment pops.
+  size_t reserved_entries_end_;
+
   // Whether the table's capacity may be resized. As there are no locks used, it is the caller's
   // responsibility to ensure thread-safety.
   ResizableCapacity resizable_;
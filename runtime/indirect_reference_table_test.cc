@@ -512,4 +512,68 @@ TEST_F(IndirectReferenceTableTest, Resize) {
   EXPECT_EQ(irt.Capacity(), kTableMax + 1);
 }
 
+TEST_F(IndirectReferenceTableTest, ReservedFastPath) {
+  // This will lead to error messages in the log.
+  ScopedLogSeverity sls(LogSeverity::FATAL);
+
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableMax = 64;
+
+  StackHandleScope<3> hs(soa.Self());
+  Handle<mirror::Class> c = hs.NewHandle(
+      class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;"));
+  ASSERT_TRUE(c != nullptr);
+  Handle<mirror::Object> obj0 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj0 != nullptr);
+  Handle<mirror::Object> obj1 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj1 != nullptr);
+
+  std::string error_msg;
+  IndirectReferenceTable irt(kTableMax,
+                             kLocal,
+                             IndirectReferenceTable::ResizableCapacity::kYes,
+                             &error_msg);
+  ASSERT_TRUE(irt.IsValid()) << error_msg;
+
+  // Reserve capacity and prime the segment as PushLocalFrame does, so that the
+  // adds and removes below go through the pointer-bump fast path.
+  const IRTSegmentState cookie = kIRTFirstSegment;
+  ASSERT_TRUE(irt.EnsureFreeCapacity(32, &error_msg)) << error_msg;
+  irt.NoteFreshSegment();
+
+  // Bulk adds within the reservation behave like regular adds.
+  IndirectRef irefs[16];
+  for (size_t i = 0; i != 16; ++i) {
+    irefs[i] = irt.Add(cookie, (i % 2 == 0) ? obj0.Get() : obj1.Get(), &error_msg);
+    ASSERT_TRUE(irefs[i] != nullptr) << error_msg;
+  }
+  EXPECT_EQ(irt.Capacity(), 16u);
+  for (size_t i = 0; i != 16; ++i) {
+    EXPECT_OBJ_PTR_EQ((i % 2 == 0) ? obj0.Get() : obj1.Get(), irt.Get(irefs[i]));
+  }
+
+  // Removing from the top collapses the segment as usual, and stale references
+  // are still rejected.
+  for (size_t i = 16; i != 0; --i) {
+    EXPECT_TRUE(irt.Remove(cookie, irefs[i - 1]));
+    EXPECT_FALSE(irt.Remove(cookie, irefs[i - 1])) << "unexpected double removal";
+  }
+  EXPECT_EQ(irt.Capacity(), 0u);
+
+  // A hole in the segment diverts adds off the fast path until it is filled.
+  irefs[0] = irt.Add(cookie, obj0.Get(), &error_msg);
+  irefs[1] = irt.Add(cookie, obj1.Get(), &error_msg);
+  irefs[2] = irt.Add(cookie, obj0.Get(), &error_msg);
+  EXPECT_TRUE(irt.Remove(cookie, irefs[1]));
+  IndirectRef filler = irt.Add(cookie, obj1.Get(), &error_msg);
+  EXPECT_TRUE(filler != nullptr);
+  // The hole was filled, not appended past the top.
+  EXPECT_EQ(irt.Capacity(), 3u);
+  EXPECT_OBJ_PTR_EQ(obj1.Get(), irt.Get(filler));
+  EXPECT_TRUE(irt.Remove(cookie, filler));
+  EXPECT_TRUE(irt.Remove(cookie, irefs[2]));
+  EXPECT_TRUE(irt.Remove(cookie, irefs[0]));
+  EXPECT_EQ(irt.Capacity(), 0u);
+}
+
 }  // namespace art
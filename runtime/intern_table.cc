@@ -289,6 +289,47 @@ ObjPtr<mirror::String> InternTable::InternStrong(ObjPtr<mirror::String> s) {
   return Insert(s, true, false);
 }
 
+void InternTable::InternStrings(ArrayRef<const Handle<mirror::String>> strings,
+                                /*out*/ std::vector<ObjPtr<mirror::String>>* interned) {
+  DCHECK(interned != nullptr);
+  interned->reserve(interned->size() + strings.size());
+  Thread* const self = Thread::Current();
+  MutexLock mu(self, *Locks::intern_table_lock_);
+  if (kDebugLocking) {
+    Locks::mutator_lock_->AssertSharedHeld(self);
+    CHECK_EQ(2u, self->NumberOfHeldMutexes()) << "may only safely hold the mutator lock";
+  }
+  for (const Handle<mirror::String>& string : strings) {
+    DCHECK(string != nullptr);
+    ObjPtr<mirror::String> result;
+    while (true) {
+      // Check the strong table for a match.
+      result = LookupStrongLocked(string.Get());
+      if (result != nullptr) {
+        break;
+      }
+      if ((!kUseReadBarrier && weak_root_state_ != gc::kWeakRootStateNoReadsOrWrites) ||
+          (kUseReadBarrier && self->GetWeakRefAccessEnabled())) {
+        // There is no match in the strong table, check the weak table.
+        ObjPtr<mirror::String> weak = LookupWeakLocked(string.Get());
+        if (weak != nullptr) {
+          // A match was found in the weak table. Promote to the strong table.
+          RemoveWeak(weak);
+          result = InsertStrong(weak);
+        } else {
+          result = InsertStrong(string.Get());
+        }
+        break;
+      }
+      // weak_root_state_ is set to gc::kWeakRootStateNoReadsOrWrites in the GC pause but is only
+      // cleared after SweepSystemWeaks has completed. This is why we need to wait until it is
+      // cleared. The handles keep the strings valid across the suspension.
+      WaitUntilAccessible(self);
+    }
+    interned->push_back(result);
+  }
+}
+
 ObjPtr<mirror::String> InternTable::InternWeak(const char* utf8_data) {
   DCHECK(utf8_data != nullptr);
   return InternWeak(mirror::String::AllocFromModifiedUtf8(Thread::Current(), utf8_data));
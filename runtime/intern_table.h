@@ -18,10 +18,12 @@
 #define ART_RUNTIME_INTERN_TABLE_H_
 
 #include "base/allocator.h"
+#include "base/array_ref.h"
 #include "base/hash_set.h"
 #include "base/mutex.h"
 #include "gc/weak_root_state.h"
 #include "gc_root.h"
+#include "handle.h"
 
 namespace art {
 
@@ -133,6 +135,16 @@ class InternTable {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Roles::uninterruptible_);
 
+  // Interns a batch of potentially new strings in the 'strong' table under a single
+  // lock acquisition, appending the canonical reference for each input string to
+  // `interned` in the input order. May cause thread suspension; the caller provides
+  // handles so that the not yet inserted strings stay valid across a suspension.
+  void InternStrings(ArrayRef<const Handle<mirror::String>> strings,
+                     /*out*/ std::vector<ObjPtr<mirror::String>>* interned)
+      REQUIRES(!Locks::intern_table_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Roles::uninterruptible_);
+
   // Interns a potentially new string in the 'weak' table. May cause thread suspension.
   ObjPtr<mirror::String> InternWeak(const char* utf8_data) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Roles::uninterruptible_);
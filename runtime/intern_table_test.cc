@@ -234,4 +234,26 @@ TEST_F(InternTableTest, LookupStrong) {
   EXPECT_TRUE(lookup_foobbS == nullptr);
 }
 
+TEST_F(InternTableTest, InternStrings) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable intern_table;
+  StackHandleScope<4> hs(soa.Self());
+  Handle<mirror::String> interned_foo(hs.NewHandle(intern_table.InternStrong(3, "foo")));
+  ASSERT_TRUE(interned_foo != nullptr);
+  std::vector<Handle<mirror::String>> strings = {
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "foo")),
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "bar")),
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "bar")),
+  };
+  std::vector<ObjPtr<mirror::String>> interned;
+  intern_table.InternStrings(ArrayRef<const Handle<mirror::String>>(strings), &interned);
+  ASSERT_EQ(3u, interned.size());
+  // The batch returns canonical references: the existing intern for "foo" and a single
+  // canonical "bar" for both duplicates.
+  EXPECT_OBJ_PTR_EQ(interned[0], interned_foo.Get());
+  EXPECT_TRUE(interned[1]->Equals("bar"));
+  EXPECT_OBJ_PTR_EQ(interned[1], interned[2]);
+  EXPECT_OBJ_PTR_EQ(interned[1], intern_table.LookupStrong(soa.Self(), 3, "bar"));
+}
+
 }  // namespace art
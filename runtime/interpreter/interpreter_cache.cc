@@ -29,4 +29,21 @@ bool InterpreterCache::IsCalledFromOwningThread() {
   return Thread::Current()->GetInterpreterCache() == this;
 }
 
+void InterpreterSharedCache::Clear() {
+  for (Entry& entry : data_) {
+    uint32_t version = entry.version.load(std::memory_order_relaxed);
+    if ((version & 1u) != 0u ||
+        !entry.version.compare_exchange_strong(
+            version, version + 1u, std::memory_order_acquire)) {
+      // A concurrent writer owns the slot. It is storing a freshly resolved
+      // entry, which is still valid: clearing happens before the unloaded
+      // dex files go away, so no stale entry can be in flight.
+      continue;
+    }
+    entry.key.store(nullptr, std::memory_order_relaxed);
+    entry.value.store(0u, std::memory_order_relaxed);
+    entry.version.store(version + 2u, std::memory_order_release);
+  }
+}
+
 }  // namespace art
@@ -94,6 +94,80 @@ class ALIGNED(16) InterpreterCache {
   std::array<Entry, kSize> data_;
 };
 
+// Process-wide second-level cache backing the per-thread interpreter caches.
+// It is consulted on a per-thread cache miss, before falling back to full
+// resolution, and refills the per-thread cache on a hit. This helps freshly
+// created threads and large methods whose footprint exceeds the tiny
+// per-thread array.
+//
+// The key-value pairs stored in the cache are:
+//   invoke: The resolved ArtMethod* pointer.
+//   iget/iput/sget/sput: The resolved ArtField* pointer.
+//
+// Unlike the per-thread cache it holds only native pointers and no heap
+// references, so it does not need to be swept during GC. It is cleared
+// together with the per-thread caches whenever any dex file is unloaded.
+//
+// Entries carry a per-slot version counter (seqlock) so concurrent lookups
+// never observe a torn key-value pair; both lookups and stores are best
+// effort and lock-free.
+class InterpreterSharedCache {
+ public:
+  // 8k entries take 192KiB on 64-bit devices; sized to hold the resolution
+  // state of an app's startup paths rather than a single hot method.
+  static constexpr size_t kSize = 8 * 1024;
+
+  ALWAYS_INLINE bool Get(const void* key, /* out */ size_t* value) {
+    Entry& entry = data_[IndexOf(key)];
+    uint32_t version = entry.version.load(std::memory_order_acquire);
+    if ((version & 1u) != 0u || entry.key.load(std::memory_order_relaxed) != key) {
+      return false;
+    }
+    size_t loaded = entry.value.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (entry.version.load(std::memory_order_relaxed) != version) {
+      // Raced with a concurrent writer.
+      return false;
+    }
+    *value = loaded;
+    return true;
+  }
+
+  ALWAYS_INLINE void Set(const void* key, size_t value) {
+    Entry& entry = data_[IndexOf(key)];
+    uint32_t version = entry.version.load(std::memory_order_relaxed);
+    if ((version & 1u) != 0u ||
+        !entry.version.compare_exchange_strong(
+            version, version + 1u, std::memory_order_acquire)) {
+      // Another writer owns the slot; drop the store.
+      return;
+    }
+    entry.key.store(key, std::memory_order_relaxed);
+    entry.value.store(value, std::memory_order_relaxed);
+    entry.version.store(version + 2u, std::memory_order_release);
+  }
+
+  // Clear the whole cache. Called together with the per-thread caches when
+  // dex files are unloaded; see Thread::ClearAllInterpreterCaches.
+  void Clear();
+
+ private:
+  struct Entry {
+    std::atomic<uint32_t> version{0u};
+    std::atomic<const void*> key{nullptr};
+    std::atomic<size_t> value{0u};
+  };
+
+  static ALWAYS_INLINE size_t IndexOf(const void* key) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
+    size_t index = (reinterpret_cast<uintptr_t>(key) >> 2) & (kSize - 1);
+    DCHECK_LT(index, kSize);
+    return index;
+  }
+
+  std::array<Entry, kSize> data_;
+};
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
@@ -46,6 +46,7 @@
 #include "dex/dex_instruction-inl.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "handle_scope-inl.h"
+#include "interpreter_cache.h"
 #include "interpreter_mterp_impl.h"
 #include "interpreter_switch_impl.h"
 #include "jit/jit-inl.h"
@@ -246,8 +247,15 @@ static ALWAYS_INLINE bool DoInvoke(Thread* self,
   InterpreterCache* tls_cache = self->GetInterpreterCache();
   size_t tls_value;
   ArtMethod* resolved_method;
+  InterpreterSharedCache* shared_cache = Runtime::Current()->GetInterpreterSharedCache();
   if (!IsNterpSupported() && LIKELY(tls_cache->Get(inst, &tls_value))) {
     resolved_method = reinterpret_cast<ArtMethod*>(tls_value);
+  } else if (shared_cache->Get(inst, &tls_value)) {
+    // Second-level shared cache hit; refill the thread-local cache.
+    resolved_method = reinterpret_cast<ArtMethod*>(tls_value);
+    if (!IsNterpSupported()) {
+      tls_cache->Set(inst, tls_value);
+    }
   } else {
     ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
     constexpr ClassLinker::ResolveMode resolve_mode =
@@ -262,6 +270,7 @@ static ALWAYS_INLINE bool DoInvoke(Thread* self,
     if (!IsNterpSupported()) {
       tls_cache->Set(inst, reinterpret_cast<size_t>(resolved_method));
     }
+    shared_cache->Set(inst, reinterpret_cast<size_t>(resolved_method));
   }
 
   // Null pointer check and virtual method resolution.
@@ -488,12 +497,29 @@ ALWAYS_INLINE bool DoFieldGet(Thread* self, ShadowFrame& shadow_frame, const Ins
                               uint16_t inst_data) REQUIRES_SHARED(Locks::mutator_lock_) {
   const bool is_static = (find_type == StaticObjectRead) || (find_type == StaticPrimitiveRead);
   const uint32_t field_idx = is_static ? inst->VRegB_21c() : inst->VRegC_22c();
-  ArtField* f =
-      FindFieldFromCode<find_type, do_access_check>(field_idx, shadow_frame.GetMethod(), self,
-                                                    Primitive::ComponentSize(field_type));
-  if (UNLIKELY(f == nullptr)) {
-    CHECK(self->IsExceptionPending());
-    return false;
+  // Try the shared cache before doing the full resolution. The hit path skips
+  // the class initialization check, so static fields only get cached once
+  // their declaring class is visibly initialized.
+  InterpreterSharedCache* shared_cache = Runtime::Current()->GetInterpreterSharedCache();
+  ArtField* f;
+  size_t cached_value;
+  if (!do_access_check && LIKELY(shared_cache->Get(inst, &cached_value))) {
+    f = reinterpret_cast<ArtField*>(cached_value);
+    DCHECK_EQ(f,
+              (FindFieldFromCode<find_type, do_access_check>(
+                  field_idx, shadow_frame.GetMethod(), self,
+                  Primitive::ComponentSize(field_type))));
+  } else {
+    f = FindFieldFromCode<find_type, do_access_check>(field_idx, shadow_frame.GetMethod(), self,
+                                                      Primitive::ComponentSize(field_type));
+    if (UNLIKELY(f == nullptr)) {
+      CHECK(self->IsExceptionPending());
+      return false;
+    }
+    if (!do_access_check &&
+        (!is_static || f->GetDeclaringClass()->IsVisiblyInitialized())) {
+      shared_cache->Set(inst, reinterpret_cast<size_t>(f));
+    }
   }
   ObjPtr<mirror::Object> obj;
   if (is_static) {
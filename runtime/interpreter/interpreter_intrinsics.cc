@@ -16,9 +16,14 @@
 
 #include "interpreter/interpreter_intrinsics.h"
 
+#include <cmath>
+#include <limits>
+
+#include "base/casts.h"
 #include "dex/dex_instruction.h"
 #include "intrinsics_enum.h"
 #include "interpreter/interpreter_common.h"
+#include "mirror/array-inl.h"
 
 namespace art {
 namespace interpreter {
@@ -45,6 +50,12 @@ static ALWAYS_INLINE bool name(ShadowFrame* shadow_frame,           \
 #define BINARY_JI_INTRINSIC(name, op, set) \
     BINARY_INTRINSIC(name, op, GetVRegLong(arg[0]), GetVReg(arg[2]), set)
 
+#define BINARY_FF_INTRINSIC(name, op, set) \
+    BINARY_INTRINSIC(name, op, GetVRegFloat(arg[0]), GetVRegFloat(arg[1]), set)
+
+#define BINARY_DD_INTRINSIC(name, op, set) \
+    BINARY_INTRINSIC(name, op, GetVRegDouble(arg[0]), GetVRegDouble(arg[2]), set)
+
 #define UNARY_INTRINSIC(name, op, get, set)                  \
 static ALWAYS_INLINE bool name(ShadowFrame* shadow_frame,    \
                                const Instruction* inst,      \
@@ -58,6 +69,75 @@ static ALWAYS_INLINE bool name(ShadowFrame* shadow_frame,    \
 }
 
 
+// The non-raw bits conversions collapse every NaN to the canonical quiet NaN
+// bit pattern, matching the Java definitions.
+static inline int64_t DoubleToLongBits(double value) {
+  return std::isnan(value) ? INT64_C(0x7ff8000000000000) : bit_cast<int64_t, double>(value);
+}
+
+static inline int32_t FloatToIntBits(float value) {
+  return std::isnan(value) ? INT32_C(0x7fc00000) : bit_cast<int32_t, float>(value);
+}
+
+// Math.min/max on float/double follow Java semantics rather than C++'s:
+// a NaN operand makes the result NaN and -0.0 is strictly smaller than +0.0.
+template <typename T>
+static ALWAYS_INLINE T JavaFpMin(T a, T b) {
+  if (std::isnan(a) || std::isnan(b)) {
+    return std::numeric_limits<T>::quiet_NaN();
+  }
+  return (b < a || (b == a && std::signbit(b))) ? b : a;
+}
+
+template <typename T>
+static ALWAYS_INLINE T JavaFpMax(T a, T b) {
+  if (std::isnan(a) || std::isnan(b)) {
+    return std::numeric_limits<T>::quiet_NaN();
+  }
+  return (b > a || (b == a && std::signbit(a))) ? b : a;
+}
+
+// Math.round: ties round towards positive infinity; NaN rounds to zero and
+// out-of-range values clamp, following the float-to-integral conversion rules.
+template <typename INT_TYPE, typename FLOAT_TYPE>
+static ALWAYS_INLINE INT_TYPE JavaRound(FLOAT_TYPE value) {
+  FLOAT_TYPE rounded = std::floor(value);
+  if (value - rounded >= static_cast<FLOAT_TYPE>(0.5)) {
+    rounded += static_cast<FLOAT_TYPE>(1.0);
+  }
+  return art_float_to_integral<INT_TYPE, FLOAT_TYPE>(rounded);
+}
+
+// java.lang.Double.doubleToRawLongBits(D)J
+UNARY_INTRINSIC(MterpDoubleDoubleToRawLongBits, (bit_cast<int64_t, double>), GetVRegDouble, SetJ);
+
+// java.lang.Double.doubleToLongBits(D)J
+UNARY_INTRINSIC(MterpDoubleDoubleToLongBits, DoubleToLongBits, GetVRegDouble, SetJ);
+
+// java.lang.Double.isInfinite(D)Z
+UNARY_INTRINSIC(MterpDoubleIsInfinite, std::isinf, GetVRegDouble, SetZ);
+
+// java.lang.Double.isNaN(D)Z
+UNARY_INTRINSIC(MterpDoubleIsNaN, std::isnan, GetVRegDouble, SetZ);
+
+// java.lang.Double.longBitsToDouble(J)D
+UNARY_INTRINSIC(MterpDoubleLongBitsToDouble, (bit_cast<double, int64_t>), GetVRegLong, SetD);
+
+// java.lang.Float.floatToRawIntBits(F)I
+UNARY_INTRINSIC(MterpFloatFloatToRawIntBits, (bit_cast<int32_t, float>), GetVRegFloat, SetI);
+
+// java.lang.Float.floatToIntBits(F)I
+UNARY_INTRINSIC(MterpFloatFloatToIntBits, FloatToIntBits, GetVRegFloat, SetI);
+
+// java.lang.Float.isInfinite(F)Z
+UNARY_INTRINSIC(MterpFloatIsInfinite, std::isinf, GetVRegFloat, SetZ);
+
+// java.lang.Float.isNaN(F)Z
+UNARY_INTRINSIC(MterpFloatIsNaN, std::isnan, GetVRegFloat, SetZ);
+
+// java.lang.Float.intBitsToFloat(I)F
+UNARY_INTRINSIC(MterpFloatIntBitsToFloat, (bit_cast<float, int32_t>), GetVReg, SetF);
+
 // java.lang.Integer.reverse(I)I
 UNARY_INTRINSIC(MterpIntegerReverse, ReverseBits32, GetVReg, SetI);
 
@@ -127,6 +207,38 @@ UNARY_INTRINSIC(MterpLongSignum, Signum, GetVRegLong, SetI);
 // java.lang.Short.reverseBytes(S)S
 UNARY_INTRINSIC(MterpShortReverseBytes, BSWAP, GetVRegShort, SetS);
 
+#define UNSIGNED_DIVIDE_INTRINSIC(name, type, get1, get2, set)        \
+static ALWAYS_INLINE bool name(ShadowFrame* shadow_frame,             \
+                               const Instruction* inst,               \
+                               uint16_t inst_data,                    \
+                               JValue* result_register)               \
+    REQUIRES_SHARED(Locks::mutator_lock_) {                           \
+  uint32_t arg[Instruction::kMaxVarArgRegs] = {};                     \
+  inst->GetVarArgs(arg, inst_data);                                   \
+  type dividend = static_cast<type>(shadow_frame->get1);              \
+  type divisor = static_cast<type>(shadow_frame->get2);               \
+  if (UNLIKELY(divisor == 0)) {                                       \
+    /* Punt and let the non-intrinsic version deal with the throw. */ \
+    return false;                                                     \
+  }                                                                   \
+  result_register->set(dividend / divisor);                           \
+  return true;                                                        \
+}
+
+// java.lang.Integer.divideUnsigned(II)I
+UNSIGNED_DIVIDE_INTRINSIC(MterpIntegerDivideUnsigned,
+                          uint32_t,
+                          GetVReg(arg[0]),
+                          GetVReg(arg[1]),
+                          SetI)
+
+// java.lang.Long.divideUnsigned(JJ)J
+UNSIGNED_DIVIDE_INTRINSIC(MterpLongDivideUnsigned,
+                          uint64_t,
+                          GetVRegLong(arg[0]),
+                          GetVRegLong(arg[2]),
+                          SetJ)
+
 // java.lang.Math.min(II)I
 BINARY_II_INTRINSIC(MterpMathMinIntInt, std::min, SetI);
 
@@ -139,6 +251,18 @@ BINARY_II_INTRINSIC(MterpMathMaxIntInt, std::max, SetI);
 // java.lang.Math.max(JJ)J
 BINARY_JJ_INTRINSIC(MterpMathMaxLongLong, std::max, SetJ);
 
+// java.lang.Math.min(FF)F
+BINARY_FF_INTRINSIC(MterpMathMinFloatFloat, JavaFpMin, SetF);
+
+// java.lang.Math.min(DD)D
+BINARY_DD_INTRINSIC(MterpMathMinDoubleDouble, JavaFpMin, SetD);
+
+// java.lang.Math.max(FF)F
+BINARY_FF_INTRINSIC(MterpMathMaxFloatFloat, JavaFpMax, SetF);
+
+// java.lang.Math.max(DD)D
+BINARY_DD_INTRINSIC(MterpMathMaxDoubleDouble, JavaFpMax, SetD);
+
 // java.lang.Math.abs(I)I
 UNARY_INTRINSIC(MterpMathAbsInt, std::abs, GetVReg, SetI);
 
@@ -178,6 +302,51 @@ UNARY_INTRINSIC(MterpMathAcos, std::acos, GetVRegDouble, SetD);
 // java.lang.Math.atan(D)D
 UNARY_INTRINSIC(MterpMathAtan, std::atan, GetVRegDouble, SetD);
 
+// java.lang.Math.atan2(DD)D
+BINARY_DD_INTRINSIC(MterpMathAtan2, std::atan2, SetD);
+
+// java.lang.Math.cbrt(D)D
+UNARY_INTRINSIC(MterpMathCbrt, std::cbrt, GetVRegDouble, SetD);
+
+// java.lang.Math.cosh(D)D
+UNARY_INTRINSIC(MterpMathCosh, std::cosh, GetVRegDouble, SetD);
+
+// java.lang.Math.exp(D)D
+UNARY_INTRINSIC(MterpMathExp, std::exp, GetVRegDouble, SetD);
+
+// java.lang.Math.expm1(D)D
+UNARY_INTRINSIC(MterpMathExpm1, std::expm1, GetVRegDouble, SetD);
+
+// java.lang.Math.hypot(DD)D
+BINARY_DD_INTRINSIC(MterpMathHypot, std::hypot, SetD);
+
+// java.lang.Math.log(D)D
+UNARY_INTRINSIC(MterpMathLog, std::log, GetVRegDouble, SetD);
+
+// java.lang.Math.log10(D)D
+UNARY_INTRINSIC(MterpMathLog10, std::log10, GetVRegDouble, SetD);
+
+// java.lang.Math.nextAfter(DD)D
+BINARY_DD_INTRINSIC(MterpMathNextAfter, std::nextafter, SetD);
+
+// java.lang.Math.pow(DD)D
+BINARY_DD_INTRINSIC(MterpMathPow, std::pow, SetD);
+
+// java.lang.Math.sinh(D)D
+UNARY_INTRINSIC(MterpMathSinh, std::sinh, GetVRegDouble, SetD);
+
+// java.lang.Math.tanh(D)D
+UNARY_INTRINSIC(MterpMathTanh, std::tanh, GetVRegDouble, SetD);
+
+// java.lang.Math.rint(D)D
+UNARY_INTRINSIC(MterpMathRint, std::rint, GetVRegDouble, SetD);
+
+// java.lang.Math.round(D)J
+UNARY_INTRINSIC(MterpMathRoundDouble, (JavaRound<int64_t, double>), GetVRegDouble, SetJ);
+
+// java.lang.Math.round(F)I
+UNARY_INTRINSIC(MterpMathRoundFloat, (JavaRound<int32_t, float>), GetVRegFloat, SetI);
+
 // java.lang.String.charAt(I)C
 static ALWAYS_INLINE bool MterpStringCharAt(ShadowFrame* shadow_frame,
                                             const Instruction* inst,
@@ -323,6 +492,55 @@ static ALWAYS_INLINE bool MterpStringEquals(ShadowFrame* shadow_frame,
   return true;
 }
 
+// java.lang.System.arraycopy(Ljava/lang/Object;ILjava/lang/Object;II)V
+static ALWAYS_INLINE bool MterpSystemArrayCopy(ShadowFrame* shadow_frame,
+                                               const Instruction* inst,
+                                               uint16_t inst_data,
+                                               JValue* result_register ATTRIBUTE_UNUSED)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  uint32_t arg[Instruction::kMaxVarArgRegs] = {};
+  inst->GetVarArgs(arg, inst_data);
+  ObjPtr<mirror::Object> src_obj = shadow_frame->GetVRegReference(arg[0]);
+  ObjPtr<mirror::Object> dst_obj = shadow_frame->GetVRegReference(arg[2]);
+  // Only handle primitive arrays of the same type; everything else (null
+  // references, object arrays needing assignability checks and write
+  // barriers, type mismatches) punts to the Java implementation which
+  // performs the full checks and throws the proper exceptions.
+  if (src_obj == nullptr || dst_obj == nullptr) {
+    return false;
+  }
+  ObjPtr<mirror::Class> klass = src_obj->GetClass();
+  if (klass != dst_obj->GetClass() || !klass->IsPrimitiveArray()) {
+    return false;
+  }
+  ObjPtr<mirror::Array> src = src_obj->AsArray();
+  ObjPtr<mirror::Array> dst = dst_obj->AsArray();
+  int32_t src_pos = shadow_frame->GetVReg(arg[1]);
+  int32_t dst_pos = shadow_frame->GetVReg(arg[3]);
+  int32_t length = shadow_frame->GetVReg(arg[4]);
+  if (UNLIKELY(src_pos < 0 || dst_pos < 0 || length < 0 ||
+               static_cast<int64_t>(src_pos) + length > src->GetLength() ||
+               static_cast<int64_t>(dst_pos) + length > dst->GetLength())) {
+    return false;  // Punt and let the non-intrinsic version deal with the throw.
+  }
+  size_t width = klass->GetComponentSize();
+  // memmove handles the overlapping same-array case and is vectorized by the
+  // C library, so large short[]/byte[] table copies go through SIMD code.
+  memmove(dst->GetRawData(width, dst_pos), src->GetRawData(width, src_pos), length * width);
+  return true;
+}
+
+// java.lang.System.arraycopy([CI[CII)V
+static ALWAYS_INLINE bool MterpSystemArrayCopyChar(ShadowFrame* shadow_frame,
+                                                   const Instruction* inst,
+                                                   uint16_t inst_data,
+                                                   JValue* result_register)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  // Same register layout as the generic version; the common helper verifies
+  // that both references are char arrays.
+  return MterpSystemArrayCopy(shadow_frame, inst, inst_data, result_register);
+}
+
 #define VARHANDLE_FENCE_INTRINSIC(name, std_memory_operation)              \
 static ALWAYS_INLINE bool name(ShadowFrame* shadow_frame ATTRIBUTE_UNUSED, \
                                const Instruction* inst ATTRIBUTE_UNUSED,   \
@@ -429,18 +647,18 @@ bool MterpHandleIntrinsic(ShadowFrame* shadow_frame,
   Intrinsics intrinsic = static_cast<Intrinsics>(called_method->GetIntrinsic());
   bool res = false;  // Assume failure
   switch (intrinsic) {
-    UNIMPLEMENTED_CASE(DoubleDoubleToRawLongBits /* (D)J */)
-    UNIMPLEMENTED_CASE(DoubleDoubleToLongBits /* (D)J */)
-    UNIMPLEMENTED_CASE(DoubleIsInfinite /* (D)Z */)
-    UNIMPLEMENTED_CASE(DoubleIsNaN /* (D)Z */)
-    UNIMPLEMENTED_CASE(DoubleLongBitsToDouble /* (J)D */)
-    UNIMPLEMENTED_CASE(FloatFloatToRawIntBits /* (F)I */)
-    UNIMPLEMENTED_CASE(FloatFloatToIntBits /* (F)I */)
-    UNIMPLEMENTED_CASE(FloatIsInfinite /* (F)Z */)
-    UNIMPLEMENTED_CASE(FloatIsNaN /* (F)Z */)
-    UNIMPLEMENTED_CASE(FloatIntBitsToFloat /* (I)F */)
-    UNIMPLEMENTED_CASE(IntegerDivideUnsigned /* (II)I */)
-    UNIMPLEMENTED_CASE(LongDivideUnsigned /* (JJ)J */)
+    INTRINSIC_CASE(DoubleDoubleToRawLongBits)
+    INTRINSIC_CASE(DoubleDoubleToLongBits)
+    INTRINSIC_CASE(DoubleIsInfinite)
+    INTRINSIC_CASE(DoubleIsNaN)
+    INTRINSIC_CASE(DoubleLongBitsToDouble)
+    INTRINSIC_CASE(FloatFloatToRawIntBits)
+    INTRINSIC_CASE(FloatFloatToIntBits)
+    INTRINSIC_CASE(FloatIsInfinite)
+    INTRINSIC_CASE(FloatIsNaN)
+    INTRINSIC_CASE(FloatIntBitsToFloat)
+    INTRINSIC_CASE(IntegerDivideUnsigned)
+    INTRINSIC_CASE(LongDivideUnsigned)
     INTRINSIC_CASE(IntegerReverse)
     INTRINSIC_CASE(IntegerReverseBytes)
     INTRINSIC_CASE(IntegerBitCount)
@@ -468,12 +686,12 @@ bool MterpHandleIntrinsic(ShadowFrame* shadow_frame,
     INTRINSIC_CASE(MathAbsFloat)
     INTRINSIC_CASE(MathAbsLong)
     INTRINSIC_CASE(MathAbsInt)
-    UNIMPLEMENTED_CASE(MathMinDoubleDouble /* (DD)D */)
-    UNIMPLEMENTED_CASE(MathMinFloatFloat /* (FF)F */)
+    INTRINSIC_CASE(MathMinDoubleDouble)
+    INTRINSIC_CASE(MathMinFloatFloat)
     INTRINSIC_CASE(MathMinLongLong)
     INTRINSIC_CASE(MathMinIntInt)
-    UNIMPLEMENTED_CASE(MathMaxDoubleDouble /* (DD)D */)
-    UNIMPLEMENTED_CASE(MathMaxFloatFloat /* (FF)F */)
+    INTRINSIC_CASE(MathMaxDoubleDouble)
+    INTRINSIC_CASE(MathMaxFloatFloat)
     INTRINSIC_CASE(MathMaxLongLong)
     INTRINSIC_CASE(MathMaxIntInt)
     INTRINSIC_CASE(MathCos)
@@ -481,28 +699,28 @@ bool MterpHandleIntrinsic(ShadowFrame* shadow_frame,
     INTRINSIC_CASE(MathAcos)
     INTRINSIC_CASE(MathAsin)
     INTRINSIC_CASE(MathAtan)
-    UNIMPLEMENTED_CASE(MathAtan2 /* (DD)D */)
-    UNIMPLEMENTED_CASE(MathCbrt /* (D)D */)
-    UNIMPLEMENTED_CASE(MathCosh /* (D)D */)
-    UNIMPLEMENTED_CASE(MathExp /* (D)D */)
-    UNIMPLEMENTED_CASE(MathExpm1 /* (D)D */)
-    UNIMPLEMENTED_CASE(MathHypot /* (DD)D */)
-    UNIMPLEMENTED_CASE(MathLog /* (D)D */)
-    UNIMPLEMENTED_CASE(MathLog10 /* (D)D */)
-    UNIMPLEMENTED_CASE(MathNextAfter /* (DD)D */)
-    UNIMPLEMENTED_CASE(MathPow /* (DD)D */)
-    UNIMPLEMENTED_CASE(MathSinh /* (D)D */)
+    INTRINSIC_CASE(MathAtan2)
+    INTRINSIC_CASE(MathCbrt)
+    INTRINSIC_CASE(MathCosh)
+    INTRINSIC_CASE(MathExp)
+    INTRINSIC_CASE(MathExpm1)
+    INTRINSIC_CASE(MathHypot)
+    INTRINSIC_CASE(MathLog)
+    INTRINSIC_CASE(MathLog10)
+    INTRINSIC_CASE(MathNextAfter)
+    INTRINSIC_CASE(MathPow)
+    INTRINSIC_CASE(MathSinh)
     INTRINSIC_CASE(MathTan)
-    UNIMPLEMENTED_CASE(MathTanh /* (D)D */)
+    INTRINSIC_CASE(MathTanh)
     INTRINSIC_CASE(MathSqrt)
     INTRINSIC_CASE(MathCeil)
     INTRINSIC_CASE(MathFloor)
-    UNIMPLEMENTED_CASE(MathRint /* (D)D */)
-    UNIMPLEMENTED_CASE(MathRoundDouble /* (D)J */)
-    UNIMPLEMENTED_CASE(MathRoundFloat /* (F)I */)
+    INTRINSIC_CASE(MathRint)
+    INTRINSIC_CASE(MathRoundDouble)
+    INTRINSIC_CASE(MathRoundFloat)
     UNIMPLEMENTED_CASE(MathMultiplyHigh /* (JJ)J */)
-    UNIMPLEMENTED_CASE(SystemArrayCopyChar /* ([CI[CII)V */)
-    UNIMPLEMENTED_CASE(SystemArrayCopy /* (Ljava/lang/Object;ILjava/lang/Object;II)V */)
+    INTRINSIC_CASE(SystemArrayCopyChar)
+    INTRINSIC_CASE(SystemArrayCopy)
     UNIMPLEMENTED_CASE(ThreadCurrentThread /* ()Ljava/lang/Thread; */)
     UNIMPLEMENTED_CASE(MemoryPeekByte /* (J)B */)
     UNIMPLEMENTED_CASE(MemoryPeekIntNative /* (J)I */)
@@ -1823,6 +1823,22 @@ class InstructionHandler {
 #define ASAN_NO_INLINE ALWAYS_INLINE
 #endif
 
+// Use direct-threaded dispatch (computed goto) instead of a single switch.
+// Every handler then ends in its own indirect branch, giving the branch
+// predictor one entry per opcode transition instead of a single shared one,
+// which matters for interpreter-heavy host workloads where mterp is not used.
+// Relies on the labels-as-values GNU extension; can be overridden at build
+// time with -DART_USE_COMPUTED_GOTO_INTERPRETER=0. Disabled under the
+// sanitizers where the replicated dispatch makes the frame even bigger.
+#ifndef ART_USE_COMPUTED_GOTO_INTERPRETER
+#if (defined(__clang__) || defined(__GNUC__)) && \
+    !defined(ADDRESS_SANITIZER) && !defined(HWADDRESS_SANITIZER)
+#define ART_USE_COMPUTED_GOTO_INTERPRETER 1
+#else
+#define ART_USE_COMPUTED_GOTO_INTERPRETER 0
+#endif
+#endif
+
 #define OPCODE_CASE(OPCODE, OPCODE_NAME, NAME, FORMAT, i, a, e, v)                                \
 template<bool do_access_check, bool transaction_active>                                           \
 ASAN_NO_INLINE static bool OP_##OPCODE_NAME(                                                      \
@@ -1858,6 +1874,78 @@ void ExecuteSwitchImplCpp(SwitchImplContext* ctx) {
       << "Entered interpreter from invoke without retry instruction being handled!";
 
   bool const interpret_one_instruction = ctx->interpret_one_instruction;
+#if ART_USE_COMPUTED_GOTO_INTERPRETER
+  static const void* const kDispatchTable[] = {
+#define OPCODE_LABEL(OPCODE, OPCODE_NAME, NAME, FORMAT, i, a, e, v) &&op_##OPCODE_NAME,
+    DEX_INSTRUCTION_LIST(OPCODE_LABEL)
+#undef OPCODE_LABEL
+  };
+  static_assert(sizeof(kDispatchTable) / sizeof(kDispatchTable[0]) == 256u,
+                "Dispatch table must cover all opcodes");
+  const Instruction* inst;
+  uint16_t inst_data;
+  bool exit = false;
+  bool success;  // Moved outside to keep frames small under asan.
+
+  // Fetch the instruction `next` points at, run the preamble and jump to the
+  // opcode handler. Leaves through `handler_done` when the preamble requests
+  // the slow path.
+#define DISPATCH()                                                                                \
+  do {                                                                                            \
+    inst = next;                                                                                  \
+    dex_pc = inst->GetDexPc(insns);                                                               \
+    shadow_frame.SetDexPC(dex_pc);                                                                \
+    TraceExecution(shadow_frame, inst, dex_pc);                                                   \
+    inst_data = inst->Fetch16(0);                                                                 \
+    exit = false;                                                                                 \
+    if (LIKELY(InstructionHandler<do_access_check, transaction_active,                            \
+                                  Instruction::kInvalidFormat>(                                   \
+            ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit).       \
+            Preamble())) {                                                                        \
+      DCHECK_EQ(self->IsExceptionPending(),                                                       \
+                inst->Opcode(inst_data) == Instruction::MOVE_EXCEPTION);                          \
+      goto* kDispatchTable[inst->Opcode(inst_data)];                                              \
+    }                                                                                             \
+    goto handler_done;                                                                            \
+  } while (false)
+
+  DISPATCH();
+
+#define OPCODE_CASE(OPCODE, OPCODE_NAME, NAME, FORMAT, i, a, e, v)                                \
+  op_##OPCODE_NAME: {                                                                             \
+    next = inst->RelativeAt(Instruction::SizeInCodeUnits(Instruction::FORMAT));                   \
+    success = OP_##OPCODE_NAME<do_access_check, transaction_active>(                              \
+        ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit);           \
+    if (success && LIKELY(!interpret_one_instruction)) {                                          \
+      DISPATCH();                                                                                 \
+    }                                                                                             \
+    goto handler_done;                                                                            \
+  }
+  DEX_INSTRUCTION_LIST(OPCODE_CASE)
+#undef OPCODE_CASE
+
+handler_done:
+  if (exit) {
+    shadow_frame.SetDexPC(dex::kDexNoIndex);
+    return;  // Return statement or debugger forced exit.
+  }
+  if (self->IsExceptionPending()) {
+    if (!InstructionHandler<do_access_check, transaction_active, Instruction::kInvalidFormat>(
+            ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit).
+            HandlePendingException()) {
+      shadow_frame.SetDexPC(dex::kDexNoIndex);
+      return;  // Locally unhandled exception - return to caller.
+    }
+    // Continue execution in the catch block.
+  }
+  if (interpret_one_instruction) {
+    shadow_frame.SetDexPC(next->GetDexPc(insns));  // Record where we stopped.
+    ctx->result = ctx->result_register;
+    return;
+  }
+  DISPATCH();
+#undef DISPATCH
+#else  // !ART_USE_COMPUTED_GOTO_INTERPRETER
   while (true) {
     const Instruction* const inst = next;
     dex_pc = inst->GetDexPc(insns);
@@ -1904,6 +1992,7 @@ void ExecuteSwitchImplCpp(SwitchImplContext* ctx) {
       return;
     }
   }
+#endif  // ART_USE_COMPUTED_GOTO_INTERPRETER
 }  // NOLINT(readability/fn_size)
 
 }  // namespace interpreter
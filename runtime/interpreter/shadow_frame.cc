@@ -17,9 +17,60 @@
 #include "shadow_frame.h"
 
 #include "art_method-inl.h"
+#include "shadow_frame_pool.h"
+#include "thread-inl.h"
 
 namespace art {
 
+ShadowFramePool::~ShadowFramePool() {
+  for (std::vector<uint8_t*>& free_list : free_lists_) {
+    for (uint8_t* memory : free_list) {
+      delete[] memory;
+    }
+  }
+}
+
+uint8_t* ShadowFramePool::Alloc(uint32_t num_vregs) {
+  const size_t bucket = BucketIndex(num_vregs);
+  if (bucket >= kNumBuckets) {
+    // Too large to pool; allocate the exact size.
+    return new uint8_t[ShadowFrame::ComputeSize(num_vregs)];
+  }
+  std::vector<uint8_t*>& free_list = free_lists_[bucket];
+  if (!free_list.empty()) {
+    uint8_t* memory = free_list.back();
+    free_list.pop_back();
+    return memory;
+  }
+  // Allocate at the bucket's maximum size so the chunk can be reused for any
+  // frame mapping to this bucket.
+  return new uint8_t[ShadowFrame::ComputeSize(BucketMaxVRegs(bucket))];
+}
+
+void ShadowFramePool::Free(uint8_t* memory, uint32_t num_vregs) {
+  const size_t bucket = BucketIndex(num_vregs);
+  if (bucket < kNumBuckets && free_lists_[bucket].size() < kMaxFramesPerBucket) {
+    free_lists_[bucket].push_back(memory);
+    return;
+  }
+  delete[] memory;
+}
+
+ShadowFrame* ShadowFrame::CreateDeoptimizedFrame(uint32_t num_vregs,
+                                                 ShadowFrame* link,
+                                                 ArtMethod* method,
+                                                 uint32_t dex_pc) {
+  uint8_t* memory = Thread::Current()->GetShadowFramePool()->Alloc(num_vregs);
+  return CreateShadowFrameImpl(num_vregs, link, method, dex_pc, memory);
+}
+
+void ShadowFrame::DeleteDeoptimizedFrame(ShadowFrame* sf) {
+  const uint32_t num_vregs = sf->NumberOfVRegs();
+  sf->~ShadowFrame();  // Explicitly destruct.
+  uint8_t* memory = reinterpret_cast<uint8_t*>(sf);
+  Thread::Current()->GetShadowFramePool()->Free(memory, num_vregs);
+}
+
 mirror::Object* ShadowFrame::GetThisObject() const {
   ArtMethod* m = GetMethod();
   if (m->IsStatic()) {
@@ -71,19 +71,14 @@ class ShadowFrame {
            (sizeof(StackReference<mirror::Object>) * num_vregs);
   }
 
-  // Create ShadowFrame in heap for deoptimization.
+  // Create ShadowFrame in heap for deoptimization. The memory comes from the
+  // calling thread's shadow frame pool.
   static ShadowFrame* CreateDeoptimizedFrame(uint32_t num_vregs, ShadowFrame* link,
-                                             ArtMethod* method, uint32_t dex_pc) {
-    uint8_t* memory = new uint8_t[ComputeSize(num_vregs)];
-    return CreateShadowFrameImpl(num_vregs, link, method, dex_pc, memory);
-  }
+                                             ArtMethod* method, uint32_t dex_pc);
 
-  // Delete a ShadowFrame allocated on the heap for deoptimization.
-  static void DeleteDeoptimizedFrame(ShadowFrame* sf) {
-    sf->~ShadowFrame();  // Explicitly destruct.
-    uint8_t* memory = reinterpret_cast<uint8_t*>(sf);
-    delete[] memory;
-  }
+  // Delete a ShadowFrame allocated on the heap for deoptimization. The memory
+  // is returned to the calling thread's shadow frame pool.
+  static void DeleteDeoptimizedFrame(ShadowFrame* sf);
 
   // Create a shadow frame in a fresh alloca. This needs to be in the context of the caller.
   // Inlining doesn't work, the compiler will still undo the alloca. So this needs to be a macro.
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_INTERPRETER_SHADOW_FRAME_POOL_H_
+#define ART_RUNTIME_INTERPRETER_SHADOW_FRAME_POOL_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace art {
+
+// Per-thread freelist pool for heap-allocated shadow frames, bucketed by vreg
+// count. Deoptimization and instrumentation can create and destroy shadow
+// frames at a high rate (one per interpreted frame of the deoptimized stack),
+// and going through malloc for each of them is measurable in deopt-heavy
+// debugging sessions. The pool is only used from the owning thread, so it
+// needs no locking. Memory not reclaimed through Free is released when the
+// thread exits.
+class ShadowFramePool {
+ public:
+  // Each bucket covers kVRegsPerBucket consecutive vreg counts; chunks are
+  // allocated at the bucket's maximum size so they can be reused for any
+  // frame that maps to the bucket. Frames with more vregs than the last
+  // bucket covers fall back to plain new/delete.
+  static constexpr uint32_t kVRegsPerBucket = 16;
+  static constexpr size_t kNumBuckets = 8;
+  // Deoptimized stacks are walked one frame at a time, so only a few frames
+  // per bucket are ever live; cap the freelists to bound retained memory.
+  static constexpr size_t kMaxFramesPerBucket = 4;
+
+  ShadowFramePool() {}
+  ~ShadowFramePool();
+
+  // Return memory large enough for a shadow frame with `num_vregs` vregs,
+  // reusing a pooled chunk when one is available.
+  uint8_t* Alloc(uint32_t num_vregs);
+
+  // Return frame memory obtained from Alloc back to the pool, or free it if
+  // the bucket is full or the frame is too large to pool.
+  void Free(uint8_t* memory, uint32_t num_vregs);
+
+ private:
+  static size_t BucketIndex(uint32_t num_vregs) {
+    return num_vregs / kVRegsPerBucket;
+  }
+
+  // The largest vreg count served by the given bucket; chunks are sized for it.
+  static uint32_t BucketMaxVRegs(size_t bucket) {
+    return static_cast<uint32_t>((bucket + 1u) * kVRegsPerBucket - 1u);
+  }
+
+  std::array<std::vector<uint8_t*>, kNumBuckets> free_lists_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShadowFramePool);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERPRETER_SHADOW_FRAME_POOL_H_
@@ -135,9 +135,25 @@ static void UnstartedRuntimeFindClass(Thread* self,
     REQUIRES_SHARED(Locks::mutator_lock_) {
   CHECK(className != nullptr);
   std::string descriptor(DotToDescriptor(className->ToModifiedUtf8().c_str()));
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  Runtime* runtime = Runtime::Current();
+  ClassLinker* class_linker = runtime->GetClassLinker();
 
-  ObjPtr<mirror::Class> found = class_linker->FindClass(self, descriptor.c_str(), class_loader);
+  // Class initializers for the framework jars resolve the same class names
+  // over and over; consult the transaction's memo table before asking the
+  // class linker. Only boot class loader lookups are memoized.
+  Transaction* transaction = (runtime->IsActiveTransaction() && class_loader == nullptr)
+      ? runtime->GetTransaction().get()
+      : nullptr;
+  ObjPtr<mirror::Class> found = nullptr;
+  if (transaction != nullptr) {
+    found = transaction->GetResolvedClassMemo(descriptor);
+  }
+  if (found == nullptr) {
+    found = class_linker->FindClass(self, descriptor.c_str(), class_loader);
+    if (found != nullptr && transaction != nullptr) {
+      transaction->MemoizeResolvedClass(descriptor, found);
+    }
+  }
   if (found != nullptr && initialize_class) {
     StackHandleScope<1> hs(self);
     HandleWrapperObjPtr<mirror::Class> h_class = hs.NewHandleWrapper(&found);
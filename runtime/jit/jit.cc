@@ -19,12 +19,14 @@
 #include <dlfcn.h>
 
 #include "art_method-inl.h"
+#include "base/casts.h"
 #include "base/enums.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/memfd.h"
 #include "base/memory_tool.h"
 #include "base/runtime_debug.h"
+#include "base/safe_map.h"
 #include "base/scoped_flock.h"
 #include "base/utils.h"
 #include "class_root-inl.h"
@@ -73,6 +75,11 @@ static constexpr uint32_t kJitStressDefaultCompileThreshold = 2 * kJitSamplesBat
 // Slow-debug build.
 static constexpr uint32_t kJitSlowStressDefaultCompileThreshold = 2;
 
+// The baseline tier defaults to one tenth of the compile threshold: cheap baseline code gets
+// methods out of the interpreter early, and its own hotness counter promotes the hot ones to an
+// optimized compile (see Jit::EnqueueOptimizedCompilation).
+static constexpr uint32_t kJitDefaultBaselineTierRatio = 10;
+
 // Different warm-up threshold constants. These default to the equivalent compile thresholds divided
 // by 2, but can be overridden at the command-line.
 static constexpr uint32_t kJitDefaultWarmUpThreshold = kJitDefaultCompileThreshold / 2;
@@ -167,6 +174,21 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
                    jit_options->compile_threshold_ - kJitThresholdStep);
   }
 
+  if (options.Exists(RuntimeArgumentMap::JITBaselineThreshold)) {
+    jit_options->baseline_threshold_ = *options.Get(RuntimeArgumentMap::JITBaselineThreshold);
+  } else {
+    jit_options->baseline_threshold_ =
+        jit_options->compile_threshold_ / kJitDefaultBaselineTierRatio;
+  }
+  jit_options->baseline_threshold_ = RoundUp(jit_options->baseline_threshold_, kJitThresholdStep);
+  if (jit_options->compile_threshold_ != 0) {
+    // Clamp such that baseline <= compile. A baseline threshold equal to the compile threshold
+    // disables the early tier (see Jit::MaybeCompileMethod).
+    jit_options->baseline_threshold_ = std::clamp(jit_options->baseline_threshold_,
+                                                  kJitThresholdStep,
+                                                  jit_options->compile_threshold_);
+  }
+
   if (options.Exists(RuntimeArgumentMap::JITPriorityThreadWeight)) {
     jit_options->priority_thread_weight_ =
         *options.Get(RuntimeArgumentMap::JITPriorityThreadWeight);
@@ -770,9 +792,39 @@ class JitCompileTask final : public Task {
     kPreCompile,
   };
 
+  // Relative order in which queued compilation requests are served. OSR requests
+  // come first as a loop is currently stuck in the interpreter, followed by
+  // regular hot-method requests and profile-driven pre-compilation, where
+  // methods the profile flags as startup come before post-startup ones.
+  enum Priority : uint32_t {
+    kPriorityPreCompile = 0u,
+    kPriorityPreCompileStartup = 1u,
+    kPriorityBaseline = 2u,
+    kPriorityOptimized = 3u,
+    kPriorityOsr = 4u,
+  };
+
   JitCompileTask(ArtMethod* method, TaskKind task_kind, CompilationKind compilation_kind)
-      : method_(method), kind_(task_kind), compilation_kind_(compilation_kind), klass_(nullptr) {
+      : JitCompileTask(method,
+                       task_kind,
+                       compilation_kind,
+                       ComputePriority(task_kind, compilation_kind)) {}
+
+  JitCompileTask(ArtMethod* method,
+                 TaskKind task_kind,
+                 CompilationKind compilation_kind,
+                 Priority priority)
+      : method_(method),
+        kind_(task_kind),
+        compilation_kind_(compilation_kind),
+        priority_(priority),
+        klass_(nullptr) {
     ScopedObjectAccess soa(Thread::Current());
+    // Remember the declaring class identity so the JIT thread pool can batch
+    // methods of the same class together. The dex file and class def index are
+    // stable even when the heap moves the class object.
+    declaring_class_dex_file_ = &method->GetDeclaringClass()->GetDexFile();
+    declaring_class_def_index_ = method->GetDeclaringClass()->GetDexClassDefIndex();
     // For a non-bootclasspath class, add a global ref to the class to prevent class unloading
     // until compilation is done.
     // When we precompile, this is either with boot classpath methods, or main
@@ -813,15 +865,100 @@ class JitCompileTask final : public Task {
     delete this;
   }
 
+  uint32_t GetPriority() const {
+    return priority_;
+  }
+
+  bool SameDeclaringClass(const JitCompileTask& other) const {
+    return declaring_class_dex_file_ == other.declaring_class_dex_file_ &&
+        declaring_class_def_index_ == other.declaring_class_def_index_;
+  }
+
  private:
+  static Priority ComputePriority(TaskKind task_kind, CompilationKind compilation_kind) {
+    if (task_kind == TaskKind::kPreCompile) {
+      return kPriorityPreCompile;
+    }
+    switch (compilation_kind) {
+      case CompilationKind::kBaseline:
+        return kPriorityBaseline;
+      case CompilationKind::kOptimized:
+        return kPriorityOptimized;
+      case CompilationKind::kOsr:
+        return kPriorityOsr;
+    }
+  }
+
   ArtMethod* const method_;
   const TaskKind kind_;
   const CompilationKind compilation_kind_;
+  const uint32_t priority_;
+  const DexFile* declaring_class_dex_file_;
+  uint16_t declaring_class_def_index_;
   jobject klass_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
 
+// A thread pool which serves queued compilation requests by priority and keeps
+// requests for methods of the same class next to each other, so a worker
+// compiles them back to back while the verification and resolution state of
+// the class is still warm. Control tasks added through the regular `AddTask`
+// keep their FIFO position.
+class JitThreadPool final : public ThreadPool {
+ public:
+  JitThreadPool(const char* name, size_t num_threads, bool create_peers)
+      : ThreadPool(name, num_threads, create_peers) {}
+
+  void AddCompileTask(Thread* self, JitCompileTask* task) REQUIRES(!task_queue_lock_) {
+    const uint32_t priority = task->GetPriority();
+    MutexLock mu(self, task_queue_lock_);
+    // Insert before the first queued compilation request with a lower priority,
+    // or right after the last request for the same class if that comes earlier.
+    auto insert_pos = tasks_.end();
+    auto batch_pos = tasks_.end();
+    for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+      auto priority_it = compile_task_priorities_.find(*it);
+      if (priority_it == compile_task_priorities_.end()) {
+        // A control task; it keeps its FIFO position.
+        continue;
+      }
+      if (priority_it->second < priority) {
+        insert_pos = it;
+        break;
+      }
+      if (down_cast<JitCompileTask*>(*it)->SameDeclaringClass(*task)) {
+        batch_pos = it;
+      }
+    }
+    if (batch_pos != tasks_.end()) {
+      insert_pos = batch_pos + 1;
+    }
+    tasks_.insert(insert_pos, task);
+    compile_task_priorities_.Put(task, priority);
+    if (started_ && waiting_count_ != 0) {
+      task_queue_condition_.Signal(self);
+    }
+  }
+
+ protected:
+  Task* TryGetTaskLocked() override REQUIRES(task_queue_lock_) {
+    Task* task = ThreadPool::TryGetTaskLocked();
+    if (task != nullptr) {
+      compile_task_priorities_.erase(task);
+    }
+    return task;
+  }
+
+ private:
+  // Priorities of the queued compilation tasks. Tasks absent from this map are
+  // control tasks; only tasks present in the map may be down-cast to
+  // `JitCompileTask`.
+  SafeMap<Task*, uint32_t> compile_task_priorities_ GUARDED_BY(task_queue_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(JitThreadPool);
+};
+
 static std::string GetProfileFile(const std::string& dex_location) {
   // Hardcoded assumption where the profile file is.
   // TODO(ngeoffray): this is brittle and we would need to change change if we
@@ -1185,7 +1322,7 @@ void Jit::CreateThreadPool() {
 
   // We need peers as we may report the JIT thread, e.g., in the debugger.
   constexpr bool kJitPoolNeedsPeers = true;
-  thread_pool_.reset(new ThreadPool("Jit thread pool", 1, kJitPoolNeedsPeers));
+  thread_pool_.reset(new JitThreadPool("Jit thread pool", 1, kJitPoolNeedsPeers));
 
   Runtime* runtime = Runtime::Current();
   thread_pool_->SetPthreadPriority(
@@ -1308,7 +1445,8 @@ bool Jit::CompileMethodFromProfile(Thread* self,
                                    Handle<mirror::DexCache> dex_cache,
                                    Handle<mirror::ClassLoader> class_loader,
                                    bool add_to_queue,
-                                   bool compile_after_boot) {
+                                   bool compile_after_boot,
+                                   bool startup) {
   ArtMethod* method = class_linker->ResolveMethodWithoutInvokeType(
       method_idx, dex_cache, class_loader);
   if (method == nullptr) {
@@ -1333,17 +1471,23 @@ bool Jit::CompileMethodFromProfile(Thread* self,
     if (!add_to_queue) {
       CompileMethod(method, self, CompilationKind::kOptimized, /* prejit= */ true);
     } else {
-      Task* task = new JitCompileTask(
-          method, JitCompileTask::TaskKind::kPreCompile, CompilationKind::kOptimized);
+      JitCompileTask* task = new JitCompileTask(
+          method,
+          JitCompileTask::TaskKind::kPreCompile,
+          CompilationKind::kOptimized,
+          startup ? JitCompileTask::kPriorityPreCompileStartup
+                  : JitCompileTask::kPriorityPreCompile);
       if (compile_after_boot) {
         MutexLock mu(Thread::Current(), boot_completed_lock_);
         if (!boot_completed_) {
+          // Tasks queued for after boot are drained through the regular
+          // `AddTask` and keep their profile order.
           tasks_after_boot_.push_back(task);
           return true;
         }
         DCHECK(tasks_after_boot_.empty());
       }
-      thread_pool_->AddTask(self, task);
+      down_cast<JitThreadPool*>(thread_pool_.get())->AddCompileTask(self, task);
       return true;
     }
   }
@@ -1385,7 +1529,8 @@ uint32_t Jit::CompileMethodsFromBootProfile(
                                  dex_caches[pair.first],
                                  class_loader,
                                  add_to_queue,
-                                 /*compile_after_boot=*/false)) {
+                                 /*compile_after_boot=*/false,
+                                 /*startup=*/true)) {
       ++added_to_queue;
     }
   }
@@ -1430,12 +1575,13 @@ uint32_t Jit::CompileMethodsFromProfile(
     }
 
     std::set<dex::TypeIndex> class_types;
-    std::set<uint16_t> all_methods;
+    std::set<uint16_t> startup_methods;
+    std::set<uint16_t> other_methods;
     if (!profile_info.GetClassesAndMethods(*dex_file,
                                            &class_types,
-                                           &all_methods,
-                                           &all_methods,
-                                           &all_methods)) {
+                                           &other_methods,
+                                           &startup_methods,
+                                           &other_methods)) {
       // This means the profile file did not reference the dex file, which is the case
       // if there's no classes and methods of that dex file in the profile.
       continue;
@@ -1443,14 +1589,32 @@ uint32_t Jit::CompileMethodsFromProfile(
     dex_cache.Assign(class_linker->FindDexCache(self, *dex_file));
     CHECK(dex_cache != nullptr) << "Could not find dex cache for " << dex_file->GetLocation();
 
-    for (uint16_t method_idx : all_methods) {
+    // Queue the startup methods first so they are compiled ahead of the rest.
+    for (uint16_t method_idx : startup_methods) {
+      if (CompileMethodFromProfile(self,
+                                   class_linker,
+                                   method_idx,
+                                   dex_cache,
+                                   class_loader,
+                                   add_to_queue,
+                                   /*compile_after_boot=*/true,
+                                   /*startup=*/true)) {
+        ++added_to_queue;
+      }
+    }
+    for (uint16_t method_idx : other_methods) {
+      if (startup_methods.find(method_idx) != startup_methods.end()) {
+        // Already handled above.
+        continue;
+      }
       if (CompileMethodFromProfile(self,
                                    class_linker,
                                    method_idx,
                                    dex_cache,
                                    class_loader,
                                    add_to_queue,
-                                   /*compile_after_boot=*/true)) {
+                                   /*compile_after_boot=*/true,
+                                   /*startup=*/false)) {
         ++added_to_queue;
       }
     }
@@ -1518,27 +1682,46 @@ bool Jit::MaybeCompileMethod(Thread* self,
   DCHECK_GT(WarmMethodThreshold(), 0);
   DCHECK_GT(HotMethodThreshold(), WarmMethodThreshold());
   DCHECK_GT(OSRMethodThreshold(), HotMethodThreshold());
+  DCHECK_GT(BaselineMethodThreshold(), 0);
+  DCHECK_LE(BaselineMethodThreshold(), HotMethodThreshold());
   DCHECK_GE(PriorityThreadWeight(), 1);
   DCHECK_LE(PriorityThreadWeight(), HotMethodThreshold());
 
   if (UseJitCompilation()) {
-    if (old_count < HotMethodThreshold() && new_count >= HotMethodThreshold()) {
+    JitThreadPool* pool = down_cast<JitThreadPool*>(thread_pool_.get());
+    if (old_count < BaselineMethodThreshold() && new_count >= BaselineMethodThreshold()) {
       if (!code_cache_->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
-        DCHECK(thread_pool_ != nullptr);
-        thread_pool_->AddTask(
+        DCHECK(pool != nullptr);
+        pool->AddCompileTask(
             self,
             new JitCompileTask(
                 method, JitCompileTask::TaskKind::kCompile, CompilationKind::kBaseline));
       }
     }
+    if (BaselineMethodThreshold() < HotMethodThreshold() &&
+        old_count < HotMethodThreshold() &&
+        new_count >= HotMethodThreshold()) {
+      // The method is still being interpreted although it crossed the baseline threshold a
+      // while ago: the baseline compile has not been installed (yet). Request an optimized
+      // compile directly; installed baseline code promotes itself through
+      // Jit::EnqueueOptimizedCompilation instead of accumulating samples here.
+      if (!options_->UseBaselineCompiler() &&
+          !code_cache_->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+        DCHECK(pool != nullptr);
+        pool->AddCompileTask(
+            self,
+            new JitCompileTask(
+                method, JitCompileTask::TaskKind::kCompile, CompilationKind::kOptimized));
+      }
+    }
     if (old_count < OSRMethodThreshold() && new_count >= OSRMethodThreshold()) {
       if (!with_backedges) {
         return false;
       }
       DCHECK(!method->IsNative());  // No back edges reported for native methods.
       if (!code_cache_->IsOsrCompiled(method)) {
-        DCHECK(thread_pool_ != nullptr);
-        thread_pool_->AddTask(
+        DCHECK(pool != nullptr);
+        pool->AddCompileTask(
             self,
             new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, CompilationKind::kOsr));
       }
@@ -1555,7 +1738,7 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   // hotness threshold. If we're not only using the baseline compiler, enqueue a compilation
   // task that will compile optimize the method.
   if (!options_->UseBaselineCompiler()) {
-    thread_pool_->AddTask(
+    down_cast<JitThreadPool*>(thread_pool_.get())->AddCompileTask(
         self,
         new JitCompileTask(method,
                            JitCompileTask::TaskKind::kCompile,
@@ -1793,20 +1976,21 @@ void Jit::EnqueueCompilationFromNterp(ArtMethod* method, Thread* self) {
   if (thread_pool_ == nullptr) {
     return;
   }
+  JitThreadPool* pool = down_cast<JitThreadPool*>(thread_pool_.get());
   if (GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
     // If we already have compiled code for it, nterp may be stuck in a loop.
     // Compile OSR.
-    thread_pool_->AddTask(
+    pool->AddCompileTask(
         self,
         new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, CompilationKind::kOsr));
     return;
   }
   if (GetCodeCache()->CanAllocateProfilingInfo()) {
-    thread_pool_->AddTask(
+    pool->AddCompileTask(
         self,
         new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, CompilationKind::kBaseline));
   } else {
-    thread_pool_->AddTask(
+    pool->AddCompileTask(
         self,
         new JitCompileTask(method,
                            JitCompileTask::TaskKind::kCompile,
@@ -77,6 +77,10 @@ class JitOptions {
     return compile_threshold_;
   }
 
+  uint16_t GetBaselineThreshold() const {
+    return baseline_threshold_;
+  }
+
   uint16_t GetWarmupThreshold() const {
     return warmup_threshold_;
   }
@@ -165,6 +169,7 @@ class JitOptions {
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
   uint32_t compile_threshold_;
+  uint32_t baseline_threshold_;
   uint32_t warmup_threshold_;
   uint32_t osr_threshold_;
   uint16_t priority_thread_weight_;
@@ -181,6 +186,7 @@ class JitOptions {
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
         compile_threshold_(0),
+        baseline_threshold_(0),
         warmup_threshold_(0),
         osr_threshold_(0),
         priority_thread_weight_(0),
@@ -289,6 +295,10 @@ class Jit {
     return options_->GetCompileThreshold();
   }
 
+  uint16_t BaselineMethodThreshold() const {
+    return options_->GetBaselineThreshold();
+  }
+
   uint16_t WarmMethodThreshold() const {
     return options_->GetWarmupThreshold();
   }
@@ -465,13 +475,16 @@ class Jit {
 
   // Compile an individual method listed in a profile. If `add_to_queue` is
   // true and the method was resolved, return true. Otherwise return false.
+  // `startup` denotes whether the profile flags the method as a startup
+  // method; such methods are compiled before post-startup ones.
   bool CompileMethodFromProfile(Thread* self,
                                 ClassLinker* linker,
                                 uint32_t method_idx,
                                 Handle<mirror::DexCache> dex_cache,
                                 Handle<mirror::ClassLoader> class_loader,
                                 bool add_to_queue,
-                                bool compile_after_boot)
+                                bool compile_after_boot,
+                                bool startup)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Compile the method if the number of samples passes a threshold.
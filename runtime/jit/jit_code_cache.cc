@@ -16,6 +16,7 @@
 
 #include "jit_code_cache.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include <android-base/logging.h>
@@ -34,6 +35,7 @@
 #include "base/time_utils.h"
 #include "base/utils.h"
 #include "cha.h"
+#include "code_info_cache.h"
 #include "debugger_interface.h"
 #include "dex/dex_file_loader.h"
 #include "dex/method_reference.h"
@@ -535,6 +537,7 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
           ++it;
         }
       }
+      PublishMethodCodeSnapshot();
     }
     for (auto it = osr_code_map_.begin(); it != osr_code_map_.end();) {
       if (alloc.ContainsUnsafe(it->first)) {
@@ -596,7 +599,7 @@ void JitCodeCache::CopyInlineCacheInto(
     const InlineCache& ic,
     /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
   static_assert(arraysize(ic.classes_) == InlineCache::kIndividualCacheSize);
-  DCHECK_EQ(classes->NumberOfReferences(), InlineCache::kIndividualCacheSize);
+  DCHECK_EQ(classes->NumberOfReferences(), 0u);
   DCHECK_EQ(classes->RemainingSlots(), InlineCache::kIndividualCacheSize);
   WaitUntilInlineCacheAccessible(Thread::Current());
   // Note that we don't need to lock `lock_` here, the compiler calling
@@ -660,22 +663,41 @@ bool JitCodeCache::Commit(Thread* self,
   size_t root_table_size = ComputeRootTableSize(roots.size());
   const uint8_t* stack_map_data = roots_data + root_table_size;
 
+  // With a dual code mapping (and outside of debug builds), the writable view stays writable:
+  // committing code and data only writes to the thread-private reserved ranges, with no global
+  // write-protection toggle. Doing the bulky copies and cache flushes before taking the lock
+  // keeps compiler threads from convoying on Locks::jit_lock_ during compilation bursts; only
+  // the publication below is serialized. A concurrent collection cannot free the reservation,
+  // as it only frees code that is present in the method maps.
+  const bool commit_unlocked = !kIsDebugBuild && region->HasDualCodeMapping();
+  const uint8_t* code_ptr = nullptr;
+  if (commit_unlocked) {
+    code_ptr = region->CommitCode(reserved_code, code, stack_map_data, has_should_deoptimize_flag);
+    if (code_ptr == nullptr) {
+      return false;
+    }
+    // Commit roots and stack maps before updating the entry point.
+    if (!region->CommitData(reserved_data, roots, stack_map)) {
+      return false;
+    }
+  }
+
   MutexLock mu(self, *Locks::jit_lock_);
   // We need to make sure that there will be no jit-gcs going on and wait for any ongoing one to
   // finish.
   WaitForPotentialCollectionToCompleteRunnable(self);
-  const uint8_t* code_ptr = region->CommitCode(
-      reserved_code, code, stack_map_data, has_should_deoptimize_flag);
-  if (code_ptr == nullptr) {
-    return false;
+  if (!commit_unlocked) {
+    code_ptr = region->CommitCode(reserved_code, code, stack_map_data, has_should_deoptimize_flag);
+    if (code_ptr == nullptr) {
+      return false;
+    }
+    // Commit roots and stack maps before updating the entry point.
+    if (!region->CommitData(reserved_data, roots, stack_map)) {
+      return false;
+    }
   }
   OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
 
-  // Commit roots and stack maps before updating the entry point.
-  if (!region->CommitData(reserved_data, roots, stack_map)) {
-    return false;
-  }
-
   switch (compilation_kind) {
     case CompilationKind::kOsr:
       number_of_osr_compilations_++;
@@ -740,6 +762,7 @@ bool JitCodeCache::Commit(Thread* self,
         zygote_map_.Put(code_ptr, method);
       } else {
         method_code_map_.Put(code_ptr, method);
+        PublishMethodCodeSnapshot();
       }
       if (compilation_kind == CompilationKind::kOsr) {
         osr_code_map_.Put(method, code_ptr);
@@ -841,6 +864,7 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
         ++it;
       }
     }
+    PublishMethodCodeSnapshot();
 
     auto osr_it = osr_code_map_.find(method);
     if (osr_it != osr_code_map_.end()) {
@@ -881,6 +905,7 @@ void JitCodeCache::MoveObsoleteMethod(ArtMethod* old_method, ArtMethod* new_meth
       it.second = new_method;
     }
   }
+  PublishMethodCodeSnapshot();
   // Update osr_code_map_ to point to the new method.
   auto code_map = osr_code_map_.find(old_method);
   if (code_map != osr_code_map_.end()) {
@@ -1000,6 +1025,10 @@ void JitCodeCache::Free(Thread* self,
 
 void JitCodeCache::FreeLocked(JitMemoryRegion* region, const uint8_t* code, const uint8_t* data) {
   if (code != nullptr) {
+    // The freed range can be reused for a different method, so drop any
+    // thread-local decoded CodeInfo keyed by a method header in it. This must
+    // happen before the actual free makes the memory available again.
+    CodeInfoCache::IncrementGlobalGeneration();
     RemoveNativeDebugInfoForJit(reinterpret_cast<const void*>(FromAllocationToCode(code)));
     region->FreeCode(code);
   }
@@ -1220,6 +1249,8 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
         it = method_code_map_.erase(it);
       }
     }
+    // Publish before freeing so that no new lookup can find removed entries.
+    PublishMethodCodeSnapshot();
     FreeAllMethodHeaders(method_headers);
   }
 }
@@ -1285,6 +1316,7 @@ bool JitCodeCache::IsMethodBeingCompiled(ArtMethod* method) {
 
 void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
   ScopedTrace trace(__FUNCTION__);
+  size_t number_of_unmarked_entries = 0u;
   {
     MutexLock mu(self, *Locks::jit_lock_);
 
@@ -1341,21 +1373,53 @@ void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
     // Empty osr method map, as osr compiled code will be deleted (except the ones
     // on thread stacks).
     osr_code_map_.clear();
+
+    // Count the entries the stack scan could still save: code that is no method's current
+    // entry point (osr, discarded or cold-baseline code). If every entry is already marked,
+    // neither the checkpoint nor the removal pass can change anything, so skip stalling every
+    // thread for the stack walk. Entry points changing concurrently cannot create new unmarked
+    // entries, as they only move between marked code and the runtime bridges.
+    for (const auto& entry : jni_stubs_map_) {
+      const JniStubData& data = entry.second;
+      if (data.IsCompiled() &&
+          !IsInZygoteExecSpace(data.GetCode()) &&
+          !GetLiveBitmap()->Test(FromCodeToAllocation(data.GetCode()))) {
+        ++number_of_unmarked_entries;
+      }
+    }
+    for (const auto& it : method_code_map_) {
+      const void* code_ptr = it.first;
+      if (!IsInZygoteExecSpace(code_ptr) && !GetLiveBitmap()->Test(FromCodeToAllocation(code_ptr))) {
+        ++number_of_unmarked_entries;
+      }
+    }
   }
 
-  // Run a checkpoint on all threads to mark the JIT compiled code they are running.
-  MarkCompiledCodeOnThreadStacks(self);
+  if (number_of_unmarked_entries != 0u) {
+    // Run a checkpoint on all threads to mark the JIT compiled code they are running.
+    MarkCompiledCodeOnThreadStacks(self);
 
-  // At this point, mutator threads are still running, and entrypoints of methods can
-  // change. We do know they cannot change to a code cache entry that is not marked,
-  // therefore we can safely remove those entries.
-  RemoveUnmarkedCode(self);
+    // At this point, mutator threads are still running, and entrypoints of methods can
+    // change. We do know they cannot change to a code cache entry that is not marked,
+    // therefore we can safely remove those entries.
+    RemoveUnmarkedCode(self);
+  }
 
   if (collect_profiling_info) {
     // TODO: Collect unused profiling infos.
   }
 }
 
+void JitCodeCache::PublishMethodCodeSnapshot() {
+  // std::map iterates in key order, so the copy is already sorted for the
+  // binary search in LookupMethodHeader.
+  std::atomic_store_explicit(
+      &method_code_snapshot_,
+      std::shared_ptr<const MethodCodeSnapshot>(
+          new MethodCodeSnapshot(method_code_map_.begin(), method_code_map_.end())),
+      std::memory_order_release);
+}
+
 OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod* method) {
   static_assert(kRuntimeISA != InstructionSet::kThumb2, "kThumb2 cannot be a runtime ISA");
   if (kRuntimeISA == InstructionSet::kArm) {
@@ -1371,10 +1435,10 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
     CHECK(method != nullptr);
   }
 
-  MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   OatQuickMethodHeader* method_header = nullptr;
   ArtMethod* found_method = nullptr;  // Only for DCHECK(), not for JNI stubs.
   if (method != nullptr && UNLIKELY(method->IsNative())) {
+    MutexLock mu(Thread::Current(), *Locks::jit_lock_);
     auto it = jni_stubs_map_.find(JniStubKey(method));
     if (it == jni_stubs_map_.end() || !ContainsElement(it->second.GetMethods(), method)) {
       return nullptr;
@@ -1391,18 +1455,33 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
         return OatQuickMethodHeader::FromCodePointer(code_ptr);
       }
     }
-    auto it = method_code_map_.lower_bound(reinterpret_cast<const void*>(pc));
-    if (it != method_code_map_.begin()) {
-      --it;
-      const void* code_ptr = it->first;
-      if (OatQuickMethodHeader::FromCodePointer(code_ptr)->Contains(pc)) {
-        method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
-        found_method = it->second;
+    // Binary search the published snapshot without taking jit_lock_: stack
+    // walks for GC root marking and exception unwind come through here for
+    // every JIT frame and must not contend with the compiler or the cache
+    // collector. The snapshot may lag behind method_code_map_, but code is
+    // only freed once a marking checkpoint has proven it is not on any
+    // thread's stack, so a pc being walked cannot match a stale entry.
+    std::shared_ptr<const MethodCodeSnapshot> snapshot =
+        std::atomic_load_explicit(&method_code_snapshot_, std::memory_order_acquire);
+    if (snapshot != nullptr) {
+      auto it = std::upper_bound(snapshot->begin(),
+                                 snapshot->end(),
+                                 reinterpret_cast<const void*>(pc),
+                                 [](const void* lhs, const std::pair<const void*, ArtMethod*>& rhs)
+                                     { return lhs < rhs.first; });
+      if (it != snapshot->begin()) {
+        --it;
+        const void* code_ptr = it->first;
+        if (OatQuickMethodHeader::FromCodePointer(code_ptr)->Contains(pc)) {
+          method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+          found_method = it->second;
+        }
       }
     }
     if (method_header == nullptr && method == nullptr) {
       // Scan all compiled JNI stubs as well. This slow search is used only
       // for checks in debug build, for release builds the `method` is not null.
+      MutexLock mu(Thread::Current(), *Locks::jit_lock_);
       for (auto&& entry : jni_stubs_map_) {
         const JniStubData& data = entry.second;
         if (data.IsCompiled() &&
@@ -455,6 +455,10 @@ class JitCodeCache {
   // Notify all waiting threads that a collection is done.
   void NotifyCollectionDone(Thread* self) REQUIRES(Locks::jit_lock_);
 
+  // Publish an up-to-date immutable copy of method_code_map_ for lock-free
+  // lookups. Must be called after every mutation of method_code_map_.
+  void PublishMethodCodeSnapshot() REQUIRES(Locks::jit_lock_);
+
   // Return whether the code cache's capacity is at its maximum.
   bool IsAtMaxCapacity() const REQUIRES(Locks::jit_lock_);
 
@@ -530,6 +534,17 @@ class JitCodeCache {
   // Holds compiled code associated to the ArtMethod.
   SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(Locks::jit_lock_);
 
+  // Immutable sorted copy of method_code_map_, rebuilt and published with
+  // release semantics (under jit_lock_) after every mutation of the map, and
+  // binary-searched without holding jit_lock_ by LookupMethodHeader. Stack
+  // walks through JIT frames (GC root marking, exception unwind) therefore
+  // never contend with the compiler or the cache collector, and search
+  // contiguous memory instead of chasing map nodes. Retired copies stay alive
+  // through the shared_ptr reference count until the last concurrent lookup
+  // drops them.
+  using MethodCodeSnapshot = std::vector<std::pair<const void*, ArtMethod*>>;
+  std::shared_ptr<const MethodCodeSnapshot> method_code_snapshot_;
+
   // Holds compiled code associated to the ArtMethod. Used when pre-jitting
   // methods whose entrypoints have the resolution stub.
   SafeMap<ArtMethod*, const void*> saved_compiled_methods_map_ GUARDED_BY(Locks::jit_lock_);
@@ -88,17 +88,20 @@ class JitMemoryRegion {
 
   // Emit header and code into the memory pointed by `reserved_code` (despite it being const).
   // Returns pointer to copied code (within reserved_code region; after OatQuickMethodHeader).
+  // Only writes to the reserved range, which belongs to the caller until publication. Callers
+  // must hold Locks::jit_lock_ unless the region has a dual code mapping in a release build,
+  // as the write-protection toggle is otherwise region-wide (see ScopedCodeCacheWrite).
   const uint8_t* CommitCode(ArrayRef<const uint8_t> reserved_code,
                             ArrayRef<const uint8_t> code,
                             const uint8_t* stack_map,
-                            bool has_should_deoptimize_flag)
-      REQUIRES(Locks::jit_lock_);
+                            bool has_should_deoptimize_flag);
 
   // Emit roots and stack map into the memory pointed by `roots_data` (despite it being const).
+  // Like CommitCode, only writes to the caller-owned reserved range, under the same locking
+  // contract.
   bool CommitData(ArrayRef<const uint8_t> reserved_data,
                   const std::vector<Handle<mirror::Object>>& roots,
                   ArrayRef<const uint8_t> stack_map)
-      REQUIRES(Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   void ResetWritableMappings() REQUIRES(Locks::jit_lock_) {
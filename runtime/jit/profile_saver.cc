@@ -25,6 +25,7 @@
 #include "android-base/strings.h"
 
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/compiler_filter.h"
 #include "base/enums.h"
 #include "base/logging.h"  // For VLOG.
@@ -42,6 +43,9 @@
 #include "oat_file_manager.h"
 #include "profile/profile_compilation_info.h"
 #include "scoped_thread_state_change-inl.h"
+#include "stack.h"
+#include "thread_list.h"
+#include "thread_pool.h"
 
 namespace art {
 
@@ -49,6 +53,7 @@ using Hotness = ProfileCompilationInfo::MethodHotness;
 
 ProfileSaver* ProfileSaver::instance_ = nullptr;
 pthread_t ProfileSaver::profiler_pthread_ = 0U;
+pthread_t ProfileSaver::sampler_pthread_ = 0U;
 
 static_assert(ProfileCompilationInfo::kIndividualInlineCacheSize ==
               InlineCache::kIndividualCacheSize,
@@ -57,6 +62,11 @@ static_assert(ProfileCompilationInfo::kIndividualInlineCacheSize ==
 // At what priority to schedule the saver threads. 9 is the lowest foreground priority on device.
 static constexpr int kProfileSaverPthreadPriority = 9;
 
+// Minimum number of stack samples for a method to be marked as hot in the profile.
+// At a 10ms sampling interval this corresponds to roughly 200ms of accumulated
+// time on top of a thread stack.
+static constexpr uint32_t kHotnessSamplesForHotMethod = 20;
+
 static void SetProfileSaverThreadPriority(pthread_t thread, int priority) {
 #if defined(ART_TARGET_ANDROID)
   int result = setpriority(PRIO_PROCESS, pthread_gettid_np(thread), priority);
@@ -908,6 +918,29 @@ bool ProfileSaver::ProcessProfilingInfo(
           }
         }
 
+        // Fold in the hotness data collected by the stack sampler, if enabled.
+        // The sample counts are kept across saves so that slowly accumulating
+        // methods of long-running apps eventually cross the hotness threshold.
+        for (const auto& entry : sampled_methods_) {
+          const MethodReference& ref = entry.first;
+          const SampledHotness& sample = entry.second;
+          const std::string base_location =
+              DexFileLoader::GetBaseLocation(ref.dex_file->GetLocation());
+          if (!ContainsElement(locations, base_location)) {
+            continue;
+          }
+          uint32_t flags = sample.flags;
+          if (sample.count >= kHotnessSamplesForHotMethod) {
+            flags |= Hotness::kFlagHot;
+          }
+          if (!info.AddMethod(ProfileMethodInfo(ref),
+                              AnnotateSampleFlags(flags),
+                              GetProfileSampleAnnotation())) {
+            VLOG(profiler) << "Could not add sampled method to the profile: "
+                           << ref.PrettyMethod();
+          }
+        }
+
         int64_t delta_number_of_methods =
             info.GetNumberOfMethods() - last_save_number_of_methods;
         int64_t delta_number_of_classes =
@@ -987,6 +1020,131 @@ void* ProfileSaver::RunProfileSaverThread(void* arg) {
   return nullptr;
 }
 
+// Checkpoint closure run by the hotness sampler. Records the top java method
+// on the stack of each checkpointed thread. The recorded methods are only
+// read after all threads have passed the barrier.
+class SampleStackClosure final : public Closure {
+ public:
+  explicit SampleStackClosure(Barrier* barrier)
+      : barrier_(barrier), lock_("profile saver sample lock") {}
+
+  void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(thread == Thread::Current() || thread->IsSuspended());
+    ArtMethod* top_method = nullptr;
+    StackVisitor::WalkStack(
+        [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+          ArtMethod* m = stack_visitor->GetMethod();
+          // Stop the walk at the first java frame. Runtime methods and the
+          // frames below them are not interesting for the profile.
+          if (m != nullptr && !m->IsRuntimeMethod()) {
+            top_method = m;
+            return false;
+          }
+          return true;
+        },
+        thread,
+        /* context= */ nullptr,
+        art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+    if (top_method != nullptr && !top_method->IsNative() && !top_method->IsProxyMethod()) {
+      MutexLock mu(Thread::Current(), lock_);
+      methods_.push_back(top_method);
+    }
+    barrier_->Pass(Thread::Current());
+  }
+
+  const std::vector<ArtMethod*>& GetMethods() const { return methods_; }
+
+ private:
+  Barrier* const barrier_;
+  Mutex lock_;
+  std::vector<ArtMethod*> methods_;
+};
+
+void ProfileSaver::SampleThreadStacks(Thread* self) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  Barrier barrier(0);
+  SampleStackClosure closure(&barrier);
+  std::vector<MethodReference> sampled;
+  {
+    ScopedObjectAccess soa(self);
+    size_t threads_running_checkpoint =
+        Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
+    {
+      // Now that we have run our checkpoint, move to a suspended state and
+      // wait for other threads to run the checkpoint.
+      ScopedThreadSuspension sts(self, kSuspended);
+      if (threads_running_checkpoint != 0) {
+        barrier.Increment(self, threads_running_checkpoint);
+      }
+    }
+    sampled.reserve(closure.GetMethods().size());
+    for (ArtMethod* method : closure.GetMethods()) {
+      sampled.emplace_back(method->GetDexFile(), method->GetDexMethodIndex());
+    }
+  }
+
+  // Methods sampled before startup completed are recorded as startup methods,
+  // mirroring the annotation of the jit notifications.
+  const uint32_t state_flag = Runtime::Current()->GetStartupCompleted()
+      ? Hotness::kFlagPostStartup
+      : Hotness::kFlagStartup;
+
+  MutexLock mu(self, *Locks::profiler_lock_);
+  if (shutting_down_) {
+    return;
+  }
+  for (const MethodReference& ref : sampled) {
+    const std::string base_location =
+        DexFileLoader::GetBaseLocation(ref.dex_file->GetLocation());
+    bool tracked = false;
+    for (const auto& it : tracked_dex_base_locations_) {
+      if (ContainsElement(it.second, base_location)) {
+        tracked = true;
+        break;
+      }
+    }
+    if (!tracked) {
+      // Skip dex files which are not profiled. This also keeps sampled_methods_
+      // free of references to dex files which may get unloaded.
+      continue;
+    }
+    SampledHotness& hotness = sampled_methods_.GetOrCreate(ref, []() { return SampledHotness(); });
+    ++hotness.count;
+    hotness.flags |= state_flag;
+  }
+}
+
+void* ProfileSaver::RunSamplerThread(void* arg) {
+  Runtime* runtime = Runtime::Current();
+
+  bool attached = runtime->AttachCurrentThread("Profile Hotness Sampler",
+                                               /*as_daemon=*/true,
+                                               runtime->GetSystemThreadGroup(),
+                                               /*create_peer=*/true);
+  if (!attached) {
+    CHECK(runtime->IsShuttingDown(Thread::Current()));
+    return nullptr;
+  }
+
+  ProfileSaver* saver = reinterpret_cast<ProfileSaver*>(arg);
+  Thread* self = Thread::Current();
+  const uint32_t interval_us = saver->options_.GetHotnessSamplingIntervalMs() * 1000u;
+  while (true) {
+    usleep(interval_us);
+    {
+      MutexLock mu(self, *Locks::profiler_lock_);
+      if (instance_ != saver || saver->shutting_down_) {
+        break;
+      }
+    }
+    saver->SampleThreadStacks(self);
+  }
+
+  runtime->DetachCurrentThread();
+  VLOG(profiler) << "Profile hotness sampler shutdown";
+  return nullptr;
+}
+
 static bool ShouldProfileLocation(const std::string& location, bool profile_aot_code) {
   if (profile_aot_code) {
     // If we have to profile all the code, irrespective of its compilation state, return true
@@ -1088,17 +1246,30 @@ void  ProfileSaver::Start(const ProfileSaverOptions& options,
       "Profile saver thread");
 
   SetProfileSaverThreadPriority(profiler_pthread_, kProfileSaverPthreadPriority);
+
+  // Create the hotness sampler thread if the sampling mode is enabled.
+  if (options.GetHotnessSamplingIntervalMs() !=
+          ProfileSaverOptions::kHotnessSamplingIntervalMsDisabled) {
+    CHECK_PTHREAD_CALL(
+        pthread_create,
+        (&sampler_pthread_, nullptr, &RunSamplerThread, reinterpret_cast<void*>(instance_)),
+        "Profile hotness sampler thread");
+
+    SetProfileSaverThreadPriority(sampler_pthread_, kProfileSaverPthreadPriority);
+  }
 }
 
 void ProfileSaver::Stop(bool dump_info) {
   ProfileSaver* profile_saver = nullptr;
   pthread_t profiler_pthread = 0U;
+  pthread_t sampler_pthread = 0U;
 
   {
     MutexLock profiler_mutex(Thread::Current(), *Locks::profiler_lock_);
     VLOG(profiler) << "Stopping profile saver thread";
     profile_saver = instance_;
     profiler_pthread = profiler_pthread_;
+    sampler_pthread = sampler_pthread_;
     if (instance_ == nullptr) {
       DCHECK(false) << "Tried to stop a profile saver which was not started";
       return;
@@ -1126,6 +1297,13 @@ void ProfileSaver::Stop(bool dump_info) {
   // Wait for the saver thread to stop.
   CHECK_PTHREAD_CALL(pthread_join, (profiler_pthread, nullptr), "profile saver thread shutdown");
 
+  // Wait for the sampler thread, if any, to notice the shutdown and stop.
+  if (sampler_pthread != 0U) {
+    CHECK_PTHREAD_CALL(pthread_join,
+                       (sampler_pthread, nullptr),
+                       "profile hotness sampler thread shutdown");
+  }
+
   {
     MutexLock profiler_mutex(Thread::Current(), *Locks::profiler_lock_);
     if (dump_info) {
@@ -1133,6 +1311,7 @@ void ProfileSaver::Stop(bool dump_info) {
     }
     instance_ = nullptr;
     profiler_pthread_ = 0U;
+    sampler_pthread_ = 0U;
   }
   delete profile_saver;
 }
@@ -69,6 +69,15 @@ class ProfileSaver {
   static void* RunProfileSaverThread(void* arg)
       REQUIRES(!Locks::profiler_lock_, !instance_->wait_lock_);
 
+  // The run loop of the timer-driven hotness sampler thread, only started when
+  // options_.GetHotnessSamplingIntervalMs() is non-zero.
+  static void* RunSamplerThread(void* arg) REQUIRES(!Locks::profiler_lock_);
+
+  // Walk all thread stacks via a checkpoint and record the top java method of
+  // each thread in sampled_methods_.
+  void SampleThreadStacks(Thread* self)
+      REQUIRES(!Locks::profiler_lock_, !Locks::mutator_lock_);
+
   // The run loop for the saver.
   void Run()
       REQUIRES(Locks::profiler_lock_, !wait_lock_)
@@ -122,6 +131,8 @@ class ProfileSaver {
   static ProfileSaver* instance_ GUARDED_BY(Locks::profiler_lock_);
   // Profile saver thread.
   static pthread_t profiler_pthread_ GUARDED_BY(Locks::profiler_lock_);
+  // Hotness sampler thread, only valid (non-zero) when the sampler is enabled.
+  static pthread_t sampler_pthread_ GUARDED_BY(Locks::profiler_lock_);
 
   jit::JitCodeCache* jit_code_cache_;
 
@@ -154,6 +165,17 @@ class ProfileSaver {
   // to just a few hundreds entries in the ProfileCompilationInfo objects.
   SafeMap<std::string, ProfileCompilationInfo*> profile_cache_ GUARDED_BY(Locks::profiler_lock_);
 
+  // Aggregated stack sample counts and hotness flags, keyed by method.
+  // Populated by the hotness sampler thread and folded into the profiles by
+  // ProcessProfilingInfo(). Only methods from tracked locations are recorded,
+  // so the referenced dex files remain loaded for the process lifetime.
+  struct SampledHotness {
+    uint32_t count = 0u;
+    uint32_t flags = 0u;
+  };
+  SafeMap<MethodReference, SampledHotness> sampled_methods_
+      GUARDED_BY(Locks::profiler_lock_);
+
   // Whether or not this is the first ever profile save.
   // Note this is an approximation and is not 100% precise. It relies on checking
   // whether or not the profiles are empty which is not a precise indication
@@ -33,6 +33,9 @@ struct ProfileSaverOptions {
   static constexpr uint32_t kMinNotificationBeforeWake = 10;
   static constexpr uint32_t kMaxNotificationBeforeWake = 50;
   static constexpr uint32_t kHotStartupMethodSamplesNotSet = std::numeric_limits<uint32_t>::max();
+  // Default value for the stack sampling interval, indicating that the
+  // timer-driven hotness sampler is disabled.
+  static constexpr uint32_t kHotnessSamplingIntervalMsDisabled = 0;
 
   ProfileSaverOptions() :
     enabled_(false),
@@ -47,7 +50,8 @@ struct ProfileSaverOptions {
     profile_path_(""),
     profile_boot_class_path_(false),
     profile_aot_code_(false),
-    wait_for_jit_notifications_to_save_(true) {}
+    wait_for_jit_notifications_to_save_(true),
+    hotness_sampling_interval_ms_(kHotnessSamplingIntervalMsDisabled) {}
 
   ProfileSaverOptions(
       bool enabled,
@@ -62,7 +66,8 @@ struct ProfileSaverOptions {
       const std::string& profile_path,
       bool profile_boot_class_path,
       bool profile_aot_code = false,
-      bool wait_for_jit_notifications_to_save = true)
+      bool wait_for_jit_notifications_to_save = true,
+      uint32_t hotness_sampling_interval_ms = kHotnessSamplingIntervalMsDisabled)
   : enabled_(enabled),
     min_save_period_ms_(min_save_period_ms),
     min_first_save_ms_(min_first_save_ms),
@@ -75,7 +80,8 @@ struct ProfileSaverOptions {
     profile_path_(profile_path),
     profile_boot_class_path_(profile_boot_class_path),
     profile_aot_code_(profile_aot_code),
-    wait_for_jit_notifications_to_save_(wait_for_jit_notifications_to_save) {}
+    wait_for_jit_notifications_to_save_(wait_for_jit_notifications_to_save),
+    hotness_sampling_interval_ms_(hotness_sampling_interval_ms) {}
 
   bool IsEnabled() const {
     return enabled_;
@@ -127,6 +133,9 @@ struct ProfileSaverOptions {
   void SetWaitForJitNotificationsToSave(bool value) {
     wait_for_jit_notifications_to_save_ = value;
   }
+  uint32_t GetHotnessSamplingIntervalMs() const {
+    return hotness_sampling_interval_ms_;
+  }
 
   friend std::ostream & operator<<(std::ostream &os, const ProfileSaverOptions& pso) {
     os << "enabled_" << pso.enabled_
@@ -140,7 +149,8 @@ struct ProfileSaverOptions {
         << ", max_notification_before_wake_" << pso.max_notification_before_wake_
         << ", profile_boot_class_path_" << pso.profile_boot_class_path_
         << ", profile_aot_code_" << pso.profile_aot_code_
-        << ", wait_for_jit_notifications_to_save_" << pso.wait_for_jit_notifications_to_save_;
+        << ", wait_for_jit_notifications_to_save_" << pso.wait_for_jit_notifications_to_save_
+        << ", hotness_sampling_interval_ms_" << pso.hotness_sampling_interval_ms_;
     return os;
   }
 
@@ -159,6 +169,9 @@ struct ProfileSaverOptions {
   bool profile_boot_class_path_;
   bool profile_aot_code_;
   bool wait_for_jit_notifications_to_save_;
+  // Interval of the timer-driven stack sampler which records method hotness in
+  // the profile. Zero (the default) disables the sampler.
+  uint32_t hotness_sampling_interval_ms_;
 };
 
 }  // namespace art
@@ -19,6 +19,7 @@
 #include <sys/mman.h>
 #include <zlib.h>
 
+#include <atomic>
 #include <iomanip>
 
 #include <android-base/logging.h>
@@ -4053,6 +4054,356 @@ const JNINativeInterface gCheckNativeInterface = {
   CheckJNI::GetObjectRefType,
 };
 
+// Sampled CheckJNI.
+//
+// The sampling table below routes one in every gCheckJniSamplingInterval calls,
+// counted per JNI function, through the full CheckJNI implementation and the rest
+// through the unchecked functions. This keeps a useful fraction of CheckJNI's bug
+// detection at a cost low enough for dogfood and production builds.
+
+// Sampling interval N: full checking for one in every N calls per function. 0 while
+// sampling is disabled.
+std::atomic<uint32_t> gCheckJniSamplingInterval(0u);
+
+// Returns the function table a sampled call should dispatch through, advancing the
+// given per-function counter.
+ALWAYS_INLINE inline const JNINativeInterface* SamplingBaseEnv(
+    std::atomic<uint32_t>* counter) {
+  uint32_t interval = gCheckJniSamplingInterval.load(std::memory_order_relaxed);
+  if (UNLIKELY(interval != 0u &&
+               counter->fetch_add(1u, std::memory_order_relaxed) % interval == 0u)) {
+    return &gCheckNativeInterface;
+  }
+  return GetJniNativeInterface();
+}
+
+// Generic trampoline for the fixed-arity JNI functions. Each instantiation carries
+// its own call counter and forwards to the table chosen for this call.
+template <auto kMember>
+struct SamplingJniStub;
+
+template <typename Ret, typename... Args, Ret (*JNINativeInterface::*kMember)(Args...)>
+struct SamplingJniStub<kMember> {
+  static Ret Fn(Args... args) {
+    static std::atomic<uint32_t> counter(0u);
+    return (SamplingBaseEnv(&counter)->*kMember)(args...);
+  }
+};
+
+// The variadic JNI functions cannot be forwarded generically; hand them off to the
+// corresponding V variant of the chosen table instead.
+class SamplingJNI {
+ public:
+  static jobject NewObject(JNIEnv* env, jclass c, jmethodID mid, ...) {
+    static std::atomic<uint32_t> counter(0u);
+    va_list ap;
+    va_start(ap, mid);
+    jobject result = SamplingBaseEnv(&counter)->NewObjectV(env, c, mid, ap);
+    va_end(ap);
+    return result;
+  }
+
+#define SAMPLING_CALL_METHOD(_ctype, _jname) \
+  static _ctype Call##_jname##Method(JNIEnv* env, jobject obj, jmethodID mid, ...) { \
+    static std::atomic<uint32_t> counter(0u); \
+    va_list ap; \
+    va_start(ap, mid); \
+    _ctype result = SamplingBaseEnv(&counter)->Call##_jname##MethodV(env, obj, mid, ap); \
+    va_end(ap); \
+    return result; \
+  } \
+  static _ctype CallNonvirtual##_jname##Method(JNIEnv* env, jobject obj, jclass c, \
+                                               jmethodID mid, ...) { \
+    static std::atomic<uint32_t> counter(0u); \
+    va_list ap; \
+    va_start(ap, mid); \
+    _ctype result = \
+        SamplingBaseEnv(&counter)->CallNonvirtual##_jname##MethodV(env, obj, c, mid, ap); \
+    va_end(ap); \
+    return result; \
+  } \
+  static _ctype CallStatic##_jname##Method(JNIEnv* env, jclass c, jmethodID mid, ...) { \
+    static std::atomic<uint32_t> counter(0u); \
+    va_list ap; \
+    va_start(ap, mid); \
+    _ctype result = SamplingBaseEnv(&counter)->CallStatic##_jname##MethodV(env, c, mid, ap); \
+    va_end(ap); \
+    return result; \
+  }
+
+  SAMPLING_CALL_METHOD(jobject, Object)
+  SAMPLING_CALL_METHOD(jboolean, Boolean)
+  SAMPLING_CALL_METHOD(jbyte, Byte)
+  SAMPLING_CALL_METHOD(jchar, Char)
+  SAMPLING_CALL_METHOD(jshort, Short)
+  SAMPLING_CALL_METHOD(jint, Int)
+  SAMPLING_CALL_METHOD(jlong, Long)
+  SAMPLING_CALL_METHOD(jfloat, Float)
+  SAMPLING_CALL_METHOD(jdouble, Double)
+
+#undef SAMPLING_CALL_METHOD
+
+  static void CallVoidMethod(JNIEnv* env, jobject obj, jmethodID mid, ...) {
+    static std::atomic<uint32_t> counter(0u);
+    va_list ap;
+    va_start(ap, mid);
+    SamplingBaseEnv(&counter)->CallVoidMethodV(env, obj, mid, ap);
+    va_end(ap);
+  }
+
+  static void CallNonvirtualVoidMethod(JNIEnv* env, jobject obj, jclass c, jmethodID mid, ...) {
+    static std::atomic<uint32_t> counter(0u);
+    va_list ap;
+    va_start(ap, mid);
+    SamplingBaseEnv(&counter)->CallNonvirtualVoidMethodV(env, obj, c, mid, ap);
+    va_end(ap);
+  }
+
+  static void CallStaticVoidMethod(JNIEnv* env, jclass c, jmethodID mid, ...) {
+    static std::atomic<uint32_t> counter(0u);
+    va_list ap;
+    va_start(ap, mid);
+    SamplingBaseEnv(&counter)->CallStaticVoidMethodV(env, c, mid, ap);
+    va_end(ap);
+  }
+};
+
+const JNINativeInterface gSamplingNativeInterface = {
+  nullptr,  // reserved0.
+  nullptr,  // reserved1.
+  nullptr,  // reserved2.
+  nullptr,  // reserved3.
+  SamplingJniStub<&JNINativeInterface::GetVersion>::Fn,
+  SamplingJniStub<&JNINativeInterface::DefineClass>::Fn,
+  SamplingJniStub<&JNINativeInterface::FindClass>::Fn,
+  SamplingJniStub<&JNINativeInterface::FromReflectedMethod>::Fn,
+  SamplingJniStub<&JNINativeInterface::FromReflectedField>::Fn,
+  SamplingJniStub<&JNINativeInterface::ToReflectedMethod>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetSuperclass>::Fn,
+  SamplingJniStub<&JNINativeInterface::IsAssignableFrom>::Fn,
+  SamplingJniStub<&JNINativeInterface::ToReflectedField>::Fn,
+  SamplingJniStub<&JNINativeInterface::Throw>::Fn,
+  SamplingJniStub<&JNINativeInterface::ThrowNew>::Fn,
+  SamplingJniStub<&JNINativeInterface::ExceptionOccurred>::Fn,
+  SamplingJniStub<&JNINativeInterface::ExceptionDescribe>::Fn,
+  SamplingJniStub<&JNINativeInterface::ExceptionClear>::Fn,
+  SamplingJniStub<&JNINativeInterface::FatalError>::Fn,
+  SamplingJniStub<&JNINativeInterface::PushLocalFrame>::Fn,
+  SamplingJniStub<&JNINativeInterface::PopLocalFrame>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewGlobalRef>::Fn,
+  SamplingJniStub<&JNINativeInterface::DeleteGlobalRef>::Fn,
+  SamplingJniStub<&JNINativeInterface::DeleteLocalRef>::Fn,
+  SamplingJniStub<&JNINativeInterface::IsSameObject>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewLocalRef>::Fn,
+  SamplingJniStub<&JNINativeInterface::EnsureLocalCapacity>::Fn,
+  SamplingJniStub<&JNINativeInterface::AllocObject>::Fn,
+  SamplingJNI::NewObject,
+  SamplingJniStub<&JNINativeInterface::NewObjectV>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewObjectA>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetObjectClass>::Fn,
+  SamplingJniStub<&JNINativeInterface::IsInstanceOf>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetMethodID>::Fn,
+  SamplingJNI::CallObjectMethod,
+  SamplingJniStub<&JNINativeInterface::CallObjectMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallObjectMethodA>::Fn,
+  SamplingJNI::CallBooleanMethod,
+  SamplingJniStub<&JNINativeInterface::CallBooleanMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallBooleanMethodA>::Fn,
+  SamplingJNI::CallByteMethod,
+  SamplingJniStub<&JNINativeInterface::CallByteMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallByteMethodA>::Fn,
+  SamplingJNI::CallCharMethod,
+  SamplingJniStub<&JNINativeInterface::CallCharMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallCharMethodA>::Fn,
+  SamplingJNI::CallShortMethod,
+  SamplingJniStub<&JNINativeInterface::CallShortMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallShortMethodA>::Fn,
+  SamplingJNI::CallIntMethod,
+  SamplingJniStub<&JNINativeInterface::CallIntMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallIntMethodA>::Fn,
+  SamplingJNI::CallLongMethod,
+  SamplingJniStub<&JNINativeInterface::CallLongMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallLongMethodA>::Fn,
+  SamplingJNI::CallFloatMethod,
+  SamplingJniStub<&JNINativeInterface::CallFloatMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallFloatMethodA>::Fn,
+  SamplingJNI::CallDoubleMethod,
+  SamplingJniStub<&JNINativeInterface::CallDoubleMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallDoubleMethodA>::Fn,
+  SamplingJNI::CallVoidMethod,
+  SamplingJniStub<&JNINativeInterface::CallVoidMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallVoidMethodA>::Fn,
+  SamplingJNI::CallNonvirtualObjectMethod,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualObjectMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualObjectMethodA>::Fn,
+  SamplingJNI::CallNonvirtualBooleanMethod,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualBooleanMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualBooleanMethodA>::Fn,
+  SamplingJNI::CallNonvirtualByteMethod,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualByteMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualByteMethodA>::Fn,
+  SamplingJNI::CallNonvirtualCharMethod,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualCharMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualCharMethodA>::Fn,
+  SamplingJNI::CallNonvirtualShortMethod,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualShortMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualShortMethodA>::Fn,
+  SamplingJNI::CallNonvirtualIntMethod,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualIntMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualIntMethodA>::Fn,
+  SamplingJNI::CallNonvirtualLongMethod,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualLongMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualLongMethodA>::Fn,
+  SamplingJNI::CallNonvirtualFloatMethod,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualFloatMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualFloatMethodA>::Fn,
+  SamplingJNI::CallNonvirtualDoubleMethod,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualDoubleMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualDoubleMethodA>::Fn,
+  SamplingJNI::CallNonvirtualVoidMethod,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualVoidMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallNonvirtualVoidMethodA>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetFieldID>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetObjectField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetBooleanField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetByteField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetCharField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetShortField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetIntField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetLongField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetFloatField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetDoubleField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetObjectField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetBooleanField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetByteField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetCharField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetShortField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetIntField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetLongField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetFloatField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetDoubleField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStaticMethodID>::Fn,
+  SamplingJNI::CallStaticObjectMethod,
+  SamplingJniStub<&JNINativeInterface::CallStaticObjectMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallStaticObjectMethodA>::Fn,
+  SamplingJNI::CallStaticBooleanMethod,
+  SamplingJniStub<&JNINativeInterface::CallStaticBooleanMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallStaticBooleanMethodA>::Fn,
+  SamplingJNI::CallStaticByteMethod,
+  SamplingJniStub<&JNINativeInterface::CallStaticByteMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallStaticByteMethodA>::Fn,
+  SamplingJNI::CallStaticCharMethod,
+  SamplingJniStub<&JNINativeInterface::CallStaticCharMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallStaticCharMethodA>::Fn,
+  SamplingJNI::CallStaticShortMethod,
+  SamplingJniStub<&JNINativeInterface::CallStaticShortMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallStaticShortMethodA>::Fn,
+  SamplingJNI::CallStaticIntMethod,
+  SamplingJniStub<&JNINativeInterface::CallStaticIntMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallStaticIntMethodA>::Fn,
+  SamplingJNI::CallStaticLongMethod,
+  SamplingJniStub<&JNINativeInterface::CallStaticLongMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallStaticLongMethodA>::Fn,
+  SamplingJNI::CallStaticFloatMethod,
+  SamplingJniStub<&JNINativeInterface::CallStaticFloatMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallStaticFloatMethodA>::Fn,
+  SamplingJNI::CallStaticDoubleMethod,
+  SamplingJniStub<&JNINativeInterface::CallStaticDoubleMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallStaticDoubleMethodA>::Fn,
+  SamplingJNI::CallStaticVoidMethod,
+  SamplingJniStub<&JNINativeInterface::CallStaticVoidMethodV>::Fn,
+  SamplingJniStub<&JNINativeInterface::CallStaticVoidMethodA>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStaticFieldID>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStaticObjectField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStaticBooleanField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStaticByteField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStaticCharField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStaticShortField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStaticIntField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStaticLongField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStaticFloatField>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStaticDoubleField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetStaticObjectField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetStaticBooleanField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetStaticByteField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetStaticCharField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetStaticShortField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetStaticIntField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetStaticLongField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetStaticFloatField>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetStaticDoubleField>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewString>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStringLength>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStringChars>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleaseStringChars>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewStringUTF>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStringUTFLength>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStringUTFChars>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleaseStringUTFChars>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetArrayLength>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewObjectArray>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetObjectArrayElement>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetObjectArrayElement>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewBooleanArray>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewByteArray>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewCharArray>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewShortArray>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewIntArray>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewLongArray>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewFloatArray>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewDoubleArray>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetBooleanArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetByteArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetCharArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetShortArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetIntArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetLongArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetFloatArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetDoubleArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleaseBooleanArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleaseByteArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleaseCharArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleaseShortArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleaseIntArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleaseLongArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleaseFloatArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleaseDoubleArrayElements>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetBooleanArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetByteArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetCharArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetShortArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetIntArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetLongArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetFloatArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetDoubleArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetBooleanArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetByteArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetCharArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetShortArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetIntArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetLongArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetFloatArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::SetDoubleArrayRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::RegisterNatives>::Fn,
+  SamplingJniStub<&JNINativeInterface::UnregisterNatives>::Fn,
+  SamplingJniStub<&JNINativeInterface::MonitorEnter>::Fn,
+  SamplingJniStub<&JNINativeInterface::MonitorExit>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetJavaVM>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStringRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStringUTFRegion>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetPrimitiveArrayCritical>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleasePrimitiveArrayCritical>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetStringCritical>::Fn,
+  SamplingJniStub<&JNINativeInterface::ReleaseStringCritical>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewWeakGlobalRef>::Fn,
+  SamplingJniStub<&JNINativeInterface::DeleteWeakGlobalRef>::Fn,
+  SamplingJniStub<&JNINativeInterface::ExceptionCheck>::Fn,
+  SamplingJniStub<&JNINativeInterface::NewDirectByteBuffer>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetDirectBufferAddress>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetDirectBufferCapacity>::Fn,
+  SamplingJniStub<&JNINativeInterface::GetObjectRefType>::Fn,
+};
+
 class CheckJII {
  public:
   static jint DestroyJavaVM(JavaVM* vm) {
@@ -4134,4 +4485,16 @@ const JNIInvokeInterface* GetCheckJniInvokeInterface() {
   return &gCheckInvokeInterface;
 }
 
+const JNINativeInterface* GetSamplingCheckJniNativeInterface() {
+  return &gSamplingNativeInterface;
+}
+
+void SetCheckJniSamplingInterval(uint32_t interval) {
+  gCheckJniSamplingInterval.store(interval, std::memory_order_relaxed);
+}
+
+uint32_t GetCheckJniSamplingInterval() {
+  return gCheckJniSamplingInterval.load(std::memory_order_relaxed);
+}
+
 }  // namespace art
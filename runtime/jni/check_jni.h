@@ -19,11 +19,22 @@
 
 #include <jni.h>
 
+#include <stdint.h>
+
 namespace art {
 
 const JNINativeInterface* GetCheckJniNativeInterface();
 const JNIInvokeInterface* GetCheckJniInvokeInterface();
 
+// Sampled CheckJNI: a JNI function table whose entries route one in every N calls
+// (counted per function) through the full CheckJNI implementation and the rest
+// through the unchecked functions.
+const JNINativeInterface* GetSamplingCheckJniNativeInterface();
+
+// Set/get the sampling interval N. 0 disables sampling.
+void SetCheckJniSamplingInterval(uint32_t interval);
+uint32_t GetCheckJniSamplingInterval();
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_JNI_CHECK_JNI_H_
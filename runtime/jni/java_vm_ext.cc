@@ -35,6 +35,7 @@
 #include "gc/heap.h"
 #include "gc_root-inl.h"
 #include "indirect_reference_table-inl.h"
+#include "jni_env_ext.h"
 #include "jni_internal.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
@@ -510,12 +511,14 @@ JavaVMExt::JavaVMExt(Runtime* runtime,
                                   (CHECK(Locks::jni_weak_globals_lock_ != nullptr),
                                    *Locks::jni_weak_globals_lock_)),
       env_hooks_(),
+      env_cache_lock_("JNIEnv cache lock"),
       enable_allocation_tracking_delta_(
           runtime_options.GetOrDefault(RuntimeArgumentMap::GlobalRefAllocStackTraceLimit)),
       allocation_tracking_enabled_(false),
       old_allocation_tracking_state_(false) {
   functions = unchecked_functions_;
-  SetCheckJniEnabled(runtime_options.Exists(RuntimeArgumentMap::CheckJni));
+  SetCheckJniEnabled(runtime_options.Exists(RuntimeArgumentMap::CheckJni),
+                     runtime_options.GetOrDefault(RuntimeArgumentMap::CheckJniSamplingInterval));
 }
 
 JavaVMExt::~JavaVMExt() {
@@ -555,6 +558,36 @@ void JavaVMExt::AddEnvironmentHook(GetEnvHook hook) {
   env_hooks_.push_back(hook);
 }
 
+JNIEnvExt* JavaVMExt::CreateJniEnv(Thread* self, std::string* error_msg) {
+  std::unique_ptr<JNIEnvExt> env;
+  {
+    MutexLock mu(self, env_cache_lock_);
+    if (!env_cache_.empty()) {
+      env = std::move(env_cache_.back());
+      env_cache_.pop_back();
+    }
+  }
+  if (env != nullptr) {
+    // Reset outside of env_cache_lock_; it takes the JNI function table lock.
+    env->Reset(self);
+    return env.release();
+  }
+  return JNIEnvExt::Create(self, this, error_msg);
+}
+
+void JavaVMExt::RecycleJniEnv(JNIEnvExt* env) {
+  DCHECK(env != nullptr);
+  std::unique_ptr<JNIEnvExt> owned(env);
+  // An env whose function table was swapped to the runtime shutdown functions
+  // must not be handed to a new thread.
+  if (!owned->IsRuntimeDeleted()) {
+    MutexLock mu(Thread::Current(), env_cache_lock_);
+    if (env_cache_.size() < kMaxCachedJniEnvs) {
+      env_cache_.push_back(std::move(owned));
+    }
+  }
+}
+
 void JavaVMExt::JniAbort(const char* jni_function_name, const char* msg) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
@@ -732,9 +765,11 @@ static void ThreadEnableCheckJni(Thread* thread, void* arg) {
   thread->GetJniEnv()->SetCheckJniEnabled(*check_jni);
 }
 
-bool JavaVMExt::SetCheckJniEnabled(bool enabled) {
+bool JavaVMExt::SetCheckJniEnabled(bool enabled, uint32_t sampling_interval) {
   bool old_check_jni = check_jni_;
   check_jni_ = enabled;
+  // Full checking subsumes sampling; the sampled tables are only used while it is off.
+  SetCheckJniSamplingInterval(enabled ? 0u : sampling_interval);
   functions = enabled ? GetCheckJniInvokeInterface() : unchecked_functions_;
   MutexLock mu(Thread::Current(), *Locks::thread_list_lock_);
   runtime_->GetThreadList()->ForEach(ThreadEnableCheckJni, &check_jni_);
@@ -743,6 +778,9 @@ bool JavaVMExt::SetCheckJniEnabled(bool enabled) {
 
 void JavaVMExt::DumpForSigQuit(std::ostream& os) {
   os << "JNI: CheckJNI is " << (check_jni_ ? "on" : "off");
+  if (!check_jni_ && GetCheckJniSamplingInterval() != 0u) {
+    os << " (sampling 1-in-" << GetCheckJniSamplingInterval() << ")";
+  }
   if (force_copy_) {
     os << " (with forcecopy)";
   }
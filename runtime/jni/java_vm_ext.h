@@ -33,6 +33,7 @@ class Array;
 
 class ArtMethod;
 class IsMarkedVisitor;
+class JNIEnvExt;
 class Libraries;
 class ParsedOptions;
 class Runtime;
@@ -133,7 +134,12 @@ class JavaVMExt : public JavaVM {
                !Locks::jni_weak_globals_lock_,
                !Locks::alloc_tracker_lock_);
 
-  bool SetCheckJniEnabled(bool enabled);
+  // Enable or disable CheckJNI. When disabling, a non-zero sampling_interval
+  // instead installs the sampled CheckJNI tables, which run one in every
+  // sampling_interval calls per JNI function through full checking; this is cheap
+  // enough to leave enabled outside of debug builds. Returns the previous
+  // full-checking state.
+  bool SetCheckJniEnabled(bool enabled, uint32_t sampling_interval = 0u);
 
   void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::jni_globals_lock_);
@@ -204,6 +210,17 @@ class JavaVMExt : public JavaVM {
 
   void AddEnvironmentHook(GetEnvHook hook);
 
+  // Hand out a JNIEnvExt for an attaching thread, reusing a cached instance
+  // from a previously detached thread when one is available so that
+  // attach/detach-heavy native code does not recreate the local reference
+  // table on every AttachCurrentThread. Falls back to creating a new env.
+  JNIEnvExt* CreateJniEnv(Thread* self, std::string* error_msg)
+      REQUIRES(!Locks::jni_function_table_lock_);
+
+  // Return a detached thread's env to the cache for reuse by a later attach,
+  // or delete it if the cache is full or the env is no longer reusable.
+  void RecycleJniEnv(JNIEnvExt* env);
+
   static bool IsBadJniVersion(int version);
 
   // Return the library search path for the given classloader, if the classloader is of a
@@ -260,6 +277,11 @@ class JavaVMExt : public JavaVM {
   // TODO Maybe move this to Runtime.
   std::vector<GetEnvHook> env_hooks_;
 
+  // Bounded cache of envs from detached threads, reused by CreateJniEnv().
+  static constexpr size_t kMaxCachedJniEnvs = 4;
+  Mutex env_cache_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<std::unique_ptr<JNIEnvExt>> env_cache_ GUARDED_BY(env_cache_lock_);
+
   size_t enable_allocation_tracking_delta_;
   std::atomic<bool> allocation_tracking_enabled_;
   std::atomic<bool> old_allocation_tracking_state_;
@@ -92,6 +92,18 @@ void JNIEnvExt::SetFunctionsToRuntimeShutdownFunctions() {
   functions = GetRuntimeShutdownNativeInterface();
 }
 
+void JNIEnvExt::Reset(Thread* self_in) {
+  DCHECK_EQ(monitors_.Size(), 0u);
+  self_ = self_in;
+  local_ref_cookie_ = kIRTFirstSegment;
+  locals_.SetSegmentState(kIRTFirstSegment);
+  stacked_local_ref_cookies_.clear();
+  locked_objects_.clear();
+  critical_ = 0;
+  runtime_deleted_.store(false, std::memory_order_relaxed);
+  SetCheckJniEnabled(vm_->IsCheckJniEnabled());
+}
+
 JNIEnvExt::~JNIEnvExt() {
 }
 
@@ -134,6 +146,9 @@ void JNIEnvExt::PushFrame(int capacity) {
   DCHECK_GE(locals_.FreeCapacity(), static_cast<size_t>(capacity));
   stacked_local_ref_cookies_.push_back(local_ref_cookie_);
   local_ref_cookie_ = locals_.GetSegmentState();
+  // The new segment is empty; prime the hole bookkeeping so adds into it start on the
+  // reserved pointer-bump fast path (PushLocalFrame just ensured the capacity).
+  locals_.NoteFreshSegment();
 }
 
 void JNIEnvExt::PopFrame() {
@@ -320,7 +335,11 @@ const JNINativeInterface* JNIEnvExt::GetFunctionTable(bool check_jni) {
   if (override != nullptr) {
     return override;
   }
-  return check_jni ? GetCheckJniNativeInterface() : GetJniNativeInterface();
+  if (check_jni) {
+    return GetCheckJniNativeInterface();
+  }
+  return GetCheckJniSamplingInterval() != 0u ? GetSamplingCheckJniNativeInterface()
+                                             : GetJniNativeInterface();
 }
 
 void JNIEnvExt::ResetFunctionTable() {
@@ -154,6 +154,14 @@ class JNIEnvExt : public JNIEnv {
   static void ResetFunctionTable()
       REQUIRES(!Locks::thread_list_lock_, !Locks::jni_function_table_lock_);
 
+  // Reset this env for reuse by a freshly attaching thread: rebind the owner,
+  // revert the local reference table to its initial segment and refresh the
+  // function table in case CheckJNI was toggled while the env sat in the
+  // JavaVMExt cache. The env is not attached to any thread while cached, so
+  // "locals" can be reset without the mutator lock (cf. CheckLocalsValid).
+  void Reset(Thread* self)
+      REQUIRES(!Locks::jni_function_table_lock_) NO_THREAD_SAFETY_ANALYSIS;
+
  private:
   // Checking "locals" requires the mutator lock, but at creation time we're
   // really only interested in validity, which isn't changing. To avoid grabbing
@@ -169,8 +177,9 @@ class JNIEnvExt : public JNIEnv {
   JNIEnvExt(Thread* self, JavaVMExt* vm, std::string* error_msg)
       REQUIRES(!Locks::jni_function_table_lock_);
 
-  // Link to Thread::Current().
-  Thread* const self_;
+  // Link to Thread::Current(). Not const: rebound by Reset() when a cached
+  // env is reused by a new thread.
+  Thread* self_;
 
   // The invocation interface JavaVM.
   JavaVMExt* const vm_;
@@ -19,6 +19,7 @@
 #include <cstdarg>
 #include <log/log.h>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 
 #include "art_field-inl.h"
@@ -2480,6 +2481,34 @@ class JNI {
       return JNI_OK;
     }
     CHECK_NON_NULL_ARGUMENT_FN_NAME("RegisterNatives", methods, JNI_ERR);
+
+    // For bulk registrations, index the methods of `c` by name and signature up front.
+    // Scanning the class's method array for every JNINativeMethod entry is quadratic
+    // when a library registers hundreds of natives, and nearly all entries resolve in
+    // the given class itself. ArtMethod pointers are stable, so the index stays valid
+    // across the registration loop.
+    static constexpr jint kMethodIndexThreshold = 8;
+    std::unordered_map<std::string, ArtMethod*> method_index;
+    if (method_count >= kMethodIndexThreshold) {
+      const PointerSize pointer_size = class_linker->GetImagePointerSize();
+      // Insert native methods first so that they take precedence over non-native methods
+      // with the same name and signature, matching the scan order below.
+      for (auto& method : c->GetMethods(pointer_size)) {
+        if (method.IsNative()) {
+          std::string key(method.GetName());
+          key += method.GetSignature().ToString();
+          method_index.emplace(std::move(key), &method);
+        }
+      }
+      for (auto& method : c->GetMethods(pointer_size)) {
+        if (!method.IsNative()) {
+          std::string key(method.GetName());
+          key += method.GetSignature().ToString();
+          method_index.emplace(std::move(key), &method);
+        }
+      }
+    }
+
     for (jint i = 0; i < method_count; ++i) {
       const char* name = methods[i].name;
       const char* sig = methods[i].signature;
@@ -2533,9 +2562,20 @@ class JNI {
       // first, either as a direct or a virtual method. Then move to
       // the parent.
       ArtMethod* m = nullptr;
+      if (!method_index.empty()) {
+        std::string key(name);
+        key += sig;
+        auto it = method_index.find(key);
+        if (it != method_index.end()) {
+          m = it->second;
+        }
+      }
       bool warn_on_going_to_parent = down_cast<JNIEnvExt*>(env)->GetVm()->IsCheckJniEnabled();
+      // If the index missed (or was not built), fall back to scanning the class
+      // hierarchy. The scan starts at `c` again; an index miss means it will not match
+      // there, but that is the uncommon path and keeps the parent-walk logic in one place.
       for (ObjPtr<mirror::Class> current_class = c.Get();
-           current_class != nullptr;
+           m == nullptr && current_class != nullptr;
            current_class = current_class->GetSuperClass()) {
         // Search first only comparing methods which are native.
         m = FindMethod<true>(current_class, name, sig);
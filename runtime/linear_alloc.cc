@@ -17,44 +17,87 @@
 #include "linear_alloc.h"
 
 #include "thread-current-inl.h"
+#include "thread.h"
 
 namespace art {
 
-LinearAlloc::LinearAlloc(ArenaPool* pool) : lock_("linear alloc"), allocator_(pool) {
+LinearAlloc::LinearAlloc(ArenaPool* pool) {
+  shards_.reserve(kNumShards);
+  for (size_t i = 0u; i != kNumShards; ++i) {
+    shards_.push_back(std::make_unique<Shard>(pool));
+  }
+}
+
+LinearAlloc::Shard* LinearAlloc::ShardFor(Thread* self, size_t size) {
+  if (size >= kSharedShardAllocThreshold) {
+    return shards_[0].get();
+  }
+  return shards_[self->GetThreadId() % kNumShards].get();
 }
 
 void* LinearAlloc::Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size) {
-  MutexLock mu(self, lock_);
-  return allocator_.Realloc(ptr, old_size, new_size);
+  if (ptr != nullptr) {
+    // Reallocate in the shard which made the original allocation so that the allocator
+    // can extend the block in place when it was the most recent allocation.
+    for (const std::unique_ptr<Shard>& shard : shards_) {
+      MutexLock mu(self, shard->lock_);
+      if (shard->allocator_.Contains(ptr)) {
+        return shard->allocator_.Realloc(ptr, old_size, new_size);
+      }
+    }
+    LOG(FATAL) << "Attempting to realloc a pointer not from this linear alloc";
+    UNREACHABLE();
+  }
+  Shard* const shard = ShardFor(self, new_size);
+  MutexLock mu(self, shard->lock_);
+  return shard->allocator_.Realloc(ptr, old_size, new_size);
 }
 
 void* LinearAlloc::Alloc(Thread* self, size_t size) {
-  MutexLock mu(self, lock_);
-  return allocator_.Alloc(size);
+  Shard* const shard = ShardFor(self, size);
+  MutexLock mu(self, shard->lock_);
+  return shard->allocator_.Alloc(size);
 }
 
 void* LinearAlloc::AllocAlign16(Thread* self, size_t size) {
-  MutexLock mu(self, lock_);
-  return allocator_.AllocAlign16(size);
+  Shard* const shard = ShardFor(self, size);
+  MutexLock mu(self, shard->lock_);
+  return shard->allocator_.AllocAlign16(size);
 }
 
 size_t LinearAlloc::GetUsedMemory() const {
-  MutexLock mu(Thread::Current(), lock_);
-  return allocator_.BytesUsed();
+  Thread* const self = Thread::Current();
+  size_t bytes_used = 0u;
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    MutexLock mu(self, shard->lock_);
+    bytes_used += shard->allocator_.BytesUsed();
+  }
+  return bytes_used;
 }
 
 ArenaPool* LinearAlloc::GetArenaPool() {
-  MutexLock mu(Thread::Current(), lock_);
-  return allocator_.GetArenaPool();
+  MutexLock mu(Thread::Current(), shards_[0]->lock_);
+  return shards_[0]->allocator_.GetArenaPool();
 }
 
 bool LinearAlloc::Contains(void* ptr) const {
-  MutexLock mu(Thread::Current(), lock_);
-  return allocator_.Contains(ptr);
+  Thread* const self = Thread::Current();
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    MutexLock mu(self, shard->lock_);
+    if (shard->allocator_.Contains(ptr)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 bool LinearAlloc::ContainsUnsafe(void* ptr) const {
-  return allocator_.Contains(ptr);
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    if (shard->allocator_.Contains(ptr)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 }  // namespace art
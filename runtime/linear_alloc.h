@@ -17,7 +17,11 @@
 #ifndef ART_RUNTIME_LINEAR_ALLOC_H_
 #define ART_RUNTIME_LINEAR_ALLOC_H_
 
+#include <memory>
+#include <vector>
+
 #include "base/arena_allocator.h"
+#include "base/globals.h"
 #include "base/mutex.h"
 
 namespace art {
@@ -29,33 +33,50 @@ class LinearAlloc {
  public:
   explicit LinearAlloc(ArenaPool* pool);
 
-  void* Alloc(Thread* self, size_t size) REQUIRES(!lock_);
-  void* AllocAlign16(Thread* self, size_t size) REQUIRES(!lock_);
+  void* Alloc(Thread* self, size_t size);
+  void* AllocAlign16(Thread* self, size_t size);
 
   // Realloc never frees the input pointer, it is the caller's job to do this if necessary.
-  void* Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size) REQUIRES(!lock_);
+  void* Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size);
 
   // Allocate an array of structs of type T.
   template<class T>
-  T* AllocArray(Thread* self, size_t elements) REQUIRES(!lock_) {
+  T* AllocArray(Thread* self, size_t elements) {
     return reinterpret_cast<T*>(Alloc(self, elements * sizeof(T)));
   }
 
   // Return the number of bytes used in the allocator.
-  size_t GetUsedMemory() const REQUIRES(!lock_);
+  size_t GetUsedMemory() const;
 
-  ArenaPool* GetArenaPool() REQUIRES(!lock_);
+  ArenaPool* GetArenaPool();
 
   // Return true if the linear alloc contrains an address.
-  bool Contains(void* ptr) const REQUIRES(!lock_);
+  bool Contains(void* ptr) const;
 
   // Unsafe version of 'Contains' only to be used when the allocator is going
   // to be deleted.
   bool ContainsUnsafe(void* ptr) const NO_THREAD_SAFETY_ANALYSIS;
 
  private:
-  mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
-  ArenaAllocator allocator_ GUARDED_BY(lock_);
+  // Allocations are sharded by thread over a small number of arena allocators, all backed
+  // by the same pool, so that parallel class loading threads do not serialize on a single
+  // lock. Large blocks all go to the first shard to avoid stranding free arena space in
+  // the per-thread shards. The shards only take arenas from the pool on first use, so a
+  // linear alloc used from a single thread retains a single partial arena as before.
+  static constexpr size_t kNumShards = 4u;
+  static constexpr size_t kSharedShardAllocThreshold = 16u * KB;
+
+  struct Shard {
+    explicit Shard(ArenaPool* pool) : lock_("linear alloc shard"), allocator_(pool) {}
+
+    mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+    ArenaAllocator allocator_ GUARDED_BY(lock_);
+  };
+
+  // Select the shard for an allocation of `size` bytes by `self`.
+  Shard* ShardFor(Thread* self, size_t size);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(LinearAlloc);
 };
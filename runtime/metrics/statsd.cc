@@ -106,6 +106,10 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
     case DatumId::kFullGcTracingThroughputAvg:
       return std::make_optional(
           statsd::ART_DATUM_REPORTED__KIND__ART_DATUM_GC_FULL_HEAP_TRACING_THROUGHPUT_AVG_MB_PER_SEC);
+    case DatumId::kProcessSpawnTotalTime:
+    case DatumId::kProcessSpawnCount:
+      // Subprocess spawn latency is not reported to statsd yet.
+      return std::nullopt;
   }
 }
 
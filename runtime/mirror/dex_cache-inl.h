@@ -19,6 +19,8 @@
 
 #include "dex_cache.h"
 
+#include <algorithm>
+
 #include <android-base/logging.h>
 
 #include "art_field.h"
@@ -212,7 +214,10 @@ inline CallSite* DexCache::GetResolvedCallSite(uint32_t call_site_idx) {
   GcRoot<mirror::CallSite>& target = GetResolvedCallSites()[call_site_idx];
   Atomic<GcRoot<mirror::CallSite>>& ref =
       reinterpret_cast<Atomic<GcRoot<mirror::CallSite>>&>(target);
-  return ref.load(std::memory_order_seq_cst).Read();
+  // Acquire pairs with the release in SetResolvedCallSite() and makes the contents of the
+  // call site written by the resolving thread visible before the reference is used. This is
+  // the hot path for every invoke-custom, so we do not want the full fence of seq_cst here.
+  return ref.load(std::memory_order_acquire).Read();
 }
 
 inline ObjPtr<CallSite> DexCache::SetResolvedCallSite(uint32_t call_site_idx,
@@ -227,49 +232,71 @@ inline ObjPtr<CallSite> DexCache::SetResolvedCallSite(uint32_t call_site_idx,
   // The first assignment for a given call site wins.
   Atomic<GcRoot<mirror::CallSite>>& ref =
       reinterpret_cast<Atomic<GcRoot<mirror::CallSite>>&>(target);
-  if (ref.CompareAndSetStrongSequentiallyConsistent(null_call_site, candidate)) {
+  if (ref.CompareAndSetStrongRelease(null_call_site, candidate)) {
     // TODO: Fine-grained marking, so that we don't need to go through all arrays in full.
     WriteBarrier::ForEveryFieldWrite(this);
     return call_site;
   } else {
-    return target.Read();
+    // The failed compare-exchange above has relaxed ordering, so re-load the winning call
+    // site with acquire to order its contents before our use of it.
+    return ref.load(std::memory_order_acquire).Read();
   }
 }
 
 inline uint32_t DexCache::FieldSlotIndex(uint32_t field_idx) {
   DCHECK_LT(field_idx, GetDexFile()->NumFieldIds());
   const uint32_t slot_idx = field_idx % kDexCacheFieldCacheSize;
-  DCHECK_LT(slot_idx, NumResolvedFields());
+  // The array is always allocated at its full size, so the slot is in bounds even if
+  // the size field is not visible to this thread yet.
+  DCHECK_LT(slot_idx, std::min<size_t>(kDexCacheFieldCacheSize, GetDexFile()->NumFieldIds()));
   return slot_idx;
 }
 
 inline ArtField* DexCache::GetResolvedField(uint32_t field_idx) {
-  auto pair = GetNativePair(GetResolvedFields(), FieldSlotIndex(field_idx));
+  FieldDexCacheType* fields = GetResolvedFields();
+  if (UNLIKELY(fields == nullptr)) {
+    return nullptr;  // Not yet materialized, take the resolution slow path.
+  }
+  auto pair = GetNativePair(fields, FieldSlotIndex(field_idx));
   return pair.GetObjectForIndex(field_idx);
 }
 
 inline void DexCache::SetResolvedField(uint32_t field_idx, ArtField* field) {
   DCHECK(field != nullptr);
+  FieldDexCacheType* fields = GetResolvedFields();
+  if (UNLIKELY(fields == nullptr)) {
+    fields = AllocateResolvedFields();
+  }
   FieldDexCachePair pair(field, field_idx);
-  SetNativePair(GetResolvedFields(), FieldSlotIndex(field_idx), pair);
+  SetNativePair(fields, FieldSlotIndex(field_idx), pair);
 }
 
 inline uint32_t DexCache::MethodSlotIndex(uint32_t method_idx) {
   DCHECK_LT(method_idx, GetDexFile()->NumMethodIds());
   const uint32_t slot_idx = method_idx % kDexCacheMethodCacheSize;
-  DCHECK_LT(slot_idx, NumResolvedMethods());
+  // The array is always allocated at its full size, so the slot is in bounds even if
+  // the size field is not visible to this thread yet.
+  DCHECK_LT(slot_idx, std::min<size_t>(kDexCacheMethodCacheSize, GetDexFile()->NumMethodIds()));
   return slot_idx;
 }
 
 inline ArtMethod* DexCache::GetResolvedMethod(uint32_t method_idx) {
-  auto pair = GetNativePair(GetResolvedMethods(), MethodSlotIndex(method_idx));
+  MethodDexCacheType* methods = GetResolvedMethods();
+  if (UNLIKELY(methods == nullptr)) {
+    return nullptr;  // Not yet materialized, take the resolution slow path.
+  }
+  auto pair = GetNativePair(methods, MethodSlotIndex(method_idx));
   return pair.GetObjectForIndex(method_idx);
 }
 
 inline void DexCache::SetResolvedMethod(uint32_t method_idx, ArtMethod* method) {
   DCHECK(method != nullptr);
+  MethodDexCacheType* methods = GetResolvedMethods();
+  if (UNLIKELY(methods == nullptr)) {
+    methods = AllocateResolvedMethods();
+  }
   MethodDexCachePair pair(method, method_idx);
-  SetNativePair(GetResolvedMethods(), MethodSlotIndex(method_idx), pair);
+  SetNativePair(methods, MethodSlotIndex(method_idx), pair);
 }
 
 template <typename T>
@@ -57,8 +57,6 @@ void DexCache::InitializeNativeFields(const DexFile* dex_file, LinearAlloc* line
 
   size_t num_strings = std::min<size_t>(kDexCacheStringCacheSize, dex_file->NumStringIds());
   size_t num_types = std::min<size_t>(kDexCacheTypeCacheSize, dex_file->NumTypeIds());
-  size_t num_fields = std::min<size_t>(kDexCacheFieldCacheSize, dex_file->NumFieldIds());
-  size_t num_methods = std::min<size_t>(kDexCacheMethodCacheSize, dex_file->NumMethodIds());
   size_t num_method_types = std::min<size_t>(kDexCacheMethodTypeCacheSize, dex_file->NumProtoIds());
   size_t num_call_sites = dex_file->NumCallSiteIds();  // Full size.
 
@@ -67,14 +65,12 @@ void DexCache::InitializeNativeFields(const DexFile* dex_file, LinearAlloc* line
       AllocArray<StringDexCacheType>(self, linear_alloc, num_strings);
   TypeDexCacheType* types =
       AllocArray<TypeDexCacheType>(self, linear_alloc, num_types);
-  MethodDexCacheType* methods =
-      AllocArray<MethodDexCacheType>(self, linear_alloc, num_methods);
-  FieldDexCacheType* fields =
-      AllocArray<FieldDexCacheType>(self, linear_alloc, num_fields);
   MethodTypeDexCacheType* method_types =
       AllocArray<MethodTypeDexCacheType>(self, linear_alloc, num_method_types);
   GcRoot<mirror::CallSite>* call_sites =
       AllocArray<GcRoot<CallSite>>(self, linear_alloc, num_call_sites);
+  // The resolved method and field arrays are allocated lazily on the first insertion;
+  // see AllocateResolvedMethods() and AllocateResolvedFields().
 
   DCHECK_ALIGNED(types, alignof(StringDexCacheType)) <<
                  "Expected StringsOffset() to align to StringDexCacheType.";
@@ -92,14 +88,6 @@ void DexCache::InitializeNativeFields(const DexFile* dex_file, LinearAlloc* line
       CHECK_EQ(types[i].load(std::memory_order_relaxed).index, 0u);
       CHECK(types[i].load(std::memory_order_relaxed).object.IsNull());
     }
-    for (size_t i = 0; i < num_methods; ++i) {
-      CHECK_EQ(GetNativePair(methods, i).index, 0u);
-      CHECK(GetNativePair(methods, i).object == nullptr);
-    }
-    for (size_t i = 0; i < num_fields; ++i) {
-      CHECK_EQ(GetNativePair(fields, i).index, 0u);
-      CHECK(GetNativePair(fields, i).object == nullptr);
-    }
     for (size_t i = 0; i < num_method_types; ++i) {
       CHECK_EQ(method_types[i].load(std::memory_order_relaxed).index, 0u);
       CHECK(method_types[i].load(std::memory_order_relaxed).object.IsNull());
@@ -114,12 +102,6 @@ void DexCache::InitializeNativeFields(const DexFile* dex_file, LinearAlloc* line
   if (types != nullptr) {
     mirror::TypeDexCachePair::Initialize(types);
   }
-  if (fields != nullptr) {
-    mirror::FieldDexCachePair::Initialize(fields);
-  }
-  if (methods != nullptr) {
-    mirror::MethodDexCachePair::Initialize(methods);
-  }
   if (method_types != nullptr) {
     mirror::MethodTypeDexCachePair::Initialize(method_types);
   }
@@ -128,16 +110,65 @@ void DexCache::InitializeNativeFields(const DexFile* dex_file, LinearAlloc* line
                   num_strings,
                   types,
                   num_types,
-                  methods,
-                  num_methods,
-                  fields,
-                  num_fields,
+                  /*resolved_methods=*/ nullptr,
+                  /*num_resolved_methods=*/ 0u,
+                  /*resolved_fields=*/ nullptr,
+                  /*num_resolved_fields=*/ 0u,
                   method_types,
                   num_method_types,
                   call_sites,
                   num_call_sites);
 }
 
+MethodDexCacheType* DexCache::AllocateResolvedMethods() {
+  Thread* self = Thread::Current();
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  LinearAlloc* linear_alloc = class_linker->GetOrCreateAllocatorForClassLoader(GetClassLoader());
+  // Hold the dex lock across the allocation and the publication so that two threads
+  // racing on the first insertion agree on a single array.
+  WriterMutexLock mu(self, *Locks::dex_lock_);
+  MethodDexCacheType* methods = GetResolvedMethods();
+  if (methods != nullptr) {
+    return methods;  // Raced with another thread; its array won.
+  }
+  size_t num_methods = std::min<size_t>(kDexCacheMethodCacheSize, GetDexFile()->NumMethodIds());
+  DCHECK_NE(num_methods, 0u);  // Insertions imply at least one method id.
+  methods = AllocArray<MethodDexCacheType>(self, linear_alloc, num_methods);
+  mirror::MethodDexCachePair::Initialize(methods);
+  // Publish the array only after its contents are initialized; readers observing the old
+  // null pointer simply take the resolution slow path. The size is published after the
+  // pointer so that racing readers of the size see either zero or the full array.
+  if (kRuntimePointerSize == PointerSize::k64) {
+    SetField64Volatile<false>(ResolvedMethodsOffset(), reinterpret_cast64<int64_t>(methods));
+  } else {
+    SetField32Volatile<false>(ResolvedMethodsOffset(), reinterpret_cast32<int32_t>(methods));
+  }
+  SetField32<false>(NumResolvedMethodsOffset(), num_methods);
+  return methods;
+}
+
+FieldDexCacheType* DexCache::AllocateResolvedFields() {
+  Thread* self = Thread::Current();
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  LinearAlloc* linear_alloc = class_linker->GetOrCreateAllocatorForClassLoader(GetClassLoader());
+  WriterMutexLock mu(self, *Locks::dex_lock_);
+  FieldDexCacheType* fields = GetResolvedFields();
+  if (fields != nullptr) {
+    return fields;  // Raced with another thread; its array won.
+  }
+  size_t num_fields = std::min<size_t>(kDexCacheFieldCacheSize, GetDexFile()->NumFieldIds());
+  DCHECK_NE(num_fields, 0u);  // Insertions imply at least one field id.
+  fields = AllocArray<FieldDexCacheType>(self, linear_alloc, num_fields);
+  mirror::FieldDexCachePair::Initialize(fields);
+  if (kRuntimePointerSize == PointerSize::k64) {
+    SetField64Volatile<false>(ResolvedFieldsOffset(), reinterpret_cast64<int64_t>(fields));
+  } else {
+    SetField32Volatile<false>(ResolvedFieldsOffset(), reinterpret_cast32<int32_t>(fields));
+  }
+  SetField32<false>(NumResolvedFieldsOffset(), num_fields);
+  return fields;
+}
+
 void DexCache::ResetNativeFields() {
   SetDexFile(nullptr);
   SetNativeArrays(nullptr, 0, nullptr, 0, nullptr, 0, nullptr, 0, nullptr, 0, nullptr, 0);
@@ -145,8 +176,10 @@ void DexCache::ResetNativeFields() {
 
 void DexCache::VisitReflectiveTargets(ReflectiveValueVisitor* visitor) {
   bool wrote = false;
-  for (size_t i = 0; i < NumResolvedFields(); i++) {
-    auto pair(GetNativePair(GetResolvedFields(), i));
+  // The arrays are materialized lazily, so they may still be null here.
+  FieldDexCacheType* resolved_fields = GetResolvedFields();
+  for (size_t i = 0; resolved_fields != nullptr && i < NumResolvedFields(); i++) {
+    auto pair(GetNativePair(resolved_fields, i));
     if (pair.index == FieldDexCachePair::InvalidIndexForSlot(i)) {
       continue;
     }
@@ -158,12 +191,13 @@ void DexCache::VisitReflectiveTargets(ReflectiveValueVisitor* visitor) {
       } else {
         pair.object = new_val;
       }
-      SetNativePair(GetResolvedFields(), i, pair);
+      SetNativePair(resolved_fields, i, pair);
       wrote = true;
     }
   }
-  for (size_t i = 0; i < NumResolvedMethods(); i++) {
-    auto pair(GetNativePair(GetResolvedMethods(), i));
+  MethodDexCacheType* resolved_methods = GetResolvedMethods();
+  for (size_t i = 0; resolved_methods != nullptr && i < NumResolvedMethods(); i++) {
+    auto pair(GetNativePair(resolved_methods, i));
     if (pair.index == MethodDexCachePair::InvalidIndexForSlot(i)) {
       continue;
     }
@@ -175,7 +209,7 @@ void DexCache::VisitReflectiveTargets(ReflectiveValueVisitor* visitor) {
       } else {
         pair.object = new_val;
       }
-      SetNativePair(GetResolvedMethods(), i, pair);
+      SetNativePair(resolved_methods, i, pair);
       wrote = true;
     }
   }
@@ -247,6 +281,10 @@ void DexCache::SetClassLoader(ObjPtr<ClassLoader> class_loader) {
   SetFieldObject<false>(OFFSET_OF_OBJECT_MEMBER(DexCache, class_loader_), class_loader);
 }
 
+ObjPtr<ClassLoader> DexCache::GetClassLoader() {
+  return GetFieldObject<ClassLoader>(OFFSET_OF_OBJECT_MEMBER(DexCache, class_loader_));
+}
+
 #if !defined(__aarch64__) && !defined(__x86_64__)
 static pthread_mutex_t dex_cache_slow_atomic_mutex = PTHREAD_MUTEX_INITIALIZER;
 
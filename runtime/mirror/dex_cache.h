@@ -311,6 +311,16 @@ class MANAGED DexCache final : public Object {
   ALWAYS_INLINE void SetResolvedField(uint32_t idx, ArtField* field)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Allocate the resolved method / field cache arrays on first insertion. The arrays are
+  // not preallocated in InitializeNativeFields() since many dex caches never see a single
+  // runtime resolution; allocating on demand keeps their backing pages clean.
+  MethodDexCacheType* AllocateResolvedMethods()
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::dex_lock_);
+  FieldDexCacheType* AllocateResolvedFields()
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::dex_lock_);
+
   MethodType* GetResolvedMethodType(dex::ProtoIndex proto_idx) REQUIRES_SHARED(Locks::mutator_lock_);
 
   void SetResolvedMethodType(dex::ProtoIndex proto_idx, MethodType* resolved)
@@ -473,6 +483,8 @@ class MANAGED DexCache final : public Object {
 
   void SetClassLoader(ObjPtr<ClassLoader> class_loader) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  ObjPtr<ClassLoader> GetClassLoader() REQUIRES_SHARED(Locks::mutator_lock_);
+
  private:
   void SetNativeArrays(StringDexCacheType* strings,
                        uint32_t num_strings,
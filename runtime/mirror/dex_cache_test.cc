@@ -54,10 +54,11 @@ TEST_F(DexCacheTest, Open) {
       || java_lang_dex_file_->NumStringIds() == dex_cache->NumStrings());
   EXPECT_TRUE(dex_cache->StaticTypeSize() == dex_cache->NumResolvedTypes()
       || java_lang_dex_file_->NumTypeIds() == dex_cache->NumResolvedTypes());
-  EXPECT_TRUE(dex_cache->StaticMethodSize() == dex_cache->NumResolvedMethods()
-      || java_lang_dex_file_->NumMethodIds() == dex_cache->NumResolvedMethods());
-  EXPECT_TRUE(dex_cache->StaticArtFieldSize() == dex_cache->NumResolvedFields()
-      || java_lang_dex_file_->NumFieldIds() ==  dex_cache->NumResolvedFields());
+  // The resolved method and field arrays are materialized lazily on first insertion.
+  EXPECT_TRUE(dex_cache->GetResolvedMethods() == nullptr);
+  EXPECT_EQ(0u, dex_cache->NumResolvedMethods());
+  EXPECT_TRUE(dex_cache->GetResolvedFields() == nullptr);
+  EXPECT_EQ(0u, dex_cache->NumResolvedFields());
   EXPECT_TRUE(dex_cache->StaticMethodTypeSize() == dex_cache->NumResolvedMethodTypes()
       || java_lang_dex_file_->NumProtoIds() == dex_cache->NumResolvedMethodTypes());
 }
@@ -87,7 +88,9 @@ TEST_F(DexCacheTest, LinearAlloc) {
   ASSERT_TRUE(klass != nullptr);
   LinearAlloc* const linear_alloc = klass->GetClassLoader()->GetAllocator();
   EXPECT_NE(linear_alloc, runtime_->GetLinearAlloc());
-  EXPECT_TRUE(linear_alloc->Contains(klass->GetDexCache()->GetResolvedMethods()));
+  // Force materialization of the lazily allocated resolved method array and check that it
+  // was allocated in the class loader's allocator rather than the runtime's.
+  EXPECT_TRUE(linear_alloc->Contains(klass->GetDexCache()->AllocateResolvedMethods()));
 }
 
 TEST_F(DexCacheTest, TestResolvedFieldAccess) {
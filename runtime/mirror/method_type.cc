@@ -112,6 +112,11 @@ size_t MethodType::NumberOfVRegs() {
 }
 
 bool MethodType::IsExactMatch(ObjPtr<MethodType> target) {
+  if (target == this) {
+    // Note: The transformer paths pass the same object as both the call site
+    // and the callee type, so this is a common case worth short-circuiting.
+    return true;
+  }
   const ObjPtr<ObjectArray<Class>> p_types = GetPTypes();
   const int32_t params_length = p_types->GetLength();
 
@@ -128,6 +133,9 @@ bool MethodType::IsExactMatch(ObjPtr<MethodType> target) {
 }
 
 bool MethodType::IsConvertible(ObjPtr<MethodType> target) {
+  if (target == this) {
+    return true;
+  }
   const ObjPtr<ObjectArray<Class>> p_types = GetPTypes();
   const int32_t params_length = p_types->GetLength();
 
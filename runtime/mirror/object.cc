@@ -168,32 +168,59 @@ ObjPtr<Object> Object::Clone(Handle<Object> h_this, Thread* self) {
 }
 
 uint32_t Object::GenerateIdentityHashCode() {
-  uint32_t expected_value, new_value;
+  Thread* self = Thread::Current();
+  uint64_t state = (self != nullptr) ? self->GetIdentityHashState() : 0u;
+  uint32_t hash;
   do {
-    expected_value = hash_code_seed.load(std::memory_order_relaxed);
-    new_value = expected_value * 1103515245 + 12345;
-  } while (!hash_code_seed.CompareAndSetWeakRelaxed(expected_value, new_value) ||
-      (expected_value & LockWord::kHashMask) == 0);
-  return expected_value & LockWord::kHashMask;
+    if (UNLIKELY(state == 0u)) {
+      // Claim a distinct stream from the shared seed so that threads do not
+      // contend on a global generator for every hash code.
+      uint32_t stream = hash_code_seed.fetch_add(1u, std::memory_order_relaxed);
+      state = (static_cast<uint64_t>(stream) + 1u) * UINT64_C(0x9e3779b97f4a7c15);
+    }
+    // One step of the splitmix64 generator.
+    state += UINT64_C(0x9e3779b97f4a7c15);
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+    hash = static_cast<uint32_t>(z ^ (z >> 31)) & LockWord::kHashMask;
+  } while (hash == 0u);
+  if (self != nullptr) {
+    self->SetIdentityHashState(state);
+  }
+  return hash;
 }
 
 void Object::SetHashCodeSeed(uint32_t new_seed) {
   hash_code_seed.store(new_seed, std::memory_order_relaxed);
+  Thread* self = Thread::Current();
+  if (self != nullptr) {
+    // Force a reseed from the new shared seed on the next generation.
+    self->SetIdentityHashState(0u);
+  }
 }
 
 int32_t Object::IdentityHashCode() {
   ObjPtr<Object> current_this = this;  // The this pointer may get invalidated by thread suspension.
+  // Generate the hash code at most once even if installing it has to be retried;
+  // regenerating on every retry wastes generator state and makes the boot image
+  // hash codes depend on CAS failures.
+  uint32_t generated_hash = 0u;
   while (true) {
     LockWord lw = current_this->GetLockWord(false);
     switch (lw.GetState()) {
       case LockWord::kUnlocked: {
         // Try to compare and swap in a new hash, if we succeed we will return the hash on the next
         // loop iteration.
-        LockWord hash_word = LockWord::FromHashCode(GenerateIdentityHashCode(), lw.GCState());
+        if (generated_hash == 0u) {
+          generated_hash = GenerateIdentityHashCode();
+        }
+        LockWord hash_word = LockWord::FromHashCode(generated_hash, lw.GCState());
         DCHECK_EQ(hash_word.GetState(), LockWord::kHashCode);
-        // Use a strong CAS to prevent spurious failures since these can make the boot image
-        // non-deterministic.
-        if (current_this->CasLockWord(lw, hash_word, CASMode::kStrong, std::memory_order_relaxed)) {
+        // A weak CAS is sufficient here: on failure we loop and either return the
+        // hash another thread installed in the meantime or retry with the same
+        // generated value.
+        if (current_this->CasLockWord(lw, hash_word, CASMode::kWeak, std::memory_order_relaxed)) {
           return hash_word.GetHashCode();
         }
         break;
@@ -204,7 +231,10 @@ int32_t Object::IdentityHashCode() {
         Thread* self = Thread::Current();
         StackHandleScope<1> hs(self);
         Handle<mirror::Object> h_this(hs.NewHandle(current_this));
-        Monitor::InflateThinLocked(self, h_this, lw, GenerateIdentityHashCode());
+        if (generated_hash == 0u) {
+          generated_hash = GenerateIdentityHashCode();
+        }
+        Monitor::InflateThinLocked(self, h_this, lw, generated_hash);
         // A GC may have occurred when we switched to kBlocked.
         current_this = h_this.Get();
         break;
@@ -100,6 +100,64 @@ inline ObjPtr<T> ObjectArray<T>::GetWithoutChecks(int32_t i) {
   return GetFieldObject<T, kVerifyFlags, kReadBarrierOption>(OffsetOfElement(i));
 }
 
+template<class T>
+inline void ObjectArray<T>::CopyReferencesWithoutBarriers(int32_t dst_pos,
+                                                          ObjPtr<ObjectArray<T>> src,
+                                                          int32_t src_pos,
+                                                          int32_t count,
+                                                          bool copy_forward) {
+  // Each reference must be copied with (at least) 32-bit single-copy atomicity so that concurrent
+  // readers - notably GC marking - never observe a torn reference; a plain memmove may legally
+  // copy byte by byte, see b/32012820. When the source and destination ranges are mutually
+  // 8-byte aligned, the bulk of the range is copied with aligned 64-bit accesses instead, which
+  // preserve the atomicity of both packed references and halve the number of memory operations.
+  // Chunked copies stay memmove-correct for overlapping ranges in either direction because each
+  // chunk is read before any later-clobbered chunk is written.
+  static_assert(sizeof(Atomic<uint32_t>) == sizeof(HeapReference<T>), "Unexpected Atomic size.");
+  static_assert(sizeof(Atomic<uint64_t>) == 2u * sizeof(HeapReference<T>),
+                "Unexpected Atomic size.");
+  Atomic<uint32_t>* dst_data =
+      reinterpret_cast<Atomic<uint32_t>*>(GetRawData(sizeof(HeapReference<T>), dst_pos));
+  Atomic<uint32_t>* src_data =
+      reinterpret_cast<Atomic<uint32_t>*>(src->GetRawData(sizeof(HeapReference<T>), src_pos));
+  const bool mutually_aligned = ((reinterpret_cast<uintptr_t>(dst_data) ^
+                                  reinterpret_cast<uintptr_t>(src_data)) & 0x7u) == 0u;
+  if (copy_forward) {
+    int32_t i = 0;
+    if (mutually_aligned) {
+      if (i < count && (reinterpret_cast<uintptr_t>(dst_data + i) & 0x7u) != 0u) {
+        dst_data[i].store(src_data[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        ++i;
+      }
+      for (; i + 1 < count; i += 2) {
+        reinterpret_cast<Atomic<uint64_t>*>(dst_data + i)->store(
+            reinterpret_cast<Atomic<uint64_t>*>(src_data + i)->load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+      }
+    }
+    for (; i < count; ++i) {
+      dst_data[i].store(src_data[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+  } else {
+    int32_t i = count;
+    if (mutually_aligned) {
+      if (i > 0 && (reinterpret_cast<uintptr_t>(dst_data + i) & 0x7u) != 0u) {
+        --i;
+        dst_data[i].store(src_data[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+      for (; i >= 2; i -= 2) {
+        reinterpret_cast<Atomic<uint64_t>*>(dst_data + i - 2)->store(
+            reinterpret_cast<Atomic<uint64_t>*>(src_data + i - 2)->load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+      }
+    }
+    while (i > 0) {
+      --i;
+      dst_data[i].store(src_data[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+  }
+}
+
 template<class T>
 inline void ObjectArray<T>::AssignableMemmove(int32_t dst_pos,
                                               ObjPtr<ObjectArray<T>> src,
@@ -114,59 +172,35 @@ inline void ObjectArray<T>::AssignableMemmove(int32_t dst_pos,
   // Perform the memmove using int memmove then perform the write barrier.
   static_assert(sizeof(HeapReference<T>) == sizeof(uint32_t),
                 "art::mirror::HeapReference<T> and uint32_t have different sizes.");
-  // TODO: Optimize this later?
   // We can't use memmove since it does not handle read barriers and may do by per byte copying.
   // See b/32012820.
   const bool copy_forward = (src != this) || (dst_pos < src_pos) || (dst_pos - src_pos >= count);
-  if (copy_forward) {
-    // Forward copy.
-    bool baker_non_gray_case = false;
-    if (kUseReadBarrier && kUseBakerReadBarrier) {
-      uintptr_t fake_address_dependency;
-      if (!ReadBarrier::IsGray(src.Ptr(), &fake_address_dependency)) {
-        baker_non_gray_case = true;
-        DCHECK_EQ(fake_address_dependency, 0U);
-        src.Assign(reinterpret_cast<ObjectArray<T>*>(
-            reinterpret_cast<uintptr_t>(src.Ptr()) | fake_address_dependency));
-        for (int i = 0; i < count; ++i) {
-          // We can skip the RB here because 'src' isn't gray.
-          ObjPtr<T> obj = src->template GetWithoutChecks<kDefaultVerifyFlags, kWithoutReadBarrier>(
-              src_pos + i);
-          SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
-        }
-      }
+  bool barrier_free_copy = !kUseReadBarrier;
+  if (kUseReadBarrier && kUseBakerReadBarrier) {
+    uintptr_t fake_address_dependency;
+    if (!ReadBarrier::IsGray(src.Ptr(), &fake_address_dependency)) {
+      barrier_free_copy = true;
+      DCHECK_EQ(fake_address_dependency, 0U);
+      src.Assign(reinterpret_cast<ObjectArray<T>*>(
+          reinterpret_cast<uintptr_t>(src.Ptr()) | fake_address_dependency));
     }
-    if (!baker_non_gray_case) {
-      for (int i = 0; i < count; ++i) {
-        // We need a RB here. ObjectArray::GetWithoutChecks() contains a RB.
-        ObjPtr<T> obj = src->GetWithoutChecks(src_pos + i);
-        SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
-      }
+  }
+  if (barrier_free_copy) {
+    // There are no read barriers, or 'src' isn't gray, so the whole range can be copied in bulk.
+    CopyReferencesWithoutBarriers(dst_pos, src, src_pos, count, copy_forward);
+  } else if (copy_forward) {
+    // Forward copy.
+    for (int i = 0; i < count; ++i) {
+      // We need a RB here. ObjectArray::GetWithoutChecks() contains a RB.
+      ObjPtr<T> obj = src->GetWithoutChecks(src_pos + i);
+      SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
     }
   } else {
     // Backward copy.
-    bool baker_non_gray_case = false;
-    if (kUseReadBarrier && kUseBakerReadBarrier) {
-      uintptr_t fake_address_dependency;
-      if (!ReadBarrier::IsGray(src.Ptr(), &fake_address_dependency)) {
-        baker_non_gray_case = true;
-        DCHECK_EQ(fake_address_dependency, 0U);
-        src.Assign(reinterpret_cast<ObjectArray<T>*>(
-            reinterpret_cast<uintptr_t>(src.Ptr()) | fake_address_dependency));
-        for (int i = count - 1; i >= 0; --i) {
-          // We can skip the RB here because 'src' isn't gray.
-          ObjPtr<T> obj = src->template GetWithoutChecks<kDefaultVerifyFlags, kWithoutReadBarrier>(
-              src_pos + i);
-          SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
-        }
-      }
-    }
-    if (!baker_non_gray_case) {
-      for (int i = count - 1; i >= 0; --i) {
-        // We need a RB here. ObjectArray::GetWithoutChecks() contains a RB.
-        ObjPtr<T> obj = src->GetWithoutChecks(src_pos + i);
-        SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
-      }
+    for (int i = count - 1; i >= 0; --i) {
+      // We need a RB here. ObjectArray::GetWithoutChecks() contains a RB.
+      ObjPtr<T> obj = src->GetWithoutChecks(src_pos + i);
+      SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
     }
   }
   WriteBarrier::ForArrayWrite(this, dst_pos, count);
@@ -192,26 +226,22 @@ inline void ObjectArray<T>::AssignableMemcpy(int32_t dst_pos,
   // Perform the memmove using int memcpy then perform the write barrier.
   static_assert(sizeof(HeapReference<T>) == sizeof(uint32_t),
                 "art::mirror::HeapReference<T> and uint32_t have different sizes.");
-  // TODO: Optimize this later?
-  // We can't use memmove since it does not handle read barriers and may do by per byte copying.
+  // We can't use memcpy since it does not handle read barriers and may do by per byte copying.
   // See b/32012820.
-  bool baker_non_gray_case = false;
+  bool barrier_free_copy = !kUseReadBarrier;
   if (kUseReadBarrier && kUseBakerReadBarrier) {
     uintptr_t fake_address_dependency;
     if (!ReadBarrier::IsGray(src.Ptr(), &fake_address_dependency)) {
-      baker_non_gray_case = true;
+      barrier_free_copy = true;
       DCHECK_EQ(fake_address_dependency, 0U);
       src.Assign(reinterpret_cast<ObjectArray<T>*>(
           reinterpret_cast<uintptr_t>(src.Ptr()) | fake_address_dependency));
-      for (int i = 0; i < count; ++i) {
-        // We can skip the RB here because 'src' isn't gray.
-        ObjPtr<Object> obj =
-            src->template GetWithoutChecks<kDefaultVerifyFlags, kWithoutReadBarrier>(src_pos + i);
-        SetWithoutChecksAndWriteBarrier<false>(dst_pos + i, obj);
-      }
     }
   }
-  if (!baker_non_gray_case) {
+  if (barrier_free_copy) {
+    // There are no read barriers, or 'src' isn't gray, so the whole range can be copied in bulk.
+    CopyReferencesWithoutBarriers(dst_pos, src, src_pos, count, /*copy_forward=*/ true);
+  } else {
     for (int i = 0; i < count; ++i) {
       // We need a RB here. ObjectArray::GetWithoutChecks() contains a RB.
       ObjPtr<T> obj = src->GetWithoutChecks(src_pos + i);
@@ -146,6 +146,17 @@ class MANAGED ObjectArray: public Array {
   }
 
  private:
+  // Copy a contiguous range of references from src without read barriers and without per-element
+  // write barrier work, dealing with overlaps as memmove does when copy_forward says so. Used by
+  // the Assignable* copies above once they have established that no per-element barriers are
+  // needed for the range.
+  void CopyReferencesWithoutBarriers(int32_t dst_pos,
+                                     ObjPtr<ObjectArray<T>> src,
+                                     int32_t src_pos,
+                                     int32_t count,
+                                     bool copy_forward)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // TODO fix thread safety analysis broken by the use of template. This should be
   // REQUIRES_SHARED(Locks::mutator_lock_).
   template<typename Visitor>
@@ -222,6 +222,18 @@ inline ObjPtr<String> String::AllocFromByteArray(Thread* self,
   return Alloc<kIsInstrumented>(self, length_with_flag, allocator_type, visitor);
 }
 
+template <bool kIsInstrumented>
+inline ObjPtr<String> String::AllocFromAsciiByteArray(Thread* self,
+                                                      int32_t byte_length,
+                                                      Handle<ByteArray> array,
+                                                      int32_t offset,
+                                                      gc::AllocatorType allocator_type) {
+  DCHECK(String::AllASCII(reinterpret_cast<uint8_t*>(array->GetData()) + offset, byte_length));
+  const int32_t length_with_flag = String::GetFlaggedCount(byte_length, kUseStringCompression);
+  SetStringCountAndBytesVisitor visitor(length_with_flag, array, offset, /*high_byte=*/ 0);
+  return Alloc<kIsInstrumented>(self, length_with_flag, allocator_type, visitor);
+}
+
 template <bool kIsInstrumented>
 inline ObjPtr<String> String::AllocFromCharArray(Thread* self,
                                                  int32_t count,
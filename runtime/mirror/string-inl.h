@@ -18,6 +18,9 @@
 
 #include "string.h"
 
+#include <cstring>
+#include <limits>
+
 #include "android-base/stringprintf.h"
 
 #include "class-inl.h"
@@ -95,7 +98,28 @@ inline int32_t String::GetUtfLength() {
 template<typename MemoryType>
 inline bool String::AllASCII(const MemoryType* chars, const int length) {
   static_assert(std::is_unsigned<MemoryType>::value, "Expecting unsigned MemoryType");
-  for (int i = 0; i < length; ++i) {
+  // Process whole words at a time: a word holds only ASCII characters (1..0x7f, see
+  // IsASCII()) if no character has bits above 0x7f set and no character is zero. The
+  // zero test uses the usual "has zero lane" bit trick. The word loads go through
+  // memcpy() because `chars` need not be word-aligned; the compiler turns them into
+  // plain loads.
+  using WordType = uintptr_t;
+  constexpr size_t kCharsPerWord = sizeof(WordType) / sizeof(MemoryType);
+  constexpr WordType kOnes =
+      std::numeric_limits<WordType>::max() / std::numeric_limits<MemoryType>::max();
+  constexpr WordType kHighBits =
+      kOnes * static_cast<MemoryType>(~(std::numeric_limits<MemoryType>::max() >> 1));
+  constexpr WordType kNonAsciiBits =
+      kOnes * static_cast<MemoryType>(~static_cast<MemoryType>(0x7f));
+  int i = 0;
+  for (; i + static_cast<int>(kCharsPerWord) <= length; i += kCharsPerWord) {
+    WordType word;
+    memcpy(&word, chars + i, sizeof(WordType));
+    if (((word & kNonAsciiBits) | ((word - kOnes) & ~word & kHighBits)) != 0u) {
+      return false;
+    }
+  }
+  for (; i < length; ++i) {
     if (!IsASCII(chars[i])) {
       return false;
     }
@@ -129,6 +129,17 @@ class MANAGED String final : public Object {
                                                          gc::AllocatorType allocator_type)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Roles::uninterruptible_);
 
+  // Allocate a string from a byte range already known to hold only ASCII characters,
+  // e.g. after a successful AllASCII() scan. Skips the compressibility scan and copies
+  // (or, with compression disabled, zero-extends) the bytes directly.
+  template <bool kIsInstrumented = true>
+  ALWAYS_INLINE static ObjPtr<String> AllocFromAsciiByteArray(Thread* self,
+                                                              int32_t byte_length,
+                                                              Handle<ByteArray> array,
+                                                              int32_t offset,
+                                                              gc::AllocatorType allocator_type)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Roles::uninterruptible_);
+
   template <bool kIsInstrumented = true>
   ALWAYS_INLINE static ObjPtr<String> AllocFromCharArray(Thread* self,
                                                          int32_t count,
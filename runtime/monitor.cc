@@ -99,6 +99,8 @@ Monitor::Monitor(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, int32_
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      locked_since_deflation_check_(true),
+      idle_deflation_passes_(0),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
       wake_set_(nullptr),
@@ -133,6 +135,8 @@ Monitor::Monitor(Thread* self,
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      locked_since_deflation_check_(true),
+      idle_deflation_passes_(0),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
       wake_set_(nullptr),
@@ -434,6 +438,7 @@ bool Monitor::TryLock(Thread* self, bool spin) {
     DCHECK(owner_.load(std::memory_order_relaxed) == nullptr);
     owner_.store(self, std::memory_order_relaxed);
     CHECK_EQ(lock_count_, 0u);
+    locked_since_deflation_check_ = true;
     if (ATraceEnabled()) {
       SetLockingMethodNoProxy(self);
     }
@@ -626,6 +631,7 @@ void Monitor::Lock(Thread* self) {
   // We avoided touching monitor fields while suspended, so set owner_ here.
   owner_.store(self, std::memory_order_relaxed);
   DCHECK_EQ(lock_count_, 0u);
+  locked_since_deflation_check_ = true;
 
   if (ATraceEnabled()) {
     SetLockingMethodNoProxy(self);
@@ -990,7 +996,7 @@ void Monitor::NotifyAll(Thread* self) {
   }
 }
 
-bool Monitor::Deflate(Thread* self, ObjPtr<mirror::Object> obj) {
+bool Monitor::Deflate(Thread* self, ObjPtr<mirror::Object> obj, bool only_if_idle) {
   DCHECK(obj != nullptr);
   // Don't need volatile since we only deflate with mutators suspended.
   LockWord lw(obj->GetLockWord(false));
@@ -1009,6 +1015,21 @@ bool Monitor::Deflate(Thread* self, ObjPtr<mirror::Object> obj) {
     }
     DCHECK_EQ(monitor->lock_count_, 0u);
     DCHECK_EQ(monitor->owner_.load(std::memory_order_relaxed), static_cast<Thread*>(nullptr));
+    if (only_if_idle) {
+      if (monitor->locked_since_deflation_check_) {
+        // The monitor was acquired since the last pass. Give it a few idle passes before
+        // deflating, so that a lock which sees periodic contention stays inflated instead
+        // of paying for repeated deflation and re-inflation.
+        monitor->locked_since_deflation_check_ = false;
+        monitor->idle_deflation_passes_ = 0u;
+        monitor->monitor_lock_.ExclusiveUnlock(self);
+        return false;
+      }
+      if (++monitor->idle_deflation_passes_ < kIdlePassesBeforeDeflation) {
+        monitor->monitor_lock_.ExclusiveUnlock(self);
+        return false;
+      }
+    }
     if (monitor->HasHashCode()) {
       LockWord new_lw = LockWord::FromHashCode(monitor->GetHashCode(), lw.GCState());
       // Assume no concurrent read barrier state changes as mutators are suspended.
@@ -1677,7 +1698,7 @@ class MonitorDeflateVisitor : public IsMarkedVisitor {
 
   mirror::Object* IsMarked(mirror::Object* object) override
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    if (Monitor::Deflate(self_, object)) {
+    if (Monitor::Deflate(self_, object, /*only_if_idle=*/ true)) {
       DCHECK_NE(object->GetLockWord(true).GetState(), LockWord::kFatLocked);
       ++deflate_count_;
       // If we deflated, return null so that the monitor gets removed from the array.
@@ -161,7 +161,10 @@ class Monitor {
   // Not exclusive because ImageWriter calls this during a Heap::VisitObjects() that
   // does not allow a thread suspension in the middle. TODO: maybe make this exclusive.
   // NO_THREAD_SAFETY_ANALYSIS for monitor->monitor_lock_.
-  static bool Deflate(Thread* self, ObjPtr<mirror::Object> obj)
+  // If `only_if_idle` is set, only deflate monitors that have stayed unused for
+  // kIdlePassesBeforeDeflation consecutive passes; used by the GC-driven deflation in
+  // MonitorList::DeflateMonitors() to leave periodically contended locks inflated.
+  static bool Deflate(Thread* self, ObjPtr<mirror::Object> obj, bool only_if_idle = false)
       REQUIRES_SHARED(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS;
 
 #ifndef __LP64__
@@ -332,6 +335,20 @@ class Monitor {
   // Owner's recursive lock depth. Owner_ non-null, and lock_count_ == 0 ==> held once.
   unsigned int lock_count_ GUARDED_BY(monitor_lock_);
 
+  // Number of consecutive deflation passes that found this monitor unused. The monitor is
+  // only deflated once this reaches kIdlePassesBeforeDeflation, so locks that see periodic
+  // contention do not bounce between the thin and fat states on every pass.
+  static constexpr uint32_t kIdlePassesBeforeDeflation = 2;
+
+  // Whether the monitor has been acquired since the last deflation pass. Written while
+  // holding monitor_lock_; a thread blocked on monitor_lock_ has already registered in
+  // num_waiters_, which makes Deflate() bail out, so the deflation pass never races with
+  // these writes.
+  bool locked_since_deflation_check_ GUARDED_BY(monitor_lock_);
+
+  // See kIdlePassesBeforeDeflation.
+  uint32_t idle_deflation_passes_ GUARDED_BY(monitor_lock_);
+
   // Owner's recursive lock depth is given by monitor_lock_.GetDepth().
 
   // What object are we part of. This is a weak root. Do not access
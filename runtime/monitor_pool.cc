@@ -105,23 +105,51 @@ void MonitorPool::FreeInternal() {
   }
 }
 
+Monitor* MonitorPool::TakeThreadLocalMonitor(Thread* self) {
+  Monitor* mon_uninitialized = self->GetFreePoolMonitors();
+  if (mon_uninitialized != nullptr) {
+    self->SetFreePoolMonitors(mon_uninitialized->next_free_);
+    mon_uninitialized->next_free_ = nullptr;
+  }
+  return mon_uninitialized;
+}
+
+bool MonitorPool::TryCacheThreadLocalMonitor(Thread* self, Monitor* monitor) {
+  // Walking the cache to check the cap is bounded by kMaxThreadLocalMonitors, so it stays
+  // cheaper than taking the allocation lock.
+  size_t num_cached = 0;
+  for (Monitor* mon = self->GetFreePoolMonitors(); mon != nullptr; mon = mon->next_free_) {
+    ++num_cached;
+  }
+  if (num_cached >= kMaxThreadLocalMonitors) {
+    return false;
+  }
+  monitor->next_free_ = self->GetFreePoolMonitors();
+  self->SetFreePoolMonitors(monitor);
+  return true;
+}
+
 Monitor* MonitorPool::CreateMonitorInPool(Thread* self,
                                           Thread* owner,
                                           ObjPtr<mirror::Object> obj,
                                           int32_t hash_code)
     REQUIRES_SHARED(Locks::mutator_lock_) {
-  // We are gonna allocate, so acquire the writer lock.
-  MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
+  // Try the thread's own cache first, to keep inflation off the contended allocation lock.
+  Monitor* mon_uninitialized = TakeThreadLocalMonitor(self);
+  if (mon_uninitialized == nullptr) {
+    // We are gonna allocate, so acquire the writer lock.
+    MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
+
+    // Enough space, or need to resize?
+    if (first_free_ == nullptr) {
+      VLOG(monitor) << "Allocating a new chunk.";
+      AllocateChunk();
+    }
 
-  // Enough space, or need to resize?
-  if (first_free_ == nullptr) {
-    VLOG(monitor) << "Allocating a new chunk.";
-    AllocateChunk();
+    mon_uninitialized = first_free_;
+    first_free_ = first_free_->next_free_;
   }
 
-  Monitor* mon_uninitialized = first_free_;
-  first_free_ = first_free_->next_free_;
-
   // Pull out the id which was preinitialized.
   MonitorId id = mon_uninitialized->monitor_id_;
 
@@ -132,9 +160,6 @@ Monitor* MonitorPool::CreateMonitorInPool(Thread* self,
 }
 
 void MonitorPool::ReleaseMonitorToPool(Thread* self, Monitor* monitor) {
-  // Might be racy with allocation, so acquire lock.
-  MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
-
   // Keep the monitor id. Don't trust it's not cleared.
   MonitorId id = monitor->monitor_id_;
 
@@ -142,12 +167,21 @@ void MonitorPool::ReleaseMonitorToPool(Thread* self, Monitor* monitor) {
   // TODO: Exception safety?
   monitor->~Monitor();
 
+  // Rewrite monitor id.
+  monitor->monitor_id_ = id;
+
+  // Prefer the thread's own cache, so that the next inflation on this thread does not
+  // need the allocation lock.
+  if (TryCacheThreadLocalMonitor(self, monitor)) {
+    return;
+  }
+
+  // Cache is full. Might be racy with allocation, so acquire lock.
+  MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
+
   // Add to the head of the free list.
   monitor->next_free_ = first_free_;
   first_free_ = monitor;
-
-  // Rewrite monitor id.
-  monitor->monitor_id_ = id;
 }
 
 void MonitorPool::ReleaseMonitorsToPool(Thread* self, MonitorList::Monitors* monitors) {
@@ -156,4 +190,19 @@ void MonitorPool::ReleaseMonitorsToPool(Thread* self, MonitorList::Monitors* mon
   }
 }
 
+void MonitorPool::ReleaseThreadLocalMonitorsToPool(Thread* self) {
+  Monitor* head = self->GetFreePoolMonitors();
+  if (head == nullptr) {
+    return;
+  }
+  self->SetFreePoolMonitors(nullptr);
+  MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
+  while (head != nullptr) {
+    Monitor* next = head->next_free_;
+    head->next_free_ = first_free_;
+    first_free_ = head;
+    head = next;
+  }
+}
+
 }  // namespace art
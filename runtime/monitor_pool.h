@@ -74,6 +74,16 @@ class MonitorPool {
 #endif
   }
 
+  // Return the monitors cached by `self` to the global pool. Called on thread exit so
+  // that the pool slots do not leak with the thread.
+  static void ReleaseThreadLocalMonitors(Thread* self) {
+#ifndef __LP64__
+    UNUSED(self);
+#else
+    GetMonitorPool()->ReleaseThreadLocalMonitorsToPool(self);
+#endif
+  }
+
   static Monitor* MonitorFromMonitorId(MonitorId mon_id) {
 #ifndef __LP64__
     return reinterpret_cast<Monitor*>(mon_id << LockWord::kMonitorIdAlignmentShift);
@@ -133,6 +143,18 @@ class MonitorPool {
 
   void ReleaseMonitorToPool(Thread* self, Monitor* monitor);
   void ReleaseMonitorsToPool(Thread* self, MonitorList::Monitors* monitors);
+  void ReleaseThreadLocalMonitorsToPool(Thread* self) REQUIRES(!Locks::allocated_monitor_ids_lock_);
+
+  // Take a free monitor from the calling thread's cache, or return null if the cache is
+  // empty. Entries are only ever pushed and popped by the owning thread, so no lock is
+  // needed; NO_THREAD_SAFETY_ANALYSIS for the next free pointers, which are guarded by
+  // allocated_monitor_ids_lock_ only while a monitor is on the global free list.
+  Monitor* TakeThreadLocalMonitor(Thread* self) NO_THREAD_SAFETY_ANALYSIS;
+
+  // Push a free monitor onto the calling thread's cache. Returns false if the cache is
+  // already at kMaxThreadLocalMonitors, in which case the caller must return the monitor
+  // to the global free list.
+  bool TryCacheThreadLocalMonitor(Thread* self, Monitor* monitor) NO_THREAD_SAFETY_ANALYSIS;
 
   // Note: This is safe as we do not ever move chunks.  All needed entries in the monitor_chunks_
   // data structure are read-only once we get here.  Updates happen-before this call because
@@ -184,6 +206,11 @@ class MonitorPool {
     return kInitialChunkStorage << index;
   }
 
+  // Maximum number of free monitors cached per thread. Keeps the number of monitors
+  // stranded in long-lived threads small while still absorbing the common inflate/deflate
+  // churn of a few hot locks without touching the global free list.
+  static constexpr size_t kMaxThreadLocalMonitors = 8;
+
   // TODO: There are assumptions in the code that monitor addresses are 8B aligned (>>3).
   static constexpr size_t kMonitorAlignment = 8;
   // Size of a monitor, rounded up to a multiple of alignment.
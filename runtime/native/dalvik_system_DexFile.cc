@@ -324,7 +324,19 @@ static jobject DexFile_openDexFileNative(JNIEnv* env,
                                                                   dex_elements,
                                                                   /*out*/ &oat_file,
                                                                   /*out*/ &error_msgs);
-  return CreateCookieFromOatFileManagerResult(env, dex_files, oat_file, error_msgs);
+  // Collect the raw pointers before the cookie conversion releases ownership.
+  std::vector<const DexFile*> dex_file_pointers;
+  for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+    dex_file_pointers.push_back(dex_file.get());
+  }
+  jobject cookie = CreateCookieFromOatFileManagerResult(env, dex_files, oat_file, error_msgs);
+  if (cookie != nullptr && class_loader != nullptr) {
+    // Kick off background pre-initialization of the classes which the previous launch
+    // of this app recorded as initialized at the end of its startup.
+    Runtime::Current()->GetOatFileManager().RunStartupClassPreInitialization(dex_file_pointers,
+                                                                             class_loader);
+  }
+  return cookie;
 }
 
 static void DexFile_verifyInBackgroundNative(JNIEnv* env,
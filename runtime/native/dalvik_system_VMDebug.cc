@@ -489,6 +489,40 @@ static void VMDebug_setAllocTrackerStackDepth(JNIEnv* env, jclass, jint stack_de
   }
 }
 
+// Returns the Heap::GcPerformanceSnapshot fields as a long[], in declaration order. Cheaper and
+// easier to feed into metrics pipelines than the string stats above.
+static jlongArray VMDebug_getGcPerformanceStatsInternal(JNIEnv* env, jclass) {
+  gc::Heap* const heap = Runtime::Current()->GetHeap();
+  gc::Heap::GcPerformanceSnapshot snapshot;
+  heap->GetGcPerformanceSnapshot(&snapshot);
+  const jlong stats[] = {
+    static_cast<jlong>(snapshot.gc_count),
+    static_cast<jlong>(snapshot.gc_time_ns),
+    static_cast<jlong>(snapshot.gc_cpu_time_ns),
+    static_cast<jlong>(snapshot.blocking_gc_count),
+    static_cast<jlong>(snapshot.blocking_gc_time_ns),
+    static_cast<jlong>(snapshot.time_waiting_for_gc_ns),
+    static_cast<jlong>(snapshot.pause_count),
+    static_cast<jlong>(snapshot.pause_time_sum_ns),
+    static_cast<jlong>(snapshot.pause_time_min_ns),
+    static_cast<jlong>(snapshot.pause_time_max_ns),
+    static_cast<jlong>(snapshot.bytes_allocated_ever),
+    static_cast<jlong>(snapshot.objects_allocated_ever),
+    static_cast<jlong>(snapshot.bytes_freed_ever),
+    static_cast<jlong>(snapshot.objects_freed_ever),
+    static_cast<jlong>(snapshot.bytes_allocated),
+    static_cast<jlong>(snapshot.total_memory),
+    static_cast<jlong>(snapshot.max_memory),
+    static_cast<jlong>(snapshot.cc_bytes_moved),
+    static_cast<jlong>(snapshot.cc_objects_moved),
+  };
+  jlongArray result = env->NewLongArray(arraysize(stats));
+  if (result != nullptr) {
+    env->SetLongArrayRegion(result, 0, arraysize(stats), stats);
+  }
+  return result;
+}
+
 static JNINativeMethod gMethods[] = {
   NATIVE_METHOD(VMDebug, countInstancesOfClass, "(Ljava/lang/Class;Z)J"),
   NATIVE_METHOD(VMDebug, countInstancesOfClasses, "([Ljava/lang/Class;Z)[J"),
@@ -513,6 +547,7 @@ static JNINativeMethod gMethods[] = {
   FAST_NATIVE_METHOD(VMDebug, threadCpuTimeNanos, "()J"),
   NATIVE_METHOD(VMDebug, getRuntimeStatInternal, "(I)Ljava/lang/String;"),
   NATIVE_METHOD(VMDebug, getRuntimeStatsInternal, "()[Ljava/lang/String;"),
+  NATIVE_METHOD(VMDebug, getGcPerformanceStatsInternal, "()[J"),
   NATIVE_METHOD(VMDebug, nativeAttachAgent, "(Ljava/lang/String;Ljava/lang/ClassLoader;)V"),
   NATIVE_METHOD(VMDebug, allowHiddenApiReflectionFrom, "(Ljava/lang/Class;)V"),
   NATIVE_METHOD(VMDebug, setAllocTrackerStackDepth, "(I)V"),
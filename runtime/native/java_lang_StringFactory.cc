@@ -118,6 +118,18 @@ static jstring StringFactory_newStringFromUtf8Bytes(JNIEnv* env, jclass, jbyteAr
     return nullptr;
   }
 
+  // Fast path: an all-ASCII region decodes to itself, so a single word-at-a-time scan
+  // followed by a direct copy into a compressed string replaces the decode into a
+  // UTF-16 buffer and the re-scan + narrowing during allocation. Network protocol and
+  // other machine-generated strings are overwhelmingly ASCII, so try this first.
+  if (mirror::String::AllASCII(
+          reinterpret_cast<const uint8_t*>(byte_array->GetData()) + offset, byte_count)) {
+    gc::AllocatorType allocator_type = Runtime::Current()->GetHeap()->GetCurrentAllocator();
+    ObjPtr<mirror::String> ascii_result = mirror::String::AllocFromAsciiByteArray(
+        soa.Self(), byte_count, byte_array, offset, allocator_type);
+    return soa.AddLocalReference<jstring>(ascii_result);
+  }
+
   /*
    * This code converts a UTF-8 byte sequence to a Java String (UTF-16).
    * It implements the W3C recommended UTF-8 decoder.
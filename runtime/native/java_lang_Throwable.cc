@@ -18,15 +18,62 @@
 
 #include "nativehelper/jni_macros.h"
 
+#include "art_method-inl.h"
 #include "jni/jni_internal.h"
+#include "mirror/class.h"
 #include "native_util.h"
+#include "obj_ptr.h"
+#include "runtime.h"
 #include "scoped_fast_native_object_access-inl.h"
+#include "stack.h"
 #include "thread.h"
 
 namespace art {
 
+// Determine the class of the exception whose construction triggered this
+// stack trace capture, by looking at the run of constructor frames below
+// Throwable.fillInStackTrace(). Constructor chaining runs from the most
+// derived class up to java.lang.Throwable, so the last constructor frame in
+// the run belongs to the exception's actual class. Returns null if the
+// capture was not triggered from a constructor (e.g. an explicit
+// fillInStackTrace() call), in which case the caller collects the trace as
+// usual.
+static ObjPtr<mirror::Class> GetConstructedExceptionClass(Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ObjPtr<mirror::Class> klass = nullptr;
+  StackVisitor::WalkStack(
+      [&](const StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+        ArtMethod* m = stack_visitor->GetMethod();
+        if (m == nullptr || m->IsRuntimeMethod()) {
+          return true;
+        }
+        if (m->IsConstructor() && m->GetDeclaringClass()->IsThrowableClass()) {
+          klass = m->GetDeclaringClass();
+          return true;
+        }
+        if (klass == nullptr && m->GetDeclaringClass()->IsThrowableClass()) {
+          // The fillInStackTrace frames above the constructors.
+          return true;
+        }
+        return false;  // First frame past the constructor run.
+      },
+      self,
+      /* context= */ nullptr,
+      StackVisitor::StackWalkKind::kSkipInlinedFrames);
+  return klass;
+}
+
 static jobject Throwable_nativeFillInStackTrace(JNIEnv* env, jclass) {
   ScopedFastNativeObjectAccess soa(env);
+  Runtime* runtime = Runtime::Current();
+  if (UNLIKELY(runtime->HasSuppressedBacktraceClasses())) {
+    ObjPtr<mirror::Class> klass = GetConstructedExceptionClass(soa.Self());
+    if (klass != nullptr && runtime->IsBacktraceSuppressed(klass)) {
+      // A null stack state is a supported Throwable state; the pre-allocated
+      // OutOfMemoryError instances are delivered without a backtrace too.
+      return nullptr;
+    }
+  }
   return soa.Self()->CreateInternalStackTrace(soa);
 }
 
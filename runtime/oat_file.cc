@@ -476,13 +476,37 @@ static bool ReadIndexBssMapping(OatFile* oat_file,
   return true;
 }
 
+// Canonicalizing a dex location calls realpath(3), which stats the path one component
+// at a time. Multidex locations share the primary location's base, so remember the
+// canonical form of the last primary location and splice the multidex suffix onto it
+// instead of repeating the realpath() walk for every secondary dex file.
+static std::string GetDexCanonicalLocationCached(
+    const std::string& dex_location,
+    /*inout*/std::string* last_primary_location,
+    /*inout*/std::string* last_primary_canonical_location) {
+  size_t separator_pos = dex_location.find(DexFileLoader::kMultiDexSeparator);
+  if (separator_pos == std::string::npos) {
+    *last_primary_location = dex_location;
+    *last_primary_canonical_location = DexFileLoader::GetDexCanonicalLocation(dex_location.c_str());
+    return *last_primary_canonical_location;
+  }
+  if (separator_pos == last_primary_location->size() &&
+      dex_location.compare(0u, separator_pos, *last_primary_location) == 0) {
+    return *last_primary_canonical_location + dex_location.substr(separator_pos);
+  }
+  return DexFileLoader::GetDexCanonicalLocation(dex_location.c_str());
+}
+
 void OatFileBase::Setup(const std::vector<const DexFile*>& dex_files) {
   uint32_t i = 0;
   const uint8_t* type_lookup_table_start = nullptr;
+  std::string last_primary_location;
+  std::string last_primary_canonical_location;
   for (const DexFile* dex_file : dex_files) {
     type_lookup_table_start = vdex_->GetNextTypeLookupTableData(type_lookup_table_start, i++);
     std::string dex_location = dex_file->GetLocation();
-    std::string canonical_location = DexFileLoader::GetDexCanonicalLocation(dex_location.c_str());
+    std::string canonical_location = GetDexCanonicalLocationCached(
+        dex_location, &last_primary_location, &last_primary_canonical_location);
 
     const uint8_t* type_lookup_table_data = nullptr;
     if (type_lookup_table_start != nullptr &&
@@ -595,6 +619,8 @@ bool OatFileBase::Setup(int zip_fd,
 
   std::string_view primary_location;
   std::string_view primary_location_replacement;
+  std::string last_primary_name;
+  std::string last_primary_canonical_name;
   size_t dex_filenames_pos = 0u;
   uint32_t dex_file_count = GetOatHeader().GetDexFileCount();
   oat_dex_files_storage_.reserve(dex_file_count);
@@ -925,7 +951,9 @@ bool OatFileBase::Setup(int zip_fd,
     OatDexFile* oat_dex_file = new OatDexFile(
         this,
         dex_file_location,
-        DexFileLoader::GetDexCanonicalLocation(dex_file_name.c_str()),
+        GetDexCanonicalLocationCached(dex_file_name,
+                                      &last_primary_name,
+                                      &last_primary_canonical_name),
         dex_file_checksum,
         dex_file_pointer,
         lookup_table_data,
@@ -1766,12 +1794,16 @@ OatFile* OatFile::Open(int zip_fd,
     // The runtime might not be available at this point if we're running
     // dex2oat or oatdump.
     if (runtime != nullptr) {
-      size_t madvise_size_limit = runtime->GetMadviseWillNeedSizeOdex();
-      Runtime::MadviseFileForRange(madvise_size_limit,
-                                   with_dlopen->Size(),
-                                   with_dlopen->Begin(),
-                                   with_dlopen->End(),
-                                   oat_location);
+      // Prefer the exact page ranges recorded at the end of a previous launch; fall
+      // back to prefetching a prefix of the file when no hints have been recorded yet.
+      if (!OatFileManager::MadviseOatFileWithPrefetchHints(*with_dlopen)) {
+        size_t madvise_size_limit = runtime->GetMadviseWillNeedSizeOdex();
+        Runtime::MadviseFileForRange(madvise_size_limit,
+                                     with_dlopen->Size(),
+                                     with_dlopen->Begin(),
+                                     with_dlopen->End(),
+                                     oat_location);
+      }
     }
     return with_dlopen;
   }
@@ -2017,11 +2049,12 @@ OatDexFile::OatDexFile(const OatFile* oat_file,
       oat_class_offsets_pointer_(oat_class_offsets_pointer),
       lookup_table_(),
       dex_layout_sections_(dex_layout_sections) {
-  InitializeTypeLookupTable();
   DCHECK(!IsBackedByVdexOnly());
 }
 
-void OatDexFile::InitializeTypeLookupTable() {
+// Called lazily from GetTypeLookupTable(): most dex files of an oat file never serve
+// a class lookup, so there is no point in wiring the table up during oat file setup.
+void OatDexFile::InitializeTypeLookupTable() const {
   // Initialize TypeLookupTable.
   if (lookup_table_data_ != nullptr) {
     // Peek the number of classes from the DexFile.
@@ -2053,16 +2086,12 @@ OatDexFile::OatDexFile(const OatFile* oat_file,
       dex_file_location_checksum_(dex_file_location_checksum),
       dex_file_pointer_(dex_file_pointer),
       lookup_table_data_(lookup_table_data) {
-  InitializeTypeLookupTable();
   DCHECK(IsBackedByVdexOnly());
 }
 
 OatDexFile::OatDexFile(TypeLookupTable&& lookup_table) : lookup_table_(std::move(lookup_table)) {
-  // Stripped-down OatDexFile only allowed in the compiler, the zygote, or the system server.
-  CHECK(Runtime::Current() == nullptr ||
-        Runtime::Current()->IsAotCompiler() ||
-        Runtime::Current()->IsZygote() ||
-        Runtime::Current()->IsSystemServer());
+  // Stripped-down OatDexFile. It is not associated with an OatFile and only
+  // backs an on-the-fly type lookup table to speed up class def lookups.
 }
 
 OatDexFile::~OatDexFile() {}
@@ -18,6 +18,7 @@
 #define ART_RUNTIME_OAT_FILE_H_
 
 #include <list>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -550,13 +551,18 @@ class OatDexFile final {
   // Madvise the dex file based on the state we are moving to.
   static void MadviseDexFile(const DexFile& dex_file, MadviseState state);
 
+  // Returns the type lookup table, wiring it up on first use. Most dex files of an
+  // oat file never serve a class lookup before the process is specialized, so the
+  // table is initialized lazily to keep it off the oat file setup path.
   const TypeLookupTable& GetTypeLookupTable() const {
+    std::call_once(lookup_table_init_, [this]() { InitializeTypeLookupTable(); });
     return lookup_table_;
   }
 
   ~OatDexFile();
 
-  // Create only with a type lookup table, used by the compiler to speed up compilation.
+  // Create only with a type lookup table, used to speed up class def lookups in
+  // dex files that are not backed by an oat file.
   explicit OatDexFile(TypeLookupTable&& lookup_table);
 
   // Return the dex layout sections.
@@ -589,7 +595,7 @@ class OatDexFile final {
              const uint8_t* lookup_table_data);
 
   bool IsBackedByVdexOnly() const;
-  void InitializeTypeLookupTable();
+  void InitializeTypeLookupTable() const;
 
   static void AssertAotCompiler();
 
@@ -605,7 +611,9 @@ class OatDexFile final {
   const IndexBssMapping* const package_type_bss_mapping_ = nullptr;
   const IndexBssMapping* const string_bss_mapping_ = nullptr;
   const uint32_t* const oat_class_offsets_pointer_ = nullptr;
-  TypeLookupTable lookup_table_;
+  // Initialized lazily by GetTypeLookupTable(), hence mutable.
+  mutable std::once_flag lookup_table_init_;
+  mutable TypeLookupTable lookup_table_;
   const DexLayoutSections* const dex_layout_sections_ = nullptr;
 
   friend class OatFile;
@@ -16,9 +16,12 @@
 
 #include "oat_file_assistant.h"
 
+#include <cstring>
 #include <sstream>
+#include <type_traits>
 
 #include <sys/stat.h>
+#include <unistd.h>
 #include "zlib.h"
 
 #include "android-base/file.h"
@@ -26,6 +29,7 @@
 #include "android-base/strings.h"
 
 #include "base/compiler_filter.h"
+#include "base/data_hash.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/macros.h"
@@ -54,6 +58,10 @@ using android::base::StringPrintf;
 static constexpr const char* kAnonymousDexPrefix = "Anonymous-DexFile@";
 static constexpr const char* kVdexExtension = ".vdex";
 
+// On-disk dexopt verdict cache record. See OatFileAssistant::VerdictCacheKey.
+static constexpr uint32_t kVerdictCacheMagic = 0x74647256;  // 'Vrdt'
+static constexpr uint32_t kVerdictCacheVersion = 1u;
+
 std::ostream& operator << (std::ostream& stream, const OatFileAssistant::OatStatus status) {
   switch (status) {
     case OatFileAssistant::kOatCannotOpen:
@@ -201,14 +209,123 @@ bool OatFileAssistant::IsInBootClassPath() {
 int OatFileAssistant::GetDexOptNeeded(CompilerFilter::Filter target,
                                       bool profile_changed,
                                       bool downgrade) {
+  // Answer steady-state queries from the persistent verdict cache so that
+  // repeated package scans pay a stat() per artifact instead of re-opening and
+  // re-checksumming the apk and its compiled artifacts.
+  VerdictCacheKey key;
+  bool cacheable = ComputeVerdictCacheKey(target, profile_changed, downgrade, &key);
+  int cached_verdict;
+  if (cacheable && GetCachedDexOptVerdict(key, &cached_verdict)) {
+    return cached_verdict;
+  }
+
   OatFileInfo& info = GetBestInfo();
   DexOptNeeded dexopt_needed = info.GetDexOptNeeded(target,
                                                     profile_changed,
                                                     downgrade);
-  if (info.IsOatLocation() || dexopt_needed == kDex2OatFromScratch) {
-    return dexopt_needed;
+  int result = (info.IsOatLocation() || dexopt_needed == kDex2OatFromScratch)
+      ? static_cast<int>(dexopt_needed)
+      : -static_cast<int>(dexopt_needed);
+  if (cacheable) {
+    StoreDexOptVerdict(key, result);
+  }
+  return result;
+}
+
+std::string OatFileAssistant::GetVerdictCacheFilename() {
+  if (UseFdToReadFiles()) {
+    // No filenames to derive the cache location from.
+    return "";
+  }
+  // Keep the record next to the artifact location that GetBestInfo() prefers:
+  // the odex location when we can write next to the dex file, otherwise the
+  // oat location in the dalvik cache.
+  const std::string* base = dex_parent_writable_ ? odex_.Filename() : oat_.Filename();
+  if (base == nullptr) {
+    return "";
+  }
+  return ReplaceFileExtension(*base, "verdict");
+}
+
+bool OatFileAssistant::ComputeVerdictCacheKey(CompilerFilter::Filter target,
+                                              bool profile_changed,
+                                              bool downgrade,
+                                              /*out*/ VerdictCacheKey* key) {
+  if (UseFdToReadFiles() || Runtime::Current() == nullptr) {
+    return false;
+  }
+  static_assert(std::is_trivially_copyable<VerdictCacheKey>::value,
+                "VerdictCacheKey is compared and stored as raw bytes");
+  // Zero the whole key, including any padding, as it is compared with memcmp().
+  memset(key, 0, sizeof(*key));
+  key->magic = kVerdictCacheMagic;
+  key->version = kVerdictCacheVersion;
+  key->boot_class_path_checksums_hash =
+      static_cast<uint32_t>(DataHash()(Runtime::Current()->GetBootClassPathChecksums()));
+  // Note: the context is encoded by location, without opening the context dex
+  // files. An updated context member is caught by its own changed apk, which
+  // package scans query (and thus refresh) before the apps depending on it.
+  key->class_loader_context_hash = (context_ != nullptr)
+      ? static_cast<uint32_t>(DataHash()(context_->EncodeContextForDex2oat(/*base_dir=*/ "")))
+      : 0u;
+  key->compiler_filter = static_cast<uint32_t>(target);
+  key->query_flags = (profile_changed ? 1u : 0u) | (downgrade ? 2u : 0u);
+  const std::string* files[VerdictCacheKey::kNumArtifacts] = {
+    &dex_location_,
+    odex_.Filename(),
+    vdex_for_odex_.Filename(),
+    oat_.Filename(),
+    vdex_for_oat_.Filename(),
+  };
+  for (size_t i = 0; i < VerdictCacheKey::kNumArtifacts; ++i) {
+    struct stat file_stat;
+    if (files[i] != nullptr && stat(files[i]->c_str(), &file_stat) == 0) {
+      key->artifact_mtimes[i] = file_stat.st_mtime;
+      key->artifact_sizes[i] = file_stat.st_size;
+      key->artifact_inodes[i] = file_stat.st_ino;
+    } else {
+      // A missing artifact is part of the identity.
+      key->artifact_mtimes[i] = -1;
+      key->artifact_sizes[i] = -1;
+      key->artifact_inodes[i] = -1;
+    }
+  }
+  return true;
+}
+
+bool OatFileAssistant::GetCachedDexOptVerdict(const VerdictCacheKey& key, /*out*/ int* verdict) {
+  std::string filename = GetVerdictCacheFilename();
+  if (filename.empty()) {
+    return false;
+  }
+  std::string data;
+  if (!android::base::ReadFileToString(filename, &data)) {
+    return false;
+  }
+  if (data.size() != sizeof(VerdictCacheKey) + sizeof(int32_t)) {
+    return false;
+  }
+  if (memcmp(data.data(), &key, sizeof(key)) != 0) {
+    return false;
+  }
+  int32_t stored_verdict;
+  memcpy(&stored_verdict, data.data() + sizeof(key), sizeof(stored_verdict));
+  *verdict = stored_verdict;
+  return true;
+}
+
+void OatFileAssistant::StoreDexOptVerdict(const VerdictCacheKey& key, int verdict) {
+  std::string filename = GetVerdictCacheFilename();
+  if (filename.empty()) {
+    return;
+  }
+  std::string data(reinterpret_cast<const char*>(&key), sizeof(key));
+  int32_t stored_verdict = verdict;
+  data.append(reinterpret_cast<const char*>(&stored_verdict), sizeof(stored_verdict));
+  if (!android::base::WriteStringToFile(data, filename)) {
+    VLOG(oat) << "Could not write dexopt verdict cache " << filename;
+    unlink(filename.c_str());
   }
-  return -dexopt_needed;
 }
 
 bool OatFileAssistant::IsUpToDate() {
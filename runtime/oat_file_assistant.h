@@ -378,6 +378,46 @@ class OatFileAssistant {
     bool file_released_ = false;
   };
 
+  // Key identifying everything a cached dexopt verdict depends on. Verdicts are
+  // persisted in a small file next to the compiled artifacts so that steady-state
+  // GetDexOptNeeded() queries are answered with a stat() of each artifact and a
+  // memcmp() instead of re-opening and re-checksumming the apk and its artifacts.
+  // Any mismatch (changed mtime/size/inode of an artifact, different boot image,
+  // different query parameters, or an unreadable record) falls back to the full
+  // computation, which then refreshes the record.
+  struct VerdictCacheKey {
+    // Files whose identity the verdict depends on:
+    // apk, odex, vdex next to odex, oat, vdex next to oat.
+    static constexpr size_t kNumArtifacts = 5u;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t boot_class_path_checksums_hash;
+    uint32_t class_loader_context_hash;
+    uint32_t compiler_filter;
+    uint32_t query_flags;
+    int64_t artifact_mtimes[kNumArtifacts];
+    int64_t artifact_sizes[kNumArtifacts];
+    int64_t artifact_inodes[kNumArtifacts];
+  };
+
+  // Returns the path of the verdict cache file, or an empty string if there is
+  // no suitable location (e.g. when reading artifacts from file descriptors).
+  std::string GetVerdictCacheFilename();
+
+  // Computes the verdict cache key for the given query. Returns false if
+  // verdicts for this query cannot be cached.
+  bool ComputeVerdictCacheKey(CompilerFilter::Filter target,
+                              bool profile_changed,
+                              bool downgrade,
+                              /*out*/ VerdictCacheKey* key);
+
+  // Returns true and sets the verdict if the cache holds a record for the key.
+  bool GetCachedDexOptVerdict(const VerdictCacheKey& key, /*out*/ int* verdict);
+
+  // Best-effort write of the verdict for the key; failures are ignored.
+  void StoreDexOptVerdict(const VerdictCacheKey& key, int verdict);
+
   // Return info for the best oat file.
   OatFileInfo& GetBestInfo();
 
@@ -109,6 +109,10 @@ class OatFileAssistantTest : public DexoptTest {
         downgrade);
   }
 
+  std::string GetVerdictCacheFilename(OatFileAssistant* assistant) {
+    return assistant->GetVerdictCacheFilename();
+  }
+
   static std::unique_ptr<ClassLoaderContext> InitializeDefaultContext() {
     auto context = ClassLoaderContext::Default();
     context->OpenDexFiles();
@@ -453,6 +457,62 @@ TEST_F(OatFileAssistantTest, OatUpToDate) {
       "up-to-date");
 }
 
+// Case: We have a DEX file and up-to-date OAT file for it.
+// Expect: The first query persists its verdict, a fresh assistant answers from
+// the cache, and updating the DEX file invalidates the record.
+TEST_F(OatFileAssistantTest, DexOptVerdictCache) {
+  if (IsExecutedAsRoot()) {
+    // We cannot simulate non writable locations when executed as root: b/38000545.
+    LOG(ERROR) << "Test skipped because it's running as root";
+    return;
+  }
+
+  std::string dex_location = GetScratchDir() + "/DexOptVerdictCache.jar";
+  Copy(GetDexSrc1(), dex_location);
+  GenerateOatForTest(dex_location.c_str(), CompilerFilter::kSpeed);
+
+  {
+    // Force the use of oat location by making the dex parent not writable.
+    ScopedNonWritable scoped_non_writable(dex_location);
+    ASSERT_TRUE(scoped_non_writable.IsSuccessful());
+
+    OatFileAssistant oat_file_assistant(dex_location.c_str(),
+                                        kRuntimeISA,
+                                        default_context_.get(),
+                                        false);
+    std::string verdict_filename = GetVerdictCacheFilename(&oat_file_assistant);
+    ASSERT_FALSE(verdict_filename.empty());
+    EXPECT_FALSE(OS::FileExists(verdict_filename.c_str()));
+
+    EXPECT_EQ(OatFileAssistant::kNoDexOptNeeded,
+        GetDexOptNeeded(&oat_file_assistant, CompilerFilter::kSpeed));
+    EXPECT_TRUE(OS::FileExists(verdict_filename.c_str()));
+
+    // A fresh assistant sees the same verdict, now answered from the cache.
+    OatFileAssistant cached_assistant(dex_location.c_str(),
+                                      kRuntimeISA,
+                                      default_context_.get(),
+                                      false);
+    EXPECT_EQ(OatFileAssistant::kNoDexOptNeeded,
+        GetDexOptNeeded(&cached_assistant, CompilerFilter::kSpeed));
+  }
+
+  // Overwrite the dex with a different dex; the stale record must not be served.
+  Copy(GetDexSrc2(), dex_location);
+
+  {
+    ScopedNonWritable scoped_non_writable(dex_location);
+    ASSERT_TRUE(scoped_non_writable.IsSuccessful());
+
+    OatFileAssistant updated_assistant(dex_location.c_str(),
+                                       kRuntimeISA,
+                                       default_context_.get(),
+                                       false);
+    EXPECT_EQ(OatFileAssistant::kDex2OatFromScratch,
+        GetDexOptNeeded(&updated_assistant, CompilerFilter::kSpeed));
+  }
+}
+
 // Case: Passing valid file descriptors of updated odex/vdex files along with the dex file.
 // Expect: The status is kNoDexOptNeeded.
 TEST_F(OatFileAssistantTest, GetDexOptNeededWithFd) {
@@ -16,19 +16,31 @@
 
 #include "oat_file_manager.h"
 
+#include <cstring>
+#include <map>
 #include <memory>
 #include <queue>
+#include <set>
 #include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "android-base/file.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
+#include "android-base/unique_fd.h"
 
 #include "art_field-inl.h"
+#include "art_method-inl.h"
+#include "base/bit_utils.h"
 #include "base/bit_vector-inl.h"
 #include "base/file_utils.h"
+#include "base/globals.h"
 #include "base/logging.h"  // For VLOG.
+#include "base/mem_map.h"
+#include "base/memfd.h"
 #include "base/mutex-inl.h"
 #include "base/sdk_version.h"
 #include "base/stl_util.h"
@@ -39,14 +51,19 @@
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_loader.h"
 #include "dex/dex_file_tracking_registrar.h"
+#include "dex/dex_instruction-inl.h"
+#include "dex/type_lookup_table.h"
 #include "gc/scoped_gc_critical_section.h"
 #include "gc/space/image_space.h"
 #include "handle_scope-inl.h"
 #include "jit/jit.h"
 #include "jni/java_vm_ext.h"
 #include "jni/jni_internal.h"
+#include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
+#include "mirror/iftable-inl.h"
 #include "mirror/object-inl.h"
+#include "oat.h"
 #include "oat_file.h"
 #include "oat_file_assistant.h"
 #include "obj_ptr-inl.h"
@@ -55,6 +72,7 @@
 #include "thread_list.h"
 #include "thread_pool.h"
 #include "vdex_file.h"
+#include "verifier/class_verifier.h"
 #include "verifier/verifier_deps.h"
 #include "well_known_classes.h"
 
@@ -402,6 +420,9 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
     }
   }
 
+  // Speed up class lookups in any dex files that ended up without an oat file.
+  CreateTypeLookupTables(dex_files);
+
   if (Runtime::Current()->GetJit() != nullptr) {
     Runtime::Current()->GetJit()->RegisterDexFiles(dex_files, class_loader);
   }
@@ -437,6 +458,9 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
       error_msgs);
 
   if (error_msgs->empty()) {
+    // Speed up class lookups in any dex files that ended up without an oat file.
+    CreateTypeLookupTables(dex_files);
+
     // Remove write permission from DexFile pages. We do this at the end because
     // OatFile assigns OatDexFile pointer in the DexFile objects.
     for (std::unique_ptr<const DexFile>& dex_file : dex_files) {
@@ -541,6 +565,61 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat_
   return dex_files;
 }
 
+void OatFileManager::CreateTypeLookupTables(
+    const std::vector<std::unique_ptr<const DexFile>>& dex_files) {
+  for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+    if (dex_file->GetOatDexFile() != nullptr) {
+      // Class def lookups will use the lookup table embedded in the oat/vdex file.
+      continue;
+    }
+    TypeLookupTable lookup_table = TypeLookupTable::Create(*dex_file);
+    if (!lookup_table.Valid()) {
+      continue;
+    }
+    // Try to move the table data into a memfd region named after the dex location
+    // checksum. Another process of the same application can then map the
+    // already-built table instead of rebuilding it once it receives the file
+    // descriptor, and the kernel can share the clean pages between the processes.
+    MemMap mem_map;
+    const uint32_t length = lookup_table.RawDataLength();
+    std::string name = StringPrintf("TypeLookupTable_%08x", dex_file->GetLocationChecksum());
+    android::base::unique_fd mem_fd(memfd_create(name.c_str(), /* flags= */ MFD_ALLOW_SEALING));
+    if (mem_fd.get() != -1 && ftruncate(mem_fd.get(), length) == 0) {
+      std::string error_msg;
+      mem_map = MemMap::MapFile(length,
+                                PROT_READ | PROT_WRITE,
+                                MAP_SHARED,
+                                mem_fd,
+                                /* start= */ 0,
+                                /* low_4gb= */ false,
+                                name.c_str(),
+                                &error_msg);
+      if (mem_map.IsValid()) {
+        memcpy(mem_map.Begin(), lookup_table.RawData(), length);
+        mem_map.Protect(PROT_READ);
+        // Seal the size so that readers in other processes can rely on it. Sealing
+        // writes is not possible while our own shared mapping exists.
+        if (fcntl(mem_fd.get(), F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) == -1) {
+          PLOG(WARNING) << "Failed to seal type lookup table for " << dex_file->GetLocation();
+        }
+        lookup_table = TypeLookupTable::Open(dex_file->DataBegin(),
+                                             mem_map.Begin(),
+                                             dex_file->NumClassDefs());
+      } else {
+        LOG(WARNING) << "Could not map type lookup table for " << dex_file->GetLocation()
+                     << ": " << error_msg;
+      }
+    }
+    // If shared memory was not available, fall back to the heap-allocated table.
+    WriterMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+    if (mem_map.IsValid()) {
+      type_lookup_table_maps_.push_back(std::move(mem_map));
+    }
+    type_lookup_tables_.push_back(std::make_unique<OatDexFile>(std::move(lookup_table)));
+    dex_file->SetOatDexFile(type_lookup_tables_.back().get());
+  }
+}
+
 // Check how many vdex files exist in the same directory as the vdex file we are about
 // to write. If more than or equal to kAnonymousVdexCacheSize, unlink the least
 // recently used one(s) (according to stat-reported atime).
@@ -761,6 +840,30 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
     return;
   }
 
+  const std::string vdex_filename = GetVdexFilename(odex_filename);
+
+  // If a previous run already verified the same dex files, the results on disk are current
+  // and there is nothing to do. This is the common case for anonymous dex files (e.g.
+  // InMemoryDexClassLoader payloads) which are keyed by content checksum and re-loaded
+  // unchanged on every launch.
+  if (OS::FileExists(vdex_filename.c_str())) {
+    std::vector<const DexFile::Header*> dex_headers;
+    dex_headers.reserve(dex_files.size());
+    for (const DexFile* dex_file : dex_files) {
+      dex_headers.push_back(&dex_file->GetHeader());
+    }
+    std::unique_ptr<VdexFile> vdex_file = VdexFile::Open(vdex_filename,
+                                                         /* writable= */ false,
+                                                         /* low_4gb= */ false,
+                                                         /* unquicken= */ false,
+                                                         &error_msg);
+    if (vdex_file == nullptr) {
+      LOG(WARNING) << "Failed to open vdex " << vdex_filename << ": " << error_msg;
+    } else if (vdex_file->MatchesDexFileChecksums(dex_headers)) {
+      return;
+    }
+  }
+
   {
     WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
     if (verification_thread_pool_ == nullptr) {
@@ -772,7 +875,76 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
   verification_thread_pool_->AddTask(self, new BackgroundVerificationTask(
       dex_files,
       class_loader,
-      GetVdexFilename(odex_filename)));
+      vdex_filename));
+}
+
+class BackgroundReverificationTask final : public Task {
+ public:
+  // Takes ownership of the global reference `klass`.
+  explicit BackgroundReverificationTask(jobject klass) : klass_(klass) {}
+
+  ~BackgroundReverificationTask() {
+    Thread* const self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    soa.Vm()->DeleteGlobalRef(self, klass_);
+  }
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<1> hs(self);
+    Handle<mirror::Class> h_class(hs.NewHandle(soa.Decode<mirror::Class>(klass_)));
+    if (h_class->IsErroneous()) {
+      return;
+    }
+    std::string error_msg;
+    verifier::FailureKind failure = verifier::ClassVerifier::ReverifyClass(
+        self,
+        h_class.Get(),
+        verifier::HardFailLogMode::kLogWarning,
+        Runtime::Current()->GetTargetSdkVersion(),
+        &error_msg);
+    if (failure != verifier::FailureKind::kNoFailure) {
+      // The class keeps running with interpreter access checks, matching the
+      // behavior of a synchronous runtime soft verification failure.
+      VLOG(verifier) << "Background re-verification of " << h_class->PrettyDescriptor()
+                     << " failed: " << error_msg;
+    }
+    if (self->IsExceptionPending()) {
+      self->ClearException();
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  jobject klass_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundReverificationTask);
+};
+
+void OatFileManager::EnqueueBackgroundReverification(Thread* self, ObjPtr<mirror::Class> klass) {
+  Runtime* const runtime = Runtime::Current();
+  if (runtime->IsShuttingDown(self)) {
+    // Not allowed to create new threads during runtime shutdown. The class simply
+    // keeps executing with interpreter access checks.
+    return;
+  }
+
+  // Create a global ref for the class because it will be accessed from a different thread.
+  jobject global_klass = runtime->GetJavaVM()->AddGlobalRef(self, klass);
+  CHECK(global_klass != nullptr);
+
+  {
+    WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
+    if (verification_thread_pool_ == nullptr) {
+      verification_thread_pool_.reset(
+          new ThreadPool("Verification thread pool", /* num_threads= */ 1));
+      verification_thread_pool_->StartWorkers(self);
+    }
+  }
+  verification_thread_pool_->AddTask(self, new BackgroundReverificationTask(global_klass));
 }
 
 void OatFileManager::WaitForWorkersToBeCreated() {
@@ -833,4 +1005,449 @@ void OatFileManager::DumpForSigQuit(std::ostream& os) {
   }
 }
 
+// On-disk format of the prefetch hints written next to an oat file. The header is
+// followed by `num_ranges` pairs of (first_page, num_pages) describing the pages of
+// the oat mapping which were resident when startup completed.
+struct PrefetchHintsHeader {
+  uint8_t magic[4];
+  uint32_t version;
+  uint32_t oat_checksum;
+  uint32_t page_size;
+  uint32_t num_ranges;
+};
+
+static constexpr uint8_t kPrefetchHintsMagic[4] = { 'O', 'a', 't', 'P' };
+static constexpr uint32_t kPrefetchHintsVersion = 1u;
+
+static std::string GetPrefetchHintsFileName(const std::string& oat_filename) {
+  return oat_filename + ".prefetch";
+}
+
+void OatFileManager::RecordOatFilePrefetchHints() {
+  ReaderMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+  std::vector<const OatFile*> boot_oat_files = GetBootOatFiles();
+  for (const std::unique_ptr<const OatFile>& oat_file : oat_files_) {
+    // Only executable oat files loaded from disk benefit from prefetching. The boot
+    // image oat files are kept resident by the zygote, so skip them.
+    if (!oat_file->IsExecutable() ||
+        oat_file->GetLocation().empty() ||
+        ContainsElement(boot_oat_files, oat_file.get())) {
+      continue;
+    }
+    const uint8_t* begin = AlignDown(oat_file->Begin(), kPageSize);
+    const size_t length = RoundUp(static_cast<size_t>(oat_file->End() - begin), kPageSize);
+    const size_t num_pages = length / kPageSize;
+    if (num_pages == 0u) {
+      continue;
+    }
+    std::vector<unsigned char> resident(num_pages);
+    if (mincore(const_cast<uint8_t*>(begin), length, resident.data()) != 0) {
+      PLOG(WARNING) << "Failed to mincore " << oat_file->GetLocation();
+      continue;
+    }
+    // Encode runs of resident pages.
+    std::string data(sizeof(PrefetchHintsHeader), '\0');
+    uint32_t num_ranges = 0u;
+    for (size_t i = 0u; i < num_pages; ) {
+      if ((resident[i] & 1u) == 0u) {
+        ++i;
+        continue;
+      }
+      size_t end = i + 1u;
+      while (end < num_pages && (resident[end] & 1u) != 0u) {
+        ++end;
+      }
+      const uint32_t range[2] = { static_cast<uint32_t>(i), static_cast<uint32_t>(end - i) };
+      data.append(reinterpret_cast<const char*>(range), sizeof(range));
+      ++num_ranges;
+      i = end;
+    }
+    PrefetchHintsHeader header;
+    memcpy(header.magic, kPrefetchHintsMagic, sizeof(header.magic));
+    header.version = kPrefetchHintsVersion;
+    header.oat_checksum = oat_file->GetOatHeader().GetChecksum();
+    header.page_size = kPageSize;
+    header.num_ranges = num_ranges;
+    memcpy(&data[0], &header, sizeof(header));
+    const std::string hints_file = GetPrefetchHintsFileName(oat_file->GetLocation());
+    if (!android::base::WriteStringToFile(data, hints_file)) {
+      // The directory holding the oat file is not always writable, e.g. on /system.
+      VLOG(startup) << "Failed to write prefetch hints to " << hints_file;
+    } else {
+      VLOG(startup) << "Recorded " << num_ranges << " prefetch ranges for "
+                    << oat_file->GetLocation();
+    }
+  }
+}
+
+bool OatFileManager::MadviseOatFileWithPrefetchHints(const OatFile& oat_file) {
+  const std::string hints_file = GetPrefetchHintsFileName(oat_file.GetLocation());
+  std::string data;
+  if (!android::base::ReadFileToString(hints_file, &data)) {
+    return false;
+  }
+  PrefetchHintsHeader header;
+  if (data.size() < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, data.data(), sizeof(header));
+  if (memcmp(header.magic, kPrefetchHintsMagic, sizeof(header.magic)) != 0 ||
+      header.version != kPrefetchHintsVersion ||
+      header.oat_checksum != oat_file.GetOatHeader().GetChecksum() ||
+      header.page_size != kPageSize ||
+      data.size() < sizeof(header) + header.num_ranges * 2u * sizeof(uint32_t)) {
+    // Stale or corrupt hints, e.g. after recompilation. Remove them so that the next
+    // startup records a fresh set; the caller falls back to the default readahead.
+    unlink(hints_file.c_str());
+    return false;
+  }
+  const uint8_t* begin = AlignDown(oat_file.Begin(), kPageSize);
+  const size_t num_pages =
+      RoundUp(static_cast<size_t>(oat_file.End() - begin), kPageSize) / kPageSize;
+  const uint32_t* ranges = reinterpret_cast<const uint32_t*>(data.data() + sizeof(header));
+  for (uint32_t i = 0u; i != header.num_ranges; ++i) {
+    const size_t first_page = ranges[2u * i];
+    const size_t range_pages = ranges[2u * i + 1u];
+    if (first_page >= num_pages || range_pages > num_pages - first_page) {
+      continue;
+    }
+    void* madvise_addr = const_cast<uint8_t*>(begin + first_page * kPageSize);
+    if (madvise(madvise_addr, range_pages * kPageSize, MADV_WILLNEED) != 0) {
+      PLOG(WARNING) << "Failed to madvise prefetch range for " << oat_file.GetLocation();
+    }
+  }
+  VLOG(startup) << "Prefetched " << header.num_ranges << " recorded ranges for "
+                << oat_file.GetLocation();
+  return true;
+}
+
+// On-disk format of the class initialization checkpoint written next to an oat file.
+// The header is followed by `num_classes` pairs of (dex file index, class def index)
+// identifying classes which reached the initialized state during the previous launch.
+struct ClassInitCheckpointHeader {
+  uint8_t magic[4];
+  uint32_t version;
+  uint32_t oat_checksum;
+  uint32_t num_classes;
+};
+
+static constexpr uint8_t kClassInitCheckpointMagic[4] = { 'O', 'a', 't', 'I' };
+static constexpr uint32_t kClassInitCheckpointVersion = 1u;
+
+static std::string GetClassInitCheckpointFileName(const std::string& oat_filename) {
+  return oat_filename + ".preinit";
+}
+
+// Returns true if the class initializer provably has no effects outside the static
+// fields of its own class, so that running it ahead of the first use of the class
+// cannot be observed by the program. The check is a conservative instruction scan:
+// only constants, arithmetic, array creation and accesses to the declaring class'
+// own static fields are allowed.
+static bool IsSideEffectFreeClassInitializer(ArtMethod* clinit)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  CodeItemInstructionAccessor accessor = clinit->DexInstructions();
+  if (!accessor.HasCodeItem()) {
+    return false;
+  }
+  const DexFile* dex_file = clinit->GetDexFile();
+  const dex::TypeIndex declaring_class_idx = clinit->GetDeclaringClass()->GetDexTypeIndex();
+  for (const DexInstructionPcPair& pair : accessor) {
+    const Instruction& inst = pair.Inst();
+    const Instruction::Code opcode = inst.Opcode();
+    if (opcode >= Instruction::SGET && opcode <= Instruction::SPUT_SHORT) {
+      // Static field accesses are allowed only on the declaring class itself.
+      const dex::FieldId& field_id = dex_file->GetFieldId(inst.VRegB_21c());
+      if (field_id.class_idx_ != declaring_class_idx) {
+        return false;
+      }
+      continue;
+    }
+    switch (opcode) {
+      case Instruction::NOP:
+      case Instruction::RETURN_VOID:
+      case Instruction::GOTO:
+      case Instruction::GOTO_16:
+      case Instruction::GOTO_32:
+      case Instruction::PACKED_SWITCH:
+      case Instruction::SPARSE_SWITCH:
+      case Instruction::NEW_ARRAY:
+      case Instruction::FILLED_NEW_ARRAY:
+      case Instruction::FILLED_NEW_ARRAY_RANGE:
+      case Instruction::FILL_ARRAY_DATA:
+      case Instruction::ARRAY_LENGTH:
+        continue;
+      default:
+        break;
+    }
+    if ((opcode >= Instruction::MOVE && opcode <= Instruction::MOVE_OBJECT_16) ||
+        (opcode >= Instruction::MOVE_RESULT && opcode <= Instruction::MOVE_RESULT_OBJECT) ||
+        (opcode >= Instruction::CONST_4 && opcode <= Instruction::CONST_STRING_JUMBO) ||
+        (opcode >= Instruction::CMPL_FLOAT && opcode <= Instruction::CMP_LONG) ||
+        (opcode >= Instruction::IF_EQ && opcode <= Instruction::IF_LEZ) ||
+        (opcode >= Instruction::AGET && opcode <= Instruction::APUT_SHORT) ||
+        (opcode >= Instruction::NEG_INT && opcode <= Instruction::INT_TO_SHORT) ||
+        (opcode >= Instruction::ADD_INT && opcode <= Instruction::USHR_INT_LIT8)) {
+      continue;
+    }
+    // Invokes, instance allocations, accesses to other classes' fields, monitors,
+    // throws etc. may be observable.
+    return false;
+  }
+  return true;
+}
+
+// Returns true if `klass` can be initialized ahead of its first use without observable
+// differences: every class initializer which would run, i.e. those of the uninitialized
+// part of the superclass chain and of uninitialized interfaces with default methods,
+// must be free of side effects.
+static bool CanSafelyPreInitialize(ObjPtr<mirror::Class> klass, PointerSize pointer_size)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  for (ObjPtr<mirror::Class> k = klass; k != nullptr && !k->IsInitialized();
+       k = k->GetSuperClass()) {
+    ArtMethod* clinit = k->FindClassInitializer(pointer_size);
+    if (clinit != nullptr && !IsSideEffectFreeClassInitializer(clinit)) {
+      return false;
+    }
+  }
+  const int32_t iftable_count = klass->GetIfTableCount();
+  for (int32_t i = 0; i < iftable_count; ++i) {
+    ObjPtr<mirror::Class> iface = klass->GetIfTable()->GetInterface(i);
+    if (!iface->HasDefaultMethods() || iface->IsInitialized()) {
+      continue;
+    }
+    ArtMethod* clinit = iface->FindClassInitializer(pointer_size);
+    if (clinit != nullptr && !IsSideEffectFreeClassInitializer(clinit)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class StartupInitializedClassCollector : public ClassVisitor {
+ public:
+  bool operator()(ObjPtr<mirror::Class> klass) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (klass->IsPrimitive() ||
+        klass->IsArrayClass() ||
+        klass->IsProxyClass() ||
+        klass->GetClassLoader() == nullptr ||  // Boot classes are initialized by the zygote.
+        !klass->IsInitialized()) {
+      return true;
+    }
+    const OatDexFile* oat_dex_file = klass->GetDexFile().GetOatDexFile();
+    if (oat_dex_file == nullptr || oat_dex_file->GetOatFile() == nullptr) {
+      return true;
+    }
+    const OatFile* oat_file = oat_dex_file->GetOatFile();
+    const std::vector<const OatDexFile*>& oat_dex_files = oat_file->GetOatDexFiles();
+    for (size_t i = 0; i != oat_dex_files.size(); ++i) {
+      if (oat_dex_files[i] == oat_dex_file) {
+        classes_[oat_file].push_back(
+            std::make_pair(static_cast<uint32_t>(i), klass->GetDexClassDefIndex()));
+        break;
+      }
+    }
+    return true;
+  }
+
+  std::map<const OatFile*, std::vector<std::pair<uint32_t, uint32_t>>> classes_;
+};
+
+void OatFileManager::RecordStartupInitializedClasses() {
+  StartupInitializedClassCollector collector;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    Runtime::Current()->GetClassLinker()->VisitClasses(&collector);
+  }
+  for (const auto& entry : collector.classes_) {
+    const OatFile* oat_file = entry.first;
+    if (oat_file->GetLocation().empty()) {
+      continue;
+    }
+    std::string data(sizeof(ClassInitCheckpointHeader), '\0');
+    for (const std::pair<uint32_t, uint32_t>& klass : entry.second) {
+      const uint32_t class_entry[2] = { klass.first, klass.second };
+      data.append(reinterpret_cast<const char*>(class_entry), sizeof(class_entry));
+    }
+    ClassInitCheckpointHeader header;
+    memcpy(header.magic, kClassInitCheckpointMagic, sizeof(header.magic));
+    header.version = kClassInitCheckpointVersion;
+    header.oat_checksum = oat_file->GetOatHeader().GetChecksum();
+    header.num_classes = static_cast<uint32_t>(entry.second.size());
+    memcpy(&data[0], &header, sizeof(header));
+    const std::string checkpoint_file = GetClassInitCheckpointFileName(oat_file->GetLocation());
+    if (!android::base::WriteStringToFile(data, checkpoint_file)) {
+      // The directory holding the oat file is not always writable, e.g. on /system.
+      VLOG(startup) << "Failed to write class initialization checkpoint to " << checkpoint_file;
+    } else {
+      VLOG(startup) << "Recorded " << entry.second.size() << " initialized classes for "
+                    << oat_file->GetLocation();
+    }
+  }
+}
+
+class StartupClassPreInitializationTask final : public Task {
+ public:
+  StartupClassPreInitializationTask(std::vector<std::pair<const DexFile*, uint32_t>>&& classes,
+                                    jobject class_loader)
+      : classes_(std::move(classes)) {
+    Thread* const self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    // Create a global ref for `class_loader` because it will be accessed from a different thread.
+    class_loader_ = soa.Vm()->AddGlobalRef(self, soa.Decode<mirror::ClassLoader>(class_loader));
+    CHECK(class_loader_ != nullptr);
+  }
+
+  ~StartupClassPreInitializationTask() {
+    Thread* const self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    soa.Vm()->DeleteGlobalRef(self, class_loader_);
+  }
+
+  void Run(Thread* self) override {
+    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+    const PointerSize pointer_size = class_linker->GetImagePointerSize();
+    for (const std::pair<const DexFile*, uint32_t>& entry : classes_) {
+      const DexFile* dex_file = entry.first;
+      const dex::ClassDef& class_def = dex_file->GetClassDef(entry.second);
+
+      // Take handles inside the loop. The pre-initialization is low priority
+      // and we want to minimize the risk of blocking anyone else.
+      ScopedObjectAccess soa(self);
+      StackHandleScope<2> hs(self);
+      Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+          soa.Decode<mirror::ClassLoader>(class_loader_)));
+      Handle<mirror::Class> h_class(hs.NewHandle<mirror::Class>(class_linker->FindClass(
+          self,
+          dex_file->GetClassDescriptor(class_def),
+          h_loader)));
+
+      if (h_class == nullptr) {
+        CHECK(self->IsExceptionPending());
+        self->ClearException();
+        continue;
+      }
+
+      if (&h_class->GetDexFile() != dex_file) {
+        // There is a different class in the class path or a parent class loader
+        // with the same descriptor. The recorded class is not resolvable, skip it.
+        continue;
+      }
+
+      if (h_class->IsInitialized() ||
+          h_class->IsErroneous() ||
+          !CanSafelyPreInitialize(h_class.Get(), pointer_size)) {
+        continue;
+      }
+
+      class_linker->EnsureInitialized(
+          self, h_class, /*can_init_fields=*/ true, /*can_init_parents=*/ true);
+      if (self->IsExceptionPending()) {
+        self->ClearException();
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const std::vector<std::pair<const DexFile*, uint32_t>> classes_;
+  jobject class_loader_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupClassPreInitializationTask);
+};
+
+void OatFileManager::RunStartupClassPreInitialization(
+    const std::vector<const DexFile*>& dex_files, jobject class_loader) {
+  Runtime* const runtime = Runtime::Current();
+  Thread* const self = Thread::Current();
+
+  if (class_loader == nullptr || runtime->GetStartupCompleted()) {
+    // The checkpoint only describes classes initialized during startup.
+    return;
+  }
+
+  if (runtime->IsJavaDebuggable()) {
+    // Threads created by ThreadPool ("runtime threads") are not allowed to load
+    // classes when debuggable to match class-initialization semantics
+    // expectations. Do not pre-initialize in the background.
+    return;
+  }
+
+  if (!IsSdkVersionSetAndAtLeast(runtime->GetTargetSdkVersion(), SdkVersion::kQ)) {
+    // Do not run for legacy apps as they may depend on the previous class loader behaviour.
+    return;
+  }
+
+  if (runtime->IsShuttingDown(self)) {
+    // Not allowed to create new threads during runtime shutdown.
+    return;
+  }
+
+  // Parse the checkpoints recorded beside the oat files backing `dex_files`.
+  std::vector<std::pair<const DexFile*, uint32_t>> classes;
+  std::set<const OatFile*> parsed_oat_files;
+  for (const DexFile* dex_file : dex_files) {
+    const OatDexFile* oat_dex_file = dex_file->GetOatDexFile();
+    const OatFile* oat_file = (oat_dex_file != nullptr) ? oat_dex_file->GetOatFile() : nullptr;
+    if (oat_file == nullptr ||
+        oat_file->GetLocation().empty() ||
+        !parsed_oat_files.insert(oat_file).second) {
+      continue;
+    }
+    const std::string checkpoint_file = GetClassInitCheckpointFileName(oat_file->GetLocation());
+    std::string data;
+    if (!android::base::ReadFileToString(checkpoint_file, &data)) {
+      continue;
+    }
+    ClassInitCheckpointHeader header;
+    if (data.size() < sizeof(header)) {
+      continue;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if (memcmp(header.magic, kClassInitCheckpointMagic, sizeof(header.magic)) != 0 ||
+        header.version != kClassInitCheckpointVersion ||
+        header.oat_checksum != oat_file->GetOatHeader().GetChecksum() ||
+        data.size() < sizeof(header) + header.num_classes * 2u * sizeof(uint32_t)) {
+      // Stale or corrupt checkpoint, e.g. after recompilation. Remove it so that the
+      // next startup completion records a fresh one.
+      unlink(checkpoint_file.c_str());
+      continue;
+    }
+    const std::vector<const OatDexFile*>& oat_dex_files = oat_file->GetOatDexFiles();
+    const uint32_t* entries = reinterpret_cast<const uint32_t*>(data.data() + sizeof(header));
+    for (uint32_t i = 0u; i != header.num_classes; ++i) {
+      const uint32_t dex_index = entries[2u * i];
+      const uint32_t class_def_index = entries[2u * i + 1u];
+      if (dex_index >= oat_dex_files.size()) {
+        continue;
+      }
+      // Match the oat dex file back to the dex file opened by this class loader.
+      for (const DexFile* loader_dex_file : dex_files) {
+        if (loader_dex_file->GetOatDexFile() == oat_dex_files[dex_index] &&
+            class_def_index < loader_dex_file->NumClassDefs()) {
+          classes.push_back(std::make_pair(loader_dex_file, class_def_index));
+          break;
+        }
+      }
+    }
+  }
+
+  if (classes.empty()) {
+    return;
+  }
+
+  {
+    WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
+    if (verification_thread_pool_ == nullptr) {
+      verification_thread_pool_.reset(
+          new ThreadPool("Verification thread pool", /* num_threads= */ 1));
+      verification_thread_pool_->StartWorkers(self);
+    }
+  }
+  verification_thread_pool_->AddTask(
+      self, new StartupClassPreInitializationTask(std::move(classes), class_loader));
+}
+
 }  // namespace art
@@ -27,6 +27,7 @@
 #include "base/locks.h"
 #include "base/macros.h"
 #include "jni.h"
+#include "obj_ptr.h"
 
 namespace art {
 
@@ -36,9 +37,14 @@ class ImageSpace;
 }  // namespace space
 }  // namespace gc
 
+namespace mirror {
+class Class;
+}  // namespace mirror
+
 class ClassLoaderContext;
 class DexFile;
 class MemMap;
+class OatDexFile;
 class OatFile;
 class ThreadPool;
 
@@ -124,6 +130,35 @@ class OatFileManager {
   void RunBackgroundVerification(const std::vector<const DexFile*>& dex_files,
                                  jobject class_loader);
 
+  // Re-verify `klass` on the background verification thread pool, lifting the
+  // interpreter access checks from its methods on success. Used when runtime
+  // verification of a class has been optimistically deferred at load time.
+  void EnqueueBackgroundReverification(Thread* self, ObjPtr<mirror::Class> klass)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::oat_file_manager_lock_);
+
+  // Record which pages of the loaded executable oat files are resident now that startup
+  // has completed, persisting a compact page-run list beside each oat file. The next
+  // launch uses the list to prefetch exactly the pages startup is going to fault in.
+  void RecordOatFilePrefetchHints() REQUIRES(!Locks::oat_file_manager_lock_);
+
+  // Issue madvise(MADV_WILLNEED) for the page ranges recorded by a previous run of the
+  // same oat file. Returns false if no valid hints exist, in which case the caller may
+  // fall back to a default readahead strategy.
+  static bool MadviseOatFileWithPrefetchHints(const OatFile& oat_file);
+
+  // Record which classes loaded by app class loaders reached the initialized state now
+  // that startup has completed, persisting a checkpoint beside each oat file. The next
+  // launch pre-initializes those classes in the background ahead of their first use.
+  void RecordStartupInitializedClasses()
+      REQUIRES(!Locks::oat_file_manager_lock_, !Locks::mutator_lock_);
+
+  // Schedule background pre-initialization of the classes recorded by a previous launch
+  // for the given oat-backed dex files. Only classes whose initializer chains are
+  // provably free of observable side effects are initialized ahead of first use.
+  void RunStartupClassPreInitialization(const std::vector<const DexFile*>& dex_files,
+                                        jobject class_loader);
+
   // Wait for thread pool workers to be created. This is used during shutdown as
   // threads are not allowed to attach while runtime is in shutdown lock.
   void WaitForWorkersToBeCreated();
@@ -149,6 +184,14 @@ class OatFileManager {
   const OatFile* FindOpenedOatFileFromOatLocationLocked(const std::string& oat_location) const
       REQUIRES(Locks::oat_file_manager_lock_);
 
+  // Build a type lookup table for each of `dex_files` not backed by an oat file, so
+  // that class def lookups do not fall back to a linear scan of the class definitions.
+  // The table data is placed in a memfd region named after the dex location checksum,
+  // allowing another process of the same application to map an already-built table
+  // instead of rebuilding it once it receives the file descriptor.
+  void CreateTypeLookupTables(const std::vector<std::unique_ptr<const DexFile>>& dex_files)
+      REQUIRES(!Locks::oat_file_manager_lock_);
+
   // Return true if we should attempt to load the app image.
   bool ShouldLoadAppImage(const OatFile* source_oat_file) const;
 
@@ -161,6 +204,12 @@ class OatFileManager {
   // Single-thread pool used to run the verifier in the background.
   std::unique_ptr<ThreadPool> verification_thread_pool_;
 
+  // Type lookup tables created on the fly for dex files not backed by an oat file,
+  // together with the shared memory mappings backing their data.
+  std::vector<std::unique_ptr<OatDexFile>> type_lookup_tables_
+      GUARDED_BY(Locks::oat_file_manager_lock_);
+  std::vector<MemMap> type_lookup_table_maps_ GUARDED_BY(Locks::oat_file_manager_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(OatFileManager);
 };
 
@@ -114,6 +114,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::BootClassPath)
       .Define("-Xcheck:jni")
           .IntoKey(M::CheckJni)
+      .Define("-Xcheck:jni:sample=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::CheckJniSamplingInterval)
       .Define("-Xms_")
           .WithType<MemoryKiB>()
           .IntoKey(M::MemoryInitialSize)
@@ -211,6 +214,12 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::DumpRegionInfoBeforeGC)
       .Define("-XX:DumpRegionInfoAfterGC")
           .IntoKey(M::DumpRegionInfoAfterGC)
+      .Define("-XX:UseRegionSpaceHugePages")
+          .IntoKey(M::UseRegionSpaceHugePages)
+      .Define("-XX:UseNumaLocalRegions")
+          .IntoKey(M::UseNumaLocalRegions)
+      .Define("-XX:UseAdaptiveTlabSize")
+          .IntoKey(M::UseAdaptiveTlabSize)
       .Define("-XX:DumpJITInfoOnShutdown")
           .IntoKey(M::DumpJITInfoOnShutdown)
       .Define("-XX:IgnoreMaxFootprint")
@@ -257,6 +266,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitmaxsize:_")
           .WithType<MemoryKiB>()
           .IntoKey(M::JITCodeCacheMaxCapacity)
+      .Define("-Xjitbaselinethreshold:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITBaselineThreshold)
       .Define("-Xjitwarmupthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITWarmupThreshold)
@@ -296,6 +308,7 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
                "-Xps-min-classes-to-save:_",
                "-Xps-min-notification-before-wake:_",
                "-Xps-max-notification-before-wake:_",
+               "-Xps-hotness-sampling-interval-ms:_",
                "-Xps-profile-path:_"})
           .WithHelp("profile-saver options -Xps-<key>:<value>")
           .WithType<ProfileSaverOptions>()
@@ -369,6 +382,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("--cpu-abilist=_")
           .WithType<std::string>()
           .IntoKey(M::CpuAbiList)
+      .Define("-Xsuppressed-backtrace-classes:_")
+          .WithType<std::string>()
+          .IntoKey(M::SuppressedBacktraceClasses)
       .Define("-Xfingerprint:_")
           .WithType<std::string>()
           .IntoKey(M::Fingerprint)
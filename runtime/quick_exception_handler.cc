@@ -23,6 +23,7 @@
 #include "base/globals.h"
 #include "base/logging.h"  // For VLOG_IS_ON.
 #include "base/systrace.h"
+#include "code_info_cache.h"
 #include "dex/dex_file_types.h"
 #include "dex/dex_instruction.h"
 #include "entrypoints/entrypoint_utils.h"
@@ -247,7 +248,7 @@ void QuickExceptionHandler::SetCatchEnvironmentForOptimizedHandler(StackVisitor*
 
   CodeItemDataAccessor accessor(GetHandlerMethod()->DexInstructionData());
   const size_t number_of_vregs = accessor.RegistersSize();
-  CodeInfo code_info(handler_method_header_);
+  CodeInfo code_info = self_->GetCodeInfoCache()->GetCodeInfo(handler_method_header_);
 
   // Find stack map of the catch block.
   StackMap catch_stack_map = code_info.GetCatchStackMapForDexPc(GetHandlerDexPc());
@@ -456,7 +457,7 @@ class DeoptimizeStackVisitor final : public StackVisitor {
                                       const bool* updated_vregs)
       REQUIRES_SHARED(Locks::mutator_lock_) {
     const OatQuickMethodHeader* method_header = GetCurrentOatQuickMethodHeader();
-    CodeInfo code_info(method_header);
+    CodeInfo code_info = GetThread()->GetCodeInfoCache()->GetCodeInfo(method_header);
     uintptr_t native_pc_offset = method_header->NativeQuickPcOffset(GetCurrentQuickFramePc());
     StackMap stack_map = code_info.GetStackMapForNativePcOffset(native_pc_offset);
     CodeItemDataAccessor accessor(m->DexInstructionData());
@@ -92,6 +92,7 @@
 #include "instrumentation.h"
 #include "intern_table-inl.h"
 #include "interpreter/interpreter.h"
+#include "interpreter/interpreter_cache.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/profile_saver.h"
@@ -692,6 +693,27 @@ void Runtime::Abort(const char* msg) {
 }
 
 void Runtime::PreZygoteFork() {
+  // Prefault the boot image and oat file pages while they can still be shared:
+  // every forked child would otherwise take its own page-cache misses faulting
+  // in this file-backed memory on first touch.
+  {
+    ScopedTrace trace2("PreZygoteFork prefault boot images");
+    for (gc::space::ImageSpace* space : heap_->GetBootImageSpaces()) {
+      MadviseFileForRange(std::numeric_limits<size_t>::max(),
+                          space->Size(),
+                          space->Begin(),
+                          space->End(),
+                          space->GetImageLocation());
+      const OatFile* oat_file = space->GetOatFile();
+      if (oat_file != nullptr && oat_file->Begin() != nullptr) {
+        MadviseFileForRange(std::numeric_limits<size_t>::max(),
+                            oat_file->Size(),
+                            oat_file->Begin(),
+                            oat_file->End(),
+                            oat_file->GetLocation());
+      }
+    }
+  }
   if (GetJit() != nullptr) {
     GetJit()->PreZygoteFork();
   }
@@ -1482,6 +1504,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   monitor_pool_ = MonitorPool::Create();
   thread_list_ = new ThreadList(runtime_options.GetOrDefault(Opt::ThreadSuspendTimeout));
   intern_table_ = new InternTable;
+  interpreter_shared_cache_.reset(new InterpreterSharedCache());
 
   monitor_timeout_enable_ = runtime_options.GetOrDefault(Opt::MonitorTimeoutEnable);
   int monitor_timeout_ms = runtime_options.GetOrDefault(Opt::MonitorTimeout);
@@ -1520,6 +1543,10 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   Split(runtime_options.GetOrDefault(Opt::CpuAbiList), ',', &cpu_abilist_);
 
+  Split(runtime_options.GetOrDefault(Opt::SuppressedBacktraceClasses),
+        ',',
+        &suppressed_backtrace_classes_);
+
   fingerprint_ = runtime_options.ReleaseOrDefault(Opt::Fingerprint);
 
   if (runtime_options.GetOrDefault(Opt::Interpret)) {
@@ -1559,46 +1586,60 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   // Generational CC collection is currently only compatible with Baker read barriers.
   bool use_generational_cc = kUseBakerReadBarrier && xgc_option.generational_cc;
 
-  heap_ = new gc::Heap(runtime_options.GetOrDefault(Opt::MemoryInitialSize),
-                       runtime_options.GetOrDefault(Opt::HeapGrowthLimit),
-                       runtime_options.GetOrDefault(Opt::HeapMinFree),
-                       runtime_options.GetOrDefault(Opt::HeapMaxFree),
-                       runtime_options.GetOrDefault(Opt::HeapTargetUtilization),
-                       foreground_heap_growth_multiplier,
-                       runtime_options.GetOrDefault(Opt::StopForNativeAllocs),
-                       runtime_options.GetOrDefault(Opt::MemoryMaximumSize),
-                       runtime_options.GetOrDefault(Opt::NonMovingSpaceCapacity),
-                       GetBootClassPath(),
-                       GetBootClassPathLocations(),
-                       image_location_,
-                       instruction_set_,
-                       // Override the collector type to CC if the read barrier config.
-                       kUseReadBarrier ? gc::kCollectorTypeCC : xgc_option.collector_type_,
-                       kUseReadBarrier ? BackgroundGcOption(gc::kCollectorTypeCCBackground)
-                                       : runtime_options.GetOrDefault(Opt::BackgroundGc),
-                       runtime_options.GetOrDefault(Opt::LargeObjectSpace),
-                       runtime_options.GetOrDefault(Opt::LargeObjectThreshold),
-                       runtime_options.GetOrDefault(Opt::ParallelGCThreads),
-                       runtime_options.GetOrDefault(Opt::ConcGCThreads),
-                       runtime_options.Exists(Opt::LowMemoryMode),
-                       runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
-                       runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
-                       runtime_options.Exists(Opt::IgnoreMaxFootprint),
-                       runtime_options.GetOrDefault(Opt::AlwaysLogExplicitGcs),
-                       runtime_options.GetOrDefault(Opt::UseTLAB),
-                       xgc_option.verify_pre_gc_heap_,
-                       xgc_option.verify_pre_sweeping_heap_,
-                       xgc_option.verify_post_gc_heap_,
-                       xgc_option.verify_pre_gc_rosalloc_,
-                       xgc_option.verify_pre_sweeping_rosalloc_,
-                       xgc_option.verify_post_gc_rosalloc_,
-                       xgc_option.gcstress_,
-                       xgc_option.measure_,
-                       runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
-                       use_generational_cc,
-                       runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
-                       runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
-                       runtime_options.Exists(Opt::DumpRegionInfoAfterGC));
+  // Block the signals we will want blocked in all threads now, so that the heap
+  // initialization thread below (and any thread it may spawn) inherits the mask.
+  BlockSignals();
+
+  // Creating the heap maps and verifies the boot image spaces, which is mostly I/O
+  // bound and independent of the signal/fault-handler setup and JavaVMExt creation
+  // below. Run it concurrently and join before anything dereferences heap_. All
+  // accesses to runtime_options between here and the join are read-only.
+  std::thread heap_init_thread([&]() {
+    heap_ = new gc::Heap(runtime_options.GetOrDefault(Opt::MemoryInitialSize),
+                         runtime_options.GetOrDefault(Opt::HeapGrowthLimit),
+                         runtime_options.GetOrDefault(Opt::HeapMinFree),
+                         runtime_options.GetOrDefault(Opt::HeapMaxFree),
+                         runtime_options.GetOrDefault(Opt::HeapTargetUtilization),
+                         foreground_heap_growth_multiplier,
+                         runtime_options.GetOrDefault(Opt::StopForNativeAllocs),
+                         runtime_options.GetOrDefault(Opt::MemoryMaximumSize),
+                         runtime_options.GetOrDefault(Opt::NonMovingSpaceCapacity),
+                         GetBootClassPath(),
+                         GetBootClassPathLocations(),
+                         image_location_,
+                         instruction_set_,
+                         // Override the collector type to CC if the read barrier config.
+                         kUseReadBarrier ? gc::kCollectorTypeCC : xgc_option.collector_type_,
+                         kUseReadBarrier ? BackgroundGcOption(gc::kCollectorTypeCCBackground)
+                                         : runtime_options.GetOrDefault(Opt::BackgroundGc),
+                         runtime_options.GetOrDefault(Opt::LargeObjectSpace),
+                         runtime_options.GetOrDefault(Opt::LargeObjectThreshold),
+                         runtime_options.GetOrDefault(Opt::ParallelGCThreads),
+                         runtime_options.GetOrDefault(Opt::ConcGCThreads),
+                         runtime_options.Exists(Opt::LowMemoryMode),
+                         runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
+                         runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
+                         runtime_options.Exists(Opt::IgnoreMaxFootprint),
+                         runtime_options.GetOrDefault(Opt::AlwaysLogExplicitGcs),
+                         runtime_options.GetOrDefault(Opt::UseTLAB),
+                         xgc_option.verify_pre_gc_heap_,
+                         xgc_option.verify_pre_sweeping_heap_,
+                         xgc_option.verify_post_gc_heap_,
+                         xgc_option.incremental_verify_,
+                         xgc_option.verify_pre_gc_rosalloc_,
+                         xgc_option.verify_pre_sweeping_rosalloc_,
+                         xgc_option.verify_post_gc_rosalloc_,
+                         xgc_option.gcstress_,
+                         xgc_option.measure_,
+                         runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
+                         use_generational_cc,
+                         runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
+                         runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
+                         runtime_options.Exists(Opt::DumpRegionInfoAfterGC),
+                         runtime_options.Exists(Opt::UseRegionSpaceHugePages),
+                         runtime_options.Exists(Opt::UseAdaptiveTlabSize),
+                         runtime_options.Exists(Opt::UseNumaLocalRegions));
+  });
 
   dump_gc_performance_on_shutdown_ = runtime_options.Exists(Opt::DumpGCPerformanceOnShutdown);
 
@@ -1662,7 +1703,6 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   }
   linear_alloc_.reset(CreateLinearAlloc());
 
-  BlockSignals();
   InitPlatformSignalHandlers();
 
   // Change the implicit checks flags based on runtime architecture.
@@ -1713,6 +1753,12 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   std::string error_msg;
   java_vm_ = JavaVMExt::Create(this, runtime_options, &error_msg);
+
+  // Attaching a thread reads from the heap (e.g. the card table base), so the heap
+  // must be fully constructed before Thread::Startup(). Join here so that the error
+  // path below does not leave the initialization thread running.
+  heap_init_thread.join();
+
   if (java_vm_.get() == nullptr) {
     LOG(ERROR) << "Could not initialize JavaVMExt: " << error_msg;
     return false;
@@ -2231,12 +2277,14 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
     os << "Running non JIT\n";
   }
   DumpDeoptimizations(os);
+  fault_manager.DumpForSigQuit(os);
   TrackedAllocators::Dump(os);
   GetMetrics()->DumpForSigQuit(os);
   os << "\n";
 
   thread_list_->DumpForSigQuit(os);
   BaseMutex::DumpAll(os);
+  BaseMutex::DumpContentionCounters(os);
 
   // Inform anyone else who is interested in SigQuit.
   {
@@ -2402,14 +2450,31 @@ void Runtime::VisitConstantRoots(RootVisitor* visitor) {
   }
 }
 
+void Runtime::VisitConcurrentRootShard(RootVisitor* visitor, VisitRootFlags flags, size_t shard) {
+  DCHECK_LT(shard, kNumConcurrentRootShards);
+  switch (shard) {
+    case 0:
+      intern_table_->VisitRoots(visitor, flags);
+      break;
+    case 1:
+      class_linker_->VisitRoots(visitor, flags);
+      break;
+    case 2:
+      jni_id_manager_->VisitRoots(visitor);
+      heap_->VisitAllocationRecords(visitor);
+      break;
+    case 3:
+      if ((flags & kVisitRootFlagNewRoots) == 0) {
+        // Guaranteed to have no new roots in the constant roots.
+        VisitConstantRoots(visitor);
+      }
+      break;
+  }
+}
+
 void Runtime::VisitConcurrentRoots(RootVisitor* visitor, VisitRootFlags flags) {
-  intern_table_->VisitRoots(visitor, flags);
-  class_linker_->VisitRoots(visitor, flags);
-  jni_id_manager_->VisitRoots(visitor);
-  heap_->VisitAllocationRecords(visitor);
-  if ((flags & kVisitRootFlagNewRoots) == 0) {
-    // Guaranteed to have no new roots in the constant roots.
-    VisitConstantRoots(visitor);
+  for (size_t shard = 0; shard < kNumConcurrentRootShards; ++shard) {
+    VisitConcurrentRootShard(visitor, flags, shard);
   }
 }
 
@@ -2965,6 +3030,17 @@ bool Runtime::IsVerificationSoftFail() const {
   return verify_ == verifier::VerifyMode::kSoftFail;
 }
 
+bool Runtime::IsBacktraceSuppressed(ObjPtr<mirror::Class> klass) const {
+  DCHECK(HasSuppressedBacktraceClasses());
+  DCHECK(klass != nullptr);
+  for (const std::string& descriptor : suppressed_backtrace_classes_) {
+    if (klass->DescriptorEquals(descriptor.c_str())) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool Runtime::IsAsyncDeoptimizeable(uintptr_t code) const {
   if (OatQuickMethodHeader::NterpMethodHeader != nullptr) {
     if (OatQuickMethodHeader::NterpMethodHeader->Contains(code)) {
@@ -3194,6 +3270,20 @@ class Runtime::NotifyStartupCompletedTask : public gc::HeapTask {
       ScopedTrace trace2("Delete thread pool");
       runtime->DeleteThreadPool();
     }
+
+    {
+      // Remember which oat file pages were touched during startup so that the next
+      // launch of this app can prefetch exactly those ranges.
+      ScopedTrace trace3("Record oat file prefetch hints");
+      runtime->GetOatFileManager().RecordOatFilePrefetchHints();
+    }
+
+    {
+      // Remember which app classes were initialized during startup so that the next
+      // launch of this app can pre-initialize the side-effect-free ones early.
+      ScopedTrace trace4("Record startup initialized classes");
+      runtime->GetOatFileManager().RecordStartupInitializedClasses();
+    }
   }
 };
 
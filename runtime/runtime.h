@@ -94,6 +94,7 @@ class Dex2oatImageTest;
 class DexFile;
 enum class InstructionSet;
 class InternTable;
+class InterpreterSharedCache;
 class IsMarkedVisitor;
 class JavaVMExt;
 class LinearAlloc;
@@ -305,6 +306,10 @@ class Runtime {
     return jni_id_manager_.get();
   }
 
+  InterpreterSharedCache* GetInterpreterSharedCache() const {
+    return interpreter_shared_cache_.get();
+  }
+
   size_t GetDefaultStackSize() const {
     return default_stack_size_;
   }
@@ -393,6 +398,17 @@ class Runtime {
       REQUIRES(!Locks::classlinker_classes_lock_, !Locks::trace_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // The number of independently visitable shards of the concurrent roots. Collectors may call
+  // VisitConcurrentRootShard() once per shard from different worker threads to spread the root
+  // scan over multiple cores; visiting all shards is equivalent to VisitConcurrentRoots().
+  static constexpr size_t kNumConcurrentRootShards = 4;
+
+  // Visit a single shard of the concurrent roots. The visitor must be safe to invoke from
+  // multiple threads if shards are visited concurrently.
+  void VisitConcurrentRootShard(RootVisitor* visitor, VisitRootFlags flags, size_t shard)
+      REQUIRES(!Locks::classlinker_classes_lock_, !Locks::trace_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Visit all of the non thread roots, we can do this with mutators unpaused.
   void VisitNonThreadRoots(RootVisitor* visitor)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -672,6 +688,19 @@ class Runtime {
     return cpu_abilist_;
   }
 
+  // Whether -Xsuppressed-backtrace-classes was given any class descriptors.
+  // Cheap check for the exception-construction fast path.
+  bool HasSuppressedBacktraceClasses() const {
+    return !suppressed_backtrace_classes_.empty();
+  }
+
+  // Returns true if backtrace collection is suppressed for exceptions of the
+  // given class, as configured with -Xsuppressed-backtrace-classes. Such
+  // exceptions are constructed with a null stack state, like the
+  // pre-allocated OutOfMemoryError instances.
+  bool IsBacktraceSuppressed(ObjPtr<mirror::Class> klass) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   bool IsRunningOnMemoryTool() const {
     return is_running_on_memory_tool_;
   }
@@ -1165,6 +1194,9 @@ class Runtime {
 
   ClassLinker* class_linker_;
 
+  // Second-level cache backing the per-thread interpreter caches.
+  std::unique_ptr<InterpreterSharedCache> interpreter_shared_cache_;
+
   SignalCatcher* signal_catcher_;
 
   std::unique_ptr<jni::JniIdManager> jni_id_manager_;
@@ -1238,6 +1270,10 @@ class Runtime {
   // List of supported cpu abis.
   std::vector<std::string> cpu_abilist_;
 
+  // Class descriptors whose exception instances skip backtrace collection,
+  // from -Xsuppressed-backtrace-classes.
+  std::vector<std::string> suppressed_backtrace_classes_;
+
   // Specifies target SDK version to allow workarounds for certain API levels.
   uint32_t target_sdk_version_;
 
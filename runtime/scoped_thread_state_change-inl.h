@@ -117,6 +117,17 @@ inline ScopedObjectAccess::ScopedObjectAccess(JNIEnv* env) : ScopedObjectAccessU
 inline ScopedObjectAccess::ScopedObjectAccess(Thread* self) : ScopedObjectAccessUnchecked(self) {}
 inline ScopedObjectAccess::~ScopedObjectAccess() {}
 
+inline ScopedStayRunnableForJni::ScopedStayRunnableForJni(Thread* self) : self_(self) {
+  DCHECK_EQ(self_, Thread::Current());
+  DCHECK_EQ(self_->GetState(), kRunnable);
+  self_->IncrementJniStayRunnableDepth();
+}
+
+inline ScopedStayRunnableForJni::~ScopedStayRunnableForJni() {
+  DCHECK_EQ(self_->GetState(), kRunnable);
+  self_->DecrementJniStayRunnableDepth();
+}
+
 inline ScopedThreadSuspension::ScopedThreadSuspension(Thread* self, ThreadState suspended_state)
     : self_(self), suspended_state_(suspended_state) {
   DCHECK(self_ != nullptr);
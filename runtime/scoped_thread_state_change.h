@@ -192,6 +192,25 @@ class ScopedObjectAccess : public ScopedObjectAccessUnchecked {
   DISALLOW_COPY_AND_ASSIGN(ScopedObjectAccess);
 };
 
+// Keeps the thread runnable across consecutive calls into regular native methods made
+// from the enclosed code: while the region is active, the JniMethodStart/End entrypoints
+// elide the runnable <-> native state transition, as they already do for @FastNative
+// methods, and only poll for pending suspend requests on the way out of each call. Only
+// use this around batches of short-running native calls, since the thread keeps its
+// share of the mutator lock while the native code runs and thus delays GC pauses.
+class ScopedStayRunnableForJni : public ValueObject {
+ public:
+  ALWAYS_INLINE explicit ScopedStayRunnableForJni(Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  ALWAYS_INLINE ~ScopedStayRunnableForJni() REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  Thread* const self_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedStayRunnableForJni);
+};
+
 // Annotalysis helper for going to a suspended state from runnable.
 class ScopedThreadSuspension : public ValueObject {
  public:
@@ -24,6 +24,7 @@
 #include "base/callee_save_type.h"
 #include "base/enums.h"
 #include "base/hex_dump.h"
+#include "code_info_cache.h"
 #include "dex/dex_file_types.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "entrypoints/quick/callee_save_frame.h"
@@ -272,7 +273,9 @@ bool StackVisitor::GetVRegFromOptimizedCode(ArtMethod* m,
   uint16_t number_of_dex_registers = accessor.RegistersSize();
   DCHECK_LT(vreg, number_of_dex_registers);
   const OatQuickMethodHeader* method_header = GetCurrentOatQuickMethodHeader();
-  CodeInfo code_info(method_header);
+  // Use the walking thread's cache: the decoded data depends only on the
+  // method header, and `thread_` may be a different, suspended thread.
+  CodeInfo code_info = Thread::Current()->GetCodeInfoCache()->GetCodeInfo(method_header);
 
   uint32_t native_pc_offset = method_header->NativeQuickPcOffset(cur_quick_frame_pc_);
   StackMap stack_map = code_info.GetStackMapForNativePcOffset(native_pc_offset);
@@ -57,6 +57,7 @@
 #include "base/utils.h"
 #include "class_linker-inl.h"
 #include "class_root-inl.h"
+#include "code_info_cache.h"
 #include "debugger.h"
 #include "dex/descriptors_names.h"
 #include "dex/dex_file-inl.h"
@@ -86,6 +87,7 @@
 #include "mirror/stack_trace_element.h"
 #include "monitor.h"
 #include "monitor_objects_stack_visitor.h"
+#include "monitor_pool.h"
 #include "native_stack_dump.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "nativehelper/scoped_utf_chars.h"
@@ -965,7 +967,7 @@ bool Thread::Init(ThreadList* thread_list, JavaVMExt* java_vm, JNIEnvExt* jni_en
     tlsPtr_.jni_env = jni_env_ext;
   } else {
     std::string error_msg;
-    tlsPtr_.jni_env = JNIEnvExt::Create(this, java_vm, &error_msg);
+    tlsPtr_.jni_env = java_vm->CreateJniEnv(this, &error_msg);
     if (tlsPtr_.jni_env == nullptr) {
       LOG(ERROR) << "Failed to create JNIEnvExt: " << error_msg;
       return false;
@@ -1534,13 +1536,19 @@ bool Thread::PassActiveSuspendBarriers(Thread* self) {
   return true;
 }
 
-void Thread::ClearSuspendBarrier(AtomicInteger* target) {
-  CHECK(ReadFlag(kActiveSuspendBarrier));
+bool Thread::ClearSuspendBarrier(AtomicInteger* target) {
+  if (!ReadFlag(kActiveSuspendBarrier)) {
+    // The barriers have already been claimed by PassActiveSuspendBarriers(); since we hold
+    // the suspend count lock, the thread is now decrementing them outside of the lock.
+    return false;
+  }
+  bool found = false;
   bool clear_flag = true;
   for (uint32_t i = 0; i < kMaxSuspendBarriers; ++i) {
     AtomicInteger* ptr = tlsPtr_.active_suspend_barriers[i];
     if (ptr == target) {
       tlsPtr_.active_suspend_barriers[i] = nullptr;
+      found = true;
     } else if (ptr != nullptr) {
       clear_flag = false;
     }
@@ -1548,6 +1556,7 @@ void Thread::ClearSuspendBarrier(AtomicInteger* target) {
   if (LIKELY(clear_flag)) {
     AtomicClearFlag(kActiveSuspendBarrier);
   }
+  return found;
 }
 
 void Thread::RunCheckpointFunction() {
@@ -2450,6 +2459,12 @@ void Thread::Destroy() {
     tlsPtr_.opeer = nullptr;
   }
 
+  // Return pool monitors cached for reuse by this thread to the global pool.
+  MonitorPool::ReleaseThreadLocalMonitors(self);
+
+  // Flush native allocation accounting still buffered in this thread.
+  Runtime::Current()->GetHeap()->FlushNativeAllocationAccounting(self);
+
   {
     ScopedObjectAccess soa(self);
     Runtime::Current()->GetHeap()->RevokeThreadLocalBuffers(this);
@@ -2467,7 +2482,9 @@ Thread::~Thread() {
   CHECK(tlsPtr_.opeer == nullptr);
   bool initialized = (tlsPtr_.jni_env != nullptr);  // Did Thread::Init run?
   if (initialized) {
-    delete tlsPtr_.jni_env;
+    // Return the env to the JavaVMExt cache so the next attaching thread can
+    // reuse it instead of recreating the local reference table.
+    Runtime::Current()->GetJavaVM()->RecycleJniEnv(tlsPtr_.jni_env);
     tlsPtr_.jni_env = nullptr;
   }
   CHECK_NE(GetState(), kRunnable);
@@ -2500,6 +2517,7 @@ Thread::~Thread() {
   delete tlsPtr_.instrumentation_stack;
   delete tlsPtr_.name;
   delete tlsPtr_.deps_or_stack_trace_sample.stack_trace_sample;
+  delete tlsPtr_.code_info_cache;
 
   Runtime::Current()->GetHeap()->AssertThreadLocalBuffersAreRevoked(this);
 
@@ -3705,6 +3723,13 @@ void Thread::QuickDeliverException() {
   exception_handler.DoLongJump();
 }
 
+CodeInfoCache* Thread::GetCodeInfoCache() {
+  if (tlsPtr_.code_info_cache == nullptr) {
+    tlsPtr_.code_info_cache = new CodeInfoCache();
+  }
+  return tlsPtr_.code_info_cache;
+}
+
 Context* Thread::GetLongJumpContext() {
   Context* result = tlsPtr_.long_jump_context;
   if (result == nullptr) {
@@ -4432,6 +4457,8 @@ void Thread::ClearAllInterpreterCaches() {
     }
   } closure;
   Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
+  // Also clear the shared second-level cache backing the per-thread caches.
+  Runtime::Current()->GetInterpreterSharedCache()->Clear();
 }
 
 
@@ -36,6 +36,7 @@
 #include "handle.h"
 #include "handle_scope.h"
 #include "interpreter/interpreter_cache.h"
+#include "interpreter/shadow_frame_pool.h"
 #include "javaheapprof/javaheapsampler.h"
 #include "jvalue.h"
 #include "managed_stack.h"
@@ -85,6 +86,7 @@ class ArtMethod;
 class BaseMutex;
 class ClassLinker;
 class Closure;
+class CodeInfoCache;
 class Context;
 class DeoptimizationContextRecord;
 class DexFile;
@@ -578,6 +580,16 @@ class Thread {
     tlsPtr_.monitor_enter_object = obj;
   }
 
+  // Head of this thread's cache of free pool monitors, see MonitorPool. Only ever
+  // accessed by the owning thread.
+  Monitor* GetFreePoolMonitors() const {
+    return tlsPtr_.free_pool_monitors;
+  }
+
+  void SetFreePoolMonitors(Monitor* head) {
+    tlsPtr_.free_pool_monitors = head;
+  }
+
   // Implements java.lang.Thread.interrupted.
   bool Interrupted();
   // Implements java.lang.Thread.isInterrupted.
@@ -1002,6 +1014,21 @@ class Thread {
     --tls32_.disable_thread_flip_count;
   }
 
+  // Whether the thread is inside a ScopedStayRunnableForJni region, in which the JNI
+  // method entrypoints keep the thread runnable as they do for @FastNative methods.
+  bool IsJniStayRunnableRegionActive() const {
+    return tls32_.jni_stay_runnable_depth != 0;
+  }
+
+  void IncrementJniStayRunnableDepth() {
+    ++tls32_.jni_stay_runnable_depth;
+  }
+
+  void DecrementJniStayRunnableDepth() {
+    DCHECK_GT(tls32_.jni_stay_runnable_depth, 0U);
+    --tls32_.jni_stay_runnable_depth;
+  }
+
   // Returns true if the thread is a runtime thread (eg from a ThreadPool).
   bool IsRuntimeThread() const {
     return is_runtime_thread_;
@@ -1120,6 +1147,32 @@ class Thread {
     tls64_.trace_clock_base = clock_base;
   }
 
+  // Per-thread state for identity hash code generation; 0 means not yet
+  // seeded from the shared seed. See Object::GenerateIdentityHashCode.
+  uint64_t GetIdentityHashState() const {
+    return tls64_.identity_hash_state;
+  }
+
+  void SetIdentityHashState(uint64_t state) {
+    tls64_.identity_hash_state = state;
+  }
+
+  // Raw per-thread buffer for streaming method tracing, or null when this
+  // thread has not logged any events yet. Written without locks; see
+  // Trace::LogStreamingMethodTraceEvent for the single-writer protocol.
+  uintptr_t* GetMethodTraceBuffer() const {
+    return tlsPtr_.method_trace_buffer;
+  }
+
+  size_t* GetMethodTraceIndexPtr() {
+    return &tlsPtr_.method_trace_buffer_index;
+  }
+
+  void SetMethodTraceBuffer(uintptr_t* buffer) {
+    tlsPtr_.method_trace_buffer = buffer;
+    tlsPtr_.method_trace_buffer_index = 0;
+  }
+
   BaseMutex* GetHeldMutex(LockLevel level) const {
     return tlsPtr_.held_mutexes[level];
   }
@@ -1128,7 +1181,10 @@ class Thread {
     tlsPtr_.held_mutexes[level] = mutex;
   }
 
-  void ClearSuspendBarrier(AtomicInteger* target)
+  // Remove an installed suspend barrier without waiting for this thread to pass it.
+  // Returns true if the barrier was removed, false if this thread has already claimed
+  // the barrier (and will pass it shortly) or had passed it.
+  bool ClearSuspendBarrier(AtomicInteger* target)
       REQUIRES(Locks::thread_suspend_count_lock_);
 
   bool ReadFlag(ThreadFlag flag) const {
@@ -1168,6 +1224,20 @@ class Thread {
     return tlsPtr_.thread_local_limit - tlsPtr_.thread_local_pos;
   }
 
+  // Accessors for the adaptive TLAB sizing state, see Heap::AdaptiveTlabSize.
+  size_t GetTlabDesiredSize() const {
+    return tlsPtr_.tlab_desired_size;
+  }
+  void SetTlabDesiredSize(size_t size) {
+    tlsPtr_.tlab_desired_size = size;
+  }
+  size_t GetTlabLastRefillGcNum() const {
+    return tlsPtr_.tlab_last_refill_gc_num;
+  }
+  void SetTlabLastRefillGcNum(size_t gc_num) {
+    tlsPtr_.tlab_last_refill_gc_num = gc_num;
+  }
+
   // Expand the TLAB by a fixed number of bytes. There must be enough capacity to do so.
   void ExpandTlab(size_t bytes) {
     tlsPtr_.thread_local_end += bytes;
@@ -1225,6 +1295,21 @@ class Thread {
     return tlsPtr_.thread_local_objects;
   }
 
+  // Accessors for native allocation accounting buffered in this thread, see
+  // Heap::RegisterNativeAllocation.
+  size_t GetPendingNativeBytesRegistered() const {
+    return tlsPtr_.pending_native_bytes_registered;
+  }
+  void SetPendingNativeBytesRegistered(size_t bytes) {
+    tlsPtr_.pending_native_bytes_registered = bytes;
+  }
+  size_t GetPendingNativeObjectsNotified() const {
+    return tlsPtr_.pending_native_objects_notified;
+  }
+  void SetPendingNativeObjectsNotified(size_t count) {
+    tlsPtr_.pending_native_objects_notified = count;
+  }
+
   void* GetRosAllocRun(size_t index) const {
     return tlsPtr_.rosalloc_runs[index];
   }
@@ -1339,6 +1424,10 @@ class Thread {
     return &interpreter_cache_;
   }
 
+  // Return the thread-local cache of decoded CodeInfo, allocating it on first
+  // use. See CodeInfoCache for the invalidation protocol with the JIT.
+  CodeInfoCache* GetCodeInfoCache();
+
   // Clear all thread-local interpreter caches.
   //
   // Since the caches are keyed by memory pointer to dex instructions, this must be
@@ -1358,6 +1447,12 @@ class Thread {
     return WhichPowerOf2(InterpreterCache::kSize);
   }
 
+  // Freelist pool for heap-allocated shadow frames (deoptimization). Only
+  // used from the owning thread.
+  ShadowFramePool* GetShadowFramePool() {
+    return &shadow_frame_pool_;
+  }
+
  private:
   explicit Thread(bool daemon);
   ~Thread() REQUIRES(!Locks::mutator_lock_, !Locks::thread_suspend_count_lock_);
@@ -1570,7 +1665,8 @@ class Thread {
           force_interpreter_count(0),
           use_mterp(0),
           make_visibly_initialized_counter(0),
-          define_class_counter(0) {}
+          define_class_counter(0),
+          jni_stay_runnable_depth(0) {}
 
     union StateAndFlags state_and_flags;
     static_assert(sizeof(union StateAndFlags) == sizeof(int32_t),
@@ -1668,15 +1764,22 @@ class Thread {
     // Counter for how many nested define-classes are ongoing in this thread. Used to allow waiting
     // for threads to be done with class-definition work.
     uint32_t define_class_counter;
+
+    // Number of nested ScopedStayRunnableForJni regions this thread is in. While non-zero,
+    // the JniMethodStart/End entrypoints elide the runnable <-> native state transition.
+    uint32_t jni_stay_runnable_depth;
   } tls32_;
 
   struct PACKED(8) tls_64bit_sized_values {
-    tls_64bit_sized_values() : trace_clock_base(0) {
+    tls_64bit_sized_values() : trace_clock_base(0), identity_hash_state(0) {
     }
 
     // The clock base used for tracing.
     uint64_t trace_clock_base;
 
+    // Generator state for identity hash codes, 0 if not yet seeded.
+    uint64_t identity_hash_state;
+
     RuntimeStats stats;
   } tls64_;
 
@@ -1695,7 +1798,10 @@ class Thread {
       thread_local_objects(0), mterp_current_ibase(nullptr), thread_local_alloc_stack_top(nullptr),
       thread_local_alloc_stack_end(nullptr),
       flip_function(nullptr), method_verifier(nullptr), thread_local_mark_stack(nullptr),
-      async_exception(nullptr), top_reflective_handle_scope(nullptr) {
+      async_exception(nullptr), top_reflective_handle_scope(nullptr),
+      tlab_desired_size(0), tlab_last_refill_gc_num(0), free_pool_monitors(nullptr),
+      code_info_cache(nullptr), method_trace_buffer(nullptr), method_trace_buffer_index(0),
+      pending_native_bytes_registered(0), pending_native_objects_notified(0) {
       std::fill(held_mutexes, held_mutexes + kLockLevelCount, nullptr);
     }
 
@@ -1854,6 +1960,34 @@ class Thread {
 
     // Top of the linked-list for reflective-handle scopes or null if none.
     BaseReflectiveHandleScope* top_reflective_handle_scope;
+
+    // Desired size of the next TLAB refill and the GC number of the last refill, used by the
+    // adaptive TLAB sizing policy (Heap::AdaptiveTlabSize). Zero desired size means the policy
+    // has not sized this thread yet.
+    size_t tlab_desired_size;
+    size_t tlab_last_refill_gc_num;
+
+    // Cache of free pool monitors, linked through their next free pointers, so that
+    // monitor inflation usually does not need to take the allocated_monitor_ids_lock_.
+    // Only used when monitors are pooled (64-bit); drained back to the global pool on
+    // thread exit. See MonitorPool.
+    Monitor* free_pool_monitors;
+
+    // Cache of decoded CodeInfo keyed by method header, used by exception
+    // delivery and deoptimization. Lazily allocated; only used from the
+    // owning thread. See CodeInfoCache.
+    CodeInfoCache* code_info_cache;
+
+    // Raw buffer of method trace records in streaming mode and the number of
+    // buffer words currently filled. Owned and released by the tracing code;
+    // see Trace::LogStreamingMethodTraceEvent.
+    uintptr_t* method_trace_buffer;
+    size_t method_trace_buffer_index;
+
+    // Native allocation bytes and allocation count registered by this thread but not yet
+    // flushed into the heap's global counters. See Heap::RegisterNativeAllocation.
+    size_t pending_native_bytes_registered;
+    size_t pending_native_objects_notified;
   } tlsPtr_;
 
   // Small thread-local cache to be used from the interpreter.
@@ -1872,6 +2006,10 @@ class Thread {
   // Pointer to the monitor lock we're currently waiting on or null if not waiting.
   Monitor* wait_monitor_ GUARDED_BY(wait_mutex_);
 
+  // Pool of heap-allocated shadow frames used for deoptimization; only
+  // accessed by the owning thread.
+  ShadowFramePool shadow_frame_pool_;
+
   // Debug disable read barrier count, only is checked for debug builds and only in the runtime.
   uint8_t debug_disallow_read_barrier_ = 0;
 
@@ -30,6 +30,7 @@
 
 #include "base/aborting.h"
 #include "base/histogram-inl.h"
+#include "base/membarrier.h"
 #include "base/mutex-inl.h"
 #include "base/systrace.h"
 #include "base/time_utils.h"
@@ -78,8 +79,16 @@ ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns)
       long_suspend_(false),
       shut_down_(false),
       thread_suspend_timeout_ns_(thread_suspend_timeout_ns),
+      membarrier_private_expedited_supported_(false),
       empty_checkpoint_barrier_(new Barrier(0)) {
   CHECK(Monitor::IsValidLockWord(LockWord::FromThinLockId(kMaxThreadId, 1, 0U)));
+  // Register for the expedited private membarrier command, used by RunCheckpoint to
+  // publish broadcast checkpoint requests with a single system call.
+  if (membarrier(MembarrierCommand::kRegisterPrivateExpedited) == 0) {
+    membarrier_private_expedited_supported_ = true;
+  } else {
+    VLOG(threads) << "Kernel does not support private expedited membarrier";
+  }
 }
 
 ThreadList::~ThreadList() {
@@ -322,46 +331,60 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, Closure* callback
     MutexLock mu(self, *Locks::thread_list_lock_);
     MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
     count = list_.size();
+    // First broadcast the checkpoint request to all runnable threads, so that they can
+    // already reach a suspend point and run their checkpoint while we deal with the
+    // threads that did not take the request, instead of serializing the wakeups behind
+    // the per-thread suspend bookkeeping below.
+    std::vector<Thread*> remaining_threads;
     for (const auto& thread : list_) {
-      if (thread != self) {
-        bool requested_suspend = false;
-        while (true) {
-          if (thread->RequestCheckpoint(checkpoint_function)) {
-            // This thread will run its checkpoint some time in the near future.
-            if (requested_suspend) {
-              // The suspend request is now unnecessary.
-              bool updated =
-                  thread->ModifySuspendCount(self, -1, nullptr, SuspendReason::kInternal);
-              DCHECK(updated);
-              requested_suspend = false;
-            }
-            break;
-          } else {
-            // The thread is probably suspended, try to make sure that it stays suspended.
-            if (thread->GetState() == kRunnable) {
-              // Spurious fail, try again.
-              continue;
-            }
-            if (!requested_suspend) {
-              bool updated =
-                  thread->ModifySuspendCount(self, +1, nullptr, SuspendReason::kInternal);
-              DCHECK(updated);
-              requested_suspend = true;
-              if (thread->IsSuspended()) {
-                break;
-              }
-              // The thread raced us to become Runnable. Try to RequestCheckpoint() again.
-            } else {
-              // The thread previously raced our suspend request to become Runnable but
-              // since it is suspended again, it must honor that suspend request now.
-              DCHECK(thread->IsSuspended());
+      if (thread != self && !thread->RequestCheckpoint(checkpoint_function)) {
+        remaining_threads.push_back(thread);
+      }
+    }
+    if (membarrier_private_expedited_supported_) {
+      // Force a barrier on every cpu running a thread of this process so that all the
+      // requests above are visible before we start handling the remaining threads and
+      // collecting acknowledgements.
+      membarrier(MembarrierCommand::kPrivateExpedited);
+    }
+    for (const auto& thread : remaining_threads) {
+      bool requested_suspend = false;
+      while (true) {
+        if (thread->RequestCheckpoint(checkpoint_function)) {
+          // This thread will run its checkpoint some time in the near future.
+          if (requested_suspend) {
+            // The suspend request is now unnecessary.
+            bool updated =
+                thread->ModifySuspendCount(self, -1, nullptr, SuspendReason::kInternal);
+            DCHECK(updated);
+            requested_suspend = false;
+          }
+          break;
+        } else {
+          // The thread is probably suspended, try to make sure that it stays suspended.
+          if (thread->GetState() == kRunnable) {
+            // Spurious fail, try again.
+            continue;
+          }
+          if (!requested_suspend) {
+            bool updated =
+                thread->ModifySuspendCount(self, +1, nullptr, SuspendReason::kInternal);
+            DCHECK(updated);
+            requested_suspend = true;
+            if (thread->IsSuspended()) {
               break;
             }
+            // The thread raced us to become Runnable. Try to RequestCheckpoint() again.
+          } else {
+            // The thread previously raced our suspend request to become Runnable but
+            // since it is suspended again, it must honor that suspend request now.
+            DCHECK(thread->IsSuspended());
+            break;
           }
         }
-        if (requested_suspend) {
-          suspended_count_modified_threads.push_back(thread);
-        }
+      }
+      if (requested_suspend) {
+        suspended_count_modified_threads.push_back(thread);
       }
     }
     // Run the callback to be called inside this critical section.
@@ -762,6 +785,54 @@ void ThreadList::SuspendAllInternal(Thread* self,
   }
 }
 
+bool ThreadList::WaitForSuspendBarrier(AtomicInteger* barrier) {
+#if ART_USE_FUTEXES
+  timespec wait_timeout;
+  InitTimeSpec(false, CLOCK_MONOTONIC, NsToMs(thread_suspend_timeout_ns_), 0, &wait_timeout);
+#else
+  const uint64_t start_time = NanoTime();
+#endif
+  while (true) {
+    int32_t cur_val = barrier->load(std::memory_order_acquire);
+    if (cur_val <= 0) {
+      CHECK_EQ(cur_val, 0);
+      return true;
+    }
+#if ART_USE_FUTEXES
+    if (futex(barrier->Address(), FUTEX_WAIT_PRIVATE, cur_val, &wait_timeout, nullptr, 0) != 0) {
+      if (errno == ETIMEDOUT) {
+        return false;
+      } else if ((errno != EAGAIN) && (errno != EINTR)) {
+        PLOG(FATAL) << "futex wait for suspend barrier failed";
+      }
+    }  // else re-check the barrier in the next iteration (this may be a spurious wake-up).
+#else
+    // Spin wait. This is likely to be slow, but on most architecture ART_USE_FUTEXES is set.
+    sched_yield();
+    if (NanoTime() - start_time >= thread_suspend_timeout_ns_) {
+      return false;
+    }
+#endif
+  }
+}
+
+// Remove a single-thread suspend barrier installed in `thread` so that it cannot touch our
+// stack frame after we return. If the thread has already claimed the barrier but not yet
+// passed it, wait for it to finish; that window only spans the tail of
+// Thread::PassActiveSuspendBarriers(), which runs without any locks.
+static void ClearOrPassSuspendBarrier(Thread* thread, AtomicInteger* barrier)
+    REQUIRES(Locks::thread_suspend_count_lock_) {
+  if (barrier->load(std::memory_order_acquire) == 0) {
+    return;  // Already passed.
+  }
+  if (thread->ClearSuspendBarrier(barrier)) {
+    return;  // Removed before the thread claimed it; it will never be decremented.
+  }
+  while (barrier->load(std::memory_order_acquire) != 0) {
+    sched_yield();
+  }
+}
+
 void ThreadList::ResumeAll() {
   Thread* self = Thread::Current();
 
@@ -882,6 +953,11 @@ Thread* ThreadList::SuspendThreadByPeer(jobject peer,
   *timed_out = false;
   Thread* const self = Thread::Current();
   Thread* suspended_thread = nullptr;
+  // Barrier the target thread passes (decrements) at its next suspend point, so that we
+  // can wait for the suspension to happen instead of polling. Only installed if we
+  // request the suspension ourselves.
+  AtomicInteger pending_suspend_barrier(0);
+  bool barrier_installed = false;
   VLOG(threads) << "SuspendThreadByPeer starting";
   while (true) {
     Thread* thread;
@@ -929,9 +1005,15 @@ Thread* ThreadList::SuspendThreadByPeer(jobject peer,
             continue;
           }
           CHECK(suspended_thread == nullptr);
+          pending_suspend_barrier.store(1, std::memory_order_relaxed);
+          if (!thread->ModifySuspendCount(self, +1, &pending_suspend_barrier, reason)) {
+            // The thread is in the middle of a thread flip or is out of suspend barrier
+            // slots. Retry from the top; there is no barrier to wait on in this case.
+            pending_suspend_barrier.store(0, std::memory_order_relaxed);
+            continue;
+          }
+          barrier_installed = true;
           suspended_thread = thread;
-          bool updated = suspended_thread->ModifySuspendCount(self, +1, nullptr, reason);
-          DCHECK(updated);
           request_suspension = false;
         } else {
           // If the caller isn't requesting suspension, a suspension should have already occurred.
@@ -946,6 +1028,10 @@ Thread* ThreadList::SuspendThreadByPeer(jobject peer,
         // count, or else we've waited and it has self suspended) or is the current thread, we're
         // done.
         if (thread->IsSuspended()) {
+          if (barrier_installed) {
+            // The thread may have become suspended before passing our barrier.
+            ClearOrPassSuspendBarrier(thread, &pending_suspend_barrier);
+          }
           VLOG(threads) << "SuspendThreadByPeer thread suspended: " << *thread;
           if (ATraceEnabled()) {
             std::string name;
@@ -969,6 +1055,9 @@ Thread* ThreadList::SuspendThreadByPeer(jobject peer,
                                                                 reason);
             DCHECK(updated);
           }
+          if (barrier_installed) {
+            ClearOrPassSuspendBarrier(thread, &pending_suspend_barrier);
+          }
           *timed_out = true;
           return nullptr;
         } else if (sleep_us == 0 &&
@@ -981,10 +1070,19 @@ Thread* ThreadList::SuspendThreadByPeer(jobject peer,
       // Release locks and come out of runnable state.
     }
     VLOG(threads) << "SuspendThreadByPeer waiting to allow thread chance to suspend";
-    ThreadSuspendSleep(sleep_us);
-    // This may stay at 0 if sleep_us == 0, but this is WAI since we want to avoid using usleep at
-    // all if possible. This shouldn't be an issue since time to suspend should always be small.
-    sleep_us = std::min(sleep_us * 2, kThreadSuspendMaxSleepUs);
+    if (barrier_installed) {
+      // Wait for the thread to pass the barrier at its next suspend point. A timeout is
+      // re-checked against start_time with the locks held on the next iteration.
+      WaitForSuspendBarrier(&pending_suspend_barrier);
+    } else {
+      // We did not request the suspension ourselves, so there is no barrier to wait on;
+      // fall back to polling.
+      ThreadSuspendSleep(sleep_us);
+      // This may stay at 0 if sleep_us == 0, but this is WAI since we want to avoid using usleep
+      // at all if possible. This shouldn't be an issue since time to suspend should always be
+      // small.
+      sleep_us = std::min(sleep_us * 2, kThreadSuspendMaxSleepUs);
+    }
   }
 }
 
@@ -1002,6 +1100,10 @@ Thread* ThreadList::SuspendThreadByThreadId(uint32_t thread_id,
   *timed_out = false;
   Thread* suspended_thread = nullptr;
   Thread* const self = Thread::Current();
+  // Barrier the target thread passes (decrements) at its next suspend point, so that we
+  // can wait for the suspension to happen instead of polling.
+  AtomicInteger pending_suspend_barrier(0);
+  bool barrier_installed = false;
   CHECK_NE(thread_id, kInvalidThreadId);
   VLOG(threads) << "SuspendThreadByThreadId starting";
   while (true) {
@@ -1040,8 +1142,14 @@ Thread* ThreadList::SuspendThreadByThreadId(uint32_t thread_id,
             // which will allow this thread to be suspended.
             continue;
           }
-          bool updated = thread->ModifySuspendCount(self, +1, nullptr, reason);
-          DCHECK(updated);
+          pending_suspend_barrier.store(1, std::memory_order_relaxed);
+          if (!thread->ModifySuspendCount(self, +1, &pending_suspend_barrier, reason)) {
+            // The thread is in the middle of a thread flip or is out of suspend barrier
+            // slots. Retry from the top; there is no barrier to wait on in this case.
+            pending_suspend_barrier.store(0, std::memory_order_relaxed);
+            continue;
+          }
+          barrier_installed = true;
           suspended_thread = thread;
         } else {
           CHECK_EQ(suspended_thread, thread);
@@ -1057,6 +1165,10 @@ Thread* ThreadList::SuspendThreadByThreadId(uint32_t thread_id,
         // count, or else we've waited and it has self suspended) or is the current thread, we're
         // done.
         if (thread->IsSuspended()) {
+          if (barrier_installed) {
+            // The thread may have become suspended before passing our barrier.
+            ClearOrPassSuspendBarrier(thread, &pending_suspend_barrier);
+          }
           if (ATraceEnabled()) {
             std::string name;
             thread->GetThreadName(name);
@@ -1075,6 +1187,9 @@ Thread* ThreadList::SuspendThreadByThreadId(uint32_t thread_id,
             bool updated = thread->ModifySuspendCount(soa.Self(), -1, nullptr, reason);
             DCHECK(updated);
           }
+          if (barrier_installed) {
+            ClearOrPassSuspendBarrier(thread, &pending_suspend_barrier);
+          }
           *timed_out = true;
           return nullptr;
         } else if (sleep_us == 0 &&
@@ -1087,8 +1202,16 @@ Thread* ThreadList::SuspendThreadByThreadId(uint32_t thread_id,
       // Release locks and come out of runnable state.
     }
     VLOG(threads) << "SuspendThreadByThreadId waiting to allow thread chance to suspend";
-    ThreadSuspendSleep(sleep_us);
-    sleep_us = std::min(sleep_us * 2, kThreadSuspendMaxSleepUs);
+    if (barrier_installed) {
+      // Wait for the thread to pass the barrier at its next suspend point. A timeout is
+      // re-checked against start_time with the locks held on the next iteration.
+      WaitForSuspendBarrier(&pending_suspend_barrier);
+    } else {
+      // We did not request the suspension ourselves, so there is no barrier to wait on;
+      // fall back to polling.
+      ThreadSuspendSleep(sleep_us);
+      sleep_us = std::min(sleep_us * 2, kThreadSuspendMaxSleepUs);
+    }
   }
 }
 
@@ -1305,6 +1428,14 @@ void ThreadList::Unregister(Thread* self) {
   // list.
   self->Destroy();
 
+  // If streaming method tracing gave this thread a trace buffer, flush and
+  // release it before the thread goes away. Needs to be runnable since the
+  // flush may emit method name lines.
+  if (UNLIKELY(self->GetMethodTraceBuffer() != nullptr)) {
+    ScopedObjectAccess soa(self);
+    Trace::FlushThreadBufferOnThreadExit(self);
+  }
+
   // If tracing, remember thread id and name before thread exits.
   Trace::StoreExitingThreadInfo(self);
 
@@ -197,6 +197,12 @@ class ThreadList {
   size_t RunCheckpoint(Closure* checkpoint_function, bool includeSuspended)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Wait for a suspend barrier, installed via Thread::ModifySuspendCount(), to be passed,
+  // i.e. to reach zero. Returns false if the wait timed out after
+  // thread_suspend_timeout_ns_, in which case the barrier may still be pending and must
+  // be removed from the target thread before `barrier` goes out of scope.
+  bool WaitForSuspendBarrier(AtomicInteger* barrier);
+
   void DumpUnattachedThreads(std::ostream& os, bool dump_native_stack)
       REQUIRES(!Locks::thread_list_lock_);
 
@@ -237,6 +243,10 @@ class ThreadList {
   // Thread suspension timeout in nanoseconds.
   const uint64_t thread_suspend_timeout_ns_;
 
+  // Whether the kernel supports the private expedited membarrier command, used to
+  // publish broadcast checkpoint requests to all running threads at once.
+  bool membarrier_private_expedited_supported_;
+
   std::unique_ptr<Barrier> empty_checkpoint_barrier_;
 
   friend class Thread;
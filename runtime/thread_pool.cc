@@ -17,6 +17,7 @@
 
 #include "thread_pool.h"
 
+#include <sched.h>
 #include <sys/mman.h>
 #include <sys/resource.h>
 #include <sys/time.h>
@@ -46,10 +47,63 @@ static constexpr bool kUseCustomThreadPoolStack = false;
 static constexpr bool kUseCustomThreadPoolStack = true;
 #endif
 
+bool TaskDeque::PushBottom(Task* task) {
+  int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  int64_t top = top_.load(std::memory_order_acquire);
+  if (bottom - top >= static_cast<int64_t>(kCapacity)) {
+    return false;  // Full.
+  }
+  tasks_[bottom & kIndexMask].store(task, std::memory_order_relaxed);
+  // Make the task visible before publishing the new bottom to thieves.
+  bottom_.store(bottom + 1, std::memory_order_release);
+  return true;
+}
+
+Task* TaskDeque::PopBottom() {
+  int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  bottom_.store(bottom, std::memory_order_relaxed);
+  // Order the bottom_ store before the top_ load, so that this pop and a concurrent
+  // steal cannot both miss each other and hand out the same task.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t top = top_.load(std::memory_order_relaxed);
+  Task* task = nullptr;
+  if (top <= bottom) {
+    task = tasks_[bottom & kIndexMask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // Taking the last entry; race with concurrent steals via top_.
+      if (!top_.compare_exchange_strong(
+              top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        task = nullptr;  // Lost the race to a thief.
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+  } else {
+    // The deque was empty; undo the decrement.
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return task;
+}
+
+Task* TaskDeque::Steal() {
+  int64_t top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t bottom = bottom_.load(std::memory_order_acquire);
+  if (top >= bottom) {
+    return nullptr;  // Empty.
+  }
+  Task* task = tasks_[top & kIndexMask].load(std::memory_order_relaxed);
+  if (!top_.compare_exchange_strong(
+          top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+    return nullptr;  // Lost the race to the owner or another thief.
+  }
+  return task;
+}
+
 ThreadPoolWorker::ThreadPoolWorker(ThreadPool* thread_pool, const std::string& name,
                                    size_t stack_size)
     : thread_pool_(thread_pool),
-      name_(name) {
+      name_(name),
+      thread_(nullptr) {
   std::string error_msg;
   // On Bionic, we know pthreads will give us a big-enough stack with
   // a guard page, so don't do anything special on Bionic libc.
@@ -106,6 +160,30 @@ int ThreadPoolWorker::GetPthreadPriority() {
 #endif
 }
 
+void ThreadPoolWorker::SetCpuAffinity(const std::vector<int>& cpus) {
+#if defined(ART_TARGET_ANDROID)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (cpus.empty()) {
+    // Reset to all CPUs.
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  } else {
+    for (int cpu : cpus) {
+      CHECK_GE(cpu, 0);
+      CHECK_LT(cpu, CPU_SETSIZE);
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  if (sched_setaffinity(pthread_gettid_np(pthread_), sizeof(cpu_set), &cpu_set) != 0) {
+    PLOG(WARNING) << "Failed to set CPU affinity of " << name_;
+  }
+#else
+  UNUSED(cpus);
+#endif
+}
+
 void ThreadPoolWorker::Run() {
   Thread* self = Thread::Current();
   Task* task = nullptr;
@@ -140,6 +218,19 @@ void* ThreadPoolWorker::Callback(void* arg) {
 }
 
 void ThreadPool::AddTask(Thread* self, Task* task) {
+  // If the caller is one of our workers, push the task to its own deque so that it can
+  // be popped (or stolen) without the queue lock; worker-spawned subtasks are the common
+  // small-task case. The lock is still taken briefly to signal waiters.
+  if (use_work_stealing_) {
+    ThreadPoolWorker* worker = FindWorker(self);
+    if (worker != nullptr && worker->task_deque_.PushBottom(task)) {
+      MutexLock mu(self, task_queue_lock_);
+      if (started_ && waiting_count_ != 0) {
+        task_queue_condition_.Signal(self);
+      }
+      return;
+    }
+  }
   MutexLock mu(self, task_queue_lock_);
   tasks_.push_back(task);
   // If we have any waiters, signal one.
@@ -148,6 +239,42 @@ void ThreadPool::AddTask(Thread* self, Task* task) {
   }
 }
 
+ThreadPoolWorker* ThreadPool::FindWorker(Thread* self) const {
+  // `threads_` is only mutated by CreateThreads and DeleteThreads, which the user of the
+  // pool must not run concurrently with task processing (see DeleteThreads).
+  for (ThreadPoolWorker* worker : threads_) {
+    if (worker->GetThread() == self) {
+      return worker;
+    }
+  }
+  return nullptr;
+}
+
+Task* ThreadPool::TryGetDequeTask(ThreadPoolWorker* worker) {
+  if (!use_work_stealing_) {
+    return nullptr;
+  }
+  if (worker != nullptr) {
+    Task* task = worker->task_deque_.PopBottom();
+    if (task != nullptr) {
+      return task;
+    }
+  }
+  for (ThreadPoolWorker* other : threads_) {
+    if (other == worker) {
+      continue;
+    }
+    while (!other->task_deque_.Empty()) {
+      Task* task = other->task_deque_.Steal();
+      if (task != nullptr) {
+        return task;
+      }
+      // Lost a steal race; re-check whether anything is left in this deque.
+    }
+  }
+  return nullptr;
+}
+
 void ThreadPool::RemoveAllTasks(Thread* self) {
   // The ThreadPool is responsible for calling Finalize (which usually delete
   // the task memory) on all the tasks.
@@ -155,6 +282,11 @@ void ThreadPool::RemoveAllTasks(Thread* self) {
   while ((task = TryGetTask(self)) != nullptr) {
     task->Finalize();
   }
+  // Also drain the worker deques, which are not served by TryGetTask once the pool has
+  // been stopped.
+  while ((task = TryGetDequeTask(/*worker=*/ nullptr)) != nullptr) {
+    task->Finalize();
+  }
   MutexLock mu(self, task_queue_lock_);
   tasks_.clear();
 }
@@ -162,7 +294,8 @@ void ThreadPool::RemoveAllTasks(Thread* self) {
 ThreadPool::ThreadPool(const char* name,
                        size_t num_threads,
                        bool create_peers,
-                       size_t worker_stack_size)
+                       size_t worker_stack_size,
+                       bool use_work_stealing)
   : name_(name),
     task_queue_lock_("task queue lock", kGenericBottomLock),
     task_queue_condition_("task queue condition", task_queue_lock_),
@@ -175,7 +308,8 @@ ThreadPool::ThreadPool(const char* name,
     creation_barier_(0),
     max_active_workers_(num_threads),
     create_peers_(create_peers),
-    worker_stack_size_(worker_stack_size) {
+    worker_stack_size_(worker_stack_size),
+    use_work_stealing_(use_work_stealing) {
   CreateThreads();
 }
 
@@ -247,6 +381,7 @@ void ThreadPool::StopWorkers(Thread* self) {
 }
 
 Task* ThreadPool::GetTask(Thread* self) {
+  ThreadPoolWorker* const worker = use_work_stealing_ ? FindWorker(self) : nullptr;
   MutexLock mu(self, task_queue_lock_);
   while (!IsShuttingDown()) {
     const size_t thread_count = GetThreadCount();
@@ -254,7 +389,14 @@ Task* ThreadPool::GetTask(Thread* self) {
     const size_t active_threads = thread_count - waiting_count_;
     // <= since self is considered an active worker.
     if (active_threads <= max_active_workers_) {
-      Task* task = TryGetTaskLocked();
+      // Prefer this worker's own deque for locality, then the central queue, then steal.
+      Task* task = (started_ && worker != nullptr) ? worker->task_deque_.PopBottom() : nullptr;
+      if (task == nullptr) {
+        task = TryGetTaskLocked();
+      }
+      if (task == nullptr && started_) {
+        task = TryGetDequeTask(worker);
+      }
       if (task != nullptr) {
         return task;
       }
@@ -279,8 +421,10 @@ Task* ThreadPool::GetTask(Thread* self) {
 }
 
 Task* ThreadPool::TryGetTask(Thread* self) {
+  ThreadPoolWorker* const worker = use_work_stealing_ ? FindWorker(self) : nullptr;
   MutexLock mu(self, task_queue_lock_);
-  return TryGetTaskLocked();
+  Task* task = started_ ? TryGetDequeTask(worker) : nullptr;
+  return (task != nullptr) ? task : TryGetTaskLocked();
 }
 
 Task* ThreadPool::TryGetTaskLocked() {
@@ -323,6 +467,12 @@ void ThreadPool::SetPthreadPriority(int priority) {
   }
 }
 
+void ThreadPool::SetWorkerCpuAffinity(const std::vector<int>& cpus) {
+  for (ThreadPoolWorker* worker : threads_) {
+    worker->SetCpuAffinity(cpus);
+  }
+}
+
 void ThreadPool::CheckPthreadPriority(int priority) {
 #if defined(ART_TARGET_ANDROID)
   for (ThreadPoolWorker* worker : threads_) {
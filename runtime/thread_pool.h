@@ -17,11 +17,13 @@
 #ifndef ART_RUNTIME_THREAD_POOL_H_
 #define ART_RUNTIME_THREAD_POOL_H_
 
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <vector>
 
 #include "barrier.h"
+#include "base/bit_utils.h"
 #include "base/mem_map.h"
 #include "base/mutex.h"
 
@@ -72,6 +74,44 @@ class FunctionTask : public SelfDeletingTask {
   std::function<void(Thread*)> func_;
 };
 
+// Fixed-size work-stealing deque of tasks (Chase-Lev). The owning worker pushes and pops
+// at the bottom without locking; other threads steal from the top. When the deque is
+// full, callers fall back to the pool's central task queue.
+class TaskDeque {
+ public:
+  TaskDeque() : top_(0), bottom_(0) {}
+
+  // Push a task at the bottom. Only the owning worker may call this. Returns false if
+  // the deque is full.
+  bool PushBottom(Task* task);
+
+  // Pop the most recently pushed task, or return null if the deque is empty. Only the
+  // owning worker may call this.
+  Task* PopBottom();
+
+  // Steal the oldest task, or return null if the deque is empty or the steal lost a race
+  // with the owner or another thief.
+  Task* Steal();
+
+  // Approximate emptiness check; exact when the owner is not concurrently pushing.
+  bool Empty() const {
+    return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kCapacity = 128;
+  static_assert(IsPowerOfTwo(kCapacity), "kCapacity must be a power of two");
+  static constexpr size_t kIndexMask = kCapacity - 1;
+
+  // top_ <= bottom_, except transiently while the owner is popping the last entry. Both
+  // indices only grow, so slots are never reused before both ends have moved past them.
+  std::atomic<int64_t> top_;
+  std::atomic<int64_t> bottom_;
+  std::atomic<Task*> tasks_[kCapacity];
+
+  DISALLOW_COPY_AND_ASSIGN(TaskDeque);
+};
+
 class ThreadPoolWorker {
  public:
   static const size_t kDefaultStackSize = 1 * MB;
@@ -89,6 +129,10 @@ class ThreadPoolWorker {
   // Get the "nice" priority for this worker.
   int GetPthreadPriority();
 
+  // Restrict this worker to the given CPUs, e.g. to keep it on the big cores of a
+  // big.LITTLE device. An empty `cpus` resets the worker to run on any CPU.
+  void SetCpuAffinity(const std::vector<int>& cpus);
+
   Thread* GetThread() const { return thread_; }
 
  protected:
@@ -103,6 +147,10 @@ class ThreadPoolWorker {
   Thread* thread_;
 
  private:
+  // This worker's stealing deque, used instead of the central task queue when the pool
+  // was created with `use_work_stealing`.
+  TaskDeque task_deque_;
+
   friend class ThreadPool;
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolWorker);
 };
@@ -135,10 +183,15 @@ class ThreadPool {
   // If create_peers is true, all worker threads will have a Java peer object. Note that if the
   // pool is asked to do work on the current thread (see Wait), a peer may not be available. Wait
   // will conservatively abort if create_peers and do_work are true.
+  // If use_work_stealing is true, tasks added by the pool's own workers go to per-worker
+  // stealing deques instead of the central queue, taking worker-spawned subtasks off the
+  // contended task_queue_lock_. Pools that rely on the FIFO order of the central queue
+  // (e.g. the JIT pool) must leave it off.
   ThreadPool(const char* name,
              size_t num_threads,
              bool create_peers = false,
-             size_t worker_stack_size = ThreadPoolWorker::kDefaultStackSize);
+             size_t worker_stack_size = ThreadPoolWorker::kDefaultStackSize,
+             bool use_work_stealing = false);
   virtual ~ThreadPool();
 
   // Create the threads of this pool.
@@ -166,6 +219,10 @@ class ThreadPool {
   // Set the "nice" priority for threads in the pool.
   void SetPthreadPriority(int priority);
 
+  // Restrict all workers in the pool to the given CPUs, e.g. to keep GC workers on the
+  // big cores during pauses. An empty `cpus` resets the workers to run on any CPU.
+  void SetWorkerCpuAffinity(const std::vector<int>& cpus);
+
   // CHECK that the "nice" priority of threads in the pool is the given
   // `priority`.
   void CheckPthreadPriority(int priority);
@@ -179,7 +236,7 @@ class ThreadPool {
 
   // Try to get a task, returning null if there is none available.
   Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
-  Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
+  virtual Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
 
   // Are we shutting down?
   bool IsShuttingDown() const REQUIRES(task_queue_lock_) {
@@ -187,9 +244,32 @@ class ThreadPool {
   }
 
   bool HasOutstandingTasks() const REQUIRES(task_queue_lock_) {
-    return started_ && !tasks_.empty();
+    if (!started_) {
+      return false;
+    }
+    if (!tasks_.empty()) {
+      return true;
+    }
+    // Worker deques are popped and stolen without the lock. The check is still precise
+    // once all workers are waiting, since only an active worker can refill a deque.
+    if (use_work_stealing_) {
+      for (ThreadPoolWorker* worker : threads_) {
+        if (!worker->task_deque_.Empty()) {
+          return true;
+        }
+      }
+    }
+    return false;
   }
 
+  // Return the worker of this pool running on `self`, or null if `self` is not one of
+  // our workers.
+  ThreadPoolWorker* FindWorker(Thread* self) const;
+
+  // Pop the worker's own deque, then try to steal from the other workers' deques.
+  // `worker` may be null for non-worker callers, which only steal.
+  Task* TryGetDequeTask(ThreadPoolWorker* worker);
+
   const std::string name_;
   Mutex task_queue_lock_;
   ConditionVariable task_queue_condition_ GUARDED_BY(task_queue_lock_);
@@ -207,6 +287,7 @@ class ThreadPool {
   size_t max_active_workers_ GUARDED_BY(task_queue_lock_);
   const bool create_peers_;
   const size_t worker_stack_size_;
+  const bool use_work_stealing_;
 
  private:
   friend class ThreadPoolWorker;
@@ -485,6 +485,14 @@ void Trace::StopTracing(bool finish_tracing, bool flush_file) {
             instrumentation::Instrumentation::kMethodUnwind);
         runtime->GetInstrumentation()->DisableMethodTracing(kTracerInstrumentationKey);
       }
+
+      if (the_trace->trace_output_mode_ == TraceOutputMode::kStreaming) {
+        // Drain and free the per-thread buffers while all threads are
+        // suspended; when aborting, discard the records instead.
+        MutexLock mu(self, *Locks::thread_list_lock_);
+        runtime->GetThreadList()->ForEach(ReleaseThreadBuffer,
+                                          finish_tracing ? the_trace : nullptr);
+      }
     }
     // At this point, code may read buf_ as it's writers are shutdown
     // and the ScopedSuspendAll above has ensured all stores to buf_
@@ -889,28 +897,6 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
   // same pointer value.
   method = method->GetNonObsoleteMethod();
 
-  // Advance cur_offset_ atomically.
-  int32_t new_offset;
-  int32_t old_offset = 0;
-
-  // In the non-streaming case, we do a busy loop here trying to get
-  // an offset to write our record and advance cur_offset_ for the
-  // next use.
-  if (trace_output_mode_ != TraceOutputMode::kStreaming) {
-    // Although multiple threads can call this method concurrently,
-    // the compare_exchange_weak here is still atomic (by definition).
-    // A succeeding update is visible to other cores when they pass
-    // through this point.
-    old_offset = cur_offset_.load(std::memory_order_relaxed);  // Speculative read
-    do {
-      new_offset = old_offset + GetRecordSize(clock_source_);
-      if (static_cast<size_t>(new_offset) > buffer_size_) {
-        overflow_ = true;
-        return;
-      }
-    } while (!cur_offset_.compare_exchange_weak(old_offset, new_offset, std::memory_order_relaxed));
-  }
-
   TraceAction action = kTraceMethodEnter;
   switch (event) {
     case instrumentation::Instrumentation::kMethodEntered:
@@ -926,24 +912,39 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
       UNIMPLEMENTED(FATAL) << "Unexpected event: " << event;
   }
 
+  if (trace_output_mode_ == TraceOutputMode::kStreaming) {
+    LogStreamingMethodTraceEvent(thread, method, action, thread_clock_diff, wall_clock_diff);
+    return;
+  }
+
+  // Advance cur_offset_ atomically. We do a busy loop here trying to
+  // get an offset to write our record and advance cur_offset_ for the
+  // next use.
+  int32_t new_offset;
+  int32_t old_offset;
+
+  // Although multiple threads can call this method concurrently,
+  // the compare_exchange_weak here is still atomic (by definition).
+  // A succeeding update is visible to other cores when they pass
+  // through this point.
+  old_offset = cur_offset_.load(std::memory_order_relaxed);  // Speculative read
+  do {
+    new_offset = old_offset + GetRecordSize(clock_source_);
+    if (static_cast<size_t>(new_offset) > buffer_size_) {
+      overflow_ = true;
+      return;
+    }
+  } while (!cur_offset_.compare_exchange_weak(old_offset, new_offset, std::memory_order_relaxed));
+
   uint32_t method_value = EncodeTraceMethodAndAction(method, action);
 
-  // Write data into the tracing buffer (if not streaming) or into a
-  // small buffer on the stack (if streaming) which we'll put into the
-  // tracing buffer below.
+  // Write data into the tracing buffer.
   //
   // These writes to the tracing buffer are synchronised with the
   // future reads that (only) occur under FinishTracing(). The callers
   // of FinishTracing() acquire locks and (implicitly) synchronise
   // the buffer memory.
-  uint8_t* ptr;
-  static constexpr size_t kPacketSize = 14U;  // The maximum size of data in a packet.
-  uint8_t stack_buf[kPacketSize];             // Space to store a packet when in streaming mode.
-  if (trace_output_mode_ == TraceOutputMode::kStreaming) {
-    ptr = stack_buf;
-  } else {
-    ptr = buf_.get() + old_offset;
-  }
+  uint8_t* ptr = buf_.get() + old_offset;
 
   Append2LE(ptr, thread->GetTid());
   Append4LE(ptr + 2, method_value);
@@ -956,10 +957,54 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
   if (UseWallClock()) {
     Append4LE(ptr, wall_clock_diff);
   }
-  static_assert(kPacketSize == 2 + 4 + 4 + 4, "Packet size incorrect.");
+}
 
-  if (trace_output_mode_ == TraceOutputMode::kStreaming) {
-    MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
+void Trace::LogStreamingMethodTraceEvent(Thread* thread, ArtMethod* method, TraceAction action,
+                                         uint32_t thread_clock_diff, uint32_t wall_clock_diff) {
+  // Only one writer appends to a given buffer: the owning thread in method
+  // tracing mode, and the sampling thread (the only caller of this method in
+  // that mode) in sampling mode. The buffer is only read once the writer is
+  // excluded -- under streaming_lock_ after the buffer has been handed over
+  // by the writer itself, or while all threads are suspended.
+  uintptr_t* buffer = thread->GetMethodTraceBuffer();
+  if (UNLIKELY(buffer == nullptr)) {
+    buffer = new uintptr_t[kPerThreadTraceBufferWords];
+    thread->SetMethodTraceBuffer(buffer);
+  }
+  size_t* index = thread->GetMethodTraceIndexPtr();
+  if (UNLIKELY(*index == kPerThreadTraceBufferWords)) {
+    FlushThreadBuffer(thread);
+    DCHECK_EQ(*index, 0u);
+  }
+  static_assert((kTraceMethodActionMask & ~(alignof(ArtMethod) - 1)) == 0,
+                "Method pointers cannot hold a TraceAction in their alignment bits.");
+  buffer[*index] = reinterpret_cast<uintptr_t>(method) | action;
+  buffer[*index + 1] = thread_clock_diff;
+  buffer[*index + 2] = wall_clock_diff;
+  *index += kWordsPerTraceRecord;
+}
+
+void Trace::FlushThreadBuffer(Thread* thread) {
+  MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
+  uintptr_t* buffer = thread->GetMethodTraceBuffer();
+  size_t* index = thread->GetMethodTraceIndexPtr();
+  DCHECK(buffer != nullptr);
+  if (RegisterThread(thread)) {
+    // It might be better to postpone this. Threads might not have received names...
+    std::string thread_name;
+    thread->GetThreadName(thread_name);
+    uint8_t buf2[7];
+    Append2LE(buf2, 0);
+    buf2[2] = kOpNewThread;
+    Append2LE(buf2 + 3, static_cast<uint16_t>(thread->GetTid()));
+    Append2LE(buf2 + 5, static_cast<uint16_t>(thread_name.length()));
+    WriteToBuf(buf2, sizeof(buf2));
+    WriteToBuf(reinterpret_cast<const uint8_t*>(thread_name.c_str()), thread_name.length());
+  }
+  for (size_t i = 0; i != *index; i += kWordsPerTraceRecord) {
+    ArtMethod* method =
+        reinterpret_cast<ArtMethod*>(buffer[i] & ~static_cast<uintptr_t>(kTraceMethodActionMask));
+    TraceAction action = static_cast<TraceAction>(buffer[i] & kTraceMethodActionMask);
     if (RegisterMethod(method)) {
       // Write a special block with the name.
       std::string method_line(GetMethodLine(method));
@@ -970,20 +1015,50 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
       WriteToBuf(buf2, sizeof(buf2));
       WriteToBuf(reinterpret_cast<const uint8_t*>(method_line.c_str()), method_line.length());
     }
-    if (RegisterThread(thread)) {
-      // It might be better to postpone this. Threads might not have received names...
-      std::string thread_name;
-      thread->GetThreadName(thread_name);
-      uint8_t buf2[7];
-      Append2LE(buf2, 0);
-      buf2[2] = kOpNewThread;
-      Append2LE(buf2 + 3, static_cast<uint16_t>(thread->GetTid()));
-      Append2LE(buf2 + 5, static_cast<uint16_t>(thread_name.length()));
-      WriteToBuf(buf2, sizeof(buf2));
-      WriteToBuf(reinterpret_cast<const uint8_t*>(thread_name.c_str()), thread_name.length());
+    uint32_t method_value = EncodeTraceMethodAndAction(method, action);
+    static constexpr size_t kPacketSize = 14U;  // The maximum size of data in a packet.
+    uint8_t packet[kPacketSize] = {};
+    Append2LE(packet, thread->GetTid());
+    Append4LE(packet + 2, method_value);
+    uint8_t* ptr = packet + 6;
+    if (UseThreadCpuClock()) {
+      Append4LE(ptr, static_cast<uint32_t>(buffer[i + 1]));
+      ptr += 4;
+    }
+    if (UseWallClock()) {
+      Append4LE(ptr, static_cast<uint32_t>(buffer[i + 2]));
     }
-    WriteToBuf(stack_buf, sizeof(stack_buf));
+    static_assert(kPacketSize == 2 + 4 + 4 + 4, "Packet size incorrect.");
+    WriteToBuf(packet, sizeof(packet));
+  }
+  *index = 0;
+}
+
+void Trace::ReleaseThreadBuffer(Thread* thread, void* arg) {
+  uintptr_t* buffer = thread->GetMethodTraceBuffer();
+  if (buffer == nullptr) {
+    return;
+  }
+  Trace* the_trace = reinterpret_cast<Trace*>(arg);
+  if (the_trace != nullptr) {
+    the_trace->FlushThreadBuffer(thread);
+  }
+  thread->SetMethodTraceBuffer(nullptr);
+  delete[] buffer;
+}
+
+void Trace::FlushThreadBufferOnThreadExit(Thread* thread) {
+  MutexLock mu(thread, *Locks::trace_lock_);
+  uintptr_t* buffer = thread->GetMethodTraceBuffer();
+  if (buffer == nullptr) {
+    return;
+  }
+  if (the_trace_ != nullptr) {
+    DCHECK(the_trace_->trace_output_mode_ == TraceOutputMode::kStreaming);
+    the_trace_->FlushThreadBuffer(thread);
   }
+  thread->SetMethodTraceBuffer(nullptr);
+  delete[] buffer;
 }
 
 void Trace::GetVisitedMethods(size_t buf_size,
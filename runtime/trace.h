@@ -233,6 +233,13 @@ class Trace final : public instrumentation::InstrumentationListener {
   // Save id and name of a thread before it exits.
   static void StoreExitingThreadInfo(Thread* thread);
 
+  // Flush and release the per-thread streaming trace buffer of an exiting
+  // thread. The caller must be runnable, as flushing emits method name lines.
+  static void FlushThreadBufferOnThreadExit(Thread* thread)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::trace_lock_)
+      NO_THREAD_SAFETY_ANALYSIS;  // Negative capabilities of the_trace_'s own locks.
+
   static TraceOutputMode GetOutputMode() REQUIRES(!Locks::trace_lock_);
   static TraceMode GetMode() REQUIRES(!Locks::trace_lock_);
   static size_t GetBufferSize() REQUIRES(!Locks::trace_lock_);
@@ -241,6 +248,16 @@ class Trace final : public instrumentation::InstrumentationListener {
   static bool IsTracingEnabled() REQUIRES(!Locks::trace_lock_);
 
  private:
+  // Geometry of the raw per-thread buffers used in streaming mode. Each
+  // record takes kWordsPerTraceRecord words: the method pointer with the
+  // TraceAction packed into its alignment bits, then the two clock diffs.
+  // 4Ki records amortize the streaming_lock_ hand-off to once per ~4000
+  // events while costing 96KiB per traced thread on 64-bit targets.
+  static constexpr size_t kWordsPerTraceRecord = 3;
+  static constexpr size_t kPerThreadTraceBufferRecords = 4 * 1024;
+  static constexpr size_t kPerThreadTraceBufferWords =
+      kWordsPerTraceRecord * kPerThreadTraceBufferRecords;
+
   Trace(File* trace_file,
         size_t buffer_size,
         int flags,
@@ -267,6 +284,25 @@ class Trace final : public instrumentation::InstrumentationListener {
                            uint32_t thread_clock_diff, uint32_t wall_clock_diff)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!unique_methods_lock_, !streaming_lock_);
 
+  // Append a raw record to `thread`'s trace buffer, allocating the buffer on
+  // first use and draining it to the trace file when it fills up. Only the
+  // drain takes streaming_lock_, so threads no longer serialize per event.
+  void LogStreamingMethodTraceEvent(Thread* thread, ArtMethod* method, TraceAction action,
+                                    uint32_t thread_clock_diff, uint32_t wall_clock_diff)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!unique_methods_lock_, !streaming_lock_);
+
+  // Convert the raw records in `thread`'s trace buffer to the streaming wire
+  // format, emitting new method and thread name blocks as needed, and mark
+  // the buffer empty. Called when a buffer fills up, when its owner exits,
+  // and for all threads when tracing stops.
+  void FlushThreadBuffer(Thread* thread)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!unique_methods_lock_, !streaming_lock_);
+
+  // ThreadList::ForEach callback draining (unless aborting) and freeing the
+  // per-thread trace buffers when tracing stops. `arg` is the Trace to flush
+  // to, or null to discard the records.
+  static void ReleaseThreadBuffer(Thread* thread, void* arg) NO_THREAD_SAFETY_ANALYSIS;
+
   // Methods to output traced methods and threads.
   void GetVisitedMethods(size_t end_offset, std::set<ArtMethod*>* visited_methods)
       REQUIRES(!unique_methods_lock_);
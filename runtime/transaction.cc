@@ -268,6 +268,21 @@ void Transaction::RecordResolveString(ObjPtr<mirror::DexCache> dex_cache,
   resolve_string_logs_.emplace_back(dex_cache, string_idx);
 }
 
+ObjPtr<mirror::Class> Transaction::GetResolvedClassMemo(const std::string& descriptor) {
+  MutexLock mu(Thread::Current(), log_lock_);
+  auto it = resolved_class_memo_.find(descriptor);
+  return (it != resolved_class_memo_.end()) ? it->second.Read() : nullptr;
+}
+
+void Transaction::MemoizeResolvedClass(const std::string& descriptor,
+                                       ObjPtr<mirror::Class> klass) {
+  DCHECK(klass != nullptr);
+  MutexLock mu(Thread::Current(), log_lock_);
+  // The memo holds no state to undo, so it is exempt from the no-new-records
+  // assertion; it merely short-circuits repeated lookups.
+  resolved_class_memo_.Overwrite(descriptor, GcRoot<mirror::Class>(klass));
+}
+
 void Transaction::RecordStrongStringInsertion(ObjPtr<mirror::String> s) {
   InternStringLog log(s, InternStringLog::kStrongString, InternStringLog::kInsert);
   LogInternedString(std::move(log));
@@ -306,6 +321,9 @@ void Transaction::Rollback() {
   UndoArrayModifications();
   UndoInternStringTableModifications();
   UndoResolveStringModifications();
+  // Flush the class resolution memo; an aborted initializer may get
+  // re-executed at runtime where the lookups can resolve differently.
+  resolved_class_memo_.clear();
   rolling_back_ = false;
 }
 
@@ -351,6 +369,7 @@ void Transaction::VisitRoots(RootVisitor* visitor) {
   VisitArrayLogs(visitor);
   VisitInternStringLogs(visitor);
   VisitResolveStringLogs(visitor);
+  VisitResolvedClassMemo(visitor);
 }
 
 void Transaction::VisitObjectLogs(RootVisitor* visitor) {
@@ -420,6 +439,12 @@ void Transaction::VisitResolveStringLogs(RootVisitor* visitor) {
   }
 }
 
+void Transaction::VisitResolvedClassMemo(RootVisitor* visitor) {
+  for (auto& it : resolved_class_memo_) {
+    it.second.VisitRoot(visitor, RootInfo(kRootUnknown));
+  }
+}
+
 void Transaction::ObjectLog::LogBooleanValue(MemberOffset offset, uint8_t value, bool is_volatile) {
   LogValue(ObjectLog::kBoolean, offset, value, is_volatile);
 }
@@ -130,6 +130,18 @@ class Transaction final {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!log_lock_);
 
+  // Memo table for classes resolved by the unstarted runtime (boot class
+  // loader only), keyed by descriptor. Class.forName and friends re-resolve
+  // the same names many times while initializing boot image classes; the memo
+  // short-circuits the repeated lookups. It is flushed on rollback since an
+  // aborted initializer must not leave state behind.
+  ObjPtr<mirror::Class> GetResolvedClassMemo(const std::string& descriptor)
+      REQUIRES(!log_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  void MemoizeResolvedClass(const std::string& descriptor, ObjPtr<mirror::Class> klass)
+      REQUIRES(!log_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Abort transaction by undoing all recorded changes.
   void Rollback()
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -305,6 +317,9 @@ class Transaction final {
   void VisitResolveStringLogs(RootVisitor* visitor)
       REQUIRES(log_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
+  void VisitResolvedClassMemo(RootVisitor* visitor)
+      REQUIRES(log_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   const std::string& GetAbortMessage() REQUIRES(!log_lock_);
 
@@ -313,6 +328,7 @@ class Transaction final {
   std::map<mirror::Array*, ArrayLog> array_logs_  GUARDED_BY(log_lock_);
   std::list<InternStringLog> intern_string_logs_ GUARDED_BY(log_lock_);
   std::list<ResolveStringLog> resolve_string_logs_ GUARDED_BY(log_lock_);
+  SafeMap<std::string, GcRoot<mirror::Class>> resolved_class_memo_ GUARDED_BY(log_lock_);
   bool aborted_ GUARDED_BY(log_lock_);
   bool rolling_back_;  // Single thread, no race.
   gc::Heap* const heap_;
@@ -514,4 +514,25 @@ ClassStatus VdexFile::ComputeClassStatus(Thread* self, Handle<mirror::Class> cls
   return ClassStatus::kVerifiedNeedsAccessChecks;
 }
 
+bool VdexFile::HasVerifiedClass(const DexFile& dex_file, uint16_t class_def_index) const {
+  if (GetVerifierDepsData().empty()) {
+    return false;
+  }
+
+  // Find which dex file index from within the vdex file.
+  uint32_t index = 0;
+  for (; index < GetNumberOfDexFiles(); ++index) {
+    if (dex_file.GetLocationChecksum() == GetLocationChecksum(index)) {
+      break;
+    }
+  }
+  if (index == GetNumberOfDexFiles()) {
+    return false;
+  }
+
+  const uint8_t* verifier_deps = GetVerifierDepsData().data();
+  const uint32_t* dex_file_class_defs = GetDexFileClassDefs(verifier_deps, index);
+  return dex_file_class_defs[class_def_index] != verifier::VerifierDeps::kNotVerifiedMarker;
+}
+
 }  // namespace art
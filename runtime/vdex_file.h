@@ -301,6 +301,11 @@ class VdexFile {
   ClassStatus ComputeClassStatus(Thread* self, Handle<mirror::Class> cls) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns whether the verifier deps section records a successful compile-time
+  // verification of class `class_def_index` in `dex_file`, regardless of whether
+  // the recorded type checks still hold in the current class loading environment.
+  bool HasVerifiedClass(const DexFile& dex_file, uint16_t class_def_index) const;
+
   // Return the name of the underlying `MemMap` of the vdex file, typically the
   // location on disk of the vdex file.
   const std::string& GetName() const {
@@ -85,6 +85,9 @@ void PcToRegisterLineTable::Init(RegisterTrackingMode mode,
                                  RegTypeCache* reg_types) {
   DCHECK_GT(insns_size, 0U);
   register_lines_.resize(insns_size);
+  allocator_ = &allocator;
+  reg_types_ = reg_types;
+  registers_size_ = registers_size;
   for (uint32_t i = 0; i < insns_size; i++) {
     bool interesting = false;
     switch (mode) {
@@ -98,10 +101,24 @@ void PcToRegisterLineTable::Init(RegisterTrackingMode mode,
         interesting = flags[i].IsBranchTarget();
         break;
     }
-    if (interesting) {
-      register_lines_[i].reset(RegisterLine::Create(registers_size, allocator, reg_types));
+    // Lines are allocated lazily when first stored so that addresses which are never reached,
+    // or which only ever hold a shared copy of an incoming line, do not pay for a full line.
+    register_lines_[i].tracked = interesting;
+  }
+}
+
+RegisterLine* PcToRegisterLineTable::GetLineForUpdate(size_t idx) {
+  PcEntry& entry = register_lines_[idx];
+  DCHECK(entry.tracked);
+  if (!entry.owned) {
+    RegisterLine* copy = RegisterLine::Create(registers_size_, *allocator_, reg_types_);
+    if (entry.line != nullptr) {
+      copy->CopyFromLine(entry.line);
     }
+    entry.line = copy;
+    entry.owned = true;
   }
+  return entry.line;
 }
 
 PcToRegisterLineTable::~PcToRegisterLineTable() {}
@@ -811,6 +828,12 @@ class MethodVerifier final : public ::art::verifier::MethodVerifier {
   // Whether to attempt to fill all register lines for (ex) debugger use.
   bool fill_register_lines_;
 
+  // Snapshot sharing state for UpdateRegisters(): the last merge source stored into the register
+  // table and the snapshot that all first-visit targets of the current instruction share. Reset
+  // for every instruction as the merge sources are reused and mutated between instructions.
+  RegisterLine* merge_line_snapshot_ = nullptr;
+  const RegisterLine* merge_line_snapshot_source_ = nullptr;
+
   // API level, for dependent checks. Note: we do not use '0' for unset here, to simplify checks.
   // Instead, unset level should correspond to max().
   const uint32_t api_level_;
@@ -1686,7 +1709,7 @@ static bool IsPrimitiveDescriptor(char descriptor) {
 
 template <bool kVerifierDebug>
 bool MethodVerifier<kVerifierDebug>::SetTypesFromSignature() {
-  RegisterLine* reg_line = reg_table_.GetLine(0);
+  RegisterLine* reg_line = reg_table_.GetLineForUpdate(0);
 
   // Should have been verified earlier.
   DCHECK_GE(code_item_accessor_.RegistersSize(), code_item_accessor_.InsSize());
@@ -2044,6 +2067,11 @@ bool MethodVerifier<kVerifierDebug>::CodeFlowVerifyInstruction(uint32_t* start_g
    *
    * The behavior can be determined from the opcode flags.
    */
+
+  // A new instruction begins: the merge sources may be modified from here on, so stop sharing
+  // the snapshot taken for the previous instruction's targets.
+  merge_line_snapshot_source_ = nullptr;
+
   const uint16_t* insns = code_item_accessor_.Insns() + work_insn_idx_;
   const Instruction* inst = Instruction::At(insns);
   int opcode_flags = Instruction::FlagsOf(inst->Opcode());
@@ -3616,8 +3644,7 @@ bool MethodVerifier<kVerifierDebug>::CodeFlowVerifyInstruction(uint32_t* start_g
       const Instruction* ret_inst = &code_item_accessor_.InstructionAt(next_insn_idx);
       AdjustReturnLine(this, ret_inst, work_line_.get());
     }
-    RegisterLine* next_line = reg_table_.GetLine(next_insn_idx);
-    if (next_line != nullptr) {
+    if (reg_table_.IsTracked(next_insn_idx)) {
       // Merge registers into what we have for the next instruction, and set the "changed" flag if
       // needed. If the merge changes the state of the registers then the work line will be
       // updated.
@@ -4884,15 +4911,18 @@ bool MethodVerifier<kVerifierDebug>::UpdateRegisters(uint32_t next_insn,
                                                      RegisterLine* merge_line,
                                                      bool update_merge_line) {
   bool changed = true;
-  RegisterLine* target_line = reg_table_.GetLine(next_insn);
   if (!GetInstructionFlags(next_insn).IsVisitedOrChanged()) {
     /*
      * We haven't processed this instruction before, and we haven't touched the registers here, so
-     * there's nothing to "merge". Copy the registers over and mark it as changed. (This is the
-     * only way a register can transition out of "unknown", so this is not just an optimization.)
+     * there's nothing to "merge". Store the incoming registers and mark it as changed. (This is
+     * the only way a register can transition out of "unknown", so this is not just an
+     * optimization.)
      */
-    target_line->CopyFromLine(merge_line);
     if (GetInstructionFlags(next_insn).IsReturn()) {
+      // The stored line is adjusted below, so it needs its own copy.
+      RegisterLine* target_line = reg_table_.GetLineForUpdate(next_insn);
+      target_line->CopyFromLine(merge_line);
+
       // Verify that the monitor stack is empty on return.
       merge_line->VerifyMonitorStackEmpty(this);
 
@@ -4904,13 +4934,32 @@ bool MethodVerifier<kVerifierDebug>::UpdateRegisters(uint32_t next_insn,
       if (flags_.have_pending_hard_failure_) {
         return false;
       }
+    } else {
+      // Store a snapshot of `merge_line` and share it between all targets the current
+      // instruction stores to (e.g. every arm of a switch or every catch handler), instead of
+      // copying it into each one. A later merge into one of the targets gives that target its
+      // own copy first (copy-on-write in reg_table_). The snapshot stays valid for the targets
+      // of the current instruction because merge sources are not modified between the stores;
+      // it is invalidated when the next instruction starts.
+      if (merge_line_snapshot_source_ != merge_line) {
+        RegisterLine* snapshot =
+            RegisterLine::Create(merge_line->NumRegs(), allocator_, GetRegTypeCache());
+        snapshot->CopyFromLine(merge_line);
+        merge_line_snapshot_ = snapshot;
+        merge_line_snapshot_source_ = merge_line;
+      }
+      reg_table_.ShareLine(next_insn, merge_line_snapshot_);
     }
   } else {
     RegisterLineArenaUniquePtr copy;
     if (kVerifierDebug) {
-      copy.reset(RegisterLine::Create(target_line->NumRegs(), allocator_, GetRegTypeCache()));
-      copy->CopyFromLine(target_line);
+      RegisterLine* stored_line = reg_table_.GetLine(next_insn);
+      copy.reset(RegisterLine::Create(stored_line->NumRegs(), allocator_, GetRegTypeCache()));
+      copy->CopyFromLine(stored_line);
     }
+    // The merge modifies the stored line; if the line is shared with other addresses, give this
+    // address its own copy first (copy-on-write).
+    RegisterLine* target_line = reg_table_.GetLineForUpdate(next_insn);
     changed = target_line->MergeRegisters(this, merge_line);
     if (flags_.have_pending_hard_failure_) {
       return false;
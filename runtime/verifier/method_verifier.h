@@ -104,12 +104,45 @@ class PcToRegisterLineTable {
     return !register_lines_.empty();
   }
 
+  // Returns whether register information is tracked for the given address.
+  bool IsTracked(size_t idx) const {
+    return register_lines_[idx].tracked;
+  }
+
+  // Returns the register line stored for the given address, or null if none has been stored
+  // yet. The line may be shared with other addresses (copy-on-write); callers must go through
+  // GetLineForUpdate() before modifying it through this entry.
   RegisterLine* GetLine(size_t idx) const {
-    return register_lines_[idx].get();
+    return register_lines_[idx].line;
+  }
+
+  // Point the entry for the given address at `line`, sharing the line with the addresses that
+  // already use it instead of copying it.
+  void ShareLine(size_t idx, RegisterLine* line) {
+    DCHECK(register_lines_[idx].tracked);
+    register_lines_[idx].line = line;
+    register_lines_[idx].owned = false;
   }
 
+  // Returns a line for the given address which is safe to modify, allocating one if the entry
+  // has none yet and breaking the sharing with a copy if the entry's line is shared.
+  RegisterLine* GetLineForUpdate(size_t idx);
+
  private:
-  ScopedArenaVector<RegisterLineArenaUniquePtr> register_lines_;
+  // Entry per dex pc. While `owned` is false the line (if any) may be shared by several entries
+  // and must be copied before being modified through this entry.
+  struct PcEntry {
+    RegisterLine* line = nullptr;
+    bool tracked = false;
+    bool owned = false;
+  };
+
+  ScopedArenaVector<PcEntry> register_lines_;
+
+  // For allocating lines lazily in GetLineForUpdate().
+  ScopedArenaAllocator* allocator_ = nullptr;
+  RegTypeCache* reg_types_ = nullptr;
+  uint16_t registers_size_ = 0u;
 
   DISALLOW_COPY_AND_ASSIGN(PcToRegisterLineTable);
 };
@@ -125,42 +125,38 @@ inline const ImpreciseConstType& RegTypeCache::PosShortConstant() {
 }
 
 inline const PreciseReferenceType& RegTypeCache::JavaLangClass() {
-  const RegType* result = &FromClass("Ljava/lang/Class;",
-                                     GetClassRoot<mirror::Class>(),
-                                     /* precise= */ true);
+  DCHECK(primitive_initialized_);
+  const RegType* result = well_known_types_[kWellKnownClassPrecise];
   DCHECK(result->IsPreciseReference());
   return *down_cast<const PreciseReferenceType*>(result);
 }
 
 inline const PreciseReferenceType& RegTypeCache::JavaLangString() {
   // String is final and therefore always precise.
-  const RegType* result = &FromClass("Ljava/lang/String;",
-                                     GetClassRoot<mirror::String>(),
-                                     /* precise= */ true);
+  DCHECK(primitive_initialized_);
+  const RegType* result = well_known_types_[kWellKnownStringPrecise];
   DCHECK(result->IsPreciseReference());
   return *down_cast<const PreciseReferenceType*>(result);
 }
 
 inline const PreciseReferenceType& RegTypeCache::JavaLangInvokeMethodHandle() {
-  const RegType* result = &FromClass("Ljava/lang/invoke/MethodHandle;",
-                                     GetClassRoot<mirror::MethodHandle>(),
-                                     /* precise= */ true);
+  DCHECK(primitive_initialized_);
+  const RegType* result = well_known_types_[kWellKnownMethodHandlePrecise];
   DCHECK(result->IsPreciseReference());
   return *down_cast<const PreciseReferenceType*>(result);
 }
 
 inline const PreciseReferenceType& RegTypeCache::JavaLangInvokeMethodType() {
-  const RegType* result = &FromClass("Ljava/lang/invoke/MethodType;",
-                                     GetClassRoot<mirror::MethodType>(),
-                                     /* precise= */ true);
+  DCHECK(primitive_initialized_);
+  const RegType* result = well_known_types_[kWellKnownMethodTypePrecise];
   DCHECK(result->IsPreciseReference());
   return *down_cast<const PreciseReferenceType*>(result);
 }
 
 inline const RegType&  RegTypeCache::JavaLangThrowable(bool precise) {
-  const RegType* result = &FromClass("Ljava/lang/Throwable;",
-                                     GetClassRoot<mirror::Throwable>(),
-                                     precise);
+  DCHECK(primitive_initialized_);
+  const RegType* result =
+      well_known_types_[precise ? kWellKnownThrowablePrecise : kWellKnownThrowableImprecise];
   if (precise) {
     DCHECK(result->IsPreciseReference());
     return *down_cast<const PreciseReferenceType*>(result);
@@ -171,7 +167,9 @@ inline const RegType&  RegTypeCache::JavaLangThrowable(bool precise) {
 }
 
 inline const RegType& RegTypeCache::JavaLangObject(bool precise) {
-  const RegType* result = &FromClass("Ljava/lang/Object;", GetClassRoot<mirror::Object>(), precise);
+  DCHECK(primitive_initialized_);
+  const RegType* result =
+      well_known_types_[precise ? kWellKnownObjectPrecise : kWellKnownObjectImprecise];
   if (precise) {
     DCHECK(result->IsPreciseReference());
     return *down_cast<const PreciseReferenceType*>(result);
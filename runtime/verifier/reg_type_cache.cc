@@ -25,10 +25,15 @@
 #include "base/scoped_arena_allocator.h"
 #include "base/stl_util.h"
 #include "class_linker-inl.h"
+#include "class_root-inl.h"
 #include "dex/descriptors_names.h"
 #include "dex/dex_file-inl.h"
 #include "mirror/class-inl.h"
+#include "mirror/method_handle_impl.h"
+#include "mirror/method_type.h"
 #include "mirror/object-inl.h"
+#include "mirror/string.h"
+#include "mirror/throwable.h"
 #include "reg_type-inl.h"
 
 namespace art {
@@ -36,8 +41,10 @@ namespace verifier {
 
 bool RegTypeCache::primitive_initialized_ = false;
 uint16_t RegTypeCache::primitive_count_ = 0;
+uint16_t RegTypeCache::static_entry_count_ = 0;
 const PreciseConstType* RegTypeCache::small_precise_constants_[kMaxSmallConstant -
                                                                kMinSmallConstant + 1];
+const RegType* RegTypeCache::well_known_types_[kNumWellKnownTypes];
 
 namespace {
 
@@ -83,6 +90,16 @@ void RegTypeCache::FillPrimitiveAndSmallConstantTypes() {
   DCHECK_EQ(entries_.size(), primitive_count_);
 }
 
+void RegTypeCache::FillWellKnownTypes() {
+  // Note: this must have the same order as CreateWellKnownTypes.
+  for (const RegType* entry : well_known_types_) {
+    DCHECK_EQ(entries_.size(), entry->GetId());
+    entries_.push_back(entry);
+    klass_entries_.push_back(std::make_pair(GcRoot<mirror::Class>(entry->GetClass()), entry));
+  }
+  DCHECK_EQ(entries_.size(), static_entry_count_);
+}
+
 const RegType& RegTypeCache::FromDescriptor(ObjPtr<mirror::ClassLoader> loader,
                                             const char* descriptor,
                                             bool precise) {
@@ -296,13 +313,15 @@ RegTypeCache::RegTypeCache(ClassLinker* class_linker,
   if (kIsDebugBuild && can_suspend) {
     Thread::Current()->AssertThreadSuspensionIsAllowable(gAborting == 0);
   }
-  // The klass_entries_ array does not have primitives or small constants.
+  // The klass_entries_ array does not have primitives or small constants, but it does
+  // have the well-known reference types.
   static constexpr size_t kNumReserveEntries = 32;
-  klass_entries_.reserve(kNumReserveEntries);
-  // We want to have room for additional entries after inserting primitives and small
-  // constants.
-  entries_.reserve(kNumReserveEntries + kNumPrimitivesAndSmallConstants);
+  klass_entries_.reserve(kNumReserveEntries + kNumWellKnownTypes);
+  // We want to have room for additional entries after inserting primitives, small
+  // constants and well-known types.
+  entries_.reserve(kNumReserveEntries + kNumPrimitivesAndSmallConstants + kNumWellKnownTypes);
   FillPrimitiveAndSmallConstantTypes();
+  FillWellKnownTypes();
 }
 
 RegTypeCache::~RegTypeCache() {
@@ -329,8 +348,13 @@ void RegTypeCache::ShutDown() {
       delete type;
       small_precise_constants_[value - kMinSmallConstant] = nullptr;
     }
+    for (size_t i = 0; i != kNumWellKnownTypes; ++i) {
+      delete well_known_types_[i];
+      well_known_types_[i] = nullptr;
+    }
     RegTypeCache::primitive_initialized_ = false;
     RegTypeCache::primitive_count_ = 0;
+    RegTypeCache::static_entry_count_ = 0;
   }
 }
 
@@ -391,6 +415,30 @@ void RegTypeCache::CreatePrimitiveAndSmallConstantTypes(ClassLinker* class_linke
   }
 }
 
+void RegTypeCache::CreateWellKnownTypes() {
+  // Note: this must have the same order as the `WellKnownTypeIndex` enum and as
+  // FillWellKnownTypes. As with the primitive types, the descriptor literals below have
+  // global lifetime, so the created entries may reference them directly.
+  uint16_t id = primitive_count_;
+  well_known_types_[kWellKnownObjectImprecise] =
+      new ReferenceType(GetClassRoot<mirror::Object>(), "Ljava/lang/Object;", id++);
+  well_known_types_[kWellKnownObjectPrecise] =
+      new PreciseReferenceType(GetClassRoot<mirror::Object>(), "Ljava/lang/Object;", id++);
+  well_known_types_[kWellKnownClassPrecise] =
+      new PreciseReferenceType(GetClassRoot<mirror::Class>(), "Ljava/lang/Class;", id++);
+  well_known_types_[kWellKnownStringPrecise] =
+      new PreciseReferenceType(GetClassRoot<mirror::String>(), "Ljava/lang/String;", id++);
+  well_known_types_[kWellKnownThrowableImprecise] =
+      new ReferenceType(GetClassRoot<mirror::Throwable>(), "Ljava/lang/Throwable;", id++);
+  well_known_types_[kWellKnownThrowablePrecise] =
+      new PreciseReferenceType(GetClassRoot<mirror::Throwable>(), "Ljava/lang/Throwable;", id++);
+  well_known_types_[kWellKnownMethodHandlePrecise] = new PreciseReferenceType(
+      GetClassRoot<mirror::MethodHandle>(), "Ljava/lang/invoke/MethodHandle;", id++);
+  well_known_types_[kWellKnownMethodTypePrecise] = new PreciseReferenceType(
+      GetClassRoot<mirror::MethodType>(), "Ljava/lang/invoke/MethodType;", id++);
+  static_entry_count_ = id;
+}
+
 const RegType& RegTypeCache::FromUnresolvedMerge(const RegType& left,
                                                  const RegType& right,
                                                  MethodVerifier* verifier) {
@@ -713,12 +761,15 @@ void RegTypeCache::VisitStaticRoots(RootVisitor* visitor) {
     for (int32_t value = kMinSmallConstant; value <= kMaxSmallConstant; ++value) {
       small_precise_constants_[value - kMinSmallConstant]->VisitRoots(visitor, ri);
     }
+    for (const RegType* entry : well_known_types_) {
+      entry->VisitRoots(visitor, ri);
+    }
   }
 }
 
 void RegTypeCache::VisitRoots(RootVisitor* visitor, const RootInfo& root_info) {
   // Exclude the static roots that are visited by VisitStaticRoots().
-  for (size_t i = primitive_count_; i < entries_.size(); ++i) {
+  for (size_t i = static_entry_count_; i < entries_.size(); ++i) {
     entries_[i]->VisitRoots(visitor, root_info);
   }
   for (auto& pair : klass_entries_) {
@@ -75,6 +75,9 @@ class RegTypeCache {
       CHECK_EQ(RegTypeCache::primitive_count_, 0);
       CreatePrimitiveAndSmallConstantTypes(class_linker);
       CHECK_EQ(RegTypeCache::primitive_count_, kNumPrimitivesAndSmallConstants);
+      CreateWellKnownTypes();
+      CHECK_EQ(RegTypeCache::static_entry_count_,
+               kNumPrimitivesAndSmallConstants + kNumWellKnownTypes);
       RegTypeCache::primitive_initialized_ = true;
     }
   }
@@ -172,6 +175,7 @@ class RegTypeCache {
 
  private:
   void FillPrimitiveAndSmallConstantTypes() REQUIRES_SHARED(Locks::mutator_lock_);
+  void FillWellKnownTypes() REQUIRES_SHARED(Locks::mutator_lock_);
   ObjPtr<mirror::Class> ResolveClass(const char* descriptor, ObjPtr<mirror::ClassLoader> loader)
       REQUIRES_SHARED(Locks::mutator_lock_);
   bool MatchDescriptor(size_t idx, const std::string_view& descriptor, bool precise)
@@ -189,6 +193,7 @@ class RegTypeCache {
 
   static void CreatePrimitiveAndSmallConstantTypes(ClassLinker* class_linker)
       REQUIRES_SHARED(Locks::mutator_lock_);
+  static void CreateWellKnownTypes() REQUIRES_SHARED(Locks::mutator_lock_);
 
   // A quick look up for popular small constants.
   static constexpr int32_t kMinSmallConstant = -1;
@@ -199,12 +204,36 @@ class RegTypeCache {
   static constexpr size_t kNumPrimitivesAndSmallConstants =
       13 + (kMaxSmallConstant - kMinSmallConstant + 1);
 
+  // Indices into `well_known_types_`. The entries for these well-known boot class
+  // references are, like the primitive types, immutable for the lifetime of the runtime,
+  // so they are created once and copied into each RegTypeCache upon construction instead
+  // of being re-resolved and re-allocated for every verified method.
+  enum WellKnownTypeIndex {
+    kWellKnownObjectImprecise,
+    kWellKnownObjectPrecise,
+    kWellKnownClassPrecise,
+    kWellKnownStringPrecise,
+    kWellKnownThrowableImprecise,
+    kWellKnownThrowablePrecise,
+    kWellKnownMethodHandlePrecise,
+    kWellKnownMethodTypePrecise,
+    kNumWellKnownTypes,
+  };
+
+  // Shared well-known reference types, created by CreateWellKnownTypes().
+  static const RegType* well_known_types_[kNumWellKnownTypes];
+
   // Have the well known global primitives been created?
   static bool primitive_initialized_;
 
   // Number of well known primitives that will be copied into a RegTypeCache upon construction.
   static uint16_t primitive_count_;
 
+  // Number of static entries (primitives, small constants and well-known reference types)
+  // that are copied into a RegTypeCache upon construction. Per-cache root visiting starts
+  // after these entries; their roots are covered by VisitStaticRoots().
+  static uint16_t static_entry_count_;
+
   // The actual storage for the RegTypes.
   ScopedArenaVector<const RegType*> entries_;
 
@@ -481,6 +481,25 @@ TEST_F(RegTypeReferenceTest, JavalangObject) {
   EXPECT_TRUE(ref_type_3.Equals(ref_type_2));
   EXPECT_EQ(ref_type.GetId(), ref_type_3.GetId());
 }
+
+TEST_F(RegTypeReferenceTest, WellKnownTypesShared) {
+  // The well-known boot class types are created once and shared by all caches, so two
+  // caches must hand out the same instances with the same ids, and a descriptor lookup
+  // must find the shared entry instead of materializing a new one.
+  ArenaStack stack(Runtime::Current()->GetArenaPool());
+  ScopedArenaAllocator allocator(&stack);
+  ScopedObjectAccess soa(Thread::Current());
+  RegTypeCache cache_1(Runtime::Current()->GetClassLinker(), true, allocator);
+  RegTypeCache cache_2(Runtime::Current()->GetClassLinker(), true, allocator);
+  EXPECT_EQ(&cache_1.JavaLangObject(false), &cache_2.JavaLangObject(false));
+  EXPECT_EQ(&cache_1.JavaLangObject(true), &cache_2.JavaLangObject(true));
+  EXPECT_EQ(&cache_1.JavaLangString(), &cache_2.JavaLangString());
+  EXPECT_EQ(&cache_1.JavaLangThrowable(false), &cache_2.JavaLangThrowable(false));
+  EXPECT_EQ(cache_1.JavaLangClass().GetId(), cache_2.JavaLangClass().GetId());
+  EXPECT_EQ(&cache_1.FromDescriptor(nullptr, "Ljava/lang/String;", true),
+            &cache_2.JavaLangString());
+}
+
 TEST_F(RegTypeReferenceTest, Merging) {
   // Tests merging logic
   // String and object , LUB is object.
@@ -16,7 +16,9 @@
 
 #include "verifier_deps.h"
 
+#include <algorithm>
 #include <cstring>
+#include <mutex>
 #include <sstream>
 
 #include "art_field-inl.h"
@@ -81,12 +83,50 @@ void VerifierDeps::MergeWith(std::unique_ptr<VerifierDeps> other,
 
 VerifierDeps::DexFileDeps* VerifierDeps::GetDexFileDeps(const DexFile& dex_file) {
   auto it = dex_deps_.find(&dex_file);
-  return (it == dex_deps_.end()) ? nullptr : it->second.get();
+  if (it == dex_deps_.end()) {
+    return nullptr;
+  }
+  DexFileDeps* deps = it->second.get();
+  EnsureDecoded(dex_file, deps);
+  return deps;
 }
 
 const VerifierDeps::DexFileDeps* VerifierDeps::GetDexFileDeps(const DexFile& dex_file) const {
   auto it = dex_deps_.find(&dex_file);
-  return (it == dex_deps_.end()) ? nullptr : it->second.get();
+  if (it == dex_deps_.end()) {
+    return nullptr;
+  }
+  DexFileDeps* deps = it->second.get();
+  EnsureDecoded(dex_file, deps);
+  return deps;
+}
+
+void VerifierDeps::EnsureDecoded(const DexFile& dex_file, DexFileDeps* deps) const {
+  if (LIKELY(!deps->needs_decoding_.load(std::memory_order_acquire))) {
+    return;
+  }
+  std::call_once(deps->decode_once_, [&]() {
+    const uint8_t* data_start = stored_data_.data();
+    const uint8_t* data_end = data_start + stored_data_.size();
+    const uint8_t* cursor =
+        data_start + reinterpret_cast<const uint32_t*>(data_start)[deps->stored_data_index_];
+    if (UNLIKELY(!DecodeDexFileDeps</*kOnlyVerifiedClasses=*/ false>(*deps,
+                                                                     &cursor,
+                                                                     data_start,
+                                                                     data_end,
+                                                                     dex_file.NumClassDefs()))) {
+      // Conservatively treat malformed data as if no class had been verified;
+      // the classes will simply be verified again. The offset table itself was
+      // validated when the data was registered in ParseStoredData().
+      LOG(ERROR) << "Failed to parse dex file dependencies for " << dex_file.GetLocation();
+      deps->strings_.clear();
+      std::fill(deps->assignable_types_.begin(),
+                deps->assignable_types_.end(),
+                std::set<TypeAssignability>());
+      std::fill(deps->verified_classes_.begin(), deps->verified_classes_.end(), false);
+    }
+    deps->needs_decoding_.store(false, std::memory_order_release);
+  });
 }
 
 dex::StringIndex VerifierDeps::GetClassDescriptorStringId(const DexFile& dex_file,
@@ -310,7 +350,28 @@ void VerifierDeps::RecordClassVerified(const DexFile& dex_file, const dex::Class
 
 bool VerifierDeps::HasRecordedVerifiedStatus(const DexFile& dex_file,
                                              const dex::ClassDef& class_def) {
-  DexFileDeps* dex_deps = GetDexFileDeps(dex_file);
+  auto it = dex_deps_.find(&dex_file);
+  DCHECK(it != dex_deps_.end());
+  DexFileDeps* dex_deps = it->second.get();
+  if (dex_deps->needs_decoding_.load(std::memory_order_acquire)) {
+    // The dependencies of this dex file are still encoded. The encoding stores
+    // the verified status directly in the per-class offset table, so answer
+    // the query from the encoded data rather than decoding the whole section
+    // for a single class.
+    const uint8_t* data_start = stored_data_.data();
+    const uint8_t* section =
+        data_start + reinterpret_cast<const uint32_t*>(data_start)[dex_deps->stored_data_index_];
+    size_t num_class_defs = dex_file.NumClassDefs();
+    if (LIKELY(section + (num_class_defs + 1) * sizeof(uint32_t) <=
+                   data_start + stored_data_.size())) {
+      uint32_t offset =
+          reinterpret_cast<const uint32_t*>(section)[dex_file.GetIndexForClassDef(class_def)];
+      return offset != kNotVerifiedMarker;
+    }
+    // The offset table does not fit in the data. Decode the section; the
+    // decoding path handles malformed data conservatively.
+    EnsureDecoded(dex_file, dex_deps);
+  }
   DCHECK_EQ(dex_deps->verified_classes_.size(), dex_file.NumClassDefs());
   return dex_deps->verified_classes_[dex_file.GetIndexForClassDef(class_def)];
 }
@@ -557,25 +618,28 @@ bool VerifierDeps::ParseStoredData(const std::vector<const DexFile*>& dex_files,
     // Currently, only the boot image does not have any VerifierDeps data.
     return true;
   }
-  const uint8_t* data_start = data.data();
-  const uint8_t* data_end = data_start + data.size();
-  const uint8_t* cursor = data_start;
+  // Validate the leading offset table eagerly. The per-dex file sections it
+  // points to are decoded lazily by EnsureDecoded() when first accessed, so
+  // using the dependencies of one dex file does not pay for decoding the
+  // sections of the others.
+  if (UNLIKELY(data.size() < dex_files.size() * sizeof(uint32_t))) {
+    LOG(ERROR) << "Verifier deps data too short to contain the offset table";
+    return false;
+  }
+  const uint32_t* offsets = reinterpret_cast<const uint32_t*>(data.data());
   uint32_t dex_file_index = 0;
   for (const DexFile* dex_file : dex_files) {
-    DexFileDeps* deps = GetDexFileDeps(*dex_file);
-    // Fetch the offset of this dex file's verifier data.
-    cursor = data_start + reinterpret_cast<const uint32_t*>(data_start)[dex_file_index++];
-    size_t num_class_defs = dex_file->NumClassDefs();
-    if (UNLIKELY(!DecodeDexFileDeps</*kOnlyVerifiedClasses=*/ false>(*deps,
-                                                                     &cursor,
-                                                                     data_start,
-                                                                     data_end,
-                                                                     num_class_defs))) {
-      LOG(ERROR) << "Failed to parse dex file dependencies for " << dex_file->GetLocation();
+    if (UNLIKELY(offsets[dex_file_index] > data.size())) {
+      LOG(ERROR) << "Invalid verifier deps offset for " << dex_file->GetLocation();
       return false;
     }
+    auto it = dex_deps_.find(dex_file);
+    DCHECK(it != dex_deps_.end());
+    DexFileDeps* deps = it->second.get();
+    deps->stored_data_index_ = dex_file_index++;
+    deps->needs_decoding_.store(true, std::memory_order_relaxed);
   }
-  // TODO: We should check that `data_start == data_end`. Why are we passing excessive data?
+  stored_data_ = data;
   return true;
 }
 
@@ -630,6 +694,8 @@ bool VerifierDeps::Equals(const VerifierDeps& rhs) const {
 
     DexFileDeps* lhs_deps = lhs_it->second.get();
     DexFileDeps* rhs_deps = rhs_it->second.get();
+    EnsureDecoded(*lhs_dex_file, lhs_deps);
+    rhs.EnsureDecoded(*rhs_dex_file, rhs_deps);
     if (!lhs_deps->Equals(*rhs_deps)) {
       return false;
     }
@@ -651,6 +717,7 @@ void VerifierDeps::Dump(VariableIndentationOutputStream* vios) const {
   std::vector<DepsEntry> dex_deps;
   dex_deps.reserve(dex_deps_.size());
   for (const auto& dep : dex_deps_) {
+    EnsureDecoded(*dep.first, dep.second.get());
     dex_deps.emplace_back(dep.first, dep.second.get());
   }
   std::sort(
@@ -700,6 +767,7 @@ bool VerifierDeps::ValidateDependencies(Thread* self,
                                         Handle<mirror::ClassLoader> class_loader,
                                         /* out */ std::string* error_msg) const {
   for (const auto& entry : dex_deps_) {
+    EnsureDecoded(*entry.first, entry.second.get());
     if (!VerifyDexFile(class_loader, *entry.first, *entry.second, self, error_msg)) {
       return false;
     }
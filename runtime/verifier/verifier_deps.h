@@ -17,7 +17,9 @@
 #ifndef ART_RUNTIME_VERIFIER_VERIFIER_DEPS_H_
 #define ART_RUNTIME_VERIFIER_VERIFIER_DEPS_H_
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <set>
 #include <vector>
 
@@ -66,7 +68,9 @@ class VerifierDeps {
   // this marker as its offset entry in the encoded data.
   static uint32_t constexpr kNotVerifiedMarker = std::numeric_limits<uint32_t>::max();
 
-  // Fill dependencies from stored data. Returns true on success, false on failure.
+  // Register stored data to fill dependencies from. The per-dex file sections
+  // are decoded lazily when first accessed, so `data` must outlive this
+  // `VerifierDeps`. Returns true on success, false on failure.
   bool ParseStoredData(const std::vector<const DexFile*>& dex_files, ArrayRef<const uint8_t> data);
 
   // Merge `other` into this `VerifierDeps`'. `other` and `this` must be for the
@@ -125,6 +129,8 @@ class VerifierDeps {
   }
 
   // Whether this `verifier_deps` has recorded that the given class is verified.
+  // Answered directly from the encoded per-class offset table when the
+  // dependencies of `dex_file` have not been decoded yet.
   bool HasRecordedVerifiedStatus(const DexFile& dex_file, const dex::ClassDef& class_def)
       REQUIRES(!Locks::verifier_deps_lock_);
 
@@ -133,7 +139,8 @@ class VerifierDeps {
   }
 
   bool ContainsDexFile(const DexFile& dex_file) const {
-    return GetDexFileDeps(dex_file) != nullptr;
+    // Note: a pure membership test; does not decode the dex file's section.
+    return dex_deps_.find(&dex_file) != dex_deps_.end();
   }
 
   // Parses raw VerifierDeps data to extract bitvectors of which class def indices
@@ -175,6 +182,18 @@ class VerifierDeps {
     // class was successfully verified.
     std::vector<bool> verified_classes_;
 
+    // Set by ParseStoredData() when these dependencies are backed by encoded
+    // data which has not been decoded yet, cleared by EnsureDecoded() once it
+    // has been. Read with acquire ordering on the fast path.
+    std::atomic<bool> needs_decoding_{false};
+
+    // Makes sure concurrent users decode the encoded data exactly once.
+    std::once_flag decode_once_;
+
+    // Index of this dex file in the offset table at the beginning of the
+    // encoded data. Only meaningful while `needs_decoding_` is set.
+    uint32_t stored_data_index_ = 0u;
+
     bool Equals(const DexFileDeps& rhs) const;
   };
 
@@ -187,6 +206,11 @@ class VerifierDeps {
                                 const uint8_t* data_end,
                                 size_t num_class_defs);
 
+  // Decodes the stored data section of `dex_file` into `deps` on first access.
+  // Sections of other dex files are left untouched, so using the dependencies
+  // of one dex file does not pay for decoding the dependencies of the others.
+  void EnsureDecoded(const DexFile& dex_file, DexFileDeps* deps) const;
+
   // Finds the DexFileDep instance associated with `dex_file`, or nullptr if
   // `dex_file` is not reported as being compiled.
   DexFileDeps* GetDexFileDeps(const DexFile& dex_file);
@@ -249,6 +273,11 @@ class VerifierDeps {
   // Map from DexFiles into dependencies collected from verification of their methods.
   std::map<const DexFile*, std::unique_ptr<DexFileDeps>> dex_deps_;
 
+  // Encoded dependency data registered by ParseStoredData() for lazy per-dex
+  // file decoding, typically the mapping of an opened vdex file. The data must
+  // outlive this `VerifierDeps`. Empty for output-only dependencies.
+  ArrayRef<const uint8_t> stored_data_;
+
   // Output only signifies if we are using the verifier deps to verify or just to generate them.
   const bool output_only_;
 
@@ -27,6 +27,7 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <initializer_list>
 #include <mutex>
 #include <type_traits>
@@ -184,9 +185,16 @@ class ScopedHandlingSignal {
   bool original_value_;
 };
 
+// Bitmask of the signals that have been claimed by special handlers, with bit (signo - 1)
+// representing signal signo. Kept in sync with the per-signal chain table below so that hot
+// paths can test for claimed signals without walking every chain.
+static std::atomic<uint64_t> claimed_signals;
+static_assert(_NSIG <= 65, "claimed signal bitmask cannot represent all signals");
+
 class SignalChain {
  public:
-  SignalChain() : claimed_(false) {
+  SignalChain() : claimed_(false), delivered_count_(0), special_handled_count_(0),
+                  forwarded_count_(0) {
   }
 
   bool IsClaimed() {
@@ -197,6 +205,7 @@ class SignalChain {
     if (!claimed_) {
       Register(signo);
       claimed_ = true;
+      claimed_signals.fetch_or(UINT64_C(1) << (signo - 1), std::memory_order_relaxed);
     }
   }
 
@@ -318,6 +327,11 @@ class SignalChain {
     fatal("failed to find special handler to remove");
   }
 
+  void GetCounters(SigchainCounters* counters) {
+    counters->delivered = delivered_count_.load(std::memory_order_relaxed);
+    counters->special_handled = special_handled_count_.load(std::memory_order_relaxed);
+    counters->forwarded = forwarded_count_.load(std::memory_order_relaxed);
+  }
 
   static void Handler(int signo, siginfo_t* siginfo, void*);
 
@@ -330,6 +344,11 @@ class SignalChain {
   struct sigaction action_;
 #endif
   SigchainAction special_handlers_[2];
+
+  // Dispatch statistics, updated from the signal handler with relaxed atomics.
+  std::atomic<uint64_t> delivered_count_;
+  std::atomic<uint64_t> special_handled_count_;
+  std::atomic<uint64_t> forwarded_count_;
 };
 
 // _NSIG is 1 greater than the highest valued signal, but signals start from 1.
@@ -339,10 +358,14 @@ static SignalChain chains[_NSIG + 1];
 static bool is_signal_hook_debuggable = false;
 
 void SignalChain::Handler(int signo, siginfo_t* siginfo, void* ucontext_raw) {
+  // The chain table is indexed directly by signal number; resolve the entry once.
+  SignalChain* chain = &chains[signo];
+  chain->delivered_count_.fetch_add(1, std::memory_order_relaxed);
+
   // Try the special handlers first.
   // If one of them crashes, we'll reenter this handler and pass that crash onto the user handler.
   if (!GetHandlingSignal()) {
-    for (const auto& handler : chains[signo].special_handlers_) {
+    for (const auto& handler : chain->special_handlers_) {
       if (handler.sc_sigaction == nullptr) {
         break;
       }
@@ -360,6 +383,7 @@ void SignalChain::Handler(int signo, siginfo_t* siginfo, void* ucontext_raw) {
       }
 
       if (handler.sc_sigaction(signo, siginfo, ucontext_raw)) {
+        chain->special_handled_count_.fetch_add(1, std::memory_order_relaxed);
         return;
       }
 
@@ -368,14 +392,15 @@ void SignalChain::Handler(int signo, siginfo_t* siginfo, void* ucontext_raw) {
   }
 
   // Forward to the user's signal handler.
-  int handler_flags = chains[signo].action_.sa_flags;
+  chain->forwarded_count_.fetch_add(1, std::memory_order_relaxed);
+  int handler_flags = chain->action_.sa_flags;
   ucontext_t* ucontext = static_cast<ucontext_t*>(ucontext_raw);
 #if defined(__BIONIC__)
   sigset64_t mask;
-  sigorset(&mask, &ucontext->uc_sigmask64, &chains[signo].action_.sa_mask);
+  sigorset(&mask, &ucontext->uc_sigmask64, &chain->action_.sa_mask);
 #else
   sigset_t mask;
-  sigorset(&mask, &ucontext->uc_sigmask, &chains[signo].action_.sa_mask);
+  sigorset(&mask, &ucontext->uc_sigmask, &chain->action_.sa_mask);
 #endif
   if (!(handler_flags & SA_NODEFER)) {
     sigaddset(&mask, signo);
@@ -399,9 +424,9 @@ void SignalChain::Handler(int signo, siginfo_t* siginfo, void* ucontext_raw) {
       siginfo->si_addr = untag_address(siginfo->si_addr);
     }
 #endif
-    chains[signo].action_.sa_sigaction(signo, siginfo, ucontext_raw);
+    chain->action_.sa_sigaction(signo, siginfo, ucontext_raw);
   } else {
-    auto handler = chains[signo].action_.sa_handler;
+    auto handler = chain->action_.sa_handler;
     if (handler == SIG_IGN) {
       return;
     } else if (handler == SIG_DFL) {
@@ -515,10 +540,14 @@ int __sigprocmask(int how, const SigsetType* new_set, SigsetType* old_set,
 
     if (how == SIG_BLOCK || how == SIG_SETMASK) {
       // Don't allow claimed signals in the mask.  If a signal chain has been claimed
-      // we can't allow the user to block that signal.
-      for (int i = 1; i < _NSIG; ++i) {
-        if (chains[i].IsClaimed() && sigismember(&tmpset, i)) {
-          sigdelset(&tmpset, i);
+      // we can't allow the user to block that signal.  Iterate over the claimed signal
+      // bitmask instead of walking every chain: typically only a signal or two is claimed.
+      uint64_t claimed = claimed_signals.load(std::memory_order_relaxed);
+      while (claimed != 0) {
+        int signo = __builtin_ctzll(claimed) + 1;
+        claimed &= claimed - 1;
+        if (sigismember(&tmpset, signo) == 1) {
+          sigdelset(&tmpset, signo);
         }
       }
     }
@@ -592,5 +621,15 @@ extern "C" void SkipAddSignalHandler(bool value) {
   is_signal_hook_debuggable = value;
 }
 
+extern "C" void GetSignalChainCounters(int signal, SigchainCounters* counters) {
+  InitializeSignalChain();
+
+  if (signal <= 0 || signal >= _NSIG) {
+    fatal("Invalid signal %d", signal);
+  }
+
+  chains[signal].GetCounters(counters);
+}
+
 }   // namespace art
 
@@ -35,8 +35,16 @@ struct SigchainAction {
   uint64_t sc_flags;
 };
 
+// Per-signal dispatch statistics, maintained by the chained handler.
+struct SigchainCounters {
+  uint64_t delivered;        // Deliveries of the signal to the chained handler.
+  uint64_t special_handled;  // Deliveries consumed by a special handler (e.g. the fault manager).
+  uint64_t forwarded;        // Deliveries forwarded to the user's handler.
+};
+
 extern "C" void AddSpecialSignalHandlerFn(int signal, SigchainAction* sa);
 extern "C" void RemoveSpecialSignalHandlerFn(int signal, bool (*fn)(int, siginfo_t*, void*));
+extern "C" void GetSignalChainCounters(int signal, SigchainCounters* counters);
 
 extern "C" void EnsureFrontOfChain(int signal);
 extern "C" void SkipAddSignalHandler(bool value);
@@ -51,6 +51,12 @@ extern "C" void SkipAddSignalHandler(bool value ATTRIBUTE_UNUSED) {
   abort();
 }
 
+extern "C" void GetSignalChainCounters(int signal ATTRIBUTE_UNUSED,
+                                       SigchainCounters* counters ATTRIBUTE_UNUSED) {
+  log("GetSignalChainCounters is not exported by the main executable.");
+  abort();
+}
+
 #pragma GCC diagnostic pop
 
 }  // namespace art
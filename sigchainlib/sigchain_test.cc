@@ -243,6 +243,34 @@ TEST_F(SigchainTest, EnsureFrontOfChain) {
   called = 0;
 }
 
+TEST_F(SigchainTest, counters) {
+  static sig_atomic_t called = 0;
+  struct sigaction action = {};
+  action.sa_flags = SA_SIGINFO;
+  action.sa_sigaction = [](int, siginfo_t*, void*) { called = 1; };
+
+  struct sigaction old_action;
+  ASSERT_EQ(0, sigaction(SIGSEGV, &action, &old_action));
+
+  art::SigchainCounters before;
+  art::GetSignalChainCounters(SIGSEGV, &before);
+
+  RaiseHandled();
+  ASSERT_EQ(0, called);
+
+  RaiseUnhandled();
+  ASSERT_EQ(1, called);
+  called = 0;
+
+  art::SigchainCounters after;
+  art::GetSignalChainCounters(SIGSEGV, &after);
+  ASSERT_EQ(before.delivered + 2, after.delivered);
+  ASSERT_EQ(before.special_handled + 1, after.special_handled);
+  ASSERT_EQ(before.forwarded + 1, after.forwarded);
+
+  ASSERT_EQ(0, sigaction(SIGSEGV, &old_action, nullptr));
+}
+
 TEST_F(SigchainTest, fault_address_tag) {
 #define SA_EXPOSE_TAGBITS 0x00000800
 #if defined(__aarch64__)
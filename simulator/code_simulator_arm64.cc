@@ -60,6 +60,18 @@ void CodeSimulatorArm64::RunFrom(intptr_t code_buffer) {
   simulator_->RunFrom(reinterpret_cast<const Instruction*>(code_buffer));
 }
 
+void CodeSimulatorArm64::SetCArgument(size_t index, int64_t value) {
+  DCHECK(kCanSimulate);
+  DCHECK_LT(index, 8u);  // x0-x7 carry integer arguments in AAPCS64.
+  simulator_->WriteXRegister(static_cast<unsigned>(index), value);
+}
+
+void CodeSimulatorArm64::SetCFPArgument(size_t index, double value) {
+  DCHECK(kCanSimulate);
+  DCHECK_LT(index, 8u);  // d0-d7 carry floating point arguments in AAPCS64.
+  simulator_->WriteDRegister(static_cast<unsigned>(index), value);
+}
+
 bool CodeSimulatorArm64::GetCReturnBool() const {
   DCHECK(kCanSimulate);
   return simulator_->ReadWRegister(0);
@@ -75,5 +87,15 @@ int64_t CodeSimulatorArm64::GetCReturnInt64() const {
   return simulator_->ReadXRegister(0);
 }
 
+float CodeSimulatorArm64::GetCReturnFloat() const {
+  DCHECK(kCanSimulate);
+  return simulator_->ReadSRegister(0);
+}
+
+double CodeSimulatorArm64::GetCReturnDouble() const {
+  DCHECK(kCanSimulate);
+  return simulator_->ReadDRegister(0);
+}
+
 }  // namespace arm64
 }  // namespace art
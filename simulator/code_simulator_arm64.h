@@ -38,9 +38,14 @@ class CodeSimulatorArm64 : public CodeSimulator {
 
   void RunFrom(intptr_t code_buffer) override;
 
+  void SetCArgument(size_t index, int64_t value) override;
+  void SetCFPArgument(size_t index, double value) override;
+
   bool GetCReturnBool() const override;
   int32_t GetCReturnInt32() const override;
   int64_t GetCReturnInt64() const override;
+  float GetCReturnFloat() const override;
+  double GetCReturnDouble() const override;
 
  private:
   CodeSimulatorArm64();
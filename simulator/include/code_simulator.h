@@ -30,10 +30,17 @@ class CodeSimulator {
 
   virtual void RunFrom(intptr_t code_buffer) = 0;
 
+  // Set arguments according to C ABI before RunFrom. Integer and floating point arguments use
+  // separate register files, so they are indexed independently.
+  virtual void SetCArgument(size_t index, int64_t value) = 0;
+  virtual void SetCFPArgument(size_t index, double value) = 0;
+
   // Get return value according to C ABI.
   virtual bool GetCReturnBool() const = 0;
   virtual int32_t GetCReturnInt32() const = 0;
   virtual int64_t GetCReturnInt64() const = 0;
+  virtual float GetCReturnFloat() const = 0;
+  virtual double GetCReturnDouble() const = 0;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(CodeSimulator);
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    public static void main(String[] args) {
+        testFormatStringAndInt();
+        testFormatPercent();
+        testFormatNotFused();
+        System.out.println("passed");
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$formatStringAndInt(java.lang.String, int) instruction_simplifier (before)
+    /// CHECK-NOT:              StringBuilderAppend
+
+    /// CHECK-START: java.lang.String Main.$noinline$formatStringAndInt(java.lang.String, int) instruction_simplifier (after)
+    /// CHECK:                  StringBuilderAppend
+
+    /// CHECK-START: java.lang.String Main.$noinline$formatStringAndInt(java.lang.String, int) instruction_simplifier (after)
+    /// CHECK-NOT:              InvokeStaticOrDirect
+    public static String $noinline$formatStringAndInt(String s, int i) {
+        return String.format("%s:%d", s, i);
+    }
+
+    public static void testFormatStringAndInt() {
+        assertEquals("x:0", $noinline$formatStringAndInt("x", 0));
+        assertEquals("tag:42", $noinline$formatStringAndInt("tag", 42));
+        assertEquals("tag:-42", $noinline$formatStringAndInt("tag", -42));
+        assertEquals("null:2147483647", $noinline$formatStringAndInt(null, Integer.MAX_VALUE));
+        assertEquals(":-2147483648", $noinline$formatStringAndInt("", Integer.MIN_VALUE));
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$formatPercent(int) instruction_simplifier (after)
+    /// CHECK:                  StringBuilderAppend
+    public static String $noinline$formatPercent(int i) {
+        return String.format("%d%%", i);
+    }
+
+    public static void testFormatPercent() {
+        assertEquals("100%", $noinline$formatPercent(100));
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$formatWidth(int) instruction_simplifier (after)
+    /// CHECK-NOT:              StringBuilderAppend
+
+    /// CHECK-START: java.lang.String Main.$noinline$formatFloat(float) instruction_simplifier (after)
+    /// CHECK-NOT:              StringBuilderAppend
+    public static String $noinline$formatWidth(int i) {
+        // Width is not supported by the fused stub; the call must be kept.
+        return String.format("%5d", i);
+    }
+
+    public static String $noinline$formatFloat(float f) {
+        // %f is not supported by the fused stub; the call must be kept.
+        return String.format("%f", f);
+    }
+
+    public static void testFormatNotFused() {
+        assertEquals("   42", $noinline$formatWidth(42));
+        assertEquals("1.500000", $noinline$formatFloat(1.5f));
+    }
+
+    public static void assertEquals(String expected, String actual) {
+        if (!expected.equals(actual)) {
+            throw new AssertionError("Expected: " + expected + ", actual: " + actual);
+        }
+    }
+}
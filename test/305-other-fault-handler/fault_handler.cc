@@ -32,7 +32,7 @@ namespace art {
 class TestFaultHandler final : public FaultHandler {
  public:
   explicit TestFaultHandler(FaultManager* manager)
-      : FaultHandler(manager),
+      : FaultHandler(manager, "test 305"),
         map_error_(),
         target_map_(MemMap::MapAnonymous("test-305-mmap",
                                          /* addr */ nullptr,